@@ -15,6 +15,8 @@
 #include "MyINIConfig.h"
 #include "MyJSONConfig.h"
 #include "MyLog.h"
+#include "MyData.h"
+#include "MyFlyControl.h"
 #include "Pipeline.h"
 #include "ServiceGuard.h"
 
@@ -57,6 +59,8 @@ struct StartupOptions {
     bool run_setup      = false;    // 执行服务自检或守护逻辑。
     bool hard_setup     = false;    // 强制执行服务自检或守护逻辑。
     bool run_doctor     = false;    // 执行 MyDoctor 自检。
+    bool fc_replay_realtime = false;    // 飞控抓包按录制时间原速回放，默认尽可能快。
+    std::string fc_replay_path;         // 非空时回放飞控抓包后退出。
     std::string setup_mode;
     std::vector<std::map<std::string, std::string>> parsed_args;
 };
@@ -110,6 +114,8 @@ ArgumentParser BuildArgumentParser() {
     parser.addOption("-s", "--setup", "执行服务自检或守护逻辑", true);
     parser.addOption("-c", "--config", "指定 INI 配置文件路径", true);
     parser.addOption("-d", "--docter", "执行 MyDoctor 自检", false);
+    parser.addOption("-r", "--fc-replay", "回放飞控串口抓包（.fccap 文件或目录）并输出统计", true);
+    parser.addOption("-R", "--fc-replay-realtime", "配合 --fc-replay，按录制时间原速回放", false);
     return parser;
 }
 
@@ -132,6 +138,10 @@ StartupOptions ParseStartupOptions(int argc, char* argv[], ArgumentParser& parse
             options.hard_setup = IsHardSetupMode(options.setup_mode);
         } else if (IsOptionMatch(item, "-d", "--docter")) {
             options.run_doctor = true;
+        } else if (IsOptionMatch(item, "-r", "--fc-replay")) {
+            options.fc_replay_path = GetOptionValue(item);
+        } else if (IsOptionMatch(item, "-R", "--fc-replay-realtime")) {
+            options.fc_replay_realtime = true;
         }
     }
 
@@ -290,6 +300,24 @@ int RunDoctorMode() {
     return 0;
 }
 
+int RunFlyControlReplayMode(const StartupOptions& options) {
+    MYLOG_INFO("[回放] 进入飞控抓包回放模式: path={}, realtime={}",
+               options.fc_replay_path, options.fc_replay_realtime);
+    fly_control::MyFlyControl fc;
+    fly_control::ReplayOptions replay_options;
+    replay_options.realtime = options.fc_replay_realtime;
+
+    fly_control::ReplayStats stats;
+    std::string err;
+    if (!fc.ReplayCapture(options.fc_replay_path, replay_options, &stats, &err)) {
+        MYLOG_ERROR("[回放] 飞控抓包回放失败: {}", err);
+        std::cout << "飞控抓包回放失败: " << err << std::endl;
+        return -1;
+    }
+    std::cout << stats.ToJson().dump(4) << std::endl;
+    return 0;
+}
+
 bool ValidateConfigurationOrLogError(const BootstrapState& state) {
     if (tools::free_func::checkConfigLoadStatus(
             state.ini_loaded,
@@ -344,6 +372,17 @@ void ShowLoadedConfigs() {
     tools::free_func::showMyConfig("YAML");
 }
 
+// 多实例部署时每个进程需配置不同的 id_node_id（0~1023），保证生成的任务 ID 全局唯一。
+void ConfigureIdGenerator() {
+    int node_id = 0;
+    MyINIConfig::GetInstance().GetInt("id_node_id", 0, node_id);
+    if (node_id < 0 || node_id > 1023) {
+        MYLOG_WARN("[启动] id_node_id={} 超出范围 [0, 1023]，将只取低 10 位。", node_id);
+    }
+    my_data::SetIdNodeId(static_cast<std::uint32_t>(node_id));
+    MYLOG_INFO("[启动] ID 生成器节点号：{}", my_data::IdNodeId());
+}
+
 json LoadPipelineConfigFromJson() {
     json pipeline_config = json::object();
     MyJSONConfig::GetInstance().Get("pipeline", json::object(), pipeline_config);
@@ -403,12 +442,17 @@ int RunApplication(int argc, char* argv[], bool& logger_initialized) {
     InitializeLogger(state, logger_initialized);
     DumpBootstrapLogs(state);
 
-    // 第五阶段：doctor 模式保留独立出口，避免继续进入主业务启动。
+    // 第五阶段：doctor / 飞控回放模式保留独立出口，避免继续进入主业务启动。
     if (state.options.run_doctor) {
         const int doctor_result = RunDoctorMode();
         MyLog::Flush();
         return doctor_result;
     }
+    if (!state.options.fc_replay_path.empty()) {
+        const int replay_result = RunFlyControlReplayMode(state.options);
+        MyLog::Flush();
+        return replay_result;
+    }
 
     // 第六阶段：确认配置完整，再进入真正的应用运行路径。
     if (!ValidateConfigurationOrLogError(state)) {
@@ -419,6 +463,7 @@ int RunApplication(int argc, char* argv[], bool& logger_initialized) {
     RegisterExitSignals();
     LogRuntimeSummary(state);
     ShowLoadedConfigs();
+    ConfigureIdGenerator();
 
     // 第七阶段：启动核心业务，并进入等待退出信号的常驻状态。
     const json pipeline_config = LoadPipelineConfigFromJson();
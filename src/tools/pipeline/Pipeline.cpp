@@ -3,6 +3,8 @@
 #include "IEdge.h"
 #include "MyEdgeManager.h"
 #include "MyEdge.h"
+#include "WorkflowScheduler.h"
+#include "MyData.h"
 #include "MyMqttBrokerManager.h"
 #include "MqttService.hpp"
 #include "FastMQTT.hpp"
@@ -24,6 +26,8 @@
 #include "SearchlightConfig.h"
 #include "SearchlightManager.h"
 #include "my_airdrop_lock.h"
+#include "demo/StatusSnapshotWriter.h"
+#include "demo/SnapshotRetention.h"
 
 #include <cstring>
 #include <system_error>
@@ -517,9 +521,23 @@ void Pipeline::LaunchEdge(const nlohmann::json& args) {
     //       }
     //     ],
     //     "edge_number": 1,
-    //     "interval_sec_": 10
+    //     "interval_sec_": 10,
+    //     "task_trace": { "enable": true, "chrome_trace_file": "" }
     //   },
     try {
+        // 任务延迟追踪（进程级）：chrome_trace_file 非空时额外输出 Chrome trace 文件
+        nlohmann::json task_trace = args.value("task_trace", nlohmann::json::object());
+        my_data::TaskTracer::GetInstance().SetEnabled(task_trace.value("enable", true));
+        const std::string chrome_trace_file = task_trace.value("chrome_trace_file", std::string());
+        if (!chrome_trace_file.empty()) {
+            std::string trace_err;
+            if (my_data::TaskTracer::GetInstance().OpenChromeTrace(chrome_trace_file, &trace_err)) {
+                MYLOG_INFO("任务追踪 Chrome trace 输出: {}", chrome_trace_file);
+            } else {
+                MYLOG_ERROR("任务追踪 Chrome trace 打开失败: {}", trace_err);
+            }
+        }
+
         int edge_number = args.value("edge_number", 1);
         nlohmann::json edge_create_args = args.value("edge_create_args", nlohmann::json::array({}));
         MYLOG_INFO("准备启动 {} 个 Edge 设备", edge_number);
@@ -572,6 +590,7 @@ void Pipeline::LaunchEdge(const nlohmann::json& args) {
     MYLOG_INFO("Edge 模块设备创建流程完成，正在启动所有 Edge 设备...");
     ::my_edge::MyEdgeManager::GetInstance().startAllEdges();
     MYLOG_INFO("所有 Edge 设备已启动");
+    ::my_edge::MyEdgeManager::GetInstance().registerMqttRoutes();
 }
 
 void Pipeline::LaunchMyMqttBroker(const nlohmann::json& args) {
@@ -833,6 +852,12 @@ void Pipeline::Stop() {
     my_mqtt_broker_manager::MyMqttBrokerManager::GetInstance().Stop();
     // 停止 EdgeManager，确保所有 Edge 设备安全关闭
     my_edge::MyEdgeManager::GetInstance().stopAllEdges();
+    // Edge/Workflow 已全部停止，排空并回收 WorkflowScheduler 的工作线程（不依赖单例静态析构的时机）
+    my_control::WorkflowScheduler::GetInstance().Stop();
+    // Edge 已停止上报，写完状态快照队列中剩余的数据；必须在 MyDB 和日志随静态析构释放之前完成
+    my_db::demo::StatusSnapshotWriter::GetInstance().Stop();
+    // 停止快照保留/降采样线程，避免其在 MyDB 释放后仍执行事务
+    my_db::demo::SnapshotRetention::GetInstance().Stop();
     // 停止 HeartbeatManager，确保心跳线程安全退出
     my_heartbeat::HeartbeatManager::GetInstance().Stop();
     // 停止MyAPI服务，确保所有API线程安全退出
@@ -137,8 +137,8 @@ public:
         if (method == "OPTIONS") {
             auto response = OutgoingResponse::createShared(oatpp::web::protocol::http::Status::CODE_200, nullptr);
             response->putHeader("Access-Control-Allow-Origin", "*");
-            response->putHeader("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-            response->putHeader("Access-Control-Allow-Headers", "DNT,User-Agent,X-Requested-With,If-Modified-Since,Cache-Control,Content-Type,Range,Authorization");
+            response->putHeader("Access-Control-Allow-Methods", "GET, HEAD, POST, PUT, DELETE, OPTIONS");
+            response->putHeader("Access-Control-Allow-Headers", "DNT,User-Agent,X-Requested-With,If-Modified-Since,If-None-Match,If-Range,Cache-Control,Content-Type,Range,Authorization");
             return response;
         }
         return nullptr; // 其他请求继续后续路由
@@ -151,6 +151,7 @@ public:
     std::shared_ptr<OutgoingResponse> intercept(const std::shared_ptr<IncomingRequest>& request, 
                                                const std::shared_ptr<OutgoingResponse>& response) override {
         response->putHeader("Access-Control-Allow-Origin", "*");
+        response->putHeader("Access-Control-Expose-Headers", "ETag,Content-Range,Accept-Ranges,Content-Disposition");
         return response;
     }
 };
@@ -1,11 +1,16 @@
 #include "BaseApiController.hpp"
 #include "MyLog.h"
+#include "MyData.h"
 #include "MyEdgeManager.h"
 #include "EdgesController.hpp"
 #include "dto/demo/EdgeStatusDto.hpp"
 #include "dto/demo/TaskDto.hpp"
+#include "demo/StatusRepository.h"
+#include "oatpp/web/protocol/http/outgoing/Body.hpp"
 
 #include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstring>
 #include <vector>
 #include <string>
 #include <memory>
@@ -15,6 +20,108 @@ namespace my_api::edge {
 
 using my_api::base::MyAPIResponsePtr;
 
+namespace {
+
+/**
+ * @brief 快照查询结果的流式 JSON 响应体
+ *
+ * 按行生成 JSON 片段写入 oatpp 传输缓冲区，不在内存中拼接整页响应；
+ * 长度未知，以 chunked 方式输出。status_json 为合法 JSON 时原样嵌入，否则作为字符串输出。
+ */
+class SnapshotPageBody : public oatpp::web::protocol::http::outgoing::Body {
+public:
+    SnapshotPageBody(std::string head, std::vector<my_db::demo::SnapshotRecord> rows)
+        : chunk_(std::move(head)), rows_(std::move(rows)) {}
+
+    oatpp::v_io_size read(void* buffer, v_buff_size count, oatpp::async::Action& action) override {
+        (void)action;
+        auto* out = static_cast<char*>(buffer);
+        v_buff_size written = 0;
+        while (written < count) {
+            if (pos_ == chunk_.size() && !NextChunk()) {
+                break;
+            }
+            const size_t n = std::min(chunk_.size() - pos_, static_cast<size_t>(count - written));
+            std::memcpy(out + written, chunk_.data() + pos_, n);
+            pos_ += n;
+            written += static_cast<v_buff_size>(n);
+        }
+        return written;
+    }
+
+    void declareHeaders(Headers& headers) override {
+        (void)headers;
+    }
+
+    p_char8 getKnownData() override {
+        return nullptr;
+    }
+
+    v_int64 getKnownSize() override {
+        return -1;
+    }
+
+private:
+    bool NextChunk() {
+        pos_ = 0;
+        chunk_.clear();
+        if (next_row_ < rows_.size()) {
+            const auto& r = rows_[next_row_];
+            if (next_row_ > 0) chunk_ += ',';
+            chunk_ += "{\"id\":" + std::to_string(r.id) + ",\"ts_ms\":" + std::to_string(r.ts_ms) + ",\"status\":";
+            chunk_ += r.is_json ? r.status_json : nlohmann::json(r.status_json).dump();
+            chunk_ += '}';
+            ++next_row_;
+            return true;
+        }
+        if (!tail_sent_) {
+            tail_sent_ = true;
+            chunk_ = "]}}";
+            return true;
+        }
+        return false;
+    }
+
+    std::string chunk_;
+    size_t pos_{0};
+    std::vector<my_db::demo::SnapshotRecord> rows_;
+    size_t next_row_{0};
+    bool tail_sent_{false};
+};
+
+std::string QueryParam(const std::shared_ptr<oatpp::web::protocol::http::incoming::Request>& request,
+                       const char* name) {
+    auto value = request ? request->getQueryParameter(name) : nullptr;
+    return value ? std::string(value->c_str(), value->size()) : std::string();
+}
+
+bool ParseInt64Param(const std::string& text, std::int64_t* out) {
+    if (text.empty()) return true;  // 未提供：保留默认值
+    try {
+        size_t n = 0;
+        const std::int64_t v = std::stoll(text, &n);
+        if (n != text.size()) return false;
+        *out = v;
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// StatusRepository::QuerySnapshots 的参数校验错误映射为 400，其余（数据库错误）为 500
+bool IsSnapshotQueryValidationError(const std::string& err) {
+    static const char* const kValidationErrors[] = {
+        "device_id required", "edge_id required", "empty range or limit",
+        "every_n must be >= 1", "bucket_ms must be > 0", "invalid cursor",
+    };
+    for (const char* e : kValidationErrors) {
+        if (err == e) return true;
+    }
+    return false;
+}
+
+}  // namespace
+
 EdgesController::EdgesController(
     const std::shared_ptr<ObjectMapper>& objectMapper
 )
@@ -112,7 +219,7 @@ MyAPIResponsePtr EdgesController::appendTaskToEdgeById(const oatpp::Object<my_ap
         
         // 6) 将任务传给业务层（示例调用）；业务层返回 bool 或可扩展为错误信息结构
         // bool ok = my_edge::MyEdgeManager::GetInstance().appendTaskToEdgeById(edgeId, params);
-        bool ok = my_edge::MyEdgeManager::GetInstance().appendTaskToEdgeByIdV2(edgeId, task);
+        bool ok = my_edge::MyEdgeManager::GetInstance().appendTaskToEdgeByIdV2(edgeId, std::move(task));
 
         if (!ok) {
             MYLOG_ERROR("AppendTaskToEdgeById 业务执行失败, edgeId={}", edgeId);
@@ -136,6 +243,70 @@ MyAPIResponsePtr EdgesController::appendTaskToEdgeById(const oatpp::Object<my_ap
     }
 }
 
+MyAPIResponsePtr EdgesController::submitBatch(const oatpp::String& body) {
+    MYLOG_INFO("[API] 收到请求: POST /v1/edges/submitBatch");
+
+    if (!body || body->empty()) {
+        return jsonError(400, "empty request body");
+    }
+
+    nlohmann::json req = nlohmann::json::parse(body->c_str(), nullptr, false);
+    if (req.is_discarded() || !req.is_object()) {
+        return jsonError(400, "request body must be a json object");
+    }
+    if (!req.contains("source")) {
+        req["source"] = "rest";
+    }
+
+    try {
+        nlohmann::json data;
+        std::string err;
+        if (!my_edge::MyEdgeManager::GetInstance().submitBatchJson(req, &data, &err)) {
+            MYLOG_WARN("[EdgesController::submitBatch] 批量提交失败: {}", err);
+            return jsonError(400, err);
+        }
+        MYLOG_INFO("[EdgesController::submitBatch] edge_id={}, total={}, accepted={}",
+                   data.value("edge_id", ""), data.value("total", 0), data.value("accepted", 0));
+        return jsonOk(data, "submit batch done");
+    } catch (const std::exception& e) {
+        MYLOG_ERROR("[EdgesController::submitBatch] exception: {}", e.what());
+        nlohmann::json details = { {"exception", e.what()} };
+        return jsonError(500, "internal server error", details);
+    }
+}
+
+MyAPIResponsePtr EdgesController::fanoutSubmit(const oatpp::String& body) {
+    MYLOG_INFO("[API] 收到请求: POST /v1/edges/fanout");
+
+    if (!body || body->empty()) {
+        return jsonError(400, "empty request body");
+    }
+
+    nlohmann::json req = nlohmann::json::parse(body->c_str(), nullptr, false);
+    if (req.is_discarded() || !req.is_object()) {
+        return jsonError(400, "request body must be a json object");
+    }
+    if (!req.contains("source")) {
+        req["source"] = "rest";
+    }
+
+    try {
+        nlohmann::json data;
+        std::string err;
+        if (!my_edge::MyEdgeManager::GetInstance().fanoutSubmitJson(req, &data, &err)) {
+            MYLOG_WARN("[EdgesController::fanoutSubmit] 扇出提交失败: {}", err);
+            return jsonError(400, err);
+        }
+        MYLOG_INFO("[EdgesController::fanoutSubmit] total={}, accepted={}",
+                   data.value("total", 0), data.value("accepted", 0));
+        return jsonOk(data, "fanout submit done");
+    } catch (const std::exception& e) {
+        MYLOG_ERROR("[EdgesController::fanoutSubmit] exception: {}", e.what());
+        nlohmann::json details = { {"exception", e.what()} };
+        return jsonError(500, "internal server error", details);
+    }
+}
+
 MyAPIResponsePtr EdgesController::getOnlineEdges() {
     MYLOG_INFO("[API] 收到请求: GET /v1/edges/getOnlineEdges");
 
@@ -201,4 +372,98 @@ MyAPIResponsePtr EdgesController::getTargetEdgeRunTimeStatusInfo (
 
     return jsonOk(status_info, "run time status info retrieved");
 }
-}; // namespace my_api::edge
\ No newline at end of file
+MyAPIResponsePtr EdgesController::getDeviceSnapshots(const std::shared_ptr<IncomingRequest>& request) {
+    MYLOG_INFO("[API] 收到请求: GET /v1/edges/snapshots/device");
+    return querySnapshots(request, true);
+}
+
+MyAPIResponsePtr EdgesController::getEdgeSnapshots(const std::shared_ptr<IncomingRequest>& request) {
+    MYLOG_INFO("[API] 收到请求: GET /v1/edges/snapshots/edge");
+    return querySnapshots(request, false);
+}
+
+MyAPIResponsePtr EdgesController::getTaskLatency(const std::shared_ptr<IncomingRequest>& request) {
+    MYLOG_INFO("[API] 收到请求: GET /v1/edges/latency");
+
+    const std::string edge_id = QueryParam(request, "edge_id");
+    if (edge_id.size() > 256) {
+        return jsonError(400, "edge_id too long");
+    }
+    const std::string reset = QueryParam(request, "reset");
+    if (!reset.empty() && reset != "true" && reset != "false") {
+        return jsonError(400, "reset must be true|false");
+    }
+
+    auto& tracer = my_data::TaskTracer::GetInstance();
+    nlohmann::json data = tracer.Snapshot(edge_id);
+    if (reset == "true") {
+        tracer.Reset();
+    }
+    return jsonOk(data, "task latency retrieved");
+}
+
+MyAPIResponsePtr EdgesController::querySnapshots(const std::shared_ptr<IncomingRequest>& request, bool device) {
+    using my_db::demo::SnapshotQuery;
+
+    SnapshotQuery q;
+    q.kind = device ? my_db::demo::SnapshotRow::Kind::Device : my_db::demo::SnapshotRow::Kind::Edge;
+    q.edge_id = QueryParam(request, "edge_id");
+    q.device_id = QueryParam(request, "device_id");
+    q.cursor = QueryParam(request, "cursor");
+
+    if (q.edge_id.size() > 256 || q.device_id.size() > 256 || q.cursor.size() > 64) {
+        return jsonError(400, "parameter too long");
+    }
+
+    std::int64_t limit = static_cast<std::int64_t>(q.limit);
+    if (!ParseInt64Param(QueryParam(request, "from_ms"), &q.from_ms) ||
+        !ParseInt64Param(QueryParam(request, "to_ms"), &q.to_ms) ||
+        !ParseInt64Param(QueryParam(request, "limit"), &limit) ||
+        !ParseInt64Param(QueryParam(request, "n"), &q.every_n) ||
+        !ParseInt64Param(QueryParam(request, "bucket_ms"), &q.bucket_ms)) {
+        return jsonError(400, "integer parameter expected");
+    }
+    q.limit = static_cast<size_t>(std::clamp<std::int64_t>(limit, 1, static_cast<std::int64_t>(SnapshotQuery::kMaxLimit)));
+
+    const std::string downsample = QueryParam(request, "downsample");
+    if (downsample.empty() || downsample == "none") {
+        q.downsample = SnapshotQuery::Downsample::None;
+    } else if (downsample == "nth") {
+        q.downsample = SnapshotQuery::Downsample::EveryNth;
+    } else if (downsample == "bucket_last") {
+        q.downsample = SnapshotQuery::Downsample::BucketLast;
+    } else {
+        return jsonError(400, "downsample must be none|nth|bucket_last");
+    }
+
+    my_db::demo::SnapshotPage page;
+    std::string err;
+    if (!my_db::demo::StatusRepository::GetInstance().QuerySnapshots(q, &page, &err)) {
+        MYLOG_WARN("[EdgesController] 快照查询失败: {}", err);
+        return jsonError(IsSnapshotQueryValidationError(err) ? 400 : 500, err);
+    }
+
+    nlohmann::json meta = {
+        {"kind", device ? "device" : "edge"},
+        {"edge_id", q.edge_id},
+        {"device_id", q.device_id},
+        {"count", page.rows.size()},
+        {"scanned", page.scanned},
+        {"has_more", page.has_more},
+        {"next_cursor", page.next_cursor},
+    };
+    // 去掉 meta 的结尾 '}'，接上 rows 数组，rows 与结尾由响应体流式输出
+    std::string head = "{\"success\":true,\"code\":200,\"message\":\"OK\",\"data\":" + meta.dump();
+    head.pop_back();
+    head += ",\"rows\":[";
+
+    MYLOG_INFO("[EdgesController] 快照查询完成: kind={}, rows={}, scanned={}, has_more={}",
+               device ? "device" : "edge", page.rows.size(), page.scanned, page.has_more);
+
+    auto body = std::make_shared<SnapshotPageBody>(std::move(head), std::move(page.rows));
+    auto res = OutgoingResponse::createShared(Status::CODE_200, body);
+    res->putHeader("Content-Type", "application/json");
+    return res;
+}
+
+}; // namespace my_api::edge
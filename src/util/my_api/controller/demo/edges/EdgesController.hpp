@@ -10,6 +10,8 @@
 
 namespace my_api::edge {
 
+using my_api::base::MyAPIResponsePtr;
+
 #include OATPP_CODEGEN_BEGIN(ApiController)
 
 class EdgesController : public base::BaseApiController {
@@ -48,6 +50,48 @@ public:
              BODY_DTO(oatpp::Object<my_api::dto::TaskDto>, taskDto)
             );
 
+    ENDPOINT_INFO(submitBatch) {
+      info->addTag(SWAGGER_TAG);
+      info->summary = "向指定的 Edge 批量提交命令";
+      info->description = "请求体示例:\n"
+                          "{\n"
+                          "  \"edge_id\": \"uav_001\",\n"
+                          "  \"atomic\": false,\n"
+                          "  \"commands\": [\n"
+                          "    { \"command_id\": \"wp-1\", \"payload\": { \"device_id\": \"self\", \"capability\": \"nav\", \"action\": \"goto\", \"params\": {} } }\n"
+                          "  ]\n"
+                          "}\n"
+                          "整批在一次加锁内校验并按设备分组入队；atomic=true 时任一命令失败则整批不入队。\n"
+                          "返回与 commands 一一对应的 results。";
+      info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+      info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+      info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
+    }
+    ENDPOINT("POST",
+             "/v1/edges/submitBatch",
+             submitBatch,
+             BODY_STRING(oatpp::String, body)
+            );
+
+    ENDPOINT_INFO(fanoutSubmit) {
+      info->addTag(SWAGGER_TAG);
+      info->summary = "把同一条命令并行下发到多个 Edge";
+      info->description = "请求体示例:\n"
+                          "{\n"
+                          "  \"edge_ids\": [\"uav_001\", \"uuv_001\"],\n"
+                          "  \"command\": { \"command_id\": \"rtl-1\", \"payload\": { \"device_id\": \"self\", \"capability\": \"nav\", \"action\": \"rtl\", \"params\": {} } }\n"
+                          "}\n"
+                          "edge_ids 省略或为空表示全部 Edge；返回与 edge_ids 一一对应的 results，未知 Edge 的 code 为 UnknownEdge。";
+      info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+      info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+      info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
+    }
+    ENDPOINT("POST",
+             "/v1/edges/fanout",
+             fanoutSubmit,
+             BODY_STRING(oatpp::String, body)
+            );
+
     ENDPOINT_INFO(getOnlineEdges) {
       info->addTag(SWAGGER_TAG);
       info->summary = "获取所有在线的 Edge ID 列表";
@@ -87,6 +131,53 @@ public:
              BODY_DTO(oatpp::Object<my_api::dto::EdgeIDDto>, edgeIdDto)
             );
 
+    ENDPOINT_INFO(getDeviceSnapshots) {
+      info->addTag(SWAGGER_TAG);
+      info->summary = "按时间区间查询设备状态快照历史";
+      info->description = "Query 参数：device_id（必填）、edge_id、from_ms、to_ms（左闭右开）、limit（默认 500，最大 5000）、\n"
+                          "cursor（上一页返回的 next_cursor）、downsample=none|nth|bucket_last、n、bucket_ms。\n"
+                          "按 (ts_ms, id) keyset 分页，响应以 chunked 方式流式输出。";
+      info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+      info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+      info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
+    }
+    ENDPOINT("GET",
+             "/v1/edges/snapshots/device",
+             getDeviceSnapshots,
+             REQUEST(std::shared_ptr<IncomingRequest>, request)
+            );
+
+    ENDPOINT_INFO(getEdgeSnapshots) {
+      info->addTag(SWAGGER_TAG);
+      info->summary = "按时间区间查询 Edge 状态快照历史";
+      info->description = "Query 参数同 /v1/edges/snapshots/device，其中 edge_id 必填。";
+      info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+      info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+      info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
+    }
+    ENDPOINT("GET",
+             "/v1/edges/snapshots/edge",
+             getEdgeSnapshots,
+             REQUEST(std::shared_ptr<IncomingRequest>, request)
+            );
+
+    ENDPOINT_INFO(getTaskLatency) {
+      info->addTag(SWAGGER_TAG);
+      info->summary = "按 (edge_id, device_id, capability, action) 查询任务各阶段延迟直方图";
+      info->description = "Query 参数：edge_id（可选，只看该 Edge）、reset=true（返回后清零）。\n"
+                          "每项包含 normalize / queue_wait / exec / end_to_end 四段：count、avg/min/max、p50/p90/p99（微秒）与对数分桶。";
+      info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+      info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+    }
+    ENDPOINT("GET",
+             "/v1/edges/latency",
+             getTaskLatency,
+             REQUEST(std::shared_ptr<IncomingRequest>, request)
+            );
+
+private:
+    MyAPIResponsePtr querySnapshots(const std::shared_ptr<IncomingRequest>& request, bool device);
+
 }; // class EdgesController
 #include OATPP_CODEGEN_END(ApiController)
 
@@ -16,8 +16,17 @@
 #include "oatpp/encoding/Base64.hpp"
 #include "oatpp/web/mime/multipart/InMemoryDataProvider.hpp"
 #include "oatpp/web/mime/multipart/PartList.hpp"
+#include "oatpp/web/mime/multipart/PartReader.hpp"
 #include "oatpp/web/mime/multipart/Reader.hpp"
 #include "oatpp/web/protocol/http/Http.hpp"
+#include "oatpp/web/protocol/http/outgoing/Body.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <filesystem>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace my_api::file_cache_api;
 using namespace my_api::base;
@@ -39,18 +48,124 @@ std::string PartToString(const std::shared_ptr<oatpp::web::mime::multipart::Part
     return std::string(data->c_str(), data->size());
 }
 
-std::vector<uint8_t> PartToBytes(const std::shared_ptr<oatpp::web::mime::multipart::Part>& part) {
-    if (!part || !part->getPayload()) {
-        return {};
+/// 非文件字段（如 file_name）的内存读取上限，防止恶意大文本字段占用内存
+constexpr oatpp::v_io_size kMaxTextPartSize = 4096;
+
+/**
+ * @brief 将 multipart 文件字段直接流式写入 MyCache 暂存文件
+ *
+ * oatpp 每次回调传入的数据块大小受其传输缓冲区限制，
+ * 因此整个上传过程的内存占用与文件大小无关。
+ * 出错后（如超过 max_file_size）记录错误码并丢弃后续数据，
+ * 由控制器在 transferBody 结束后统一返回错误响应。
+ */
+class CacheStreamPartReader : public oatpp::web::mime::multipart::PartReader {
+public:
+    explicit CacheStreamPartReader(MyCache* cache) : cache_(cache) {}
+
+    void onNewPart(const std::shared_ptr<oatpp::web::mime::multipart::Part>& part) override {
+        (void)part;
+        if (writer_ || error_ != CacheErrorCode::Ok) {
+            // 重复的 file 字段：仅保留第一个
+            return;
+        }
+        auto result = cache_->OpenWriter();
+        if (!result.Ok()) {
+            error_ = result.code;
+            return;
+        }
+        writer_ = std::move(result.value);
     }
 
-    auto data = part->getPayload()->getInMemoryData();
-    if (!data) {
-        return {};
+    void onPartData(const std::shared_ptr<oatpp::web::mime::multipart::Part>& part,
+                    const char* data,
+                    oatpp::v_io_size size) override {
+        (void)part;
+        if (size <= 0 || !writer_ || !writer_->IsOpen() || error_ != CacheErrorCode::Ok) {
+            return;
+        }
+        auto result = writer_->Append(reinterpret_cast<const uint8_t*>(data), static_cast<size_t>(size));
+        if (!result.Ok()) {
+            error_ = result.code;
+        }
+    }
+
+    CacheErrorCode Error() const { return error_; }
+    CacheFileWriter* Writer() const { return writer_.get(); }
+
+private:
+    MyCache* cache_;
+    std::unique_ptr<CacheFileWriter> writer_;
+    CacheErrorCode error_ = CacheErrorCode::Ok;
+};
+
+/**
+ * @brief 从文件描述符按区间分块读取的响应体
+ *
+ * 每次 read 回调只通过 pread 读取 oatpp 传输缓冲区大小的数据，
+ * 文件不会整体加载到内存。Content-Length 由 getKnownSize 声明。
+ * head_only 为 true 时声明长度但不输出内容（用于 HEAD 请求）。
+ */
+class CacheFileBody : public oatpp::web::protocol::http::outgoing::Body {
+public:
+    CacheFileBody(int fd, uint64_t offset, uint64_t length, bool head_only)
+        : fd_(fd), offset_(offset), length_(length), remaining_(head_only ? 0 : length) {
+        if (!head_only && length_ > 0) {
+            ::posix_fadvise(fd_, static_cast<off_t>(offset_), static_cast<off_t>(length_),
+                            POSIX_FADV_SEQUENTIAL);
+        }
+    }
+
+    ~CacheFileBody() override {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    oatpp::v_io_size read(void* buffer, v_buff_size count, oatpp::async::Action& action) override {
+        (void)action;
+        if (remaining_ == 0 || count <= 0) {
+            return 0;
+        }
+        const size_t want = static_cast<size_t>(std::min<uint64_t>(remaining_, static_cast<uint64_t>(count)));
+        ssize_t n;
+        do {
+            n = ::pread(fd_, buffer, want, static_cast<off_t>(offset_));
+        } while (n < 0 && errno == EINTR);
+        if (n <= 0) {
+            // 读取失败或文件被截断：结束输出，客户端会因长度不足而重试
+            MYLOG_WARN("[FileApiController] 下载读取中断：offset={}, 剩余={} 字节", offset_, remaining_);
+            remaining_ = 0;
+            return 0;
+        }
+        offset_ += static_cast<uint64_t>(n);
+        remaining_ -= static_cast<uint64_t>(n);
+        return static_cast<oatpp::v_io_size>(n);
+    }
+
+    void declareHeaders(Headers& headers) override {
+        (void)headers;
+    }
+
+    p_char8 getKnownData() override {
+        return nullptr;
+    }
+
+    v_int64 getKnownSize() override {
+        return static_cast<v_int64>(length_);
     }
 
-    const auto* begin = reinterpret_cast<const uint8_t*>(data->data());
-    return std::vector<uint8_t>(begin, begin + data->size());
+private:
+    int fd_;
+    uint64_t offset_;
+    uint64_t length_;
+    uint64_t remaining_;
+};
+
+std::string HeaderToString(const std::shared_ptr<oatpp::web::protocol::http::incoming::Request>& request,
+                           const char* name) {
+    auto value = request ? request->getHeader(name) : nullptr;
+    return value ? std::string(value->c_str(), value->size()) : std::string();
 }
 
 bool IsMultipartFormData(const oatpp::String& content_type) {
@@ -116,8 +231,8 @@ MyAPIResponsePtr FileApiController::uploadFile(
         return jsonError(400, "data 字段 Base64 解码后为空");
     }
 
-    // 转换为 vector<uint8_t>
-    std::vector<uint8_t> file_data(decoded->begin(), decoded->end());
+    const auto* file_data = reinterpret_cast<const uint8_t*>(decoded->data());
+    const size_t file_size = decoded->size();
 
     auto cache_result = MyCacheProvider::Get();
     if (!cache_result.Ok()) {
@@ -127,7 +242,7 @@ MyAPIResponsePtr FileApiController::uploadFile(
                          {{"error_code", CacheErrorCodeToString(cache_result.code)}});
     }
 
-    auto save_result = cache_result.value->SaveFile(filename, file_data);
+    auto save_result = cache_result.value->SaveFile(filename, file_data, file_size);
     if (!save_result.Ok()) {
         int http_code = CacheErrorToHttpCode(save_result.code);
         MYLOG_WARN("[FileApiController] 文件保存失败：filename={}, 错误={}", filename, CacheErrorCodeToString(save_result.code));
@@ -137,8 +252,8 @@ MyAPIResponsePtr FileApiController::uploadFile(
                           {"filename", filename}});
     }
 
-    MYLOG_INFO("[FileApiController] 文件上传成功：filename={}, 大小={} 字节", filename, file_data.size());
-    return jsonOk({{"filename", filename}, {"size", file_data.size()}}, "文件上传成功");
+    MYLOG_INFO("[FileApiController] 文件上传成功：filename={}, 大小={} 字节", filename, file_size);
+    return jsonOk({{"filename", filename}, {"size", file_size}}, "文件上传成功");
 }
 
 // ============================================================================
@@ -168,8 +283,11 @@ MyAPIResponsePtr FileApiController::uploadLocalFile(
 
     auto multipart = std::make_shared<oatpp::web::mime::multipart::PartList>(request->getHeaders());
     oatpp::web::mime::multipart::Reader multipart_reader(multipart.get());
+    // file 字段直接流式落盘，其余文本字段在内存中读取（有大小上限）
+    auto file_reader = std::make_shared<CacheStreamPartReader>(cache_result.value);
+    multipart_reader.setPartReader("file", file_reader);
     multipart_reader.setDefaultPartReader(
-        oatpp::web::mime::multipart::createInMemoryPartReader(-1));
+        oatpp::web::mime::multipart::createInMemoryPartReader(kMaxTextPartSize));
 
     try {
         request->transferBody(&multipart_reader);
@@ -201,12 +319,23 @@ MyAPIResponsePtr FileApiController::uploadLocalFile(
         return jsonError(400, "file_name 校验失败", {{"detail", filename_err}});
     }
 
-    if (!file_part->getPayload()) {
+    if (file_reader->Error() != CacheErrorCode::Ok) {
+        const int http_code = CacheErrorToHttpCode(file_reader->Error());
+        MYLOG_WARN("[FileApiController] 客户端文件写入失败：file_name={}, 错误={}",
+                   file_name, CacheErrorCodeToString(file_reader->Error()));
+        return jsonError(http_code,
+                         "文件导入失败",
+                         {{"error_code", CacheErrorCodeToString(file_reader->Error())},
+                          {"file_name", file_name}});
+    }
+
+    auto* writer = file_reader->Writer();
+    if (!writer) {
         return jsonError(400, "上传文件内容为空");
     }
 
-    auto file_data = PartToBytes(file_part);
-    auto save_result = cache_result.value->SaveFile(file_name, file_data);
+    const uint64_t file_size = writer->BytesWritten();
+    auto save_result = writer->Commit(file_name);
     if (!save_result.Ok()) {
         const int http_code = CacheErrorToHttpCode(save_result.code);
         MYLOG_WARN("[FileApiController] 客户端文件导入失败：file_name={}, 错误={}",
@@ -218,9 +347,9 @@ MyAPIResponsePtr FileApiController::uploadLocalFile(
     }
 
     MYLOG_INFO("[FileApiController] 客户端本地文件导入成功：file_name={}, 大小={} 字节",
-               file_name, file_data.size());
+               file_name, file_size);
     return jsonOk({{"file_name", file_name},
-                   {"size", file_data.size()}},
+                   {"size", file_size}},
                   "文件导入成功");
 }
 
@@ -326,9 +455,23 @@ MyAPIResponsePtr FileApiController::deleteFile(
 MyAPIResponsePtr FileApiController::listFiles(const oatpp::Object<my_api::dto::CacheListRequestDto>& requestDto) {
     MYLOG_INFO("[FileApiController] listFiles 请求收到");
 
-    const std::string folder_path = requestDto && requestDto->folder_path
-        ? requestDto->folder_path->c_str()
-        : std::string();
+    my_cache::FileListQuery query;
+    std::string order;
+    uint32_t limit = 0;
+    if (requestDto) {
+        if (requestDto->folder_path) query.folder_path = requestDto->folder_path->c_str();
+        if (requestDto->prefix) query.prefix = requestDto->prefix->c_str();
+        if (requestDto->order) order = requestDto->order->c_str();
+        if (requestDto->limit) limit = *requestDto->limit;
+        if (requestDto->after) query.after = requestDto->after->c_str();
+    }
+    const std::string& folder_path = query.folder_path;
+
+    if (!ParseListOrder(order, query.order)) {
+        MYLOG_WARN("[FileApiController] 不支持的排序方式：order={}", order);
+        return jsonError(400, "order 仅支持 name 或 mtime_desc", {{"order", order}});
+    }
+    query.limit = ClampListLimit(limit);
 
     // 1. 获取 MyCache 实例
     auto cache_result = MyCacheProvider::Get();
@@ -339,8 +482,8 @@ MyAPIResponsePtr FileApiController::listFiles(const oatpp::Object<my_api::dto::C
                          {{"error_code", CacheErrorCodeToString(cache_result.code)}});
     }
 
-    // 2. 获取指定目录下的文件列表
-    auto list_result = cache_result.value->GetFileList(folder_path);
+    // 2. 获取指定目录下的一页文件列表
+    auto list_result = cache_result.value->GetFileList(query);
     if (!list_result.Ok()) {
         int http_code = CacheErrorToHttpCode(list_result.code);
         MYLOG_WARN("[FileApiController] 获取文件列表失败：folder_path={}, 错误={}",
@@ -352,8 +495,9 @@ MyAPIResponsePtr FileApiController::listFiles(const oatpp::Object<my_api::dto::C
     }
 
     // 3. 构造响应
+    const auto& page = list_result.value;
     json files_array = json::array();
-    for (const auto& fi : list_result.value) {
+    for (const auto& fi : page.files) {
         files_array.push_back({
             {"name", fi.name},
             {"size", fi.size},
@@ -362,14 +506,171 @@ MyAPIResponsePtr FileApiController::listFiles(const oatpp::Object<my_api::dto::C
         });
     }
 
-    MYLOG_INFO("[FileApiController] 文件列表查询成功：folder_path={}, 共 {} 个文件",
-               folder_path, list_result.value.size());
+    MYLOG_INFO("[FileApiController] 文件列表查询成功：folder_path={}, 本页 {} 个文件, has_more={}",
+               folder_path, page.files.size(), page.has_more);
     return jsonOk({{"folder_path", folder_path.empty() ? cache_result.value->GetRootPath() : folder_path},
                    {"files", files_array},
-                   {"total", list_result.value.size()}},
+                   {"total", page.total},
+                   {"has_more", page.has_more},
+                   {"next_cursor", page.next_cursor}},
                   "查询成功");
 }
 
+// ============================================================================
+// GET / HEAD /v1/cache/download
+// ============================================================================
+
+MyAPIResponsePtr FileApiController::downloadFile(
+    const oatpp::String& filename,
+    const std::shared_ptr<IncomingRequest>& request) {
+    return serveDownload(filename, request, false);
+}
+
+MyAPIResponsePtr FileApiController::headDownloadFile(
+    const oatpp::String& filename,
+    const std::shared_ptr<IncomingRequest>& request) {
+    return serveDownload(filename, request, true);
+}
+
+MyAPIResponsePtr FileApiController::serveDownload(
+    const oatpp::String& filename_param,
+    const std::shared_ptr<IncomingRequest>& request,
+    bool head_only) {
+    using Status = oatpp::web::protocol::http::Status;
+
+    const std::string filename = filename_param ? filename_param->c_str() : std::string();
+    MYLOG_INFO("[FileApiController] download 请求收到：filename={}, head={}", filename, head_only);
+
+    std::string filename_err;
+    if (!ValidateFilename(filename, filename_err)) {
+        MYLOG_WARN("[FileApiController] filename 校验失败：{}", filename_err);
+        return jsonError(400, "filename 校验失败", {{"detail", filename_err}});
+    }
+
+    auto cache_result = MyCacheProvider::Get();
+    if (!cache_result.Ok()) {
+        MYLOG_ERROR("[FileApiController] MyCache 未初始化");
+        return jsonError(CacheErrorToHttpCode(cache_result.code),
+                         "文件缓存服务未初始化",
+                         {{"error_code", CacheErrorCodeToString(cache_result.code)}});
+    }
+
+    auto path_result = cache_result.value->GetFullPath(filename);
+    if (!path_result.Ok()) {
+        return jsonError(CacheErrorToHttpCode(path_result.code),
+                         "文件路径解析失败",
+                         {{"error_code", CacheErrorCodeToString(path_result.code)},
+                          {"filename", filename}});
+    }
+
+    int fd = ::open(path_result.value.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st{};
+    if (fd < 0 || ::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        if (fd >= 0) ::close(fd);
+        MYLOG_WARN("[FileApiController] 下载目标不存在或不是常规文件：{}", filename);
+        return jsonError(404, "文件不存在",
+                         {{"error_code", CacheErrorCodeToString(CacheErrorCode::FileNotFound)},
+                          {"filename", filename}});
+    }
+
+    const uint64_t file_size = static_cast<uint64_t>(st.st_size);
+    const int64_t mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    const std::string etag = MakeFileETag(file_size, mtime_ns);
+
+    // 1. 条件请求：ETag 未变化直接返回 304
+    if (ETagMatches(HeaderToString(request, "If-None-Match"), etag)) {
+        ::close(fd);
+        auto res = OutgoingResponse::createShared(Status::CODE_304, nullptr);
+        res->putHeader("ETag", etag.c_str());
+        MYLOG_INFO("[FileApiController] 下载命中 ETag，返回 304：{}", filename);
+        return res;
+    }
+
+    // 2. Range：If-Range 与当前 ETag 不一致时忽略 Range，返回完整文件
+    uint64_t first = 0;
+    uint64_t last = file_size == 0 ? 0 : file_size - 1;
+    ByteRangeStatus range_status = ByteRangeStatus::None;
+    const std::string range_header = HeaderToString(request, "Range");
+    const std::string if_range = HeaderToString(request, "If-Range");
+    if (!range_header.empty() && (if_range.empty() || if_range == etag)) {
+        range_status = ParseByteRange(range_header, file_size, first, last);
+    }
+
+    if (range_status == ByteRangeStatus::Unsatisfiable) {
+        ::close(fd);
+        auto res = OutgoingResponse::createShared(Status::CODE_416, nullptr);
+        res->putHeader("Content-Range", ("bytes */" + std::to_string(file_size)).c_str());
+        res->putHeader("ETag", etag.c_str());
+        MYLOG_WARN("[FileApiController] Range 越界：filename={}, range={}", filename, range_header);
+        return res;
+    }
+
+    const bool partial = range_status == ByteRangeStatus::Satisfiable;
+    const uint64_t length = file_size == 0 ? 0 : (last - first + 1);
+
+    auto body = std::make_shared<CacheFileBody>(fd, first, length, head_only);
+    auto res = OutgoingResponse::createShared(partial ? Status::CODE_206 : Status::CODE_200, body);
+
+    std::string download_name = std::filesystem::path(filename).filename().string();
+    std::replace(download_name.begin(), download_name.end(), '"', '_');
+    res->putHeader("Content-Type", "application/octet-stream");
+    res->putHeader("Content-Disposition", ("attachment; filename=\"" + download_name + "\"").c_str());
+    res->putHeader("Accept-Ranges", "bytes");
+    res->putHeader("ETag", etag.c_str());
+    if (partial) {
+        res->putHeader("Content-Range",
+                       ("bytes " + std::to_string(first) + "-" + std::to_string(last) +
+                        "/" + std::to_string(file_size)).c_str());
+    }
+
+    MYLOG_INFO("[FileApiController] 下载开始：filename={}, 区间=[{}, {}], 长度={} 字节, partial={}",
+               filename, first, last, length, partial);
+    return res;
+}
+
+// ============================================================================
+// POST /v1/cache/pin
+// ============================================================================
+
+MyAPIResponsePtr FileApiController::pinFile(
+    const oatpp::Object<my_api::dto::CachePinRequestDto>& requestDto) {
+    MYLOG_INFO("[FileApiController] pinFile 请求收到");
+
+    if (!requestDto || !requestDto->filename) {
+        return jsonError(400, "缺少必需字段 filename 或类型错误");
+    }
+    std::string filename = requestDto->filename->c_str();
+    const bool pinned = requestDto->pinned ? *requestDto->pinned : true;
+
+    std::string filename_err;
+    if (!ValidateFilename(filename, filename_err)) {
+        MYLOG_WARN("[FileApiController] filename 校验失败：{}", filename_err);
+        return jsonError(400, "filename 校验失败", {{"detail", filename_err}});
+    }
+
+    auto cache_result = MyCacheProvider::Get();
+    if (!cache_result.Ok()) {
+        MYLOG_ERROR("[FileApiController] MyCache 未初始化");
+        return jsonError(CacheErrorToHttpCode(cache_result.code),
+                         "文件缓存服务未初始化",
+                         {{"error_code", CacheErrorCodeToString(cache_result.code)}});
+    }
+
+    auto pin_result = cache_result.value->SetPinned(filename, pinned);
+    if (!pin_result.Ok()) {
+        int http_code = CacheErrorToHttpCode(pin_result.code);
+        MYLOG_WARN("[FileApiController] 文件固定状态设置失败：filename={}, 错误={}",
+                   filename, CacheErrorCodeToString(pin_result.code));
+        return jsonError(http_code,
+                         "文件固定状态设置失败",
+                         {{"error_code", CacheErrorCodeToString(pin_result.code)},
+                          {"filename", filename}});
+    }
+
+    MYLOG_INFO("[FileApiController] 文件固定状态已更新：filename={}, pinned={}", filename, pinned);
+    return jsonOk({{"filename", filename}, {"pinned", pinned}}, "设置成功");
+}
+
 // ============================================================================
 // POST /v1/cache/create-folder
 // ============================================================================
@@ -435,6 +736,27 @@ MyAPIResponsePtr FileApiController::cacheInfo() {
     data["root_path"] = config.root_path;
     data["max_file_size"] = config.max_file_size;
     data["max_retention_seconds"] = config.max_retention_seconds;
+    data["max_total_bytes"] = config.max_total_bytes;
+    data["high_watermark"] = config.high_watermark;
+    data["low_watermark"] = config.low_watermark;
+
+    const auto usage = cache_result.value->GetUsage();
+    data["usage"] = {
+        {"total_bytes", usage.total_bytes},
+        {"file_count", usage.file_count},
+        {"pinned_count", usage.pinned_count},
+        {"evicted_files", usage.evicted_files},
+        {"evicted_bytes", usage.evicted_bytes},
+        {"stored_bytes", usage.stored_bytes}
+    };
+    data["dedup"] = {
+        {"enabled", config.dedup},
+        {"hash_accelerated", my_cache::Sha256::HardwareAccelerated()},
+        {"blob_count", usage.blob_count},
+        {"hits", usage.dedup_hits},
+        {"saved_bytes", usage.total_bytes > usage.stored_bytes ? usage.total_bytes - usage.stored_bytes : 0},
+        {"ratio", DedupRatio(usage.total_bytes, usage.stored_bytes)}
+    };
 
     MYLOG_INFO("[FileApiController] 缓存配置查询成功");
     return jsonOk(data, "查询成功");
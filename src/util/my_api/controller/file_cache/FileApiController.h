@@ -9,12 +9,15 @@
  *   - POST /v1/cache/upload-local —— 将客户端本地文件导入缓存目录
  *   - POST /v1/cache/query   —— 查询文件是否存在及完整路径
  *   - POST /v1/cache/delete  —— 删除缓存中的文件
- *   - POST /v1/cache/list    —— 获取所有文件列表
+ *   - POST /v1/cache/list    —— 分页获取文件列表
+ *   - GET  /v1/cache/download —— 下载缓存文件（支持 Range / ETag / HEAD）
+ *   - POST /v1/cache/pin     —— 固定/取消固定文件（固定文件不参与容量淘汰）
  *   - GET  /v1/cache/info    —— 获取缓存配置信息
   *   - POST /v1/cache/create-folder —— 创建子目录
  *   - GET  /v1/cache/status  —— 获取缓存运行状态
  *
  * 除 upload-local 使用 multipart/form-data 外，其余写接口使用 JSON Body，禁止路径变量。
+ * download 为只读接口，文件名通过查询参数传递。
  * 底层调用 MyCacheProvider::Get() 获取 MyCache 实例。
  */
 
@@ -66,7 +69,8 @@ public:
         info->description =
             "接收 multipart/form-data 请求。\n"
             "必须包含 file 文件字段，可选包含 file_name 文本字段作为缓存目标名称。\n"
-            "若 file_name 为空，则默认使用上传文件原始文件名。";
+            "若 file_name 为空，则默认使用上传文件原始文件名。\n"
+            "file 字段以流式方式直接写入磁盘，内存占用与文件大小无关。";
         info->addConsumes<oatpp::Object<my_api::dto::CacheUploadLocalMultipartDto>>("multipart/form-data");
         info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
         info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
@@ -114,7 +118,7 @@ public:
              BODY_DTO(oatpp::Object<my_api::dto::CacheFileRequestDto>, requestDto));
 
     // ====================================================================
-    // POST /v1/cache/list —— 获取所有文件列表
+    // POST /v1/cache/list —— 分页获取文件列表
     // ====================================================================
     ENDPOINT_INFO(listFiles) {
         info->addTag(SWAGGER_TAG);
@@ -122,7 +126,9 @@ public:
         info->description =
             "接收 JSON 请求体，可默认查询缓存根目录，\n"
             "也可指定缓存根目录内的子目录或绝对路径（仍需位于缓存根目录内）。\n"
-            "返回目录下所有文件的元信息，包括文件名、大小、类型、最后修改时间。";
+            "返回目录下文件的元信息，包括文件名、大小、类型、最后修改时间。\n"
+            "支持 prefix 前缀过滤、order 排序（name / mtime_desc）和 limit + after 游标分页，\n"
+            "has_more 为 true 时以响应中的 next_cursor 作为下一次请求的 after。";
         info->addConsumes<oatpp::Object<my_api::dto::CacheListRequestDto>>("application/json");
         info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
         info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
@@ -133,6 +139,65 @@ public:
     ENDPOINT("POST", "/v1/cache/list", listFiles,
              BODY_DTO(oatpp::Object<my_api::dto::CacheListRequestDto>, requestDto));
 
+    // ====================================================================
+    // GET /v1/cache/download —— 下载缓存文件
+    // ====================================================================
+    ENDPOINT_INFO(downloadFile) {
+        info->addTag(SWAGGER_TAG);
+        info->summary = "下载缓存文件";
+        info->description =
+            "通过查询参数 filename 下载缓存中的文件，文件内容分块从磁盘读取，不整体加载到内存。\n"
+            "支持 Range（单段）/ If-Range 断点续传，返回 206 Partial Content；\n"
+            "支持基于文件大小与修改时间的 ETag / If-None-Match，命中时返回 304。";
+        info->queryParams["filename"].description = "缓存中的文件相对路径，如 \"images/photo.jpg\"";
+        info->addResponse<oatpp::String>(Status::CODE_200, "application/octet-stream");
+        info->addResponse<oatpp::String>(Status::CODE_206, "application/octet-stream");
+        info->addResponse<oatpp::String>(Status::CODE_304, "application/octet-stream");
+        info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_403, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_404, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_416, "application/octet-stream");
+        info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
+    }
+    ENDPOINT("GET", "/v1/cache/download", downloadFile,
+             QUERY(String, filename),
+             REQUEST(std::shared_ptr<IncomingRequest>, request));
+
+    // ====================================================================
+    // HEAD /v1/cache/download —— 仅返回下载响应头
+    // ====================================================================
+    ENDPOINT_INFO(headDownloadFile) {
+        info->addTag(SWAGGER_TAG);
+        info->summary = "获取缓存文件下载响应头";
+        info->description =
+            "与 GET /v1/cache/download 返回相同的响应头（Content-Length、ETag、Accept-Ranges 等），不返回文件内容。";
+        info->queryParams["filename"].description = "缓存中的文件相对路径";
+        info->addResponse<oatpp::String>(Status::CODE_200, "application/octet-stream");
+        info->addResponse<oatpp::String>(Status::CODE_404, "application/json");
+    }
+    ENDPOINT("HEAD", "/v1/cache/download", headDownloadFile,
+             QUERY(String, filename),
+             REQUEST(std::shared_ptr<IncomingRequest>, request));
+
+    // ====================================================================
+    // POST /v1/cache/pin —— 固定/取消固定文件
+    // ====================================================================
+    ENDPOINT_INFO(pinFile) {
+        info->addTag(SWAGGER_TAG);
+        info->summary = "固定或取消固定缓存文件";
+        info->description =
+            "接收 JSON Body，固定的文件不参与总容量 LRU 淘汰和过期清理，\n"
+            "但仍可通过 /v1/cache/delete 显式删除。";
+        info->addConsumes<oatpp::Object<my_api::dto::CachePinRequestDto>>("application/json");
+        info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_403, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_404, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
+    }
+    ENDPOINT("POST", "/v1/cache/pin", pinFile,
+             BODY_DTO(oatpp::Object<my_api::dto::CachePinRequestDto>, requestDto));
+
     // ====================================================================
     // POST /v1/cache/create-folder —— 创建子目录
     // ====================================================================
@@ -162,7 +227,8 @@ public:
         info->summary = "获取缓存配置信息";
         info->description =
             "返回当前文件缓存模块的配置信息，\n"
-            "包括根目录路径、最大文件大小、最长保留时间等。";
+            "包括根目录路径、最大文件大小、最长保留时间、总容量上限与水位，\n"
+            "以及当前容量使用、LRU 淘汰统计和内容去重统计（内容块数、节省字节数、去重比）。";
         info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
         info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
     }
@@ -181,6 +247,12 @@ public:
         info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
     }
     ENDPOINT("GET", "/v1/cache/status", cacheStatus);
+
+private:
+    /// GET / HEAD 下载共用实现，head_only 为 true 时只发送响应头
+    MyAPIResponsePtr serveDownload(const oatpp::String& filename,
+                                   const std::shared_ptr<IncomingRequest>& request,
+                                   bool head_only);
 };
 
 #include OATPP_CODEGEN_END(ApiController)
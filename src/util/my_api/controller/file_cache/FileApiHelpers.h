@@ -9,6 +9,9 @@
 
 #include "CacheTypes.h"
 
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
 #include <string>
 #include <sstream>
 
@@ -88,4 +91,167 @@ inline int CacheErrorToHttpCode(my_cache::CacheErrorCode code) {
     }
 }
 
+// ============================================================================
+// 下载接口：Range / ETag 辅助函数
+// ============================================================================
+
+/**
+ * @brief Range 请求头解析结果
+ */
+enum class ByteRangeStatus {
+    None,            // 无 Range 头或格式不支持（多段范围等），返回完整文件
+    Satisfiable,     // 单段范围有效，返回 206
+    Unsatisfiable,   // 范围越界，返回 416
+};
+
+/**
+ * @brief 解析单段 Range 请求头（RFC 7233）
+ *
+ * 支持格式：
+ *   - bytes=START-END
+ *   - bytes=START-      （到文件末尾）
+ *   - bytes=-SUFFIX     （最后 SUFFIX 字节）
+ * 多段范围（含逗号）按规范允许忽略，返回 None。
+ *
+ * @param header Range 请求头原文
+ * @param file_size 文件大小（字节）
+ * @param[out] first 范围起始偏移（含）
+ * @param[out] last 范围结束偏移（含）
+ * @return ByteRangeStatus
+ */
+inline ByteRangeStatus ParseByteRange(const std::string& header, uint64_t file_size,
+                                      uint64_t& first, uint64_t& last) {
+    static const std::string kPrefix = "bytes=";
+    if (header.compare(0, kPrefix.size(), kPrefix) != 0) {
+        return ByteRangeStatus::None;
+    }
+    std::string spec = header.substr(kPrefix.size());
+    if (spec.find(',') != std::string::npos) {
+        return ByteRangeStatus::None;
+    }
+
+    auto dash = spec.find('-');
+    if (dash == std::string::npos) {
+        return ByteRangeStatus::None;
+    }
+    std::string first_str = spec.substr(0, dash);
+    std::string last_str = spec.substr(dash + 1);
+
+    auto parse_u64 = [](const std::string& text, uint64_t& out) {
+        if (text.empty() || text.size() > 19) return false;
+        out = 0;
+        for (char c : text) {
+            if (!std::isdigit(static_cast<unsigned char>(c))) return false;
+            out = out * 10 + static_cast<uint64_t>(c - '0');
+        }
+        return true;
+    };
+
+    if (first_str.empty()) {
+        // 后缀范围：最后 N 字节
+        uint64_t suffix = 0;
+        if (!parse_u64(last_str, suffix)) return ByteRangeStatus::None;
+        if (suffix == 0 || file_size == 0) return ByteRangeStatus::Unsatisfiable;
+        first = suffix >= file_size ? 0 : file_size - suffix;
+        last = file_size - 1;
+        return ByteRangeStatus::Satisfiable;
+    }
+
+    if (!parse_u64(first_str, first)) return ByteRangeStatus::None;
+    if (last_str.empty()) {
+        last = file_size == 0 ? 0 : file_size - 1;
+    } else if (!parse_u64(last_str, last) || last < first) {
+        return ByteRangeStatus::None;
+    }
+
+    if (first >= file_size) {
+        return ByteRangeStatus::Unsatisfiable;
+    }
+    if (last >= file_size) {
+        last = file_size - 1;
+    }
+    return ByteRangeStatus::Satisfiable;
+}
+
+/**
+ * @brief 根据文件大小和修改时间生成强 ETag
+ * @param file_size 文件大小（字节）
+ * @param mtime_ns 修改时间（纳秒）
+ * @return 带引号的 ETag，如 "\"1f4-17c9a2b3e1f00000\""
+ */
+inline std::string MakeFileETag(uint64_t file_size, int64_t mtime_ns) {
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "\"%llx-%llx\"",
+                  static_cast<unsigned long long>(file_size),
+                  static_cast<unsigned long long>(mtime_ns));
+    return buf;
+}
+
+/**
+ * @brief 判断 If-None-Match 请求头是否命中当前 ETag
+ *
+ * 支持 "*"、逗号分隔的多个 ETag 以及弱校验前缀 W/。
+ */
+inline bool ETagMatches(const std::string& if_none_match, const std::string& etag) {
+    if (if_none_match.empty()) return false;
+
+    std::string item;
+    std::istringstream stream(if_none_match);
+    while (std::getline(stream, item, ',')) {
+        auto begin = item.find_first_not_of(" \t");
+        auto end = item.find_last_not_of(" \t");
+        if (begin == std::string::npos) continue;
+        item = item.substr(begin, end - begin + 1);
+        if (item == "*") return true;
+        if (item.compare(0, 2, "W/") == 0) item = item.substr(2);
+        if (item == etag) return true;
+    }
+    return false;
+}
+
+/// list 接口默认单页条数（请求未指定 limit 时）
+constexpr uint32_t kDefaultListLimit = 1000;
+/// list 接口单页条数上限
+constexpr uint32_t kMaxListLimit = 10000;
+
+/**
+ * @brief 解析 list 接口的排序参数
+ * @param order 请求中的 order 字段："name"（默认，空字符串等同）或 "mtime_desc"
+ * @param[out] out 解析结果
+ * @return true 合法，false 不支持的取值
+ */
+inline bool ParseListOrder(const std::string& order, my_cache::FileListOrder& out) {
+    if (order.empty() || order == "name") {
+        out = my_cache::FileListOrder::ByName;
+        return true;
+    }
+    if (order == "mtime_desc") {
+        out = my_cache::FileListOrder::ByModifiedDesc;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 计算 list 接口实际单页条数
+ * @param requested 请求中的 limit，0 表示使用默认值
+ * @return 限制在 [1, kMaxListLimit] 内的条数
+ */
+inline size_t ClampListLimit(uint32_t requested) {
+    if (requested == 0) {
+        return kDefaultListLimit;
+    }
+    return requested > kMaxListLimit ? kMaxListLimit : requested;
+}
+
+/**
+ * @brief 计算去重比（逻辑总大小 / 实际占用），无数据时返回 1.0
+ */
+inline double DedupRatio(uint64_t logical_bytes, uint64_t stored_bytes) {
+    if (stored_bytes == 0) {
+        return 1.0;
+    }
+    return static_cast<double>(logical_bytes) / static_cast<double>(stored_bytes);
+}
+
 }  // namespace my_api::file_cache_api
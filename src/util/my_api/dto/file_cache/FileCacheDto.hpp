@@ -49,6 +49,26 @@ class CacheListRequestDto : public oatpp::DTO {
     DTO_INIT(CacheListRequestDto, DTO)
 
     DTO_FIELD(String, folder_path);
+
+    DTO_FIELD_INFO(prefix) {
+        info->description = "目录范围内的文件名前缀过滤，可选";
+    }
+    DTO_FIELD(String, prefix);
+
+    DTO_FIELD_INFO(order) {
+        info->description = "排序方式：name（默认，按名称升序）或 mtime_desc（按修改时间降序）";
+    }
+    DTO_FIELD(String, order);
+
+    DTO_FIELD_INFO(limit) {
+        info->description = "单页最大条数，默认 1000，最大 10000";
+    }
+    DTO_FIELD(UInt32, limit);
+
+    DTO_FIELD_INFO(after) {
+        info->description = "翻页游标，传入上一页响应中的 next_cursor";
+    }
+    DTO_FIELD(String, after);
 };
 
 class CacheCreateFolderRequestDto : public oatpp::DTO {
@@ -58,6 +78,18 @@ class CacheCreateFolderRequestDto : public oatpp::DTO {
     DTO_FIELD(String, new_folder_name);
 };
 
+class CachePinRequestDto : public oatpp::DTO {
+    DTO_INIT(CachePinRequestDto, DTO)
+
+    DTO_FIELD(String, filename);
+    DTO_FIELD(Boolean, pinned) = true;
+
+    DTO_FIELD_INFO(pinned) {
+        info->description = "true 固定文件（不参与容量淘汰和过期清理），false 取消固定";
+        info->required = false;
+    }
+};
+
 #include OATPP_CODEGEN_END(DTO)
 
 }  // namespace my_api::dto
\ No newline at end of file
@@ -0,0 +1,102 @@
+/**
+ * @file CacheFileWriter.cpp
+ * @brief my_cache 流式写入器 —— 实现文件
+ */
+
+#include "CacheFileWriter.h"
+#include "MyCache.h"
+#include "MyLog.h"
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+namespace my_cache {
+
+CacheFileWriter::CacheFileWriter(MyCache* owner, int fd, std::filesystem::path tmp_path,
+                                 uint64_t max_file_size, bool hash_content)
+    : owner_(owner),
+      fd_(fd),
+      tmp_path_(std::move(tmp_path)),
+      max_file_size_(max_file_size),
+      hasher_(hash_content ? std::make_unique<Sha256>() : nullptr) {
+    MYLOG_DEBUG("[CacheFileWriter] 打开临时文件：{}", tmp_path_.string());
+}
+
+CacheFileWriter::~CacheFileWriter() {
+    if (fd_ >= 0) {
+        MYLOG_WARN("[CacheFileWriter] 写入器未提交即析构，放弃临时文件：{}", tmp_path_.string());
+        Abort();
+    }
+}
+
+CacheResult<void> CacheFileWriter::Append(const uint8_t* data, size_t size) {
+    if (fd_ < 0) {
+        return CacheResult<void>::Fail(CacheErrorCode::IoError);
+    }
+    if (size == 0) {
+        return CacheResult<void>::Success();
+    }
+
+    // 增量校验大小限制，超限立即删除临时文件，避免继续占用磁盘
+    if (max_file_size_ > 0 && bytes_written_ + size > max_file_size_) {
+        MYLOG_WARN("[CacheFileWriter] 文件超过大小限制：已写入={} 字节, 本次={} 字节, 限制={} 字节",
+                   bytes_written_, size, max_file_size_);
+        Abort();
+        return CacheResult<void>::Fail(CacheErrorCode::FileTooLarge);
+    }
+
+    size_t offset = 0;
+    while (offset < size) {
+        ssize_t n = ::write(fd_, data + offset, size - offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            MYLOG_ERROR("[CacheFileWriter] 写入临时文件失败：{}, 错误：{}",
+                        tmp_path_.string(), std::strerror(errno));
+            Abort();
+            return CacheResult<void>::Fail(CacheErrorCode::IoError);
+        }
+        offset += static_cast<size_t>(n);
+    }
+
+    if (hasher_) {
+        hasher_->Update(data, size);
+    }
+    bytes_written_ += size;
+    return CacheResult<void>::Success();
+}
+
+CacheResult<void> CacheFileWriter::Commit(const std::string& name) {
+    if (fd_ < 0) {
+        MYLOG_WARN("[CacheFileWriter] 写入器已关闭，无法提交：name={}", name);
+        return CacheResult<void>::Fail(CacheErrorCode::IoError);
+    }
+
+    // 落盘后再重命名，保证目标文件要么是完整新内容，要么是旧内容
+    if (::fsync(fd_) != 0) {
+        MYLOG_ERROR("[CacheFileWriter] fsync 失败：{}, 错误：{}", tmp_path_.string(), std::strerror(errno));
+        Abort();
+        return CacheResult<void>::Fail(CacheErrorCode::IoError);
+    }
+    ::close(fd_);
+    fd_ = -1;
+
+    const std::string content_hash = hasher_ ? hasher_->HexDigest() : std::string();
+    auto result = owner_->CommitStagedFile(tmp_path_, name, bytes_written_, content_hash);
+    if (!result.Ok()) {
+        std::error_code ec;
+        std::filesystem::remove(tmp_path_, ec);
+    }
+    return result;
+}
+
+void CacheFileWriter::Abort() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    std::error_code ec;
+    std::filesystem::remove(tmp_path_, ec);
+}
+
+}  // namespace my_cache
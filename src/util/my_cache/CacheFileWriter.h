@@ -0,0 +1,83 @@
+#pragma once
+
+/**
+ * @file CacheFileWriter.h
+ * @brief my_cache 流式写入器
+ *
+ * 用于大文件分块写入缓存目录，内存占用与文件大小无关：
+ *   1. MyCache::OpenWriter() 在暂存目录中创建临时文件
+ *   2. Append() 逐块追加数据，并增量校验 max_file_size
+ *   3. Commit(name) 执行 fsync 后原子重命名到目标路径并更新索引
+ *   4. 未 Commit 的写入器在析构时自动 Abort，删除临时文件
+ *   5. 去重模式下 Append 时增量计算 SHA-256，Commit 时据此定位内容块
+ *
+ * 线程安全：单个写入器实例只允许一个线程使用。
+ */
+
+#include "CacheTypes.h"
+#include "ContentHash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace my_cache {
+
+class MyCache;
+
+/**
+ * @brief 缓存文件流式写入器（由 MyCache::OpenWriter 创建）
+ */
+class CacheFileWriter {
+public:
+    /// 析构时若尚未提交，自动放弃并删除临时文件
+    ~CacheFileWriter();
+
+    // 禁止拷贝和移动（持有文件描述符）
+    CacheFileWriter(const CacheFileWriter&) = delete;
+    CacheFileWriter& operator=(const CacheFileWriter&) = delete;
+    CacheFileWriter(CacheFileWriter&&) = delete;
+    CacheFileWriter& operator=(CacheFileWriter&&) = delete;
+
+    /**
+     * @brief 追加一块数据到临时文件
+     * @param data 数据指针
+     * @param size 数据长度（字节），为 0 时直接返回成功
+     * @return CacheResult<void>，累计大小超出 max_file_size 时返回 FileTooLarge，
+     *         此时临时文件已被删除，写入器不可继续使用
+     */
+    CacheResult<void> Append(const uint8_t* data, size_t size);
+
+    /**
+     * @brief 提交写入：fsync 后原子重命名为缓存中的 name
+     * @param name 目标文件相对路径名（同 MyCache::SaveFile）
+     * @return CacheResult<void>，失败时临时文件已被删除
+     */
+    CacheResult<void> Commit(const std::string& name);
+
+    /// 放弃写入并删除临时文件（可重复调用）
+    void Abort();
+
+    /// 已写入的字节数
+    uint64_t BytesWritten() const { return bytes_written_; }
+
+    /// 写入器是否仍可继续 Append / Commit
+    bool IsOpen() const { return fd_ >= 0; }
+
+private:
+    friend class MyCache;
+
+    CacheFileWriter(MyCache* owner, int fd, std::filesystem::path tmp_path, uint64_t max_file_size,
+                    bool hash_content);
+
+    MyCache* owner_ = nullptr;            // 所属缓存实例
+    int fd_ = -1;                         // 临时文件描述符，-1 表示已关闭
+    std::filesystem::path tmp_path_;      // 暂存目录中的临时文件路径
+    uint64_t max_file_size_ = 0;          // 单文件大小上限，0 表示不限制
+    uint64_t bytes_written_ = 0;          // 已写入字节数
+    std::unique_ptr<Sha256> hasher_;      // 内容摘要（仅去重模式下创建）
+};
+
+}  // namespace my_cache
@@ -8,6 +8,8 @@
  *   - CacheStatus 模块状态枚举
  *   - CacheConfig 配置结构体（由 Init 的 JSON 参数解析得到）
  *   - FileInfo 文件元信息结构体
+ *   - CacheUsage 容量使用与淘汰统计
+ *   - FileListQuery / FileListPage 分页列表查询参数与结果
  *   - CacheErrorCode 错误码枚举
  *   - CacheErrorCodeToString 错误码转字符串
  *   - CacheResult<T> 通用返回值包装类
@@ -49,15 +51,22 @@ const char* CacheStatusToString(CacheStatus status);
  * @code{.json}
  * {
  *     "root_path": "/data/cache",
- *     "max_file_size": 104857600,
- *     "max_retention_seconds": 86400
+ *     "max_file_size": 100,
+ *     "max_retention_seconds": 86400,
+ *     "max_total_bytes": 10737418240,
+ *     "high_watermark": 0.95,
+ *     "low_watermark": 0.85
  * }
  * @endcode
  */
 struct CacheConfig {
     std::string root_path;                  ///< 缓存根目录路径（必填）
-    uint64_t max_file_size = 0;             ///< 单个文件最大大小（字节），0 表示不限制
+    uint64_t max_file_size = 0;             ///< 单个文件最大大小（字节，JSON 中以 MB 输入），0 表示不限制
     int64_t max_retention_seconds = 0;      ///< 文件最长保留时间（秒），0 表示不限制，-1 表示永久有效
+    uint64_t max_total_bytes = 0;           ///< 缓存目录总容量上限（字节），0 表示不限制
+    double high_watermark = 0.95;           ///< 总量超过 max_total_bytes * high_watermark 时触发 LRU 淘汰
+    double low_watermark = 0.85;            ///< 淘汰至 max_total_bytes * low_watermark 以下停止
+    bool dedup = false;                     ///< 内容寻址去重：相同内容只存一份，文件名为指向内容块的硬链接
 };
 
 // ============================================================================
@@ -72,6 +81,62 @@ struct FileInfo {
     uint64_t size = 0;         ///< 文件大小（字节）
     std::string type;          ///< 文件扩展名（如 "txt"、"bin"，无扩展名为空）
     std::string modified_at;   ///< 最后修改时间（ISO 8601 格式，如 "2026-03-31T14:30:00"）
+    int64_t modified_ns = 0;   ///< 最后修改时间（Unix 纪元纳秒），排序与游标使用，不受时区/夏令时影响
+};
+
+// ============================================================================
+// 分页列表查询
+// ============================================================================
+
+/**
+ * @brief 文件列表排序方式
+ */
+enum class FileListOrder {
+    ByName = 0,        // 按相对路径字典序升序
+    ByModifiedDesc,    // 按最后修改时间降序（最新的在前）
+};
+
+/**
+ * @brief 分页列表查询参数
+ *
+ * 基于内存有序索引实现：按名称排序时目录/前缀过滤为区间查询，
+ * 单页代价为 O(log n + limit)；按修改时间排序且无目录/前缀过滤时同为 O(log n + limit)，
+ * 有过滤时只在匹配区间内选出一页，代价与匹配数成正比而与缓存总文件数无关。
+ */
+struct FileListQuery {
+    std::string folder_path;                    ///< 目录范围，空字符串表示根目录（规则同 GetFileList）
+    std::string prefix;                         ///< 目录范围内的文件名前缀过滤，如 "2026/" 或 "img_"
+    FileListOrder order = FileListOrder::ByName;///< 排序方式
+    size_t limit = 0;                           ///< 单页最大条数，0 表示不分页
+    std::string after;                          ///< 游标：上一页返回的 next_cursor，空表示第一页
+};
+
+/**
+ * @brief 分页列表查询结果
+ */
+struct FileListPage {
+    std::vector<FileInfo> files;   ///< 当前页文件列表
+    bool has_more = false;         ///< 是否还有下一页
+    std::string next_cursor;       ///< 下一页游标（不透明字符串），has_more 为 false 时为空
+    size_t total = 0;              ///< 满足目录/前缀条件的文件总数（不受分页影响）
+};
+
+// ============================================================================
+// 容量统计
+// ============================================================================
+
+/**
+ * @brief 缓存容量使用与淘汰统计
+ */
+struct CacheUsage {
+    uint64_t total_bytes = 0;      ///< 索引中所有文件的总大小（字节）
+    uint64_t file_count = 0;       ///< 索引中的文件数量
+    uint64_t pinned_count = 0;     ///< 被固定（不参与淘汰和过期清理）的文件数量
+    uint64_t evicted_files = 0;    ///< 累计被 LRU 淘汰的文件数量
+    uint64_t evicted_bytes = 0;    ///< 累计被 LRU 淘汰的字节数
+    uint64_t stored_bytes = 0;     ///< 实际占用的磁盘字节数（去重后；未开启去重时等于 total_bytes）
+    uint64_t blob_count = 0;       ///< 去重内容块数量
+    uint64_t dedup_hits = 0;       ///< 累计命中已有内容块的写入次数
 };
 
 // ============================================================================
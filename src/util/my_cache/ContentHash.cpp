@@ -0,0 +1,226 @@
+/**
+ * @file ContentHash.cpp
+ * @brief my_cache 内容寻址用的流式 SHA-256 —— 实现文件
+ */
+
+#include "ContentHash.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MY_CACHE_SHA256_X86 1
+#include <immintrin.h>
+#endif
+
+namespace my_cache {
+
+namespace {
+
+alignas(16) constexpr uint32_t kRoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+constexpr uint32_t kInitialState[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+inline uint32_t Rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+inline uint32_t LoadBigEndian32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+/// 可移植压缩函数
+void CompressPortable(uint32_t state[8], const uint8_t* blocks, size_t block_count) {
+    uint32_t w[64];
+    for (; block_count > 0; --block_count, blocks += 64) {
+        for (int t = 0; t < 16; ++t) {
+            w[t] = LoadBigEndian32(blocks + 4 * t);
+        }
+        for (int t = 16; t < 64; ++t) {
+            const uint32_t s0 = Rotr(w[t - 15], 7) ^ Rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+            const uint32_t s1 = Rotr(w[t - 2], 17) ^ Rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int t = 0; t < 64; ++t) {
+            const uint32_t s1 = Rotr(e, 6) ^ Rotr(e, 11) ^ Rotr(e, 25);
+            const uint32_t ch = (e & f) ^ (~e & g);
+            const uint32_t t1 = h + s1 + ch + kRoundConstants[t] + w[t];
+            const uint32_t s0 = Rotr(a, 2) ^ Rotr(a, 13) ^ Rotr(a, 22);
+            const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            const uint32_t t2 = s0 + maj;
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+#if defined(MY_CACHE_SHA256_X86)
+
+/**
+ * SHA-NI 压缩函数：每组 4 轮，消息扩展用 sha256msg1/msg2，
+ * 状态按 sha256rnds2 要求的 ABEF/CDGH 排布保存。
+ */
+__attribute__((target("sha,sse4.1,ssse3")))
+void CompressShaNi(uint32_t state[8], const uint8_t* blocks, size_t block_count) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+    __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);                 // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1B);           // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);   // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);        // CDGH
+
+    for (; block_count > 0; --block_count, blocks += 64) {
+        const __m128i abef_save = state0;
+        const __m128i cdgh_save = state1;
+        __m128i m[4];
+
+        for (int i = 0; i < 16; ++i) {
+            if (i < 4) {
+                m[i] = _mm_shuffle_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 16 * i)), byte_swap);
+            }
+            __m128i msg = _mm_add_epi32(
+                m[i % 4], _mm_load_si128(reinterpret_cast<const __m128i*>(&kRoundConstants[4 * i])));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            if (i >= 3 && i <= 14) {
+                __m128i& next = m[(i + 1) % 4];
+                next = _mm_add_epi32(next, _mm_alignr_epi8(m[i % 4], m[(i + 3) % 4], 4));
+                next = _mm_sha256msg2_epu32(next, m[i % 4]);
+            }
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+            if (i >= 1 && i <= 12) {
+                m[(i + 3) % 4] = _mm_sha256msg1_epu32(m[(i + 3) % 4], m[i % 4]);
+            }
+        }
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);              // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);           // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);        // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);           // HGFE
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
+
+bool DetectShaNi() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+}
+
+#endif
+
+}  // namespace
+
+Sha256::Sha256(bool allow_hardware) : compress_(&CompressPortable) {
+#if defined(MY_CACHE_SHA256_X86)
+    if (allow_hardware && HardwareAccelerated()) {
+        compress_ = &CompressShaNi;
+    }
+#else
+    (void)allow_hardware;
+#endif
+    std::memcpy(state_, kInitialState, sizeof(state_));
+}
+
+bool Sha256::HardwareAccelerated() {
+#if defined(MY_CACHE_SHA256_X86)
+    static const bool supported = DetectShaNi();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+void Sha256::Update(const uint8_t* data, size_t size) {
+    total_bytes_ += size;
+
+    // 先补齐上次残留的不完整分组
+    if (buffered_ > 0) {
+        const size_t take = std::min(size, sizeof(buffer_) - buffered_);
+        std::memcpy(buffer_ + buffered_, data, take);
+        buffered_ += take;
+        data += take;
+        size -= take;
+        if (buffered_ < sizeof(buffer_)) {
+            return;
+        }
+        compress_(state_, buffer_, 1);
+        buffered_ = 0;
+    }
+
+    // 完整分组直接从调用方缓冲区压缩，不做拷贝
+    const size_t blocks = size / 64;
+    if (blocks > 0) {
+        compress_(state_, data, blocks);
+        data += blocks * 64;
+        size -= blocks * 64;
+    }
+
+    if (size > 0) {
+        std::memcpy(buffer_, data, size);
+        buffered_ = size;
+    }
+}
+
+Sha256::Digest Sha256::Final() {
+    const uint64_t bit_length = total_bytes_ * 8;
+
+    buffer_[buffered_++] = 0x80;
+    if (buffered_ > 56) {
+        std::memset(buffer_ + buffered_, 0, sizeof(buffer_) - buffered_);
+        compress_(state_, buffer_, 1);
+        buffered_ = 0;
+    }
+    std::memset(buffer_ + buffered_, 0, 56 - buffered_);
+    for (int i = 0; i < 8; ++i) {
+        buffer_[56 + i] = static_cast<uint8_t>(bit_length >> (56 - 8 * i));
+    }
+    compress_(state_, buffer_, 1);
+    buffered_ = 0;
+
+    Digest digest{};
+    for (int i = 0; i < 8; ++i) {
+        digest[4 * i + 0] = static_cast<uint8_t>(state_[i] >> 24);
+        digest[4 * i + 1] = static_cast<uint8_t>(state_[i] >> 16);
+        digest[4 * i + 2] = static_cast<uint8_t>(state_[i] >> 8);
+        digest[4 * i + 3] = static_cast<uint8_t>(state_[i]);
+    }
+    return digest;
+}
+
+std::string Sha256::HexDigest() {
+    static constexpr char kHex[] = "0123456789abcdef";
+    const Digest digest = Final();
+    std::string hex(digest.size() * 2, '0');
+    for (size_t i = 0; i < digest.size(); ++i) {
+        hex[2 * i] = kHex[digest[i] >> 4];
+        hex[2 * i + 1] = kHex[digest[i] & 0x0F];
+    }
+    return hex;
+}
+
+}  // namespace my_cache
@@ -0,0 +1,61 @@
+#pragma once
+
+/**
+ * @file ContentHash.h
+ * @brief my_cache 内容寻址用的流式 SHA-256
+ *
+ * 去重模式下，CacheFileWriter 在 Append 时增量计算摘要，Commit 时无需再次读取文件。
+ * x86-64 上运行时检测 SHA 扩展指令（SHA-NI），可用时走硬件压缩函数，否则使用可移植实现。
+ *
+ * 线程安全：单个实例只允许一个线程使用。
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace my_cache {
+
+/**
+ * @brief 流式 SHA-256 摘要计算器
+ *
+ * 使用方式：
+ *   Sha256 h;
+ *   h.Update(chunk1, n1);
+ *   h.Update(chunk2, n2);
+ *   std::string hex = h.HexDigest();
+ */
+class Sha256 {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    /**
+     * @brief 构造摘要计算器
+     * @param allow_hardware 是否允许使用硬件加速（测试中可关闭以对比可移植实现）
+     */
+    explicit Sha256(bool allow_hardware = true);
+
+    /// 追加一段数据
+    void Update(const uint8_t* data, size_t size);
+
+    /// 结束计算并返回摘要（调用后实例不可继续 Update）
+    Digest Final();
+
+    /// 结束计算并返回 64 字符小写十六进制摘要
+    std::string HexDigest();
+
+    /// 当前 CPU 是否支持硬件加速
+    static bool HardwareAccelerated();
+
+private:
+    using CompressFn = void (*)(uint32_t state[8], const uint8_t* blocks, size_t block_count);
+
+    CompressFn compress_;              // 压缩函数（可移植实现或 SHA-NI 实现）
+    uint32_t state_[8];                // 中间哈希值
+    uint8_t buffer_[64];               // 未满一个分组的剩余数据
+    size_t buffered_ = 0;              // buffer_ 中的有效字节数
+    uint64_t total_bytes_ = 0;         // 已输入的总字节数
+};
+
+}  // namespace my_cache
@@ -8,8 +8,16 @@
 
 #include <nlohmann/json.hpp>
 #include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
 #include <ctime>
-#include <fstream>
+#include <functional>
+#include <limits>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using json = nlohmann::json;
 
@@ -21,13 +29,27 @@ namespace my_cache {
 
 namespace {
 
-/// 将 filesystem::file_time_type 转为 ISO 8601 字符串
-std::string FormatFileTime(const std::filesystem::file_time_type& ftime) {
-    auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+/// 将 filesystem::file_time_type 转为 system_clock 时间点
+std::chrono::system_clock::time_point ToSystemTime(const std::filesystem::file_time_type& ftime) {
+    return std::chrono::time_point_cast<std::chrono::system_clock::duration>(
         ftime - std::filesystem::file_time_type::clock::now()
              + std::chrono::system_clock::now()
     );
-    std::time_t t = std::chrono::system_clock::to_time_t(sctp);
+}
+
+/// 将 system_clock 时间点转为 Unix 纪元纳秒（索引排序键）
+int64_t ToEpochNs(std::chrono::system_clock::time_point tp) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+}
+
+/// 将 filesystem::file_time_type 转为 Unix 纪元纳秒（索引排序键）
+int64_t FileTimeToEpochNs(const std::filesystem::file_time_type& ftime) {
+    return ToEpochNs(ToSystemTime(ftime));
+}
+
+/// 将 system_clock 时间点转为 ISO 8601 字符串
+std::string FormatSystemTime(std::chrono::system_clock::time_point tp) {
+    std::time_t t = std::chrono::system_clock::to_time_t(tp);
     std::tm tm{};
     localtime_r(&t, &tm);
     char buf[32];
@@ -35,6 +57,11 @@ std::string FormatFileTime(const std::filesystem::file_time_type& ftime) {
     return buf;
 }
 
+/// 将 filesystem::file_time_type 转为 ISO 8601 字符串
+std::string FormatFileTime(const std::filesystem::file_time_type& ftime) {
+    return FormatSystemTime(ToSystemTime(ftime));
+}
+
 /// 提取文件扩展名（不含 '.'），如 "txt"、"bin"，无扩展名返回空
 std::string GetFileExtension(const std::string& name) {
     auto pos = name.rfind('.');
@@ -159,9 +186,30 @@ CacheResult<void> MyCache::Init(const std::string& config_json) {
     if (jcfg.contains("max_retention_seconds") && jcfg["max_retention_seconds"].is_number()) {
         config_.max_retention_seconds = jcfg["max_retention_seconds"].get<int64_t>();
     }
+    if (jcfg.contains("max_total_bytes") && jcfg["max_total_bytes"].is_number_unsigned()) {
+        config_.max_total_bytes = jcfg["max_total_bytes"].get<uint64_t>();
+    }
+    if (jcfg.contains("high_watermark") && jcfg["high_watermark"].is_number()) {
+        config_.high_watermark = jcfg["high_watermark"].get<double>();
+    }
+    if (jcfg.contains("low_watermark") && jcfg["low_watermark"].is_number()) {
+        config_.low_watermark = jcfg["low_watermark"].get<double>();
+    }
+    if (jcfg.contains("dedup") && jcfg["dedup"].is_boolean()) {
+        config_.dedup = jcfg["dedup"].get<bool>();
+    }
+    if (config_.low_watermark <= 0.0 || config_.low_watermark > config_.high_watermark ||
+        config_.high_watermark > 1.0) {
+        MYLOG_ERROR("[MyCache] 水位配置非法：high_watermark={}, low_watermark={}",
+                    config_.high_watermark, config_.low_watermark);
+        status_.store(CacheStatus::Error);
+        return CacheResult<void>::Fail(CacheErrorCode::InvalidArgument);
+    }
 
-    MYLOG_INFO("[MyCache] 配置解析完成：root_path={}, max_file_size={}, max_retention_seconds={}",
-               config_.root_path, config_.max_file_size, config_.max_retention_seconds);
+    MYLOG_INFO("[MyCache] 配置解析完成：root_path={}, max_file_size={}, max_retention_seconds={}, "
+               "max_total_bytes={}, high_watermark={}, low_watermark={}, dedup={}",
+               config_.root_path, config_.max_file_size, config_.max_retention_seconds,
+               config_.max_total_bytes, config_.high_watermark, config_.low_watermark, config_.dedup);
 
     // 3. 对传入路径进行规范化处理
     std::error_code ec;
@@ -200,6 +248,28 @@ CacheResult<void> MyCache::Init(const std::string& config_json) {
 
     MYLOG_INFO("[MyCache] 规范化根目录：{}", root_path_.string());
 
+    // 暂存目录：清理上次异常退出残留的未提交临时文件
+    staging_path_ = root_path_ / kStagingDirName;
+    std::filesystem::remove_all(staging_path_, ec);
+    if (!std::filesystem::create_directories(staging_path_, ec) && ec) {
+        MYLOG_ERROR("[MyCache] 创建暂存目录失败：{}, 错误：{}", staging_path_.string(), ec.message());
+        status_.store(CacheStatus::Error);
+        return CacheResult<void>::Fail(CacheErrorCode::CreateDirFailed);
+    }
+
+    // 内容块目录：未开启去重时整体删除（文件名是硬链接，不影响已有文件内容）
+    blob_path_ = root_path_ / kBlobDirName;
+    if (config_.dedup) {
+        if (!std::filesystem::create_directories(blob_path_, ec) && ec) {
+            MYLOG_ERROR("[MyCache] 创建内容块目录失败：{}, 错误：{}", blob_path_.string(), ec.message());
+            status_.store(CacheStatus::Error);
+            return CacheResult<void>::Fail(CacheErrorCode::CreateDirFailed);
+        }
+        MYLOG_INFO("[MyCache] 内容寻址去重已开启，SHA-256 硬件加速：{}", Sha256::HardwareAccelerated());
+    } else {
+        std::filesystem::remove_all(blob_path_, ec);
+    }
+
     // 4. 首次扫描建立索引
     RefreshIndex();
 
@@ -209,6 +279,9 @@ CacheResult<void> MyCache::Init(const std::string& config_json) {
     scan_thread_ = std::thread(&MyCache::ScanThreadFunc, this);
 
     MYLOG_INFO("[MyCache] 初始化完成，后台扫描线程已启动，扫描间隔 {} 秒", kScanIntervalSec);
+
+    // 启动时已超出容量上限则立即淘汰
+    RequestEviction();
     return CacheResult<void>::Success();
 }
 
@@ -323,7 +396,11 @@ CacheErrorCode MyCache::ValidateDirectoryPath(const std::string& folder_path,
 
 CacheResult<void> MyCache::SaveFile(const std::string& name,
                                     const std::vector<uint8_t>& data) {
-    MYLOG_DEBUG("[MyCache] SaveFile 请求：name={}, 数据大小={} 字节", name, data.size());
+    return SaveFile(name, data.data(), data.size());
+}
+
+CacheResult<void> MyCache::SaveFile(const std::string& name, const uint8_t* data, size_t size) {
+    MYLOG_DEBUG("[MyCache] SaveFile 请求：name={}, 数据大小={} 字节", name, size);
 
     std::filesystem::path full_path;
     auto code = ValidatePath(name, full_path);
@@ -333,12 +410,78 @@ CacheResult<void> MyCache::SaveFile(const std::string& name,
     }
 
     // 检查文件大小限制
-    if (config_.max_file_size > 0 && data.size() > config_.max_file_size) {
+    if (config_.max_file_size > 0 && size > config_.max_file_size) {
         MYLOG_WARN("[MyCache] 文件超过大小限制：name={}, 大小={} 字节, 限制={} 字节",
-                   name, data.size(), config_.max_file_size);
+                   name, size, config_.max_file_size);
         return CacheResult<void>::Fail(CacheErrorCode::FileTooLarge);
     }
 
+    // 写入文件（原子：先写暂存目录中的临时文件再重命名）
+    auto writer_result = OpenWriter();
+    if (!writer_result.Ok()) {
+        return CacheResult<void>::Fail(writer_result.code);
+    }
+    auto& writer = writer_result.value;
+
+    auto append_result = writer->Append(data, size);
+    if (!append_result.Ok()) {
+        return append_result;
+    }
+
+    auto commit_result = writer->Commit(name);
+    if (!commit_result.Ok()) {
+        return commit_result;
+    }
+
+    MYLOG_INFO("[MyCache] 文件保存成功：{}, 大小={} 字节", name, size);
+    return CacheResult<void>::Success();
+}
+
+CacheResult<std::unique_ptr<CacheFileWriter>> MyCache::OpenWriter() {
+    using WriterResult = CacheResult<std::unique_ptr<CacheFileWriter>>;
+
+    if (status_.load() != CacheStatus::Running) {
+        MYLOG_WARN("[MyCache] 模块尚未初始化");
+        return WriterResult::Fail(CacheErrorCode::NotInitialized);
+    }
+
+    // 暂存目录可能被外部删除，按需重建
+    std::error_code ec;
+    if (!std::filesystem::exists(staging_path_, ec)) {
+        if (!std::filesystem::create_directories(staging_path_, ec) && ec) {
+            MYLOG_ERROR("[MyCache] 创建暂存目录失败：{}, 错误：{}", staging_path_.string(), ec.message());
+            return WriterResult::Fail(CacheErrorCode::CreateDirFailed);
+        }
+    }
+
+    std::string tmpl = (staging_path_ / "upload-XXXXXX").string();
+    int fd = ::mkstemp(tmpl.data());
+    if (fd < 0) {
+        MYLOG_ERROR("[MyCache] 创建临时文件失败：{}, 错误：{}", tmpl, std::strerror(errno));
+        return WriterResult::Fail(CacheErrorCode::IoError);
+    }
+    ::fchmod(fd, 0644);
+
+    std::unique_ptr<CacheFileWriter> writer(
+        new CacheFileWriter(this, fd, std::filesystem::path(tmpl), config_.max_file_size, config_.dedup));
+    return WriterResult::Success(std::move(writer));
+}
+
+CacheResult<void> MyCache::CommitStagedFile(const std::filesystem::path& tmp_path,
+                                            const std::string& name,
+                                            uint64_t size,
+                                            const std::string& content_hash) {
+    std::filesystem::path full_path;
+    auto code = ValidatePath(name, full_path);
+    if (code != CacheErrorCode::Ok) {
+        MYLOG_WARN("[MyCache] 提交路径校验失败：name={}, 错误码={}", name, CacheErrorCodeToString(code));
+        return CacheResult<void>::Fail(code);
+    }
+    if (IsInternalPath(std::filesystem::relative(full_path, root_path_))) {
+        MYLOG_WARN("[MyCache] 不允许写入内部目录：{}", name);
+        return CacheResult<void>::Fail(CacheErrorCode::InvalidArgument);
+    }
+
     // 确保父目录存在
     std::error_code ec;
     auto parent = full_path.parent_path();
@@ -350,51 +493,113 @@ CacheResult<void> MyCache::SaveFile(const std::string& name,
         }
     }
 
-    // 写入文件（原子：先写临时文件再重命名）
-    auto tmp_path = full_path;
-    tmp_path += ".tmp";
-
+    // 重命名与索引更新在同一把写锁内完成，避免与后台淘汰删除同名文件交错
+    bool need_evict = false;
     {
-        std::ofstream ofs(tmp_path, std::ios::binary | std::ios::trunc);
-        if (!ofs.is_open()) {
-            MYLOG_ERROR("[MyCache] 无法打开临时文件：{}", tmp_path.string());
-            return CacheResult<void>::Fail(CacheErrorCode::IoError);
+        std::unique_lock lock(index_mutex_);
+        std::string blob;
+        if (!content_hash.empty() && LinkBlobLocked(tmp_path, content_hash, size)) {
+            blob = content_hash;
         }
-        ofs.write(reinterpret_cast<const char*>(data.data()),
-                  static_cast<std::streamsize>(data.size()));
-        if (!ofs.good()) {
-            MYLOG_ERROR("[MyCache] 写入临时文件失败：{}", tmp_path.string());
-            ofs.close();
-            std::filesystem::remove(tmp_path, ec);
+
+        std::filesystem::rename(tmp_path, full_path, ec);
+        if (ec) {
+            MYLOG_ERROR("[MyCache] 重命名文件失败：{} -> {}, 错误：{}",
+                        tmp_path.string(), full_path.string(), ec.message());
+            if (!blob.empty() && blobs_.count(blob) == 0) {
+                std::filesystem::remove(BlobPath(blob), ec);  // 刚创建且无人引用的内容块
+            }
             return CacheResult<void>::Fail(CacheErrorCode::IoError);
         }
-    }
-
-    // 重命名临时文件为目标文件
-    std::filesystem::rename(tmp_path, full_path, ec);
-    if (ec) {
-        MYLOG_ERROR("[MyCache] 重命名文件失败：{} -> {}, 错误：{}",
-                    tmp_path.string(), full_path.string(), ec.message());
-        std::filesystem::remove(tmp_path, ec);
-        return CacheResult<void>::Fail(CacheErrorCode::IoError);
-    }
+        if (!blob.empty()) {
+            // 目标文件已是同一内容块的硬链接时 rename 不做任何事，临时链接需手动删除
+            std::error_code rm_ec;
+            std::filesystem::remove(tmp_path, rm_ec);
+        }
 
-    // 立即更新内存索引
-    {
         FileInfo info;
         info.name = name;
-        info.size = data.size();
+        info.size = size;
         info.type = GetFileExtension(name);
-        info.modified_at = FormatFileTime(std::filesystem::last_write_time(full_path, ec));
+        if (blob.empty()) {
+            const auto ftime = std::filesystem::last_write_time(full_path, ec);
+            info.modified_at = FormatFileTime(ftime);
+            info.modified_ns = FileTimeToEpochNs(ftime);
+        } else {
+            // 共享内容块的文件名同享 inode 修改时间，按文件名记录本次提交时间（过期清理据此计算）
+            const auto now = std::chrono::system_clock::now();
+            info.modified_at = FormatSystemTime(now);
+            info.modified_ns = ToEpochNs(now);
+        }
+        IndexUpsertLocked(name, std::move(info), true, blob);
+        need_evict = OverHighWatermarkLocked();
+    }
 
-        std::unique_lock lock(index_mutex_);
-        file_index_[name] = std::move(info);
+    // 同步父目录，确保重命名本身已持久化
+    int dir_fd = ::open(parent.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dir_fd >= 0) {
+        ::fsync(dir_fd);
+        ::close(dir_fd);
     }
 
-    MYLOG_INFO("[MyCache] 文件保存成功：{}, 大小={} 字节", name, data.size());
+    if (need_evict) {
+        RequestEviction();
+    }
     return CacheResult<void>::Success();
 }
 
+bool MyCache::LinkBlobLocked(const std::filesystem::path& tmp_path, const std::string& content_hash,
+                             uint64_t size) {
+    const auto blob_file = BlobPath(content_hash);
+    std::error_code ec;
+
+    auto it = blobs_.find(content_hash);
+    if (it != blobs_.end()) {
+        if (it->second.size != size) {
+            MYLOG_ERROR("[MyCache] 内容块大小不一致，按普通文件保存：blob={}, 期望={} 字节, 实际={} 字节",
+                        content_hash, it->second.size, size);
+            return false;
+        }
+        // 命中已有内容块：临时文件替换为指向内容块的硬链接。不修改 inode 时间，
+        // 否则会改变所有共享该内容块的文件名的修改时间；各文件名的时间记录在索引中
+        std::filesystem::remove(tmp_path, ec);
+        if (::link(blob_file.c_str(), tmp_path.c_str()) != 0) {
+            MYLOG_ERROR("[MyCache] 创建内容块硬链接失败：{}, 错误：{}", blob_file.string(), std::strerror(errno));
+            return false;
+        }
+        dedup_hits_.fetch_add(1);
+        MYLOG_DEBUG("[MyCache] 去重命中：blob={}, 大小={} 字节", content_hash, size);
+        return true;
+    }
+
+    // 新内容：临时文件本身成为内容块
+    std::filesystem::create_directories(blob_file.parent_path(), ec);
+    if (::link(tmp_path.c_str(), blob_file.c_str()) != 0 && errno == EEXIST) {
+        // 残留的无引用内容块（如异常退出），以新写入的内容为准
+        std::filesystem::remove(blob_file, ec);
+        if (::link(tmp_path.c_str(), blob_file.c_str()) != 0) {
+            MYLOG_ERROR("[MyCache] 创建内容块失败：{}, 错误：{}", blob_file.string(), std::strerror(errno));
+            return false;
+        }
+    } else if (!std::filesystem::exists(blob_file, ec)) {
+        MYLOG_ERROR("[MyCache] 创建内容块失败：{}, 错误：{}", blob_file.string(), std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+std::filesystem::path MyCache::BlobPath(const std::string& content_hash) const {
+    return blob_path_ / content_hash.substr(0, 2) / content_hash;
+}
+
+bool MyCache::IsInternalPath(const std::filesystem::path& relative_path) {
+    if (relative_path.empty()) {
+        return false;
+    }
+    const auto& first = *relative_path.begin();
+    return first == kStagingDirName || first == kBlobDirName;
+}
+
 CacheResult<void> MyCache::DeleteFile(const std::string& name) {
     MYLOG_DEBUG("[MyCache] DeleteFile 请求：name={}", name);
 
@@ -404,22 +609,26 @@ CacheResult<void> MyCache::DeleteFile(const std::string& name) {
         MYLOG_WARN("[MyCache] DeleteFile 路径校验失败：name={}, 错误码={}", name, CacheErrorCodeToString(code));
         return CacheResult<void>::Fail(code);
     }
-
-    std::error_code ec;
-    if (!std::filesystem::exists(full_path, ec)) {
-        MYLOG_WARN("[MyCache] 删除目标不存在：{}", full_path.string());
+    if (IsInternalPath(std::filesystem::relative(full_path, root_path_))) {
+        MYLOG_WARN("[MyCache] DeleteFile 拒绝访问内部目录：{}", name);
         return CacheResult<void>::Fail(CacheErrorCode::FileNotFound);
     }
 
-    if (!std::filesystem::remove(full_path, ec) || ec) {
-        MYLOG_ERROR("[MyCache] 删除文件失败：{}, 错误：{}", full_path.string(), ec.message());
-        return CacheResult<void>::Fail(CacheErrorCode::IoError);
-    }
-
-    // 立即更新内存索引
+    // 删除与索引更新在同一写锁内完成：CommitStagedFile 也在写锁内 rename，
+    // 不会出现删掉并发提交刚落盘的新文件、索引却仍保留该文件的情况
     {
         std::unique_lock lock(index_mutex_);
-        file_index_.erase(name);
+        std::error_code ec;
+        if (!std::filesystem::exists(full_path, ec)) {
+            MYLOG_WARN("[MyCache] 删除目标不存在：{}", full_path.string());
+            return CacheResult<void>::Fail(CacheErrorCode::FileNotFound);
+        }
+
+        if (!std::filesystem::remove(full_path, ec) || ec) {
+            MYLOG_ERROR("[MyCache] 删除文件失败：{}, 错误：{}", full_path.string(), ec.message());
+            return CacheResult<void>::Fail(CacheErrorCode::IoError);
+        }
+        IndexEraseLocked(name);
     }
 
     MYLOG_INFO("[MyCache] 文件删除成功：{}", name);
@@ -435,11 +644,142 @@ CacheResult<std::string> MyCache::GetFullPath(const std::string& name) {
         MYLOG_WARN("[MyCache] GetFullPath 路径校验失败：name={}, 错误码={}", name, CacheErrorCodeToString(code));
         return CacheResult<std::string>::Fail(code);
     }
+    // 暂存目录（未提交的上传）与内容块目录对外不可见
+    if (IsInternalPath(std::filesystem::relative(full_path, root_path_))) {
+        MYLOG_WARN("[MyCache] GetFullPath 拒绝访问内部目录：{}", name);
+        return CacheResult<std::string>::Fail(CacheErrorCode::FileNotFound);
+    }
+
+    // 记录访问时刻：只持共享锁，并发下载互不阻塞；LRU 位置由淘汰时延迟调整
+    {
+        std::shared_lock lock(index_mutex_);
+        auto it = file_index_.find(name);
+        if (it != file_index_.end()) {
+            it->second.accessed.value.store(access_clock_.fetch_add(1, std::memory_order_relaxed) + 1,
+                                            std::memory_order_relaxed);
+        }
+    }
 
     MYLOG_DEBUG("[MyCache] GetFullPath 结果：{} -> {}", name, full_path.string());
     return CacheResult<std::string>::Success(full_path.string());
 }
 
+CacheResult<std::string> MyCache::GetWritablePath(const std::string& name) {
+    MYLOG_DEBUG("[MyCache] GetWritablePath 请求：name={}", name);
+
+    auto path_result = GetFullPath(name);
+    if (!path_result.Ok()) {
+        return path_result;
+    }
+    const std::filesystem::path full_path(path_result.value);
+
+    std::string blob;
+    uint64_t epoch = 0;
+    {
+        std::shared_lock lock(index_mutex_);
+        auto it = file_index_.find(name);
+        if (it == file_index_.end()) {
+            return CacheResult<std::string>::Fail(CacheErrorCode::FileNotFound);
+        }
+        blob = it->second.blob;
+        epoch = it->second.epoch;
+    }
+    if (blob.empty()) {
+        return path_result;  // 普通文件，独占 inode
+    }
+
+    // 写时复制：在锁外把内容复制到暂存目录，避免大文件复制期间阻塞索引
+    std::error_code ec;
+    std::filesystem::create_directories(staging_path_, ec);
+    std::string tmpl = (staging_path_ / "cow-XXXXXX").string();
+    int fd = ::mkstemp(tmpl.data());
+    if (fd < 0) {
+        MYLOG_ERROR("[MyCache] 创建写时复制临时文件失败：{}, 错误：{}", tmpl, std::strerror(errno));
+        return CacheResult<std::string>::Fail(CacheErrorCode::IoError);
+    }
+    ::close(fd);
+    const std::filesystem::path tmp_path(tmpl);
+    if (!std::filesystem::copy_file(full_path, tmp_path, std::filesystem::copy_options::overwrite_existing, ec)) {
+        MYLOG_ERROR("[MyCache] 写时复制失败：{}, 错误：{}", name, ec.message());
+        std::filesystem::remove(tmp_path, ec);
+        return CacheResult<std::string>::Fail(CacheErrorCode::IoError);
+    }
+
+    {
+        std::unique_lock lock(index_mutex_);
+        auto it = file_index_.find(name);
+        if (it == file_index_.end() || it->second.epoch != epoch) {
+            // 复制期间文件已被删除或重新提交，放弃本次副本，由调用方重试
+            const auto fail_code = it == file_index_.end() ? CacheErrorCode::FileNotFound
+                                                           : CacheErrorCode::IoError;
+            lock.unlock();
+            std::filesystem::remove(tmp_path, ec);
+            MYLOG_WARN("[MyCache] 写时复制期间文件已变更：{}", name);
+            return CacheResult<std::string>::Fail(fail_code);
+        }
+        std::filesystem::rename(tmp_path, full_path, ec);
+        if (ec) {
+            lock.unlock();
+            MYLOG_ERROR("[MyCache] 写时复制替换失败：{}, 错误：{}", name, ec.message());
+            std::filesystem::remove(tmp_path, ec);
+            return CacheResult<std::string>::Fail(CacheErrorCode::IoError);
+        }
+        // 文件名改为普通文件：释放内容块引用，修改时间沿用索引记录
+        IndexUpsertLocked(name, it->second.info, false, std::string());
+    }
+
+    MYLOG_INFO("[MyCache] 文件已解除内容块共享：name={}, blob={}", name, blob);
+    return path_result;
+}
+
+CacheResult<void> MyCache::SetPinned(const std::string& name, bool pinned) {
+    MYLOG_INFO("[MyCache] SetPinned 请求：name={}, pinned={}", name, pinned);
+
+    std::filesystem::path full_path;
+    auto code = ValidatePath(name, full_path);
+    if (code != CacheErrorCode::Ok) {
+        return CacheResult<void>::Fail(code);
+    }
+
+    std::unique_lock lock(index_mutex_);
+    auto it = file_index_.find(name);
+    if (it == file_index_.end()) {
+        MYLOG_WARN("[MyCache] SetPinned 目标不在索引中：{}", name);
+        return CacheResult<void>::Fail(CacheErrorCode::FileNotFound);
+    }
+
+    auto& entry = it->second;
+    if (entry.pinned == pinned) {
+        return CacheResult<void>::Success();
+    }
+    if (pinned) {
+        lru_list_.erase(entry.lru_it);
+        ++pinned_count_;
+    } else {
+        entry.lru_it = lru_list_.insert(lru_list_.begin(), &it->first);
+        entry.lru_tick = entry.accessed.value.load(std::memory_order_relaxed);
+        --pinned_count_;
+    }
+    entry.pinned = pinned;
+    return CacheResult<void>::Success();
+}
+
+CacheUsage MyCache::GetUsage() const {
+    CacheUsage usage;
+    {
+        std::shared_lock lock(index_mutex_);
+        usage.total_bytes = total_bytes_;
+        usage.file_count = file_index_.size();
+        usage.pinned_count = pinned_count_;
+        usage.stored_bytes = stored_bytes_;
+        usage.blob_count = blobs_.size();
+    }
+    usage.dedup_hits = dedup_hits_.load();
+    usage.evicted_files = evicted_files_.load();
+    usage.evicted_bytes = evicted_bytes_.load();
+    return usage;
+}
+
 CacheResult<bool> MyCache::Exists(const std::string& name) {
     // Exists 是高频调用，仅在 debug 级别记录
     MYLOG_DEBUG("[MyCache] Exists 查询：name={}", name);
@@ -466,65 +806,141 @@ CacheResult<std::vector<FileInfo>> MyCache::GetAllFileList() {
 }
 
 CacheResult<std::vector<FileInfo>> MyCache::GetFileList(const std::string& folder_path) {
-    MYLOG_DEBUG("[MyCache] GetFileList 请求：folder_path={}", folder_path);
+    FileListQuery query;
+    query.folder_path = folder_path;
+
+    auto page = GetFileList(query);
+    if (!page.Ok()) {
+        return CacheResult<std::vector<FileInfo>>::Fail(page.code);
+    }
+    return CacheResult<std::vector<FileInfo>>::Success(std::move(page.value.files));
+}
+
+CacheResult<FileListPage> MyCache::GetFileList(const FileListQuery& query) {
+    MYLOG_DEBUG("[MyCache] GetFileList 请求：folder_path={}, prefix={}, order={}, limit={}, after={}",
+                query.folder_path, query.prefix, static_cast<int>(query.order), query.limit, query.after);
 
     std::filesystem::path target_path;
-    auto code = ValidateDirectoryPath(folder_path, target_path, true);
+    auto code = ValidateDirectoryPath(query.folder_path, target_path, true);
     if (code != CacheErrorCode::Ok) {
         MYLOG_WARN("[MyCache] GetFileList 路径校验失败：folder_path={}, 错误码={}",
-                   folder_path, CacheErrorCodeToString(code));
-        return CacheResult<std::vector<FileInfo>>::Fail(code);
+                   query.folder_path, CacheErrorCodeToString(code));
+        return CacheResult<FileListPage>::Fail(code);
+    }
+
+    if (IsInternalPath(std::filesystem::relative(target_path, root_path_))) {
+        MYLOG_WARN("[MyCache] 不允许列出内部目录：{}", query.folder_path);
+        return CacheResult<FileListPage>::Fail(CacheErrorCode::InvalidArgument);
     }
 
     std::error_code ec;
     if (!std::filesystem::exists(target_path, ec)) {
         MYLOG_WARN("[MyCache] 查询目录不存在：{}", target_path.string());
-        return CacheResult<std::vector<FileInfo>>::Fail(CacheErrorCode::FileNotFound);
+        return CacheResult<FileListPage>::Fail(CacheErrorCode::FileNotFound);
     }
     if (!std::filesystem::is_directory(target_path, ec) || ec) {
         MYLOG_WARN("[MyCache] 查询路径不是目录：{}", target_path.string());
-        return CacheResult<std::vector<FileInfo>>::Fail(CacheErrorCode::InvalidArgument);
+        return CacheResult<FileListPage>::Fail(CacheErrorCode::InvalidArgument);
     }
 
-    std::vector<FileInfo> result;
-    for (auto it = std::filesystem::recursive_directory_iterator(target_path, ec);
-         it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
-        if (ec) {
-            MYLOG_WARN("[MyCache] 遍历目录失败：{}, 错误：{}", target_path.string(), ec.message());
-            ec.clear();
-            continue;
+    // 目录范围 + 文件名前缀 合并为索引键前缀
+    std::string key_prefix;
+    if (target_path != root_path_) {
+        key_prefix = ToRelativeUnixPath(root_path_, target_path) + "/";
+    }
+    key_prefix += query.prefix;
+
+    const size_t limit = query.limit == 0 ? std::numeric_limits<size_t>::max() : query.limit;
+    FileListPage page;
+
+    // 修改时间游标格式 "<modified_ns>|<name>"
+    bool has_cursor = false;
+    MtimeKey cursor_key{0, std::string_view()};
+    if (query.order == FileListOrder::ByModifiedDesc && !query.after.empty()) {
+        const auto sep = query.after.find('|');
+        int64_t cursor_ns = 0;
+        std::from_chars_result parsed{};
+        if (sep != std::string::npos) {
+            parsed = std::from_chars(query.after.data(), query.after.data() + sep, cursor_ns);
         }
-
-        if (!it->is_regular_file(ec) || ec) {
-            ec.clear();
-            continue;
+        if (sep == std::string::npos || parsed.ec != std::errc() || parsed.ptr != query.after.data() + sep) {
+            MYLOG_WARN("[MyCache] GetFileList 游标格式非法：{}", query.after);
+            return CacheResult<FileListPage>::Fail(CacheErrorCode::InvalidArgument);
         }
+        cursor_key = MtimeKey{cursor_ns, std::string_view(query.after).substr(sep + 1)};
+        has_cursor = true;
+    }
 
-        FileInfo info;
-        info.name = ToRelativeUnixPath(root_path_, it->path());
-        info.size = it->file_size(ec);
-        if (ec) {
-            info.size = 0;
-            ec.clear();
+    std::shared_lock lock(index_mutex_);
+
+    // 目录/前缀对应名称索引中的连续区间 [range_begin, range_end)
+    auto range_begin = name_index_.lower_bound(key_prefix);
+    auto range_end = range_begin;
+    if (key_prefix.empty()) {
+        range_end = name_index_.end();
+        page.total = name_index_.size();
+    } else {
+        while (range_end != name_index_.end() &&
+               range_end->compare(0, key_prefix.size(), key_prefix) == 0) {
+            ++range_end;
+            ++page.total;
         }
-        info.type = GetFileExtension(info.name);
+    }
 
-        auto ftime = it->last_write_time(ec);
-        if (!ec) {
-            info.modified_at = FormatFileTime(ftime);
-        } else {
-            ec.clear();
+    if (query.order == FileListOrder::ByName) {
+        // 名称有序：前缀区间 [key_prefix, ...)，从游标之后开始，O(log n + limit)
+        auto it = range_begin;
+        if (!query.after.empty() && query.after >= key_prefix) {
+            it = name_index_.upper_bound(query.after);
+        }
+        for (; it != name_index_.end(); ++it) {
+            if (it->compare(0, key_prefix.size(), key_prefix) != 0) {
+                break;
+            }
+            if (page.files.size() == limit) {
+                page.has_more = true;
+                break;
+            }
+            page.files.push_back(file_index_.find(std::string(*it))->second.info);
+        }
+        if (page.has_more) {
+            page.next_cursor = page.files.back().name;
+        }
+    } else if (key_prefix.empty()) {
+        // 修改时间降序、无过滤：从游标位置向前（更旧）遍历，O(log n + limit)
+        auto it = has_cursor ? mtime_index_.lower_bound(cursor_key) : mtime_index_.end();
+        while (it != mtime_index_.begin()) {
+            --it;
+            if (page.files.size() == limit) {
+                page.has_more = true;
+                break;
+            }
+            page.files.push_back(file_index_.find(std::string(it->second))->second.info);
+        }
+    } else {
+        // 修改时间降序、有过滤：在名称区间内取游标之前的键，只对一页做部分排序，
+        // 代价与匹配数成正比，不再遍历整个修改时间索引
+        std::vector<MtimeKey> keys;
+        for (auto it = range_begin; it != range_end; ++it) {
+            const auto& mtime_key = *file_index_.find(std::string(*it))->second.mtime_it;
+            if (!has_cursor || mtime_key < cursor_key) {
+                keys.push_back(mtime_key);
+            }
+        }
+        const size_t take = std::min(keys.size(), limit);
+        std::partial_sort(keys.begin(), keys.begin() + take, keys.end(), std::greater<MtimeKey>());
+        page.has_more = keys.size() > take;
+        for (size_t i = 0; i < take; ++i) {
+            page.files.push_back(file_index_.find(std::string(keys[i].second))->second.info);
         }
-
-        result.push_back(std::move(info));
+    }
+    if (query.order == FileListOrder::ByModifiedDesc && page.has_more) {
+        const auto& last = page.files.back();
+        page.next_cursor = std::to_string(last.modified_ns) + "|" + last.name;
     }
 
-    std::sort(result.begin(), result.end(), [](const FileInfo& lhs, const FileInfo& rhs) {
-        return lhs.name < rhs.name;
-    });
-
-    MYLOG_DEBUG("[MyCache] GetFileList 返回 {} 个文件", result.size());
-    return CacheResult<std::vector<FileInfo>>::Success(std::move(result));
+    MYLOG_DEBUG("[MyCache] GetFileList 返回 {} 个文件, has_more={}", page.files.size(), page.has_more);
+    return CacheResult<FileListPage>::Success(std::move(page));
 }
 
 CacheResult<std::string> MyCache::CreateSubdirectory(const std::string& folder_path,
@@ -596,24 +1012,33 @@ CacheResult<std::string> MyCache::CreateSubdirectory(const std::string& folder_p
 void MyCache::ScanThreadFunc() {
     MYLOG_INFO("[MyCache] 后台扫描线程启动");
 
+    auto next_scan = std::chrono::steady_clock::now() + std::chrono::seconds(kScanIntervalSec);
     while (running_.load()) {
-        // 等待指定时间或被唤醒退出
+        // 等待到下次扫描时间，或被淘汰请求/退出唤醒
         {
             std::unique_lock lock(cv_mutex_);
-            cv_.wait_for(lock, std::chrono::seconds(kScanIntervalSec), [this]() {
-                return !running_.load();
+            cv_.wait_until(lock, next_scan, [this]() {
+                return !running_.load() || evict_requested_;
             });
+            evict_requested_ = false;
         }
 
         if (!running_.load()) {
             break;
         }
 
-        // 执行一次目录扫描
-        RefreshIndex();
+        if (std::chrono::steady_clock::now() >= next_scan) {
+            // 执行一次目录扫描
+            RefreshIndex();
 
-        // 清理过期文件
-        CleanExpiredFiles();
+            // 清理过期文件
+            CleanExpiredFiles();
+
+            next_scan = std::chrono::steady_clock::now() + std::chrono::seconds(kScanIntervalSec);
+        }
+
+        // 容量淘汰（未超高水位时仅做一次计数比较）
+        EvictIfNeeded();
     }
 
     MYLOG_INFO("[MyCache] 后台扫描线程退出");
@@ -622,9 +1047,24 @@ void MyCache::ScanThreadFunc() {
 void MyCache::RefreshIndex() {
     MYLOG_DEBUG("[MyCache] 开始扫描目录：{}", root_path_.string());
 
-    std::unordered_map<std::string, FileInfo> new_index;
+    std::unordered_map<std::string, FileInfo> scanned;
+    std::unordered_map<std::string, std::string> scanned_blobs;  // 文件名 → 内容块摘要
     std::error_code ec;
 
+    // 扫描不持锁，期间写入/删除的文件可能未被扫到或已过时；记录扫描开始时的变更序号，
+    // 合并时不改动此后变更过的索引项
+    uint64_t scan_epoch = 0;
+    {
+        std::shared_lock lock(index_mutex_);
+        scan_epoch = index_epoch_;
+    }
+
+    // 去重模式：先记录内容块 inode，用于识别哪些文件是内容块的硬链接
+    std::unordered_map<uint64_t, std::string> blob_inodes;
+    if (config_.dedup) {
+        blob_inodes = ScanBlobs();
+    }
+
     // 递归遍历缓存目录下的所有常规文件
     for (auto it = std::filesystem::recursive_directory_iterator(root_path_, ec);
          it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
@@ -634,6 +1074,12 @@ void MyCache::RefreshIndex() {
             continue;
         }
 
+        // 暂存目录中的未提交文件、内容块目录不进入索引
+        if (it->path() == staging_path_ || it->path() == blob_path_) {
+            it.disable_recursion_pending();
+            continue;
+        }
+
         if (it->is_regular_file(ec) && !ec) {
             // 计算相对于 root_path_ 的相对路径作为索引 key
             auto rel = std::filesystem::relative(it->path(), root_path_, ec);
@@ -649,22 +1095,105 @@ void MyCache::RefreshIndex() {
             auto ftime = it->last_write_time(ec);
             if (!ec) {
                 info.modified_at = FormatFileTime(ftime);
+                info.modified_ns = FileTimeToEpochNs(ftime);
             } else {
                 info.modified_at = "";
                 ec.clear();
             }
 
-            new_index[rel_str] = std::move(info);
+            struct stat st {};
+            if (!blob_inodes.empty() && ::stat(it->path().c_str(), &st) == 0 && st.st_nlink > 1) {
+                auto blob_it = blob_inodes.find(static_cast<uint64_t>(st.st_ino));
+                if (blob_it != blob_inodes.end()) {
+                    scanned_blobs[rel_str] = blob_it->second;
+                }
+            }
+
+            scanned[rel_str] = std::move(info);
         }
     }
 
-    // 用写锁替换整个索引
+    // 与现有索引合并：保留 LRU 顺序与固定标记，只增删变化的文件
+    size_t index_size = 0;
     {
         std::unique_lock lock(index_mutex_);
-        file_index_.swap(new_index);
+        const bool changed_during_scan = index_epoch_ != scan_epoch;
+        for (auto it = file_index_.begin(); it != file_index_.end();) {
+            auto next = std::next(it);
+            if (it->second.epoch <= scan_epoch && scanned.count(it->first) == 0) {
+                IndexEraseLocked(it->first);
+            }
+            it = next;
+        }
+
+        // 新发现的文件按修改时间从新到旧追加到 LRU 尾部，最旧的文件最先被淘汰
+        std::vector<FileInfo*> discovered;
+        for (auto& [name, info] : scanned) {
+            auto it = file_index_.find(name);
+            if (it != file_index_.end()) {
+                if (it->second.epoch > scan_epoch) {
+                    continue;  // 扫描期间已由写入更新，以索引为准
+                }
+                auto blob_it = scanned_blobs.find(name);
+                if (blob_it != scanned_blobs.end() && blob_it->second == it->second.blob) {
+                    // 仍指向同一内容块：inode 时间为各文件名共享，保留索引中按文件名记录的时间
+                    info.modified_at = it->second.info.modified_at;
+                    info.modified_ns = it->second.info.modified_ns;
+                }
+                IndexUpsertLocked(name, std::move(info), false,
+                                  blob_it != scanned_blobs.end() ? blob_it->second : std::string());
+            } else {
+                // 扫描期间可能已被删除，此时重新确认文件仍然存在
+                if (changed_during_scan && !std::filesystem::exists(root_path_ / name, ec)) {
+                    ec.clear();
+                    continue;
+                }
+                discovered.push_back(&info);
+            }
+        }
+        std::sort(discovered.begin(), discovered.end(), [](const FileInfo* lhs, const FileInfo* rhs) {
+            return lhs->modified_ns > rhs->modified_ns;
+        });
+        for (auto* info : discovered) {
+            std::string name = info->name;
+            auto blob_it = scanned_blobs.find(name);
+            IndexUpsertLocked(name, std::move(*info), false,
+                              blob_it != scanned_blobs.end() ? blob_it->second : std::string());
+        }
+
+        // 回收无任何文件名引用的内容块（异常退出或外部删除文件后残留）
+        for (const auto& [inode, blob] : blob_inodes) {
+            (void)inode;
+            if (blobs_.count(blob) == 0) {
+                MYLOG_INFO("[MyCache] 回收无引用内容块：{}", blob);
+                std::filesystem::remove(BlobPath(blob), ec);
+            }
+        }
+        index_size = file_index_.size();
     }
 
-    MYLOG_DEBUG("[MyCache] 扫描完成，索引文件数量：{}", file_index_.size());
+    MYLOG_DEBUG("[MyCache] 扫描完成，索引文件数量：{}", index_size);
+}
+
+std::unordered_map<uint64_t, std::string> MyCache::ScanBlobs() {
+    std::unordered_map<uint64_t, std::string> inodes;
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(blob_path_, ec);
+         it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec) {
+            ec.clear();
+            continue;
+        }
+        if (!it->is_regular_file(ec) || ec) {
+            ec.clear();
+            continue;
+        }
+        struct stat st {};
+        if (::stat(it->path().c_str(), &st) == 0) {
+            inodes.emplace(static_cast<uint64_t>(st.st_ino), it->path().filename().string());
+        }
+    }
+    return inodes;
 }
 
 void MyCache::CleanExpiredFiles() {
@@ -675,46 +1204,241 @@ void MyCache::CleanExpiredFiles() {
     MYLOG_DEBUG("[MyCache] 开始清理过期文件（保留时间 {} 秒）", config_.max_retention_seconds);
 
     auto now = std::chrono::system_clock::now();
-    std::vector<std::string> expired_names;
+    std::vector<std::pair<std::string, uint64_t>> expired_names;  // (文件名, 收集时的 epoch)
 
     // 在读锁下收集过期文件（不在锁内做删除操作）
     {
         std::shared_lock lock(index_mutex_);
-        for (const auto& [name, info] : file_index_) {
-            std::error_code ec;
-            auto full_path = root_path_ / name;
-            auto ftime = std::filesystem::last_write_time(full_path, ec);
-            if (ec) continue;
-
-            // 将 file_time_type 转为 system_clock
-            auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-                ftime - std::filesystem::file_time_type::clock::now()
-                     + std::chrono::system_clock::now()
-            );
+        for (const auto& [name, entry] : file_index_) {
+            if (entry.pinned) {
+                continue;  // 固定文件不参与过期清理
+            }
+            if (entry.info.modified_ns == 0) continue;  // 修改时间未知
 
-            auto age = std::chrono::duration_cast<std::chrono::seconds>(now - sctp).count();
+            // 使用索引中按文件名记录的修改时间：去重模式下共享 inode 的文件名各自计时
+            const std::chrono::system_clock::time_point modified{
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::nanoseconds(entry.info.modified_ns))};
+            auto age = std::chrono::duration_cast<std::chrono::seconds>(now - modified).count();
             if (age > config_.max_retention_seconds) {
-                expired_names.push_back(name);
+                expired_names.emplace_back(name, entry.epoch);
             }
         }
     }
 
-    // 删除过期文件
-    for (const auto& name : expired_names) {
+    // 删除过期文件：在写锁内复核索引项未被更新（epoch 不变）后再删除，
+    // 避免误删收集之后由 CommitStagedFile 重新提交的同名文件
+    size_t cleaned = 0;
+    for (const auto& [name, epoch] : expired_names) {
+        std::unique_lock lock(index_mutex_);
+        auto it = file_index_.find(name);
+        if (it == file_index_.end() || it->second.epoch != epoch || it->second.pinned) {
+            continue;
+        }
         std::error_code ec;
-        auto full_path = root_path_ / name;
-        if (std::filesystem::remove(full_path, ec) && !ec) {
+        if (std::filesystem::remove(root_path_ / name, ec) && !ec) {
+            IndexEraseLocked(name);
+            ++cleaned;
             MYLOG_INFO("[MyCache] 过期文件已清理：{}", name);
-            std::unique_lock lock(index_mutex_);
-            file_index_.erase(name);
         } else {
             MYLOG_WARN("[MyCache] 清理过期文件失败：{}, 错误：{}", name, ec.message());
         }
     }
 
-    if (!expired_names.empty()) {
-        MYLOG_INFO("[MyCache] 过期清理完成，共清理 {} 个文件", expired_names.size());
+    if (cleaned > 0) {
+        MYLOG_INFO("[MyCache] 过期清理完成，共清理 {} 个文件", cleaned);
+    }
+}
+
+// ============================================================================
+// 容量淘汰
+// ============================================================================
+
+void MyCache::RequestEviction() {
+    if (config_.max_total_bytes == 0) {
+        return;
+    }
+    {
+        std::lock_guard lock(cv_mutex_);
+        evict_requested_ = true;
+    }
+    cv_.notify_all();
+}
+
+void MyCache::EvictIfNeeded() {
+    if (config_.max_total_bytes == 0) {
+        return;
+    }
+
+    const auto low_bytes = static_cast<uint64_t>(
+        static_cast<double>(config_.max_total_bytes) * config_.low_watermark);
+    {
+        std::shared_lock lock(index_mutex_);
+        if (!OverHighWatermarkLocked()) {
+            return;
+        }
+    }
+
+    size_t evicted = 0;
+    uint64_t freed = 0;
+    bool more = false;
+    while (running_.load()) {
+        if (evicted >= kEvictBatchSize) {
+            more = true;  // 本轮配额用完，交还 CPU，下一轮继续
+            break;
+        }
+
+        // 每淘汰一个文件只持有一次短写锁，读者不会被长时间阻塞
+        std::unique_lock lock(index_mutex_);
+        if (stored_bytes_ <= low_bytes || lru_list_.empty()) {
+            if (stored_bytes_ > low_bytes) {
+                MYLOG_WARN("[MyCache] 可淘汰文件已耗尽，剩余均为固定文件：stored={} 字节, 目标={} 字节",
+                           stored_bytes_, low_bytes);
+            }
+            break;
+        }
+
+        // 尾部文件在上次移到头部后被读过：移回头部，给下一个尾部文件机会
+        auto& tail = file_index_.find(*lru_list_.back())->second;
+        const uint64_t accessed = tail.accessed.value.load(std::memory_order_relaxed);
+        if (accessed != tail.lru_tick) {
+            tail.lru_tick = accessed;
+            lru_list_.splice(lru_list_.begin(), lru_list_, tail.lru_it);
+            continue;
+        }
+
+        // 去重模式下内容块仍被其他文件名引用时，淘汰该文件名不释放空间
+        const std::string victim = *lru_list_.back();
+        const uint64_t size = tail.info.size;
+        const uint64_t stored_before = stored_bytes_;
+        IndexEraseLocked(victim);
+        const uint64_t released = stored_before - stored_bytes_;
+
+        std::error_code ec;
+        if (!std::filesystem::remove(root_path_ / victim, ec) && ec) {
+            MYLOG_WARN("[MyCache] 淘汰文件删除失败：{}, 错误：{}", victim, ec.message());
+        }
+        lock.unlock();
+
+        ++evicted;
+        freed += released;
+        evicted_files_.fetch_add(1);
+        evicted_bytes_.fetch_add(size);
+        MYLOG_DEBUG("[MyCache] LRU 淘汰文件：{}, 大小={} 字节", victim, size);
+    }
+
+    if (evicted > 0) {
+        MYLOG_INFO("[MyCache] LRU 淘汰完成：本轮 {} 个文件，释放 {} 字节", evicted, freed);
+    }
+    if (more) {
+        RequestEviction();
+    }
+}
+
+// ============================================================================
+// 索引维护
+// ============================================================================
+
+void MyCache::IndexUpsertLocked(const std::string& name, FileInfo info, bool hot,
+                                const std::string& blob) {
+    auto it = file_index_.find(name);
+    if (it != file_index_.end()) {
+        auto& entry = it->second;
+        total_bytes_ = total_bytes_ - entry.info.size + info.size;
+        if (entry.blob != blob) {
+            if (entry.blob.empty()) {
+                stored_bytes_ -= entry.info.size;
+            } else {
+                BlobUnrefLocked(entry.blob);
+            }
+            if (blob.empty()) {
+                stored_bytes_ += info.size;
+            } else {
+                BlobRefLocked(blob, info.size);
+            }
+            entry.blob = blob;
+        } else if (blob.empty()) {
+            stored_bytes_ = stored_bytes_ - entry.info.size + info.size;
+        }
+        if (entry.mtime_it->first != info.modified_ns) {
+            mtime_index_.erase(entry.mtime_it);
+            entry.mtime_it = mtime_index_.emplace(info.modified_ns, *entry.name_it).first;
+        }
+        entry.info = std::move(info);
+        entry.epoch = ++index_epoch_;
+        if (hot && !entry.pinned) {
+            lru_list_.splice(lru_list_.begin(), lru_list_, entry.lru_it);
+            entry.lru_tick = entry.accessed.value.load(std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    total_bytes_ += info.size;
+    if (blob.empty()) {
+        stored_bytes_ += info.size;
+    } else {
+        BlobRefLocked(blob, info.size);
+    }
+    auto [inserted, ok] = file_index_.emplace(name, IndexEntry{std::move(info), false, {}, {}, {}, blob,
+                                                               ++index_epoch_, {}, 0});
+    (void)ok;
+    const std::string* key = &inserted->first;
+    inserted->second.lru_it = hot ? lru_list_.insert(lru_list_.begin(), key)
+                                  : lru_list_.insert(lru_list_.end(), key);
+    inserted->second.name_it = name_index_.emplace(*key).first;
+    inserted->second.mtime_it = mtime_index_.emplace(inserted->second.info.modified_ns, *key).first;
+}
+
+void MyCache::IndexEraseLocked(const std::string& name) {
+    auto it = file_index_.find(name);
+    if (it == file_index_.end()) {
+        return;
+    }
+    if (it->second.pinned) {
+        --pinned_count_;
+    } else {
+        lru_list_.erase(it->second.lru_it);
+    }
+    name_index_.erase(it->second.name_it);
+    mtime_index_.erase(it->second.mtime_it);
+    if (it->second.blob.empty()) {
+        stored_bytes_ -= it->second.info.size;
+    } else {
+        BlobUnrefLocked(it->second.blob);
+    }
+    total_bytes_ -= it->second.info.size;
+    file_index_.erase(it);
+    ++index_epoch_;
+}
+
+void MyCache::BlobRefLocked(const std::string& blob, uint64_t size) {
+    auto& entry = blobs_[blob];
+    if (entry.refs++ == 0) {
+        entry.size = size;
+        stored_bytes_ += size;
+    }
+}
+
+void MyCache::BlobUnrefLocked(const std::string& blob) {
+    auto it = blobs_.find(blob);
+    if (it == blobs_.end() || --it->second.refs > 0) {
+        return;
+    }
+    stored_bytes_ -= it->second.size;
+    blobs_.erase(it);
+
+    std::error_code ec;
+    if (!std::filesystem::remove(BlobPath(blob), ec) && ec) {
+        MYLOG_WARN("[MyCache] 删除内容块失败：{}, 错误：{}", blob, ec.message());
+    }
+}
+
+bool MyCache::OverHighWatermarkLocked() const {
+    if (config_.max_total_bytes == 0) {
+        return false;
     }
+    return static_cast<double>(stored_bytes_) >
+           static_cast<double>(config_.max_total_bytes) * config_.high_watermark;
 }
 
 }  // namespace my_cache
@@ -9,6 +9,9 @@
  *   - 默认构造，通过 Init(JSON) 传入配置后启动
  *   - 后台线程定期扫描目录，维护内存文件索引，使 Exists 查询达到 O(1) 复杂度
  *   - 支持配置最大文件大小、最长保留时间
+ *   - 支持通过 CacheFileWriter 流式写入大文件（内存占用与文件大小无关）
+ *   - 支持总容量上限：超过高水位后台按 LRU 增量淘汰至低水位，固定文件不参与淘汰
+ *   - 可选内容寻址去重：相同内容只存一份内容块，文件名为硬链接，内容块按引用计数回收
  *   - 所有操作均防止路径穿越攻击
  *   - MyCacheProvider 提供线程安全的单例包装
  *
@@ -17,13 +20,18 @@
  */
 
 #include "CacheTypes.h"
+#include "CacheFileWriter.h"
 
 #include <atomic>
 #include <condition_variable>
 #include <filesystem>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <set>
 #include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -42,6 +50,7 @@ namespace my_cache {
  *   2. 后台线程每 5 秒扫描一次目录，维护内存文件索引
  *   3. 所有公开接口均做路径穿越校验
  *   4. 可根据配置进行文件大小限制和过期清理
+ *   5. 维护 LRU 链表，总容量超过高水位时由后台线程增量淘汰最久未访问的文件
  *
  * 使用流程：
  *   MyCache cache;
@@ -75,6 +84,10 @@ public:
      *   - root_path (string, 必填): 缓存根目录路径，不存在时自动创建
      *   - max_file_size (uint64, 可选): 单个文件最大大小（字节），0 或缺省表示不限制
      *   - max_retention_seconds (int64, 可选): 文件最长保留时间（秒），0 或缺省表示不限制，-1 表示永久有效
+     *   - max_total_bytes (uint64, 可选): 缓存目录总容量上限（字节），0 或缺省表示不限制
+     *   - high_watermark / low_watermark (double, 可选): 淘汰触发/停止水位（占 max_total_bytes 的比例），
+     *     需满足 0 < low_watermark <= high_watermark <= 1
+     *   - dedup (bool, 可选): 是否开启内容寻址去重，缺省为 false
      *
      * @return CacheResult<void> 初始化结果
      */
@@ -97,6 +110,25 @@ public:
     CacheResult<void> SaveFile(const std::string& name,
                                const std::vector<uint8_t>& data);
 
+    /**
+     * @brief 保存一段连续内存到缓存目录（避免调用方额外拷贝为 vector）
+     * @param name 文件相对路径名
+     * @param data 数据指针
+     * @param size 数据长度（字节）
+     * @return CacheResult<void>，若超出 max_file_size 返回 FileTooLarge
+     */
+    CacheResult<void> SaveFile(const std::string& name, const uint8_t* data, size_t size);
+
+    /**
+     * @brief 打开流式写入器，用于分块写入大文件
+     *
+     * 临时文件创建在缓存根目录下的暂存目录（kStagingDirName）中，
+     * 该目录不会出现在文件索引和文件列表中。目标文件名在 Commit 时确定。
+     *
+     * @return CacheResult<std::unique_ptr<CacheFileWriter>> 成功时 value 为写入器
+     */
+    CacheResult<std::unique_ptr<CacheFileWriter>> OpenWriter();
+
     /**
      * @brief 删除缓存目录中的文件
      * @param name 文件相对路径名
@@ -106,11 +138,44 @@ public:
 
     /**
      * @brief 获取文件的完整绝对路径
+     *
+     * 文件在索引中时会记录一次访问（下载等读取路径均经过此接口）。只持共享锁，
+     * LRU 位置由淘汰线程在检查尾部时按访问记录延迟调整。
+     *
      * @param name 文件相对路径名
      * @return CacheResult<std::string> 成功时 value 为绝对路径
      */
     CacheResult<std::string> GetFullPath(const std::string& name);
 
+    /**
+     * @brief 获取可原地修改的文件路径
+     *
+     * 去重模式下多个文件名可能是同一内容块的硬链接，原地写入其中一个会同时改变其他文件名
+     * 和内容块本身。此接口在文件引用内容块时先复制出独立副本替换该文件名（写时复制），
+     * 解除与内容块的关联后再返回路径；未引用内容块的文件直接返回路径。
+     * GetFullPath 返回的路径只应用于读取。
+     *
+     * @param name 文件相对路径名
+     * @return CacheResult<std::string> 成功时 value 为绝对路径；文件不在索引中返回 FileNotFound
+     */
+    CacheResult<std::string> GetWritablePath(const std::string& name);
+
+    /**
+     * @brief 固定/取消固定文件
+     *
+     * 固定的文件不参与 LRU 容量淘汰和过期清理，但仍可通过 DeleteFile 显式删除。
+     *
+     * @param name 文件相对路径名
+     * @param pinned true 固定，false 取消固定
+     * @return CacheResult<void>，文件不在索引中返回 FileNotFound
+     */
+    CacheResult<void> SetPinned(const std::string& name, bool pinned);
+
+    /**
+     * @brief 获取容量使用与淘汰统计
+     */
+    CacheUsage GetUsage() const;
+
     /**
      * @brief O(1) 查询文件是否存在（基于内存索引）
      * @param name 文件相对路径名
@@ -135,12 +200,23 @@ public:
     CacheResult<std::vector<FileInfo>> GetAllFileList();
 
     /**
-     * @brief 获取指定目录下的文件元信息列表
+     * @brief 获取指定目录下的文件元信息列表（按名称排序）
      * @param folder_path 目标目录，支持空字符串（表示缓存根目录）、相对路径或位于缓存根目录内的绝对路径
      * @return CacheResult<std::vector<FileInfo>> 成功时 value 为文件元信息列表
      */
     CacheResult<std::vector<FileInfo>> GetFileList(const std::string& folder_path = "");
 
+    /**
+     * @brief 分页获取文件列表，支持排序、前缀过滤和游标翻页
+     *
+     * 基于内存有序索引，不遍历目录。
+     *
+     * @param query 查询参数
+     * @return CacheResult<FileListPage> 成功时 value 为当前页结果；
+     *         游标格式非法返回 InvalidArgument，目录不存在返回 FileNotFound
+     */
+    CacheResult<FileListPage> GetFileList(const FileListQuery& query);
+
     /**
      * @brief 在指定目录下创建子目录
      * @param folder_path 父目录，支持空字符串（表示缓存根目录）、相对路径或位于缓存根目录内的绝对路径
@@ -150,7 +226,45 @@ public:
     CacheResult<std::string> CreateSubdirectory(const std::string& folder_path,
                                                 const std::string& new_folder_name);
 
+    /// 暂存目录名（位于缓存根目录下，保存未提交的临时文件）
+    static constexpr const char* kStagingDirName = ".staging";
+
+    /// 内容块目录名（位于缓存根目录下，去重模式下按 SHA-256 保存内容块）
+    static constexpr const char* kBlobDirName = ".blobs";
+
 private:
+    friend class CacheFileWriter;
+
+    /**
+     * @brief 将暂存目录中已落盘的临时文件原子重命名为目标文件，并更新索引
+     * @param tmp_path 临时文件路径
+     * @param name 目标文件相对路径名
+     * @param size 文件大小（字节）
+     * @param content_hash 内容 SHA-256（十六进制），为空表示不去重
+     * @return CacheResult<void>
+     */
+    CacheResult<void> CommitStagedFile(const std::filesystem::path& tmp_path,
+                                       const std::string& name,
+                                       uint64_t size,
+                                       const std::string& content_hash);
+
+    /**
+     * @brief 将临时文件挂接到内容块：内容块已存在时临时文件改为指向它的硬链接，
+     *        否则临时文件本身成为新内容块（调用方须持有 index_mutex_ 写锁）
+     * @return true 成功（临时文件与内容块为同一 inode），false 时按普通文件提交
+     */
+    bool LinkBlobLocked(const std::filesystem::path& tmp_path, const std::string& content_hash,
+                        uint64_t size);
+
+    /// 内容块路径：kBlobDirName/<前两位>/<完整摘要>
+    std::filesystem::path BlobPath(const std::string& content_hash) const;
+
+    /// 判断相对路径是否位于内部目录（暂存目录、内容块目录）中，内部文件不进入索引
+    static bool IsInternalPath(const std::filesystem::path& relative_path);
+
+    /// 扫描内容块目录，返回 inode → 摘要 映射，用于识别已有文件对应的内容块
+    std::unordered_map<uint64_t, std::string> ScanBlobs();
+
     // ---- 路径安全验证 ----
 
     /**
@@ -184,20 +298,97 @@ private:
     /// 清理过期文件（仅当 max_retention_seconds > 0 时生效）
     void CleanExpiredFiles();
 
+    /// 总容量超过高水位时按 LRU 淘汰，每轮最多 kEvictBatchSize 个文件，未完成则继续请求下一轮；
+    /// 尾部文件若在上次移到头部后被读过，先移回头部再继续（近似 LRU，读路径无需写锁）
+    void EvictIfNeeded();
+
+    /// 唤醒后台线程执行一轮淘汰
+    void RequestEviction();
+
+    // ---- 索引维护（调用方须持有 index_mutex_ 写锁）----
+
+    using LruList = std::list<const std::string*>;
+    using NameIndex = std::set<std::string_view>;
+    using MtimeKey = std::pair<int64_t, std::string_view>;  // (modified_ns, name)
+    using MtimeIndex = std::set<MtimeKey>;
+
+    /// 插入或更新索引项；新文件 hot=true 时放在 LRU 头部，否则放在尾部；blob 为所引用内容块摘要
+    void IndexUpsertLocked(const std::string& name, FileInfo info, bool hot,
+                           const std::string& blob = std::string());
+
+    /// 从索引和 LRU 链表中移除，并释放其内容块引用
+    void IndexEraseLocked(const std::string& name);
+
+    /// 增加内容块引用；首次引用时计入实际占用
+    void BlobRefLocked(const std::string& blob, uint64_t size);
+
+    /// 释放内容块引用；最后一个引用释放时删除内容块文件
+    void BlobUnrefLocked(const std::string& blob);
+
+    /// 实际占用是否超过高水位
+    bool OverHighWatermarkLocked() const;
+
 private:
     CacheConfig config_;                       // 配置信息
     std::filesystem::path root_path_;          // 缓存根目录（规范化后的绝对路径）
+    std::filesystem::path staging_path_;       // 暂存目录（root_path_/kStagingDirName）
+    std::filesystem::path blob_path_;          // 内容块目录（root_path_/kBlobDirName）
     std::atomic<CacheStatus> status_{CacheStatus::NotInitialized}; // 模块状态
     std::atomic<bool> running_{false};         // 后台线程运行标记
 
-    mutable std::shared_mutex index_mutex_;    // 保护文件索引的读写锁
-    std::unordered_map<std::string, FileInfo> file_index_; // 内存文件索引（相对路径→元信息）
+    /// 访问时刻：读路径在共享锁下原子写入，淘汰时据此延迟调整 LRU 位置
+    struct AccessTick {
+        std::atomic<uint64_t> value{0};
+
+        AccessTick() = default;
+        AccessTick(const AccessTick& other) : value(other.value.load(std::memory_order_relaxed)) {}
+        AccessTick& operator=(const AccessTick& other) {
+            value.store(other.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+    };
+
+    /// 索引项：文件元信息 + LRU 位置（仅未固定的文件在 LRU 链表中）+ 有序索引位置
+    struct IndexEntry {
+        FileInfo info;
+        bool pinned = false;
+        LruList::iterator lru_it;
+        NameIndex::iterator name_it;
+        MtimeIndex::iterator mtime_it;
+        std::string blob;              // 引用的内容块摘要，空表示普通文件
+        uint64_t epoch = 0;            // 最近一次插入/更新时的 index_epoch_
+        AccessTick accessed;           // 最近一次读访问的 access_clock_ 值
+        uint64_t lru_tick = 0;         // 最近一次移到 LRU 头部时的 accessed 值；两者不等说明之后被读过
+    };
+
+    /// 内容块：大小 + 引用它的文件名数量
+    struct BlobEntry {
+        uint64_t size = 0;
+        uint64_t refs = 0;
+    };
+
+    mutable std::shared_mutex index_mutex_;    // 保护文件索引、LRU 链表和容量统计的读写锁
+    std::unordered_map<std::string, IndexEntry> file_index_; // 内存文件索引（相对路径→元信息）
+    LruList lru_list_;                         // 头部最近访问，尾部最久未访问；元素指向 file_index_ 的 key
+    NameIndex name_index_;                     // 按相对路径有序（目录/前缀区间查询）；元素引用 file_index_ 的 key
+    MtimeIndex mtime_index_;                   // 按 (修改时间, 路径) 有序（最新 N 个文件查询）
+    uint64_t total_bytes_ = 0;                 // 索引中文件总大小（逻辑大小）
+    uint64_t stored_bytes_ = 0;                // 实际占用：普通文件大小 + 各内容块大小（只计一次）
+    std::unordered_map<std::string, BlobEntry> blobs_; // 内容块引用计数（摘要→内容块）
+    uint64_t pinned_count_ = 0;                // 固定文件数量
+    uint64_t index_epoch_ = 0;                 // 索引变更序号，每次插入/更新/删除递增；扫描据此识别扫描期间的变更
+    std::atomic<uint64_t> access_clock_{0};    // 读访问计数，GetFullPath 在共享锁下递增
+    std::atomic<uint64_t> evicted_files_{0};   // 累计淘汰文件数
+    std::atomic<uint64_t> evicted_bytes_{0};   // 累计淘汰字节数
+    std::atomic<uint64_t> dedup_hits_{0};      // 累计命中已有内容块的写入次数
 
     std::thread scan_thread_;                  // 后台扫描线程
     std::mutex cv_mutex_;                      // 条件变量互斥锁
-    std::condition_variable cv_;               // 用于优雅退出的条件变量
+    std::condition_variable cv_;               // 用于优雅退出和淘汰唤醒的条件变量
+    bool evict_requested_ = false;             // 淘汰请求标记（受 cv_mutex_ 保护）
 
     static constexpr int kScanIntervalSec = 5; // 扫描间隔（秒）
+    static constexpr size_t kEvictBatchSize = 256; // 每轮最多淘汰的文件数，避免长时间占用
 };
 
 }  // namespace my_cache
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <nlohmann/json.hpp>
 #include <string>
 
@@ -29,6 +30,18 @@ public:
    */
   virtual my_data::TaskResult DoTask(const my_data::Task& task) = 0;
 
+  using DoneCallback = std::function<void(my_data::TaskResult)>;
+
+  /**
+   * @brief 异步执行（Workflow 的 pooled 模式使用）
+   *
+   * - 不得阻塞调用线程：需要等待 I/O/延时的执行器应在 I/O 就绪或定时到期后再调用 done
+   *   （可用 WorkflowScheduler::RunAfter）
+   * - done 恰好调用一次，可在任意线程；调用 done 之后不得再抛异常
+   * - 默认实现同步调用 DoTask，适合本身不阻塞的执行器
+   */
+  virtual void DoTaskAsync(const my_data::Task& task, DoneCallback done) { done(DoTask(task)); }
+
   /**
    * @brief 健康检查（可选）
    */
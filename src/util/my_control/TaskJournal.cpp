@@ -0,0 +1,563 @@
+#include "TaskJournal.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MyLog.h"
+
+namespace my_control {
+
+namespace {
+
+constexpr char kMagic[8] = {'M', 'Y', 'T', 'J', 'R', 'N', 'L', '1'};
+constexpr std::size_t kRecordHeaderBytes = 8;  // u32 body_len + u32 crc32
+
+// CRC-32（IEEE 802.3，反射多项式 0xEDB88320）
+std::uint32_t Crc32(const char* data, std::size_t n) {
+  static const std::array<std::uint32_t, 256> table = [] {
+    std::array<std::uint32_t, 256> t{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+      std::uint32_t c = i;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+      }
+      t[i] = c;
+    }
+    return t;
+  }();
+
+  std::uint32_t crc = 0xFFFFFFFFu;
+  for (std::size_t i = 0; i < n; ++i) {
+    crc = table[(crc ^ static_cast<std::uint8_t>(data[i])) & 0xFFu] ^ (crc >> 8);
+  }
+  return crc ^ 0xFFFFFFFFu;
+}
+
+void PutU16(std::string& out, std::uint16_t v) {
+  out.push_back(static_cast<char>(v & 0xFF));
+  out.push_back(static_cast<char>((v >> 8) & 0xFF));
+}
+
+void PutU32(std::string& out, std::uint32_t v) {
+  for (int i = 0; i < 4; ++i) {
+    out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+  }
+}
+
+std::uint16_t GetU16(const char* p) {
+  return static_cast<std::uint16_t>(static_cast<std::uint8_t>(p[0]) |
+                                    (static_cast<std::uint8_t>(p[1]) << 8));
+}
+
+std::uint32_t GetU32(const char* p) {
+  std::uint32_t v = 0;
+  for (int i = 0; i < 4; ++i) {
+    v |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(p[i])) << (8 * i);
+  }
+  return v;
+}
+
+std::string LiveKey(const std::string& queue, const std::string& task_id) {
+  std::string key;
+  key.reserve(queue.size() + 1 + task_id.size());
+  key.append(queue).push_back('\0');
+  key.append(task_id);
+  return key;
+}
+
+std::string ErrnoString(const char* what) {
+  return std::string(what) + ": " + std::strerror(errno);
+}
+
+bool SyncDirectoryOf(const std::string& path) {
+  std::filesystem::path dir = std::filesystem::path(path).parent_path();
+  if (dir.empty()) dir = ".";
+  int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dfd < 0) return false;
+  const bool ok = ::fsync(dfd) == 0;
+  ::close(dfd);
+  return ok;
+}
+
+} // namespace
+
+TaskJournal::TaskJournal(TaskJournalOptions options) : options_(std::move(options)) {}
+
+TaskJournal::~TaskJournal() {
+  Close();
+}
+
+bool TaskJournal::Open(std::string* err) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (open_) return true;
+
+  if (options_.path.empty()) {
+    if (err) *err = "journal path is empty";
+    return false;
+  }
+
+  std::error_code ec;
+  const auto parent = std::filesystem::path(options_.path).parent_path();
+  if (!parent.empty()) {
+    std::filesystem::create_directories(parent, ec);
+  }
+
+  fd_ = ::open(options_.path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    std::string e = ErrnoString("open journal failed");
+    if (err) *err = e;
+    MYLOG_ERROR("[TaskJournal] Open 失败: path={}, err={}", options_.path, e);
+    return false;
+  }
+
+  if (!ReplayLocked(err)) {
+    ::close(fd_);
+    fd_ = -1;
+    return false;
+  }
+
+  stop_ = false;
+  io_error_.clear();
+  open_ = true;
+  writer_ = std::thread(&TaskJournal::WriterLoop, this);
+
+  MYLOG_INFO("[TaskJournal] Open 成功: path={}, file_bytes={}, recovered={}",
+             options_.path, file_bytes_, stats_.recovered);
+  return true;
+}
+
+void TaskJournal::Close() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!open_) return;
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+    open_ = false;
+    live_.clear();
+    live_bytes_ = 0;
+  }
+  durable_cv_.notify_all();
+  MYLOG_INFO("[TaskJournal] Close 完成: path={}", options_.path);
+}
+
+bool TaskJournal::IsOpen() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return open_;
+}
+
+std::vector<my_data::Task> TaskJournal::TakeRecovered(const std::string& queue) {
+  std::lock_guard<std::mutex> lk(mu_);
+  std::vector<my_data::Task> out;
+  auto it = recovered_.find(queue);
+  if (it == recovered_.end()) return out;
+
+  out.reserve(it->second.size());
+  for (auto& [seq, task] : it->second) {
+    (void)seq;
+    out.push_back(std::move(task));
+  }
+  recovered_.erase(it);
+  return out;
+}
+
+std::uint64_t TaskJournal::AppendEnqueue(const std::string& queue, const my_data::Task& task, std::string* err) {
+  std::string payload;
+  try {
+    payload = task.toJson().dump();
+  } catch (const std::exception& e) {
+    if (err) *err = std::string("serialize task failed: ") + e.what();
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> lk(mu_);
+  if (!open_ || !io_error_.empty()) {
+    if (err) *err = open_ ? io_error_ : "journal not open";
+    return 0;
+  }
+  if (queue.size() > 0xFFFF || task.task_id.size() > 0xFFFF ||
+      kRecordHeaderBytes + 5 + queue.size() + task.task_id.size() + payload.size() > options_.max_record_bytes) {
+    if (err) *err = "journal record too large";
+    return 0;
+  }
+
+  std::string record = EncodeRecord(RecordType::Enqueue, queue, task.task_id, payload);
+  const std::string key = LiveKey(queue, task.task_id);
+  auto it = live_.find(key);
+  if (it != live_.end()) {
+    live_bytes_ -= it->second.record.size();
+  }
+  live_bytes_ += record.size();
+
+  const std::uint64_t seq = next_seq_++;
+  pending_ += record;
+  pending_max_seq_ = seq;
+  live_[key] = LiveEntry{seq, queue, std::move(record)};
+  ++stats_.appended;
+  cv_.notify_one();
+  return seq;
+}
+
+std::uint64_t TaskJournal::AppendDequeue(const std::string& queue, const my_data::TaskId& task_id) {
+  std::lock_guard<std::mutex> lk(mu_);
+  return AppendLocked(RecordType::Dequeue, queue, task_id, std::string());
+}
+
+std::uint64_t TaskJournal::AppendComplete(const std::string& queue, const my_data::TaskId& task_id) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto it = live_.find(LiveKey(queue, task_id));
+  if (it != live_.end()) {
+    live_bytes_ -= it->second.record.size();
+    live_.erase(it);
+  }
+  return AppendLocked(RecordType::Complete, queue, task_id, std::string());
+}
+
+std::uint64_t TaskJournal::AppendLocked(RecordType type, const std::string& queue,
+                                        const std::string& task_id, const std::string& payload) {
+  if (!open_ || !io_error_.empty()) return 0;
+  if (queue.size() > 0xFFFF || task_id.size() > 0xFFFF) return 0;
+
+  const std::uint64_t seq = next_seq_++;
+  pending_ += EncodeRecord(type, queue, task_id, payload);
+  pending_max_seq_ = seq;
+  ++stats_.appended;
+  cv_.notify_one();
+  return seq;
+}
+
+bool TaskJournal::WaitDurable(std::uint64_t seq, std::string* err) {
+  std::unique_lock<std::mutex> lk(mu_);
+  durable_cv_.wait(lk, [&] { return durable_seq_ >= seq || !io_error_.empty() || !open_; });
+  if (durable_seq_ >= seq) return true;
+  if (err) *err = io_error_.empty() ? "journal closed" : io_error_;
+  return false;
+}
+
+void TaskJournal::RequestCompaction() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    compact_requested_ = true;
+  }
+  cv_.notify_one();
+}
+
+TaskJournalStats TaskJournal::Stats() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  TaskJournalStats s = stats_;
+  s.file_bytes = file_bytes_;
+  s.live_bytes = live_bytes_;
+  s.live_tasks = live_.size();
+  return s;
+}
+
+std::string TaskJournal::EncodeRecord(RecordType type, const std::string& queue,
+                                      const std::string& task_id, const std::string& payload) {
+  std::string body;
+  body.reserve(5 + queue.size() + task_id.size() + payload.size());
+  body.push_back(static_cast<char>(type));
+  PutU16(body, static_cast<std::uint16_t>(queue.size()));
+  body += queue;
+  PutU16(body, static_cast<std::uint16_t>(task_id.size()));
+  body += task_id;
+  body += payload;
+
+  std::string record;
+  record.reserve(kRecordHeaderBytes + body.size());
+  PutU32(record, static_cast<std::uint32_t>(body.size()));
+  PutU32(record, Crc32(body.data(), body.size()));
+  record += body;
+  return record;
+}
+
+bool TaskJournal::ReplayLocked(std::string* err) {
+  live_.clear();
+  live_bytes_ = 0;
+  recovered_.clear();
+  stats_ = TaskJournalStats{};
+
+  struct stat st {};
+  if (::fstat(fd_, &st) != 0) {
+    if (err) *err = ErrnoString("fstat journal failed");
+    return false;
+  }
+
+  std::string data(static_cast<std::size_t>(st.st_size), '\0');
+  std::size_t got = 0;
+  while (got < data.size()) {
+    ssize_t n = ::pread(fd_, data.data() + got, data.size() - got, static_cast<off_t>(got));
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      if (err) *err = ErrnoString("read journal failed");
+      return false;
+    }
+    if (n == 0) break;
+    got += static_cast<std::size_t>(n);
+  }
+  data.resize(got);
+
+  if (data.size() < sizeof(kMagic)) {
+    // 空文件，或创建时写文件头中途崩溃留下的残缺文件头（不可能含有记录）：按空日志重新初始化
+    if (!data.empty()) {
+      MYLOG_WARN("[TaskJournal] 文件头不完整，按空日志重新初始化: path={}, file_bytes={}", options_.path, data.size());
+      if (::ftruncate(fd_, 0) != 0) {
+        if (err) *err = ErrnoString("truncate journal failed");
+        return false;
+      }
+    }
+    std::string e;
+    if (!WriteAll(fd_, std::string(kMagic, sizeof(kMagic)), &e) || ::fdatasync(fd_) != 0) {
+      if (err) *err = e.empty() ? ErrnoString("fdatasync journal failed") : e;
+      return false;
+    }
+    file_bytes_ = sizeof(kMagic);
+    return true;
+  }
+  if (std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+    if (err) *err = "not a task journal: " + options_.path;
+    MYLOG_ERROR("[TaskJournal] 文件头不匹配，拒绝覆盖: path={}", options_.path);
+    return false;
+  }
+
+  std::unordered_map<std::string, my_data::Task> live_tasks;
+  std::size_t off = sizeof(kMagic);
+  std::size_t records = 0;
+  while (off + kRecordHeaderBytes <= data.size()) {
+    const std::uint32_t len = GetU32(data.data() + off);
+    const std::uint32_t crc = GetU32(data.data() + off + 4);
+    if (len < 5 || len > options_.max_record_bytes || off + kRecordHeaderBytes + len > data.size()) break;
+
+    const char* body = data.data() + off + kRecordHeaderBytes;
+    if (Crc32(body, len) != crc) break;
+
+    const auto type = static_cast<RecordType>(static_cast<std::uint8_t>(body[0]));
+    std::size_t p = 1;
+    const std::uint16_t qlen = GetU16(body + p);
+    p += 2;
+    if (p + qlen + 2 > len) break;
+    std::string queue(body + p, qlen);
+    p += qlen;
+    const std::uint16_t idlen = GetU16(body + p);
+    p += 2;
+    if (p + idlen > len) break;
+    std::string task_id(body + p, idlen);
+    p += idlen;
+
+    const std::string key = LiveKey(queue, task_id);
+    if (type == RecordType::Enqueue) {
+      try {
+        auto task = my_data::Task::fromJson(nlohmann::json::parse(body + p, body + len));
+        auto it = live_.find(key);
+        if (it != live_.end()) live_bytes_ -= it->second.record.size();
+        std::string record(data.data() + off, kRecordHeaderBytes + len);
+        live_bytes_ += record.size();
+        live_[key] = LiveEntry{next_seq_++, queue, std::move(record)};
+        live_tasks[key] = std::move(task);
+      } catch (const std::exception& e) {
+        MYLOG_WARN("[TaskJournal] 跳过无法解析的 enqueue 记录: queue={}, task_id={}, err={}", queue, task_id, e.what());
+      }
+    } else if (type == RecordType::Complete) {
+      auto it = live_.find(key);
+      if (it != live_.end()) {
+        live_bytes_ -= it->second.record.size();
+        live_.erase(it);
+      }
+      live_tasks.erase(key);
+    } else if (type != RecordType::Dequeue) {
+      break;
+    }
+
+    off += kRecordHeaderBytes + len;
+    ++records;
+  }
+
+  if (off < data.size()) {
+    // 崩溃时写了一半的尾部记录：截掉，后续追加从完整记录之后开始
+    MYLOG_WARN("[TaskJournal] 检测到不完整/损坏的尾部记录，截断: path={}, valid_bytes={}, file_bytes={}",
+               options_.path, off, data.size());
+    if (::ftruncate(fd_, static_cast<off_t>(off)) != 0) {
+      if (err) *err = ErrnoString("truncate journal failed");
+      return false;
+    }
+  }
+  file_bytes_ = off;
+  durable_seq_ = next_seq_ - 1;
+  pending_max_seq_ = durable_seq_;
+
+  for (auto& [key, entry] : live_) {
+    auto tit = live_tasks.find(key);
+    if (tit == live_tasks.end()) continue;
+    recovered_[entry.queue][entry.seq] = std::move(tit->second);
+    ++stats_.recovered;
+  }
+
+  MYLOG_INFO("[TaskJournal] 回放完成: path={}, records={}, unfinished={}", options_.path, records, stats_.recovered);
+  return true;
+}
+
+bool TaskJournal::WriteAll(int fd, const std::string& data, std::string* err) {
+  std::size_t done = 0;
+  while (done < data.size()) {
+    ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      if (err) *err = ErrnoString("write journal failed");
+      return false;
+    }
+    done += static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+bool TaskJournal::ShouldCompactLocked() const {
+  return file_bytes_ >= options_.compact_min_bytes &&
+         static_cast<double>(live_bytes_) < static_cast<double>(file_bytes_) * options_.compact_live_ratio;
+}
+
+std::string TaskJournal::CompactionSnapshotLocked(std::size_t* live_tasks) const {
+  std::vector<const LiveEntry*> entries;
+  entries.reserve(live_.size());
+  for (const auto& [key, entry] : live_) {
+    (void)key;
+    entries.push_back(&entry);
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const LiveEntry* a, const LiveEntry* b) { return a->seq < b->seq; });
+
+  std::string data(kMagic, sizeof(kMagic));
+  data.reserve(sizeof(kMagic) + live_bytes_);
+  for (const auto* e : entries) {
+    data += e->record;
+  }
+  if (live_tasks) *live_tasks = entries.size();
+  return data;
+}
+
+bool TaskJournal::WriteCompacted(const std::string& data, int* new_fd, bool* replaced, std::string* err) const {
+  *replaced = false;
+  const std::string tmp = options_.path + ".compact";
+  int tfd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (tfd < 0) {
+    if (err) *err = ErrnoString("open compact file failed");
+    return false;
+  }
+  if (!WriteAll(tfd, data, err) || ::fdatasync(tfd) != 0) {
+    if (err && err->empty()) *err = ErrnoString("fdatasync compact file failed");
+    ::close(tfd);
+    ::unlink(tmp.c_str());
+    return false;
+  }
+  ::close(tfd);
+
+  if (::rename(tmp.c_str(), options_.path.c_str()) != 0) {
+    if (err) *err = ErrnoString("rename compact file failed");
+    ::unlink(tmp.c_str());
+    return false;
+  }
+  *replaced = true;
+  SyncDirectoryOf(options_.path);
+
+  *new_fd = ::open(options_.path.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+  if (*new_fd < 0) {
+    // 新文件已生效但无法追加：后续记录无处可写，调用方进入错误状态
+    if (err) *err = ErrnoString("reopen journal failed");
+    return false;
+  }
+  return true;
+}
+
+void TaskJournal::WriterLoop() {
+  MYLOG_INFO("[TaskJournal] 写线程启动: path={}", options_.path);
+  const auto check_interval = std::chrono::milliseconds(std::max(1, options_.compact_check_interval_ms));
+  auto next_check = std::chrono::steady_clock::now() + check_interval;
+
+  std::unique_lock<std::mutex> lk(mu_);
+  while (true) {
+    cv_.wait_until(lk, next_check, [&] { return stop_ || !pending_.empty() || compact_requested_; });
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= next_check) {
+      compact_requested_ = compact_requested_ || ShouldCompactLocked();
+      next_check = now + check_interval;
+    }
+    if (pending_.empty() && !compact_requested_) {
+      if (stop_) break;
+      continue;
+    }
+
+    std::string batch;
+    batch.swap(pending_);
+    const std::uint64_t batch_seq = pending_max_seq_;
+    const bool compact = compact_requested_ && io_error_.empty();
+    compact_requested_ = false;
+
+    std::string e;
+    bool ok = true;
+    if (compact) {
+      // live_ 已包含 batch 的全部效果，压缩文件直接取代这批记录。
+      // 快照在锁内生成，写盘/fdatasync/rename 在锁外进行：期间只有本线程写文件，
+      // 新追加的记录留在 pending_ 中，下一轮写入新文件
+      std::size_t live_tasks = 0;
+      const std::string data = CompactionSnapshotLocked(&live_tasks);
+      lk.unlock();
+      int nfd = -1;
+      bool replaced = false;
+      ok = WriteCompacted(data, &nfd, &replaced, &e);
+      lk.lock();
+      if (ok) {
+        ::close(fd_);
+        fd_ = nfd;
+        MYLOG_INFO("[TaskJournal] 压缩完成: path={}, bytes {} -> {}, live_tasks={}",
+                   options_.path, file_bytes_, data.size(), live_tasks);
+        file_bytes_ = data.size();
+        ++stats_.compactions;
+      } else if (!replaced) {
+        // 压缩失败（rename 之前）不影响原文件，本批照常追加（排在压缩期间新追加的记录之前）
+        MYLOG_WARN("[TaskJournal] 压缩失败，继续追加写: path={}, err={}", options_.path, e);
+        pending_.insert(0, batch);
+        continue;
+      }
+    } else if (!batch.empty()) {
+      const int fd = fd_;
+      lk.unlock();
+      ok = WriteAll(fd, batch, &e);
+      if (ok && options_.fsync && ::fdatasync(fd) != 0) {
+        e = ErrnoString("fdatasync journal failed");
+        ok = false;
+      }
+      lk.lock();
+      if (ok) file_bytes_ += batch.size();
+    }
+
+    if (ok) {
+      durable_seq_ = std::max(durable_seq_, batch_seq);
+      if (!batch.empty()) ++stats_.batches;
+    } else {
+      io_error_ = e;
+      MYLOG_ERROR("[TaskJournal] 写入失败，停止接受新记录: path={}, err={}", options_.path, e);
+    }
+    durable_cv_.notify_all();
+  }
+  MYLOG_INFO("[TaskJournal] 写线程退出: path={}", options_.path);
+}
+
+} // namespace my_control
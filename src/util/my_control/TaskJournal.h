@@ -0,0 +1,153 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "MyData.h"
+
+namespace my_control {
+
+/**
+ * @brief TaskJournal 配置
+ */
+struct TaskJournalOptions {
+  std::string path;                                // 日志文件路径
+  bool fsync{true};                                // 每批写入后 fdatasync（关闭后仅保证进程崩溃不丢）
+  std::size_t max_record_bytes{1 << 20};           // 单条记录上限，超过视为损坏
+  std::size_t compact_min_bytes{4 << 20};          // 文件小于该值时不压缩
+  double compact_live_ratio{0.25};                 // 有效字节 / 文件字节低于该比例时压缩
+  int compact_check_interval_ms{30000};            // 压缩检查周期
+};
+
+struct TaskJournalStats {
+  std::uint64_t appended{0};    // 追加的记录数
+  std::uint64_t batches{0};     // 写入批次数（每批一次顺序 write + 一次 fsync）
+  std::uint64_t compactions{0};
+  std::uint64_t recovered{0};   // 启动时回放出的未完成任务
+  std::uint64_t file_bytes{0};
+  std::uint64_t live_bytes{0};  // 未完成任务对应的记录字节
+  std::size_t live_tasks{0};
+};
+
+/**
+ * @brief 任务预写日志（追加写 + CRC 校验 + 组提交）
+ *
+ * @details
+ * - 记录 enqueue / dequeue / complete 三类事件，按队列名 + task_id 关联
+ * - 记录格式：[u32 body_len][u32 crc32(body)][body]，body = [u8 type][u16 qlen][queue][u16 idlen][task_id][task json]
+ * - 追加只写内存缓冲；后台线程把积攒的记录一次顺序 write 并 fdatasync，
+ *   之后唤醒 WaitDurable 的调用方（并发入队自然合并为一批）
+ * - Open 时回放：enqueue 之后没有 complete 的任务视为未完成（已 dequeue 但未完成的任务会被重新执行），
+ *   遇到截断或 CRC 不符的尾部记录时截掉
+ * - 有效记录占比过低时，后台线程只把未完成任务重写到新文件并原子 rename
+ */
+class TaskJournal {
+public:
+  explicit TaskJournal(TaskJournalOptions options);
+  ~TaskJournal();
+
+  TaskJournal(const TaskJournal&) = delete;
+  TaskJournal& operator=(const TaskJournal&) = delete;
+
+  /**
+   * @brief 打开（不存在则创建）日志文件，回放未完成任务并启动写线程
+   */
+  bool Open(std::string* err);
+
+  /**
+   * @brief 刷盘剩余记录并停止写线程（幂等）
+   */
+  void Close();
+
+  bool IsOpen() const;
+
+  /**
+   * @brief 取出某队列回放得到的未完成任务（按入队顺序），取出后清空
+   */
+  std::vector<my_data::Task> TakeRecovered(const std::string& queue);
+
+  /**
+   * @brief 追加事件，返回记录序号（0 表示失败）；不等待落盘
+   */
+  std::uint64_t AppendEnqueue(const std::string& queue, const my_data::Task& task, std::string* err);
+  std::uint64_t AppendDequeue(const std::string& queue, const my_data::TaskId& task_id);
+  std::uint64_t AppendComplete(const std::string& queue, const my_data::TaskId& task_id);
+
+  /**
+   * @brief 等待 seq 及之前的记录落盘
+   */
+  bool WaitDurable(std::uint64_t seq, std::string* err);
+
+  /**
+   * @brief 立即检查并在需要时压缩（测试/运维用；正常由写线程周期触发）
+   */
+  void RequestCompaction();
+
+  TaskJournalStats Stats() const;
+
+  const std::string& Path() const { return options_.path; }
+
+private:
+  enum class RecordType : std::uint8_t {
+    Enqueue = 1,
+    Dequeue = 2,
+    Complete = 3,
+  };
+
+  struct LiveEntry {
+    std::uint64_t seq{0};
+    std::string queue;
+    std::string record;  // 编码后的 enqueue 记录（压缩时原样写回）
+  };
+
+  static std::string EncodeRecord(RecordType type, const std::string& queue,
+                                  const std::string& task_id, const std::string& payload);
+
+  std::uint64_t AppendLocked(RecordType type, const std::string& queue,
+                             const std::string& task_id, const std::string& payload);
+
+  bool ReplayLocked(std::string* err);
+  void WriterLoop();
+  static bool WriteAll(int fd, const std::string& data, std::string* err);
+  // 压缩分两步：持锁时拼出未完成任务快照，释放锁后写临时文件、fdatasync、rename 并重新打开
+  std::string CompactionSnapshotLocked(std::size_t* live_tasks) const;
+  bool WriteCompacted(const std::string& data, int* new_fd, bool* replaced, std::string* err) const;
+  bool ShouldCompactLocked() const;
+
+private:
+  TaskJournalOptions options_;
+
+  mutable std::mutex mu_;
+  std::condition_variable cv_;          // 唤醒写线程
+  std::condition_variable durable_cv_;  // 唤醒 WaitDurable
+  std::thread writer_;
+  bool open_{false};
+  bool stop_{false};
+  bool compact_requested_{false};
+  int fd_{-1};
+
+  std::string pending_;                 // 待写入的记录
+  std::uint64_t next_seq_{1};
+  std::uint64_t pending_max_seq_{0};    // pending_ 中最大的序号
+  std::uint64_t durable_seq_{0};        // 已落盘的最大序号
+  std::string io_error_;                // 写入失败后不再接受新记录
+
+  // queue + '\0' + task_id -> 未完成任务
+  std::unordered_map<std::string, LiveEntry> live_;
+  std::uint64_t live_bytes_{0};
+  std::uint64_t file_bytes_{0};
+
+  // 回放结果：queue -> (seq -> task)
+  std::unordered_map<std::string, std::map<std::uint64_t, my_data::Task>> recovered_;
+
+  TaskJournalStats stats_{};
+};
+
+} // namespace my_control
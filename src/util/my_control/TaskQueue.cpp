@@ -1,14 +1,64 @@
 #include "TaskQueue.h"
+#include "TaskJournal.h"
 
+#include <algorithm>
 #include <chrono>
+#include <limits>
 #include <utility>
 
 namespace my_control {
 
+namespace {
+
+std::int64_t SteadyNowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+} // namespace
+
+std::string ToString(TaskQueueMode mode) {
+  switch (mode) {
+    case TaskQueueMode::Fifo: return "fifo";
+    case TaskQueueMode::Priority: return "priority";
+  }
+  return "unknown";
+}
+
+bool ParseTaskQueueMode(const std::string& s, TaskQueueMode* out) {
+  if (s == "fifo") {
+    *out = TaskQueueMode::Fifo;
+    return true;
+  }
+  if (s == "priority" || s == "edf") {
+    *out = TaskQueueMode::Priority;
+    return true;
+  }
+  return false;
+}
+
+nlohmann::json ToJson(const TaskQueueStats& stats) {
+  nlohmann::json by = nlohmann::json::object();
+  for (const auto& [prio, w] : stats.by_priority) {
+    by[std::to_string(prio)] = {
+        {"popped", w.popped},
+        {"expired", w.expired},
+        {"wait_ms_avg", (w.popped + w.expired) ? w.wait_ms_total / (w.popped + w.expired) : 0},
+        {"wait_ms_max", w.wait_ms_max},
+    };
+  }
+  return {{"mode", ToString(stats.mode)}, {"size", stats.size}, {"wait_by_priority", by}};
+}
+
 TaskQueue::TaskQueue() : TaskQueue("TaskQueue") {}
 
-TaskQueue::TaskQueue(std::string name) : name_(std::move(name)) {
-  MYLOG_INFO("[TaskQueue:{}] 创建队列实例", name_);
+TaskQueue::TaskQueue(std::string name) : TaskQueue(std::move(name), TaskQueueOptions{}) {}
+
+TaskQueue::TaskQueue(std::string name, TaskQueueOptions options)
+    : name_(std::move(name)), options_(options) {
+  MYLOG_INFO("[TaskQueue:{}] 创建队列实例：mode={}, drop_expired={}",
+             name_, ToString(options_.mode), options_.drop_expired);
 }
 
 TaskQueue::~TaskQueue() {
@@ -17,64 +67,320 @@ TaskQueue::~TaskQueue() {
   MYLOG_INFO("[TaskQueue:{}] 析构完成", name_);
 }
 
-void TaskQueue::Push(const my_data::Task& task) {
+void TaskQueue::AttachJournal(std::shared_ptr<TaskJournal> journal) {
+  std::lock_guard<std::mutex> lk(mu_);
+  journal_ = std::move(journal);
+  MYLOG_INFO("[TaskQueue:{}] {} 任务日志", name_, journal_ ? "绑定" : "解绑");
+}
+
+void TaskQueue::SetExpiredCallback(ExpiredCallback cb) {
+  std::lock_guard<std::mutex> lk(mu_);
+  on_expired_ = std::move(cb);
+}
+
+void TaskQueue::SetReadyCallback(ReadyCallback cb) {
+  std::lock_guard<std::mutex> lk(mu_);
+  on_ready_ = std::move(cb);
+  if (on_ready_ && !heap_.empty()) on_ready_();
+}
+
+bool TaskQueue::Push(const my_data::Task& task, std::string* err) {
+  return Push(my_data::Task(task), err);
+}
+
+bool TaskQueue::Push(my_data::Task&& task, std::string* err) {
+  std::shared_ptr<TaskJournal> journal;
+  std::uint64_t seq = 0;
+  std::uint64_t queue_seq = 0;
   {
     std::lock_guard<std::mutex> lk(mu_);
     if (shutdown_) {
       MYLOG_WARN("[TaskQueue:{}] Push 被拒绝：队列已 shutdown。task_id={}", name_, task.task_id);
-      return;
+      if (err) *err = "queue shutdown";
+      return false;
+    }
+    if (!journal_) {
+      MYLOG_INFO("[TaskQueue:{}] Push 成功：task_id={}, device_id={}, priority={}, size={}",
+                 name_, task.task_id, task.device_id, task.priority, heap_.size() + 1);
+      PushLocked(std::move(task));
+      cv_.notify_one();
+      return true;
+    }
+    // 在队列锁内追加日志并预留入队序号，保证日志顺序与队列顺序一致（只写内存缓冲，不等待落盘）
+    seq = journal_->AppendEnqueue(name_, task, err);
+    if (seq == 0) {
+      MYLOG_ERROR("[TaskQueue:{}] Push 失败：写任务日志失败。task_id={}", name_, task.task_id);
+      return false;
+    }
+    journal = journal_;
+    queue_seq = next_seq_++;
+  }
+
+  // 锁外等待组提交落盘：并发 Push 合并成一次 write + fsync。
+  // 落盘之前任务对消费者不可见，失败时不会出现"返回失败但任务仍被执行"
+  if (!journal->WaitDurable(seq, err)) {
+    MYLOG_ERROR("[TaskQueue:{}] 任务日志落盘失败，任务不入队：task_id={}, seq={}", name_, task.task_id, seq);
+    journal->AppendComplete(name_, task.task_id);
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (shutdown_) {
+      MYLOG_WARN("[TaskQueue:{}] Push 被拒绝：等待落盘期间队列已 shutdown。task_id={}", name_, task.task_id);
+      journal->AppendComplete(name_, task.task_id);
+      if (err) *err = "queue shutdown";
+      return false;
     }
-    q_.push_back(task);
-    MYLOG_INFO("[TaskQueue:{}] Push 成功：task_id={}, device_id={}, size={}",
-               name_, task.task_id, task.device_id, q_.size());
+    MYLOG_INFO("[TaskQueue:{}] Push 成功：task_id={}, device_id={}, priority={}, size={}",
+               name_, task.task_id, task.device_id, task.priority, heap_.size() + 1);
+    PushLocked(std::move(task), queue_seq);
   }
   cv_.notify_one();
+  return true;
 }
 
-bool TaskQueue::PopBlocking(my_data::Task& out, int timeout_ms) {
-  std::unique_lock<std::mutex> lk(mu_);
+bool TaskQueue::PushBatch(std::vector<my_data::Task>&& tasks, std::string* err) {
+  if (tasks.empty()) return true;
 
-  // 1) 无限等待
-  if (timeout_ms < 0) {
-    cv_.wait(lk, [&]() { return shutdown_ || !q_.empty(); });
-  } else {
-    // 2) 超时等待
-    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
-    bool ok = cv_.wait_until(lk, deadline, [&]() { return shutdown_ || !q_.empty(); });
+  std::shared_ptr<TaskJournal> journal;
+  std::uint64_t seq = 0;
+  std::uint64_t queue_seq = 0;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (shutdown_) {
+      MYLOG_WARN("[TaskQueue:{}] PushBatch 被拒绝：队列已 shutdown。count={}", name_, tasks.size());
+      if (err) *err = "queue shutdown";
+      return false;
+    }
+    if (journal_) {
+      for (std::size_t i = 0; i < tasks.size(); ++i) {
+        seq = journal_->AppendEnqueue(name_, tasks[i], err);
+        if (seq == 0) {
+          // 已写入的 enqueue 记录补 complete，避免重启后回放未入队的任务
+          for (std::size_t j = 0; j < i; ++j) {
+            journal_->AppendComplete(name_, tasks[j].task_id);
+          }
+          MYLOG_ERROR("[TaskQueue:{}] PushBatch 失败：写任务日志失败。task_id={}", name_, tasks[i].task_id);
+          return false;
+        }
+      }
+      journal = journal_;
+      queue_seq = next_seq_;
+      next_seq_ += tasks.size();
+    } else {
+      for (auto& t : tasks) {
+        PushLocked(std::move(t));
+      }
+      MYLOG_INFO("[TaskQueue:{}] PushBatch 成功：count={}, size={}", name_, tasks.size(), heap_.size());
+    }
+  }
+
+  if (journal) {
+    // 整批落盘之后才对消费者可见
+    bool ok = journal->WaitDurable(seq, err);
+    if (!ok) {
+      MYLOG_ERROR("[TaskQueue:{}] 任务日志落盘失败，整批不入队：count={}, seq={}", name_, tasks.size(), seq);
+    }
+    std::lock_guard<std::mutex> lk(mu_);
+    if (ok && shutdown_) {
+      MYLOG_WARN("[TaskQueue:{}] PushBatch 被拒绝：等待落盘期间队列已 shutdown。count={}", name_, tasks.size());
+      if (err) *err = "queue shutdown";
+      ok = false;
+    }
     if (!ok) {
-      MYLOG_WARN("[TaskQueue:{}] PopBlocking 超时：timeout_ms={}, size={}", name_, timeout_ms, q_.size());
+      for (const auto& t : tasks) {
+        journal->AppendComplete(name_, t.task_id);
+      }
       return false;
     }
+    for (auto& t : tasks) {
+      PushLocked(std::move(t), queue_seq++);
+    }
+    MYLOG_INFO("[TaskQueue:{}] PushBatch 成功：count={}, size={}", name_, tasks.size(), heap_.size());
   }
+  if (tasks.size() == 1) {
+    cv_.notify_one();
+  } else {
+    cv_.notify_all();
+  }
+  return true;
+}
 
-  // 被唤醒后：若队列为空
-  if (q_.empty()) {
-    if (shutdown_) {
-      MYLOG_INFO("[TaskQueue:{}] PopBlocking 返回 false：队列已 shutdown 且为空", name_);
-    } else {
-      // 理论上不会走到这（因为 wait 条件是 !q_.empty()）
-      MYLOG_WARN("[TaskQueue:{}] PopBlocking 异常情况：被唤醒但队列为空且未 shutdown", name_);
+std::size_t TaskQueue::Restore(std::vector<my_data::Task> tasks) {
+  std::size_t n = 0;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (shutdown_) return 0;
+    for (auto& t : tasks) {
+      PushLocked(std::move(t));
+      ++n;
+    }
+    if (n > 0) {
+      MYLOG_WARN("[TaskQueue:{}] Restore：放回 {} 条未完成任务，size={}", name_, n, heap_.size());
     }
-    return false;
   }
+  if (n > 0) cv_.notify_all();
+  return n;
+}
 
-  out = std::move(q_.front());
-  q_.pop_front();
+void TaskQueue::MarkDone(const my_data::Task& task) {
+  std::shared_ptr<TaskJournal> journal;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    journal = journal_;
+  }
+  if (journal) {
+    journal->AppendComplete(name_, task.task_id);
+  }
+}
 
-  MYLOG_INFO("[TaskQueue:{}] Pop 成功：task_id={}, device_id={}, size={}",
-             name_, out.task_id, out.device_id, q_.size());
-  return true;
+void TaskQueue::ReportExpired(const ExpiredCallback& cb, ExpiredList* expired) const {
+  // 过期任务的回调在锁外执行，避免回调里再访问队列时死锁
+  for (const auto& [task, result] : *expired) {
+    if (!cb) continue;
+    try {
+      cb(task, result);
+    } catch (const std::exception& e) {
+      MYLOG_ERROR("[TaskQueue:{}] ExpiredCallback 异常：task_id={}, err={}", name_, task.task_id, e.what());
+    } catch (...) {
+      MYLOG_ERROR("[TaskQueue:{}] ExpiredCallback 未知异常：task_id={}", name_, task.task_id);
+    }
+  }
+  expired->clear();
+}
+
+bool TaskQueue::PopReadyLocked(my_data::Task& out, ExpiredList* expired) {
+  const TimestampMs now_ms = my_data::NowMs();
+  while (!heap_.empty()) {
+    std::int64_t waited_ms = 0;
+    my_data::Task task = PopTopLocked(&waited_ms);
+    auto& ws = wait_stats_[std::clamp(task.priority, TaskQueueStats::kWaitStatsMinPriority,
+                                      TaskQueueStats::kWaitStatsMaxPriority)];
+    ws.wait_ms_total += static_cast<std::uint64_t>(waited_ms);
+    ws.wait_ms_max = std::max(ws.wait_ms_max, static_cast<std::uint64_t>(waited_ms));
+
+    if (options_.drop_expired && task.deadline_at_ms > 0 && now_ms > task.deadline_at_ms) {
+      ++ws.expired;
+      if (journal_) {
+        journal_->AppendComplete(name_, task.task_id);  // 不再执行，重启后也不回放
+      }
+      MYLOG_WARN("[TaskQueue:{}] 任务已过期，丢弃：task_id={}, priority={}, deadline_at_ms={}, now_ms={}, waited_ms={}",
+                 name_, task.task_id, task.priority, task.deadline_at_ms, now_ms, waited_ms);
+      my_data::TaskResult r;
+      r.code = my_data::ErrorCode::Timeout;
+      r.message = "deadline exceeded before dispatch";
+      r.started_at_ms = now_ms;
+      r.finished_at_ms = now_ms;
+      r.output = {{"reason", "deadline_exceeded"},
+                  {"deadline_at_ms", task.deadline_at_ms},
+                  {"queue_wait_ms", waited_ms}};
+      task.state = my_data::TaskState::Cancelled;
+      expired->emplace_back(std::move(task), std::move(r));
+      continue;
+    }
+
+    ++ws.popped;
+    out = std::move(task);
+    if (journal_) {
+      journal_->AppendDequeue(name_, out.task_id);
+    }
+    MYLOG_INFO("[TaskQueue:{}] Pop 成功：task_id={}, device_id={}, priority={}, waited_ms={}, size={}",
+               name_, out.task_id, out.device_id, out.priority, waited_ms, heap_.size());
+    return true;
+  }
+  return false;
+}
+
+bool TaskQueue::PopBlocking(my_data::Task& out, int timeout_ms) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeout_ms, 0));
+  ExpiredList expired;
+
+  std::unique_lock<std::mutex> lk(mu_);
+  while (true) {
+    if (timeout_ms < 0) {
+      // 1) 无限等待
+      cv_.wait(lk, [&]() { return shutdown_ || !heap_.empty(); });
+    } else {
+      // 2) 超时等待
+      bool ok = cv_.wait_until(lk, deadline, [&]() { return shutdown_ || !heap_.empty(); });
+      if (!ok) {
+        MYLOG_DEBUG("[TaskQueue:{}] PopBlocking 超时：timeout_ms={}, size={}", name_, timeout_ms, heap_.size());
+        ExpiredCallback on_expired = on_expired_;
+        lk.unlock();
+        ReportExpired(on_expired, &expired);
+        return false;
+      }
+    }
+
+    // 被唤醒后：若队列为空
+    if (heap_.empty()) {
+      if (shutdown_) {
+        MYLOG_INFO("[TaskQueue:{}] PopBlocking 返回 false：队列已 shutdown 且为空", name_);
+      } else {
+        // 理论上不会走到这（因为 wait 条件是 !heap_.empty()）
+        MYLOG_WARN("[TaskQueue:{}] PopBlocking 异常情况：被唤醒但队列为空且未 shutdown", name_);
+      }
+      ExpiredCallback on_expired = on_expired_;
+      lk.unlock();
+      ReportExpired(on_expired, &expired);
+      return false;
+    }
+
+    const bool ok = PopReadyLocked(out, &expired);
+    ExpiredCallback on_expired = on_expired_;
+    lk.unlock();
+    ReportExpired(on_expired, &expired);
+    if (ok) return true;
+
+    // 本轮取到的全部过期：已上报，继续等待
+    lk.lock();
+  }
+}
+
+bool TaskQueue::TryPop(my_data::Task& out) {
+  ExpiredList expired;
+  bool ok = false;
+  ExpiredCallback on_expired;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    ok = PopReadyLocked(out, &expired);
+    if (!expired.empty()) on_expired = on_expired_;
+  }
+  ReportExpired(on_expired, &expired);
+  return ok;
 }
 
 std::size_t TaskQueue::Size() const {
+  return published_size_.load(std::memory_order_acquire);
+}
+
+std::uint64_t TaskQueue::Version() const {
+  return version_.load(std::memory_order_acquire);
+}
+
+TaskQueueStats TaskQueue::Stats() const {
   std::lock_guard<std::mutex> lk(mu_);
-  return q_.size();
+  TaskQueueStats st;
+  st.mode = options_.mode;
+  st.size = heap_.size();
+  st.by_priority = wait_stats_;
+  return st;
 }
 
 void TaskQueue::Clear() {
   std::lock_guard<std::mutex> lk(mu_);
-  std::size_t n = q_.size();
-  q_.clear();
+  std::size_t n = heap_.size();
+  if (journal_) {
+    // 被清空的任务不会再执行，记为完成，避免重启后被回放
+    for (const auto& e : heap_) {
+      journal_->AppendComplete(name_, slots_[e.slot].task.task_id);
+    }
+  }
+  heap_.clear();
+  slots_.clear();
+  free_slots_.clear();
+  PublishSizeLocked();
   MYLOG_WARN("[TaskQueue:{}] Clear：清空 {} 条待执行任务", name_, n);
 }
 
@@ -83,7 +389,8 @@ void TaskQueue::Shutdown() {
     std::lock_guard<std::mutex> lk(mu_);
     if (shutdown_) return;
     shutdown_ = true;
-    MYLOG_WARN("[TaskQueue:{}] Shutdown：队列关闭，唤醒所有等待线程。size={}", name_, q_.size());
+    version_.fetch_add(1, std::memory_order_release);
+    MYLOG_WARN("[TaskQueue:{}] Shutdown：队列关闭，唤醒所有等待线程。size={}", name_, heap_.size());
   }
   cv_.notify_all();
 }
@@ -93,4 +400,89 @@ bool TaskQueue::IsShutdown() const {
   return shutdown_;
 }
 
+bool TaskQueue::Before(const HeapEntry& a, const HeapEntry& b) const {
+  if (options_.mode == TaskQueueMode::Priority) {
+    if (a.priority != b.priority) return a.priority > b.priority;
+    const auto da = a.deadline_at_ms > 0 ? a.deadline_at_ms : std::numeric_limits<TimestampMs>::max();
+    const auto db = b.deadline_at_ms > 0 ? b.deadline_at_ms : std::numeric_limits<TimestampMs>::max();
+    if (da != db) return da < db;
+  }
+  return a.seq < b.seq;
+}
+
+void TaskQueue::PushLocked(my_data::Task&& task) {
+  PushLocked(std::move(task), next_seq_++);
+}
+
+void TaskQueue::PushLocked(my_data::Task&& task, std::uint64_t seq) {
+  HeapEntry e;
+  e.priority = task.priority;
+  e.deadline_at_ms = task.deadline_at_ms;
+  e.seq = seq;
+
+  if (!free_slots_.empty()) {
+    e.slot = free_slots_.back();
+    free_slots_.pop_back();
+  } else {
+    e.slot = static_cast<std::uint32_t>(slots_.size());
+    slots_.emplace_back();
+  }
+  slots_[e.slot].task = std::move(task);
+  slots_[e.slot].task.trace.enqueued_us = my_data::MonoUs();
+  slots_[e.slot].enqueued_at_ms = SteadyNowMs();
+
+  heap_.push_back(e);
+  SiftUpLocked(heap_.size() - 1);
+  PublishSizeLocked();
+  if (on_ready_) on_ready_();
+}
+
+my_data::Task TaskQueue::PopTopLocked(std::int64_t* waited_ms) {
+  const std::uint32_t slot = heap_.front().slot;
+  heap_.front() = heap_.back();
+  heap_.pop_back();
+  if (!heap_.empty()) SiftDownLocked(0);
+  PublishSizeLocked();
+
+  Slot& s = slots_[slot];
+  if (waited_ms) *waited_ms = std::max<std::int64_t>(0, SteadyNowMs() - s.enqueued_at_ms);
+  my_data::Task task = std::move(s.task);
+  free_slots_.push_back(slot);
+  return task;
+}
+
+void TaskQueue::PublishSizeLocked() {
+  published_size_.store(heap_.size(), std::memory_order_release);
+  version_.fetch_add(1, std::memory_order_release);
+}
+
+void TaskQueue::SiftUpLocked(std::size_t i) {
+  HeapEntry e = heap_[i];
+  while (i > 0) {
+    const std::size_t parent = (i - 1) / kHeapArity;
+    if (!Before(e, heap_[parent])) break;
+    heap_[i] = heap_[parent];
+    i = parent;
+  }
+  heap_[i] = e;
+}
+
+void TaskQueue::SiftDownLocked(std::size_t i) {
+  const std::size_t n = heap_.size();
+  HeapEntry e = heap_[i];
+  while (true) {
+    const std::size_t first = i * kHeapArity + 1;
+    if (first >= n) break;
+    std::size_t best = first;
+    const std::size_t last = std::min(first + kHeapArity, n);
+    for (std::size_t c = first + 1; c < last; ++c) {
+      if (Before(heap_[c], heap_[best])) best = c;
+    }
+    if (!Before(heap_[best], e)) break;
+    heap_[i] = heap_[best];
+    i = best;
+  }
+  heap_[i] = e;
+}
+
 } // namespace my_control
\ No newline at end of file
@@ -1,43 +1,144 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <cstddef>
-#include <deque>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "MyData.h"
 #include "MyLog.h"
 
 namespace my_control {
 
+class TaskJournal;
+
 using namespace my_data;
+
+/**
+ * @brief 出队顺序
+ * - Fifo：按入队顺序（默认，兼容原行为）
+ * - Priority：priority 大者先出；同优先级 deadline 早者先出（EDF，无 deadline 排最后）；再按入队顺序
+ */
+enum class TaskQueueMode {
+  Fifo = 0,
+  Priority = 1,
+};
+
+std::string ToString(TaskQueueMode mode);
+bool ParseTaskQueueMode(const std::string& s, TaskQueueMode* out);
+
+struct TaskQueueOptions {
+  TaskQueueMode mode{TaskQueueMode::Fifo};
+  bool drop_expired{true};  // 出队时丢弃 deadline_at_ms 已过的任务（state=Cancelled，经 ExpiredCallback 上报）
+};
+
+/**
+ * @brief 单个优先级的排队等待统计（入队到出队/过期的时长）
+ */
+struct TaskQueueWaitStats {
+  std::uint64_t popped{0};
+  std::uint64_t expired{0};
+  std::uint64_t wait_ms_total{0};
+  std::uint64_t wait_ms_max{0};
+};
+
+struct TaskQueueStats {
+  TaskQueueMode mode{TaskQueueMode::Fifo};
+  std::size_t size{0};
+  // priority -> 统计；priority 来自外部命令，超出 [kWaitStatsMinPriority, kWaitStatsMaxPriority] 的归入边界值
+  std::map<int, TaskQueueWaitStats> by_priority;
+
+  static constexpr int kWaitStatsMinPriority = -128;
+  static constexpr int kWaitStatsMaxPriority = 127;
+};
+
+nlohmann::json ToJson(const TaskQueueStats& stats);
+
 /**
  * @brief 线程安全任务队列（MVP）
  *
  * @details
  * - 生产者：通常是 Edge（接收外部命令后 push task）
- * - 消费者：通常是每个 Device 的 Workflow 线程（阻塞 pop）
+ * - 消费者：通常是每个 Device 的 Workflow 线程（阻塞 pop）；M:N 模式下由 ReadyCallback 唤醒后非阻塞 TryPop
  *
  * 语义约定：
  * - PopBlocking() 返回 false：
  *   1) timeout 到期且仍无数据（timeout_ms >= 0 时）
  *   2) 队列已 Shutdown 且队列为空
  * - Shutdown() 会唤醒所有阻塞的 PopBlocking()
+ *
+ * 调度：
+ * - 内部为 4 叉堆，堆元素只含排序键与槽位下标，Task 本体存放在槽位数组中不随堆调整移动
+ * - drop_expired 时，PopBlocking 遇到已过期任务直接移出（不返回给调用方），
+ *   以 TaskState::Cancelled + ErrorCode::Timeout 调用 ExpiredCallback（在调用 PopBlocking 的线程、锁外执行）
+ *
+ * 持久化（可选）：
+ * - AttachJournal() 之后 Push 会先写 enqueue 记录并等待组提交落盘，落盘成功后任务才对消费者可见；
+ *   落盘失败时任务不入队并补写 complete。PopBlocking 写 dequeue，
+ *   MarkDone 写 complete；进程重启后未 complete 的任务由 Restore() 放回队列
  */
 class TaskQueue {
 public:
+  using ExpiredCallback = std::function<void(const my_data::Task&, const my_data::TaskResult&)>;
+  using ReadyCallback = std::function<void()>;
+
   TaskQueue();
   explicit TaskQueue(std::string name);
+  TaskQueue(std::string name, TaskQueueOptions options);
   ~TaskQueue();
 
   TaskQueue(const TaskQueue&) = delete;
   TaskQueue& operator=(const TaskQueue&) = delete;
 
+  /**
+   * @brief 绑定任务日志（在开始 Push 之前调用；传 nullptr 解绑）
+   */
+  void AttachJournal(std::shared_ptr<TaskJournal> journal);
+
+  /**
+   * @brief 过期任务回调（通常由消费者注册，用于上报取消结果）
+   */
+  void SetExpiredCallback(ExpiredCallback cb);
+
+  /**
+   * @brief 入队通知回调（M:N 调度用）：每次有任务入队时在队列锁内调用，设置时若队列非空也立即调用一次
+   * @note 回调内不得再访问本队列；传 nullptr 解绑，返回后保证不会再被调用
+   */
+  void SetReadyCallback(ReadyCallback cb);
+
   /**
    * @brief 入队一个 Task（线程安全）
+   * @return 队列已关闭或日志写入失败时返回 false
    */
-  void Push(const my_data::Task& task);
+  bool Push(const my_data::Task& task, std::string* err = nullptr);
+
+  /**
+   * @brief 入队一个 Task（移动语义，避免拷贝 params/policy 等字段）
+   */
+  bool Push(my_data::Task&& task, std::string* err = nullptr);
+
+  /**
+   * @brief 批量入队：一次加锁、一次唤醒、一次等待日志落盘；要么全部入队，要么全部不入队
+   * @return 队列已关闭或日志写入失败时返回 false（tasks 保持不变）
+   */
+  bool PushBatch(std::vector<my_data::Task>&& tasks, std::string* err = nullptr);
+
+  /**
+   * @brief 放回日志回放出的任务（按原顺序重新入队，不再重复写日志）
+   * @return 放回的数量
+   */
+  std::size_t Restore(std::vector<my_data::Task> tasks);
+
+  /**
+   * @brief 任务执行结束（无论成败）后由消费者调用，写 complete 记录；未绑定日志时为空操作
+   */
+  void MarkDone(const my_data::Task& task);
 
   /**
    * @brief 阻塞出队
@@ -48,10 +149,21 @@ public:
   bool PopBlocking(my_data::Task& out, int timeout_ms = -1);
 
   /**
-   * @brief 队列长度（线程安全）
+   * @brief 非阻塞出队（过期任务处理与 PopBlocking 相同）
+   * @return 队列为空（或只剩过期任务）时返回 false
+   */
+  bool TryPop(my_data::Task& out);
+
+  /**
+   * @brief 队列长度（线程安全，无锁读取最近一次发布的长度）
    */
   std::size_t Size() const;
 
+  /**
+   * @brief 状态版本号：入队/出队/清空/关闭时递增（无锁），用于判断 Size 等状态是否变化
+   */
+  std::uint64_t Version() const;
+
   /**
    * @brief 清空队列（线程安全）
    */
@@ -72,13 +184,59 @@ public:
    */
   const std::string& Name() const { return name_; }
 
+  TaskQueueMode Mode() const { return options_.mode; }
+
+  /**
+   * @brief 当前长度 + 各优先级排队等待统计
+   */
+  TaskQueueStats Stats() const;
+
+private:
+  static constexpr std::size_t kHeapArity = 4;
+
+  struct HeapEntry {
+    int priority{0};
+    TimestampMs deadline_at_ms{0};  // 0 表示无 deadline
+    std::uint64_t seq{0};           // 入队序号（同键时保持 FIFO）
+    std::uint32_t slot{0};
+  };
+
+  struct Slot {
+    my_data::Task task;
+    std::int64_t enqueued_at_ms{0};  // steady clock，用于等待时长统计
+  };
+
+  bool Before(const HeapEntry& a, const HeapEntry& b) const;
+  void PushLocked(my_data::Task&& task);
+  // 使用预先保留的入队序号（带日志的 Push 在落盘后才入堆，序号在写日志时保留）
+  void PushLocked(my_data::Task&& task, std::uint64_t seq);
+  my_data::Task PopTopLocked(std::int64_t* waited_ms);
+  void SiftUpLocked(std::size_t i);
+  void SiftDownLocked(std::size_t i);
+  void PublishSizeLocked();
+
+  using ExpiredList = std::vector<std::pair<my_data::Task, my_data::TaskResult>>;
+  // 弹出一个未过期任务；过期任务移入 expired，由调用方在锁外 ReportExpired
+  bool PopReadyLocked(my_data::Task& out, ExpiredList* expired);
+  void ReportExpired(const ExpiredCallback& cb, ExpiredList* expired) const;
+
 private:
   std::string name_;
+  TaskQueueOptions options_;
 
   mutable std::mutex mu_;         // 保护队列与状态
   std::condition_variable cv_;    // 用于阻塞等待
-  std::deque<my_data::Task> q_;   // 任务队列
+  std::vector<HeapEntry> heap_;   // 4 叉堆
+  std::vector<Slot> slots_;       // Task 存放处（下标由 heap_ 引用）
+  std::vector<std::uint32_t> free_slots_;
+  std::uint64_t next_seq_{0};
   bool shutdown_{false};          // 是否已关闭
+  std::shared_ptr<TaskJournal> journal_;  // 可选：任务日志
+  ExpiredCallback on_expired_{};
+  ReadyCallback on_ready_{};
+  std::map<int, TaskQueueWaitStats> wait_stats_;
+  std::atomic<std::size_t> published_size_{0};  // heap_.size() 的发布值（mu_ 内写）
+  std::atomic<std::uint64_t> version_{0};
 };
 
 } // namespace my_control
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "WorkflowScheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "MyLog.h"
+
+namespace my_control {
+
+nlohmann::json ToJson(const WorkflowSchedulerStats& st) {
+  return nlohmann::json{
+      {"workers", st.workers},
+      {"queued", st.queued},
+      {"timers", st.timers},
+      {"executed", st.executed},
+  };
+}
+
+WorkflowScheduler& WorkflowScheduler::GetInstance() {
+  static WorkflowScheduler instance;
+  return instance;
+}
+
+WorkflowScheduler::~WorkflowScheduler() {
+  Stop();
+}
+
+void WorkflowScheduler::Start(std::size_t workers) {
+  std::lock_guard<std::mutex> lk(mu_);
+  StartLocked(workers);
+}
+
+void WorkflowScheduler::StartLocked(std::size_t workers) {
+  if (running_) return;
+  if (workers == 0) {
+    workers = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+  }
+  stop_ = false;
+  running_ = true;
+  workers_.reserve(workers);
+  for (std::size_t i = 0; i < workers; ++i) {
+    workers_.emplace_back(&WorkflowScheduler::WorkerLoop, this);
+  }
+  timer_thread_ = std::thread(&WorkflowScheduler::TimerLoop, this);
+  MYLOG_INFO("[WorkflowScheduler] 启动：workers={}", workers);
+}
+
+void WorkflowScheduler::Stop() {
+  std::vector<std::thread> workers;
+  std::thread timer;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!running_ || stop_) return;
+    stop_ = true;
+    // 未到期的定时任务提前触发，不丢弃
+    if (!timers_.empty()) {
+      MYLOG_WARN("[WorkflowScheduler] 停止：提前触发 {} 个未到期的定时任务", timers_.size());
+      for (auto& [due, fn] : timers_) {
+        ready_.push_back(std::move(fn));
+      }
+      timers_.clear();
+    }
+    workers.swap(workers_);
+    timer = std::move(timer_thread_);
+  }
+  cv_.notify_all();
+  timer_cv_.notify_all();
+  for (auto& t : workers) {
+    if (t.joinable()) t.join();
+  }
+  if (timer.joinable()) timer.join();
+
+  std::lock_guard<std::mutex> lk(mu_);
+  running_ = false;
+  MYLOG_INFO("[WorkflowScheduler] 已停止：executed={}", executed_);
+}
+
+void WorkflowScheduler::Post(Fn fn) {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    StartLocked(0);
+    ready_.push_back(std::move(fn));
+  }
+  cv_.notify_one();
+}
+
+void WorkflowScheduler::RunAfter(int delay_ms, Fn fn) {
+  if (delay_ms <= 0) {
+    Post(std::move(fn));
+    return;
+  }
+  bool earliest = false;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    StartLocked(0);
+    const auto due = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms);
+    auto it = timers_.emplace(due, std::move(fn));
+    earliest = (it == timers_.begin());
+  }
+  if (earliest) timer_cv_.notify_one();
+}
+
+WorkflowSchedulerStats WorkflowScheduler::Stats() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  WorkflowSchedulerStats st;
+  st.workers = workers_.size();
+  st.queued = ready_.size();
+  st.timers = timers_.size();
+  st.executed = executed_;
+  return st;
+}
+
+void WorkflowScheduler::WorkerLoop() {
+  std::unique_lock<std::mutex> lk(mu_);
+  while (true) {
+    cv_.wait(lk, [&]() { return !ready_.empty() || (stop_ && DrainedLocked()); });
+    if (ready_.empty()) break;  // 已排空
+    Fn fn = std::move(ready_.front());
+    ready_.pop_front();
+    ++executed_;
+    ++active_;
+    lk.unlock();
+    try {
+      fn();
+    } catch (const std::exception& e) {
+      MYLOG_ERROR("[WorkflowScheduler] 任务异常：{}", e.what());
+    } catch (...) {
+      MYLOG_ERROR("[WorkflowScheduler] 任务未知异常");
+    }
+    lk.lock();
+    --active_;
+    if (stop_ && DrainedLocked()) {
+      // 最后一个任务结束：唤醒其余工作线程与定时线程退出
+      cv_.notify_all();
+      timer_cv_.notify_all();
+    }
+  }
+}
+
+void WorkflowScheduler::TimerLoop() {
+  std::unique_lock<std::mutex> lk(mu_);
+  while (!(stop_ && DrainedLocked())) {
+    if (timers_.empty()) {
+      timer_cv_.wait(lk, [&]() { return !timers_.empty() || (stop_ && DrainedLocked()); });
+      continue;
+    }
+    const auto due = timers_.begin()->first;
+    if (due > std::chrono::steady_clock::now()) {
+      timer_cv_.wait_until(lk, due);
+      continue;
+    }
+    // 到期的一次性全部转入就绪队列
+    const auto now = std::chrono::steady_clock::now();
+    std::size_t n = 0;
+    while (!timers_.empty() && timers_.begin()->first <= now) {
+      ready_.push_back(std::move(timers_.begin()->second));
+      timers_.erase(timers_.begin());
+      ++n;
+    }
+    if (n == 1) {
+      cv_.notify_one();
+    } else {
+      cv_.notify_all();
+    }
+  }
+}
+
+} // namespace my_control
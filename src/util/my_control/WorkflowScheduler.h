@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace my_control {
+
+struct WorkflowSchedulerStats {
+  std::size_t workers{0};
+  std::size_t queued{0};          // 等待执行的就绪任务
+  std::size_t timers{0};          // 未到期的定时任务
+  std::uint64_t executed{0};      // 已执行的就绪任务（含定时任务到期后的执行）
+};
+
+nlohmann::json ToJson(const WorkflowSchedulerStats& st);
+
+/**
+ * @brief M:N 调度器：固定数量的工作线程 + 一个定时线程，承载大量轻量 Workflow
+ *
+ * @details
+ * - Post：投递一个短小、不阻塞的函数，由任一工作线程执行
+ * - RunAfter：到期后再 Post（用于把“等待 I/O/延时”变成回调，而不占用线程）
+ * - 工作线程数默认取 std::thread::hardware_concurrency()；首次 Post 时自动启动
+ * - 投递的函数不保证执行顺序；需要按设备保序的调用方（Workflow）自行保证同一时刻只投递一个
+ */
+class WorkflowScheduler {
+public:
+  using Fn = std::function<void()>;
+
+  static WorkflowScheduler& GetInstance();
+
+  WorkflowScheduler() = default;
+  ~WorkflowScheduler();
+
+  WorkflowScheduler(const WorkflowScheduler&) = delete;
+  WorkflowScheduler& operator=(const WorkflowScheduler&) = delete;
+
+  /**
+   * @brief 启动工作线程（幂等）；workers=0 表示按 CPU 核数
+   */
+  void Start(std::size_t workers = 0);
+
+  /**
+   * @brief 排空后停止全部线程
+   *
+   * 调用时未到期的定时任务立即触发（完成回调里往往持有调用方的计数，丢弃会让 Workflow::Join 永远等待）；
+   * 排空期间新投递的任务照常执行，新登记的定时任务按原延时执行；就绪队列、定时任务均为空且没有执行中的任务后返回
+   */
+  void Stop();
+
+  void Post(Fn fn);
+  void RunAfter(int delay_ms, Fn fn);
+
+  WorkflowSchedulerStats Stats() const;
+
+private:
+  void WorkerLoop();
+  void TimerLoop();
+  void StartLocked(std::size_t workers);
+  bool DrainedLocked() const { return ready_.empty() && timers_.empty() && active_ == 0; }
+
+private:
+  mutable std::mutex mu_;
+  std::condition_variable cv_;        // 唤醒工作线程
+  std::condition_variable timer_cv_;  // 唤醒定时线程
+  std::deque<Fn> ready_;
+  std::multimap<std::chrono::steady_clock::time_point, Fn> timers_;
+  std::vector<std::thread> workers_;
+  std::thread timer_thread_;
+  bool running_{false};
+  bool stop_{false};                  // 排空中：running_ 仍为 true，Post/RunAfter 不会另起线程
+  std::size_t active_{0};             // 正在执行的任务数（执行中可能继续 Post/RunAfter）
+  std::uint64_t executed_{0};
+};
+
+} // namespace my_control
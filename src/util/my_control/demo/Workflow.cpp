@@ -1,13 +1,40 @@
 #include "Workflow.h"
 
 #include <chrono>
+#include <memory>
 #include <utility>
 
+#include "WorkflowScheduler.h"
+
 namespace my_control::demo {
 
-Workflow::Workflow(std::string name, my_control::TaskQueue& queue, my_control::IControl& control)
-    : name_(std::move(name)), queue_(queue), control_(control) {
-  MYLOG_INFO("[Workflow:{}] 创建：queue={}, control={}", name_, queue_.Name(), control_.Name());
+namespace {
+constexpr int kEStopRetryMs = 200;
+} // namespace
+
+std::string ToString(WorkflowMode m) {
+  switch (m) {
+    case WorkflowMode::Thread: return "thread";
+    case WorkflowMode::Pooled: return "pooled";
+    default: return "unknown";
+  }
+}
+
+bool ParseWorkflowMode(const std::string& s, WorkflowMode* out) {
+  if (s == "thread") {
+    *out = WorkflowMode::Thread;
+    return true;
+  }
+  if (s == "pooled") {
+    *out = WorkflowMode::Pooled;
+    return true;
+  }
+  return false;
+}
+
+Workflow::Workflow(std::string name, my_control::TaskQueue& queue, my_control::IControl& control, WorkflowMode mode)
+    : name_(std::move(name)), queue_(queue), control_(control), mode_(mode) {
+  MYLOG_INFO("[Workflow:{}] 创建：queue={}, control={}, mode={}", name_, queue_.Name(), control_.Name(), ToString(mode_));
 }
 
 Workflow::~Workflow() {
@@ -23,6 +50,19 @@ bool Workflow::Start() {
   }
   stop_ = false;
 
+  // 队列出队时丢弃的过期任务（state=Cancelled）经 on_expired 上报，调用发生在出队线程的 PopBlocking/TryPop 内
+  queue_.SetExpiredCallback([this](const my_data::Task& task, const my_data::TaskResult& result) {
+    MYLOG_WARN("[Workflow:{}] 任务过期未执行：task_id={}, message={}", name_, task.task_id, result.message);
+    if (on_expired_) on_expired_(task, result);
+  });
+
+  if (mode_ == WorkflowMode::Pooled) {
+    MYLOG_INFO("[Workflow:{}] 启动（pooled）：由 WorkflowScheduler 调度", name_);
+    // 队列中已有的任务（如日志回放）会在这里立即触发一次
+    queue_.SetReadyCallback([this]() { SignalReady(); });
+    return true;
+  }
+
   MYLOG_INFO("[Workflow:{}] 启动线程", name_);
   worker_ = std::thread(&Workflow::RunLoop, this);
   return true;
@@ -32,16 +72,32 @@ void Workflow::Stop() {
   if (!running_.load()) return;
 
   stop_ = true;
-  MYLOG_WARN("[Workflow:{}] Stop：请求停止线程", name_);
+  MYLOG_WARN("[Workflow:{}] Stop：请求停止{}", name_, mode_ == WorkflowMode::Pooled ? "调度" : "线程");
 
   // 注意：queue 实例归 Edge，通常由 Edge 在全局 shutdown 时调用 queue.Shutdown()
   // 这里不强制 shutdown queue，以保持“队列归属”边界清晰。
 }
 
 void Workflow::Join() {
+  if (mode_ == WorkflowMode::Pooled) {
+    if (!running_.load()) return;
+    // 先解绑入队回调（返回后不会再有新的 Step 被投递），再等已投递的 Step / 执行中的任务结束
+    queue_.SetReadyCallback(nullptr);
+    MYLOG_INFO("[Workflow:{}] Join：等待未完成的调度回调...", name_);
+    {
+      std::unique_lock<std::mutex> lk(pool_mu_);
+      pool_cv_.wait(lk, [&]() { return outstanding_ == 0; });
+    }
+    queue_.SetExpiredCallback(nullptr);
+    running_ = false;
+    MYLOG_INFO("[Workflow:{}] Join：调度已结束", name_);
+    return;
+  }
+
   if (worker_.joinable()) {
     MYLOG_INFO("[Workflow:{}] Join：等待线程回收...", name_);
     worker_.join();
+    queue_.SetExpiredCallback(nullptr);
     MYLOG_INFO("[Workflow:{}] Join：线程已回收", name_);
   }
   running_ = false;
@@ -54,7 +110,7 @@ void Workflow::RunLoop() {
     // 1) EStop：不取新任务（MVP）
     if (estop_flag_ && estop_flag_->load()) {
       MYLOG_WARN("[Workflow:{}] EStop=true：暂停取新任务", name_);
-      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      std::this_thread::sleep_for(std::chrono::milliseconds(kEStopRetryMs));
       continue;
     }
 
@@ -70,55 +126,163 @@ void Workflow::RunLoop() {
       continue;
     }
 
+    task.trace.dequeued_us = my_data::MonoUs();
     MYLOG_INFO("[Workflow:{}] 已取到任务：task_id={}, device_id={}, capability={}, action={}",
                name_, task.task_id, task.device_id, task.capability, task.action);
 
     // 3) on_start：Pop 成功后、DoTask 前触发
-    if (on_start_) {
-      try {
-        MYLOG_INFO("[Workflow:{}] on_start 回调触发：task_id={}", name_, task.task_id);
-        on_start_(task);
-      } catch (const std::exception& e) {
-        MYLOG_ERROR("[Workflow:{}] on_start 回调异常：task_id={}, err={}", name_, task.task_id, e.what());
-      } catch (...) {
-        MYLOG_ERROR("[Workflow:{}] on_start 回调未知异常：task_id={}", name_, task.task_id);
-      }
-    }
+    NotifyStart(task);
 
     // 4) 执行
-    MYLOG_INFO("[Workflow:{}] 开始执行 task_id={}", name_, task.task_id);
+    my_data::TaskResult result = Execute(task);
+
+    // 5) on_finish + 6) MarkDone
+    Complete(task, result);
+  }
+
+  running_ = false;
+  MYLOG_WARN("[Workflow:{}] RunLoop 退出", name_);
+}
+
+void Workflow::NotifyStart(const my_data::Task& task) {
+  if (!on_start_) return;
+  try {
+    MYLOG_INFO("[Workflow:{}] on_start 回调触发：task_id={}", name_, task.task_id);
+    on_start_(task);
+  } catch (const std::exception& e) {
+    MYLOG_ERROR("[Workflow:{}] on_start 回调异常：task_id={}, err={}", name_, task.task_id, e.what());
+  } catch (...) {
+    MYLOG_ERROR("[Workflow:{}] on_start 回调未知异常：task_id={}", name_, task.task_id);
+  }
+}
+
+my_data::TaskResult Workflow::Execute(my_data::Task& task) {
+  MYLOG_INFO("[Workflow:{}] 开始执行 task_id={}", name_, task.task_id);
 
-    my_data::TaskResult result;
+  my_data::TaskResult result;
+  task.trace.exec_start_us = my_data::MonoUs();
+  try {
+    result = control_.DoTask(task);
+  } catch (const std::exception& e) {
+    MYLOG_ERROR("[Workflow:{}] DoTask 异常：task_id={}, err={}", name_, task.task_id, e.what());
+    result.code = my_data::ErrorCode::InternalError;
+    result.message = std::string("DoTask exception: ") + e.what();
+  } catch (...) {
+    MYLOG_ERROR("[Workflow:{}] DoTask 未知异常：task_id={}", name_, task.task_id);
+    result.code = my_data::ErrorCode::InternalError;
+    result.message = "DoTask unknown exception";
+  }
+  task.trace.exec_finish_us = my_data::MonoUs();
+  return result;
+}
+
+void Workflow::Complete(const my_data::Task& task, const my_data::TaskResult& result) {
+  MYLOG_INFO("[Workflow:{}] 执行完成 task_id={}, result_code={}, message={}",
+             name_, task.task_id, my_data::ToString(result.code), result.message);
+
+  // on_finish：DoTask 后触发
+  if (on_finish_) {
     try {
-      result = control_.DoTask(task);
+      MYLOG_INFO("[Workflow:{}] on_finish 回调触发：task_id={}", name_, task.task_id);
+      on_finish_(task, result);
     } catch (const std::exception& e) {
-      MYLOG_ERROR("[Workflow:{}] DoTask 异常：task_id={}, err={}", name_, task.task_id, e.what());
-      result.code = my_data::ErrorCode::InternalError;
-      result.message = std::string("DoTask exception: ") + e.what();
+      MYLOG_ERROR("[Workflow:{}] on_finish 回调异常：{}", name_, e.what());
     } catch (...) {
-      MYLOG_ERROR("[Workflow:{}] DoTask 未知异常：task_id={}", name_, task.task_id);
-      result.code = my_data::ErrorCode::InternalError;
-      result.message = "DoTask unknown exception";
+      MYLOG_ERROR("[Workflow:{}] on_finish 回调未知异常", name_);
+    }
+  }
+
+  // 延迟聚合（queue_wait / exec / end_to_end）
+  my_data::TaskTracer::GetInstance().Record(task, result);
+
+  // 写 complete 记录（绑定任务日志时），重启后不再回放该任务
+  queue_.MarkDone(task);
+}
+
+// ---------------- pooled 模式 ----------------
+
+void Workflow::Hold() {
+  std::lock_guard<std::mutex> lk(pool_mu_);
+  ++outstanding_;
+}
+
+void Workflow::Release() {
+  bool idle = false;
+  {
+    std::lock_guard<std::mutex> lk(pool_mu_);
+    idle = (--outstanding_ == 0);
+  }
+  if (idle) pool_cv_.notify_all();
+}
+
+void Workflow::SignalReady() {
+  dirty_.store(true);
+  if (!busy_.exchange(true)) {
+    PostStep();
+  }
+}
+
+void Workflow::PostStep() {
+  Hold();
+  WorkflowScheduler::GetInstance().Post([this]() {
+    Step();
+    Release();
+  });
+}
+
+void Workflow::Step() {
+  dirty_.store(false);
+
+  if (!stop_.load()) {
+    // EStop：不取新任务，定时再看（busy_ 保持，期间的入队通知只记 dirty_）
+    if (estop_flag_ && estop_flag_->load()) {
+      Hold();
+      WorkflowScheduler::GetInstance().RunAfter(kEStopRetryMs, [this]() {
+        Step();
+        Release();
+      });
+      return;
     }
 
-    MYLOG_INFO("[Workflow:{}] 执行完成 task_id={}, result_code={}, message={}",
-               name_, task.task_id, my_data::ToString(result.code), result.message);
+    auto task = std::make_shared<my_data::Task>();
+    if (queue_.TryPop(*task)) {
+      task->trace.dequeued_us = my_data::MonoUs();
+      NotifyStart(*task);
+      MYLOG_INFO("[Workflow:{}] 开始执行 task_id={}", name_, task->task_id);
 
-    // 5) on_finish：DoTask 后触发
-    if (on_finish_) {
+      // 完成回调：收尾后投递下一个 Step（先 PostStep 再 Release，outstanding 不会中途归零）
+      Hold();
+      auto done = [this, task](my_data::TaskResult result) {
+        task->trace.exec_finish_us = my_data::MonoUs();
+        Complete(*task, result);
+        PostStep();
+        Release();
+      };
+      task->trace.exec_start_us = my_data::MonoUs();
       try {
-        MYLOG_INFO("[Workflow:{}] on_finish 回调触发：task_id={}", name_, task.task_id);
-        on_finish_(task, result);
+        control_.DoTaskAsync(*task, done);
       } catch (const std::exception& e) {
-        MYLOG_ERROR("[Workflow:{}] on_finish 回调异常：{}", name_, e.what());
+        MYLOG_ERROR("[Workflow:{}] DoTaskAsync 异常：task_id={}, err={}", name_, task->task_id, e.what());
+        my_data::TaskResult result;
+        result.code = my_data::ErrorCode::InternalError;
+        result.message = std::string("DoTask exception: ") + e.what();
+        done(std::move(result));
       } catch (...) {
-        MYLOG_ERROR("[Workflow:{}] on_finish 回调未知异常", name_);
+        MYLOG_ERROR("[Workflow:{}] DoTaskAsync 未知异常：task_id={}", name_, task->task_id);
+        my_data::TaskResult result;
+        result.code = my_data::ErrorCode::InternalError;
+        result.message = "DoTask unknown exception";
+        done(std::move(result));
       }
+      return;
     }
   }
 
-  running_ = false;
-  MYLOG_WARN("[Workflow:{}] RunLoop 退出", name_);
+  // 队列已空（或已停止）：让出；若期间有新的入队通知则重新投递
+  busy_.store(false);
+  if (!stop_.load() && dirty_.load() && !busy_.exchange(true)) {
+    PostStep();
+  }
 }
 
-} // namespace my_control::demo
\ No newline at end of file
+} // namespace my_control::demo
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
+#include <cstddef>
 #include <functional>
+#include <mutex>
 #include <string>
 #include <thread>
 
@@ -13,19 +16,45 @@
 namespace my_control::demo {
 
 /**
- * @brief Workflow（调度线程）：每个 device_id 一条线程
+ * @brief 执行方式
+ * - Thread：每个 Workflow 一条线程，阻塞在 TaskQueue 上（默认）
+ * - Pooled：不占用独立线程，由 WorkflowScheduler 的固定工作线程池按需执行（M:N）
+ */
+enum class WorkflowMode {
+  Thread = 0,
+  Pooled = 1,
+};
+
+std::string ToString(WorkflowMode m);
+
+/**
+ * @brief 解析配置值 "thread" / "pooled"；无法识别时返回 false（out 不变）
+ */
+bool ParseWorkflowMode(const std::string& s, WorkflowMode* out);
+
+/**
+ * @brief Workflow（调度单元）：每个 device_id 一个
  *
  * @details
  * - 绑定：TaskQueue& + IControl&
- * - 运行：循环 pop task -> (on_start) -> doTask -> (on_finish)
+ * - 运行：循环 pop task -> (on_start) -> doTask -> (on_finish) -> queue.MarkDone
+ * - 出队、执行前后在 Task::trace 上打点，收尾时交给 my_data::TaskTracer 聚合延迟
+ * - 出队时过期被丢弃的任务不执行，以 Cancelled 结果触发 on_expired（不触发 on_start/on_finish）
  * - 停止：Stop + Join；通常由 Device/Edge 生命周期控制
+ *
+ * Pooled 模式：
+ * - 队列入队回调唤醒 Workflow，投递一个 Step 到调度器；Step 非阻塞 TryPop 并调用 IControl::DoTaskAsync，
+ *   完成回调里再投递下一个 Step，直到队列为空
+ * - 同一时刻最多一个 Step 或一个执行中的任务，保证同一设备的任务按出队顺序串行执行
+ * - 回调可能在不同的工作线程上执行
  */
 class Workflow {
 public:
   using StartCallback = std::function<void(const my_data::Task&)>;
   using FinishCallback = std::function<void(const my_data::Task&, const my_data::TaskResult&)>;
 
-  Workflow(std::string name, my_control::TaskQueue& queue, my_control::IControl& control);
+  Workflow(std::string name, my_control::TaskQueue& queue, my_control::IControl& control,
+           WorkflowMode mode = WorkflowMode::Thread);
 
   ~Workflow();
 
@@ -44,20 +73,39 @@ public:
    */
   void SetFinishCallback(FinishCallback cb) { on_finish_ = std::move(cb); }
 
+  /**
+   * @brief 任务过期回调（出队时已过 deadline 被丢弃，未执行；result.code=Timeout）
+   */
+  void SetExpiredCallback(FinishCallback cb) { on_expired_ = std::move(cb); }
+
   bool Start();
   void Stop();
   void Join();
 
   bool IsRunning() const { return running_.load(); }
   const std::string& Name() const { return name_; }
+  WorkflowMode Mode() const { return mode_; }
 
 private:
   void RunLoop();
 
+  // 两种模式共用：on_start / 同步执行 / on_finish + MarkDone
+  void NotifyStart(const my_data::Task& task);
+  my_data::TaskResult Execute(my_data::Task& task);  // 同时记录 exec_start/exec_finish
+  void Complete(const my_data::Task& task, const my_data::TaskResult& result);
+
+  // Pooled 模式
+  void SignalReady();  // TaskQueue 入队回调（队列锁内）
+  void PostStep();
+  void Step();
+  void Hold();
+  void Release();
+
 private:
   std::string name_;
   my_control::TaskQueue& queue_;
   my_control::IControl& control_;
+  WorkflowMode mode_{WorkflowMode::Thread};
 
   std::atomic<bool> running_{false};
   std::atomic<bool> stop_{false};
@@ -68,6 +116,14 @@ private:
 
   StartCallback on_start_{};
   FinishCallback on_finish_{};
+  FinishCallback on_expired_{};
+
+  // Pooled 模式状态
+  std::atomic<bool> busy_{false};    // 已投递 Step 或有任务在执行
+  std::atomic<bool> dirty_{false};   // busy 期间收到入队通知
+  std::mutex pool_mu_;
+  std::condition_variable pool_cv_;
+  std::size_t outstanding_{0};       // 未完成的投递/定时/异步回调数；Join 等其归零
 };
 
 } // namespace my_control::demo
\ No newline at end of file
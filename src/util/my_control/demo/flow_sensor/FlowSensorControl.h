@@ -19,9 +19,15 @@ class FlowSensorControl final : public my_control::IControl {
 public:
   bool Init(const nlohmann::json& cfg, std::string* err) override;
   my_data::TaskResult DoTask(const my_data::Task& task) override;
+  void DoTaskAsync(const my_data::Task& task, DoneCallback done) override;
   std::string Name() const override { return "FlowSensorControl"; }
 
 private:
+  // 校验 capability 并记录开始时间；失败时填好 r 并返回 false
+  bool Accept(const my_data::Task& task, my_data::TaskResult* r) const;
+  // 采样完成后生成结果（DoTask 与 DoTaskAsync 共用）
+  void Measure(const my_data::Task& task, my_data::TaskResult* r) const;
+
   std::string device_name_{"flow-sensor-demo"};
   int simulate_latency_ms_{50};
   double flow_base_mps_{0.8};
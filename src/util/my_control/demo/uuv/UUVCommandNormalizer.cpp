@@ -50,7 +50,7 @@ std::optional<my_data::Task> UUVCommandNormalizer::Normalize(const my_data::RawC
   task.task_id = my_data::GenerateId("task");
   task.created_at_ms = my_data::NowMs();
 
-  // 幂等字段：预留不启用
+  // 幂等字段：BaseEdge::Submit 据此去重
   task.idempotency_key = !in.idempotency_key.empty() ? in.idempotency_key : task.command_id;
   task.dedup_window_ms = in.dedup_window_ms;
 
@@ -3,6 +3,9 @@
 #include <chrono>
 #include <random>
 #include <thread>
+#include <utility>
+
+#include "WorkflowScheduler.h"
 
 namespace my_control::demo {
 
@@ -26,21 +29,45 @@ bool WindSensorDevice::Init(const nlohmann::json& cfg, std::string* err) {
 }
 
 my_data::TaskResult WindSensorDevice::DoTask(const my_data::Task& task) {
+  my_data::TaskResult r;
+  if (!Accept(task, &r)) return r;
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(simulate_latency_ms_));
+  Measure(task, &r);
+  return r;
+}
+
+void WindSensorDevice::DoTaskAsync(const my_data::Task& task, DoneCallback done) {
+  my_data::TaskResult r;
+  if (!Accept(task, &r)) {
+    done(std::move(r));
+    return;
+  }
+
+  // 模拟采样延时：到期后由调度器回调，不占用工作线程
+  my_control::WorkflowScheduler::GetInstance().RunAfter(
+      simulate_latency_ms_, [this, task, r, done = std::move(done)]() mutable {
+        Measure(task, &r);
+        done(std::move(r));
+      });
+}
+
+bool WindSensorDevice::Accept(const my_data::Task& task, my_data::TaskResult* r) const {
   MYLOG_INFO("[Control:{}] DoTask: device={}, task_id={}, capability={}, action={}, params={}",
              Name(), device_name_, task.task_id, task.capability, task.action, task.params.dump());
 
-  my_data::TaskResult r;
-  r.started_at_ms = my_data::NowMs();
+  r->started_at_ms = my_data::NowMs();
 
   if (task.capability != "wind") {
-    r.code = my_data::ErrorCode::InvalidCommand;
-    r.message = "unsupported capability for split speed sensor: " + task.capability;
-    r.finished_at_ms = my_data::NowMs();
-    return r;
+    r->code = my_data::ErrorCode::InvalidCommand;
+    r->message = "unsupported capability for split speed sensor: " + task.capability;
+    r->finished_at_ms = my_data::NowMs();
+    return false;
   }
+  return true;
+}
 
-  std::this_thread::sleep_for(std::chrono::milliseconds(simulate_latency_ms_));
-
+void WindSensorDevice::Measure(const my_data::Task& task, my_data::TaskResult* r) const {
   if (task.action == "read") {
     static thread_local std::mt19937 rng{std::random_device{}()};
     std::normal_distribution<double> nd(0.0, noise_);
@@ -49,23 +76,22 @@ my_data::TaskResult WindSensorDevice::DoTask(const my_data::Task& task) {
     double vy = vy_base_ + nd(rng);
     double vz = vz_base_ + nd(rng);
 
-    r.code = my_data::ErrorCode::Ok;
-    r.message = "split speed read ok";
-    r.output = nlohmann::json{
+    r->code = my_data::ErrorCode::Ok;
+    r->message = "split speed read ok";
+    r->output = nlohmann::json{
         {"vx", vx},
         {"vy", vy},
         {"vz", vz},
         {"unit", "m/s"},
     };
   } else {
-    r.code = my_data::ErrorCode::InvalidCommand;
-    r.message = "unknown action for wind: " + task.action;
+    r->code = my_data::ErrorCode::InvalidCommand;
+    r->message = "unknown action for wind: " + task.action;
   }
 
-  r.finished_at_ms = my_data::NowMs();
+  r->finished_at_ms = my_data::NowMs();
   MYLOG_INFO("[Control:{}] DoTask done: task_id={}, code={}, message={}, output={}",
-             Name(), task.task_id, my_data::ToString(r.code), r.message, r.output.dump());
-  return r;
+             Name(), task.task_id, my_data::ToString(r->code), r->message, r->output.dump());
 }
 
 } // namespace my_control::demo
\ No newline at end of file
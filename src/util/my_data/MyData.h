@@ -9,10 +9,14 @@
  */
 
 #include "demo/Types.h"
+#include "demo/Symbol.h"
 #include "demo/Error.h"
 #include "demo/TaskResult.h"
 #include "demo/Task.h"
 #include "demo/Status.h"
 #include "demo/RawCommand.h"
 #include "demo/TimeUtil.h"
-#include "demo/IdUtil.h"
\ No newline at end of file
+#include "demo/IdUtil.h"
+#include "demo/VersionedSnapshot.h"
+#include "demo/TaskTrace.h"
+#include "demo/TaskTracer.h"
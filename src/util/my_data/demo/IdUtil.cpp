@@ -1,15 +1,110 @@
 #include "IdUtil.h"
 #include "TimeUtil.h"
 #include <atomic>
-#include <sstream>
 
 namespace my_data {
 
+namespace {
+
+constexpr TimestampMs kIdEpochMs = 1704067200000LL;  // 2024-01-01T00:00:00Z
+constexpr int kSeqBits = 12;
+constexpr int kNodeBits = 10;
+constexpr int kTimeBits = 41;
+constexpr std::uint64_t kSeqMask = (std::uint64_t(1) << kSeqBits) - 1;
+constexpr std::uint64_t kNodeMask = (std::uint64_t(1) << kNodeBits) - 1;
+constexpr std::uint64_t kTimeMask = (std::uint64_t(1) << kTimeBits) - 1;
+
+constexpr char kBase32[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+constexpr std::size_t kBase32Len = 13;  // 13 * 5 = 65 位
+
+std::atomic<std::uint32_t> g_node_id{0};
+// 逻辑时钟：高位为相对毫秒，低 12 位为该毫秒内已用的序号
+std::atomic<std::uint64_t> g_clock{0};
+
+int Base32Value(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+  switch (c) {
+    case 'O': return 0;
+    case 'I':
+    case 'L': return 1;
+    default: break;
+  }
+  for (int i = 10; i < 32; ++i) {
+    if (kBase32[i] == c) return i;
+  }
+  return -1;
+}
+
+} // namespace
+
+void SetIdNodeId(std::uint32_t node_id) {
+  g_node_id.store(static_cast<std::uint32_t>(node_id & kNodeMask), std::memory_order_relaxed);
+}
+
+std::uint32_t IdNodeId() {
+  return g_node_id.load(std::memory_order_relaxed);
+}
+
+Id64 NextId64() {
+  const TimestampMs now = NowMs() - kIdEpochMs;
+  const std::uint64_t now_ms = now > 0 ? static_cast<std::uint64_t>(now) & kTimeMask : 0;
+
+  std::uint64_t cur = g_clock.load(std::memory_order_relaxed);
+  std::uint64_t next = 0;
+  do {
+    const std::uint64_t cur_ms = cur >> kSeqBits;
+    if (now_ms > cur_ms) {
+      next = now_ms << kSeqBits;
+    } else if ((cur & kSeqMask) < kSeqMask) {
+      next = cur + 1;  // 同一毫秒或时钟回拨：序号递增
+    } else {
+      next = (cur_ms + 1) << kSeqBits;  // 序号用尽：逻辑时钟前移 1ms
+    }
+  } while (!g_clock.compare_exchange_weak(cur, next, std::memory_order_relaxed));
+
+  const std::uint64_t ms = (next >> kSeqBits) & kTimeMask;
+  return (ms << (kNodeBits + kSeqBits)) |
+         (static_cast<std::uint64_t>(IdNodeId()) << kSeqBits) |
+         (next & kSeqMask);
+}
+
+TimestampMs Id64TimestampMs(Id64 id) {
+  return static_cast<TimestampMs>((id >> (kNodeBits + kSeqBits)) & kTimeMask) + kIdEpochMs;
+}
+
+std::string EncodeId64(Id64 id) {
+  std::string out(kBase32Len, '0');
+  for (std::size_t i = kBase32Len; i-- > 0;) {
+    out[i] = kBase32[id & 31u];
+    id >>= 5;
+  }
+  return out;
+}
+
+bool DecodeId64(const std::string& text, Id64* out) {
+  if (text.size() != kBase32Len) return false;
+  Id64 v = 0;
+  for (std::size_t i = 0; i < kBase32Len; ++i) {
+    const int d = Base32Value(text[i]);
+    if (d < 0) return false;
+    if (i == 0 && d > 15) return false;  // 首位只承载 4 位
+    v = (v << 5) | static_cast<Id64>(d);
+  }
+  if (out) *out = v;
+  return true;
+}
+
 std::string GenerateId(const char* prefix) {
-  static std::atomic<std::uint64_t> seq{0};
-  std::ostringstream oss;
-  oss << (prefix ? prefix : "id") << "-" << NowMs() << "-" << seq.fetch_add(1);
-  return oss.str();
+  std::string id(prefix ? prefix : "id");
+  id.push_back('-');
+  id += EncodeId64(NextId64());
+  return id;
+}
+
+bool ParseGeneratedId(const std::string& id, Id64* out) {
+  const auto pos = id.rfind('-');
+  return DecodeId64(pos == std::string::npos ? id : id.substr(pos + 1), out);
 }
 
-} // namespace my_data
\ No newline at end of file
+} // namespace my_data
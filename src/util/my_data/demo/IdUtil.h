@@ -4,11 +4,55 @@
 namespace my_data {
 
 /**
- * @brief 生成一个“够用”的ID（MVP 版）
+ * @brief 64 位时间有序 ID（Snowflake 布局）
  *
- * @note 这是 demo 级实现：时间戳 + 递增计数。
- *       未来可替换为 UUID，不影响上层。
+ * @details
+ * - bit 63      : 0（保证可作为 SQLite INTEGER / int64 存储）
+ * - bit 62..22  : 41 位毫秒时间戳（相对 2024-01-01T00:00:00Z，约 69 年）
+ * - bit 21..12  : 10 位节点号（0~1023，来自配置 id_node_id）
+ * - bit 11..0   : 12 位序号（同一毫秒内递增，单节点每毫秒 4096 个）
+ *
+ * 生成过程只有一次 CAS，无锁；同一毫秒序号用尽或系统时钟回拨时逻辑时钟继续向前，
+ * 保证单进程内严格递增。
+ */
+using Id64 = std::uint64_t;
+
+/**
+ * @brief 设置节点号（启动时按配置调用一次；超出 0~1023 取低 10 位）
+ */
+void SetIdNodeId(std::uint32_t node_id);
+std::uint32_t IdNodeId();
+
+/**
+ * @brief 生成下一个 64 位 ID
+ */
+Id64 NextId64();
+
+/**
+ * @brief 从 ID 中取出生成时的毫秒时间戳（Unix epoch）
+ */
+TimestampMs Id64TimestampMs(Id64 id);
+
+/**
+ * @brief 固定 13 位 Crockford base32 文本（大写，按字典序与数值序一致）
+ */
+std::string EncodeId64(Id64 id);
+
+/**
+ * @brief 解析 EncodeId64 的文本（大小写不敏感，I/L 视为 1、O 视为 0）
+ */
+bool DecodeId64(const std::string& text, Id64* out);
+
+/**
+ * @brief 生成对外使用的字符串 ID："<prefix>-<13 位 base32>"
+ *
+ * @note 定长、按时间有序；可用 ParseGeneratedId 取回 64 位值（用于 SQLite INTEGER 列）。
  */
 std::string GenerateId(const char* prefix);
 
-} // namespace my_data
\ No newline at end of file
+/**
+ * @brief 解析 GenerateId 生成的字符串（取最后一个 '-' 之后的部分）；非本生成器的 ID 返回 false
+ */
+bool ParseGeneratedId(const std::string& id, Id64* out);
+
+} // namespace my_data
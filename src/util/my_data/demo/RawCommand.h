@@ -18,7 +18,7 @@ struct RawCommand {
   nlohmann::json payload = nlohmann::json::object();
   TimestampMs received_at_ms{0};
 
-  // 幂等（预留，不启用）
+  // 幂等：为空时 Normalizer 用 command_id 作为 key；dedup_window_ms=0 时使用 Edge 默认窗口
   std::string idempotency_key{};
   std::int64_t dedup_window_ms{0};
 
@@ -0,0 +1,125 @@
+#include "Symbol.h"
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace my_data {
+
+namespace {
+
+/**
+ * @brief 全局驻留表
+ *
+ * @details
+ * - id -> 字符串：分块数组，块一旦分配不再移动，读路径无锁
+ * - 字符串 -> id：读写锁保护的哈希表，命中走共享锁
+ */
+class SymbolTable {
+public:
+  static constexpr std::size_t kChunkBits = 12;
+  static constexpr std::size_t kChunkSize = std::size_t(1) << kChunkBits;
+  static constexpr std::size_t kMaxChunks = Symbol::kMaxInterned / kChunkSize;
+  static_assert(Symbol::kMaxInterned % kChunkSize == 0, "kMaxInterned must be a multiple of the chunk size");
+
+  static SymbolTable& Instance() {
+    static SymbolTable* table = new SymbolTable();  // 不析构：静态对象析构期间仍可能有日志引用符号
+    return *table;
+  }
+
+  // 表满时返回 Symbol::kOwnedId，由调用方自持字符串
+  Symbol::Id Intern(std::string_view s) {
+    if (s.empty()) return 0;
+    {
+      std::shared_lock<std::shared_mutex> lk(mu_);
+      auto it = index_.find(s);
+      if (it != index_.end()) return it->second;
+    }
+
+    std::unique_lock<std::shared_mutex> lk(mu_);
+    auto it = index_.find(s);
+    if (it != index_.end()) return it->second;
+
+    const std::size_t id = count_.load(std::memory_order_relaxed);
+    const std::size_t chunk = id >> kChunkBits;
+    if (chunk >= kMaxChunks) {
+      owned_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+      return Symbol::kOwnedId;
+    }
+    if (!chunks_[chunk].load(std::memory_order_relaxed)) {
+      chunks_[chunk].store(new std::string[kChunkSize], std::memory_order_release);
+    }
+    std::string& slot = chunks_[chunk].load(std::memory_order_relaxed)[id & (kChunkSize - 1)];
+    slot.assign(s.data(), s.size());
+    index_.emplace(std::string_view(slot), static_cast<Symbol::Id>(id));
+    count_.store(id + 1, std::memory_order_release);
+    return static_cast<Symbol::Id>(id);
+  }
+
+  const std::string& Get(Symbol::Id id) const {
+    // id 来自 Intern 的返回值，槽位写入先于 id 对外可见
+    return chunks_[id >> kChunkBits].load(std::memory_order_acquire)[id & (kChunkSize - 1)];
+  }
+
+  std::size_t Count() const { return count_.load(std::memory_order_acquire); }
+  std::uint64_t OwnedFallbacks() const { return owned_fallbacks_.load(std::memory_order_relaxed); }
+
+private:
+  SymbolTable() {
+    chunks_[0].store(new std::string[kChunkSize], std::memory_order_release);  // id 0 = ""
+    count_.store(1, std::memory_order_release);
+  }
+
+  std::shared_mutex mu_;
+  std::unordered_map<std::string_view, Symbol::Id> index_;
+  std::array<std::atomic<std::string*>, kMaxChunks> chunks_{};
+  std::atomic<std::size_t> count_{0};
+  std::atomic<std::uint64_t> owned_fallbacks_{0};
+};
+
+} // namespace
+
+Symbol::Symbol(const std::string& s) {
+  Assign(s.data(), s.size());
+}
+
+Symbol::Symbol(const char* s) {
+  if (s) Assign(s, std::strlen(s));
+}
+
+void Symbol::Assign(const char* data, std::size_t size) {
+  id_ = SymbolTable::Instance().Intern(std::string_view(data, size));
+  if (id_ == kOwnedId) {
+    owned_ = std::make_shared<const std::string>(data, size);
+  }
+}
+
+const std::string& Symbol::str() const {
+  return owned_ ? *owned_ : SymbolTable::Instance().Get(id_);
+}
+
+std::size_t Symbol::InternedCount() {
+  return SymbolTable::Instance().Count();
+}
+
+std::uint64_t Symbol::OwnedFallbackCount() {
+  return SymbolTable::Instance().OwnedFallbacks();
+}
+
+std::ostream& operator<<(std::ostream& os, const Symbol& s) {
+  return os << s.str();
+}
+
+void to_json(nlohmann::json& j, const Symbol& s) {
+  j = s.str();
+}
+
+void from_json(const nlohmann::json& j, Symbol& s) {
+  s = j.is_string() ? Symbol(j.get_ref<const std::string&>()) : Symbol();
+}
+
+} // namespace my_data
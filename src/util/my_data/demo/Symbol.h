@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include <nlohmann/json.hpp>
+#include <spdlog/fmt/fmt.h>
+
+namespace my_data {
+
+/**
+ * @brief 驻留字符串（interned string）：32 位句柄
+ *
+ * @details
+ * - 用于低基数标识（edge_id / device_id / capability / action），同一字符串全局只存一份，
+ *   Task 拷贝/比较只涉及 32 位句柄
+ * - 驻留表只增不删，容量有上限（kMaxInterned）；这些字段可能来自外部命令，
+ *   表满之后新出现的字符串不再驻留，改由 Symbol 自持一份（id() == kOwnedId），行为不变，只是失去句柄比较的优势
+ * - 同一字符串要么始终驻留、要么始终自持（表满后不再增长），因此相等与哈希保持一致
+ * - 可隐式转换为 const std::string&，与现有按字符串使用的代码兼容
+ */
+class Symbol {
+public:
+  using Id = std::uint32_t;
+
+  static constexpr std::size_t kMaxInterned = std::size_t(1) << 16;  // 驻留表容量（含空字符串）
+  static constexpr Id kOwnedId = 0xFFFFFFFFu;                        // 未驻留（自持字符串）时的 id
+
+  Symbol() = default;  // 空字符串，id=0
+  Symbol(const std::string& s);
+  Symbol(const char* s);
+
+  Id id() const { return id_; }
+  bool interned() const { return id_ != kOwnedId; }
+  const std::string& str() const;
+  operator const std::string&() const { return str(); }
+
+  bool empty() const { return id_ == 0; }
+  std::size_t size() const { return str().size(); }
+  const char* c_str() const { return str().c_str(); }
+
+  friend bool operator==(const Symbol& a, const Symbol& b) {
+    return (a.interned() && b.interned()) ? a.id_ == b.id_ : a.str() == b.str();
+  }
+  friend bool operator!=(const Symbol& a, const Symbol& b) { return !(a == b); }
+  friend bool operator==(const Symbol& a, const std::string& b) { return a.str() == b; }
+  friend bool operator==(const std::string& a, const Symbol& b) { return a == b.str(); }
+  friend bool operator!=(const Symbol& a, const std::string& b) { return a.str() != b; }
+  friend bool operator!=(const std::string& a, const Symbol& b) { return a != b.str(); }
+  friend bool operator==(const Symbol& a, const char* b) { return a.str() == b; }
+  friend bool operator==(const char* a, const Symbol& b) { return b.str() == a; }
+  friend bool operator!=(const Symbol& a, const char* b) { return a.str() != b; }
+  friend bool operator!=(const char* a, const Symbol& b) { return b.str() != a; }
+  friend bool operator<(const Symbol& a, const Symbol& b) { return a.str() < b.str(); }
+
+  friend std::string operator+(const std::string& a, const Symbol& b) { return a + b.str(); }
+  friend std::string operator+(const Symbol& a, const std::string& b) { return a.str() + b; }
+  friend std::string operator+(const char* a, const Symbol& b) { return a + b.str(); }
+  friend std::string operator+(const Symbol& a, const char* b) { return a.str() + b; }
+
+  /**
+   * @brief 已驻留的字符串数量（含空字符串）
+   */
+  static std::size_t InternedCount();
+
+  /**
+   * @brief 因驻留表已满而改为自持的次数
+   */
+  static std::uint64_t OwnedFallbackCount();
+
+private:
+  void Assign(const char* data, std::size_t size);
+
+  Id id_{0};
+  std::shared_ptr<const std::string> owned_;  // 仅 id_ == kOwnedId 时非空
+};
+
+std::ostream& operator<<(std::ostream& os, const Symbol& s);
+
+void to_json(nlohmann::json& j, const Symbol& s);
+void from_json(const nlohmann::json& j, Symbol& s);
+
+} // namespace my_data
+
+namespace std {
+template <>
+struct hash<my_data::Symbol> {
+  std::size_t operator()(const my_data::Symbol& s) const noexcept {
+    return s.interned() ? std::hash<std::uint32_t>()(s.id()) : std::hash<std::string>()(s.str());
+  }
+};
+} // namespace std
+
+template <>
+struct fmt::formatter<my_data::Symbol> : fmt::formatter<fmt::string_view> {
+  template <typename FormatContext>
+  auto format(const my_data::Symbol& s, FormatContext& ctx) const -> decltype(ctx.out()) {
+    return fmt::formatter<fmt::string_view>::format(fmt::string_view(s.str()), ctx);
+  }
+};
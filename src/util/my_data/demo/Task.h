@@ -1,5 +1,7 @@
 #pragma once
+#include "Symbol.h"
 #include "TaskResult.h"
+#include "TaskTrace.h"
 #include "Types.h"
 #include <nlohmann/json.hpp>
 #include <string>
@@ -23,6 +25,8 @@ enum class TaskState {
  * @details
  * - 数据类中包含“幂等字段”，但 MVP 阶段不启用去重逻辑。
  * - params/output/policy 统一使用 nlohmann::json，初始化/扩展方便。
+ * - edge_id/device_id/capability/action 取值有限，用 Symbol（32 位驻留句柄）保存，拷贝与比较不涉及字符串。
+ * - 入队路径（Submit -> TaskQueue -> Workflow）按值移动传递，一个 Task 只构造一次。
  */
 struct Task {
   // 身份：全局唯一的任务标识与来源命令 ID
@@ -33,25 +37,27 @@ struct Task {
 
   // 追踪信息（可选，用于分布式追踪/链路分析）
   // - `trace_id`：分布式追踪的跟踪 ID
-  // - `span_id`：当前任务在 trace 中的 span 标识
+  // - `span_id`：当前任务在 trace 中的 span 标识（Edge 收到命令时补全 trace_id/span_id）
+  // - `trace`：生命周期时间戳（进程内单调时钟，不序列化），由 TaskTracer 聚合
   std::string trace_id{};
   std::string span_id{};
+  TaskTrace trace{};
 
   // 路由信息：任务应被投递到哪个 Edge/Device
   // - `edge_id`：目标边缘节点 ID（通常由客户端指定或路由器填充）
   // - `device_id`：目标设备 ID（任务最终执行的设备标识）
-  EdgeId edge_id{};
-  DeviceId device_id{};
+  Symbol edge_id{};
+  Symbol device_id{};
 
   // 能力与动作：描述要执行的功能和操作
   // - `capability`：能力域或模块名称（如 camera、motion）
   // - `action`：具体动作名称（如 capture、move_to）
   // - `params`：动作参数，以 JSON 表示，方便扩展任意结构
-  std::string capability{};
-  std::string action{};
+  Symbol capability{};
+  Symbol action{};
   nlohmann::json params = nlohmann::json::object();
 
-  // 幂等与去重（预留字段，MVP 阶段未启用去重逻辑）
+  // 幂等与去重（BaseEdge::Submit 在窗口内按 key 去重，重复提交返回首次 SubmitResult）
   // - `idempotency_key`：用于幂等判定的 key（来自客户端或网关）
   // - `dedup_window_ms`：去重时间窗口（毫秒），表示在该窗口内基于 key 判定重复
   std::string idempotency_key{};
@@ -66,7 +72,7 @@ struct Task {
    * @brief 任务优先级，数值越大优先级越高
    * 默认值为 0，表示普通优先级。
    * 1: 高优先级任务，执行后即清空 self_task 成员变量，避免重复执行（一次性任务）。
-   * 0: 普通优先级任务，执行后保留 self_task 成员
+   * 0: 普通优先级任务；self task 若 policy.repeat_interval_ms > 0，则执行完成后按该间隔定时重跑（周期任务）
    */
   int priority{0};
   TimestampMs created_at_ms{0};
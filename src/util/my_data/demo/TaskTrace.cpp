@@ -0,0 +1,80 @@
+#include "TaskTrace.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace my_data {
+
+namespace {
+
+void PutSpan(nlohmann::json& j, const char* name, std::int64_t from_us, std::int64_t to_us) {
+  if (from_us > 0 && to_us >= from_us) j[name] = to_us - from_us;
+}
+
+} // namespace
+
+nlohmann::json TaskTrace::toJson() const {
+  nlohmann::json j = nlohmann::json::object();
+  PutSpan(j, "normalize_us", received_us, normalized_us);
+  PutSpan(j, "queue_wait_us", enqueued_us, dequeued_us);
+  PutSpan(j, "exec_us", exec_start_us, exec_finish_us);
+  PutSpan(j, "end_to_end_us", received_us > 0 ? received_us : enqueued_us, exec_finish_us);
+  return j;
+}
+
+int LatencyHistogram::BucketOf(std::int64_t us) {
+  if (us <= 0) return 0;
+  int b = 0;
+  auto v = static_cast<std::uint64_t>(us);
+  while (v != 0) {
+    ++b;
+    v >>= 1;
+  }
+  return std::min(b, kBuckets - 1);
+}
+
+std::int64_t LatencyHistogram::BucketUpperUs(int bucket) {
+  if (bucket <= 0) return 0;
+  return (std::int64_t{1} << bucket) - 1;
+}
+
+void LatencyHistogram::Record(std::int64_t us) {
+  if (us < 0) us = 0;
+  ++buckets_[BucketOf(us)];
+  if (count_ == 0 || us < min_us_) min_us_ = us;
+  if (us > max_us_) max_us_ = us;
+  ++count_;
+  sum_us_ += us;
+}
+
+std::int64_t LatencyHistogram::PercentileUs(double q) const {
+  if (count_ == 0) return 0;
+  q = std::clamp(q, 0.0, 1.0);
+  const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(q * count_)));
+  std::uint64_t seen = 0;
+  for (int i = 0; i < kBuckets; ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) return std::clamp(BucketUpperUs(i), min_us_, max_us_);
+  }
+  return max_us_;
+}
+
+nlohmann::json LatencyHistogram::ToJson() const {
+  nlohmann::json buckets = nlohmann::json::array();
+  for (int i = 0; i < kBuckets; ++i) {
+    if (buckets_[i] == 0) continue;
+    buckets.push_back({{"le_us", BucketUpperUs(i)}, {"count", buckets_[i]}});
+  }
+  return nlohmann::json{
+      {"count", count_},
+      {"avg_us", count_ ? sum_us_ / static_cast<std::int64_t>(count_) : 0},
+      {"min_us", min_us_},
+      {"max_us", max_us_},
+      {"p50_us", PercentileUs(0.50)},
+      {"p90_us", PercentileUs(0.90)},
+      {"p99_us", PercentileUs(0.99)},
+      {"buckets", std::move(buckets)},
+  };
+}
+
+} // namespace my_data
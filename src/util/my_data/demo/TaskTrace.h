@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+namespace my_data {
+
+/**
+ * @brief 任务生命周期时间戳（单调时钟微秒，见 MonoUs）
+ *
+ * @details
+ * - received：Edge 收到命令；normalized：Normalize 完成；enqueued：进入 TaskQueue
+ * - dequeued：Workflow 取出；exec_start/exec_finish：IControl 执行前后
+ * - 0 表示该阶段未经过（如自任务不经 Submit、日志回放的任务没有 received）
+ * - 仅在本进程内有意义，不参与 Task 的 JSON 序列化
+ */
+struct TaskTrace {
+  std::int64_t received_us{0};
+  std::int64_t normalized_us{0};
+  std::int64_t enqueued_us{0};
+  std::int64_t dequeued_us{0};
+  std::int64_t exec_start_us{0};
+  std::int64_t exec_finish_us{0};
+
+  /**
+   * @brief 各阶段耗时（微秒）；缺失的阶段不输出
+   */
+  nlohmann::json toJson() const;
+};
+
+/**
+ * @brief 延迟直方图（对数分桶，单位微秒）
+ *
+ * @details
+ * - 第 i 个桶覆盖 [2^(i-1), 2^i) 微秒（桶 0 只含 0），最后一个桶兜底（约 1000 秒以上）
+ * - 分位数取所在桶的上界，并以观测到的最大值封顶：误差不超过 2 倍，足够用来判断瓶颈所在阶段
+ * - 非线程安全，由持有者加锁
+ */
+class LatencyHistogram {
+public:
+  static constexpr int kBuckets = 32;
+
+  void Record(std::int64_t us);
+
+  std::uint64_t Count() const { return count_; }
+  std::int64_t MaxUs() const { return max_us_; }
+
+  /**
+   * @brief 分位数估计（q 取 0~1）；无样本时返回 0
+   */
+  std::int64_t PercentileUs(double q) const;
+
+  nlohmann::json ToJson() const;
+
+private:
+  static int BucketOf(std::int64_t us);
+  static std::int64_t BucketUpperUs(int bucket);
+
+  std::array<std::uint64_t, kBuckets> buckets_{};
+  std::uint64_t count_{0};
+  std::int64_t sum_us_{0};
+  std::int64_t min_us_{0};
+  std::int64_t max_us_{0};
+};
+
+} // namespace my_data
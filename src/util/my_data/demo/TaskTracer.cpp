@@ -0,0 +1,184 @@
+#include "TaskTracer.h"
+
+#include <map>
+#include <tuple>
+
+#include "TimeUtil.h"
+
+namespace my_data {
+
+namespace {
+
+// 每写这么多条事件 flush 一次，兼顾落盘及时性与写放大
+constexpr std::uint64_t kChromeFlushEvery = 64;
+
+void RecordSpan(LatencyHistogram& h, std::int64_t from_us, std::int64_t to_us) {
+  if (from_us > 0 && to_us >= from_us) h.Record(to_us - from_us);
+}
+
+} // namespace
+
+TaskTracer& TaskTracer::GetInstance() {
+  static TaskTracer instance;
+  return instance;
+}
+
+TaskTracer::~TaskTracer() {
+  CloseChromeTrace();
+}
+
+bool TaskTracer::OpenChromeTrace(const std::string& path, std::string* err) {
+  CloseChromeTrace();
+
+  std::lock_guard<std::mutex> lk(mu_);
+  chrome_out_.open(path, std::ios::out | std::ios::trunc);
+  if (!chrome_out_.is_open()) {
+    if (err) *err = "open chrome trace file failed: " + path;
+    return false;
+  }
+  chrome_path_ = path;
+  chrome_pids_.clear();
+  chrome_tids_.clear();
+  chrome_events_ = 0;
+  // JSON Array 格式：进程异常退出时缺少结尾 "]" 也能被 chrome://tracing / Perfetto 正常加载
+  chrome_out_ << "[\n";
+  chrome_out_.flush();
+  return true;
+}
+
+void TaskTracer::CloseChromeTrace() {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (!chrome_out_.is_open()) return;
+  // 结尾事件不带逗号，使文件成为合法 JSON
+  chrome_out_ << nlohmann::json{{"name", "trace_end"}, {"ph", "i"}, {"s", "g"}, {"ts", MonoUs()},
+                                {"pid", 0}, {"tid", 0}}.dump()
+              << "\n]\n";
+  chrome_out_.close();
+  chrome_path_.clear();
+}
+
+void TaskTracer::Record(const Task& task, const TaskResult& result) {
+  if (!Enabled()) return;
+
+  const TaskTrace& t = task.trace;
+  const Key key{task.edge_id, task.device_id, task.capability, task.action};
+
+  std::lock_guard<std::mutex> lk(mu_);
+  Entry& e = EntryLocked(key);
+  RecordSpan(e.normalize, t.received_us, t.normalized_us);
+  RecordSpan(e.queue_wait, t.enqueued_us, t.dequeued_us);
+  RecordSpan(e.exec, t.exec_start_us, t.exec_finish_us);
+  RecordSpan(e.end_to_end, t.received_us > 0 ? t.received_us : t.enqueued_us, t.exec_finish_us);
+  if (result.code == ErrorCode::Ok) {
+    ++e.ok;
+  } else {
+    ++e.failed;
+  }
+
+  if (chrome_out_.is_open()) WriteChromeEventsLocked(task, result);
+}
+
+TaskTracer::Entry& TaskTracer::EntryLocked(const Key& key) {
+  auto it = entries_.find(key);
+  if (it != entries_.end()) return it->second;
+  if (entries_.size() + 1 < kMaxEntries) return entries_[key];
+
+  // 条目已满：新键不再单独聚合，避免外部命令中的任意取值无限占用内存
+  ++overflowed_;
+  static const Key kOverflowKey{Symbol(), Symbol(), Symbol(), Symbol("<overflow>")};
+  return entries_[kOverflowKey];
+}
+
+nlohmann::json TaskTracer::Snapshot(const std::string& edge_id) const {
+  // 按字符串排序输出，便于对比多次查询结果
+  std::map<std::tuple<std::string, std::string, std::string, std::string>, nlohmann::json> sorted;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    for (const auto& [k, e] : entries_) {
+      if (!edge_id.empty() && k.edge_id != edge_id) continue;
+      sorted.emplace(std::make_tuple(k.edge_id.str(), k.device_id.str(), k.capability.str(), k.action.str()),
+                     nlohmann::json{
+                         {"ok", e.ok},
+                         {"failed", e.failed},
+                         {"normalize", e.normalize.ToJson()},
+                         {"queue_wait", e.queue_wait.ToJson()},
+                         {"exec", e.exec.ToJson()},
+                         {"end_to_end", e.end_to_end.ToJson()},
+                     });
+    }
+  }
+
+  nlohmann::json items = nlohmann::json::array();
+  for (auto& [k, j] : sorted) {
+    j["edge_id"] = std::get<0>(k);
+    j["device_id"] = std::get<1>(k);
+    j["capability"] = std::get<2>(k);
+    j["action"] = std::get<3>(k);
+    items.push_back(std::move(j));
+  }
+
+  std::lock_guard<std::mutex> lk(mu_);
+  return nlohmann::json{
+      {"enabled", Enabled()},
+      {"chrome_trace_file", chrome_path_},
+      {"overflowed", overflowed_},
+      {"items", std::move(items)},
+  };
+}
+
+void TaskTracer::Reset() {
+  std::lock_guard<std::mutex> lk(mu_);
+  entries_.clear();
+  overflowed_ = 0;
+}
+
+int TaskTracer::ChromePidLocked(const Symbol& edge_id) {
+  if (chrome_pids_.size() >= kMaxChromeThreads && !chrome_pids_.count(edge_id)) {
+    return static_cast<int>(kMaxChromeThreads);
+  }
+  auto [it, inserted] = chrome_pids_.try_emplace(edge_id, static_cast<int>(chrome_pids_.size()) + 1);
+  if (inserted) {
+    WriteChromeLineLocked({{"name", "process_name"}, {"ph", "M"}, {"pid", it->second}, {"tid", 0},
+                           {"args", {{"name", "edge:" + edge_id.str()}}}});
+  }
+  return it->second;
+}
+
+int TaskTracer::ChromeTidLocked(const Symbol& device_id, int pid) {
+  if (chrome_tids_.size() >= kMaxChromeThreads && !chrome_tids_.count(device_id)) {
+    return static_cast<int>(kMaxChromeThreads);
+  }
+  auto [it, inserted] = chrome_tids_.try_emplace(device_id, static_cast<int>(chrome_tids_.size()) + 1);
+  if (inserted) {
+    WriteChromeLineLocked({{"name", "thread_name"}, {"ph", "M"}, {"pid", pid}, {"tid", it->second},
+                           {"args", {{"name", "device:" + device_id.str()}}}});
+  }
+  return it->second;
+}
+
+void TaskTracer::WriteChromeLineLocked(const nlohmann::json& event) {
+  chrome_out_ << event.dump() << ",\n";
+  if (++chrome_events_ % kChromeFlushEvery == 0) chrome_out_.flush();
+}
+
+void TaskTracer::WriteChromeEventsLocked(const Task& task, const TaskResult& result) {
+  const TaskTrace& t = task.trace;
+  const int pid = ChromePidLocked(task.edge_id);
+  const int tid = ChromeTidLocked(task.device_id, pid);
+
+  auto span = [&](const std::string& name, std::int64_t from_us, std::int64_t to_us, nlohmann::json args) {
+    if (from_us <= 0 || to_us < from_us) return;
+    WriteChromeLineLocked({{"name", name}, {"cat", "task"}, {"ph", "X"}, {"ts", from_us},
+                           {"dur", to_us - from_us}, {"pid", pid}, {"tid", tid}, {"args", std::move(args)}});
+  };
+
+  const nlohmann::json ids{{"task_id", task.task_id}, {"trace_id", task.trace_id}, {"span_id", task.span_id}};
+  span("normalize", t.received_us, t.normalized_us, ids);
+  span("queue_wait", t.enqueued_us, t.dequeued_us, ids);
+
+  nlohmann::json exec_args = ids;
+  exec_args["code"] = ToString(result.code);
+  span(task.capability.str() + "." + task.action.str(), t.exec_start_us, t.exec_finish_us, std::move(exec_args));
+}
+
+} // namespace my_data
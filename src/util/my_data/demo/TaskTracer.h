@@ -0,0 +1,120 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <unordered_map>
+
+#include "Symbol.h"
+#include "Task.h"
+#include "TaskResult.h"
+#include "TaskTrace.h"
+
+namespace my_data {
+
+/**
+ * @brief 任务生命周期追踪：按 (edge_id, device_id, capability, action) 聚合各阶段延迟
+ *
+ * @details
+ * - Workflow 在任务收尾时调用 Record；各阶段时间戳见 TaskTrace
+ * - 聚合三段直方图：queue_wait（入队 -> 出队）、exec（执行开始 -> 结束）、end_to_end（收到 -> 执行结束），
+ *   另有 normalize（收到 -> Normalize 完成）
+ * - 可选写 Chrome trace 文件（JSON Array 格式，chrome://tracing / Perfetto 直接打开）：
+ *   pid 对应 edge，tid 对应 device，每个任务输出 normalize / queue_wait / 执行 三个区间
+ * - 进程级单例；Record 一次加锁 + 一次哈希查找
+ * - 聚合键可能来自外部命令，条目数上限 kMaxEntries；超出后新键统一计入 action="<overflow>" 的条目
+ */
+class TaskTracer {
+public:
+  static constexpr std::size_t kMaxEntries = 4096;      // 聚合条目上限（含 overflow 条目）
+  static constexpr std::size_t kMaxChromeThreads = 1024; // Chrome trace 中 pid/tid 上限，超出后共用最后一个
+
+  static TaskTracer& GetInstance();
+
+  TaskTracer() = default;
+  ~TaskTracer();
+
+  TaskTracer(const TaskTracer&) = delete;
+  TaskTracer& operator=(const TaskTracer&) = delete;
+
+  /**
+   * @brief 开关聚合（默认开启）；关闭后 Record 直接返回
+   */
+  void SetEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+  bool Enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 打开 Chrome trace 输出文件（覆盖写）；已打开时先关闭旧文件
+   */
+  bool OpenChromeTrace(const std::string& path, std::string* err);
+
+  /**
+   * @brief 写入结尾并关闭文件（未打开时无操作）
+   */
+  void CloseChromeTrace();
+
+  void Record(const Task& task, const TaskResult& result);
+
+  /**
+   * @brief 聚合结果；edge_id 非空时只返回该 Edge 的条目
+   */
+  nlohmann::json Snapshot(const std::string& edge_id = "") const;
+
+  void Reset();
+
+private:
+  struct Key {
+    Symbol edge_id{};
+    Symbol device_id{};
+    Symbol capability{};
+    Symbol action{};
+
+    friend bool operator==(const Key& a, const Key& b) {
+      return a.edge_id == b.edge_id && a.device_id == b.device_id && a.capability == b.capability &&
+             a.action == b.action;
+    }
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key& k) const noexcept {
+      std::size_t h = std::hash<Symbol>()(k.edge_id);
+      h = h * 31 + std::hash<Symbol>()(k.device_id);
+      h = h * 31 + std::hash<Symbol>()(k.capability);
+      h = h * 31 + std::hash<Symbol>()(k.action);
+      return h;
+    }
+  };
+
+  struct Entry {
+    LatencyHistogram normalize;
+    LatencyHistogram queue_wait;
+    LatencyHistogram exec;
+    LatencyHistogram end_to_end;
+    std::uint64_t ok{0};
+    std::uint64_t failed{0};
+  };
+
+  void WriteChromeEventsLocked(const Task& task, const TaskResult& result);
+  Entry& EntryLocked(const Key& key);
+  int ChromePidLocked(const Symbol& edge_id);
+  int ChromeTidLocked(const Symbol& device_id, int pid);
+  void WriteChromeLineLocked(const nlohmann::json& event);
+
+private:
+  std::atomic<bool> enabled_{true};
+
+  mutable std::mutex mu_;
+  std::unordered_map<Key, Entry, KeyHash> entries_;
+  std::uint64_t overflowed_{0};  // 因条目已满而计入 overflow 条目的记录数
+
+  // Chrome trace 输出（mu_ 保护）
+  std::ofstream chrome_out_;
+  std::string chrome_path_;
+  std::unordered_map<Symbol, int> chrome_pids_;  // edge_id -> pid
+  std::unordered_map<Symbol, int> chrome_tids_;  // device_id -> tid
+  std::uint64_t chrome_events_{0};
+};
+
+} // namespace my_data
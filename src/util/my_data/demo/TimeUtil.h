@@ -9,4 +9,9 @@ namespace my_data {
  */
 TimestampMs NowMs();
 
+/**
+ * @brief 单调时钟微秒数（steady_clock），只用于计算同一进程内的时间间隔
+ */
+std::int64_t MonoUs();
+
 } // namespace my_data
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace my_data {
+
+/**
+ * @brief 带版本号的不可变快照（写方整体替换，读方无锁取 shared_ptr）
+ *
+ * @details
+ * - Publish 构造一份新的只读对象并原子替换指针，随后递增版本号
+ * - Load 返回当前对象的 shared_ptr<const T>；读方持有期间写方再发布也不影响其内容
+ * - Version 从 1 开始（构造时发布一份默认值），调用方可据此判断“自上次读取后是否变化”
+ * - 多个写方需由调用方自行串行化（通常已在各自的状态锁内）
+ */
+template <typename T>
+class VersionedSnapshot {
+public:
+  VersionedSnapshot() : ptr_(std::make_shared<const T>()) {}
+
+  void Publish(T value) {
+    std::atomic_store_explicit(&ptr_, std::shared_ptr<const T>(std::make_shared<const T>(std::move(value))),
+                               std::memory_order_release);
+    version_.fetch_add(1, std::memory_order_release);
+  }
+
+  std::shared_ptr<const T> Load() const {
+    return std::atomic_load_explicit(&ptr_, std::memory_order_acquire);
+  }
+
+  std::uint64_t Version() const { return version_.load(std::memory_order_acquire); }
+
+private:
+  std::shared_ptr<const T> ptr_;
+  std::atomic<std::uint64_t> version_{1};
+};
+
+} // namespace my_data
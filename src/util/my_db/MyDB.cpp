@@ -1,5 +1,6 @@
 #include "MyDB.h"
 
+#include <chrono>
 #include <filesystem>
 #include <sstream>
 
@@ -20,9 +21,24 @@ DBConfig DBConfig::FromJson(const nlohmann::json& j) {
   c.synchronous = j.value("synchronous", c.synchronous);
 
   c.auto_migrate = j.value("auto_migrate", c.auto_migrate);
+  c.statement_cache_size = j.value("statement_cache_size", c.statement_cache_size);
+  c.read_pool_size = j.value("read_pool_size", c.read_pool_size);
 
   c.status_snapshot_enable = j.value("status_snapshot_enable", c.status_snapshot_enable);
   c.status_snapshot_interval_ms = j.value("status_snapshot_interval_ms", c.status_snapshot_interval_ms);
+  c.snapshot_batch_max_rows = j.value("snapshot_batch_max_rows", c.snapshot_batch_max_rows);
+  c.snapshot_batch_interval_ms = j.value("snapshot_batch_interval_ms", c.snapshot_batch_interval_ms);
+  c.snapshot_queue_capacity = j.value("snapshot_queue_capacity", c.snapshot_queue_capacity);
+
+  c.snapshot_retention_enable = j.value("snapshot_retention_enable", c.snapshot_retention_enable);
+  c.snapshot_raw_retention_hours = j.value("snapshot_raw_retention_hours", c.snapshot_raw_retention_hours);
+  c.snapshot_minute_rollup_retention_days =
+      j.value("snapshot_minute_rollup_retention_days", c.snapshot_minute_rollup_retention_days);
+  c.snapshot_hour_rollup_retention_days =
+      j.value("snapshot_hour_rollup_retention_days", c.snapshot_hour_rollup_retention_days);
+  c.snapshot_retention_interval_ms = j.value("snapshot_retention_interval_ms", c.snapshot_retention_interval_ms);
+  c.snapshot_retention_delete_batch = j.value("snapshot_retention_delete_batch", c.snapshot_retention_delete_batch);
+  c.snapshot_vacuum_pages = j.value("snapshot_vacuum_pages", c.snapshot_vacuum_pages);
 
   return c;
 }
@@ -46,6 +62,11 @@ std::string MyDB::Path() const {
   return cfg_.path;
 }
 
+DBConfig MyDB::Config() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return cfg_;
+}
+
 bool MyDB::EnsureParentDirExists(const std::string& path, std::string* err) {
   try {
     std::filesystem::path p(path);
@@ -119,12 +140,33 @@ bool MyDB::Init(const DBConfig& cfg, std::string* err) {
     return false;
   }
 
+  stmt_cache_ = std::make_unique<StatementCache>(
+      static_cast<std::size_t>(cfg_.statement_cache_size > 0 ? cfg_.statement_cache_size : 0));
+
+  // 只读连接池：依赖 WAL 才能与写事务并发；打开失败不影响主连接，读路径回退到写连接
+  if (cfg_.read_pool_size > 0 && cfg_.wal && cfg_.path != ":memory:") {
+    auto pool = std::make_shared<ReadPool>(
+        cfg_.path, static_cast<std::size_t>(cfg_.read_pool_size), cfg_.busy_timeout_ms,
+        static_cast<std::size_t>(cfg_.statement_cache_size > 0 ? cfg_.statement_cache_size : 0));
+    std::string pool_err;
+    if (pool->Open(&pool_err)) {
+      std::lock_guard<std::mutex> rlk(read_mu_);
+      read_pool_ = std::move(pool);
+    } else {
+      MYLOG_WARN("[MyDB] Read pool disabled: {}", pool_err);
+    }
+  }
+
   initialized_ = true;
-  MYLOG_INFO("[MyDB] Init success: path={}", cfg_.path);
+  MYLOG_INFO("[MyDB] Init success: path={}, statement_cache_size={}, read_pool_size={}",
+             cfg_.path, cfg_.statement_cache_size, ReadStats().size);
   return true;
 }
 
 bool MyDB::ApplyPragmasLocked(std::string* err) {
+  // 仅对新建库生效（须在建表前设置）；已有库需显式调用 ConvertToIncrementalVacuum 转换
+  if (!ExecLocked("PRAGMA auto_vacuum=INCREMENTAL;", err)) return false;
+
   if (cfg_.wal) {
     if (!ExecLocked("PRAGMA journal_mode=WAL;", err)) return false;
   } else {
@@ -181,6 +223,47 @@ bool MyDB::Transaction(const std::function<bool(std::string* err)>& fn, std::str
   return TransactionLocked(fn, err);
 }
 
+StatementHandle MyDB::Prepare(const std::string& sql, std::string* err) {
+  if (!initialized_ || !db_ || !stmt_cache_) {
+    if (err) *err = "db not initialized";
+    return StatementHandle();
+  }
+  return stmt_cache_->Acquire(db_, sql, err);
+}
+
+StatementCacheStats MyDB::StatementStats() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return stmt_cache_ ? stmt_cache_->Stats() : StatementCacheStats{};
+}
+
+ReadLease MyDB::AcquireReader(std::string* err) {
+  // read_pool_ 由 read_mu_ 保护：写事务持有 mu_ 期间读路径仍可取连接
+  std::shared_ptr<ReadPool> pool;
+  {
+    std::lock_guard<std::mutex> rlk(read_mu_);
+    pool = read_pool_;
+  }
+  if (pool) {
+    return pool->Acquire(err);
+  }
+
+  std::unique_lock<std::mutex> lk(mu_);
+  if (!initialized_ || !db_) {
+    if (err) *err = "db not initialized";
+    return ReadLease();
+  }
+  ReadLease lease;
+  lease.writer_db_ = db_;
+  lease.writer_stmts_ = stmt_cache_.get();
+  lease.writer_lock_ = std::move(lk);
+  return lease;
+}
+
+ReadPoolStats MyDB::ReadStats() const {
+  std::lock_guard<std::mutex> lk(read_mu_);
+  return read_pool_ ? read_pool_->Stats() : ReadPoolStats{};
+}
+
 bool MyDB::TransactionLocked(const std::function<bool(std::string* err)>& fn, std::string* err) {
   std::string e1;
   if (!ExecLocked("BEGIN IMMEDIATE;", &e1)) {
@@ -233,6 +316,8 @@ bool MyDB::Migrate(std::string* err) {
 
   if (!ExecLocked("CREATE TABLE IF NOT EXISTS schema_version (version INTEGER NOT NULL);", err)) return false;
 
+  if (cfg_.snapshot_retention_enable) CheckIncrementalVacuumLocked();
+
   std::string tx_err;
   bool ok = TransactionLocked([&](std::string* txe) -> bool {
     if (!ExecLocked("INSERT INTO schema_version(version) SELECT 1 WHERE NOT EXISTS (SELECT 1 FROM schema_version);", txe)) return false;
@@ -248,7 +333,8 @@ bool MyDB::Migrate(std::string* err) {
         state INTEGER,
         created_at_ms INTEGER,
         deadline_at_ms INTEGER,
-        task_json TEXT
+        task_json TEXT,
+        task_seq INTEGER
       );
     )SQL", txe)) return false;
 
@@ -288,6 +374,67 @@ bool MyDB::Migrate(std::string* err) {
     )SQL", txe)) return false;
     if (!ExecLocked("CREATE INDEX IF NOT EXISTS idx_edge_status_edge_ts ON edge_status_snapshots(edge_id, ts_ms);", txe)) return false;
 
+    // v2：保留期删除与降采样按时间扫描
+    if (!ExecLocked("CREATE INDEX IF NOT EXISTS idx_dev_status_ts ON device_status_snapshots(ts_ms);", txe)) return false;
+    if (!ExecLocked("CREATE INDEX IF NOT EXISTS idx_edge_status_ts ON edge_status_snapshots(ts_ms);", txe)) return false;
+
+    // 降采样聚合：bucket_ms = 60000（1 分钟）/ 3600000（1 小时）
+    if (!ExecLocked(R"SQL(
+      CREATE TABLE IF NOT EXISTS device_status_rollups (
+        edge_id TEXT,
+        device_id TEXT,
+        bucket_ms INTEGER,
+        bucket_start_ms INTEGER,
+        samples INTEGER,
+        online_samples INTEGER,
+        busy_samples INTEGER,
+        faulted_samples INTEGER,
+        queue_depth_max INTEGER,
+        queue_depth_avg REAL,
+        last_ts_ms INTEGER,
+        last_status_json TEXT,
+        PRIMARY KEY(device_id, bucket_ms, bucket_start_ms, edge_id)
+      );
+    )SQL", txe)) return false;
+    if (!ExecLocked("CREATE INDEX IF NOT EXISTS idx_dev_rollup_bucket ON device_status_rollups(bucket_ms, bucket_start_ms);", txe)) return false;
+
+    if (!ExecLocked(R"SQL(
+      CREATE TABLE IF NOT EXISTS edge_status_rollups (
+        edge_id TEXT,
+        bucket_ms INTEGER,
+        bucket_start_ms INTEGER,
+        samples INTEGER,
+        estop_samples INTEGER,
+        tasks_pending_max INTEGER,
+        tasks_pending_avg REAL,
+        tasks_running_max INTEGER,
+        last_ts_ms INTEGER,
+        last_status_json TEXT,
+        PRIMARY KEY(edge_id, bucket_ms, bucket_start_ms)
+      );
+    )SQL", txe)) return false;
+    if (!ExecLocked("CREATE INDEX IF NOT EXISTS idx_edge_rollup_bucket ON edge_status_rollups(bucket_ms, bucket_start_ms);", txe)) return false;
+
+    // 每个 (源表, 粒度) 已汇总到的时间点（不含）
+    if (!ExecLocked(R"SQL(
+      CREATE TABLE IF NOT EXISTS snapshot_rollup_state (
+        source TEXT,
+        bucket_ms INTEGER,
+        done_until_ms INTEGER,
+        PRIMARY KEY(source, bucket_ms)
+      );
+    )SQL", txe)) return false;
+
+    if (!ExecLocked("UPDATE schema_version SET version=2 WHERE version<2;", txe)) return false;
+
+    // v3：GenerateId 生成的 task_id 另存为 64 位整数（时间有序），整数索引比 TEXT 主键更紧凑
+    bool has_task_seq = false;
+    if (!ColumnExistsLocked("tasks", "task_seq", &has_task_seq, txe)) return false;
+    if (!has_task_seq && !ExecLocked("ALTER TABLE tasks ADD COLUMN task_seq INTEGER;", txe)) return false;
+    if (!ExecLocked("CREATE INDEX IF NOT EXISTS idx_tasks_seq ON tasks(task_seq);", txe)) return false;
+
+    if (!ExecLocked("UPDATE schema_version SET version=3 WHERE version<3;", txe)) return false;
+
     return true;
   }, &tx_err);
 
@@ -301,10 +448,87 @@ bool MyDB::Migrate(std::string* err) {
   return true;
 }
 
+bool MyDB::ColumnExistsLocked(const std::string& table, const std::string& column, bool* exists, std::string* err) {
+  *exists = false;
+  sqlite3_stmt* stmt = nullptr;
+  const std::string sql = "PRAGMA table_info(" + table + ");";
+  if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    if (err) *err = sqlite3_errmsg(db_);
+    return false;
+  }
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    const unsigned char* name = sqlite3_column_text(stmt, 1);
+    if (name && column == reinterpret_cast<const char*>(name)) {
+      *exists = true;
+      break;
+    }
+  }
+  sqlite3_finalize(stmt);
+  return true;
+}
+
+bool MyDB::QueryAutoVacuumLocked(int* mode, std::string* err) {
+  sqlite3_stmt* stmt = nullptr;
+  if (sqlite3_prepare_v2(db_, "PRAGMA auto_vacuum;", -1, &stmt, nullptr) != SQLITE_OK) {
+    if (err) *err = sqlite3_errmsg(db_);
+    return false;
+  }
+  *mode = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : 0;
+  sqlite3_finalize(stmt);
+  return true;
+}
+
+void MyDB::CheckIncrementalVacuumLocked() {
+  int mode = 0;
+  std::string err;
+  if (!QueryAutoVacuumLocked(&mode, &err)) {
+    MYLOG_WARN("[MyDB] Query auto_vacuum failed: {}", err);
+    return;
+  }
+  // 2 = INCREMENTAL；旧库（NONE）不在启动时隐式 VACUUM，只提示
+  if (mode != 2) {
+    MYLOG_WARN("[MyDB] auto_vacuum={} (not INCREMENTAL): retention frees pages but the file will not shrink; "
+               "run MyDB::ConvertToIncrementalVacuum in a maintenance window: path={}", mode, cfg_.path);
+  }
+}
+
+bool MyDB::ConvertToIncrementalVacuum(std::string* err) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (!initialized_ || !db_) {
+    std::string e = "db not initialized";
+    if (err) *err = e;
+    MYLOG_ERROR("[MyDB] ConvertToIncrementalVacuum failed: {}", e);
+    return false;
+  }
+
+  int mode = 0;
+  if (!QueryAutoVacuumLocked(&mode, err)) return false;
+  if (mode == 2) return true;
+
+  // 设置后需要一次全量 VACUUM 才生效
+  MYLOG_WARN("[MyDB] Converting db to auto_vacuum=INCREMENTAL (full VACUUM): path={}", cfg_.path);
+  const auto t0 = std::chrono::steady_clock::now();
+  if (!ExecLocked("PRAGMA auto_vacuum=INCREMENTAL;", err)) return false;
+  if (!ExecLocked("VACUUM;", err)) return false;
+  MYLOG_INFO("[MyDB] auto_vacuum converted: cost_ms={}",
+             std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count());
+  return true;
+}
+
 void MyDB::Close() {
   std::lock_guard<std::mutex> lk(mu_);
   if (db_) {
     MYLOG_WARN("[MyDB] Close db: path={}", cfg_.path);
+    std::shared_ptr<ReadPool> pool;
+    {
+      std::lock_guard<std::mutex> rlk(read_mu_);
+      pool = std::move(read_pool_);
+    }
+    if (pool) {
+      pool->Close();
+    }
+    // 未 finalize 的语句会让 sqlite3_close 返回 SQLITE_BUSY
+    stmt_cache_.reset();
     sqlite3_close(db_);
     db_ = nullptr;
   }
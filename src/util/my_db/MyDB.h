@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
@@ -10,6 +11,8 @@
 #include <nlohmann/json.hpp>
 
 #include "MyLog.h"
+#include "ReadPool.h"
+#include "StatementCache.h"
 
 struct sqlite3; // forward declare
 
@@ -26,9 +29,30 @@ struct DBConfig {
 
   bool auto_migrate{true};
 
+  // 预编译语句缓存容量（按 SQL 文本 LRU），0 表示不缓存
+  int statement_cache_size{64};
+
+  // 只读连接池大小（仅 wal=true 且非 :memory: 时生效），0 表示读写共用一条连接
+  int read_pool_size{4};
+
   bool status_snapshot_enable{true};
   int status_snapshot_interval_ms{5000};
 
+  // 状态快照组提交：攒满 batch_max_rows 行或首行等待 batch_interval_ms 后一次事务写入
+  int snapshot_batch_max_rows{256};
+  int snapshot_batch_interval_ms{200};
+  int snapshot_queue_capacity{8192};  // 队列满时丢弃新快照
+
+  // 状态快照保留与降采样（SnapshotRetention 后台定时执行）：
+  // 原始快照先汇总为 1 分钟 / 1 小时聚合，再按各自保留期分批删除，并增量回收空闲页
+  bool snapshot_retention_enable{true};
+  int snapshot_raw_retention_hours{72};
+  int snapshot_minute_rollup_retention_days{30};
+  int snapshot_hour_rollup_retention_days{365};
+  int snapshot_retention_interval_ms{60000};
+  int snapshot_retention_delete_batch{2000};  // 每个删除事务的最大行数
+  int snapshot_vacuum_pages{1024};            // 每轮 incremental_vacuum 最多回收的页数
+
   static DBConfig FromJson(const nlohmann::json& j);
 };
 
@@ -50,11 +74,28 @@ public:
   bool Transaction(const std::function<bool(std::string* err)>& fn, std::string* err);
 
   std::string Path() const;
+  DBConfig Config() const;
   void Close();
 
   sqlite3* UnsafeHandle() const { return db_; }
   std::mutex& Mutex() { return mu_; }
 
+  // 假设已持有 Mutex()：从语句缓存取出预编译语句，句柄析构时自动 reset 并归还。
+  // 句柄必须在释放锁之前析构；失败时返回空句柄并写入 err。
+  StatementHandle Prepare(const std::string& sql, std::string* err);
+
+  StatementCacheStats StatementStats() const;
+
+  // 只读查询入口（无需持有 Mutex()）：从只读连接池租一条连接，WAL 下不被写事务阻塞。
+  // 连接池未启用时退化为持有 Mutex() 的写连接。失败时返回空租约并写入 err。
+  ReadLease AcquireReader(std::string* err);
+
+  ReadPoolStats ReadStats() const;
+
+  // 维护命令：把 auto_vacuum=NONE 的旧库转换为 INCREMENTAL（全量 VACUUM，耗时与库大小成正比，
+  // 期间持有写锁）。Init/Migrate 不会自动执行，需在维护窗口显式调用；已是 INCREMENTAL 时直接返回 true。
+  bool ConvertToIncrementalVacuum(std::string* err);
+
 private:
   MyDB() = default;
   ~MyDB();
@@ -64,11 +105,17 @@ private:
   bool TransactionLocked(const std::function<bool(std::string* err)>& fn, std::string* err);
 
   bool ApplyPragmasLocked(std::string* err);
+  bool QueryAutoVacuumLocked(int* mode, std::string* err);
+  void CheckIncrementalVacuumLocked();
+  bool ColumnExistsLocked(const std::string& table, const std::string& column, bool* exists, std::string* err);
   bool EnsureParentDirExists(const std::string& path, std::string* err);
 
 private:
   mutable std::mutex mu_;
   sqlite3* db_{nullptr};
+  std::unique_ptr<StatementCache> stmt_cache_;
+  mutable std::mutex read_mu_;  // 只保护 read_pool_ 指针
+  std::shared_ptr<ReadPool> read_pool_;
   DBConfig cfg_{};
   bool initialized_{false};
 };
@@ -0,0 +1,176 @@
+#include "ReadPool.h"
+
+#include <chrono>
+#include <utility>
+
+#include "MyLog.h"
+#include "sqlite3.h"
+
+namespace my_db {
+
+// ---------------- ReadLease ----------------
+
+ReadLease::~ReadLease() {
+  Release();
+}
+
+ReadLease::ReadLease(ReadLease&& other) noexcept
+    : pool_(std::move(other.pool_)),
+      conn_(std::exchange(other.conn_, nullptr)),
+      writer_lock_(std::move(other.writer_lock_)),
+      writer_db_(std::exchange(other.writer_db_, nullptr)),
+      writer_stmts_(std::exchange(other.writer_stmts_, nullptr)) {}
+
+ReadLease& ReadLease::operator=(ReadLease&& other) noexcept {
+  if (this != &other) {
+    Release();
+    pool_ = std::move(other.pool_);
+    conn_ = std::exchange(other.conn_, nullptr);
+    writer_lock_ = std::move(other.writer_lock_);
+    writer_db_ = std::exchange(other.writer_db_, nullptr);
+    writer_stmts_ = std::exchange(other.writer_stmts_, nullptr);
+  }
+  return *this;
+}
+
+sqlite3* ReadLease::handle() const {
+  return conn_ ? conn_->db : writer_db_;
+}
+
+StatementHandle ReadLease::Prepare(const std::string& sql, std::string* err) {
+  StatementCache* cache = conn_ ? conn_->stmts.get() : writer_stmts_;
+  sqlite3* db = handle();
+  if (!db || !cache) {
+    if (err) *err = "db not initialized";
+    return StatementHandle();
+  }
+  return cache->Acquire(db, sql, err);
+}
+
+void ReadLease::Release() {
+  if (conn_ && pool_) {
+    pool_->Return(conn_);
+  }
+  conn_ = nullptr;
+  pool_.reset();
+
+  writer_db_ = nullptr;
+  writer_stmts_ = nullptr;
+  if (writer_lock_.owns_lock()) {
+    writer_lock_.unlock();
+  }
+  writer_lock_ = std::unique_lock<std::mutex>();
+}
+
+// ---------------- ReadPool ----------------
+
+ReadPool::ReadPool(std::string path, std::size_t size, int busy_timeout_ms, std::size_t stmt_cache_size)
+    : path_(std::move(path)), size_(size), busy_timeout_ms_(busy_timeout_ms), stmt_cache_size_(stmt_cache_size) {}
+
+ReadPool::~ReadPool() {
+  Close();
+}
+
+bool ReadPool::Open(std::string* err) {
+  std::lock_guard<std::mutex> lk(mu_);
+
+  for (std::size_t i = 0; i < size_; ++i) {
+    auto conn = std::make_unique<ReadConnection>();
+    // 每条连接同一时刻只被一个租约使用，无需 SQLite 内部互斥
+    int rc = sqlite3_open_v2(path_.c_str(), &conn->db, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
+    if (rc != SQLITE_OK || !conn->db) {
+      std::string e = std::string("sqlite3_open_v2(readonly) failed: ") +
+                      (conn->db ? sqlite3_errmsg(conn->db) : "db is null");
+      if (err) *err = e;
+      MYLOG_ERROR("[ReadPool] Open failed: path={}, err={}", path_, e);
+      CloseConnection(conn.get());
+      for (auto& c : conns_) CloseConnection(c.get());
+      conns_.clear();
+      idle_.clear();
+      return false;
+    }
+    sqlite3_busy_timeout(conn->db, busy_timeout_ms_);
+    conn->stmts = std::make_unique<StatementCache>(stmt_cache_size_);
+
+    idle_.push_back(conn.get());
+    conns_.push_back(std::move(conn));
+  }
+
+  MYLOG_INFO("[ReadPool] Open success: path={}, size={}", path_, size_);
+  return true;
+}
+
+ReadLease ReadPool::Acquire(std::string* err) {
+  std::unique_lock<std::mutex> lk(mu_);
+  ++acquires_;
+
+  if (idle_.empty() && !closed_) {
+    ++waits_;
+    bool ready = cv_.wait_for(lk, std::chrono::milliseconds(busy_timeout_ms_),
+                              [&] { return closed_ || !idle_.empty(); });
+    if (!ready) {
+      ++timeouts_;
+      if (err) *err = "read pool exhausted";
+      MYLOG_WARN("[ReadPool] Acquire timeout: size={}, wait_ms={}", size_, busy_timeout_ms_);
+      return ReadLease();
+    }
+  }
+  if (closed_) {
+    if (err) *err = "read pool closed";
+    return ReadLease();
+  }
+
+  ReadLease lease;
+  lease.pool_ = shared_from_this();
+  lease.conn_ = idle_.back();
+  idle_.pop_back();
+  return lease;
+}
+
+void ReadPool::Return(ReadConnection* conn) {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (closed_) {
+      CloseConnection(conn);
+      return;
+    }
+    idle_.push_back(conn);
+  }
+  cv_.notify_one();
+}
+
+void ReadPool::Close() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (closed_) return;
+    closed_ = true;
+    for (auto* conn : idle_) {
+      CloseConnection(conn);
+    }
+    idle_.clear();
+  }
+  cv_.notify_all();
+  MYLOG_INFO("[ReadPool] Closed: path={}", path_);
+}
+
+void ReadPool::CloseConnection(ReadConnection* conn) {
+  // 先 finalize 缓存语句，否则 sqlite3_close 返回 SQLITE_BUSY
+  conn->stmts.reset();
+  if (conn->db) {
+    sqlite3_close(conn->db);
+    conn->db = nullptr;
+  }
+}
+
+ReadPoolStats ReadPool::Stats() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  ReadPoolStats s;
+  s.size = closed_ ? 0 : conns_.size();
+  s.idle = idle_.size();
+  s.acquires = acquires_;
+  s.waits = waits_;
+  s.timeouts = timeouts_;
+  return s;
+}
+
+} // namespace my_db
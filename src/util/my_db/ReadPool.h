@@ -0,0 +1,108 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "StatementCache.h"
+
+struct sqlite3; // forward declare
+
+namespace my_db {
+
+class ReadPool;
+
+// 一条只读连接及其私有的语句缓存（同一时刻只被一个租约持有）
+struct ReadConnection {
+  sqlite3* db{nullptr};
+  std::unique_ptr<StatementCache> stmts;
+};
+
+// 读连接租约（RAII）：析构时归还连接池。
+// 连接池未启用时退化为持有写连接锁（MyDB::Mutex()）并使用写连接。
+// 租约上 Prepare 出的句柄必须先于租约析构。
+class ReadLease {
+public:
+  ReadLease() = default;
+  ~ReadLease();
+
+  ReadLease(const ReadLease&) = delete;
+  ReadLease& operator=(const ReadLease&) = delete;
+  ReadLease(ReadLease&& other) noexcept;
+  ReadLease& operator=(ReadLease&& other) noexcept;
+
+  explicit operator bool() const { return handle() != nullptr; }
+  sqlite3* handle() const;
+
+  StatementHandle Prepare(const std::string& sql, std::string* err);
+
+  void Release();
+
+private:
+  friend class ReadPool;
+  friend class MyDB;
+
+  std::shared_ptr<ReadPool> pool_;
+  ReadConnection* conn_{nullptr};
+
+  // 回退模式：写连接 + 写锁
+  std::unique_lock<std::mutex> writer_lock_;
+  sqlite3* writer_db_{nullptr};
+  StatementCache* writer_stmts_{nullptr};
+};
+
+struct ReadPoolStats {
+  std::size_t size{0};
+  std::size_t idle{0};
+  std::uint64_t acquires{0};
+  std::uint64_t waits{0};     // 需要等待空闲连接的次数
+  std::uint64_t timeouts{0};  // 等待超时次数
+};
+
+// 固定大小的只读连接池（SQLITE_OPEN_READONLY，WAL 下与写连接并发读）
+class ReadPool : public std::enable_shared_from_this<ReadPool> {
+public:
+  ReadPool(std::string path, std::size_t size, int busy_timeout_ms, std::size_t stmt_cache_size);
+  ~ReadPool();
+
+  ReadPool(const ReadPool&) = delete;
+  ReadPool& operator=(const ReadPool&) = delete;
+
+  // 打开全部连接；任一失败则关闭已打开的连接并返回 false
+  bool Open(std::string* err);
+
+  // 取一条空闲连接，最多等待 busy_timeout_ms；失败返回空租约
+  ReadLease Acquire(std::string* err);
+
+  // 关闭空闲连接；仍被租用的连接在归还时关闭
+  void Close();
+
+  ReadPoolStats Stats() const;
+
+private:
+  friend class ReadLease;
+
+  void Return(ReadConnection* conn);
+  static void CloseConnection(ReadConnection* conn);
+
+  std::string path_;
+  std::size_t size_;
+  int busy_timeout_ms_;
+  std::size_t stmt_cache_size_;
+
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  std::vector<std::unique_ptr<ReadConnection>> conns_;
+  std::vector<ReadConnection*> idle_;
+  bool closed_{false};
+
+  std::uint64_t acquires_{0};
+  std::uint64_t waits_{0};
+  std::uint64_t timeouts_{0};
+};
+
+} // namespace my_db
@@ -0,0 +1,134 @@
+#include "StatementCache.h"
+
+#include "MyLog.h"
+#include "sqlite3.h"
+
+namespace my_db {
+
+// ---------------- StatementHandle ----------------
+
+StatementHandle::~StatementHandle() {
+  Release();
+}
+
+StatementHandle::StatementHandle(StatementHandle&& other) noexcept
+    : owner_(other.owner_), stmt_(other.stmt_), key_(other.key_) {
+  other.owner_ = nullptr;
+  other.stmt_ = nullptr;
+  other.key_ = nullptr;
+}
+
+StatementHandle& StatementHandle::operator=(StatementHandle&& other) noexcept {
+  if (this != &other) {
+    Release();
+    owner_ = other.owner_;
+    stmt_ = other.stmt_;
+    key_ = other.key_;
+    other.owner_ = nullptr;
+    other.stmt_ = nullptr;
+    other.key_ = nullptr;
+  }
+  return *this;
+}
+
+void StatementHandle::Release() {
+  if (stmt_ && owner_) {
+    owner_->Release(stmt_, key_);
+  }
+  owner_ = nullptr;
+  stmt_ = nullptr;
+  key_ = nullptr;
+}
+
+// ---------------- StatementCache ----------------
+
+StatementCache::~StatementCache() {
+  Clear();
+}
+
+StatementHandle StatementCache::Acquire(sqlite3* db, const std::string& sql, std::string* err) {
+  auto it = entries_.find(sql);
+  if (it != entries_.end() && !it->second.in_use) {
+    ++hits_;
+    it->second.in_use = true;
+    lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+    return StatementHandle(this, it->second.stmt, &it->first);
+  }
+
+  ++misses_;
+  sqlite3_stmt* stmt = nullptr;
+  int rc = sqlite3_prepare_v3(db, sql.c_str(), static_cast<int>(sql.size()),
+                              capacity_ > 0 ? SQLITE_PREPARE_PERSISTENT : 0, &stmt, nullptr);
+  if (rc != SQLITE_OK || !stmt) {
+    if (err) *err = sqlite3_errmsg(db);
+    MYLOG_ERROR("[StatementCache] prepare failed: rc={}, err={}, sql={}", rc, sqlite3_errmsg(db), sql);
+    if (stmt) sqlite3_finalize(stmt);
+    return StatementHandle();
+  }
+
+  // 同一条 SQL 正在被使用（嵌套调用）或缓存关闭：临时语句，用完即 finalize
+  if (it != entries_.end() || capacity_ == 0) {
+    return StatementHandle(this, stmt, nullptr);
+  }
+
+  auto [inserted, ok] = entries_.emplace(sql, Entry{stmt, true, {}});
+  (void)ok;
+  inserted->second.lru_it = lru_.insert(lru_.begin(), &inserted->first);
+  EvictIfNeeded();
+  return StatementHandle(this, stmt, &inserted->first);
+}
+
+void StatementCache::Release(sqlite3_stmt* stmt, const std::string* key) {
+  if (!key) {
+    sqlite3_finalize(stmt);
+    return;
+  }
+
+  // 清除游标与绑定，下次取出即为干净状态（也释放 SQLITE_TRANSIENT 绑定的拷贝）
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  auto it = entries_.find(*key);
+  if (it != entries_.end()) {
+    it->second.in_use = false;
+  }
+  EvictIfNeeded();
+}
+
+void StatementCache::EvictIfNeeded() {
+  // 从 LRU 尾部淘汰未被占用的语句；被占用的语句归还后再淘汰
+  auto lit = lru_.end();
+  while (entries_.size() > capacity_ && lit != lru_.begin()) {
+    --lit;
+    auto it = entries_.find(**lit);
+    if (it->second.in_use) {
+      continue;
+    }
+    sqlite3_finalize(it->second.stmt);
+    lit = lru_.erase(lit);
+    entries_.erase(it);
+    ++evictions_;
+  }
+}
+
+void StatementCache::Clear() {
+  for (auto& [sql, entry] : entries_) {
+    if (entry.in_use) {
+      MYLOG_WARN("[StatementCache] Clear with statement still in use: sql={}", sql);
+    }
+    sqlite3_finalize(entry.stmt);
+  }
+  entries_.clear();
+  lru_.clear();
+}
+
+StatementCacheStats StatementCache::Stats() const {
+  StatementCacheStats s;
+  s.hits = hits_;
+  s.misses = misses_;
+  s.evictions = evictions_;
+  s.size = entries_.size();
+  return s;
+}
+
+} // namespace my_db
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+struct sqlite3;      // forward declare
+struct sqlite3_stmt; // forward declare
+
+namespace my_db {
+
+class StatementCache;
+
+// 预编译语句的 RAII 句柄：析构时 reset + clear_bindings 并归还缓存。
+// 只能在持有对应连接锁（MyDB::Mutex()）期间使用和释放。
+class StatementHandle {
+public:
+  StatementHandle() = default;
+  ~StatementHandle();
+
+  StatementHandle(const StatementHandle&) = delete;
+  StatementHandle& operator=(const StatementHandle&) = delete;
+  StatementHandle(StatementHandle&& other) noexcept;
+  StatementHandle& operator=(StatementHandle&& other) noexcept;
+
+  sqlite3_stmt* get() const { return stmt_; }
+  explicit operator bool() const { return stmt_ != nullptr; }
+
+  // 提前归还（之后句柄为空）
+  void Release();
+
+private:
+  friend class StatementCache;
+  StatementHandle(StatementCache* owner, sqlite3_stmt* stmt, const std::string* key)
+      : owner_(owner), stmt_(stmt), key_(key) {}
+
+  StatementCache* owner_{nullptr};
+  sqlite3_stmt* stmt_{nullptr};
+  const std::string* key_{nullptr}; // 缓存项的 key；nullptr 表示缓存项被占用时临时编译的语句，释放时直接 finalize
+};
+
+struct StatementCacheStats {
+  std::uint64_t hits{0};
+  std::uint64_t misses{0};
+  std::uint64_t evictions{0};
+  std::size_t size{0};
+};
+
+// 以 SQL 文本为 key 的预编译语句 LRU 缓存（单连接，非线程安全，由连接锁保护）
+class StatementCache {
+public:
+  explicit StatementCache(std::size_t capacity) : capacity_(capacity) {}
+  ~StatementCache();
+
+  StatementCache(const StatementCache&) = delete;
+  StatementCache& operator=(const StatementCache&) = delete;
+
+  // 命中则复用，未命中则 sqlite3_prepare_v3(PERSISTENT) 并放入缓存；失败返回空句柄
+  StatementHandle Acquire(sqlite3* db, const std::string& sql, std::string* err);
+
+  // finalize 所有缓存语句（关闭连接前调用；此时不应有未归还的句柄）
+  void Clear();
+
+  StatementCacheStats Stats() const;
+
+private:
+  friend class StatementHandle;
+
+  using LruList = std::list<const std::string*>;
+
+  struct Entry {
+    sqlite3_stmt* stmt{nullptr};
+    bool in_use{false};
+    LruList::iterator lru_it;
+  };
+
+  void Release(sqlite3_stmt* stmt, const std::string* key);
+  void EvictIfNeeded();
+
+  std::size_t capacity_;
+  std::unordered_map<std::string, Entry> entries_;
+  LruList lru_; // 头部最近使用；元素指向 entries_ 的 key
+
+  std::uint64_t hits_{0};
+  std::uint64_t misses_{0};
+  std::uint64_t evictions_{0};
+};
+
+} // namespace my_db
@@ -0,0 +1,439 @@
+#include "SnapshotRetention.h"
+
+#include <algorithm>
+#include <chrono>
+#include <initializer_list>
+#include <vector>
+
+#include "MyData.h"
+#include "MyLog.h"
+#include "sqlite3.h"
+
+namespace my_db::demo {
+
+namespace {
+
+constexpr std::int64_t kMinuteMs = 60 * 1000;
+constexpr std::int64_t kHourMs = 60 * kMinuteMs;
+constexpr std::int64_t kDayMs = 24 * kHourMs;
+
+// 留给组提交的迟到时间：桶结束后再等这么久才汇总
+constexpr std::int64_t kRollupGraceMs = 10 * 1000;
+// 单个汇总事务最多覆盖的时间跨度（限制持有写锁的时长）
+constexpr std::int64_t kRollupSpanMs = kDayMs;
+// 每轮最多执行的汇总事务 / 删除批次，余下的留给下一轮
+constexpr int kMaxRollupSpansPerRun = 30;
+constexpr int kMaxDeleteBatchesPerRun = 50;
+
+// 早期版本写入的 status_json 是 toString() 文本，按空对象参与聚合（只计入 samples）
+
+const std::string kDeviceRollupSql = R"SQL(
+  INSERT OR REPLACE INTO device_status_rollups(
+    edge_id, device_id, bucket_ms, bucket_start_ms, samples,
+    online_samples, busy_samples, faulted_samples,
+    queue_depth_max, queue_depth_avg, last_ts_ms, last_status_json)
+  SELECT g.edge_id, g.device_id, ?1, g.bucket_start, g.samples,
+         g.online, g.busy, g.faulted, g.qmax, g.qavg, g.last_ts,
+         (SELECT s.status_json FROM device_status_snapshots s
+           WHERE s.device_id = g.device_id AND s.ts_ms = g.last_ts AND s.edge_id IS g.edge_id
+           ORDER BY s.id DESC LIMIT 1)
+  FROM (
+    SELECT edge_id, device_id, (ts_ms / ?1) * ?1 AS bucket_start,
+           COUNT(1) AS samples,
+           SUM(json_extract(j, '$.conn_state') = 1) AS online,
+           SUM(json_extract(j, '$.work_state') = 1) AS busy,
+           SUM(json_extract(j, '$.work_state') = 2) AS faulted,
+           MAX(json_extract(j, '$.queue_depth')) AS qmax,
+           AVG(json_extract(j, '$.queue_depth')) AS qavg,
+           MAX(ts_ms) AS last_ts
+    FROM (SELECT edge_id, device_id, ts_ms,
+                 CASE WHEN json_valid(status_json) THEN status_json ELSE '{}' END AS j
+          FROM device_status_snapshots
+          WHERE ts_ms >= ?2 AND ts_ms < ?3)
+    GROUP BY edge_id, device_id, bucket_start
+  ) AS g;
+)SQL";
+
+const std::string kEdgeRollupSql = R"SQL(
+  INSERT OR REPLACE INTO edge_status_rollups(
+    edge_id, bucket_ms, bucket_start_ms, samples, estop_samples,
+    tasks_pending_max, tasks_pending_avg, tasks_running_max, last_ts_ms, last_status_json)
+  SELECT g.edge_id, ?1, g.bucket_start, g.samples, g.estop,
+         g.pmax, g.pavg, g.rmax, g.last_ts,
+         (SELECT s.status_json FROM edge_status_snapshots s
+           WHERE s.edge_id = g.edge_id AND s.ts_ms = g.last_ts
+           ORDER BY s.id DESC LIMIT 1)
+  FROM (
+    SELECT edge_id, (ts_ms / ?1) * ?1 AS bucket_start,
+           COUNT(1) AS samples,
+           SUM(json_extract(j, '$.estop_active')) AS estop,
+           MAX(json_extract(j, '$.tasks_pending_total')) AS pmax,
+           AVG(json_extract(j, '$.tasks_pending_total')) AS pavg,
+           MAX(json_extract(j, '$.tasks_running_total')) AS rmax,
+           MAX(ts_ms) AS last_ts
+    FROM (SELECT edge_id, ts_ms,
+                 CASE WHEN json_valid(status_json) THEN status_json ELSE '{}' END AS j
+          FROM edge_status_snapshots
+          WHERE ts_ms >= ?2 AND ts_ms < ?3)
+    GROUP BY edge_id, bucket_start
+  ) AS g;
+)SQL";
+
+struct Source {
+  const char* name;              // snapshot_rollup_state.source
+  const std::string* rollup_sql;
+  std::string min_ts_sql;
+  std::string delete_raw_sql;
+  std::string delete_rollup_sql;
+};
+
+const Source& DeviceSource() {
+  static const Source src{
+      "device", &kDeviceRollupSql,
+      "SELECT MIN(ts_ms) FROM device_status_snapshots;",
+      "DELETE FROM device_status_snapshots WHERE id IN "
+      "(SELECT id FROM device_status_snapshots WHERE ts_ms < ?1 ORDER BY ts_ms LIMIT ?2);",
+      "DELETE FROM device_status_rollups WHERE rowid IN "
+      "(SELECT rowid FROM device_status_rollups WHERE bucket_ms = ?1 AND bucket_start_ms < ?2 LIMIT ?3);"};
+  return src;
+}
+
+const Source& EdgeSource() {
+  static const Source src{
+      "edge", &kEdgeRollupSql,
+      "SELECT MIN(ts_ms) FROM edge_status_snapshots;",
+      "DELETE FROM edge_status_snapshots WHERE id IN "
+      "(SELECT id FROM edge_status_snapshots WHERE ts_ms < ?1 ORDER BY ts_ms LIMIT ?2);",
+      "DELETE FROM edge_status_rollups WHERE rowid IN "
+      "(SELECT rowid FROM edge_status_rollups WHERE bucket_ms = ?1 AND bucket_start_ms < ?2 LIMIT ?3);"};
+  return src;
+}
+
+std::int64_t FloorTo(std::int64_t v, std::int64_t unit) {
+  return v >= 0 ? (v / unit) * unit : ((v - unit + 1) / unit) * unit;
+}
+
+// 以下均假设已持有 db.Mutex()
+
+bool StepInt64Args(MyDB& db, const std::string& sql, std::initializer_list<std::int64_t> args,
+                   std::int64_t* changes, std::string* err) {
+  auto handle = db.Prepare(sql, err);
+  if (!handle) return false;
+  sqlite3_stmt* stmt = handle.get();
+
+  int idx = 1;
+  for (std::int64_t v : args) {
+    sqlite3_bind_int64(stmt, idx++, static_cast<sqlite3_int64>(v));
+  }
+  int rc = sqlite3_step(stmt);
+  if (rc != SQLITE_DONE && rc != SQLITE_ROW) {
+    if (err) *err = sqlite3_errmsg(db.UnsafeHandle());
+    return false;
+  }
+  if (changes) *changes = sqlite3_changes(db.UnsafeHandle());
+  return true;
+}
+
+// 查询单个整数；结果为 NULL 或无行时 *found=false
+bool QueryInt64(MyDB& db, const std::string& sql, const char* text_arg, std::int64_t int_arg,
+                std::int64_t* out, bool* found, std::string* err) {
+  *found = false;
+  auto handle = db.Prepare(sql, err);
+  if (!handle) return false;
+  sqlite3_stmt* stmt = handle.get();
+
+  if (text_arg) {
+    sqlite3_bind_text(stmt, 1, text_arg, -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(int_arg));
+  }
+  int rc = sqlite3_step(stmt);
+  if (rc == SQLITE_ROW) {
+    if (sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+      *out = sqlite3_column_int64(stmt, 0);
+      *found = true;
+    }
+    return true;
+  }
+  if (rc == SQLITE_DONE) return true;
+  if (err) *err = sqlite3_errmsg(db.UnsafeHandle());
+  return false;
+}
+
+bool ReadWatermark(MyDB& db, const Source& src, std::int64_t bucket_ms,
+                   std::int64_t* out, bool* found, std::string* err) {
+  static const std::string sql = "SELECT done_until_ms FROM snapshot_rollup_state WHERE source=?1 AND bucket_ms=?2;";
+  return QueryInt64(db, sql, src.name, bucket_ms, out, found, err);
+}
+
+bool WriteWatermark(MyDB& db, const Source& src, std::int64_t bucket_ms, std::int64_t done_until,
+                    std::string* err) {
+  static const std::string sql =
+      "INSERT OR REPLACE INTO snapshot_rollup_state(source, bucket_ms, done_until_ms) VALUES(?1, ?2, ?3);";
+  auto handle = db.Prepare(sql, err);
+  if (!handle) return false;
+  sqlite3_stmt* stmt = handle.get();
+  sqlite3_bind_text(stmt, 1, src.name, -1, SQLITE_STATIC);
+  sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(bucket_ms));
+  sqlite3_bind_int64(stmt, 3, static_cast<sqlite3_int64>(done_until));
+  if (sqlite3_step(stmt) != SQLITE_DONE) {
+    if (err) *err = sqlite3_errmsg(db.UnsafeHandle());
+    return false;
+  }
+  return true;
+}
+
+// 汇总一个 (源表, 粒度)：每个事务最多推进 kRollupSpanMs；*done_until 返回汇总进度
+bool Rollup(MyDB& db, const Source& src, std::int64_t bucket_ms, std::int64_t now_ms,
+            std::int64_t* done_until, bool* has_data, RetentionReport* report, std::string* err) {
+  const std::int64_t end = FloorTo(now_ms - kRollupGraceMs, bucket_ms);
+
+  std::int64_t done = 0;
+  bool found = false;
+  bool ok = db.Transaction([&](std::string* txe) -> bool {
+    if (!ReadWatermark(db, src, bucket_ms, &done, &found, txe)) return false;
+    if (found) return true;
+
+    // 首次汇总：从最早一条原始快照所在的桶开始
+    std::int64_t min_ts = 0;
+    bool has_rows = false;
+    if (!QueryInt64(db, src.min_ts_sql, nullptr, 0, &min_ts, &has_rows, txe)) return false;
+    if (has_rows) {
+      done = FloorTo(min_ts, bucket_ms);
+      found = true;
+    }
+    return true;
+  }, err);
+  if (!ok) return false;
+
+  *has_data = found;
+  if (!found) {
+    return true;  // 没有数据也没有进度
+  }
+
+  for (int i = 0; i < kMaxRollupSpansPerRun && done < end; ++i) {
+    const std::int64_t span_end = std::min(end, done + kRollupSpanMs);
+    std::int64_t changes = 0;
+    ok = db.Transaction([&](std::string* txe) -> bool {
+      if (!StepInt64Args(db, *src.rollup_sql, {bucket_ms, done, span_end}, &changes, txe)) return false;
+      return WriteWatermark(db, src, bucket_ms, span_end, txe);
+    }, err);
+    if (!ok) return false;
+
+    if (report) report->rollup_rows += changes;
+    done = span_end;
+  }
+
+  *done_until = done;
+  return true;
+}
+
+// 分批删除：每批一个事务，批与批之间释放写锁；返回删除总行数
+bool DeleteInBatches(MyDB& db, const std::string& sql, std::initializer_list<std::int64_t> args_before_limit,
+                     std::int64_t batch, std::int64_t* deleted, std::string* err) {
+  std::vector<std::int64_t> args(args_before_limit);
+  args.push_back(batch);
+
+  for (int i = 0; i < kMaxDeleteBatchesPerRun; ++i) {
+    std::int64_t changes = 0;
+    bool ok = db.Transaction([&](std::string* txe) -> bool {
+      auto handle = db.Prepare(sql, txe);
+      if (!handle) return false;
+      int idx = 1;
+      for (std::int64_t v : args) {
+        sqlite3_bind_int64(handle.get(), idx++, static_cast<sqlite3_int64>(v));
+      }
+      if (sqlite3_step(handle.get()) != SQLITE_DONE) {
+        if (txe) *txe = sqlite3_errmsg(db.UnsafeHandle());
+        return false;
+      }
+      changes = sqlite3_changes(db.UnsafeHandle());
+      return true;
+    }, err);
+    if (!ok) return false;
+
+    *deleted += changes;
+    if (changes < batch) break;
+  }
+  return true;
+}
+
+bool IncrementalVacuum(MyDB& db, int pages, std::int64_t* vacuumed, std::string* err) {
+  static const std::string freelist_sql = "PRAGMA freelist_count;";
+  const std::string vacuum_sql = "PRAGMA incremental_vacuum(" + std::to_string(pages) + ");";
+
+  std::lock_guard<std::mutex> lk(db.Mutex());
+  if (!db.UnsafeHandle()) {
+    if (err) *err = "db not initialized";
+    return false;
+  }
+
+  std::int64_t before = 0, after = 0;
+  bool found = false;
+  if (!QueryInt64(db, freelist_sql, nullptr, 0, &before, &found, err)) return false;
+  if (before == 0) return true;
+
+  {
+    auto handle = db.Prepare(vacuum_sql, err);
+    if (!handle) return false;
+    int rc;
+    while ((rc = sqlite3_step(handle.get())) == SQLITE_ROW) {
+    }
+    if (rc != SQLITE_DONE) {
+      if (err) *err = sqlite3_errmsg(db.UnsafeHandle());
+      return false;
+    }
+  }
+
+  if (!QueryInt64(db, freelist_sql, nullptr, 0, &after, &found, err)) return false;
+  *vacuumed += before - after;
+  return true;
+}
+
+} // namespace
+
+SnapshotRetention& SnapshotRetention::GetInstance() {
+  static SnapshotRetention inst;
+  return inst;
+}
+
+SnapshotRetention::SnapshotRetention() {
+  // 保证 MyDB 晚于本单例析构
+  (void)my_db::MyDB::GetInstance();
+}
+
+SnapshotRetention::~SnapshotRetention() {
+  Stop();
+}
+
+bool SnapshotRetention::Start(std::string* err) {
+  auto& db = my_db::MyDB::GetInstance();
+  if (!db.IsInitialized()) {
+    if (err) *err = "db not initialized";
+    return false;
+  }
+  const DBConfig cfg = db.Config();
+  if (!cfg.snapshot_retention_enable) {
+    MYLOG_INFO("[Retention] disabled by cfg");
+    return true;
+  }
+
+  std::lock_guard<std::mutex> lk(mu_);
+  if (running_) {
+    return true;
+  }
+  stop_ = false;
+  running_ = true;
+  const int interval_ms = std::max(1000, cfg.snapshot_retention_interval_ms);
+  worker_ = std::thread(&SnapshotRetention::Loop, this, interval_ms);
+
+  MYLOG_INFO("[Retention] Start: interval_ms={}, raw_hours={}, minute_days={}, hour_days={}",
+             interval_ms, cfg.snapshot_raw_retention_hours, cfg.snapshot_minute_rollup_retention_days,
+             cfg.snapshot_hour_rollup_retention_days);
+  return true;
+}
+
+void SnapshotRetention::Stop() {
+  std::thread worker;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!running_) {
+      return;
+    }
+    stop_ = true;
+    worker = std::move(worker_);
+  }
+  cv_.notify_all();
+  if (worker.joinable()) {
+    worker.join();
+  }
+
+  std::lock_guard<std::mutex> lk(mu_);
+  running_ = false;
+  MYLOG_INFO("[Retention] Stopped");
+}
+
+bool SnapshotRetention::IsRunning() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return running_ && !stop_;
+}
+
+void SnapshotRetention::Loop(int interval_ms) {
+  MYLOG_INFO("[Retention] Loop enter");
+
+  std::unique_lock<std::mutex> lk(mu_);
+  while (!stop_) {
+    cv_.wait_for(lk, std::chrono::milliseconds(interval_ms), [&] { return stop_; });
+    if (stop_) break;
+
+    lk.unlock();
+    RetentionReport r;
+    std::string err;
+    if (!RunOnce(my_data::NowMs(), &r, &err)) {
+      MYLOG_ERROR("[Retention] RunOnce failed: {}", err);
+    }
+    lk.lock();
+  }
+
+  MYLOG_INFO("[Retention] Loop exit");
+}
+
+bool SnapshotRetention::RunOnce(std::int64_t now_ms, RetentionReport* report, std::string* err) {
+  std::lock_guard<std::mutex> run_lk(run_mu_);
+
+  auto& db = my_db::MyDB::GetInstance();
+  if (!db.IsInitialized()) {
+    if (err) *err = "db not initialized";
+    return false;
+  }
+  const DBConfig cfg = db.Config();
+
+  RetentionReport r;
+  const std::int64_t batch = std::max(1, cfg.snapshot_retention_delete_batch);
+  const std::int64_t raw_cutoff = now_ms - static_cast<std::int64_t>(cfg.snapshot_raw_retention_hours) * kHourMs;
+  const std::int64_t minute_cutoff =
+      now_ms - static_cast<std::int64_t>(cfg.snapshot_minute_rollup_retention_days) * kDayMs;
+  const std::int64_t hour_cutoff =
+      now_ms - static_cast<std::int64_t>(cfg.snapshot_hour_rollup_retention_days) * kDayMs;
+
+  for (const Source* src : {&DeviceSource(), &EdgeSource()}) {
+    std::int64_t minute_done = 0, hour_done = 0;
+    bool has_minute = false, has_hour = false;
+    if (!Rollup(db, *src, kMinuteMs, now_ms, &minute_done, &has_minute, &r, err)) return false;
+    if (!Rollup(db, *src, kHourMs, now_ms, &hour_done, &has_hour, &r, err)) return false;
+
+    // 原始快照只删到两个粒度都已汇总的位置
+    if (has_minute && has_hour) {
+      const std::int64_t cutoff = std::min({raw_cutoff, minute_done, hour_done});
+      if (!DeleteInBatches(db, src->delete_raw_sql, {cutoff}, batch, &r.deleted_raw_rows, err)) return false;
+    }
+    if (!DeleteInBatches(db, src->delete_rollup_sql, {kMinuteMs, minute_cutoff}, batch,
+                         &r.deleted_rollup_rows, err)) return false;
+    if (!DeleteInBatches(db, src->delete_rollup_sql, {kHourMs, hour_cutoff}, batch,
+                         &r.deleted_rollup_rows, err)) return false;
+  }
+
+  if (cfg.snapshot_vacuum_pages > 0 &&
+      !IncrementalVacuum(db, cfg.snapshot_vacuum_pages, &r.vacuumed_pages, err)) {
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    totals_.rollup_rows += r.rollup_rows;
+    totals_.deleted_raw_rows += r.deleted_raw_rows;
+    totals_.deleted_rollup_rows += r.deleted_rollup_rows;
+    totals_.vacuumed_pages += r.vacuumed_pages;
+  }
+
+  MYLOG_INFO("[Retention] RunOnce: rollup_rows={}, deleted_raw={}, deleted_rollups={}, vacuumed_pages={}",
+             r.rollup_rows, r.deleted_raw_rows, r.deleted_rollup_rows, r.vacuumed_pages);
+  if (report) *report = r;
+  return true;
+}
+
+RetentionReport SnapshotRetention::Totals() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return totals_;
+}
+
+} // namespace my_db::demo
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "MyDB.h"
+
+namespace my_db::demo {
+
+struct RetentionReport {
+  std::int64_t rollup_rows{0};          // 写入的聚合行
+  std::int64_t deleted_raw_rows{0};     // 删除的原始快照
+  std::int64_t deleted_rollup_rows{0};  // 删除的过期聚合
+  std::int64_t vacuumed_pages{0};       // incremental_vacuum 回收的页
+};
+
+// 状态快照保留与降采样：
+// 1) 把已结束的时间桶汇总到 *_status_rollups（1 分钟 / 1 小时），按 snapshot_rollup_state 记录进度
+// 2) 按保留期分批删除原始快照与过期聚合（每批一个短事务，期间让出写锁）；
+//    原始快照只有在两个粒度都汇总过之后才会被删除
+// 3) PRAGMA incremental_vacuum 把空闲页还给文件系统
+class SnapshotRetention {
+public:
+  static SnapshotRetention& GetInstance();
+
+  SnapshotRetention(const SnapshotRetention&) = delete;
+  SnapshotRetention& operator=(const SnapshotRetention&) = delete;
+
+  // 按 MyDB::Config() 启动后台线程（snapshot_retention_enable=false 时不启动）
+  bool Start(std::string* err);
+  void Stop();
+  bool IsRunning() const;
+
+  // 执行一轮（now_ms 便于测试指定时间）
+  bool RunOnce(std::int64_t now_ms, RetentionReport* report, std::string* err);
+
+  // 启动以来的累计结果
+  RetentionReport Totals() const;
+
+private:
+  SnapshotRetention();
+  ~SnapshotRetention();
+
+  void Loop(int interval_ms);
+
+private:
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  bool running_{false};
+  bool stop_{false};
+  std::thread worker_;
+
+  std::mutex run_mu_;  // 串行化 RunOnce（后台线程与手动调用）
+  RetentionReport totals_{};
+};
+
+} // namespace my_db::demo
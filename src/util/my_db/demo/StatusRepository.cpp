@@ -1,5 +1,7 @@
 #include "StatusRepository.h"
 
+#include <algorithm>
+
 #include "sqlite3.h"
 
 namespace my_db::demo {
@@ -34,146 +36,308 @@ static bool StepDone(sqlite3_stmt* stmt, sqlite3* db, std::string* err) {
   return true;
 }
 
+// 假设已持有 db.Mutex()
+static bool InsertRowLocked(MyDB& db, const SnapshotRow& row, std::string* err) {
+  static const std::string device_sql = R"SQL(
+    INSERT INTO device_status_snapshots(edge_id, device_id, ts_ms, status_json)
+    VALUES(?, ?, ?, ?);
+  )SQL";
+  static const std::string edge_sql = R"SQL(
+    INSERT INTO edge_status_snapshots(edge_id, ts_ms, status_json)
+    VALUES(?, ?, ?);
+  )SQL";
+
+  const bool is_device = row.kind == SnapshotRow::Kind::Device;
+  auto handle = db.Prepare(is_device ? device_sql : edge_sql, err);
+  if (!handle) {
+    return false;
+  }
+  sqlite3_stmt* stmt = handle.get();
+
+  int idx = 1;
+  bool ok = BindText(stmt, idx++, row.edge_id, err);
+  if (is_device) ok = ok && BindText(stmt, idx++, row.device_id, err);
+  ok = ok && BindInt64(stmt, idx++, row.ts_ms, err);
+  ok = ok && BindText(stmt, idx++, row.status_json, err);
+
+  return ok && StepDone(stmt, db.UnsafeHandle(), err);
+}
+
 bool StatusRepository::InsertDeviceSnapshot(const my_data::EdgeId& edge_id,
                                             const my_data::DeviceStatus& st,
                                             std::string* err) {
   auto& db = my_db::MyDB::GetInstance();
   std::lock_guard<std::mutex> lk(db.Mutex());
 
-  sqlite3* h = db.UnsafeHandle();
-  if (!h) {
+  if (!db.UnsafeHandle()) {
     if (err) *err = "db not initialized";
     return false;
   }
 
-  const char* sql = R"SQL(
-    INSERT INTO device_status_snapshots(edge_id, device_id, ts_ms, status_json)
-    VALUES(?, ?, ?, ?);
-  )SQL";
-
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
-    MYLOG_ERROR("[StatusRepo] InsertDeviceSnapshot prepare failed: {}", err ? *err : "");
+  std::string ierr;
+  if (!InsertRowLocked(db, SnapshotRow::Device(edge_id, st), &ierr)) {
+    if (err) *err = ierr;
+    MYLOG_ERROR("[StatusRepo] InsertDeviceSnapshot failed: {}", ierr);
     return false;
   }
 
-  std::string berr;
-  bool ok = true;
-  ok = ok && BindText(stmt, 1, edge_id, &berr);
-  ok = ok && BindText(stmt, 2, st.device_id, &berr);
-  ok = ok && BindInt64(stmt, 3, my_data::NowMs(), &berr);
-  ok = ok && BindText(stmt, 4, st.toString(), &berr);
+  MYLOG_DEBUG("[StatusRepo] InsertDeviceSnapshot ok: device_id={}", st.device_id);
+  return true;
+}
 
-  if (!ok) {
-    sqlite3_finalize(stmt);
-    if (err) *err = berr;
-    MYLOG_ERROR("[StatusRepo] InsertDeviceSnapshot bind failed: {}", berr);
+bool StatusRepository::InsertEdgeSnapshot(const my_data::EdgeStatus& st, std::string* err) {
+  auto& db = my_db::MyDB::GetInstance();
+  std::lock_guard<std::mutex> lk(db.Mutex());
+
+  if (!db.UnsafeHandle()) {
+    if (err) *err = "db not initialized";
     return false;
   }
 
-  std::string serr;
-  ok = StepDone(stmt, h, &serr);
-  sqlite3_finalize(stmt);
-
-  if (!ok) {
-    if (err) *err = serr;
-    MYLOG_ERROR("[StatusRepo] InsertDeviceSnapshot step failed: {}", serr);
+  std::string ierr;
+  if (!InsertRowLocked(db, SnapshotRow::Edge(st), &ierr)) {
+    if (err) *err = ierr;
+    MYLOG_ERROR("[StatusRepo] InsertEdgeSnapshot failed: {}", ierr);
     return false;
   }
 
-  MYLOG_DEBUG("[StatusRepo] InsertDeviceSnapshot ok: device_id={}", st.device_id);
+  MYLOG_DEBUG("[StatusRepo] InsertEdgeSnapshot ok: edge_id={}", st.edge_id);
   return true;
 }
 
-bool StatusRepository::InsertEdgeSnapshot(const my_data::EdgeStatus& st, std::string* err) {
+bool StatusRepository::InsertSnapshotBatch(const std::vector<SnapshotRow>& rows, std::string* err) {
+  if (rows.empty()) return true;
+
   auto& db = my_db::MyDB::GetInstance();
-  std::lock_guard<std::mutex> lk(db.Mutex());
+  // 整批一个事务：一次 fsync 提交所有行
+  bool ok = db.Transaction([&](std::string* txe) -> bool {
+    for (const auto& row : rows) {
+      if (!InsertRowLocked(db, row, txe)) return false;
+    }
+    return true;
+  }, err);
 
-  sqlite3* h = db.UnsafeHandle();
-  if (!h) {
-    if (err) *err = "db not initialized";
+  if (!ok) {
+    MYLOG_ERROR("[StatusRepo] InsertSnapshotBatch failed: rows={}, err={}", rows.size(), err ? *err : "");
     return false;
   }
+  MYLOG_DEBUG("[StatusRepo] InsertSnapshotBatch ok: rows={}", rows.size());
+  return true;
+}
 
-  const char* sql = R"SQL(
-    INSERT INTO edge_status_snapshots(edge_id, ts_ms, status_json)
-    VALUES(?, ?, ?);
+std::string SnapshotQuery::FormatCursor(std::int64_t ts_ms, std::int64_t id) {
+  return std::to_string(ts_ms) + ":" + std::to_string(id);
+}
+
+bool SnapshotQuery::ParseCursor(const std::string& cursor, std::int64_t* ts_ms, std::int64_t* id) {
+  const auto pos = cursor.find(':');
+  if (pos == std::string::npos || pos == 0 || pos + 1 >= cursor.size()) return false;
+  try {
+    std::size_t n1 = 0, n2 = 0;
+    const std::string ts_part = cursor.substr(0, pos);
+    const std::string id_part = cursor.substr(pos + 1);
+    const std::int64_t ts = std::stoll(ts_part, &n1);
+    const std::int64_t rid = std::stoll(id_part, &n2);
+    if (n1 != ts_part.size() || n2 != id_part.size()) return false;
+    if (ts_ms) *ts_ms = ts;
+    if (id) *id = rid;
+    return true;
+  } catch (const std::exception&) {
+    return false;
+  }
+}
+
+bool StatusRepository::QuerySnapshots(const SnapshotQuery& q, SnapshotPage* page, std::string* err) {
+  if (!page) {
+    if (err) *err = "page is null";
+    return false;
+  }
+  *page = SnapshotPage{};
+
+  const bool is_device = q.kind == SnapshotRow::Kind::Device;
+  if (is_device ? q.device_id.empty() : q.edge_id.empty()) {
+    if (err) *err = is_device ? "device_id required" : "edge_id required";
+    return false;
+  }
+  if (q.limit == 0 || q.from_ms >= q.to_ms) {
+    if (err) *err = "empty range or limit";
+    return false;
+  }
+  if (q.downsample == SnapshotQuery::Downsample::EveryNth && q.every_n < 1) {
+    if (err) *err = "every_n must be >= 1";
+    return false;
+  }
+  if (q.downsample == SnapshotQuery::Downsample::BucketLast && q.bucket_ms <= 0) {
+    if (err) *err = "bucket_ms must be > 0";
+    return false;
+  }
+
+  // keyset：从 (after_ts, after_id) 之后继续；首页为 (from_ms, -1)
+  std::int64_t after_ts = q.from_ms;
+  std::int64_t after_id = -1;
+  if (!q.cursor.empty() && !SnapshotQuery::ParseCursor(q.cursor, &after_ts, &after_id)) {
+    if (err) *err = "invalid cursor";
+    return false;
+  }
+  const std::size_t limit = std::min(q.limit, SnapshotQuery::kMaxLimit);
+  // 至少 2 行才能保证 BucketLast 翻页前进；不超过 kMaxScanRows
+  const std::size_t max_scan = std::clamp<std::size_t>(q.max_scan, 2, SnapshotQuery::kMaxScanRows);
+  // 索引区间下界直接取游标位置，翻页不再从 from_ms 重新扫描
+  const std::int64_t lower_ts = std::max(q.from_ms, after_ts);
+
+  static const std::string device_sql = R"SQL(
+    SELECT id, ts_ms, status_json, json_valid(status_json) FROM device_status_snapshots
+    WHERE device_id=?1 AND (?2 = '' OR edge_id=?2)
+      AND ts_ms >= ?3 AND ts_ms < ?4 AND (ts_ms > ?5 OR id > ?6)
+    ORDER BY ts_ms, id;
+  )SQL";
+  static const std::string edge_sql = R"SQL(
+    SELECT id, ts_ms, status_json, json_valid(status_json) FROM edge_status_snapshots
+    WHERE edge_id=?1
+      AND ts_ms >= ?3 AND ts_ms < ?4 AND (ts_ms > ?5 OR id > ?6)
+    ORDER BY ts_ms, id;
   )SQL";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
-    MYLOG_ERROR("[StatusRepo] InsertEdgeSnapshot prepare failed: {}", err ? *err : "");
+  auto reader = my_db::MyDB::GetInstance().AcquireReader(err);
+  if (!reader) {
     return false;
   }
+  sqlite3* h = reader.handle();
 
-  std::string berr;
-  bool ok = true;
-  ok = ok && BindText(stmt, 1, st.edge_id, &berr);
-  ok = ok && BindInt64(stmt, 2, my_data::NowMs(), &berr);
-  ok = ok && BindText(stmt, 3, st.toString(), &berr);
+  auto handle = reader.Prepare(is_device ? device_sql : edge_sql, err);
+  if (!handle) {
+    return false;
+  }
+  sqlite3_stmt* stmt = handle.get();
 
+  std::string berr;
+  bool ok = BindText(stmt, 1, is_device ? q.device_id : q.edge_id, &berr);
+  if (is_device) ok = ok && BindText(stmt, 2, q.edge_id, &berr);
+  ok = ok && BindInt64(stmt, 3, lower_ts, &berr);
+  ok = ok && BindInt64(stmt, 4, q.to_ms, &berr);
+  ok = ok && BindInt64(stmt, 5, after_ts, &berr);
+  ok = ok && BindInt64(stmt, 6, after_id, &berr);
   if (!ok) {
-    sqlite3_finalize(stmt);
     if (err) *err = berr;
-    MYLOG_ERROR("[StatusRepo] InsertEdgeSnapshot bind failed: {}", berr);
     return false;
   }
 
-  std::string serr;
-  ok = StepDone(stmt, h, &serr);
-  sqlite3_finalize(stmt);
+  // prev 为最后一条已消费的行：翻页时作为 next_cursor，下一页从其后继续
+  std::int64_t prev_ts = after_ts;
+  std::int64_t prev_id = after_id;
+  SnapshotRecord pending;
+  bool has_pending = false;
+  std::int64_t pending_bucket = 0;
+  // pending 之前最后一条已消费的行：扫描上限截断在桶中间时，下一页从 pending 重新开始
+  std::int64_t before_pending_ts = after_ts;
+  std::int64_t before_pending_id = after_id;
+
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    SnapshotRecord rec;
+    rec.id = sqlite3_column_int64(stmt, 0);
+    rec.ts_ms = sqlite3_column_int64(stmt, 1);
+
+    if (page->scanned >= max_scan) {
+      // 扫描上限：本行未消费，下一页从游标继续
+      page->has_more = true;
+      if (has_pending) {
+        if ((rec.ts_ms / q.bucket_ms) * q.bucket_ms != pending_bucket && page->rows.size() < limit) {
+          // 下一行已进入新桶，pending 即为本桶最后一行
+          page->rows.push_back(std::move(pending));
+        } else {
+          // 桶未结束：丢弃 pending，下一页从它开始重新扫描本桶剩余部分
+          prev_ts = before_pending_ts;
+          prev_id = before_pending_id;
+        }
+        has_pending = false;
+      }
+      break;
+    }
+
+    const unsigned char* txt = sqlite3_column_text(stmt, 2);
+    rec.status_json = txt ? reinterpret_cast<const char*>(txt) : "";
+    rec.is_json = sqlite3_column_int(stmt, 3) != 0;
+    ++page->scanned;
+
+    if (q.downsample == SnapshotQuery::Downsample::BucketLast) {
+      const std::int64_t bucket = (rec.ts_ms / q.bucket_ms) * q.bucket_ms;
+      if (has_pending && bucket != pending_bucket) {
+        page->rows.push_back(std::move(pending));
+        has_pending = false;
+        if (page->rows.size() >= limit) {
+          page->has_more = true;
+          break;
+        }
+      }
+      pending_bucket = bucket;
+      before_pending_ts = prev_ts;
+      before_pending_id = prev_id;
+      pending = std::move(rec);
+      has_pending = true;
+      prev_ts = pending.ts_ms;
+      prev_id = pending.id;
+      continue;
+    }
+
+    const bool keep = q.downsample == SnapshotQuery::Downsample::None ||
+                      (static_cast<std::int64_t>(page->scanned) - 1) % q.every_n == 0;
+    if (keep) {
+      if (page->rows.size() >= limit) {
+        page->has_more = true;
+        break;
+      }
+      page->rows.push_back(rec);
+    }
+    prev_ts = rec.ts_ms;
+    prev_id = rec.id;
+  }
 
-  if (!ok) {
-    if (err) *err = serr;
-    MYLOG_ERROR("[StatusRepo] InsertEdgeSnapshot step failed: {}", serr);
+  if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+    if (err) *err = sqlite3_errmsg(h);
     return false;
   }
+  if (has_pending) {
+    page->rows.push_back(std::move(pending));
+  }
+  if (page->has_more) {
+    page->next_cursor = SnapshotQuery::FormatCursor(prev_ts, prev_id);
+  }
 
-  MYLOG_DEBUG("[StatusRepo] InsertEdgeSnapshot ok: edge_id={}", st.edge_id);
+  MYLOG_DEBUG("[StatusRepo] QuerySnapshots: rows={}, scanned={}, has_more={}",
+              page->rows.size(), page->scanned, page->has_more);
   return true;
 }
 
 bool StatusRepository::CountEdgeSnapshots(const my_data::EdgeId& edge_id, std::int64_t* out_cnt, std::string* err) {
   if (out_cnt) *out_cnt = 0;
 
-  auto& db = my_db::MyDB::GetInstance();
-  std::lock_guard<std::mutex> lk(db.Mutex());
-
-  sqlite3* h = db.UnsafeHandle();
-  if (!h) {
-    if (err) *err = "db not initialized";
+  auto reader = my_db::MyDB::GetInstance().AcquireReader(err);
+  if (!reader) {
     return false;
   }
+  sqlite3* h = reader.handle();
 
-  const char* sql = "SELECT COUNT(1) FROM edge_status_snapshots WHERE edge_id=?;";
-  sqlite3_stmt* stmt = nullptr;
-
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
+  static const std::string sql = "SELECT COUNT(1) FROM edge_status_snapshots WHERE edge_id=?;";
+  auto handle = reader.Prepare(sql, err);
+  if (!handle) {
     return false;
   }
+  sqlite3_stmt* stmt = handle.get();
 
   std::string berr;
   if (!BindText(stmt, 1, edge_id, &berr)) {
-    sqlite3_finalize(stmt);
     if (err) *err = berr;
     return false;
   }
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   if (rc == SQLITE_ROW) {
     if (out_cnt) *out_cnt = sqlite3_column_int64(stmt, 0);
-    sqlite3_finalize(stmt);
     return true;
   }
 
   if (err) *err = sqlite3_errmsg(h);
-  sqlite3_finalize(stmt);
   return false;
 }
 
@@ -181,40 +345,32 @@ bool StatusRepository::CountDeviceSnapshots(const my_data::EdgeId& edge_id, cons
                                             std::int64_t* out_cnt, std::string* err) {
   if (out_cnt) *out_cnt = 0;
 
-  auto& db = my_db::MyDB::GetInstance();
-  std::lock_guard<std::mutex> lk(db.Mutex());
-
-  sqlite3* h = db.UnsafeHandle();
-  if (!h) {
-    if (err) *err = "db not initialized";
+  auto reader = my_db::MyDB::GetInstance().AcquireReader(err);
+  if (!reader) {
     return false;
   }
+  sqlite3* h = reader.handle();
 
-  const char* sql = "SELECT COUNT(1) FROM device_status_snapshots WHERE edge_id=? AND device_id=?;";
-  sqlite3_stmt* stmt = nullptr;
-
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
+  static const std::string sql = "SELECT COUNT(1) FROM device_status_snapshots WHERE edge_id=? AND device_id=?;";
+  auto handle = reader.Prepare(sql, err);
+  if (!handle) {
     return false;
   }
+  sqlite3_stmt* stmt = handle.get();
 
   std::string berr;
   if (!BindText(stmt, 1, edge_id, &berr) || !BindText(stmt, 2, device_id, &berr)) {
-    sqlite3_finalize(stmt);
     if (err) *err = berr;
     return false;
   }
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   if (rc == SQLITE_ROW) {
     if (out_cnt) *out_cnt = sqlite3_column_int64(stmt, 0);
-    sqlite3_finalize(stmt);
     return true;
   }
 
   if (err) *err = sqlite3_errmsg(h);
-  sqlite3_finalize(stmt);
   return false;
 }
 
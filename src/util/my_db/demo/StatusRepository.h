@@ -1,7 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
+#include <limits>
 #include <string>
+#include <vector>
 
 #include "MyDB.h"
 #include "MyData.h"
@@ -9,6 +12,71 @@
 
 namespace my_db::demo {
 
+// 一行待写入的状态快照（status_json 已在调用方线程序列化）
+struct SnapshotRow {
+  enum class Kind { Edge, Device };
+
+  Kind kind{Kind::Device};
+  my_data::EdgeId edge_id;
+  my_data::DeviceId device_id;  // 仅 Device
+  std::int64_t ts_ms{0};
+  std::string status_json;
+
+  static SnapshotRow Device(const my_data::EdgeId& edge_id, const my_data::DeviceStatus& st) {
+    return SnapshotRow{Kind::Device, edge_id, st.device_id, my_data::NowMs(), st.toJson().dump()};
+  }
+  static SnapshotRow Edge(const my_data::EdgeStatus& st) {
+    return SnapshotRow{Kind::Edge, st.edge_id, {}, my_data::NowMs(), st.toJson().dump()};
+  }
+};
+
+// 时间区间快照查询：按 (ts_ms, id) keyset 分页，走 (device_id, ts_ms) / (edge_id, ts_ms) 索引
+struct SnapshotQuery {
+  enum class Downsample {
+    None,        // 全部行
+    EveryNth,    // 每 every_n 行取第一行
+    BucketLast,  // 每个 bucket_ms 时间桶取最后一行
+  };
+
+  SnapshotRow::Kind kind{SnapshotRow::Kind::Device};
+  my_data::EdgeId edge_id;      // Edge 必填；Device 可选（为空则不过滤）
+  my_data::DeviceId device_id;  // Device 必填
+
+  std::int64_t from_ms{0};                                       // 含
+  std::int64_t to_ms{std::numeric_limits<std::int64_t>::max()};  // 不含
+  std::size_t limit{500};                                        // 每页最多返回行数
+  std::string cursor;  // 上一页的 next_cursor，空表示从 from_ms 开始
+
+  Downsample downsample{Downsample::None};
+  std::int64_t every_n{1};
+  std::int64_t bucket_ms{0};
+
+  // 单页最多扫描的原始行数：降采样时返回行远少于扫描行，达到上限即结束本页并返回游标
+  // （此时 rows 可能为空而 has_more 为 true，调用方继续翻页即可）
+  std::size_t max_scan{kMaxScanRows};
+
+  static constexpr std::size_t kMaxLimit = 5000;
+  static constexpr std::size_t kMaxScanRows = 50000;
+
+  // 游标格式 "<ts_ms>:<id>"
+  static std::string FormatCursor(std::int64_t ts_ms, std::int64_t id);
+  static bool ParseCursor(const std::string& cursor, std::int64_t* ts_ms, std::int64_t* id);
+};
+
+struct SnapshotRecord {
+  std::int64_t id{0};
+  std::int64_t ts_ms{0};
+  std::string status_json;
+  bool is_json{false};  // status_json 是否为合法 JSON（早期行是 toString() 文本）
+};
+
+struct SnapshotPage {
+  std::vector<SnapshotRecord> rows;
+  std::size_t scanned{0};  // 降采样前扫描的行数
+  bool has_more{false};
+  std::string next_cursor;
+};
+
 class StatusRepository {
 public:
   static StatusRepository& GetInstance();
@@ -19,6 +87,12 @@ public:
 
   bool InsertEdgeSnapshot(const my_data::EdgeStatus& st, std::string* err);
 
+  // 在一个事务内写入一批快照（供 StatusSnapshotWriter 组提交使用）
+  bool InsertSnapshotBatch(const std::vector<SnapshotRow>& rows, std::string* err);
+
+  // 时间区间查询（只读连接）；参数错误或游标非法时返回 false
+  bool QuerySnapshots(const SnapshotQuery& q, SnapshotPage* page, std::string* err);
+
   // 为测试/观测提供：计数查询
   bool CountEdgeSnapshots(const my_data::EdgeId& edge_id, std::int64_t* out_cnt, std::string* err);
   bool CountDeviceSnapshots(const my_data::EdgeId& edge_id, const my_data::DeviceId& device_id,
@@ -0,0 +1,218 @@
+#include "StatusSnapshotWriter.h"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "MyDB.h"
+#include "MyLog.h"
+
+namespace my_db::demo {
+
+nlohmann::json ToJson(const SnapshotWriterStats& stats) {
+  return {
+      {"enqueued", stats.enqueued},
+      {"dropped", stats.dropped},
+      {"committed_rows", stats.committed_rows},
+      {"failed_rows", stats.failed_rows},
+      {"queue_depth", stats.queue_depth},
+      {"batch", {{"count", stats.batches},
+                 {"last_rows", stats.last_batch_rows},
+                 {"max_rows", stats.max_batch_rows}}},
+      {"commit_us", {{"last", stats.last_commit_us},
+                     {"max", stats.max_commit_us},
+                     {"avg", stats.avg_commit_us}}},
+  };
+}
+
+StatusSnapshotWriter& StatusSnapshotWriter::GetInstance() {
+  static StatusSnapshotWriter inst;
+  return inst;
+}
+
+StatusSnapshotWriter::StatusSnapshotWriter() {
+  // 先构造 MyDB 单例，保证析构时 MyDB 晚于 writer 销毁（Stop 需要写库）
+  (void)my_db::MyDB::GetInstance();
+}
+
+StatusSnapshotWriter::~StatusSnapshotWriter() {
+  Stop();
+}
+
+bool StatusSnapshotWriter::Start(std::string* err) {
+  auto& db = my_db::MyDB::GetInstance();
+  if (!db.IsInitialized()) {
+    if (err) *err = "db not initialized";
+    return false;
+  }
+  const DBConfig cfg = db.Config();
+
+  std::lock_guard<std::mutex> lk(mu_);
+  if (running_) {
+    return true;
+  }
+
+  batch_max_rows_ = static_cast<std::size_t>(std::max(1, cfg.snapshot_batch_max_rows));
+  batch_interval_ = std::chrono::milliseconds(std::max(0, cfg.snapshot_batch_interval_ms));
+  queue_capacity_ = static_cast<std::size_t>(std::max(1, cfg.snapshot_queue_capacity));
+
+  stop_ = false;
+  running_ = true;
+  worker_ = std::thread(&StatusSnapshotWriter::Loop, this);
+
+  MYLOG_INFO("[SnapshotWriter] Start: batch_max_rows={}, batch_interval_ms={}, queue_capacity={}",
+             batch_max_rows_, batch_interval_.count(), queue_capacity_);
+  return true;
+}
+
+void StatusSnapshotWriter::Stop() {
+  std::thread worker;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!running_) {
+      return;
+    }
+    stop_ = true;
+    worker = std::move(worker_);
+  }
+  cv_.notify_all();
+  if (worker.joinable()) {
+    worker.join();
+  }
+
+  std::lock_guard<std::mutex> lk(mu_);
+  running_ = false;
+  MYLOG_INFO("[SnapshotWriter] Stopped: committed_rows={}, failed_rows={}, dropped={}",
+             committed_rows_.load(), failed_rows_.load(), dropped_.load());
+}
+
+bool StatusSnapshotWriter::IsRunning() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return running_ && !stop_;
+}
+
+bool StatusSnapshotWriter::Enqueue(SnapshotRow row, std::future<bool>* done) {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!running_ || stop_ || queue_.size() >= queue_capacity_) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    Pending p{std::move(row), std::nullopt};
+    if (done) {
+      p.done.emplace();
+      *done = p.done->get_future();
+    }
+    if (queue_.empty()) {
+      first_pending_at_ = Clock::now();
+    }
+    queue_.push_back(std::move(p));
+
+    // 攒满一批才唤醒；不足一批由 writer 按首行时间超时提交
+    if (queue_.size() >= batch_max_rows_ || queue_.size() == 1) {
+      cv_.notify_one();
+    }
+  }
+  enqueued_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+bool StatusSnapshotWriter::EnqueueEdgeSnapshot(const my_data::EdgeStatus& st, std::future<bool>* done) {
+  return Enqueue(SnapshotRow::Edge(st), done);
+}
+
+bool StatusSnapshotWriter::EnqueueDeviceSnapshot(const my_data::EdgeId& edge_id,
+                                                 const my_data::DeviceStatus& st,
+                                                 std::future<bool>* done) {
+  return Enqueue(SnapshotRow::Device(edge_id, st), done);
+}
+
+void StatusSnapshotWriter::Loop() {
+  MYLOG_INFO("[SnapshotWriter] Loop enter");
+
+  std::deque<Pending> batch;
+  std::unique_lock<std::mutex> lk(mu_);
+  while (true) {
+    cv_.wait(lk, [&] { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      break;  // stop_ 且已写完
+    }
+
+    if (!stop_ && queue_.size() < batch_max_rows_) {
+      cv_.wait_until(lk, first_pending_at_ + batch_interval_,
+                     [&] { return stop_ || queue_.size() >= batch_max_rows_; });
+    }
+
+    const std::size_t n = std::min(queue_.size(), batch_max_rows_);
+    batch.clear();
+    std::move(queue_.begin(), queue_.begin() + static_cast<std::ptrdiff_t>(n), std::back_inserter(batch));
+    queue_.erase(queue_.begin(), queue_.begin() + static_cast<std::ptrdiff_t>(n));
+    if (!queue_.empty()) {
+      first_pending_at_ = Clock::now();
+    }
+
+    lk.unlock();
+    CommitBatch(batch);
+    lk.lock();
+  }
+
+  MYLOG_INFO("[SnapshotWriter] Loop exit");
+}
+
+void StatusSnapshotWriter::CommitBatch(std::deque<Pending>& batch) {
+  std::vector<SnapshotRow> rows;
+  rows.reserve(batch.size());
+  for (auto& p : batch) {
+    rows.push_back(std::move(p.row));
+  }
+
+  const auto t0 = Clock::now();
+  std::string err;
+  const bool ok = StatusRepository::GetInstance().InsertSnapshotBatch(rows, &err);
+  const std::int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0).count();
+
+  batches_.fetch_add(1, std::memory_order_relaxed);
+  last_batch_rows_.store(rows.size(), std::memory_order_relaxed);
+  if (rows.size() > max_batch_rows_.load(std::memory_order_relaxed)) {
+    max_batch_rows_.store(rows.size(), std::memory_order_relaxed);
+  }
+  last_commit_us_.store(us, std::memory_order_relaxed);
+  total_commit_us_.fetch_add(us, std::memory_order_relaxed);
+  if (us > max_commit_us_.load(std::memory_order_relaxed)) {
+    max_commit_us_.store(us, std::memory_order_relaxed);
+  }
+
+  if (ok) {
+    committed_rows_.fetch_add(rows.size(), std::memory_order_relaxed);
+    MYLOG_DEBUG("[SnapshotWriter] batch committed: rows={}, commit_us={}", rows.size(), us);
+  } else {
+    failed_rows_.fetch_add(rows.size(), std::memory_order_relaxed);
+    MYLOG_ERROR("[SnapshotWriter] batch failed: rows={}, err={}", rows.size(), err);
+  }
+
+  for (auto& p : batch) {
+    if (p.done) p.done->set_value(ok);
+  }
+}
+
+SnapshotWriterStats StatusSnapshotWriter::Stats() const {
+  SnapshotWriterStats s;
+  s.enqueued = enqueued_.load(std::memory_order_relaxed);
+  s.dropped = dropped_.load(std::memory_order_relaxed);
+  s.committed_rows = committed_rows_.load(std::memory_order_relaxed);
+  s.failed_rows = failed_rows_.load(std::memory_order_relaxed);
+  s.batches = batches_.load(std::memory_order_relaxed);
+  s.last_batch_rows = last_batch_rows_.load(std::memory_order_relaxed);
+  s.max_batch_rows = max_batch_rows_.load(std::memory_order_relaxed);
+  s.last_commit_us = last_commit_us_.load(std::memory_order_relaxed);
+  s.max_commit_us = max_commit_us_.load(std::memory_order_relaxed);
+  s.avg_commit_us = s.batches ? total_commit_us_.load(std::memory_order_relaxed) / static_cast<std::int64_t>(s.batches) : 0;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    s.queue_depth = queue_.size();
+  }
+  return s;
+}
+
+} // namespace my_db::demo
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+#include "MyData.h"
+#include "demo/StatusRepository.h"
+
+namespace my_db::demo {
+
+struct SnapshotWriterStats {
+  std::uint64_t enqueued{0};
+  std::uint64_t dropped{0};        // 队列满或 writer 未运行
+  std::uint64_t committed_rows{0};
+  std::uint64_t failed_rows{0};
+  std::uint64_t batches{0};
+
+  std::size_t queue_depth{0};
+  std::size_t last_batch_rows{0};
+  std::size_t max_batch_rows{0};
+
+  std::int64_t last_commit_us{0};
+  std::int64_t max_commit_us{0};
+  std::int64_t avg_commit_us{0};
+};
+
+// 运行时状态 JSON（Edge 的 GetRunTimeStatusInfo 中以 "snapshot_writer" 暴露）
+nlohmann::json ToJson(const SnapshotWriterStats& stats);
+
+// 状态快照后台写入器（组提交）：
+// - 调用方只做序列化与入队，不再持有 MyDB 锁等待 fsync
+// - 后台线程攒满 snapshot_batch_max_rows 行，或首行等待超过 snapshot_batch_interval_ms，
+//   即以一个事务写入整批
+// - 队列有界（snapshot_queue_capacity），满时丢弃新快照并计数
+class StatusSnapshotWriter {
+public:
+  static StatusSnapshotWriter& GetInstance();
+
+  StatusSnapshotWriter(const StatusSnapshotWriter&) = delete;
+  StatusSnapshotWriter& operator=(const StatusSnapshotWriter&) = delete;
+
+  // 按 MyDB::Config() 的批量参数启动后台线程；已运行时直接返回 true
+  bool Start(std::string* err);
+  // 停止并把队列中剩余快照全部写完
+  void Stop();
+  bool IsRunning() const;
+
+  // 入队（fire-and-forget）；done 非空时返回该行所在批次的提交结果。
+  // 返回 false 表示被丢弃，此时 done 不会被设置。
+  bool Enqueue(SnapshotRow row, std::future<bool>* done = nullptr);
+  bool EnqueueEdgeSnapshot(const my_data::EdgeStatus& st, std::future<bool>* done = nullptr);
+  bool EnqueueDeviceSnapshot(const my_data::EdgeId& edge_id, const my_data::DeviceStatus& st,
+                             std::future<bool>* done = nullptr);
+
+  SnapshotWriterStats Stats() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Pending {
+    SnapshotRow row;
+    std::optional<std::promise<bool>> done;
+  };
+
+  StatusSnapshotWriter();
+  ~StatusSnapshotWriter();
+
+  void Loop();
+  void CommitBatch(std::deque<Pending>& batch);
+
+private:
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Pending> queue_;
+  Clock::time_point first_pending_at_{};
+  bool running_{false};
+  bool stop_{false};
+  std::thread worker_;
+
+  std::size_t batch_max_rows_{256};
+  std::chrono::milliseconds batch_interval_{200};
+  std::size_t queue_capacity_{8192};
+
+  std::atomic<std::uint64_t> enqueued_{0};
+  std::atomic<std::uint64_t> dropped_{0};
+  std::atomic<std::uint64_t> committed_rows_{0};
+  std::atomic<std::uint64_t> failed_rows_{0};
+  std::atomic<std::uint64_t> batches_{0};
+  std::atomic<std::size_t> last_batch_rows_{0};
+  std::atomic<std::size_t> max_batch_rows_{0};
+  std::atomic<std::int64_t> last_commit_us_{0};
+  std::atomic<std::int64_t> max_commit_us_{0};
+  std::atomic<std::int64_t> total_commit_us_{0};
+};
+
+} // namespace my_db::demo
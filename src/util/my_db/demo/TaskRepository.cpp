@@ -46,9 +46,9 @@ bool TaskRepository::UpsertTask(const my_data::Task& task, std::string* err) {
     return false;
   }
 
-  const char* sql = R"SQL(
-    INSERT INTO tasks(task_id, command_id, edge_id, device_id, capability, action, state, created_at_ms, deadline_at_ms, task_json)
-    VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+  static const std::string sql = R"SQL(
+    INSERT INTO tasks(task_id, command_id, edge_id, device_id, capability, action, state, created_at_ms, deadline_at_ms, task_json, task_seq)
+    VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
     ON CONFLICT(task_id) DO UPDATE SET
       command_id=excluded.command_id,
       edge_id=excluded.edge_id,
@@ -58,16 +58,16 @@ bool TaskRepository::UpsertTask(const my_data::Task& task, std::string* err) {
       state=excluded.state,
       created_at_ms=excluded.created_at_ms,
       deadline_at_ms=excluded.deadline_at_ms,
-      task_json=excluded.task_json;
+      task_json=excluded.task_json,
+      task_seq=excluded.task_seq;
   )SQL";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
+  auto handle = db.Prepare(sql, err);
+  if (!handle) {
     MYLOG_ERROR("[TaskRepo] UpsertTask prepare failed: err={}", err ? *err : "");
     return false;
   }
+  sqlite3_stmt* stmt = handle.get();
 
   std::string berr;
   bool ok = true;
@@ -82,8 +82,16 @@ bool TaskRepository::UpsertTask(const my_data::Task& task, std::string* err) {
   ok = ok && BindInt64(stmt, 9, task.deadline_at_ms, &berr);
   ok = ok && BindText(stmt, 10, task.toString(), &berr);
 
+  // 非 GenerateId 生成的 task_id（外部传入）task_seq 为 NULL
+  my_data::Id64 seq = 0;
+  if (my_data::ParseGeneratedId(task.task_id, &seq)) {
+    ok = ok && BindInt64(stmt, 11, static_cast<std::int64_t>(seq), &berr);
+  } else if (ok && sqlite3_bind_null(stmt, 11) != SQLITE_OK) {
+    berr = "sqlite3_bind_null failed";
+    ok = false;
+  }
+
   if (!ok) {
-    sqlite3_finalize(stmt);
     if (err) *err = berr;
     MYLOG_ERROR("[TaskRepo] UpsertTask bind failed: {}", berr);
     return false;
@@ -91,7 +99,6 @@ bool TaskRepository::UpsertTask(const my_data::Task& task, std::string* err) {
 
   std::string serr;
   ok = StepDone(stmt, h, &serr);
-  sqlite3_finalize(stmt);
 
   if (!ok) {
     if (err) *err = serr;
@@ -114,7 +121,7 @@ bool TaskRepository::UpsertResult(const my_data::TaskId& task_id, const my_data:
     return false;
   }
 
-  const char* sql = R"SQL(
+  static const std::string sql = R"SQL(
     INSERT INTO task_results(task_id, code, message, started_at_ms, finished_at_ms, result_json)
     VALUES(?, ?, ?, ?, ?, ?)
     ON CONFLICT(task_id) DO UPDATE SET
@@ -125,13 +132,12 @@ bool TaskRepository::UpsertResult(const my_data::TaskId& task_id, const my_data:
       result_json=excluded.result_json;
   )SQL";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
+  auto handle = db.Prepare(sql, err);
+  if (!handle) {
     MYLOG_ERROR("[TaskRepo] UpsertResult prepare failed: err={}", err ? *err : "");
     return false;
   }
+  sqlite3_stmt* stmt = handle.get();
 
   std::string berr;
   bool ok = true;
@@ -143,7 +149,6 @@ bool TaskRepository::UpsertResult(const my_data::TaskId& task_id, const my_data:
   ok = ok && BindText(stmt, 6, r.toString(), &berr);
 
   if (!ok) {
-    sqlite3_finalize(stmt);
     if (err) *err = berr;
     MYLOG_ERROR("[TaskRepo] UpsertResult bind failed: {}", berr);
     return false;
@@ -151,7 +156,6 @@ bool TaskRepository::UpsertResult(const my_data::TaskId& task_id, const my_data:
 
   std::string serr;
   ok = StepDone(stmt, h, &serr);
-  sqlite3_finalize(stmt);
 
   if (!ok) {
     if (err) *err = serr;
@@ -166,133 +170,109 @@ bool TaskRepository::UpsertResult(const my_data::TaskId& task_id, const my_data:
 bool TaskRepository::ExistsTask(const my_data::TaskId& task_id, bool* exists, std::string* err) {
   if (exists) *exists = false;
 
-  auto& db = my_db::MyDB::GetInstance();
-  std::lock_guard<std::mutex> lk(db.Mutex());
-
-  sqlite3* h = db.UnsafeHandle();
-  if (!h) {
-    if (err) *err = "db not initialized";
+  auto reader = my_db::MyDB::GetInstance().AcquireReader(err);
+  if (!reader) {
     return false;
   }
+  sqlite3* h = reader.handle();
 
-  const char* sql = "SELECT 1 FROM tasks WHERE task_id=? LIMIT 1;";
-  sqlite3_stmt* stmt = nullptr;
-
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
+  static const std::string sql = "SELECT 1 FROM tasks WHERE task_id=? LIMIT 1;";
+  auto handle = reader.Prepare(sql, err);
+  if (!handle) {
     return false;
   }
+  sqlite3_stmt* stmt = handle.get();
 
   std::string berr;
   if (!BindText(stmt, 1, task_id, &berr)) {
-    sqlite3_finalize(stmt);
     if (err) *err = berr;
     return false;
   }
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   if (rc == SQLITE_ROW) {
     if (exists) *exists = true;
   } else if (rc == SQLITE_DONE) {
     if (exists) *exists = false;
   } else {
     if (err) *err = sqlite3_errmsg(h);
-    sqlite3_finalize(stmt);
     return false;
   }
 
-  sqlite3_finalize(stmt);
   return true;
 }
 
 bool TaskRepository::GetTaskJson(const my_data::TaskId& task_id, std::string* out_task_json, std::string* err) {
   if (out_task_json) out_task_json->clear();
 
-  auto& db = my_db::MyDB::GetInstance();
-  std::lock_guard<std::mutex> lk(db.Mutex());
-
-  sqlite3* h = db.UnsafeHandle();
-  if (!h) {
-    if (err) *err = "db not initialized";
+  auto reader = my_db::MyDB::GetInstance().AcquireReader(err);
+  if (!reader) {
     return false;
   }
+  sqlite3* h = reader.handle();
 
-  const char* sql = "SELECT task_json FROM tasks WHERE task_id=? LIMIT 1;";
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
+  static const std::string sql = "SELECT task_json FROM tasks WHERE task_id=? LIMIT 1;";
+  auto handle = reader.Prepare(sql, err);
+  if (!handle) {
     return false;
   }
+  sqlite3_stmt* stmt = handle.get();
 
   std::string berr;
   if (!BindText(stmt, 1, task_id, &berr)) {
-    sqlite3_finalize(stmt);
     if (err) *err = berr;
     return false;
   }
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   if (rc == SQLITE_ROW) {
     const unsigned char* txt = sqlite3_column_text(stmt, 0);
     if (out_task_json) *out_task_json = txt ? reinterpret_cast<const char*>(txt) : "";
-    sqlite3_finalize(stmt);
     return true;
   }
   if (rc == SQLITE_DONE) {
     if (err) *err = "not found";
-    sqlite3_finalize(stmt);
     return false;
   }
 
   if (err) *err = sqlite3_errmsg(h);
-  sqlite3_finalize(stmt);
   return false;
 }
 
 bool TaskRepository::GetResultJson(const my_data::TaskId& task_id, std::string* out_result_json, std::string* err) {
   if (out_result_json) out_result_json->clear();
 
-  auto& db = my_db::MyDB::GetInstance();
-  std::lock_guard<std::mutex> lk(db.Mutex());
-
-  sqlite3* h = db.UnsafeHandle();
-  if (!h) {
-    if (err) *err = "db not initialized";
+  auto reader = my_db::MyDB::GetInstance().AcquireReader(err);
+  if (!reader) {
     return false;
   }
+  sqlite3* h = reader.handle();
 
-  const char* sql = "SELECT result_json FROM task_results WHERE task_id=? LIMIT 1;";
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
+  static const std::string sql = "SELECT result_json FROM task_results WHERE task_id=? LIMIT 1;";
+  auto handle = reader.Prepare(sql, err);
+  if (!handle) {
     return false;
   }
+  sqlite3_stmt* stmt = handle.get();
 
   std::string berr;
   if (!BindText(stmt, 1, task_id, &berr)) {
-    sqlite3_finalize(stmt);
     if (err) *err = berr;
     return false;
   }
 
-  rc = sqlite3_step(stmt);
+  int rc = sqlite3_step(stmt);
   if (rc == SQLITE_ROW) {
     const unsigned char* txt = sqlite3_column_text(stmt, 0);
     if (out_result_json) *out_result_json = txt ? reinterpret_cast<const char*>(txt) : "";
-    sqlite3_finalize(stmt);
     return true;
   }
   if (rc == SQLITE_DONE) {
     if (err) *err = "not found";
-    sqlite3_finalize(stmt);
     return false;
   }
 
   if (err) *err = sqlite3_errmsg(h);
-  sqlite3_finalize(stmt);
   return false;
 }
 
@@ -306,14 +286,12 @@ bool TaskRepository::UpdateTaskState(const my_data::TaskId& task_id, my_data::Ta
     return false;
   }
 
-  const char* sql = "UPDATE tasks SET state=? WHERE task_id=?;";
-  sqlite3_stmt* stmt = nullptr;
-
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
+  static const std::string sql = "UPDATE tasks SET state=? WHERE task_id=?;";
+  auto handle = db.Prepare(sql, err);
+  if (!handle) {
     return false;
   }
+  sqlite3_stmt* stmt = handle.get();
 
   std::string berr;
   bool ok = true;
@@ -321,14 +299,12 @@ bool TaskRepository::UpdateTaskState(const my_data::TaskId& task_id, my_data::Ta
   ok = ok && BindText(stmt, 2, task_id, &berr);
 
   if (!ok) {
-    sqlite3_finalize(stmt);
     if (err) *err = berr;
     return false;
   }
 
   std::string serr;
   ok = StepDone(stmt, h, &serr);
-  sqlite3_finalize(stmt);
 
   if (!ok) {
     if (err) *err = serr;
@@ -349,25 +325,21 @@ bool TaskRepository::DeleteTask(const my_data::TaskId& task_id, std::string* err
     return false;
   }
 
-  const char* sql = "DELETE FROM tasks WHERE task_id=?;";
-  sqlite3_stmt* stmt = nullptr;
-
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
+  static const std::string sql = "DELETE FROM tasks WHERE task_id=?;";
+  auto handle = db.Prepare(sql, err);
+  if (!handle) {
     return false;
   }
+  sqlite3_stmt* stmt = handle.get();
 
   std::string berr;
   if (!BindText(stmt, 1, task_id, &berr)) {
-    sqlite3_finalize(stmt);
     if (err) *err = berr;
     return false;
   }
 
   std::string serr;
   bool ok = StepDone(stmt, h, &serr);
-  sqlite3_finalize(stmt);
 
   if (!ok) {
     if (err) *err = serr;
@@ -378,4 +350,46 @@ bool TaskRepository::DeleteTask(const my_data::TaskId& task_id, std::string* err
   return true;
 }
 
-} // namespace my_db::demo
\ No newline at end of file
+bool TaskRepository::ListTaskIdsAfter(my_data::Id64 after_seq, std::size_t limit,
+                                      std::vector<my_data::TaskId>* out, std::string* err) {
+  if (!out) {
+    if (err) *err = "out is null";
+    return false;
+  }
+  out->clear();
+
+  auto reader = my_db::MyDB::GetInstance().AcquireReader(err);
+  if (!reader) {
+    return false;
+  }
+  sqlite3* h = reader.handle();
+
+  static const std::string sql =
+      "SELECT task_id FROM tasks WHERE task_seq > ? ORDER BY task_seq LIMIT ?;";
+  auto handle = reader.Prepare(sql, err);
+  if (!handle) {
+    return false;
+  }
+  sqlite3_stmt* stmt = handle.get();
+
+  std::string berr;
+  bool ok = BindInt64(stmt, 1, static_cast<std::int64_t>(after_seq), &berr);
+  ok = ok && BindInt64(stmt, 2, static_cast<std::int64_t>(limit), &berr);
+  if (!ok) {
+    if (err) *err = berr;
+    return false;
+  }
+
+  int rc = SQLITE_ROW;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    const unsigned char* txt = sqlite3_column_text(stmt, 0);
+    out->emplace_back(txt ? reinterpret_cast<const char*>(txt) : "");
+  }
+  if (rc != SQLITE_DONE) {
+    if (err) *err = sqlite3_errmsg(h);
+    return false;
+  }
+  return true;
+}
+
+} // namespace my_db::demo
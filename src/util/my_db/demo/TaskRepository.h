@@ -2,6 +2,7 @@
 
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "MyDB.h"
 #include "MyData.h"
@@ -27,6 +28,10 @@ public:
   // 删除任务（results 通过外键 ON DELETE CASCADE 自动删除）
   bool DeleteTask(const my_data::TaskId& task_id, std::string* err);
 
+  // 按 task_seq（GenerateId 的 64 位值，时间有序）增量列出 task_id：task_seq > after_seq，升序
+  bool ListTaskIdsAfter(my_data::Id64 after_seq, std::size_t limit,
+                        std::vector<my_data::TaskId>* out, std::string* err);
+
 private:
   TaskRepository() = default;
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <nlohmann/json.hpp>
 #include <string>
 
@@ -63,6 +64,13 @@ public:
    */
   virtual my_data::DeviceStatus GetStatusSnapshot() const = 0;
 
+  /**
+   * @brief 状态版本号：状态每变化一次递增（无锁读取）
+   *
+   * Edge 只在版本号变化时重新调用 GetStatusSnapshot；返回 0 表示设备不发布版本号，Edge 每次都重新读取。
+   */
+  virtual std::uint64_t StatusVersion() const { return 0; }
+
   /**
    * @brief 设备ID
    */
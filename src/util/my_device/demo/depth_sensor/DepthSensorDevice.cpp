@@ -14,6 +14,7 @@ DepthSensorDevice::DepthSensorDevice() {
     status_.running_task_id = "";
     status_.last_error = "";
     status_.last_seen_at_ms = my_data::NowMs();
+    status_pub_.Publish(status_);
   }
   MYLOG_INFO("[Device:{}] 构造完成 (DepthSensorDevice)", device_id_);
 }
@@ -63,12 +64,20 @@ bool DepthSensorDevice::Init(const nlohmann::json& cfg, std::string* err) {
     device_id_ = cfg.value("device_id", device_id_);
     device_name_ = cfg.value("device_name", device_name_);
 
+    const std::string mode_str = cfg.value("workflow_mode", std::string("thread"));
+    if (!my_control::demo::ParseWorkflowMode(mode_str, &workflow_mode_)) {
+      if (err) *err = "invalid workflow_mode: " + mode_str;
+      MYLOG_ERROR("[Device:{}] Init 失败：workflow_mode 非法（thread|pooled），got={}", device_id_, mode_str);
+      return false;
+    }
+
     {
       std::lock_guard<std::mutex> lk(status_mu_);
       status_.device_id = device_id_;
       status_.conn_state = my_data::DeviceConnState::Online;
       status_.work_state = my_data::DeviceWorkState::Idle;
       status_.last_seen_at_ms = my_data::NowMs();
+      status_pub_.Publish(status_);
     }
 
     MYLOG_INFO("[Device:{}] 创建 Control 实例...", device_id_);
@@ -111,7 +120,7 @@ bool DepthSensorDevice::Start(my_control::TaskQueue& queue, std::atomic<bool>* e
   estop_flag_ = estop_flag;
 
   std::string wf_name = "wf-" + device_id_;
-  workflow_ = std::make_unique<my_control::demo::Workflow>(wf_name, queue, *control_);
+  workflow_ = std::make_unique<my_control::demo::Workflow>(wf_name, queue, *control_, workflow_mode_);
 
   workflow_->SetEStopFlag(estop_flag_);
   workflow_->SetStartCallback([this](const my_data::Task& task) { this->UpdateOnTaskStart(task); });
@@ -136,6 +145,7 @@ void DepthSensorDevice::Stop() {
   {
     std::lock_guard<std::mutex> lk(status_mu_);
     status_.last_seen_at_ms = my_data::NowMs();
+    status_pub_.Publish(status_);
   }
 }
 
@@ -148,8 +158,7 @@ void DepthSensorDevice::Join() {
 }
 
 my_data::DeviceStatus DepthSensorDevice::GetStatusSnapshot() const {
-  std::lock_guard<std::mutex> lk(status_mu_);
-  return status_;
+  return *status_pub_.Load();
 }
 
 void DepthSensorDevice::UpdateOnTaskStart(const my_data::Task& task) {
@@ -158,6 +167,7 @@ void DepthSensorDevice::UpdateOnTaskStart(const my_data::Task& task) {
   status_.running_task_id = task.task_id;
   status_.last_seen_at_ms = my_data::NowMs();
   running_task_snapshot_ = task;
+  status_pub_.Publish(status_);
 
   MYLOG_INFO("[Device:{}] 状态更新：进入 Busy，running_task_id={}, capability={}, action={}",
              device_id_, status_.running_task_id, task.capability, task.action);
@@ -178,6 +188,7 @@ void DepthSensorDevice::UpdateOnTaskFinish(const my_data::Task& task, const my_d
 
   status_.running_task_id.clear();
   running_task_snapshot_.reset();
+  status_pub_.Publish(status_);
 
   MYLOG_INFO("[Device:{}] 状态更新：任务完成 task_id={}, code={}, work_state={}, last_error={}",
              device_id_,
@@ -29,6 +29,7 @@ public:
   void Join() override;
 
   my_data::DeviceStatus GetStatusSnapshot() const override;
+  std::uint64_t StatusVersion() const override { return status_pub_.Version(); }
 
   /**
    * @brief 显示和解释构造参数
@@ -47,6 +48,7 @@ private:
 private:
   my_data::DeviceId device_id_{"depth-unknown"};
   std::string device_name_{"depth-sensor-demo"};
+  my_control::demo::WorkflowMode workflow_mode_{my_control::demo::WorkflowMode::Thread};  // cfg.workflow_mode: thread|pooled
 
   std::unique_ptr<my_control::IControl> control_;
   std::unique_ptr<my_control::demo::Workflow> workflow_;
@@ -56,6 +58,7 @@ private:
 
   mutable std::mutex status_mu_;
   my_data::DeviceStatus status_;
+  my_data::VersionedSnapshot<my_data::DeviceStatus> status_pub_;  // status_ 的已发布副本（status_mu_ 内发布，读方无锁）
   std::optional<my_data::Task> running_task_snapshot_;
 };
 
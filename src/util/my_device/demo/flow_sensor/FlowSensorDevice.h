@@ -30,6 +30,7 @@ public:
   void Join() override;
 
   my_data::DeviceStatus GetStatusSnapshot() const override;
+  std::uint64_t StatusVersion() const override { return status_pub_.Version(); }
 
   my_data::DeviceId Id() const override { return device_id_; }
   std::string Type() const override { return "flow_sensor"; }
@@ -41,6 +42,7 @@ private:
 private:
   my_data::DeviceId device_id_{"flow-unknown"};
   std::string device_name_{"flow-sensor-demo"};
+  my_control::demo::WorkflowMode workflow_mode_{my_control::demo::WorkflowMode::Thread};  // cfg.workflow_mode: thread|pooled
 
   std::unique_ptr<my_control::IControl> control_;
   std::unique_ptr<my_control::demo::Workflow> workflow_;
@@ -50,6 +52,7 @@ private:
 
   mutable std::mutex status_mu_;
   my_data::DeviceStatus status_;
+  my_data::VersionedSnapshot<my_data::DeviceStatus> status_pub_;  // status_ 的已发布副本（status_mu_ 内发布，读方无锁）
   std::optional<my_data::Task> running_task_snapshot_;
 };
 
@@ -13,6 +13,7 @@ UUVDevice::UUVDevice() {
     status_.running_task_id = "";
     status_.last_error = "";
     status_.last_seen_at_ms = my_data::NowMs();
+    status_pub_.Publish(status_);
   }
   MYLOG_INFO("[Device:{}] 构造完成 (UUVDevice)", device_id_);
 }
@@ -62,12 +63,20 @@ bool UUVDevice::Init(const nlohmann::json& cfg, std::string* err) {
     device_id_ = cfg.value("device_id", device_id_);
     device_name_ = cfg.value("device_name", device_name_);
 
+    const std::string mode_str = cfg.value("workflow_mode", std::string("thread"));
+    if (!my_control::demo::ParseWorkflowMode(mode_str, &workflow_mode_)) {
+      if (err) *err = "invalid workflow_mode: " + mode_str;
+      MYLOG_ERROR("[Device:{}] Init 失败：workflow_mode 非法（thread|pooled），got={}", device_id_, mode_str);
+      return false;
+    }
+
     {
       std::lock_guard<std::mutex> lk(status_mu_);
       status_.device_id = device_id_;
       status_.conn_state = my_data::DeviceConnState::Online;
       status_.work_state = my_data::DeviceWorkState::Idle;
       status_.last_seen_at_ms = my_data::NowMs();
+      status_pub_.Publish(status_);
     }
 
     // 2) 创建并初始化 control（通过 my_control 的工厂）
@@ -113,7 +122,7 @@ bool UUVDevice::Start(my_control::TaskQueue& queue, std::atomic<bool>* estop_fla
 
   // 创建 workflow（每设备一条线程）
   std::string wf_name = "wf-" + device_id_;
-  workflow_ = std::make_unique<my_control::demo::Workflow>(wf_name, queue, *control_);
+  workflow_ = std::make_unique<my_control::demo::Workflow>(wf_name, queue, *control_, workflow_mode_);
 
   // 注入 estop
   workflow_->SetEStopFlag(estop_flag_);
@@ -150,6 +159,7 @@ void UUVDevice::Stop() {
   {
     std::lock_guard<std::mutex> lk(status_mu_);
     status_.last_seen_at_ms = my_data::NowMs();
+    status_pub_.Publish(status_);
   }
 }
 
@@ -162,8 +172,7 @@ void UUVDevice::Join() {
 }
 
 my_data::DeviceStatus UUVDevice::GetStatusSnapshot() const {
-  std::lock_guard<std::mutex> lk(status_mu_);
-  return status_;
+  return *status_pub_.Load();
 }
 
 void UUVDevice::UpdateOnTaskStart(const my_data::Task& task) {
@@ -172,6 +181,7 @@ void UUVDevice::UpdateOnTaskStart(const my_data::Task& task) {
   status_.running_task_id = task.task_id;
   status_.last_seen_at_ms = my_data::NowMs();
   running_task_snapshot_ = task;
+  status_pub_.Publish(status_);
 
   MYLOG_INFO("[Device:{}] 状态更新：进入 Busy，running_task_id={}, capability={}, action={}",
              device_id_, status_.running_task_id, task.capability, task.action);
@@ -193,6 +203,7 @@ void UUVDevice::UpdateOnTaskFinish(const my_data::Task& task, const my_data::Tas
 
   status_.running_task_id.clear();
   running_task_snapshot_.reset();
+  status_pub_.Publish(status_);
 
   MYLOG_INFO("[Device:{}] 状态更新：任务完成 task_id={}, code={}, work_state={}, last_error={}",
              device_id_,
@@ -40,6 +40,7 @@ public:
   void Join() override;
 
   my_data::DeviceStatus GetStatusSnapshot() const override;
+  std::uint64_t StatusVersion() const override { return status_pub_.Version(); }
 
   my_data::DeviceId Id() const override { return device_id_; }
   std::string Type() const override { return "uuv"; }
@@ -52,6 +53,7 @@ private:
   // 基础身份
   my_data::DeviceId device_id_{"uuv-unknown"};
   std::string device_name_{"uuv-demo"};
+  my_control::demo::WorkflowMode workflow_mode_{my_control::demo::WorkflowMode::Thread};  // cfg.workflow_mode: thread|pooled
 
   // 控制器与工作流
   std::unique_ptr<my_control::IControl> control_;
@@ -64,6 +66,7 @@ private:
   // 运行态快照
   mutable std::mutex status_mu_;
   my_data::DeviceStatus status_;
+  my_data::VersionedSnapshot<my_data::DeviceStatus> status_pub_;  // status_ 的已发布副本（status_mu_ 内发布，读方无锁）
   std::optional<my_data::Task> running_task_snapshot_; // 可选，便于调试
 };
 
@@ -1,7 +1,9 @@
 #include "BaseEdge.h"
 
+#include <algorithm>
 #include <chrono>
 #include <atomic>
+#include <cstdint>
 
 #include "JsonUtil.h"
 #include "MyDevice.h"
@@ -34,7 +36,10 @@ bool BaseEdge::Init(const nlohmann::json& cfg, std::string* err) {
         self_task = my_data::Task{};
         self_task_run_state_.store(RunState::RunOver);
         self_task_executing_.store(false);
+        self_task_queue_ = nullptr;
+        self_periodic_tasks_.clear();
     }
+    self_queue_ = nullptr;
 
     cfg_ = cfg;
     edge_id_ = cfg.value("edge_id", edge_id_);
@@ -47,13 +52,36 @@ bool BaseEdge::Init(const nlohmann::json& cfg, std::string* err) {
     self_device_id_ = cfg.value("self_device_id", self_device_id_);
     snapshot_enable_ = cfg.value("snapshot_enable", snapshot_enable_);
     snapshot_interval_ms_ = cfg.value("snapshot_interval_ms", snapshot_interval_ms_);
+    task_journal_enable_ = cfg.value("task_journal_enable", task_journal_enable_);
+    task_journal_path_ = cfg.value("task_journal_path", std::string("./data/task_journal/") + edge_id_ + ".wal");
+
+    // 队列调度：fifo（默认）| priority（优先级 + EDF）
+    task_queue_options_ = my_control::TaskQueueOptions{};
+    const std::string queue_mode = cfg.value("task_queue_mode", std::string("fifo"));
+    if (!my_control::ParseTaskQueueMode(queue_mode, &task_queue_options_.mode)) {
+        MYLOG_WARN("[Edge:{}] 未知 task_queue_mode={}，使用 fifo", edge_id_, queue_mode);
+    }
+    task_queue_options_.drop_expired = cfg.value("task_queue_drop_expired", task_queue_options_.drop_expired);
+
+    // Submit 幂等去重
+    dedup_enable_ = cfg.value("dedup_enable", true);
+    dedup_default_window_ms_ = cfg.value("dedup_default_window_ms", static_cast<std::int64_t>(0));
+    {
+        DedupTableOptions dopts;
+        dopts.slot_ms = cfg.value("dedup_slot_ms", dopts.slot_ms);
+        dopts.max_window_ms = cfg.value("dedup_max_window_ms", dopts.max_window_ms);
+        dopts.max_entries = cfg.value("dedup_max_entries", dopts.max_entries);
+        dedup_.Reset(dopts);
+    }
 
     boot_at_ms_ = my_data::NowMs();
 
-    // 清理旧资源（支持重复 Init）
+    // 清理旧资源（支持重复 Init）；撤下状态快照引用的旧设备/队列（读方持有的旧快照仍共享持有它们）
+    status_cache_.PublishSources({});
     devices_.clear();
     queues_.clear();
     device_type_by_id_.clear();
+    CloseTaskJournalLocked();
 
     MYLOG_INFO("[Edge:{}] Init 开始: edge_type={}, version={}, self_action_enable={}, snapshot_enable={}, interval_ms={}",
                          edge_id_, edge_type_, self_action_enable_ ? "true" : "false",
@@ -62,7 +90,8 @@ bool BaseEdge::Init(const nlohmann::json& cfg, std::string* err) {
     // 1) 永远创建 self 队列（Edge ��身能力）
     {
         const std::string qname = "queue-" + self_device_id_;
-        queues_[self_device_id_] = std::make_unique<my_control::TaskQueue>(qname);
+        queues_[self_device_id_] = std::make_unique<my_control::TaskQueue>(qname, task_queue_options_);
+        self_queue_ = queues_[self_device_id_].get();
         device_type_by_id_[self_device_id_] = "self";
         MYLOG_INFO("[Edge:{}] 创建 self 队列成功: device_id={}, queue={}", edge_id_, self_device_id_, qname);
     }
@@ -85,7 +114,7 @@ bool BaseEdge::Init(const nlohmann::json& cfg, std::string* err) {
                 device_type_by_id_[device_id] = type;
 
                 std::string qname = "queue-" + device_id;
-                queues_[device_id] = std::make_unique<my_control::TaskQueue>(qname);
+                queues_[device_id] = std::make_unique<my_control::TaskQueue>(qname, task_queue_options_);
                 MYLOG_INFO("[Edge:{}] 创建队列: device_id={}, type={}, queue={}", edge_id_, device_id, type, qname);
 
                 auto dev = my_device::MyDevice::GetInstance().Create(type, dcfg, err);
@@ -108,9 +137,20 @@ bool BaseEdge::Init(const nlohmann::json& cfg, std::string* err) {
         MYLOG_WARN("[Edge:{}] 未配置 devices，Edge 将以 self 模式运行（仅 self_action + snapshot）", edge_id_);
     }
 
+    // 3) 任务日志（可选）：回放上次未完成的任务
+    if (task_journal_enable_) {
+        std::string jerr;
+        if (!OpenTaskJournalLocked(&jerr)) {
+            MYLOG_ERROR("[Edge:{}] 任务日志打开失败，队列将不持久化: path={}, err={}", edge_id_, task_journal_path_, jerr);
+            if (err) *err = "task journal: " + jerr;
+        }
+    }
+
     MYLOG_INFO("注册内置 say_hello handler");
     RegisterSelfTaskHandler("say_hello", [this](const my_data::Task& task) {this->SayHelloAction(task); });
 
+    PublishStatusSourcesLocked();
+
     run_state_ = RunState::Ready;
     MYLOG_INFO("[Edge:{}] Init 完成: run_state=Ready，devices={}, queues={}",
                          edge_id_, devices_.size(), queues_.size());
@@ -129,16 +169,13 @@ bool BaseEdge::Start(std::string* err) {
 
     MYLOG_INFO("[Edge:{}] Start 开始: devices={}", edge_id_, devices_.size());
 
-    // 1) 启动 self task 监控线程
-    StartSelfTaskMonitorThreadLocked();
-    
-    // 2) 启动 self action thread
+    // 1) 启动 self action thread
     StartSelfActionThreadLocked();
 
-    // 3) 启动心跳/上报线程
+    // 2) 启动心跳/上报线程
     StartSnapshotThreadLocked();
 
-    // 4) 启动所有 device（如果有）
+    // 3) 启动所有 device（如果有）
     for (auto& [device_id, dev] : devices_) {
         auto qit = queues_.find(device_id);
         if (qit == queues_.end() || !qit->second) {
@@ -164,17 +201,13 @@ bool BaseEdge::Start(std::string* err) {
     return true;
 }
 
-SubmitResult BaseEdge::Submit(const my_data::RawCommand& cmd) {
-    std::shared_lock<std::shared_mutex> lk(rw_mutex_);
-
-    MYLOG_INFO("[Edge:{}] Submit: command_id={}, source={}, payload={}",
-                         edge_id_, cmd.command_id, cmd.source, cmd.payload.dump());
-
+bool BaseEdge::CheckAcceptingLocked(const my_data::RawCommand& cmd, SubmitResult* fail) const {
     // 1) run_state
     if (run_state_.load() != RunState::Running) {
-        return MakeResult(SubmitCode::NotRunning,
+        *fail = MakeResult(SubmitCode::NotRunning,
                                             "edge 未运行，run_state=" + RunStateToString(run_state_.load()),
                                             cmd);
+        return false;
     }
 
     // 2) estop
@@ -184,26 +217,34 @@ SubmitResult BaseEdge::Submit(const my_data::RawCommand& cmd) {
             std::lock_guard<std::mutex> lk2(estop_mu_);
             reason = estop_reason_;
         }
-        return MakeResult(SubmitCode::EStop,
+        *fail = MakeResult(SubmitCode::EStop,
                                             reason.empty() ? "estop 已激活" : ("estop 已激活: " + reason),
                                             cmd);
+        return false;
     }
+    return true;
+}
 
+std::optional<my_data::Task> BaseEdge::PrepareTaskLocked(const my_data::RawCommand& cmd, std::int64_t received_us,
+                                                        SubmitResult* fail) {
     // 3) payload 校验
     if (!cmd.payload.is_object()) {
-        return MakeResult(SubmitCode::InvalidCommand, "payload 必须是对象", cmd);
+        *fail = MakeResult(SubmitCode::InvalidCommand, "payload 必须是对象", cmd);
+        return std::nullopt;
     }
 
     // 4) device_id
     std::string device_id = my_data::jsonutil::GetStringOr(cmd.payload, "device_id", "");
     if (device_id.empty()) {
-        return MakeResult(SubmitCode::InvalidCommand, "缺少 payload.device_id", cmd);
+        *fail = MakeResult(SubmitCode::InvalidCommand, "缺少 payload.device_id", cmd);
+        return std::nullopt;
     }
 
     // 5) type
     auto dit = device_type_by_id_.find(device_id);
     if (dit == device_type_by_id_.end()) {
-        return MakeResult(SubmitCode::UnknownDevice, "未知 device_id=" + device_id, cmd, device_id);
+        *fail = MakeResult(SubmitCode::UnknownDevice, "未知 device_id=" + device_id, cmd, device_id);
+        return std::nullopt;
     }
     const std::string& type = dit->second;
 
@@ -211,18 +252,65 @@ SubmitResult BaseEdge::Submit(const my_data::RawCommand& cmd) {
     std::string nerr;
     auto maybe_task = NormalizeCommandLocked(cmd, device_id, type, &nerr);
     if (!maybe_task.has_value()) {
-        return MakeResult(SubmitCode::InvalidCommand,
+        *fail = MakeResult(SubmitCode::InvalidCommand,
                                             nerr.empty() ? "Normalize 失败" : ("Normalize 失败: " + nerr),
                                             cmd, device_id);
+        return std::nullopt;
+    }
+    // 以路由用的 device_id 为准（入队、分组都按它）
+    maybe_task->device_id = device_id;
+
+    // 7) 追踪：trace_id 优先沿用上游（payload.trace_id），span_id 每个任务一个
+    StampIngressTrace(*maybe_task, cmd, received_us);
+    return maybe_task;
+}
+
+bool BaseEdge::DedupParamsOf(const my_data::Task& task, std::int64_t* window_ms) const {
+    *window_ms = task.dedup_window_ms > 0 ? task.dedup_window_ms : dedup_default_window_ms_;
+    return dedup_enable_ && !task.idempotency_key.empty() && *window_ms > 0;
+}
+
+SubmitResult BaseEdge::Submit(const my_data::RawCommand& cmd) {
+    const std::int64_t received_us = my_data::MonoUs();
+    std::shared_lock<std::shared_mutex> lk(rw_mutex_);
+
+    MYLOG_INFO("[Edge:{}] Submit: command_id={}, source={}, payload={}",
+                         edge_id_, cmd.command_id, cmd.source, cmd.payload.dump());
+
+    SubmitResult fail;
+    if (!CheckAcceptingLocked(cmd, &fail)) {
+        return fail;
+    }
+    auto maybe_task = PrepareTaskLocked(cmd, received_us, &fail);
+    if (!maybe_task.has_value()) {
+        return fail;
+    }
+    const my_data::DeviceId device_id = maybe_task->device_id;
+    const my_data::TaskId task_id = maybe_task->task_id;
+
+    // 8) 幂等去重：窗口内同一 idempotency_key 直接返回首次结果（先占位，避免并发重复提交同时入队）
+    const std::string dedup_key = maybe_task->idempotency_key;
+    std::int64_t dedup_window_ms = 0;
+    const bool dedup = DedupParamsOf(*maybe_task, &dedup_window_ms);
+    if (dedup) {
+        SubmitResult first;
+        if (dedup_.TryReserve(dedup_key, dedup_window_ms,
+                              MakeResult(SubmitCode::Ok, "已入队", cmd, device_id, task_id),
+                              my_data::NowMs(), &first)) {
+            MYLOG_WARN("[Edge:{}] Submit 重复提交，返回首次结果: idempotency_key={}, command_id={}, task_id={}",
+                       edge_id_, dedup_key, cmd.command_id, first.task_id);
+            first.message += "（重复提交）";
+            return first;
+        }
     }
-    my_data::Task task = *maybe_task;
 
-    // 7) push queue
+    // 9) push queue（Task 一路移动进队列，不再拷贝）
     std::string qerr;
-    if (!AppendTaskToQueueLocked(device_id, task, &qerr)) {
+    if (!AppendTaskToQueueLocked(device_id, std::move(*maybe_task), &qerr)) {
+        if (dedup) dedup_.Erase(dedup_key);  // 入队失败不占用窗口，允许重试
         return MakeResult(SubmitCode::InternalError,
                                             qerr.empty() ? "入队失败" : ("入队失败: " + qerr),
-                                            cmd, device_id, task.task_id);
+                                            cmd, device_id, task_id);
     }
 
     auto qit = queues_.find(device_id);
@@ -230,60 +318,156 @@ SubmitResult BaseEdge::Submit(const my_data::RawCommand& cmd) {
                                                  ? static_cast<std::int64_t>(qit->second->Size())
                                                  : 0;
 
-    return MakeResult(SubmitCode::Ok, "已入队", cmd, device_id, task.task_id, qsize);
+    SubmitResult result = MakeResult(SubmitCode::Ok, "已入队", cmd, device_id, task_id, qsize);
+    if (dedup) dedup_.Update(dedup_key, result);
+    return result;
 }
 
-my_data::EdgeStatus BaseEdge::GetStatusSnapshot() const {
-    std::shared_lock<std::shared_mutex> lk(rw_mutex_);
-
-    my_data::EdgeStatus s;
-    s.edge_id = edge_id_;
-    s.boot_at_ms = boot_at_ms_;
-    s.version = version_;
+std::vector<SubmitResult> BaseEdge::SubmitBatch(std::vector<my_data::RawCommand>&& cmds, bool atomic) {
+    std::vector<SubmitResult> results(cmds.size());
+    if (cmds.empty()) return results;
+    const std::int64_t received_us = my_data::MonoUs();
 
-    RunState rs = run_state_.load();
-    if (rs == RunState::Initializing || rs == RunState::Ready) {
-        s.run_state = my_data::EdgeRunState::Initializing;
-    } else if (rs == RunState::Running) {
-        s.run_state = estop_.load() ? my_data::EdgeRunState::EStop : my_data::EdgeRunState::Running;
-    } else {
-        s.run_state = my_data::EdgeRunState::Degraded;
-    }
-
-    s.estop_active = estop_.load();
-    {
-        std::lock_guard<std::mutex> lk2(estop_mu_);
-        s.estop_reason = estop_reason_;
+    std::shared_lock<std::shared_mutex> lk(rw_mutex_);
+    MYLOG_INFO("[Edge:{}] SubmitBatch: count={}, atomic={}", edge_id_, cmds.size(), atomic ? "true" : "false");
+
+    // 1) run_state / estop 对整批只判断一次
+    SubmitResult fail;
+    if (!CheckAcceptingLocked(cmds.front(), &fail)) {
+        for (std::size_t i = 0; i < cmds.size(); ++i) {
+            results[i] = fail;
+            results[i].command_id = cmds[i].command_id;
+        }
+        return results;
     }
 
-    std::int64_t pending_total = 0;
-    std::int64_t running_total = 0;
+    // 2) 逐条校验 + Normalize + 去重占位，按设备分组（保持批内顺序）
+    struct Pending {
+        std::size_t index{0};
+        std::string dedup_key{};  // 非空表示已在去重表中占位
+    };
+    struct Group {
+        my_control::TaskQueue* queue{nullptr};
+        std::vector<my_data::Task> tasks;
+        std::vector<Pending> pending;
+    };
+    std::vector<my_data::DeviceId> group_order;
+    std::unordered_map<my_data::DeviceId, Group> groups;
+    std::size_t failed = 0;
+    const my_data::TimestampMs now_ms = my_data::NowMs();
+
+    for (std::size_t i = 0; i < cmds.size(); ++i) {
+        const auto& cmd = cmds[i];
+        auto maybe_task = PrepareTaskLocked(cmd, received_us, &results[i]);
+        if (!maybe_task.has_value()) {
+            ++failed;
+            continue;
+        }
+        const my_data::DeviceId device_id = maybe_task->device_id;
 
-    for (const auto& [device_id, dev] : devices_) {
-        if (!dev) continue;
+        auto qit = queues_.find(device_id);
+        if (qit == queues_.end() || !qit->second || qit->second->IsShutdown()) {
+            results[i] = MakeResult(SubmitCode::QueueShutdown, "队列不存在或已关闭，device_id=" + device_id,
+                                    cmd, device_id, maybe_task->task_id);
+            ++failed;
+            continue;
+        }
 
-        my_data::DeviceStatus ds = dev->GetStatusSnapshot();
+        Pending p;
+        p.index = i;
+        std::int64_t dedup_window_ms = 0;
+        if (DedupParamsOf(*maybe_task, &dedup_window_ms)) {
+            SubmitResult first;
+            if (dedup_.TryReserve(maybe_task->idempotency_key, dedup_window_ms,
+                                  MakeResult(SubmitCode::Ok, "已入队", cmd, device_id, maybe_task->task_id),
+                                  now_ms, &first)) {
+                first.message += "（重复提交）";
+                results[i] = std::move(first);  // 重复命令不算失败
+                continue;
+            }
+            p.dedup_key = maybe_task->idempotency_key;
+        }
 
-        auto qit = queues_.find(device_id);
-        if (qit != queues_.end() && qit->second) {
-            ds.queue_depth = static_cast<std::int64_t>(qit->second->Size());
-            pending_total += ds.queue_depth;
+        auto [git, inserted] = groups.try_emplace(device_id);
+        if (inserted) {
+            group_order.push_back(device_id);
+            git->second.queue = qit->second.get();
         }
-        if (ds.work_state == my_data::DeviceWorkState::Busy) {
-            running_total += 1;
+        results[i] = MakeResult(SubmitCode::Ok, "已入队", cmd, device_id, maybe_task->task_id);
+        git->second.tasks.push_back(std::move(*maybe_task));
+        git->second.pending.push_back(std::move(p));
+    }
+
+    // 3) 全有或全无：有失败则释放占位，整批不入队
+    if (atomic && failed > 0) {
+        for (auto& [device_id, g] : groups) {
+            for (const auto& p : g.pending) {
+                if (!p.dedup_key.empty()) dedup_.Erase(p.dedup_key);
+                results[p.index].code = SubmitCode::BatchAborted;
+                results[p.index].message = "同批 " + std::to_string(failed) + " 条命令失败，整批未入队";
+            }
         }
-        s.devices[device_id] = ds;
+        MYLOG_WARN("[Edge:{}] SubmitBatch 整批放弃: count={}, failed={}", edge_id_, cmds.size(), failed);
+        return results;
     }
 
-    // 也把 self 的队列深度统计进去（self 没有 DeviceStatus，可放到 tasks_pending_total）
-    auto self_qit = queues_.find(self_device_id_);
-    if (self_qit != queues_.end() && self_qit->second) {
-        pending_total += static_cast<std::int64_t>(self_qit->second->Size());
+    // 4) 每个设备队列一次批量入队（一次加锁 + 一次唤醒 + 一次落盘等待）
+    std::size_t queued = 0;
+    for (const auto& device_id : group_order) {
+        Group& g = groups[device_id];
+        const std::size_t n = g.tasks.size();
+        std::string qerr;
+        if (!g.queue->PushBatch(std::move(g.tasks), &qerr)) {
+            for (const auto& p : g.pending) {
+                if (!p.dedup_key.empty()) dedup_.Erase(p.dedup_key);
+                results[p.index].code = SubmitCode::InternalError;
+                results[p.index].message = qerr.empty() ? "入队失败" : ("入队失败: " + qerr);
+            }
+            MYLOG_ERROR("[Edge:{}] SubmitBatch 入队失败: device_id={}, count={}, err={}", edge_id_, device_id, n, qerr);
+            continue;
+        }
+        const std::int64_t qsize = static_cast<std::int64_t>(g.queue->Size());
+        for (const auto& p : g.pending) {
+            results[p.index].queue_size_after = qsize;
+            if (!p.dedup_key.empty()) dedup_.Update(p.dedup_key, results[p.index]);
+        }
+        queued += n;
     }
 
-    s.tasks_pending_total = pending_total;
-    s.tasks_running_total = running_total;
-    return s;
+    MYLOG_INFO("[Edge:{}] SubmitBatch 完成: count={}, queued={}, failed={}, devices={}",
+               edge_id_, cmds.size(), queued, failed, group_order.size());
+    return results;
+}
+
+my_data::EdgeStatus BaseEdge::GetStatusSnapshot() const {
+    return *GetStatusSnapshotShared();
+}
+
+std::shared_ptr<const my_data::EdgeStatus> BaseEdge::GetStatusSnapshotShared() const {
+    return status_cache_.Get(run_state_.load(), estop_.load(), [this] {
+        std::lock_guard<std::mutex> lk(estop_mu_);
+        return estop_reason_;
+    });
+}
+
+void BaseEdge::PublishStatusSourcesLocked() {
+    EdgeStatusCache::Sources src;
+    src.edge_id = edge_id_;
+    src.version = version_;
+    src.boot_at_ms = boot_at_ms_;
+    src.devices.reserve(devices_.size());
+    for (const auto& [device_id, dev] : devices_) {
+        if (!dev) continue;
+        EdgeStatusCache::Source ss;
+        ss.device_id = device_id;
+        ss.device = dev;
+        auto qit = queues_.find(device_id);
+        if (qit != queues_.end()) ss.queue = qit->second;
+        src.devices.push_back(std::move(ss));
+    }
+    auto sit = queues_.find(self_device_id_);
+    if (sit != queues_.end()) src.self_queue = sit->second;
+    status_cache_.PublishSources(std::move(src));
 }
 
 void BaseEdge::SetEStop(bool active, const std::string& reason) {
@@ -294,6 +478,7 @@ void BaseEdge::SetEStop(bool active, const std::string& reason) {
             std::lock_guard<std::mutex> lk2(estop_mu_);
             estop_reason_ = reason;
         }
+        status_cache_.BumpMeta();
     }
     MYLOG_WARN("[Edge:{}] SetEStop: active={}, reason={}",
                          edge_id_, active ? "true" : "false", reason);
@@ -333,9 +518,14 @@ void BaseEdge::Shutdown() {
         dev->Join();
     }
 
+    // 队列与消费线程都已停止，剩余任务保留在日志中，下次 Init 回放
+    CloseTaskJournalLocked();
+
     devices_.clear();
     queues_.clear();
     device_type_by_id_.clear();
+    self_queue_ = nullptr;
+    PublishStatusSourcesLocked();
 
     run_state_ = RunState::Stopped;
     MYLOG_WARN("[Edge:{}] Shutdown 完成: run_state=Stopped", edge_id_);
@@ -393,17 +583,20 @@ nlohmann::json BaseEdge::GetRunTimeStatusInfo() const {
 
 
     // 线程状态
-    tj["self_task_monitor"] = {
-        {"enabled", self_task_monitor_enable_},
-        {"running", self_task_monitor_thread_.joinable()},
-        {"boot_at_ms", self_task_monitor_boot_at_ms_},
-        {"running_time_s", int((my_data::NowMs() - self_task_monitor_boot_at_ms_) / 1000)}
-    };
+    std::size_t periodic_pending = 0;
+    {
+        std::shared_lock<std::shared_mutex> self_lk(rw_mutex_self_task_);
+        periodic_pending = self_periodic_tasks_.size();
+    }
     tj["self_action"] = {
         {"enabled", self_action_enable_},
         {"running", self_action_thread_.joinable()},
         {"boot_at_ms", self_action_boot_at_ms_},
-        {"running_time_s", int((my_data::NowMs() - self_action_boot_at_ms_) / 1000)}
+        {"running_time_s", int((my_data::NowMs() - self_action_boot_at_ms_) / 1000)},
+        {"task_run_state", RunStateToString(self_task_run_state_.load())},
+        {"dispatched", self_task_dispatched_.load()},
+        {"periodic_runs", self_task_periodic_runs_.load()},
+        {"periodic_pending", periodic_pending}
     };
     tj["snapshot"] = {
         {"enabled", snapshot_enable_},
@@ -413,6 +606,12 @@ nlohmann::json BaseEdge::GetRunTimeStatusInfo() const {
     };
     allRunningInfo["thread_status"] = tj;
 
+    // 状态快照：composed 只在设备/队列/estop 变化后增长，与轮询频率无关
+    allRunningInfo["status_snapshot"] = {
+        {"composed", status_cache_.ComposeCount()},
+        {"sources_version", status_cache_.SourcesVersion()}
+    };
+
     // 任务队列状态
     nlohmann::json qj = nlohmann::json::object();
     for (const auto& [device_id, q] : queues_) {
@@ -420,18 +619,28 @@ nlohmann::json BaseEdge::GetRunTimeStatusInfo() const {
         qj[device_id] = {
             {"name", q->Name()},
             {"size", q->Size()},
-            {"is_shutdown", q->IsShutdown()}
+            {"is_shutdown", q->IsShutdown()},
+            {"stats", my_control::ToJson(q->Stats())}
         };
     }
     allRunningInfo["queues"] = qj;
+
+    const auto ds = dedup_.Stats();
+    allRunningInfo["dedup"] = {
+        {"enabled", dedup_enable_},
+        {"size", ds.size},
+        {"hits", ds.hits},
+        {"inserts", ds.inserts},
+        {"expired", ds.expired},
+        {"evicted", ds.evicted}
+    };
     return allRunningInfo;
 }
 
 
 bool BaseEdge::AppendJsonTask(const nlohmann::json& taskj) {
     try {
-        my_data::Task t = my_data::Task::fromJson(taskj);
-        return AppendTask(t);
+        return AppendTask(my_data::Task::fromJson(taskj));
     } catch (const std::exception& e) {
         MYLOG_ERROR("[Edge:{}] AppendJsonTask 异常: {}", edge_id_, e.what());
         return false;
@@ -439,6 +648,10 @@ bool BaseEdge::AppendJsonTask(const nlohmann::json& taskj) {
 }
 
 bool BaseEdge::AppendTask(const my_data::Task& task) {
+    return AppendTask(my_data::Task(task));
+}
+
+bool BaseEdge::AppendTask(my_data::Task&& task) {
     std::unique_lock<std::shared_mutex> lk(rw_mutex_);
 
     // 允许外部把 self task 直接 append 进来（你要求外部可下发 self）
@@ -448,12 +661,14 @@ bool BaseEdge::AppendTask(const my_data::Task& task) {
     }
 
     std::string err;
-    if (!AppendTaskToQueueLocked(task.device_id, task, &err)) {
+    const my_data::DeviceId device_id = task.device_id;
+    const my_data::TaskId task_id = task.task_id;
+    if (!AppendTaskToQueueLocked(device_id, std::move(task), &err)) {
         MYLOG_ERROR("[Edge:{}] AppendTask 失败: {}", edge_id_, err);
         return false;
     }
 
-    MYLOG_INFO("[Edge:{}] AppendTask 成功: device_id={}, task_id={}", edge_id_, task.device_id, task.task_id);
+    MYLOG_INFO("[Edge:{}] AppendTask 成功: device_id={}, task_id={}", edge_id_, device_id, task_id);
     return true;
 }
 
@@ -475,7 +690,7 @@ SubmitResult BaseEdge::MakeResult(SubmitCode code,
 }
 
 bool BaseEdge::AppendTaskToQueueLocked(const my_data::DeviceId& device_id,
-                                                                            const my_data::Task& task,
+                                                                            my_data::Task&& task,
                                                                             std::string* err) {
     auto qit = queues_.find(device_id);
     if (qit == queues_.end() || !qit->second) {
@@ -486,76 +701,46 @@ bool BaseEdge::AppendTaskToQueueLocked(const my_data::DeviceId& device_id,
         if (err) *err = "队列已关闭，device_id=" + device_id;
         return false;
     }
-    qit->second->Push(task);
-    return true;
+    return qit->second->Push(std::move(task), err);
 }
 
-// ---------------- self action thread ----------------
+bool BaseEdge::OpenTaskJournalLocked(std::string* err) {
+    my_control::TaskJournalOptions opts;
+    opts.path = task_journal_path_;
+    opts.fsync = cfg_.value("task_journal_fsync", opts.fsync);
+    opts.compact_check_interval_ms = cfg_.value("task_journal_compact_interval_ms", opts.compact_check_interval_ms);
 
-void BaseEdge::StartSelfTaskMonitorThreadLocked() {
-    if (!self_task_monitor_enable_) {
-        MYLOG_WARN("[Edge:{}] self_task monitor 线程未启用", edge_id_);
-        return;
-    } else {
-        MYLOG_INFO("[Edge:{}] self_task monitor 线程启用", edge_id_);
-    }
-    if (self_task_monitor_thread_.joinable()) {
-        MYLOG_WARN("[Edge:{}] self_task monitor 线程已在运行", edge_id_);
-        return;
-    } else {
-        MYLOG_INFO("[Edge:{}] self_task monitor 线程未在运行", edge_id_);
+    auto journal = std::make_shared<my_control::TaskJournal>(opts);
+    if (!journal->Open(err)) {
+        return false;
     }
-    self_task_monitor_stop_.store(false);
-    MYLOG_INFO("[Edge:{}] 启动 self_task monitor 线程", edge_id_);
-    self_task_monitor_boot_at_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count();
-    MYLOG_INFO("[Edge:{}] self_task monitor 线程启动时间戳: {}", edge_id_, self_task_monitor_boot_at_ms_);
-    self_task_monitor_thread_ = std::thread(&BaseEdge::SelfTaskMonitorLoop, this);
-}
-
 
-void BaseEdge::StopSelfTaskMonitorThreadLocked() {
-    self_task_monitor_stop_.store(true);
-
-    if (self_task_monitor_thread_.joinable()) {
-        MYLOG_INFO("[Edge:{}] 等待 self_task monitor 线程退出...", edge_id_);
-        self_task_monitor_thread_.join();
-        MYLOG_INFO("[Edge:{}] self_task monitor 线程已退出", edge_id_);
+    std::size_t restored = 0;
+    for (auto& [device_id, q] : queues_) {
+        if (!q) continue;
+        q->AttachJournal(journal);
+        std::size_t n = q->Restore(journal->TakeRecovered(q->Name()));
+        if (n > 0) {
+            MYLOG_WARN("[Edge:{}] 任务日志回放: device_id={}, queue={}, restored={}", edge_id_, device_id, q->Name(), n);
+        }
+        restored += n;
     }
-}
-
-void BaseEdge::SelfTaskMonitorLoop() {
-    MYLOG_INFO("[Edge:{}] self_task monitor loop 进入", edge_id_);
-
-    while (!self_task_monitor_stop_.load()) {
-        my_data::Task task;
-        int wait_ms = 1000; // 退化行为，避免空转过快
-        // 尝试获取任务（会在内部仅持短锁以查找队列），timeout_ms 与之前 sleep 行为一致
-        int fetch_res = FetchSelfTask(task, wait_ms); // 1000ms 超时
 
-        if (0 == fetch_res) { // No queue
-            MYLOG_ERROR("[Edge:{}] self_action: self 队列不存在，线程退出, fetch_res: {}", edge_id_, fetch_res);
-            return;
-        }
-        if (3 == fetch_res) { // Queue shutdown
-            MYLOG_ERROR("[Edge:{}] self_action: self 队列已关闭，线程退出, fetch_res: {}", edge_id_, fetch_res);
-            break;
-        }
-        if (5 == fetch_res) { // already has task
-            MYLOG_INFO("[Edge:{}] self_action: 已有未执行任务，继续等待 {} ms, fetch_res: {}", edge_id_, wait_ms, fetch_res);
-        }
-        if (2 == fetch_res) { // timeout, 无任务，继续循环
-            MYLOG_INFO("[Edge:{}] self_action: 无任务，继续等待 {} ms, fetch_res: {}", edge_id_, wait_ms, fetch_res);
+    task_journal_ = std::move(journal);
+    MYLOG_INFO("[Edge:{}] 任务日志已启用: path={}, restored={}", edge_id_, task_journal_path_, restored);
+    return true;
+}
 
-        }
-        // 其它错误码（4）则回到循环重试
-        std::this_thread::sleep_for(std::chrono::milliseconds(wait_ms)); // 退化行为，避免空转过快
+void BaseEdge::CloseTaskJournalLocked() {
+    if (!task_journal_) return;
+    for (auto& [device_id, q] : queues_) {
+        if (q) q->AttachJournal(nullptr);
     }
-
-    MYLOG_WARN("[Edge:{}] self_task monitor loop 退出", edge_id_);
-    return;
+    task_journal_->Close();
+    task_journal_.reset();
 }
 
+// ---------------- self action thread ----------------
 
 void BaseEdge::StartSelfActionThreadLocked() {
     if (!self_action_enable_) {
@@ -581,9 +766,10 @@ void BaseEdge::StartSelfActionThreadLocked() {
 void BaseEdge::StopSelfActionThreadLocked() {
     self_action_stop_.store(true);
 
-    // 尝试唤醒（如果 TaskQueue 没有 timed pop，这里只能依赖 Shutdown 时唤醒）
-    // 这里不强依赖，join 前先 Shutdown 队列会更稳（但我们 shutdown 里是先停线程再 shutdown queue）
-    // 所以建议 TaskQueue 支持带超时 pop；暂时在 loop 内 sleep 退化。
+    // self_action 线程阻塞在 self 队列的 PopBlocking 上（空闲时不设超时），关闭 self 队列将其唤醒
+    if (self_queue_) {
+        self_queue_->Shutdown();
+    }
 
     if (self_action_thread_.joinable()) {
         MYLOG_INFO("[Edge:{}] 等待 self_action 线程退出...", edge_id_);
@@ -592,76 +778,162 @@ void BaseEdge::StopSelfActionThreadLocked() {
     }
 }
 
+/**
+ * @brief self task 执行循环（单线程状态机）
+ *
+ * 1) 有到期的周期任务：直接装载执行
+ * 2) 否则阻塞在 self 队列上，最多等到下一个周期任务到期；Submit/AppendTask 入队即唤醒
+ * 3) 队列关闭（Shutdown）时退出
+ */
 void BaseEdge::SelfActionLoop() {
     MYLOG_INFO("[Edge:{}] self_action loop 进入", edge_id_);
     while (!self_action_stop_.load()) {
-        ExecuteSelfTask();
-        std::this_thread::sleep_for(std::chrono::milliseconds(100)); // 退化行为，避免空转过快
+        my_data::Task task;
+        int wait_ms = -1;
+        if (TakeDuePeriodicSelfTask(&task, &wait_ms)) {
+            {
+                std::unique_lock<std::shared_mutex> lk(rw_mutex_self_task_);
+                self_task = std::move(task);
+                self_task_queue_ = nullptr;  // 周期重跑不经过队列，无需 MarkDone
+                self_task_run_state_.store(RunState::Initializing);
+            }
+            self_task_periodic_runs_.fetch_add(1);
+            RunLoadedSelfTask();
+            continue;
+        }
+
+        const int fetch_res = FetchSelfTask(task, wait_ms);
+        if (0 == fetch_res) { // No queue
+            MYLOG_ERROR("[Edge:{}] self_action: self 队列不存在，线程退出", edge_id_);
+            break;
+        }
+        if (3 == fetch_res) { // Queue shutdown
+            MYLOG_WARN("[Edge:{}] self_action: self 队列已关闭，线程退出", edge_id_);
+            break;
+        }
+        if (1 == fetch_res) {
+            RunLoadedSelfTask();
+            continue;
+        }
+        if (5 == fetch_res) {
+            // 单线程下 RunLoadedSelfTask 已保证收尾，这里只可能是停止过程中的残留状态
+            if (self_action_stop_.load()) break;
+            MYLOG_WARN("[Edge:{}] self_action: self task 状态未回收({})，强制置为 RunOver",
+                       edge_id_, RunStateToString(self_task_run_state_.load()));
+            self_task_run_state_.store(RunState::RunOver);
+            continue;
+        }
+        if (4 == fetch_res) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100)); // 异常重试退避（非空闲路径）
+        }
+        // 2 = 超时：周期任务到期，回到循环顶部执行
     }
     MYLOG_WARN("[Edge:{}] self_action loop 退出", edge_id_);
 }
 
+void BaseEdge::RunLoadedSelfTask() {
+    my_data::Task current_task;
+    {
+        std::shared_lock<std::shared_mutex> lk(rw_mutex_self_task_);
+        current_task = self_task;
+    }
+    self_task_dispatched_.fetch_add(1);
+
+    current_task.trace.exec_start_us = my_data::MonoUs();
+    ExecuteSelfTask();
+    current_task.trace.exec_finish_us = my_data::MonoUs();
+
+    // 子类覆盖的 ExecuteSelfTaskLocked 未调用 FinishSelfTask 时在这里收尾，避免下一次 fetch 被跳过
+    const RunState st = self_task_run_state_.load();
+    if (st == RunState::Initializing || st == RunState::Ready || st == RunState::Running) {
+        MYLOG_WARN("[Edge:{}] self task 未收尾，补充回收: task_id={}, state={}",
+                   edge_id_, current_task.task_id, RunStateToString(st));
+        FinishSelfTask(current_task);
+    }
+    // self task 没有统一的结果码（由各 handler 自行上报），延迟统计按成功计
+    my_data::TaskTracer::GetInstance().Record(current_task, my_data::TaskResult{});
+
+    const std::int64_t interval_ms = SelfTaskRepeatIntervalMs(current_task);
+    if (interval_ms <= 0 || self_action_stop_.load()) {
+        return;
+    }
+    const auto due = std::chrono::steady_clock::now() + std::chrono::milliseconds(interval_ms);
+    current_task.trace = my_data::TaskTrace{};  // 周期重跑不经过队列，旧时间戳不再有意义
+    std::size_t pending = 0;
+    {
+        std::unique_lock<std::shared_mutex> lk(rw_mutex_self_task_);
+        self_periodic_tasks_.emplace(due, std::move(current_task));
+        pending = self_periodic_tasks_.size();
+    }
+    MYLOG_DEBUG("[Edge:{}] 周期 self task 已重新排期: interval_ms={}, periodic_pending={}",
+                edge_id_, interval_ms, pending);
+}
+
+std::int64_t BaseEdge::SelfTaskRepeatIntervalMs(const my_data::Task& task) {
+    if (task.priority != 0 || !task.policy.is_object()) {
+        return 0;
+    }
+    auto it = task.policy.find("repeat_interval_ms");
+    if (it == task.policy.end() || !it->is_number_integer()) {
+        return 0;
+    }
+    return std::max<std::int64_t>(it->get<std::int64_t>(), 0);
+}
+
+bool BaseEdge::TakeDuePeriodicSelfTask(my_data::Task* out, int* wait_ms) {
+    std::unique_lock<std::shared_mutex> lk(rw_mutex_self_task_);
+    if (self_periodic_tasks_.empty()) {
+        *wait_ms = -1;
+        return false;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    auto it = self_periodic_tasks_.begin();
+    if (it->first > now) {
+        // 向上取整，避免提前 1ms 醒来再空转一轮
+        const auto remain_us = std::chrono::duration_cast<std::chrono::microseconds>(it->first - now).count();
+        *wait_ms = static_cast<int>(std::min<std::int64_t>((remain_us + 999) / 1000, INT32_MAX));
+        return false;
+    }
+    *out = std::move(it->second);
+    self_periodic_tasks_.erase(it);
+    return true;
+}
+
 /**
  * @brief 尝试从 self 队列中获取任务，带超时
  * 
  * @param out 输出参数，获取到的任务
- * @param timeout_ms 超时时间，单位毫秒
+ * @param timeout_ms 超时时间，单位毫秒；<0 表示一直等待
  * @return int 状态码: 0=无队列，1=成功，2=超时，3=队列已关闭，4=错误，5=已有任务未执行
  */
 int BaseEdge::FetchSelfTask(my_data::Task& out, int timeout_ms) {
-    my_control::TaskQueue* q = nullptr;
+    my_control::TaskQueue* q = self_queue_;
     bool ok = false;
     try {
         // 判断当前任务状态，避免重复 fetch
-        RunState current_state = self_task_run_state_.load();
-        if (current_state == RunState::Ready) {
-            MYLOG_WARN("[Edge:{}] FetchSelfTask: 当前已有未执行任务，跳过本次 fetch", edge_id_);
-            return 5; // already has task
-        }
-        if (current_state == RunState::Initializing) {
-            MYLOG_INFO("[Edge:{}] FetchSelfTask: 当前任务正在等待执行，跳过本次 fetch", edge_id_);
-            return 5; // already has task
-        }
-        if (current_state == RunState::Running) {
-            MYLOG_WARN("[Edge:{}] FetchSelfTask: 当前任务正在运行，跳过本次 fetch", edge_id_);
-            return 5; // already has task
-        }
-        if (current_state == RunState::Stopping || current_state == RunState::Stopped) {
-            MYLOG_WARN("[Edge:{}] FetchSelfTask: 当前处于停止状态，跳过本次 fetch", edge_id_);
+        const RunState current_state = self_task_run_state_.load();
+        if (current_state != RunState::RunOver) {
+            MYLOG_WARN("[Edge:{}] FetchSelfTask: 当前 self task 状态为 {}，跳过本次 fetch",
+                       edge_id_, RunStateToString(current_state));
             return 5; // already has task or stopping
         }
-        if (current_state == RunState::RunOver) {
-            MYLOG_INFO("[Edge:{}] FetchSelfTask: 当前无待执行 self task，开始本次 fetch", edge_id_);
-        }
 
-        {
-            std::shared_lock<std::shared_mutex> lk(rw_mutex_);
-            auto it = queues_.find(self_device_id_);
-            if (it == queues_.end()) {
-                MYLOG_WARN("[Edge:{}] FetchSelfTask: 找不到 self_device_id={} 对应的队列", edge_id_, self_device_id_);
-                return 0; // No queue
-            }
-            if (!it->second) {
-                MYLOG_WARN("[Edge:{}] FetchSelfTask: self_device_id={} 对应的队列为空", edge_id_, self_device_id_);
-                return 0; // No queue
-            }
-            q = it->second.get();
+        if (!q) {
+            MYLOG_WARN("[Edge:{}] FetchSelfTask: 找不到 self_device_id={} 对应的队列", edge_id_, self_device_id_);
+            return 0; // No queue
         }
 
         if (q->IsShutdown()) return 3; // queue already shutdown
 
         ok = q->PopBlocking(out, timeout_ms);
-        if (!ok) {
-            return 2; // timeout
-        } else {
-            {
-                std::unique_lock<std::shared_mutex> lk(rw_mutex_self_task_);
-                this->self_task = out; // 存储到成员变量，供 ExecuteSelfTask 使用
-                this->self_task_run_state_.store(RunState::Initializing); // 标记为有新任务
-                MYLOG_INFO("[Edge:{}] 更新当前任务, task_id={}, capability={}, action={}, params={}", edge_id_, out.task_id, out.capability, out.action, out.params.dump(4));
-            }
+        if (ok) {
+            out.trace.dequeued_us = my_data::MonoUs();
+            std::unique_lock<std::shared_mutex> lk(rw_mutex_self_task_);
+            this->self_task = std::move(out); // 移动到成员变量，供 ExecuteSelfTask 使用（调用方不再使用 out）
+            this->self_task_queue_ = q;
+            this->self_task_run_state_.store(RunState::Initializing); // 标记为有新任务
+            MYLOG_INFO("[Edge:{}] 更新当前任务, task_id={}, capability={}, action={}, params={}", edge_id_, self_task.task_id, self_task.capability, self_task.action, self_task.params.dump(4));
         }
-        
     } catch (const std::exception& e) {
         MYLOG_ERROR("[Edge:{}] FetchSelfTask 异常: {}", edge_id_, e.what());
         return 4; // error
@@ -683,9 +955,6 @@ void BaseEdge::ExecuteSelfTask() {
 }
 
 void BaseEdge::ExecuteSelfTaskLocked() {
-    // 每个任务执行的时候都间隔1秒
-    std::this_thread::sleep_for(std::chrono::milliseconds(self_task_execution_step_ms_)); // 退化行为，避免空转过快
-    
     const RunState current_state = self_task_run_state_.load();
     if (current_state != RunState::Initializing && current_state != RunState::Ready) {
         // 无新任务
@@ -856,6 +1125,10 @@ RunState BaseEdge::FinishSelfTask(const my_data::Task& task) {
     }
 
     self_task_executing_.store(false);
+    if (self_task_queue_) {
+        self_task_queue_->MarkDone(task);
+        self_task_queue_ = nullptr;
+    }
     MYLOG_INFO("[Edge:{}] self task 执行收尾: task_id={}, capability={}, action={}, final_state={}",
                edge_id_, task.task_id, task.capability, task.action, RunStateToString(final_state));
     return final_state;
@@ -1,21 +1,27 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <functional>
+#include <map>
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "DedupTable.h"
+#include "EdgeStatusCache.h"
 #include "IEdge.h"
 #include "MyData.h"
 #include "MyLog.h"
 #include "IDevice.h"
+#include "TaskJournal.h"
 #include "TaskQueue.h"
 #include "demo/Task.h"
 
@@ -25,7 +31,7 @@ namespace my_edge {
  * @brief BaseEdge: 实现 IEdge 的通用骨架
  *
  * 设计目标: 
- * 1) Edge 自身具备执行能力: 内置 self 队列 + self_action 线程
+ * 1) Edge 自身具备执行能力: 内置 self 队列 + self_action 线程（事件驱动：入队即唤醒，周期任务按定时重排）
  * 2) device 是可选的: cfg.devices 可以为空/缺失
  * 3) 心跳/上报线程独立: snapshot_thread_ 负责心跳上报（也可扩展为状态上报）
  * 4) Submit/Init/Start/Shutdown 的并发与状态机统一
@@ -45,7 +51,9 @@ public:
   bool Init(const nlohmann::json& cfg, std::string* err) override;          // 负责解析 cfg 和初始化成员变量，但不启动设备线程
   bool Start(std::string* err) override;                                    // 负责启动设备线程、self action 线程和 snapshot 线程，切换 run_state 到 Running
   SubmitResult Submit(const my_data::RawCommand& cmd) override;             // 负责 run_state/estop/device_id 校验，调用 NormalizeCommandLocked 获取 Task，并分发到对应队列
-  my_data::EdgeStatus GetStatusSnapshot() const override;                   // 负责收集基本状态信息（run_state、estop、队列长度等），并调用 ReportHeartbeatLocked 上报
+  std::vector<SubmitResult> SubmitBatch(std::vector<my_data::RawCommand>&& cmds, bool atomic = false) override; // 一次加锁校验整批命令，按设备分组后每个队列一次批量入队
+  my_data::EdgeStatus GetStatusSnapshot() const override;                   // 返回 GetStatusSnapshotShared 的副本
+  std::shared_ptr<const my_data::EdgeStatus> GetStatusSnapshotShared() const override; // 无锁：设备/队列版本号均未变化时返回缓存快照，否则重新组装
   void SetEStop(bool active, const std::string& reason) override;           // 负责设置 estop 状态和原因，并在日志中记录
   void Shutdown() override;                                                 // 负责停止设备线程、self action 线程和 snapshot 线程，清理资源，切换 run_state 到 Stopped
   my_data::EdgeId Id() const override;                                      // 负责返回 edge_id        
@@ -55,6 +63,7 @@ public:
   nlohmann::json GetRunTimeStatusInfo() const override;                     // 负责输出运行时状态信息（供 DumpInternalInfo 调用）
   bool AppendJsonTask(const nlohmann::json& task) override;                 // 负责把 JSON 任务转换成 Task 并调用 AppendTask
   bool AppendTask(const my_data::Task& task) override;                      // 负责把 Task 分发到对应队列（受 rw_mutex_ 保护）  
+  bool AppendTask(my_data::Task&& task) override;                           // 同上，Task 移动进队列
 
   // Self task 回调签名: task_id, capability, action, params（均为 string，按需修改）
   using SelfTaskHandler = std::function<void(const my_data::Task& task)>;
@@ -116,12 +125,20 @@ protected:
   std::atomic<bool>         self_task_executing_{false};                    // self task 执行状态
   mutable std::shared_mutex rw_mutex_self_task_;                            // 保护 self_task_
   std::atomic<RunState>     self_task_run_state_{RunState::RunOver};        // self task 执行状态；默认空闲，无待执行任务
-  int                       self_task_execution_step_ms_{1000};             // self task 执行间隔时间戳（毫秒）
+  my_control::TaskQueue*    self_task_queue_{nullptr};                      // 当前 self task 的来源队列（用于 MarkDone）；周期重跑时为空
+  my_control::TaskQueue*    self_queue_{nullptr};                           // self 队列（Init 创建后不变，self_action 线程无需再取 rw_mutex_）
+  std::multimap<std::chrono::steady_clock::time_point, my_data::Task> self_periodic_tasks_; // 下次到期时间 -> 周期 self task（受 rw_mutex_self_task_ 保护）
+  std::atomic<std::uint64_t> self_task_dispatched_{0};                      // 已分发执行的 self task 数（含周期重跑）
+  std::atomic<std::uint64_t> self_task_periodic_runs_{0};                   // 其中周期重跑次数
+  // ------------------------------- 任务日志相关 ----------------------------------------------
+  bool                      task_journal_enable_{false};                    // 是否启用任务预写日志（默认关闭）
+  std::string               task_journal_path_{};                           // 日志路径，默认 ./data/task_journal/<edge_id>.wal
+  std::shared_ptr<my_control::TaskJournal> task_journal_;                   // 所有队列共用一个日志
+  my_control::TaskQueueOptions task_queue_options_{};                       // 所有队列共用：task_queue_mode / task_queue_drop_expired
   // ------------------------------- Submit 相关 ----------------------------------------------
-  bool                      self_task_monitor_enable_{true};                // 启动监控Task 默认启用
-  std::atomic<bool>         self_task_monitor_stop_{false};               // self_task_monitor 线程停止标志 
-  std::thread               self_task_monitor_thread_;                      // self_task_monitor 线程 
-  std::int64_t              self_task_monitor_boot_at_ms_{0};               // self_task_monitor 启动时间戳  
+  bool                      dedup_enable_{true};                            // 是否按 idempotency_key 去重
+  std::int64_t              dedup_default_window_ms_{0};                    // Task 未指定 dedup_window_ms 时的默认窗口（0=不去重）
+  DedupTable                dedup_;                                         // idempotency_key -> 首次 SubmitResult（自带锁）
   // ------------------------------- self action 线程相关 ----------------------------------------------
   bool                      self_action_enable_{true};                      // 启动执行Task 默认启用
   std::atomic<bool>         self_action_stop_{false};                       // self action 线程停止标志 
@@ -133,18 +150,21 @@ protected:
   std::atomic<bool>         snapshot_stop_{false};                          // snapshot 线程停止标志
   std::thread               snapshot_thread_;                               // snapshot 线程
   std::int64_t              snapshot_boot_at_ms_{0};                        // snapshot 启动时间戳
+  // -------------------------------- 状态快照相关 -----------------------------------------------------
+  EdgeStatusCache status_cache_;                                            // GetStatusSnapshotShared 的缓存（读方不取 rw_mutex_）
+
+  /**
+   * @brief 向 status_cache_ 发布设备/队列来源（锁内调用，devices_/queues_ 变化之后）
+   */
+  void PublishStatusSourcesLocked();
 
 protected:
   // -------- 线程相关（锁内调用） --------
 
-  void StartSelfTaskMonitorThreadLocked();
-  void StopSelfTaskMonitorThreadLocked();
-  void SelfTaskMonitorLoop();
-
   /**
-   * @brief 从 self 队列获取任务
+   * @brief 从 self 队列获取任务（阻塞在队列条件变量上，入队即返回）
    * @param out 输出任务
-   * @param timeout_ms 超时时间（毫秒）
+   * @param timeout_ms 超时时间（毫秒），<0 表示一直等到有任务或队列关闭
    * @return 状态码: 0 = 没有队列（NoQueue），1 = 获取成功（OK），2 = 超时（Timeout），3 = 队列已关闭（Shutdown），4 = 错误（Error）5=已有任务未执行
    */
   int FetchSelfTask(my_data::Task& out, int timeout_ms = 500);
@@ -153,6 +173,21 @@ protected:
   void StopSelfActionThreadLocked();
   void SelfActionLoop();
 
+  /**
+   * @brief 执行已装载到 self_task 的任务并收尾；周期任务在这里重新排期
+   */
+  void RunLoadedSelfTask();
+
+  /**
+   * @brief 周期任务的重复间隔：priority==0 且 policy.repeat_interval_ms>0 时返回该值，否则 0（一次性任务）
+   */
+  static std::int64_t SelfTaskRepeatIntervalMs(const my_data::Task& task);
+
+  /**
+   * @brief 取出一个已到期的周期任务；没有到期任务时返回 false，并在 wait_ms 中给出距下一个到期的毫秒数（无周期任务时为 -1）
+   */
+  bool TakeDuePeriodicSelfTask(my_data::Task* out, int* wait_ms);
+
   /**
    * @brief 执行其他任务
    * @param task 要执行的任务
@@ -192,10 +227,27 @@ protected:
                           const std::string& msg,
                           const my_data::RawCommand& cmd,
                           const my_data::DeviceId& device_id = "",
-                          const my_data::TaskId& task_id = 0,
+                          const my_data::TaskId& task_id = "",
                           std::int64_t queue_size_after = 0) const;
 
-  bool AppendTaskToQueueLocked(const my_data::DeviceId& device_id, const my_data::Task& task, std::string* err);
+  // Submit/SubmitBatch 共用（rw_mutex_ 共享锁内调用）：失败时返回 false/nullopt 并写出 fail
+  // received_us：收到命令时的 MonoUs()，写入 Task::trace 并补全 trace_id/span_id
+  bool CheckAcceptingLocked(const my_data::RawCommand& cmd, SubmitResult* fail) const;
+  std::optional<my_data::Task> PrepareTaskLocked(const my_data::RawCommand& cmd, std::int64_t received_us,
+                                                 SubmitResult* fail);
+  bool DedupParamsOf(const my_data::Task& task, std::int64_t* window_ms) const;
+
+  bool AppendTaskToQueueLocked(const my_data::DeviceId& device_id, my_data::Task&& task, std::string* err);
+
+  /**
+   * @brief 打开任务日志，绑定到全部队列并放回未完成任务（锁内调用，Init 时）
+   */
+  bool OpenTaskJournalLocked(std::string* err);
+
+  /**
+   * @brief 解绑并关闭任务日志（锁内调用，队列与设备线程停止之后）
+   */
+  void CloseTaskJournalLocked();
 
 private:
   std::unordered_map<std::string, SelfTaskHandler> self_task_handlers_;
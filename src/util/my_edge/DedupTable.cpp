@@ -0,0 +1,125 @@
+#include "DedupTable.h"
+
+#include <algorithm>
+
+#include "MyLog.h"
+
+namespace my_edge {
+
+DedupTable::DedupTable(DedupTableOptions options) {
+    Reset(options);
+}
+
+void DedupTable::Reset(DedupTableOptions options) {
+    std::lock_guard<std::mutex> lk(mu_);
+    options.slot_ms = std::max<std::int64_t>(1, options.slot_ms);
+    options.max_window_ms = std::max(options.slot_ms, options.max_window_ms);
+    options.max_entries = std::max<std::size_t>(1, options.max_entries);
+    options_ = options;
+
+    entries_.clear();
+    wheel_.clear();
+    wheel_.resize(static_cast<std::size_t>(options_.max_window_ms / options_.slot_ms + 2));
+    cur_tick_ = -1;
+    stats_ = DedupTableStats{};
+}
+
+bool DedupTable::TryReserve(const std::string& key, std::int64_t window_ms, const SubmitResult& value,
+                            my_data::TimestampMs now_ms, SubmitResult* existing) {
+    std::lock_guard<std::mutex> lk(mu_);
+    const std::int64_t now_tick = now_ms / options_.slot_ms;
+    AdvanceLocked(now_tick);
+
+    auto it = entries_.find(key);
+    if (it != entries_.end() && now_ms < it->second.expire_at_ms) {
+        ++stats_.hits;
+        if (existing) *existing = it->second.result;
+        return true;
+    }
+
+    if (it == entries_.end() && entries_.size() >= options_.max_entries) {
+        EvictLocked();
+    }
+
+    // 到期 tick 向上取整，保证至少保留 window_ms
+    window_ms = std::clamp(window_ms, options_.slot_ms, options_.max_window_ms);
+    const my_data::TimestampMs expire_at_ms = now_ms + window_ms;
+    const std::int64_t expire_tick = (expire_at_ms + options_.slot_ms - 1) / options_.slot_ms;
+
+    Entry& e = entries_[key];  // 已过期但尚未清扫的旧条目原地覆盖；旧格子里的引用清扫时按 tick 不符跳过
+    e.result = value;
+    e.expire_at_ms = expire_at_ms;
+    e.expire_tick = expire_tick;
+    wheel_[static_cast<std::size_t>(expire_tick % static_cast<std::int64_t>(wheel_.size()))].push_back(key);
+    ++stats_.inserts;
+    return false;
+}
+
+void DedupTable::Update(const std::string& key, const SubmitResult& value) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        it->second.result = value;
+    }
+}
+
+void DedupTable::Erase(const std::string& key) {
+    std::lock_guard<std::mutex> lk(mu_);
+    entries_.erase(key);  // 格子里的残留 key 在清扫时找不到条目，直接跳过
+}
+
+DedupTableStats DedupTable::Stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    DedupTableStats s = stats_;
+    s.size = entries_.size();
+    return s;
+}
+
+void DedupTable::AdvanceLocked(std::int64_t now_tick) {
+    if (cur_tick_ < 0) {
+        cur_tick_ = now_tick;
+        return;
+    }
+    if (now_tick <= cur_tick_) {
+        return;  // 同一格子内或时钟回拨：不清扫
+    }
+
+    const std::int64_t slots = static_cast<std::int64_t>(wheel_.size());
+    if (now_tick - cur_tick_ >= slots) {
+        // 空闲超过一整圈：所有条目都已到期
+        stats_.expired += entries_.size();
+        entries_.clear();
+        for (auto& bucket : wheel_) bucket.clear();
+    } else {
+        for (std::int64_t t = cur_tick_ + 1; t <= now_tick; ++t) {
+            stats_.expired += SweepBucketLocked(t);
+        }
+    }
+    cur_tick_ = now_tick;
+}
+
+std::size_t DedupTable::SweepBucketLocked(std::int64_t tick) {
+    auto& bucket = wheel_[static_cast<std::size_t>(tick % static_cast<std::int64_t>(wheel_.size()))];
+    std::size_t n = 0;
+    for (const auto& key : bucket) {
+        auto it = entries_.find(key);
+        if (it != entries_.end() && it->second.expire_tick == tick) {
+            entries_.erase(it);
+            ++n;
+        }
+    }
+    bucket.clear();
+    return n;
+}
+
+void DedupTable::EvictLocked() {
+    const std::int64_t slots = static_cast<std::int64_t>(wheel_.size());
+    std::size_t evicted = 0;
+    for (std::int64_t t = cur_tick_ + 1; t < cur_tick_ + slots && entries_.size() >= options_.max_entries; ++t) {
+        evicted += SweepBucketLocked(t);
+    }
+    stats_.evicted += evicted;
+    MYLOG_WARN("[DedupTable] 条目数达到上限 {}，提前淘汰 {} 条", options_.max_entries, evicted);
+}
+
+} // namespace my_edge
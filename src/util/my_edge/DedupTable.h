@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "IEdge.h"
+#include "MyData.h"
+
+namespace my_edge {
+
+struct DedupTableOptions {
+  std::int64_t slot_ms{100};                      // 时间轮格子粒度
+  std::int64_t max_window_ms{10 * 60 * 1000};     // 单个 key 的最长去重窗口（更长的窗口按此截断）
+  std::size_t max_entries{100000};                // 条目上限，超出时提前淘汰最早到期的格子
+};
+
+struct DedupTableStats {
+  std::size_t size{0};
+  std::uint64_t hits{0};      // 命中（判定为重复）
+  std::uint64_t inserts{0};
+  std::uint64_t expired{0};   // 到期清除
+  std::uint64_t evicted{0};   // 因容量上限提前清除
+};
+
+/**
+ * @brief Submit 幂等去重表：idempotency_key -> 首次 SubmitResult
+ *
+ * @details
+ * - 哈希表负责 O(1) 查找；过期由时间轮负责：每个 key 按到期时刻挂到对应格子，
+ *   每次调用只清扫“上次调用以来已到期”的格子，不做全表扫描
+ * - 窗口被截断到 max_window_ms，因此格子数固定（max_window_ms / slot_ms + 2），
+ *   同一格子里只会有同一到期 tick 的有效 key
+ * - 条目数达到 max_entries 时，从最近将到期的格子开始提前淘汰，内存占用有上界
+ * - 线程安全（内部互斥锁）
+ */
+class DedupTable {
+public:
+  explicit DedupTable(DedupTableOptions options = {});
+
+  /**
+   * @brief 清空并按新配置重建（Edge 重复 Init 时调用）
+   */
+  void Reset(DedupTableOptions options);
+
+  /**
+   * @brief 查找 key；未过期则返回 true 并写出首次结果。
+   * 未命中时以 value 占位（窗口 window_ms），返回 false，调用方随后 Update 或 Erase。
+   */
+  bool TryReserve(const std::string& key, std::int64_t window_ms, const SubmitResult& value,
+                  my_data::TimestampMs now_ms, SubmitResult* existing);
+
+  /**
+   * @brief 更新已占位 key 的结果（不改变到期时间）
+   */
+  void Update(const std::string& key, const SubmitResult& value);
+
+  /**
+   * @brief 删除 key（例如入队失败，允许客户端重试）
+   */
+  void Erase(const std::string& key);
+
+  DedupTableStats Stats() const;
+
+private:
+  struct Entry {
+    SubmitResult result;
+    my_data::TimestampMs expire_at_ms{0};
+    std::int64_t expire_tick{0};
+  };
+
+  void AdvanceLocked(std::int64_t now_tick);
+  std::size_t SweepBucketLocked(std::int64_t tick);
+  void EvictLocked();
+
+private:
+  DedupTableOptions options_;
+
+  mutable std::mutex mu_;
+  std::unordered_map<std::string, Entry> entries_;
+  std::vector<std::vector<std::string>> wheel_;  // tick % wheel_.size() -> 该 tick 到期的 key
+  std::int64_t cur_tick_{-1};                    // 已清扫到的 tick（-1 表示尚未使用）
+  DedupTableStats stats_{};
+};
+
+} // namespace my_edge
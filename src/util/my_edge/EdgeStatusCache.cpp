@@ -0,0 +1,94 @@
+#include "EdgeStatusCache.h"
+
+#include <utility>
+
+namespace my_edge {
+
+std::shared_ptr<const my_data::EdgeStatus> EdgeStatusCache::Get(
+    RunState run_state, bool estop, const std::function<std::string()>& estop_reason) const {
+  // 1) 先读版本号再读数据：数据至少与版本号一样新，最坏多组装一次，不会返回过期快照
+  const std::uint64_t sources_version = sources_.Version();
+  const auto sources = sources_.Load();
+
+  std::vector<std::uint64_t> versions;
+  versions.reserve(4 + sources->devices.size() * 2 + 1);
+  versions.push_back(static_cast<std::uint64_t>(run_state));
+  versions.push_back(estop ? 1 : 0);
+  versions.push_back(meta_version_.load());
+  versions.push_back(sources_version);
+  bool volatile_device = false;  // 有设备不发布版本号时每次都重新读取
+  for (const auto& src : sources->devices) {
+    const std::uint64_t dv = src.device ? src.device->StatusVersion() : 0;
+    if (dv == 0) volatile_device = true;
+    versions.push_back(dv);
+    versions.push_back(src.queue ? src.queue->Version() : 0);
+  }
+  versions.push_back(sources->self_queue ? sources->self_queue->Version() : 0);
+
+  const auto cached = cache_.Load();
+  if (!volatile_device && cached->status && cached->versions == versions) {
+    return cached->status;
+  }
+
+  // 2) 有变化：重新组装；版本号未变的设备沿用上一份 DeviceStatus
+  const bool reuse = cached->status && cached->versions.size() == versions.size();
+  auto s = std::make_shared<my_data::EdgeStatus>();
+  s->edge_id = sources->edge_id;
+  s->boot_at_ms = sources->boot_at_ms;
+  s->version = sources->version;
+
+  if (run_state == RunState::Initializing || run_state == RunState::Ready) {
+    s->run_state = my_data::EdgeRunState::Initializing;
+  } else if (run_state == RunState::Running) {
+    s->run_state = estop ? my_data::EdgeRunState::EStop : my_data::EdgeRunState::Running;
+  } else {
+    s->run_state = my_data::EdgeRunState::Degraded;
+  }
+
+  s->estop_active = estop;
+  if (estop_reason) s->estop_reason = estop_reason();
+
+  std::int64_t pending_total = 0;
+  std::int64_t running_total = 0;
+  for (std::size_t i = 0; i < sources->devices.size(); ++i) {
+    const auto& src = sources->devices[i];
+    const std::size_t vi = 4 + i * 2;
+
+    my_data::DeviceStatus ds;
+    bool reused = false;
+    if (reuse && versions[vi] != 0 && versions[vi] == cached->versions[vi]) {
+      auto prev = cached->status->devices.find(src.device_id);
+      if (prev != cached->status->devices.end()) {
+        ds = prev->second;
+        reused = true;
+      }
+    }
+    if (!reused && src.device) {
+      ds = src.device->GetStatusSnapshot();
+    }
+
+    if (src.queue) {
+      ds.queue_depth = static_cast<std::int64_t>(src.queue->Size());
+      pending_total += ds.queue_depth;
+    }
+    if (ds.work_state == my_data::DeviceWorkState::Busy) {
+      running_total += 1;
+    }
+    s->devices[src.device_id] = std::move(ds);
+  }
+
+  // 也把 self 的队列深度统计进去（self 没有 DeviceStatus，可放到 tasks_pending_total）
+  if (sources->self_queue) {
+    pending_total += static_cast<std::int64_t>(sources->self_queue->Size());
+  }
+
+  s->tasks_pending_total = pending_total;
+  s->tasks_running_total = running_total;
+
+  std::shared_ptr<const my_data::EdgeStatus> out = std::move(s);
+  cache_.Publish(Cached{std::move(versions), out});
+  compose_count_.fetch_add(1);
+  return out;
+}
+
+} // namespace my_edge
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "IDevice.h"
+#include "IEdge.h"
+#include "MyData.h"
+#include "TaskQueue.h"
+
+namespace my_edge {
+
+/**
+ * @brief Edge 状态快照缓存：各 Edge 的 GetStatusSnapshotShared 共用实现
+ *
+ * @details
+ * - Edge 在 devices_/queues_ 变化之后（锁内）PublishSources 发布只读的设备/队列引用，读方不再取 Edge 的 rw_mutex_
+ * - Get 以 run_state/estop/meta 版本 + 各设备 StatusVersion + 各队列 Version 组成版本号向量，
+ *   与上次组装时一致则直接返回缓存的同一对象；有设备不发布版本号（StatusVersion()==0）时每次重新组装
+ * - 重新组装时，版本号未变的设备沿用上一份 DeviceStatus
+ * - 共享持有设备/队列：Edge 清理映射时，仍在读取旧快照的线程不会访问已释放的对象
+ * - PublishSources / BumpMeta 由 Edge 在各自的状态锁内串行调用；Get 无锁、可并发
+ */
+class EdgeStatusCache {
+public:
+  struct Source {
+    my_data::DeviceId                              device_id;
+    std::shared_ptr<const my_device::IDevice>      device;
+    std::shared_ptr<const my_control::TaskQueue>   queue;
+  };
+  struct Sources {
+    my_data::EdgeId                                edge_id;
+    std::string                                    version;
+    std::int64_t                                   boot_at_ms{0};
+    std::vector<Source>                            devices;
+    std::shared_ptr<const my_control::TaskQueue>   self_queue;   // 可空；深度计入 tasks_pending_total
+  };
+
+  void PublishSources(Sources sources) { sources_.Publish(std::move(sources)); }
+
+  /**
+   * @brief estop_reason 等没有版本号的字段变化时调用，使下一次 Get 重新组装
+   */
+  void BumpMeta() { meta_version_.fetch_add(1); }
+
+  /**
+   * @brief 取状态快照；版本号均未变化时返回缓存
+   * @param estop_reason 仅在需要重新组装时调用（调用方在其中取 estop 锁）
+   */
+  std::shared_ptr<const my_data::EdgeStatus> Get(RunState run_state, bool estop,
+                                                 const std::function<std::string()>& estop_reason) const;
+
+  std::uint64_t SourcesVersion() const { return sources_.Version(); }
+  std::uint64_t ComposeCount() const { return compose_count_.load(); }   // 实际重新组装 EdgeStatus 的次数
+
+private:
+  // 已组装的快照及其对应的版本号向量
+  struct Cached {
+    std::vector<std::uint64_t>                  versions;
+    std::shared_ptr<const my_data::EdgeStatus>  status;
+  };
+
+  my_data::VersionedSnapshot<Sources> sources_;
+  mutable my_data::VersionedSnapshot<Cached> cache_;
+  std::atomic<std::uint64_t> meta_version_{0};
+  mutable std::atomic<std::uint64_t> compose_count_{0};
+};
+
+} // namespace my_edge
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <memory>
 #include <sstream>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <vector>
 
+#include "JsonUtil.h"
 #include "MyData.h"
 #include "IDevice.h"
 #include "TaskQueue.h"
@@ -16,8 +19,9 @@ using namespace my_control;
 using namespace my_device;
 
 using DeviceID_Type___Mapping = std::unordered_map<my_data::DeviceId, std::string>;
-using DeviceID_Tasks__Mapping = std::unordered_map<my_data::DeviceId, std::unique_ptr<my_control::TaskQueue>>;
-using DeviceID_Device_Mapping = std::unordered_map<my_data::DeviceId, std::unique_ptr<my_device::IDevice>>;
+// shared_ptr：状态快照读方（不持 rw_mutex_）可能在 Init/Shutdown 清理映射之后仍持有设备/队列
+using DeviceID_Tasks__Mapping = std::unordered_map<my_data::DeviceId, std::shared_ptr<my_control::TaskQueue>>;
+using DeviceID_Device_Mapping = std::unordered_map<my_data::DeviceId, std::shared_ptr<my_device::IDevice>>;
 
 /**
  * @brief Submit 结果码：用于表达 Submit 的详细含义（替代 bool）
@@ -29,7 +33,9 @@ enum class SubmitCode {
   InvalidCommand = 3,///< 规范化失败（字段缺失/格式错误）
   UnknownDevice = 4, ///< 未注册 device_id
   QueueShutdown = 5, ///< 队列已 shutdown（通常是 shutdown 过程中）
-  InternalError = 6  ///< 未知异常
+  InternalError = 6, ///< 未知异常
+  BatchAborted = 7,  ///< SubmitBatch 全有或全无模式下，因同批其他命令失败而未入队
+  UnknownEdge = 8    ///< MyEdgeManager 路由时未找到 edge_id
 };
 
 /**
@@ -74,10 +80,42 @@ inline std::string ToString(SubmitCode c) {
     case SubmitCode::UnknownDevice: return "UnknownDevice";
     case SubmitCode::QueueShutdown: return "QueueShutdown";
     case SubmitCode::InternalError: return "InternalError";
+    case SubmitCode::BatchAborted: return "BatchAborted";
+    case SubmitCode::UnknownEdge: return "UnknownEdge";
     default: return "UnknownSubmitCode";
   }
 }
 
+/**
+ * @brief SubmitResult 转 json（API/MQTT 回包使用）
+ */
+inline nlohmann::json ToJson(const SubmitResult& r) {
+  return {
+    {"code", ToString(r.code)},
+    {"message", r.message},
+    {"edge_id", r.edge_id},
+    {"device_id", r.device_id},
+    {"command_id", r.command_id},
+    {"task_id", r.task_id},
+    {"queue_size_after", r.queue_size_after}
+  };
+}
+
+/**
+ * @brief 入口追踪打点（各 Edge 的 Submit/SubmitBatch 在 Normalize 之后调用）
+ * @param received_us Edge 收到命令的时刻（MonoUs，加锁之前取）
+ * @details trace_id 优先沿用 Normalize 结果，其次上游 payload.trace_id，都没有则生成；span_id 每个任务一个
+ */
+inline void StampIngressTrace(my_data::Task& task, const my_data::RawCommand& cmd, std::int64_t received_us) {
+  task.trace.received_us = received_us;
+  task.trace.normalized_us = my_data::MonoUs();
+  if (task.trace_id.empty()) {
+    task.trace_id = my_data::jsonutil::GetStringOr(cmd.payload, "trace_id", "");
+    if (task.trace_id.empty()) task.trace_id = my_data::GenerateId("trace");
+  }
+  if (task.span_id.empty()) task.span_id = my_data::GenerateId("span");
+}
+
 /**
  * @brief Edge 运行状态（用于区分 Init/Start 阶段，以及运行中状态）
  * 
@@ -125,11 +163,45 @@ public:
    */
   virtual SubmitResult Submit(const my_data::RawCommand& cmd) = 0;
 
+  /**
+   * @brief SubmitBatch：批量命令入口（如任务上传时一次下发的航点/动作序列）
+   * @param cmds 命令列表（移动传入）
+   * @param atomic true 表示全有或全无：任一命令失败则整批不入队，其余命令返回 BatchAborted
+   * @return 与 cmds 一一对应的结果
+   * @details 默认实现逐条调用 Submit，不支持 atomic（此时整批返回 InternalError）；
+   *          BaseEdge / UUVEdge / TUNAEdge 均覆盖为一次加锁校验 + 按设备分组批量入队
+   */
+  virtual std::vector<SubmitResult> SubmitBatch(std::vector<my_data::RawCommand>&& cmds, bool atomic = false) {
+    std::vector<SubmitResult> results;
+    results.reserve(cmds.size());
+    for (const auto& cmd : cmds) {
+      if (atomic) {
+        SubmitResult r;
+        r.code = SubmitCode::InternalError;
+        r.message = "atomic SubmitBatch not supported by edge_type=" + EdgeType();
+        r.edge_id = Id();
+        r.command_id = cmd.command_id;
+        results.push_back(std::move(r));
+      } else {
+        results.push_back(Submit(cmd));
+      }
+    }
+    return results;
+  }
+
   /**
    * @brief 获取状态快照（EdgeStatus，补 queue_depth/pending/running）
    */
   virtual my_data::EdgeStatus GetStatusSnapshot() const = 0;
 
+  /**
+   * @brief 获取只读状态快照（可共享，调用方不得修改）
+   * 默认实现每次重新生成；BaseEdge 在设备/队列状态未变化时返回缓存的同一对象。
+   */
+  virtual std::shared_ptr<const my_data::EdgeStatus> GetStatusSnapshotShared() const {
+    return std::make_shared<const my_data::EdgeStatus>(GetStatusSnapshot());
+  }
+
   /**
    * @brief 设置紧急停止
    */
@@ -181,6 +253,14 @@ public:
      * @return 如果成功添加任务则返回 true，否则返回 false。
      */
   virtual bool AppendTask(const my_data::Task& task) = 0;
+
+  /**
+     * @brief 向 Edge 添加任务（移动语义，调用方不再使用 task）。
+     * @details 默认转调 const 引用版本；BaseEdge 覆盖为一路移动到队列、不拷贝 Task。
+     */
+  virtual bool AppendTask(my_data::Task&& task) {
+    return AppendTask(static_cast<const my_data::Task&>(task));
+  }
 };
 
 } // namespace my_edge
\ No newline at end of file
@@ -1,10 +1,42 @@
 #include "MyEdgeManager.h"
 #include "MyLog.h"
+#include "MqttService.hpp"
+#include "WorkflowScheduler.h"
 #include "demo/Task.h"
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 
 namespace my_edge {
 
+namespace {
+
+SubmitResult MakeRouteError(SubmitCode code, std::string message, const std::string& edge_id,
+                            const my_data::RawCommand& cmd) {
+    SubmitResult r;
+    r.code = code;
+    r.message = std::move(message);
+    r.edge_id = edge_id;
+    r.command_id = cmd.command_id;
+    return r;
+}
+
+// 路由热路径：未找到/异常都转成结果码，不向上抛
+SubmitResult SubmitOne(const std::string& edge_id, const std::shared_ptr<IEdge>& edge,
+                       const my_data::RawCommand& cmd) {
+    if (!edge) {
+        return MakeRouteError(SubmitCode::UnknownEdge, "未知 edge_id=" + edge_id, edge_id, cmd);
+    }
+    try {
+        return edge->Submit(cmd);
+    } catch (const std::exception& e) {
+        MYLOG_ERROR("向 Edge '{}' 提交命令时发生异常: {}", edge_id, e.what());
+        return MakeRouteError(SubmitCode::InternalError, std::string("Submit 异常: ") + e.what(), edge_id, cmd);
+    }
+}
+
+}  // namespace
+
 MyEdgeManager& MyEdgeManager::GetInstance() {
     try {
         static MyEdgeManager instance;
@@ -25,12 +57,16 @@ bool MyEdgeManager::appendEdge(std::unique_ptr<IEdge> edge_ptr) {
         std::string edge_id = edge_ptr->Id();
         std::lock_guard<std::mutex> lock(mutex_);
 
-        if (edges_.find(edge_id) != edges_.end()) {
+        auto current = routes_.Load();
+        if (current->find(edge_id) != current->end()) {
             MYLOG_WARN("ID 为 '" + edge_id + "' 的 Edge 已存在。");
             throw DuplicateEdgeException(edge_id);
         }
 
-        edges_[edge_id] = std::move(edge_ptr);
+        // 写时复制：新表发布后，正在读旧表的路由调用不受影响
+        RouteTable next = *current;
+        next.emplace(edge_id, std::shared_ptr<IEdge>(std::move(edge_ptr)));
+        routes_.Publish(std::move(next));
         MYLOG_INFO("ID 为 '" + edge_id + "' 的 Edge 添加成功。");
         return true;
     } catch (const DuplicateEdgeException&) {
@@ -45,8 +81,8 @@ const std::vector<const IEdge*>& MyEdgeManager::getEdges() const {
     try {
         static thread_local std::vector<const IEdge*> temp_ptrs;
         temp_ptrs.clear();
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (const auto& pair : edges_) {
+        auto routes = routes_.Load();
+        for (const auto& pair : *routes) {
             temp_ptrs.push_back(pair.second.get());
         }
         return temp_ptrs;
@@ -61,8 +97,8 @@ const std::vector<std::string>& MyEdgeManager::getEdgeIds() const {
     try {
         static thread_local std::vector<std::string> temp_ids;
         temp_ids.clear();
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (const auto& pair : edges_) {
+        auto routes = routes_.Load();
+        for (const auto& pair : *routes) {
             temp_ids.push_back(pair.first);
         }
         return temp_ids;
@@ -76,12 +112,14 @@ const std::vector<std::string>& MyEdgeManager::getEdgeIds() const {
 bool MyEdgeManager::deleteEdgeById(const std::string& edge_id) {
     try {
         std::lock_guard<std::mutex> lock(mutex_);
-        auto it = edges_.find(edge_id);
-        if (it == edges_.end()) {
+        auto current = routes_.Load();
+        if (current->find(edge_id) == current->end()) {
             MYLOG_WARN("尝试删除不存在的 Edge，ID 为 '" + edge_id + "'。");
             return false;
         }
-        edges_.erase(it);
+        RouteTable next = *current;
+        next.erase(edge_id);
+        routes_.Publish(std::move(next));
         MYLOG_INFO("ID 为 '" + edge_id + "' 的 Edge 删除成功。");
         return true;
     } catch (const std::exception& e) {
@@ -93,8 +131,9 @@ bool MyEdgeManager::deleteEdgeById(const std::string& edge_id) {
 bool MyEdgeManager::startAllEdges() {
     try {
         std::lock_guard<std::mutex> lock(mutex_);
+        auto routes = routes_.Load();
         bool all_success = true;
-        for (auto& pair : edges_) {
+        for (auto& pair : *routes) {
             std::string error_msg;
             try {
                 if (!pair.second->Start(&error_msg)) {
@@ -119,10 +158,11 @@ bool MyEdgeManager::stopAllEdges() {
     MYLOG_INFO("开始停止所有 Edge 设备...");
     try {
         std::lock_guard<std::mutex> lock(mutex_);
+        auto routes = routes_.Load();
         bool all_success = true;
-        MYLOG_INFO("当前 Edge 设备数量: {}", edges_.size());
+        MYLOG_INFO("当前 Edge 设备数量: {}", routes->size());
         int index = 0;
-        for (auto& pair : edges_) {
+        for (auto& pair : *routes) {
             index++;
             MYLOG_INFO("正在停止 ID 为 '{}' 的 Edge 设备，序号: {}", pair.first, index);
             try {
@@ -142,28 +182,27 @@ bool MyEdgeManager::stopAllEdges() {
     return false;
 }
 
-const std::unique_ptr<IEdge>& MyEdgeManager::getEdgeById(const std::string& edge_id) const {
-    try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = edges_.find(edge_id);
-        if (it == edges_.end()) {
-            MYLOG_WARN("ID 为 '" + edge_id + "' 的 Edge 未找到。");
-        } else {
-            MYLOG_INFO("ID 为 '" + edge_id + "' 的 Edge 获取成功。");
-            return it->second;
-        }
-    } catch (const std::exception& e) {
-        MYLOG_ERROR("获取 Edge 时发生异常: " + std::string(e.what()));
+std::shared_ptr<IEdge> MyEdgeManager::getEdgeById(const std::string& edge_id) const {
+    auto edge = findEdge(edge_id);
+    if (!edge) {
+        MYLOG_WARN("ID 为 '" + edge_id + "' 的 Edge 未找到。");
+        throw EdgeNotFoundException(edge_id);
     }
-    return nullptr;  // 永远不会到达
+    return edge;
+}
+
+std::shared_ptr<IEdge> MyEdgeManager::findEdge(const std::string& edge_id) const {
+    auto routes = routes_.Load();
+    auto it = routes->find(edge_id);
+    return it == routes->end() ? nullptr : it->second;
 }
 
 nlohmann::json MyEdgeManager::GetHeartbeatInfo() const {
     nlohmann::json heartbeat_info = nlohmann::json::object();
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (const auto& pair : edges_) {
-            heartbeat_info[pair.first] = pair.second->GetStatusSnapshot().toJson();
+        auto routes = routes_.Load();
+        for (const auto& pair : *routes) {
+            heartbeat_info[pair.first] = pair.second->GetStatusSnapshotShared()->toJson();
         }
     } catch (const std::exception& e) {
         MYLOG_ERROR("获取 Heartbeat 信息时发生异常: " + std::string(e.what()));
@@ -173,8 +212,7 @@ nlohmann::json MyEdgeManager::GetHeartbeatInfo() const {
 
 bool MyEdgeManager::HasEdge(const std::string& edge_id) const {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return edges_.find(edge_id) != edges_.end();
+        return findEdge(edge_id) != nullptr;
     } catch (const std::exception& e) {
         MYLOG_ERROR("检查 Edge 存在性时发生异常: " + std::string(e.what()));
         return false;
@@ -183,8 +221,7 @@ bool MyEdgeManager::HasEdge(const std::string& edge_id) const {
 
 bool MyEdgeManager::IsEmpty() const {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return edges_.empty();
+        return routes_.Load()->empty();
     } catch (const std::exception& e) {
         MYLOG_ERROR("检查 Edge 集合是否为空时发生异常: " + std::string(e.what()));
         return true;  // 出错时假设为空
@@ -193,14 +230,13 @@ bool MyEdgeManager::IsEmpty() const {
 
 bool MyEdgeManager::SelectEdgeByIdDoAction(const std::string& edge_id, const nlohmann::json& action) const {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = edges_.find(edge_id);
-        if (it == edges_.end()) {
+        auto edge = findEdge(edge_id);
+        if (!edge) {
             MYLOG_WARN("ID 为 '" + edge_id + "' 的 Edge 未找到，无法执行操作。");
             return false;
         }
         bool result = false;
-        // return it->second->ExecuteAction(action);
+        // return edge->ExecuteAction(action);
         return result;
     } catch (const std::exception& e) {
         MYLOG_ERROR("对 Edge 执行操作时发生异常: " + std::string(e.what()));
@@ -211,16 +247,15 @@ bool MyEdgeManager::SelectEdgeByIdDoAction(const std::string& edge_id, const nlo
 bool MyEdgeManager::appendTaskToEdgeById(const std::string& edge_id, const nlohmann::json& task) const {
     MYLOG_INFO("尝试向 ID 为 '{}' 的 Edge 添加任务: {}", edge_id, task.dump(4));
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = edges_.find(edge_id);
-        if (it == edges_.end()) {
+        auto edge = findEdge(edge_id);
+        if (!edge) {
             MYLOG_WARN("ID 为 '" + edge_id + "' 的 Edge 未找到，无法添加任务。");
             return false;
         } else {
             MYLOG_INFO("找到 ID 为 '{}' 的 Edge，准备添加任务。", edge_id);
         }
         bool result = false;
-        result = it->second->AppendJsonTask(task);
+        result = edge->AppendJsonTask(task);
         return result;
     } catch (const std::exception& e) {
         MYLOG_ERROR("向 Edge 添加任务时发生异常: " + std::string(e.what()));
@@ -229,18 +264,21 @@ bool MyEdgeManager::appendTaskToEdgeById(const std::string& edge_id, const nlohm
 }
 
 bool MyEdgeManager::appendTaskToEdgeByIdV2(const std::string& edge_id, const my_data::Task& task) const {
+    return appendTaskToEdgeByIdV2(edge_id, my_data::Task(task));
+}
+
+bool MyEdgeManager::appendTaskToEdgeByIdV2(const std::string& edge_id, my_data::Task&& task) const {
     MYLOG_INFO("尝试向 ID 为 '{}' 的 Edge 添加任务: {}", edge_id, task.toString());
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = edges_.find(edge_id);
-        if (it == edges_.end()) {
+        auto edge = findEdge(edge_id);
+        if (!edge) {
             MYLOG_WARN("ID 为 '" + edge_id + "' 的 Edge 未找到，无法添加任务。");
             return false;
         } else {
             MYLOG_INFO("找到 ID 为 '{}' 的 Edge，准备添加任务。", edge_id);
         }
         bool result = false;
-        result = it->second->AppendTask(task);
+        result = edge->AppendTask(std::move(task));
         return result;
     } catch (const std::exception& e) {
         MYLOG_ERROR("向 Edge 添加任务时发生异常: " + std::string(e.what()));
@@ -248,16 +286,275 @@ bool MyEdgeManager::appendTaskToEdgeByIdV2(const std::string& edge_id, const my_
     }
 }
 
+bool MyEdgeManager::submitBatchToEdgeById(const std::string& edge_id,
+                                          std::vector<my_data::RawCommand>&& cmds,
+                                          bool atomic,
+                                          std::vector<SubmitResult>* results) const {
+    MYLOG_INFO("尝试向 ID 为 '{}' 的 Edge 批量提交命令: count={}, atomic={}", edge_id, cmds.size(), atomic);
+    try {
+        auto edge = findEdge(edge_id);
+        if (!edge) {
+            MYLOG_WARN("ID 为 '" + edge_id + "' 的 Edge 未找到，无法批量提交。");
+            return false;
+        }
+        auto r = edge->SubmitBatch(std::move(cmds), atomic);
+        if (results) *results = std::move(r);
+        return true;
+    } catch (const std::exception& e) {
+        MYLOG_ERROR("向 Edge 批量提交命令时发生异常: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool MyEdgeManager::submitBatchJson(const nlohmann::json& request, nlohmann::json* response, std::string* err) const {
+    if (!request.is_object()) {
+        if (err) *err = "request must be a json object";
+        return false;
+    }
+    auto eit = request.find("edge_id");
+    const std::string edge_id = (eit != request.end() && eit->is_string()) ? eit->get<std::string>() : std::string();
+    if (edge_id.empty()) {
+        if (err) *err = "edge_id required";
+        return false;
+    }
+    auto cit = request.find("commands");
+    if (cit == request.end() || !cit->is_array() || cit->empty()) {
+        if (err) *err = "commands must be a non-empty array";
+        return false;
+    }
+    if (cit->size() > kMaxBatchCommands) {
+        if (err) *err = "too many commands (max " + std::to_string(kMaxBatchCommands) + ")";
+        return false;
+    }
+    // json::value 遇到类型不符会抛 type_error（MQTT 回调里没有兜底），这里先校验，按参数错误返回
+    auto ait = request.find("atomic");
+    if (ait != request.end() && !ait->is_boolean()) {
+        if (err) *err = "atomic must be a boolean";
+        return false;
+    }
+    const bool atomic = ait != request.end() && ait->get<bool>();
+    auto sit = request.find("source");
+    if (sit != request.end() && !sit->is_string()) {
+        if (err) *err = "source must be a string";
+        return false;
+    }
+    const std::string source = sit != request.end() ? sit->get<std::string>() : std::string("batch");
+
+    std::vector<my_data::RawCommand> cmds;
+    cmds.reserve(cit->size());
+    const my_data::TimestampMs now_ms = my_data::NowMs();
+    for (const auto& cj : *cit) {
+        my_data::RawCommand c = my_data::RawCommand::fromJson(cj);
+        if (c.source.empty()) c.source = source;
+        if (c.received_at_ms == 0) c.received_at_ms = now_ms;
+        cmds.push_back(std::move(c));
+    }
+    const std::size_t total = cmds.size();
+
+    std::vector<SubmitResult> results;
+    if (!submitBatchToEdgeById(edge_id, std::move(cmds), atomic, &results)) {
+        if (err) *err = "edge not found: " + edge_id;
+        return false;
+    }
+
+    std::size_t accepted = 0;
+    nlohmann::json rj = nlohmann::json::array();
+    for (const auto& r : results) {
+        if (r.ok()) ++accepted;
+        rj.push_back(ToJson(r));
+    }
+    if (response) {
+        *response = {
+            {"edge_id", edge_id},
+            {"atomic", atomic},
+            {"total", total},
+            {"accepted", accepted},
+            {"results", std::move(rj)}
+        };
+    }
+    return true;
+}
+
+SubmitResult MyEdgeManager::submitToEdge(const std::string& edge_id, const my_data::RawCommand& cmd) const {
+    return SubmitOne(edge_id, findEdge(edge_id), cmd);
+}
+
+std::vector<SubmitResult> MyEdgeManager::fanoutSubmit(const std::vector<std::string>& edge_ids,
+                                                      const my_data::RawCommand& cmd) const {
+    // 1) 目标取自同一份路由快照
+    auto routes = routes_.Load();
+    std::vector<std::pair<std::string, std::shared_ptr<IEdge>>> targets;
+    if (edge_ids.empty()) {
+        targets.reserve(routes->size());
+        for (const auto& pair : *routes) {
+            targets.emplace_back(pair.first, pair.second);
+        }
+    } else {
+        targets.reserve(edge_ids.size());
+        for (const auto& id : edge_ids) {
+            auto it = routes->find(id);
+            targets.emplace_back(id, it == routes->end() ? nullptr : it->second);
+        }
+    }
+
+    const std::size_t n = targets.size();
+    std::vector<SubmitResult> results(n);
+    if (n == 0) return results;
+    if (n == 1) {
+        results[0] = SubmitOne(targets[0].first, targets[0].second, cmd);
+        return results;
+    }
+
+    // 2) 认领式并行：调用线程与工作线程从同一个计数器领取下标，领不到就退出。
+    //    晚到的工作线程只访问 state（共享持有），不会碰到本函数返回后的栈上数据。
+    struct FanoutState {
+        std::atomic<std::size_t> next{0};
+        std::mutex mu;
+        std::condition_variable cv;
+        std::size_t done{0};
+    };
+    auto state = std::make_shared<FanoutState>();
+    auto drain = [state, n, &targets, &results, &cmd]() {
+        while (true) {
+            const std::size_t i = state->next.fetch_add(1);
+            if (i >= n) return;
+            results[i] = SubmitOne(targets[i].first, targets[i].second, cmd);
+            std::lock_guard<std::mutex> lk(state->mu);
+            if (++state->done == n) state->cv.notify_all();
+        }
+    };
+
+    const std::size_t helpers = std::min<std::size_t>(n - 1, std::max(1u, std::thread::hardware_concurrency()));
+    for (std::size_t h = 0; h < helpers; ++h) {
+        my_control::WorkflowScheduler::GetInstance().Post([state, n, drain]() {
+            if (state->next.load() >= n) return;  // 已被领完
+            drain();
+        });
+    }
+    drain();
+
+    std::unique_lock<std::mutex> lk(state->mu);
+    state->cv.wait(lk, [&]() { return state->done == n; });
+    return results;
+}
+
+bool MyEdgeManager::fanoutSubmitJson(const nlohmann::json& request, nlohmann::json* response, std::string* err) const {
+    if (!request.is_object()) {
+        if (err) *err = "request must be a json object";
+        return false;
+    }
+    auto cit = request.find("command");
+    if (cit == request.end() || !cit->is_object()) {
+        if (err) *err = "command must be a json object";
+        return false;
+    }
+
+    std::vector<std::string> edge_ids;
+    auto eit = request.find("edge_ids");
+    if (eit != request.end() && !eit->is_null()) {
+        if (!eit->is_array()) {
+            if (err) *err = "edge_ids must be an array";
+            return false;
+        }
+        if (eit->size() > kMaxFanoutEdges) {
+            if (err) *err = "too many edge_ids (max " + std::to_string(kMaxFanoutEdges) + ")";
+            return false;
+        }
+        for (const auto& id : *eit) {
+            if (!id.is_string()) {
+                if (err) *err = "edge_ids must contain strings";
+                return false;
+            }
+            edge_ids.push_back(id.get<std::string>());
+        }
+    }
+
+    my_data::RawCommand cmd = my_data::RawCommand::fromJson(*cit);
+    if (cmd.source.empty()) cmd.source = request.value("source", std::string("fanout"));
+    if (cmd.received_at_ms == 0) cmd.received_at_ms = my_data::NowMs();
+
+    const auto results = fanoutSubmit(edge_ids, cmd);
+
+    std::size_t accepted = 0;
+    nlohmann::json rj = nlohmann::json::array();
+    for (const auto& r : results) {
+        if (r.ok()) ++accepted;
+        rj.push_back(ToJson(r));
+    }
+    if (response) {
+        *response = {
+            {"total", results.size()},
+            {"accepted", accepted},
+            {"results", std::move(rj)}
+        };
+    }
+    return true;
+}
+
+void MyEdgeManager::registerMqttRoutes() {
+    static const std::string kRequestTopic = "edge/submit_batch";
+    static const std::string kResultTopic = "edge/submit_batch/result";
+
+    my_mqtt::MqttService::GetInstance().AddRoute(kRequestTopic, [this](const std::string& topic, const std::string& payload) {
+        nlohmann::json resp;
+        std::string err;
+        nlohmann::json req = nlohmann::json::parse(payload, nullptr, false);
+        if (req.is_discarded()) {
+            err = "payload is not valid json";
+        } else if (req.is_object() && !req.contains("source")) {
+            req["source"] = "mqtt";
+        }
+        const bool ok = err.empty() && submitBatchJson(req, &resp, &err);
+        if (!ok) {
+            MYLOG_WARN("MQTT 批量提交失败: topic={}, err={}", topic, err);
+            resp = {{"ok", false}, {"error", err}};
+        } else {
+            resp["ok"] = true;
+        }
+        // 回带请求方的 request_id，便于关联
+        if (req.is_object() && req.contains("request_id")) {
+            resp["request_id"] = req["request_id"];
+        }
+        my_mqtt::MqttService::GetInstance().Publish(kResultTopic, resp.dump(), 1, false);
+    }, 1);
+    MYLOG_INFO("已注册 MQTT 批量提交入口: {} -> {}", kRequestTopic, kResultTopic);
+
+    static const std::string kFanoutTopic = "edge/fanout";
+    static const std::string kFanoutResultTopic = "edge/fanout/result";
+
+    my_mqtt::MqttService::GetInstance().AddRoute(kFanoutTopic, [this](const std::string& topic, const std::string& payload) {
+        nlohmann::json resp;
+        std::string err;
+        nlohmann::json req = nlohmann::json::parse(payload, nullptr, false);
+        if (req.is_discarded()) {
+            err = "payload is not valid json";
+        } else if (req.is_object() && !req.contains("source")) {
+            req["source"] = "mqtt";
+        }
+        const bool ok = err.empty() && fanoutSubmitJson(req, &resp, &err);
+        if (!ok) {
+            MYLOG_WARN("MQTT 扇出提交失败: topic={}, err={}", topic, err);
+            resp = {{"ok", false}, {"error", err}};
+        } else {
+            resp["ok"] = true;
+        }
+        if (req.is_object() && req.contains("request_id")) {
+            resp["request_id"] = req["request_id"];
+        }
+        my_mqtt::MqttService::GetInstance().Publish(kFanoutResultTopic, resp.dump(), 1, false);
+    }, 1);
+    MYLOG_INFO("已注册 MQTT 扇出提交入口: {} -> {}", kFanoutTopic, kFanoutResultTopic);
+}
+
 bool MyEdgeManager::setESTOP(const std::string& edge_id, bool estop) const {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = edges_.find(edge_id);
-        if (it == edges_.end()) {
+        auto edge = findEdge(edge_id);
+        if (!edge) {
             MYLOG_WARN("ID 为 '" + edge_id + "' 的 Edge 未找到，无法设置 ESTOP。");
             return false;
         }
         bool result = false;
-        // return it->second->SetESTOP(estop);
+        // return edge->SetESTOP(estop);
         return result;
     } catch (const std::exception& e) {
         MYLOG_ERROR("设置 Edge ESTOP 时发生异常: " + std::string(e.what()));
@@ -267,9 +564,9 @@ bool MyEdgeManager::setESTOP(const std::string& edge_id, bool estop) const {
 
 bool MyEdgeManager::setAllEdgesESTOP(bool estop) const {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
+        auto routes = routes_.Load();
         bool all_success = true;
-        for (auto& pair : edges_) {
+        for (auto& pair : *routes) {
             try {
                 // if (!pair.second->SetESTOP(estop)) {
                 //     MYLOG_ERROR("设置 ID 为 '" + pair.first + "' 的 Edge ESTOP 失败。");
@@ -291,14 +588,13 @@ bool MyEdgeManager::setAllEdgesESTOP(bool estop) const {
 
 bool MyEdgeManager::getEdgeOnlineStatus(const std::string& edge_id) const {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = edges_.find(edge_id);
-        if (it == edges_.end()) {
+        auto edge = findEdge(edge_id);
+        if (!edge) {
             MYLOG_WARN("ID 为 '" + edge_id + "' 的 Edge 未找到，无法获取在线状态。");
             return false;
         }
         bool result = false;
-        // return it->second->IsOnline();
+        // return edge->IsOnline();
         return result;  // 占位符
     } catch (const std::exception& e) {
         MYLOG_ERROR("获取 Edge 在线状态时发生异常: " + std::string(e.what()));
@@ -308,8 +604,8 @@ bool MyEdgeManager::getEdgeOnlineStatus(const std::string& edge_id) const {
 
 bool MyEdgeManager::getAllEdgesOnlineStatus(std::unordered_map<std::string, bool>& status_map) const {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (const auto& pair : edges_) {
+        auto routes = routes_.Load();
+        for (const auto& pair : *routes) {
             // status_map[pair.first] = pair.second->IsOnline();
         }
         return true;
@@ -323,9 +619,9 @@ bool MyEdgeManager::getAllEdgesOnlineStatus(std::unordered_map<std::string, bool
 bool MyEdgeManager::getOnlineEdges(std::vector<std::string>& online_edges) const {
     MYLOG_INFO("获取在线 Edges 列表...");
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
+        auto routes = routes_.Load();
         online_edges.clear();
-        for (const auto& pair : edges_) {
+        for (const auto& pair : *routes) {
             // if (pair.second->IsOnline()) {
             //     online_edges.push_back(pair.first);
             // }
@@ -341,13 +637,12 @@ bool MyEdgeManager::getOnlineEdges(std::vector<std::string>& online_edges) const
 
 bool MyEdgeManager::getEdgeTaskStatus(const std::string& edge_id, nlohmann::json& task_status) const {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = edges_.find(edge_id);
-        if (it == edges_.end()) {
+        auto edge = findEdge(edge_id);
+        if (!edge) {
             MYLOG_WARN("ID 为 '" + edge_id + "' 的 Edge 未找到，无法获取任务状态。");
             return false;
         }
-        // task_status = it->second->GetTaskStatus();
+        // task_status = edge->GetTaskStatus();
         return true;
     } catch (const std::exception& e) {
         MYLOG_ERROR("获取 Edge 任务状态时发生异常: " + std::string(e.what()));
@@ -357,13 +652,12 @@ bool MyEdgeManager::getEdgeTaskStatus(const std::string& edge_id, nlohmann::json
 
 bool MyEdgeManager::getEdgeHistoryTaskStatus(const std::string& edge_id, nlohmann::json& history_task_status) const {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = edges_.find(edge_id);
-        if (it == edges_.end()) {
+        auto edge = findEdge(edge_id);
+        if (!edge) {
             MYLOG_WARN("ID 为 '" + edge_id + "' 的 Edge 未找到，无法获取历史任务状态。");
             return false;
         }
-        // history_task_status = it->second->GetHistoryTaskStatus();
+        // history_task_status = edge->GetHistoryTaskStatus();
         return true;
     } catch (const std::exception& e) {
         MYLOG_ERROR("获取 Edge 历史任务状态时发生异常: " + std::string(e.what()));
@@ -374,13 +668,12 @@ bool MyEdgeManager::getEdgeHistoryTaskStatus(const std::string& edge_id, nlohman
 bool MyEdgeManager::getEdgeInternalDumpInfo(const std::string& edge_id, nlohmann::json& dump_info) const {
     bool foundStatus = false;
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = edges_.find(edge_id);
-        if (it == edges_.end()) {
+        auto edge = findEdge(edge_id);
+        if (!edge) {
             MYLOG_WARN("ID 为 '" + edge_id + "' 的 Edge 未找到，无法获取内部信息 Dump。");
             foundStatus = false;
         } else {
-            dump_info = it->second->DumpInternalInfo();
+            dump_info = edge->DumpInternalInfo();
             foundStatus = true;
         }
     } catch (const std::exception& e) {
@@ -393,13 +686,12 @@ bool MyEdgeManager::getEdgeInternalDumpInfo(const std::string& edge_id, nlohmann
 bool MyEdgeManager::getEdgeRunTimeStatusInfo(const std::string& edge_id, nlohmann::json& status_info) const {
     bool foundStatus = false;
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = edges_.find(edge_id);
-        if (it == edges_.end()) {
+        auto edge = findEdge(edge_id);
+        if (!edge) {
             MYLOG_WARN("ID 为 '" + edge_id + "' 的 Edge 未找到，无法获取运行时状态信息。");
             foundStatus = false;
         } else {
-            status_info = it->second->GetRunTimeStatusInfo();
+            status_info = edge->GetRunTimeStatusInfo();
             foundStatus = true;
         }
     } catch (const std::exception& e) {
@@ -6,6 +6,7 @@
 #include <mutex>
 #include <nlohmann/json.hpp>
 #include "IEdge.h"
+#include "MyData.h"
 #include "MyLog.h"
 
 namespace my_edge {
@@ -32,7 +33,12 @@ public:
  * @brief MyEdgeManager - 企业级单例 IEdge 实例管理器。
  * 
  * 此类提供线程安全的操作，用于管理 IEdge 对象的集合。
- * 使用 std::unique_ptr 进行独占所有权，使用 std::unordered_map 进行高效查找。
+ *
+ * 路由表（edge_id -> IEdge）按 RCU 方式维护：
+ * - 读（命令路由、状态查询）无锁取当前快照（my_data::VersionedSnapshot），多个 REST/MQTT 线程互不串行
+ * - 写（append/delete）在 mutex_ 内复制一份新表再整体发布；Edge 以 shared_ptr 持有，
+ *   删除后正在使用它的路由调用仍可安全完成，最后一个持有者释放时析构
+ * - 热路径（findEdge / submitToEdge / fanoutSubmit）未命中时返回 nullptr 或 SubmitCode::UnknownEdge，不抛异常
  */
 class MyEdgeManager {
 public:
@@ -83,14 +89,50 @@ public:
     bool stopAllEdges();
 
     /**
-     * @brief 通过 ID 获取 Edge（只读）。
+     * @brief 通过 ID 获取 Edge。
      * @param edge_id Edge 的 ID。
-     * @return 唯一指针的常量引用。
+     * @return Edge 的共享指针（调用方持有期间即使被删除也不会析构）。
      * @throws EdgeNotFoundException 如果未找到。
-     * 
-     * 注意：返回常量引用，不会导致集合变动。
+     *
+     * 注意：命令路由等热路径请使用 findEdge（未命中返回 nullptr，不抛异常）。
+     */
+    std::shared_ptr<IEdge> getEdgeById(const std::string& edge_id) const;
+
+    /**
+     * @brief 无锁查找 Edge（读路由快照）。
+     * @return 未找到时返回 nullptr。
+     */
+    std::shared_ptr<IEdge> findEdge(const std::string& edge_id) const;
+
+    /**
+     * @brief 向指定 Edge 提交一条命令（转调 IEdge::Submit）。
+     * @return Edge 未找到时 code=UnknownEdge；Edge 抛出异常时 code=InternalError。
+     */
+    SubmitResult submitToEdge(const std::string& edge_id, const my_data::RawCommand& cmd) const;
+
+    /**
+     * @brief 把同一条命令并行下发到多个 Edge。
+     * @param edge_ids 目标 Edge；为空表示全部 Edge。
+     * @return 与 edge_ids 一一对应的结果（edge_ids 为空时按路由表顺序）。
+     *
+     * 各 Edge 的 Submit 在 WorkflowScheduler 的工作线程上并行执行，调用线程同时参与处理，
+     * 因此即使从工作线程调用也不会因等待自身而阻塞。
+     */
+    std::vector<SubmitResult> fanoutSubmit(const std::vector<std::string>& edge_ids,
+                                           const my_data::RawCommand& cmd) const;
+
+    /**
+     * @brief JSON 形式的扇出提交（REST 与 MQTT 入口共用）。
+     * 请求：{"edge_ids": ["...", ...]（省略或为空表示全部）, "command": RawCommand}
+     * 响应：{"total", "accepted", "results": [SubmitResult, ...]}
+     * @return 请求格式错误时返回 false，并写入 err。
+     */
+    bool fanoutSubmitJson(const nlohmann::json& request, nlohmann::json* response, std::string* err) const;
+
+    /**
+     * @brief 路由表版本（每次 append/delete 递增）。
      */
-    const std::unique_ptr<IEdge>& getEdgeById(const std::string& edge_id) const;
+    std::uint64_t routeVersion() const { return routes_.Version(); }
 
     /**
      * @brief Get the Heartbeat Info object/获取给模块的心跳信息
@@ -197,14 +239,50 @@ public:
      */
     bool appendTaskToEdgeByIdV2(const std::string& edge_id, const my_data::Task& task) const;
 
+    /**
+     * @brief 同上，Task 移动传给 Edge（不拷贝）。
+     */
+    bool appendTaskToEdgeByIdV2(const std::string& edge_id, my_data::Task&& task) const;
+
+    /**
+     * @brief 向指定 ID 的 Edge 批量提交命令（转调 IEdge::SubmitBatch）。
+     * @param atomic 全有或全无。
+     * @param results 与 cmds 一一对应的结果。
+     * @return Edge 未找到或发生异常时返回 false。
+     */
+    bool submitBatchToEdgeById(const std::string& edge_id,
+                               std::vector<my_data::RawCommand>&& cmds,
+                               bool atomic,
+                               std::vector<SubmitResult>* results) const;
+
+    /**
+     * @brief JSON 形式的批量提交（REST 与 MQTT 入口共用）。
+     * 请求：{"edge_id": "...", "atomic": false, "commands": [RawCommand, ...]}
+     * 响应：{"edge_id", "atomic", "total", "accepted", "results": [SubmitResult, ...]}
+     * @return 请求格式错误或 Edge 未找到时返回 false，并写入 err。
+     */
+    bool submitBatchJson(const nlohmann::json& request, nlohmann::json* response, std::string* err) const;
+
+    /**
+     * @brief 注册 MQTT 入口：
+     * - edge/submit_batch -> edge/submit_batch/result（批量提交）
+     * - edge/fanout -> edge/fanout/result（扇出提交）
+     */
+    void registerMqttRoutes();
+
+    static constexpr std::size_t kMaxBatchCommands = 5000;  // 单批命令数上限
+    static constexpr std::size_t kMaxFanoutEdges = 1024;    // 单次扇出 Edge 数上限
+
 private:
     MyEdgeManager()                                 = default;
     ~MyEdgeManager() { stopAllEdges(); };  // 析构函数，用于必要清理
     MyEdgeManager(const MyEdgeManager&)             = delete;
     MyEdgeManager& operator=(const MyEdgeManager&)  = delete;
 
-    mutable std::mutex mutex_;  // 用于线程安全
-    std::unordered_map<std::string, std::unique_ptr<IEdge>> edges_;  // 以 ID 为键的高效存储
+    using RouteTable = std::unordered_map<std::string, std::shared_ptr<IEdge>>;
+
+    mutable std::mutex mutex_;                        // 串行化写操作（append/delete/start/stop）
+    my_data::VersionedSnapshot<RouteTable> routes_;   // 只读路由快照，写时复制后整体发布
 };
 
 }  // namespace my_edge
\ No newline at end of file
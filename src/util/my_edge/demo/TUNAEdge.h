@@ -4,8 +4,10 @@
 #include "MyMavVehicle.h"
 #include <nlohmann/json.hpp>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <shared_mutex>
 #include <thread>
 #include <atomic>
@@ -14,6 +16,9 @@
 #include "MyLog.h"
 #include "IDevice.h"
 #include "ICommandNormalizer.h"
+#include "DedupTable.h"
+#include "EdgeStatusCache.h"
+#include "TaskJournal.h"
 #include "TaskQueue.h"
 
 namespace my_edge::demo {
@@ -30,7 +35,9 @@ public:
     bool Init(const nlohmann::json& cfg, std::string* err) override;
     bool Start(std::string* err) override;
     SubmitResult Submit(const my_data::RawCommand& cmd) override;
-    my_data::EdgeStatus GetStatusSnapshot() const override;
+    std::vector<SubmitResult> SubmitBatch(std::vector<my_data::RawCommand>&& cmds, bool atomic = false) override;
+    my_data::EdgeStatus GetStatusSnapshot() const override;                      // 返回 GetStatusSnapshotShared 的副本
+    std::shared_ptr<const my_data::EdgeStatus> GetStatusSnapshotShared() const override; // 无锁：设备/队列版本号均未变化时返回缓存快照
     void SetEStop(bool active, const std::string& reason) override;
     void Shutdown() override;
     my_data::EdgeId Id() const override;
@@ -56,6 +63,21 @@ private:
 
     bool AppendTaskToTargetTaskQueue(const my_data::DeviceId& device_id, const my_data::Task& task);
 
+    // 任务日志（锁内调用）
+    bool OpenTaskJournalLocked(std::string* err);
+    void CloseTaskJournalLocked();
+
+    // Submit/SubmitBatch 共用（rw_mutex_ 共享锁内调用）
+    bool CheckAcceptingLocked(const my_data::RawCommand& cmd, SubmitResult* fail) const;
+    std::optional<my_data::Task> PrepareTaskLocked(const my_data::RawCommand& cmd, std::int64_t received_us,
+                                                   SubmitResult* fail) const;
+
+    // 向 status_cache_ 发布设备/队列来源（锁内调用，devices_/queues_ 变化之后）
+    void PublishStatusSourcesLocked();
+
+    // 是否参与去重；window_ms 输出实际窗口
+    bool DedupParamsOf(const my_data::Task& task, std::int64_t* window_ms) const;
+
 private:
     // 基本标识与配置
     my_data::EdgeId edge_id_{"tuna-default"};
@@ -72,12 +94,29 @@ private:
     bool allow_queue_when_estop_{false};
 
     // 设备/队列 管理（与 UUVEdge 一致）
-    std::unordered_map<my_data::DeviceId, std::unique_ptr<my_device::IDevice>> devices_;
-    std::unordered_map<my_data::DeviceId, std::unique_ptr<my_control::TaskQueue>> queues_;
+    // shared_ptr：状态快照（status_cache_）共享持有设备/队列，清理映射后读方仍可安全访问
+    std::unordered_map<my_data::DeviceId, std::shared_ptr<my_device::IDevice>> devices_;
+    std::unordered_map<my_data::DeviceId, std::shared_ptr<my_control::TaskQueue>> queues_;
     std::unordered_map<std::string, std::string> device_type_by_id_;
 
     mutable std::shared_mutex rw_mutex_;
 
+    // 任务日志（可选，所有队列共用一个）
+    bool task_journal_enable_{false};
+    std::string task_journal_path_;
+    std::shared_ptr<my_control::TaskJournal> task_journal_;
+
+    // 所有队列共用：task_queue_mode / task_queue_drop_expired
+    my_control::TaskQueueOptions task_queue_options_{};
+
+    // Submit 幂等去重
+    bool dedup_enable_{true};
+    std::int64_t dedup_default_window_ms_{0};
+    DedupTable dedup_;  // idempotency_key -> 首次 SubmitResult（自带锁）
+
+    // 状态快照缓存（GetStatusSnapshotShared 读方不取 rw_mutex_）
+    EdgeStatusCache status_cache_;
+
     // Status snapshot
     bool                    status_snapshot_enable_{false};
     int                     status_snapshot_interval_ms_{5000};
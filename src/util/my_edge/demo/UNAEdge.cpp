@@ -158,8 +158,6 @@ void UNAEdge::ExecuteOtherTaskLocked(const my_data::Task& task) {
 }
 
 void UNAEdge::ExecuteSelfTaskLocked() {
-  std::this_thread::sleep_for(std::chrono::milliseconds(self_task_execution_step_ms_));
-
   const RunState current_state = self_task_run_state_.load();
   if (current_state != RunState::Initializing && current_state != RunState::Ready) {
     return;
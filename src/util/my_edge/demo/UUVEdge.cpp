@@ -9,7 +9,8 @@
 #include "MyControl.h"
 #include "MyDevice.h"
 #include "MyLog.h"
-#include "demo/StatusRepository.h"
+#include "demo/SnapshotRetention.h"
+#include "demo/StatusSnapshotWriter.h"
 #include "demo/Task.h"
 namespace my_edge::demo {
 
@@ -93,7 +94,29 @@ bool UUVEdge::Init(const nlohmann::json& cfg, std::string* err) {
   allow_queue_when_estop_ = cfg.value("allow_queue_when_estop", false); 
   self_action_enable_     = cfg.value("self_action_enable", true); // 读取自我行动线程配置
   self_device_id_         = cfg.value("self_device_id", self_device_id_);
+  task_journal_enable_    = cfg.value("task_journal_enable", false);
+  task_journal_path_      = cfg.value("task_journal_path", std::string("./data/task_journal/") + edge_id_ + ".wal");
+  // 队列调度：fifo（默认）| priority（优先级 + EDF）
+  task_queue_options_ = my_control::TaskQueueOptions{};
+  const std::string queue_mode = cfg.value("task_queue_mode", std::string("fifo"));
+  if (!my_control::ParseTaskQueueMode(queue_mode, &task_queue_options_.mode)) {
+    MYLOG_WARN("[Edge:{}] 未知 task_queue_mode={}，使用 fifo", edge_id_, queue_mode);
+  }
+  task_queue_options_.drop_expired = cfg.value("task_queue_drop_expired", task_queue_options_.drop_expired);
+  // Submit 幂等去重（与 BaseEdge 相同的配置项）
+  dedup_enable_ = cfg.value("dedup_enable", true);
+  dedup_default_window_ms_ = cfg.value("dedup_default_window_ms", static_cast<std::int64_t>(0));
+  {
+    DedupTableOptions dopts;
+    dopts.slot_ms = cfg.value("dedup_slot_ms", dopts.slot_ms);
+    dopts.max_window_ms = cfg.value("dedup_max_window_ms", dopts.max_window_ms);
+    dopts.max_entries = cfg.value("dedup_max_entries", dopts.max_entries);
+    dedup_.Reset(dopts);
+  }
   boot_at_ms_             = my_data::NowMs();
+  CloseTaskJournalLocked();
+  // 撤下状态快照引用的旧设备/队列（读方持有的旧快照仍共享持有它们）
+  status_cache_.PublishSources({});
   devices_.clear();
   queues_.clear();
   device_type_by_id_.clear();
@@ -103,7 +126,7 @@ bool UUVEdge::Init(const nlohmann::json& cfg, std::string* err) {
   // 创建 Edge 自己的任务队列
   if (self_action_enable_) {
     std::string self_queue_name = "queue-" + self_device_id_;
-    queues_[self_device_id_] = std::make_unique<my_control::TaskQueue>(self_queue_name);
+    queues_[self_device_id_] = std::make_unique<my_control::TaskQueue>(self_queue_name, task_queue_options_);
     MYLOG_INFO("[Edge:{}] 创建自我行动队列：device_id={}, queue={}", edge_id_, self_device_id_, self_queue_name);
   }
   
@@ -153,7 +176,7 @@ bool UUVEdge::Init(const nlohmann::json& cfg, std::string* err) {
 
       // 创建队列
       std::string qname = "queue-" + device_id;
-      queues_[device_id] = std::make_unique<my_control::TaskQueue>(qname);
+      queues_[device_id] = std::make_unique<my_control::TaskQueue>(qname, task_queue_options_);
       MYLOG_INFO("[Edge:{}] 创建队列：device_id={}, queue={} ------------------------------- 完成", edge_id_, device_id, qname);
 
       // 创建设备
@@ -185,13 +208,69 @@ bool UUVEdge::Init(const nlohmann::json& cfg, std::string* err) {
     }
     MYLOG_INFO("----------------------------------------------------------------------------------------------");
   }
+
+  // 任务日志（可选）：绑定到全部队列并回放上次未完成的任务
+  if (task_journal_enable_) {
+    std::string jerr;
+    if (!OpenTaskJournalLocked(&jerr)) {
+      MYLOG_ERROR("[Edge:{}] 任务日志打开失败，队列将不持久化：path={}, err={}", edge_id_, task_journal_path_, jerr);
+      if (err) *err = "task journal: " + jerr;
+      initStatus = false;
+    }
+  }
+  PublishStatusSourcesLocked();
   return initStatus;
 }
 
+bool UUVEdge::OpenTaskJournalLocked(std::string* err) {
+  my_control::TaskJournalOptions opts;
+  opts.path = task_journal_path_;
+  opts.fsync = cfg_.value("task_journal_fsync", opts.fsync);
+  opts.compact_check_interval_ms = cfg_.value("task_journal_compact_interval_ms", opts.compact_check_interval_ms);
+
+  auto journal = std::make_shared<my_control::TaskJournal>(opts);
+  if (!journal->Open(err)) {
+    return false;
+  }
+
+  std::size_t restored = 0;
+  for (auto& [device_id, q] : queues_) {
+    if (!q) continue;
+    q->AttachJournal(journal);
+    std::size_t n = q->Restore(journal->TakeRecovered(q->Name()));
+    if (n > 0) {
+      MYLOG_WARN("[Edge:{}] 任务日志回放：device_id={}, queue={}, restored={}", edge_id_, device_id, q->Name(), n);
+    }
+    restored += n;
+  }
+
+  task_journal_ = std::move(journal);
+  MYLOG_INFO("[Edge:{}] 任务日志已启用：path={}, restored={}", edge_id_, task_journal_path_, restored);
+  return true;
+}
+
+void UUVEdge::CloseTaskJournalLocked() {
+  if (!task_journal_) return;
+  for (auto& [device_id, q] : queues_) {
+    if (q) q->AttachJournal(nullptr);
+  }
+  task_journal_->Close();
+  task_journal_.reset();
+}
+
+bool UUVEdge::DedupParamsOf(const my_data::Task& task, std::int64_t* window_ms) const {
+  *window_ms = task.dedup_window_ms > 0 ? task.dedup_window_ms : dedup_default_window_ms_;
+  return dedup_enable_ && !task.idempotency_key.empty() && *window_ms > 0;
+}
+
 nlohmann::json UUVEdge::GetRunTimeStatusInfo() const {
     nlohmann::json status;
     status["name"] = "UUVEdge";
     status["state"] = "active"; 
+    // 状态快照组提交：批大小与提交耗时
+    auto& writer = my_db::demo::StatusSnapshotWriter::GetInstance();
+    status["snapshot_writer"] = my_db::demo::ToJson(writer.Stats());
+    status["snapshot_writer"]["running"] = writer.IsRunning();
     return status;
 }
 
@@ -242,20 +321,14 @@ bool UUVEdge::Start(std::string* err) {
   return true;
 }
 
-SubmitResult UUVEdge::Submit(const my_data::RawCommand& cmd) {
-  std::shared_lock<std::shared_mutex> lk(rw_mutex_);
-
-  MYLOG_INFO("[Edge:{}] Submit 开始：command_id={}, source={}, payload={}",
-             edge_id_, cmd.command_id, cmd.source, cmd.payload.dump());
-
+bool UUVEdge::CheckAcceptingLocked(const my_data::RawCommand& cmd, SubmitResult* fail) const {
   // 1) 运行状态检查 (Ready => NotRunning)
   RunState rs = run_state_.load();
   if (rs != RunState::Running) {
-    auto r = MakeResult(SubmitCode::NotRunning,
-                        "边缘未运行，run_state=" + RunStateToString(rs),
-                        cmd);
-    MYLOG_WARN("[Edge:{}] Submit 拒绝：{}", edge_id_, r.toString());
-    return r;
+    *fail = MakeResult(SubmitCode::NotRunning,
+                       "边缘未运行，run_state=" + RunStateToString(rs),
+                       cmd);
+    return false;
   }
 
   // 2) 急停检查（默认拒绝）
@@ -265,33 +338,33 @@ SubmitResult UUVEdge::Submit(const my_data::RawCommand& cmd) {
       std::lock_guard<std::mutex> lk2(estop_mu_);
       reason = estop_reason_;
     }
-    auto r = MakeResult(SubmitCode::EStop,
-                        reason.empty() ? "急停激活" : ("急停激活: " + reason),
-                        cmd);
-    MYLOG_WARN("[Edge:{}] Submit 拒绝(EStop)：{}", edge_id_, r.toString());
-    return r;
+    *fail = MakeResult(SubmitCode::EStop,
+                       reason.empty() ? "急停激活" : ("急停激活: " + reason),
+                       cmd);
+    return false;
   }
+  return true;
+}
 
+std::optional<my_data::Task> UUVEdge::PrepareTaskLocked(const my_data::RawCommand& cmd, std::int64_t received_us,
+                                                        SubmitResult* fail) const {
   // 3) payload 必须是对象并包含 device_id（顶层）
   if (!cmd.payload.is_object()) {
-    auto r = MakeResult(SubmitCode::InvalidCommand, "payload 必须是对象", cmd);
-    MYLOG_ERROR("[Edge:{}] Submit 失败：{}", edge_id_, r.toString());
-    return r;
+    *fail = MakeResult(SubmitCode::InvalidCommand, "payload 必须是对象", cmd);
+    return std::nullopt;
   }
 
   std::string device_id = my_data::jsonutil::GetStringOr(cmd.payload, "device_id", "");
   if (device_id.empty()) {
-    auto r = MakeResult(SubmitCode::InvalidCommand, "缺少 payload.device_id", cmd);
-    MYLOG_ERROR("[Edge:{}] Submit 失败：{}", edge_id_, r.toString());
-    return r;
+    *fail = MakeResult(SubmitCode::InvalidCommand, "缺少 payload.device_id", cmd);
+    return std::nullopt;
   }
 
   // 4) 查找类型
   auto dit = device_type_by_id_.find(device_id);
   if (dit == device_type_by_id_.end()) {
-    auto r = MakeResult(SubmitCode::UnknownDevice, "未知的 device_id=" + device_id, cmd, device_id);
-    MYLOG_ERROR("[Edge:{}] Submit 失败：{}", edge_id_, r.toString());
-    return r;
+    *fail = MakeResult(SubmitCode::UnknownDevice, "未知的 device_id=" + device_id, cmd, device_id);
+    return std::nullopt;
   }
 
   const std::string& type = dit->second;
@@ -299,98 +372,230 @@ SubmitResult UUVEdge::Submit(const my_data::RawCommand& cmd) {
   // 5) 根据类型选择 normalizer
   auto nit = normalizers_by_type_.find(type);
   if (nit == normalizers_by_type_.end() || !nit->second) {
-    auto r = MakeResult(SubmitCode::InternalError, "缺少 normalizer，类型=" + type, cmd, device_id);
-    MYLOG_ERROR("[Edge:{}] Submit 失败：{}", edge_id_, r.toString());
-    return r;
+    *fail = MakeResult(SubmitCode::InternalError, "缺少 normalizer，类型=" + type, cmd, device_id);
+    return std::nullopt;
   }
 
   // 6) 规范化
   std::string nerr;
   auto maybe_task = nit->second->Normalize(cmd, edge_id_, &nerr);
   if (!maybe_task.has_value()) {
-    auto r = MakeResult(SubmitCode::InvalidCommand,
-                        nerr.empty() ? "规范化失败" : ("规范化失败: " + nerr),
-                        cmd, device_id);
-    MYLOG_ERROR("[Edge:{}] Submit 失败：{}", edge_id_, r.toString());
-    return r;
+    *fail = MakeResult(SubmitCode::InvalidCommand,
+                       nerr.empty() ? "规范化失败" : ("规范化失败: " + nerr),
+                       cmd, device_id);
+    return std::nullopt;
   }
+  // 以路由用的 device_id 为准（入队、分组都按它）
+  maybe_task->device_id = device_id;
+  // 追踪：trace_id 优先沿用上游（payload.trace_id），span_id 每个任务一个
+  StampIngressTrace(*maybe_task, cmd, received_us);
 
-  my_data::Task task = *maybe_task;
-
-  // 7) 推送到队列
+  // 7) 目标队列必须存在且未关闭
   auto qit = queues_.find(device_id);
   if (qit == queues_.end() || !qit->second) {
-    auto r = MakeResult(SubmitCode::InternalError, "缺少队列，device_id=" + device_id, cmd, device_id, task.task_id);
-    MYLOG_ERROR("[Edge:{}] Submit 失��：{}", edge_id_, r.toString());
-    return r;
+    *fail = MakeResult(SubmitCode::InternalError, "缺少队列，device_id=" + device_id, cmd, device_id,
+                       maybe_task->task_id);
+    return std::nullopt;
   }
-
   if (qit->second->IsShutdown()) {
-    auto r = MakeResult(SubmitCode::QueueShutdown, "队列已关闭", cmd, device_id, task.task_id);
-    MYLOG_WARN("[Edge:{}] Submit 拒绝：{}", edge_id_, r.toString());
-    return r;
+    *fail = MakeResult(SubmitCode::QueueShutdown, "队列已关闭", cmd, device_id, maybe_task->task_id);
+    return std::nullopt;
   }
-
-  qit->second->Push(task);
-  std::int64_t qsize = static_cast<std::int64_t>(qit->second->Size());
-
-  auto r = MakeResult(SubmitCode::Ok, "已入队", cmd, device_id, task.task_id, qsize);
-  MYLOG_INFO("[Edge:{}] Submit 成功：{}", edge_id_, r.toString());
-  return r;
+  return maybe_task;
 }
 
-my_data::EdgeStatus UUVEdge::GetStatusSnapshot() const {
+SubmitResult UUVEdge::Submit(const my_data::RawCommand& cmd) {
+  const std::int64_t received_us = my_data::MonoUs();
   std::shared_lock<std::shared_mutex> lk(rw_mutex_);
 
-  my_data::EdgeStatus s;
-  s.edge_id = edge_id_;
-  s.boot_at_ms = boot_at_ms_;
-  s.version = version_;
+  MYLOG_INFO("[Edge:{}] Submit 开始：command_id={}, source={}, payload={}",
+             edge_id_, cmd.command_id, cmd.source, cmd.payload.dump());
+
+  SubmitResult fail;
+  if (!CheckAcceptingLocked(cmd, &fail)) {
+    MYLOG_WARN("[Edge:{}] Submit 拒绝：{}", edge_id_, fail.toString());
+    return fail;
+  }
+  auto maybe_task = PrepareTaskLocked(cmd, received_us, &fail);
+  if (!maybe_task.has_value()) {
+    MYLOG_ERROR("[Edge:{}] Submit 失败：{}", edge_id_, fail.toString());
+    return fail;
+  }
 
-  RunState rs = run_state_.load();
-  if (rs == RunState::Initializing || rs == RunState::Ready) {
-    s.run_state = my_data::EdgeRunState::Initializing;
-  } else if (rs == RunState::Running) {
-    s.run_state = estop_.load() ? my_data::EdgeRunState::EStop : my_data::EdgeRunState::Running;
-  } else if (rs == RunState::Stopping) {
-    s.run_state = my_data::EdgeRunState::Degraded;
-  } else {
-    s.run_state = my_data::EdgeRunState::Degraded;
+  my_data::Task& task = *maybe_task;
+  const my_data::DeviceId device_id = task.device_id;
+  auto& queue = queues_.find(device_id)->second;
+
+  // 幂等去重：窗口内同一 idempotency_key 直接返回首次结果（先占位，避免并发重复提交同时入队）
+  const std::string dedup_key = task.idempotency_key;
+  std::int64_t dedup_window_ms = 0;
+  const bool dedup = DedupParamsOf(task, &dedup_window_ms);
+  if (dedup) {
+    SubmitResult first;
+    if (dedup_.TryReserve(dedup_key, dedup_window_ms,
+                          MakeResult(SubmitCode::Ok, "已入队", cmd, device_id, task.task_id),
+                          my_data::NowMs(), &first)) {
+      MYLOG_WARN("[Edge:{}] Submit 重复提交，返回首次结果: idempotency_key={}, command_id={}, task_id={}",
+                 edge_id_, dedup_key, cmd.command_id, first.task_id);
+      first.message += "（重复提交）";
+      return first;
+    }
   }
 
-  s.estop_active = estop_.load();
-  {
-    std::lock_guard<std::mutex> lk2(estop_mu_);
-    s.estop_reason = estop_reason_;
+  std::string qerr;
+  if (!queue->Push(task, &qerr)) {
+    if (dedup) dedup_.Erase(dedup_key);  // 入队失败不占用窗口，允许重试
+    auto r = MakeResult(SubmitCode::InternalError,
+                        qerr.empty() ? "入队失败" : ("入队失败: " + qerr),
+                        cmd, device_id, task.task_id);
+    MYLOG_ERROR("[Edge:{}] Submit 失败：{}", edge_id_, r.toString());
+    return r;
   }
+  std::int64_t qsize = static_cast<std::int64_t>(queue->Size());
 
-  std::int64_t pending_total = 0;
-  std::int64_t running_total = 0;
+  auto r = MakeResult(SubmitCode::Ok, "已入队", cmd, device_id, task.task_id, qsize);
+  if (dedup) dedup_.Update(dedup_key, r);
+  MYLOG_INFO("[Edge:{}] Submit 成功：{}", edge_id_, r.toString());
+  return r;
+}
 
-  for (const auto& [device_id, dev] : devices_) {
-    if (!dev) continue;
+std::vector<SubmitResult> UUVEdge::SubmitBatch(std::vector<my_data::RawCommand>&& cmds, bool atomic) {
+  std::vector<SubmitResult> results(cmds.size());
+  if (cmds.empty()) return results;
 
-    my_data::DeviceStatus ds = dev->GetStatusSnapshot();
+  const std::int64_t received_us = my_data::MonoUs();
+  std::shared_lock<std::shared_mutex> lk(rw_mutex_);
+  MYLOG_INFO("[Edge:{}] SubmitBatch 开始：count={}, atomic={}", edge_id_, cmds.size(), atomic ? "true" : "false");
+
+  // 1) 运行状态 / 急停对整批只判断一次
+  SubmitResult fail;
+  if (!CheckAcceptingLocked(cmds.front(), &fail)) {
+    for (std::size_t i = 0; i < cmds.size(); ++i) {
+      results[i] = fail;
+      results[i].command_id = cmds[i].command_id;
+    }
+    MYLOG_WARN("[Edge:{}] SubmitBatch 拒绝：{}", edge_id_, fail.toString());
+    return results;
+  }
 
-    auto qit = queues_.find(device_id);
-    if (qit != queues_.end() && qit->second) {
-      ds.queue_depth = static_cast<std::int64_t>(qit->second->Size());
-      pending_total += ds.queue_depth;
+  // 2) 逐条校验 + 规范化 + 去重占位，按设备分组（保持批内顺序）
+  struct Pending {
+    std::size_t index{0};
+    std::string dedup_key{};  // 非空表示已在去重表中占位
+  };
+  struct Group {
+    my_control::TaskQueue* queue{nullptr};
+    std::vector<my_data::Task> tasks;
+    std::vector<Pending> pending;
+  };
+  std::vector<my_data::DeviceId> group_order;
+  std::unordered_map<my_data::DeviceId, Group> groups;
+  std::size_t failed = 0;
+  const my_data::TimestampMs now_ms = my_data::NowMs();
+
+  for (std::size_t i = 0; i < cmds.size(); ++i) {
+    const auto& cmd = cmds[i];
+    auto maybe_task = PrepareTaskLocked(cmd, received_us, &results[i]);
+    if (!maybe_task.has_value()) {
+      ++failed;
+      continue;
+    }
+    const my_data::DeviceId device_id = maybe_task->device_id;
+
+    Pending p;
+    p.index = i;
+    std::int64_t dedup_window_ms = 0;
+    if (DedupParamsOf(*maybe_task, &dedup_window_ms)) {
+      SubmitResult first;
+      if (dedup_.TryReserve(maybe_task->idempotency_key, dedup_window_ms,
+                            MakeResult(SubmitCode::Ok, "已入队", cmd, device_id, maybe_task->task_id),
+                            now_ms, &first)) {
+        first.message += "（重复提交）";
+        results[i] = std::move(first);  // 重复命令不算失败
+        continue;
+      }
+      p.dedup_key = maybe_task->idempotency_key;
+    }
+
+    auto [git, inserted] = groups.try_emplace(device_id);
+    if (inserted) {
+      group_order.push_back(device_id);
+      git->second.queue = queues_.find(device_id)->second.get();
     }
+    results[i] = MakeResult(SubmitCode::Ok, "已入队", cmd, device_id, maybe_task->task_id);
+    git->second.tasks.push_back(std::move(*maybe_task));
+    git->second.pending.push_back(std::move(p));
+  }
 
-    if (ds.work_state == my_data::DeviceWorkState::Busy) {
-      running_total += 1;
+  // 3) 全有或全无：有失败则释放占位，整批不入队
+  if (atomic && failed > 0) {
+    for (auto& [device_id, g] : groups) {
+      for (const auto& p : g.pending) {
+        if (!p.dedup_key.empty()) dedup_.Erase(p.dedup_key);
+        results[p.index].code = SubmitCode::BatchAborted;
+        results[p.index].message = "同批 " + std::to_string(failed) + " 条命令失败，整批未入队";
+      }
     }
+    MYLOG_WARN("[Edge:{}] SubmitBatch 整批放弃：count={}, failed={}", edge_id_, cmds.size(), failed);
+    return results;
+  }
 
-    s.devices[device_id] = ds;
+  // 4) 每个设备队列一次批量入队（一次加锁 + 一次唤醒 + 一次落盘等待）
+  std::size_t queued = 0;
+  for (const auto& device_id : group_order) {
+    Group& g = groups[device_id];
+    const std::size_t n = g.tasks.size();
+    std::string qerr;
+    if (!g.queue->PushBatch(std::move(g.tasks), &qerr)) {
+      for (const auto& p : g.pending) {
+        if (!p.dedup_key.empty()) dedup_.Erase(p.dedup_key);
+        results[p.index].code = SubmitCode::InternalError;
+        results[p.index].message = qerr.empty() ? "入队失败" : ("入队失败: " + qerr);
+      }
+      MYLOG_ERROR("[Edge:{}] SubmitBatch 入队失败：device_id={}, count={}, err={}", edge_id_, device_id, n, qerr);
+      continue;
+    }
+    const std::int64_t qsize = static_cast<std::int64_t>(g.queue->Size());
+    for (const auto& p : g.pending) {
+      results[p.index].queue_size_after = qsize;
+      if (!p.dedup_key.empty()) dedup_.Update(p.dedup_key, results[p.index]);
+    }
+    queued += n;
   }
 
-  s.tasks_pending_total = pending_total;
-  s.tasks_running_total = running_total;
+  MYLOG_INFO("[Edge:{}] SubmitBatch 完成：count={}, queued={}, failed={}, devices={}",
+             edge_id_, cmds.size(), queued, failed, group_order.size());
+  return results;
+}
 
-  MYLOG_DEBUG("[Edge:{}] GetStatusSnapshot：devices={}, pending_total={}, running_total={}, estop={}",
-              edge_id_, s.devices.size(), s.tasks_pending_total, s.tasks_running_total, s.estop_active);
-  return s;
+my_data::EdgeStatus UUVEdge::GetStatusSnapshot() const {
+  return *GetStatusSnapshotShared();
+}
+
+std::shared_ptr<const my_data::EdgeStatus> UUVEdge::GetStatusSnapshotShared() const {
+  return status_cache_.Get(run_state_.load(), estop_.load(), [this] {
+    std::lock_guard<std::mutex> lk(estop_mu_);
+    return estop_reason_;
+  });
+}
+
+void UUVEdge::PublishStatusSourcesLocked() {
+  EdgeStatusCache::Sources src;
+  src.edge_id = edge_id_;
+  src.version = version_;
+  src.boot_at_ms = boot_at_ms_;
+  src.devices.reserve(devices_.size());
+  for (const auto& [device_id, dev] : devices_) {
+    if (!dev) continue;
+    EdgeStatusCache::Source ss;
+    ss.device_id = device_id;
+    ss.device = dev;
+    auto qit = queues_.find(device_id);
+    if (qit != queues_.end()) ss.queue = qit->second;
+    src.devices.push_back(std::move(ss));
+  }
+  // self 队列深度不计入 tasks_pending_total（与原先的 UUVEdge 快照一致）
+  status_cache_.PublishSources(std::move(src));
 }
 
 void UUVEdge::SetEStop(bool active, const std::string& reason) {
@@ -401,6 +606,7 @@ void UUVEdge::SetEStop(bool active, const std::string& reason) {
       std::lock_guard<std::mutex> lk2(estop_mu_);
       estop_reason_ = reason;
     }
+    status_cache_.BumpMeta();
   }
   MYLOG_WARN("[Edge:{}] SetEStop：active={}, reason={}", edge_id_, active ? "true" : "false", reason);
 }
@@ -423,6 +629,16 @@ void UUVEdge::StartStatusSnapshotThreadLocked() {
     return;
   }
 
+  std::string werr;
+  if (!my_db::demo::StatusSnapshotWriter::GetInstance().Start(&werr)) {
+    MYLOG_WARN("[Edge:{}] 状态快照线程未启动：快照写入器启动失败：{}", edge_id_, werr);
+    return;
+  }
+
+  if (!my_db::demo::SnapshotRetention::GetInstance().Start(&werr)) {
+    MYLOG_WARN("[Edge:{}] 快照保留任务启动失败：{}", edge_id_, werr);
+  }
+
   snapshot_stop_.store(false);
   MYLOG_INFO("[Edge:{}] 状态快照线程启动：间隔时间={} ms", edge_id_, status_snapshot_interval_ms_);
   snapshot_thread_ = std::thread(&UUVEdge::StatusSnapshotLoop, this);
@@ -443,20 +659,16 @@ void UUVEdge::StatusSnapshotLoop() {
   while (!snapshot_stop_.load()) {
     my_data::EdgeStatus st = GetStatusSnapshot();
 
-    std::string err;
-    auto& repo = my_db::demo::StatusRepository::GetInstance();
+    // 只做序列化与入队，由 StatusSnapshotWriter 后台组提交
+    auto& writer = my_db::demo::StatusSnapshotWriter::GetInstance();
 
-    if (!repo.InsertEdgeSnapshot(st, &err)) {
-      MYLOG_ERROR("[Edge:{}] 状态快照：插入边缘快照失败：{}", edge_id_, err);
-    } else {
-      MYLOG_DEBUG("[Edge:{}] 状态快照：边缘快照已插入", edge_id_);
+    if (!writer.EnqueueEdgeSnapshot(st)) {
+      MYLOG_WARN("[Edge:{}] 状态快照：边缘快照入队失败（队列已满或写入器未运行）", edge_id_);
     }
 
     for (const auto& [device_id, ds] : st.devices) {
-      std::string e2;
-      if (!repo.InsertDeviceSnapshot(edge_id_, ds, &e2)) {
-        MYLOG_ERROR("[Edge:{}] 状态快照：插入设备快照失败：device_id={}, err={}",
-                    edge_id_, device_id, e2);
+      if (!writer.EnqueueDeviceSnapshot(edge_id_, ds)) {
+        MYLOG_WARN("[Edge:{}] 状态快照：设备快照入队失败：device_id={}", edge_id_, device_id);
       }
     }
 
@@ -490,7 +702,8 @@ void UUVEdge::StartSelfActionThreadLocked() {
 
   self_action_stop_.store(false);
   MYLOG_INFO("[Edge:{}] 自我行动线程启动：device_id={}", edge_id_, self_device_id_);
-  do_self_action_thread_ = std::thread(&UUVEdge::SelfActionLoop, this);
+  // 队列指针在锁内取好传给线程：Shutdown 持 unique_lock 等待本线程退出，线程内再加锁会与之互等
+  do_self_action_thread_ = std::thread(&UUVEdge::SelfActionLoop, this, qit->second.get());
 }
 
 void UUVEdge::StopSelfActionThreadLocked() {
@@ -509,55 +722,33 @@ void UUVEdge::StopSelfActionThreadLocked() {
   }
 }
 
-void UUVEdge::SelfActionLoop() {
+// 空闲时阻塞在 self 队列上（不设超时）：Submit/AppendTask 入队即唤醒，Shutdown 关闭队列即退出
+void UUVEdge::SelfActionLoop(my_control::TaskQueue* queue) {
   MYLOG_INFO("[Edge:{}] 自我行动循环进入", edge_id_);
 
   while (!self_action_stop_.load()) {
-    // 获取任务（函数内部会加锁访问queues_并立即释放）
-    auto maybe_task = GetSelfTask(1000);
-    
+    auto maybe_task = GetSelfTask(queue, -1);
     if (!maybe_task.has_value()) {
-      // 未获取到任务（超时、队列关闭或队列不存在）
-      MYLOG_INFO("[Edge:{}] 自我行动循环：未获取到任务，可能是超时或队列关闭, device_id={}, wait_time={} ms", edge_id_, self_device_id_, 1000);
-      std::this_thread::sleep_for(std::chrono::milliseconds(1000)); // 等待一段时间后重试，避免频繁轮询
+      // 无限等待下只有队列关闭才会返回空
+      if (queue->IsShutdown()) break;
       continue;
-    } else {
-      MYLOG_INFO("[Edge:{}] 自我行动循环：获得任务，task_id={}", edge_id_, maybe_task->task_id);
     }
 
     // 执行任务
     MYLOG_INFO("[Edge:{}] 自我行动循环：获得任务，task_id={}", edge_id_, maybe_task->task_id);
     ExecuteSelfTask(*maybe_task);
-    std::this_thread::sleep_for(std::chrono::milliseconds(100)); // 执行完一个任务后短暂休息，避免过热
+    // 无论成败都写 complete，避免重启后重复执行（Shutdown 在 join 本线程之后才释放队列）
+    queue->MarkDone(*maybe_task);
   }
 
   MYLOG_WARN("[Edge:{}] 自我行动循环退出", edge_id_);
 }
 
-std::optional<my_data::Task> UUVEdge::GetSelfTask(int timeout_ms) {
-  // 加锁获取队列指针
-  my_control::TaskQueue* queue = nullptr;
-  {
-    std::shared_lock<std::shared_mutex> lk(rw_mutex_);
-    auto qit = queues_.find(self_device_id_);
-    if (qit != queues_.end() && qit->second) {
-      queue = qit->second.get();
-    }
-  }
-  // 锁已释放
-
-  if (!queue) {
-    // 队列不存在，可能在Shutdown过程中
-    if (!self_action_stop_.load()) {
-      MYLOG_WARN("[Edge:{}] 获取自我任务失败：队列不存在", edge_id_);
-    }
-    return std::nullopt;
-  }
-
+std::optional<my_data::Task> UUVEdge::GetSelfTask(my_control::TaskQueue* queue, int timeout_ms) {
   // TaskQueue本身是线程安全的，PopBlocking不需要外部锁
   my_data::Task task;
   bool got_task = queue->PopBlocking(task, timeout_ms);
-  
+
   if (!got_task) {
     // 超时或队列已关闭
     if (queue->IsShutdown()) {
@@ -647,10 +838,14 @@ void UUVEdge::Shutdown() {
     dev->Join();
   }
 
+  // 队列与消费线程都已停止，剩余任务保留在日志中，下次 Init 回放
+  CloseTaskJournalLocked();
+
   devices_.clear();
   queues_.clear();
   device_type_by_id_.clear();
   normalizers_by_type_.clear();
+  PublishStatusSourcesLocked();
 
   run_state_ = RunState::Stopped;
   MYLOG_WARN("[Edge:{}] Shutdown 完成：run_state={}", edge_id_, RunStateToString(run_state_.load()));
@@ -715,10 +910,21 @@ nlohmann::json UUVEdge::DumpInternalInfo() const {
     nlohmann::json queueInfo;
     queueInfo["name"] = queue->Name();
     queueInfo["size"] = queue->Size();
+    queueInfo["stats"] = my_control::ToJson(queue->Stats());
     queuesJson[device_id] = queueInfo;
   }
   edgeInfo["task-queues"] = queuesJson;
 
+  const auto ds = dedup_.Stats();
+  edgeInfo["dedup"] = {
+    {"enabled", dedup_enable_},
+    {"size", ds.size},
+    {"hits", ds.hits},
+    {"inserts", ds.inserts},
+    {"expired", ds.expired},
+    {"evicted", ds.evicted}
+  };
+
   // 获取设备信息
   nlohmann::json devicesJson = nlohmann::json::object();
   for (const auto& [device_id, dev] : devices_) {
@@ -824,7 +1030,11 @@ bool UUVEdge::AppendTaskToTargetTaskQueue(const my_data::DeviceId& device_id, co
       return result;
     } else {
       MYLOG_INFO("[Edge:{}] AppendTaskToTargetTaskQueue device_id={} 的任务队列当前大小={}", edge_id_, device_id, it->second->Size());
-      it->second->Push(task);
+      std::string qerr;
+      if (!it->second->Push(task, &qerr)) {
+        MYLOG_ERROR("[Edge:{}] AppendTaskToTargetTaskQueue 失败：device_id={}, err={}", edge_id_, device_id, qerr);
+        return result;
+      }
       MYLOG_INFO("[Edge:{}] AppendTaskToTargetTaskQueue 成功：任务已添加到 device_id={} 的任务队列", edge_id_, device_id);
       result = true;
     }
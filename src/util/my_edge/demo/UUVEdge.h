@@ -7,6 +7,7 @@
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -19,6 +20,9 @@
 
 
 #include "ICommandNormalizer.h"
+#include "DedupTable.h"
+#include "EdgeStatusCache.h"
+#include "TaskJournal.h"
 #include "TaskQueue.h"
 
 namespace my_edge::demo {
@@ -32,8 +36,11 @@ public:
   bool Init(const nlohmann::json& cfg, std::string* err) override;
   bool Start(std::string* err) override;
   SubmitResult Submit(const my_data::RawCommand& cmd) override;
+  // 一次加锁校验整批命令，按设备分组后每个队列一次批量入队；atomic=true 时全有或全无
+  std::vector<SubmitResult> SubmitBatch(std::vector<my_data::RawCommand>&& cmds, bool atomic = false) override;
 
-  my_data::EdgeStatus GetStatusSnapshot() const override;
+  my_data::EdgeStatus GetStatusSnapshot() const override;              // 返回 GetStatusSnapshotShared 的副本
+  std::shared_ptr<const my_data::EdgeStatus> GetStatusSnapshotShared() const override; // 无锁：设备/队列版本号均未变化时返回缓存快照
   void SetEStop(bool active, const std::string& reason) override;
   void Shutdown() override;
   nlohmann::json DumpInternalInfo() const override;
@@ -74,12 +81,28 @@ private:
   // ---- self action thread ----
   void StartSelfActionThreadLocked();
   void StopSelfActionThreadLocked();
-  void SelfActionLoop();
-  std::optional<my_data::Task> GetSelfTask(int timeout_ms);
+  void SelfActionLoop(my_control::TaskQueue* queue);
+  // timeout_ms<0 表示无限等待；队列关闭或超时返回 nullopt
+  std::optional<my_data::Task> GetSelfTask(my_control::TaskQueue* queue, int timeout_ms);
   void ExecuteSelfTask(const my_data::Task& task);
   
   bool AppendTaskToTargetTaskQueue(const my_data::DeviceId& device_id, const Task& task);
 
+  // ---- 任务日志（锁内调用）----
+  bool OpenTaskJournalLocked(std::string* err);
+  void CloseTaskJournalLocked();
+
+  // Submit/SubmitBatch 共用（rw_mutex_ 共享锁内调用）：失败时返回 false/nullopt 并写出 fail
+  bool CheckAcceptingLocked(const my_data::RawCommand& cmd, SubmitResult* fail) const;
+  std::optional<my_data::Task> PrepareTaskLocked(const my_data::RawCommand& cmd, std::int64_t received_us,
+                                                 SubmitResult* fail) const;
+
+  // 向 status_cache_ 发布设备/队列来源（锁内调用，devices_/queues_ 变化之后）
+  void PublishStatusSourcesLocked();
+
+  // 是否参与去重；window_ms 输出实际窗口
+  bool DedupParamsOf(const my_data::Task& task, std::int64_t* window_ms) const;
+
 private:
   mutable std::shared_mutex rw_mutex_;
 
@@ -105,13 +128,30 @@ private:
   std::unordered_map<std::string, std::unique_ptr<my_control::ICommandNormalizer>> normalizers_by_type_;
 
   // device_id -> queue/device（实例归 Edge 持有）
-  std::unordered_map<my_data::DeviceId, std::unique_ptr<my_control::TaskQueue>> queues_;
+  // shared_ptr：状态快照（status_cache_）共享持有设备/队列，清理映射后读方仍可安全访问
+  std::unordered_map<my_data::DeviceId, std::shared_ptr<my_control::TaskQueue>> queues_;
   std::unordered_map<my_data::DeviceId, std::unique_ptr<my_control::TaskQueue>> history_queues_;
-  std::unordered_map<my_data::DeviceId, std::unique_ptr<my_device::IDevice>>    devices_;
+  std::unordered_map<my_data::DeviceId, std::shared_ptr<my_device::IDevice>>    devices_;
 
   // 保存 cfg（调试）
   nlohmann::json cfg_;
 
+  // ---- 任务日志（可选，所有队列共用一个）----
+  bool                                     task_journal_enable_{false};
+  std::string                              task_journal_path_{};
+  std::shared_ptr<my_control::TaskJournal> task_journal_;
+
+  // 所有队列共用：task_queue_mode / task_queue_drop_expired
+  my_control::TaskQueueOptions             task_queue_options_{};
+
+  // ---- Submit 幂等去重 ----
+  bool                                     dedup_enable_{true};
+  std::int64_t                             dedup_default_window_ms_{0};
+  DedupTable                               dedup_;   // idempotency_key -> 首次 SubmitResult（自带锁）
+
+  // ---- 状态快照缓存（GetStatusSnapshotShared 读方不取 rw_mutex_） ----
+  EdgeStatusCache                          status_cache_;
+
   // ---- snapshot thread config/state ----
   bool                status_snapshot_enable_{false};
   int                 status_snapshot_interval_ms_{5000};
@@ -0,0 +1,514 @@
+#include "FlyControlCapture.h"
+#include "MyLog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// =============================================================================
+// 飞控串口抓包实现
+// =============================================================================
+
+namespace fly_control {
+
+namespace {
+
+constexpr size_t MIN_SEGMENT_SIZE = 64u << 10;   // 分段至少 64KB，保证能容纳一次串口读
+
+#if !defined(_WIN32)
+std::string ErrnoMessage(const std::string& what, const std::string& path) {
+    return what + " " + path + ": " + std::strerror(errno);
+}
+#endif
+
+// 录制标签：本地时间到毫秒 + pid + 进程内序号，同一秒内重启或同一进程重复 Open 都不会重名
+std::string MakeSessionTag() {
+    static std::atomic<uint32_t> open_seq{0};
+    const auto now_tp = std::chrono::system_clock::now();
+    const std::time_t now = std::chrono::system_clock::to_time_t(now_tp);
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now_tp.time_since_epoch()).count() % 1000;
+    std::tm tm_buf{};
+#if defined(_WIN32)
+    localtime_s(&tm_buf, &now);
+    const long pid = 0;
+#else
+    localtime_r(&now, &tm_buf);
+    const long pid = static_cast<long>(::getpid());
+#endif
+    char date[32] = {0};
+    std::strftime(date, sizeof(date), "%Y%m%d_%H%M%S", &tm_buf);
+    char buf[80] = {0};
+    std::snprintf(buf, sizeof(buf), "%s_%03d_%ld_%03u", date, static_cast<int>(ms), pid,
+                  open_seq.fetch_add(1) % 1000);
+    return buf;
+}
+
+} // namespace
+
+int64_t CaptureNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// =============================================================================
+// CaptureWriter
+// =============================================================================
+
+CaptureWriter::~CaptureWriter() {
+    Close();
+}
+
+bool CaptureWriter::ParseOptions(const nlohmann::json& cfg, Options& out, std::string* err) {
+    try {
+        Options opts = out;   // 未配置的字段沿用调用方给的默认值
+        opts.dir    = cfg.value("dir", std::string());
+        opts.prefix = cfg.value("prefix", opts.prefix);
+        const size_t segment_mb = cfg.value("segment_size_mb", static_cast<size_t>(opts.segment_size >> 20));
+        opts.segment_size = segment_mb << 20;
+        opts.max_segments = cfg.value("max_segments", opts.max_segments);
+        if (opts.dir.empty()) {
+            if (err) *err = "capture.dir 不能为空";
+            return false;
+        }
+        if (opts.segment_size < MIN_SEGMENT_SIZE || opts.max_segments == 0) {
+            if (err) *err = "capture.segment_size_mb 与 capture.max_segments 必须大于 0";
+            return false;
+        }
+        out = opts;
+        return true;
+    } catch (const std::exception& e) {
+        if (err) *err = std::string("capture 配置解析失败: ") + e.what();
+        return false;
+    }
+}
+
+bool CaptureWriter::Open(const Options& options, std::string* err) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (current_.map != nullptr || rotator_.joinable()) {
+        if (err) *err = "capture 已打开";
+        return false;
+    }
+    if (options.segment_size < MIN_SEGMENT_SIZE || options.max_segments == 0) {
+        if (err) *err = "capture 分段大小或分段数量无效";
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(options.dir, ec);
+    if (ec) {
+        if (err) *err = "创建抓包目录失败 " + options.dir + ": " + ec.message();
+        return false;
+    }
+
+    options_       = options;
+    session_tag_   = MakeSessionTag();
+    segment_index_ = 0;
+    spare_failed_  = false;
+    spare_error_.clear();
+    rotator_stop_  = false;
+    records_ = bytes_ = dropped_ = rotation_waits_ = 0;
+    if (!OpenSegment(0, false, current_, err)) {
+        return false;
+    }
+    PruneSegments(current_.path);
+
+    // 后台线程随即预备第 1 个分段
+    rotator_ = std::thread(&CaptureWriter::RotatorLoop, this);
+    return true;
+}
+
+void CaptureWriter::Close() {
+    std::thread rotator;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (current_.map == nullptr && !rotator_.joinable()) {
+            return;
+        }
+        rotator_stop_ = true;
+        rotator = std::move(rotator_);
+    }
+    rotator_cv_.notify_all();
+    spare_cv_.notify_all();
+    if (rotator.joinable()) {
+        rotator.join();
+    }
+
+    // 后台线程已退出，剩下的收尾在这里完成
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& path : unpublished_) {
+        std::error_code ec;
+        std::filesystem::rename(path + ".part", path, ec);
+    }
+    if (!unpublished_.empty()) {
+        PruneSegments(current_.path);
+    }
+    unpublished_.clear();
+    for (auto& seg : retired_) {
+        CloseSegment(seg);
+    }
+    retired_.clear();
+    CloseSegment(current_);
+    if (spare_.map != nullptr) {
+        const std::string spare_path = spare_.path + ".part";
+        CloseSegment(spare_);
+        std::error_code ec;
+        std::filesystem::remove(spare_path, ec);
+    }
+    spare_ = Segment{};
+}
+
+bool CaptureWriter::IsOpen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_.map != nullptr;
+}
+
+bool CaptureWriter::Append(CaptureDirection direction, const uint8_t* data, size_t len, int64_t mono_ns) {
+    const size_t need = sizeof(CaptureRecordHeader) + len;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (current_.map == nullptr) {
+        return false;
+    }
+    if (need > options_.segment_size - sizeof(CaptureFileHeader)) {
+        ++dropped_;
+        return false;
+    }
+    // 当前分段写满：切换到预备分段（等待期间其他线程可能已经切换过，所以循环判断）
+    while (current_.map != nullptr && current_.used + need > current_.size) {
+        if (spare_.map != nullptr) {
+            ActivateSpareLocked();
+            break;
+        }
+        if (spare_failed_) {
+            MYLOG_ERROR("[FlyControlCapture] 滚动分段失败，停止录制: {}", spare_error_);
+            retired_.push_back(std::exchange(current_, Segment{}));
+            rotator_cv_.notify_one();
+            break;
+        }
+        if (rotator_stop_) {
+            break;
+        }
+        ++rotation_waits_;
+        rotator_cv_.notify_one();
+        spare_cv_.wait(lock, [this]() { return spare_.map != nullptr || spare_failed_ || rotator_stop_; });
+    }
+    if (current_.map == nullptr || current_.used + need > current_.size) {
+        ++dropped_;
+        return false;
+    }
+
+    CaptureRecordHeader rec{};
+    rec.mono_ns   = mono_ns;
+    rec.len       = static_cast<uint32_t>(len);
+    rec.direction = static_cast<uint8_t>(direction);
+    std::memcpy(current_.map + current_.used, &rec, sizeof(rec));
+    if (len > 0) {
+        std::memcpy(current_.map + current_.used + sizeof(rec), data, len);
+    }
+    current_.used += need;
+
+    // 记录完整写入后再推进 data_end，读取端永远看不到半条记录
+    reinterpret_cast<CaptureFileHeader*>(current_.map)->data_end = current_.used;
+    ++records_;
+    bytes_ += len;
+    return true;
+}
+
+nlohmann::json CaptureWriter::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    nlohmann::json j;
+    j["open"]           = current_.map != nullptr;
+    j["records"]        = records_;
+    j["bytes"]          = bytes_;
+    j["dropped"]        = dropped_;
+    j["segments"]       = segment_index_ + (current_.map != nullptr ? 1 : 0);
+    j["rotation_waits"] = rotation_waits_;
+    j["current_path"]   = current_.map != nullptr ? current_.path : std::string();
+    return j;
+}
+
+void CaptureWriter::ActivateSpareLocked() {
+    retired_.push_back(std::exchange(current_, Segment{}));
+    current_ = std::exchange(spare_, Segment{});
+    segment_index_ = current_.index;
+
+    // 文件头的起始时刻以实际启用时为准
+    auto* header = reinterpret_cast<CaptureFileHeader*>(current_.map);
+    header->start_mono_ns = CaptureNowNs();
+    header->start_wall_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    unpublished_.push_back(current_.path);
+    rotator_cv_.notify_one();
+}
+
+void CaptureWriter::RotatorLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        rotator_cv_.wait(lock, [this]() {
+            return rotator_stop_ || !retired_.empty() || !unpublished_.empty() ||
+                   (current_.map != nullptr && spare_.map == nullptr && !spare_failed_);
+        });
+        if (rotator_stop_) {
+            break;
+        }
+        auto retired     = std::exchange(retired_, {});
+        auto unpublished = std::exchange(unpublished_, {});
+        const bool need_spare = current_.map != nullptr && spare_.map == nullptr && !spare_failed_;
+        const uint32_t next_index = segment_index_ + 1;
+        const std::string keep = current_.path;
+        lock.unlock();
+
+        for (const auto& path : unpublished) {
+            std::error_code ec;
+            std::filesystem::rename(path + ".part", path, ec);
+            if (ec) {
+                MYLOG_WARN("[FlyControlCapture] 抓包分段改名失败: path={}, err={}", path, ec.message());
+            }
+        }
+        for (auto& seg : retired) {
+            CloseSegment(seg);
+        }
+        Segment seg;
+        std::string err;
+        const bool ok = !need_spare || OpenSegment(next_index, true, seg, &err);
+        if (!unpublished.empty()) {
+            PruneSegments(keep);
+        }
+
+        lock.lock();
+        if (need_spare) {
+            if (ok) {
+                spare_ = std::move(seg);
+            } else {
+                spare_failed_ = true;
+                spare_error_  = err;
+            }
+            spare_cv_.notify_all();
+        }
+    }
+}
+
+bool CaptureWriter::OpenSegment(uint32_t index, bool spare, Segment& seg, std::string* err) const {
+    char name[96] = {0};
+    std::snprintf(name, sizeof(name), "_%s_%04u", session_tag_.c_str(), index);
+    const std::string path =
+        (std::filesystem::path(options_.dir) / (options_.prefix + name + CAPTURE_FILE_SUFFIX)).string();
+    const std::string file_path = spare ? path + ".part" : path;
+
+#if defined(_WIN32)
+    (void)file_path;
+    (void)seg;
+    if (err) *err = "fly control capture is not supported on this platform";
+    return false;
+#else
+    // O_EXCL：文件名按录制唯一，已存在说明出了问题，宁可失败也不覆盖旧抓包
+    const int fd = ::open(file_path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        if (err) *err = ErrnoMessage("open", file_path);
+        return false;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(options_.segment_size)) != 0) {
+        if (err) *err = ErrnoMessage("ftruncate", file_path);
+        ::close(fd);
+        return false;
+    }
+    void* map = ::mmap(nullptr, options_.segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        if (err) *err = ErrnoMessage("mmap", file_path);
+        ::close(fd);
+        return false;
+    }
+
+    seg.fd    = fd;
+    seg.map   = static_cast<uint8_t*>(map);
+    seg.size  = options_.segment_size;
+    seg.used  = sizeof(CaptureFileHeader);
+    seg.index = index;
+    seg.path  = path;
+
+    CaptureFileHeader header{};
+    std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+    header.version       = CAPTURE_VERSION;
+    header.header_size   = sizeof(CaptureFileHeader);
+    header.data_end      = seg.used;
+    header.start_mono_ns = CaptureNowNs();
+    header.start_wall_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    header.segment_index = index;
+    std::memcpy(seg.map, &header, sizeof(header));
+
+    MYLOG_INFO("[FlyControlCapture] {}抓包分段: path={}, segment_size={}", spare ? "预备" : "开始写入", path, seg.size);
+    return true;
+#endif
+}
+
+void CaptureWriter::PruneSegments(const std::string& keep) const {
+    // 按目录统计：之前录制（包括已退出进程）留下的分段也计入 max_segments；.part 预备分段不计入
+    const std::string head = options_.prefix + "_";
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(options_.dir, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (entry.is_regular_file() && entry.path().extension() == CAPTURE_FILE_SUFFIX &&
+            name.compare(0, head.size(), head) == 0) {
+            files.push_back(entry.path().string());
+        }
+    }
+    if (files.size() <= options_.max_segments) {
+        return;
+    }
+    std::sort(files.begin(), files.end());
+    size_t excess = files.size() - options_.max_segments;
+    for (const auto& file : files) {
+        if (excess == 0) {
+            break;
+        }
+        if (file == keep) {
+            continue;
+        }
+        std::filesystem::remove(file, ec);
+        --excess;
+    }
+}
+
+void CaptureWriter::CloseSegment(Segment& seg) {
+#if !defined(_WIN32)
+    if (seg.map == nullptr) {
+        return;
+    }
+    ::munmap(seg.map, seg.size);
+    // 截掉预分配但未使用的尾部，文件大小即有效数据长度
+    if (::ftruncate(seg.fd, static_cast<off_t>(seg.used)) != 0) {
+        MYLOG_WARN("[FlyControlCapture] 截断抓包分段失败: {}", std::strerror(errno));
+    }
+    ::close(seg.fd);
+#endif
+    seg = Segment{};
+}
+
+// =============================================================================
+// CaptureReader
+// =============================================================================
+
+CaptureReader::~CaptureReader() {
+    Close();
+}
+
+bool CaptureReader::Open(const std::string& path, std::string* err) {
+    Close();
+#if defined(_WIN32)
+    (void)path;
+    if (err) *err = "fly control capture is not supported on this platform";
+    return false;
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (err) *err = ErrnoMessage("open", path);
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        if (err) *err = ErrnoMessage("fstat", path);
+        ::close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    if (size < sizeof(CaptureFileHeader)) {
+        if (err) *err = "抓包文件过短: " + path;
+        ::close(fd);
+        return false;
+    }
+    void* map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        if (err) *err = ErrnoMessage("mmap", path);
+        return false;
+    }
+
+    std::memcpy(&header_, map, sizeof(header_));
+    if (std::memcmp(header_.magic, CAPTURE_MAGIC, sizeof(header_.magic)) != 0 ||
+        header_.version != CAPTURE_VERSION || header_.header_size != sizeof(CaptureFileHeader)) {
+        if (err) *err = "不是有效的飞控抓包文件: " + path;
+        ::munmap(map, size);
+        return false;
+    }
+
+    map_      = static_cast<const uint8_t*>(map);
+    map_size_ = size;
+    // 进程崩溃时文件未截断，以文件头记录的 data_end 为准
+    data_end_ = static_cast<size_t>(std::min<uint64_t>(header_.data_end, size));
+    read_off_ = sizeof(CaptureFileHeader);
+    return true;
+#endif
+}
+
+void CaptureReader::Close() {
+#if !defined(_WIN32)
+    if (map_ != nullptr) {
+        ::munmap(const_cast<uint8_t*>(map_), map_size_);
+    }
+#endif
+    map_      = nullptr;
+    map_size_ = 0;
+    data_end_ = 0;
+    read_off_ = 0;
+}
+
+bool CaptureReader::Next(CaptureRecordView& rec) {
+    if (map_ == nullptr || read_off_ > data_end_ || data_end_ - read_off_ < sizeof(CaptureRecordHeader)) {
+        return false;
+    }
+    CaptureRecordHeader hdr;
+    std::memcpy(&hdr, map_ + read_off_, sizeof(hdr));
+    const size_t body = read_off_ + sizeof(hdr);
+    if (hdr.len > data_end_ - body) {
+        return false;  // 记录越界，视为文件末尾损坏
+    }
+    rec.mono_ns   = hdr.mono_ns;
+    rec.direction = static_cast<CaptureDirection>(hdr.direction);
+    rec.data      = map_ + body;
+    rec.len       = hdr.len;
+    read_off_     = body + hdr.len;
+    return true;
+}
+
+void CaptureReader::Rewind() {
+    read_off_ = (map_ != nullptr) ? sizeof(CaptureFileHeader) : 0;
+}
+
+std::vector<std::string> CaptureReader::ListCaptureFiles(const std::string& path, std::string* err) {
+    std::vector<std::string> files;
+    std::error_code ec;
+    if (std::filesystem::is_directory(path, ec)) {
+        for (const auto& entry : std::filesystem::directory_iterator(path, ec)) {
+            if (entry.is_regular_file() && entry.path().extension() == CAPTURE_FILE_SUFFIX) {
+                files.push_back(entry.path().string());
+            }
+        }
+        // 文件名含录制时间与零填充分段序号，字典序即时间顺序
+        std::sort(files.begin(), files.end());
+    } else if (std::filesystem::is_regular_file(path, ec)) {
+        files.push_back(path);
+    }
+    if (files.empty() && err != nullptr) {
+        *err = "未找到抓包文件: " + path;
+    }
+    return files;
+}
+
+} // namespace fly_control
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+// =============================================================================
+// 飞控串口原始字节抓包（录制 / 读取）
+//
+// 文件格式（.fccap，主机字节序，目标平台均为小端）：
+//   CaptureFileHeader(64) + N × [ CaptureRecordHeader(16) + 原始字节(len) ]
+//
+//   - 每个分段文件创建时预分配 segment_size 字节并 mmap，追加只做 memcpy，
+//     不经过 write 系统调用；写满后切换到后台线程预先打开的下一个分段，
+//     旧分段的截断/关闭、新分段的创建/映射、过期分段的删除都在后台线程完成，
+//     接收/发送线程上的 Append 不做文件系统操作
+//   - 预先打开的分段以 .fccap.part 命名，启用后由后台线程改名为 .fccap
+//   - 文件头中的 data_end 在每条记录写完后更新，进程崩溃后读取端以它为准，
+//     不会读到预分配区域里的零字节（掉电场景不做保证，未调用 msync）
+//   - 时间戳取 steady_clock 纳秒，同一进程内跨分段单调，可用于原速回放
+//   - 文件名 <prefix>_<日期_时间_毫秒>_<pid>_<序号>_<分段序号>.fccap，多次录制（含同一秒内重启）
+//     互不覆盖，字典序即时间顺序；分段保留数按目录内同一 prefix 的全部分段计算
+//
+// 录制：MyFlyControl 配置 "capture": { "enabled": true, "dir": "..." } 时启用
+// 回放：MyFlyControl::ReplayCapture，或命令行 --fc-replay <文件或目录>
+// =============================================================================
+
+namespace fly_control {
+
+constexpr char     CAPTURE_MAGIC[8]     = {'F', 'C', 'C', 'A', 'P', 'v', '1', '\0'};
+constexpr uint32_t CAPTURE_VERSION      = 1;
+constexpr char     CAPTURE_FILE_SUFFIX[] = ".fccap";
+
+// 数据方向
+enum class CaptureDirection : uint8_t {
+    Rx = 0,   // 飞控 → 域控（串口收到）
+    Tx = 1,   // 域控 → 飞控（串口发出）
+};
+
+struct CaptureFileHeader {
+    char     magic[8];            // CAPTURE_MAGIC
+    uint32_t version;             // CAPTURE_VERSION
+    uint32_t header_size;         // sizeof(CaptureFileHeader)
+    uint64_t data_end;            // 有效数据末尾偏移（含文件头）
+    int64_t  start_mono_ns;       // 分段创建时的 steady_clock
+    int64_t  start_wall_us;       // 分段创建时的 system_clock，便于和日志对照
+    uint32_t segment_index;       // 本次录制中的分段序号
+    uint8_t  reserved[20];
+};
+static_assert(sizeof(CaptureFileHeader) == 64, "capture file header must be 64 bytes");
+
+struct CaptureRecordHeader {
+    int64_t  mono_ns;             // 收到/发出时刻（steady_clock 纳秒）
+    uint32_t len;                 // 原始字节长度
+    uint8_t  direction;           // CaptureDirection
+    uint8_t  reserved[3];
+};
+static_assert(sizeof(CaptureRecordHeader) == 16, "capture record header must be 16 bytes");
+
+// 一条记录的视图，data 指向读取端的映射内存
+struct CaptureRecordView {
+    int64_t          mono_ns   = 0;
+    CaptureDirection direction = CaptureDirection::Rx;
+    const uint8_t*   data      = nullptr;
+    size_t           len       = 0;
+};
+
+// steady_clock 当前时刻（纳秒）
+int64_t CaptureNowNs();
+
+// ---------------------------------------------------------------------------
+// 录制端：线程安全，接收线程与发送线程可并发 Append；Open 后带一个后台滚动线程
+// ---------------------------------------------------------------------------
+class CaptureWriter {
+public:
+    struct Options {
+        std::string dir;                          // 输出目录（不存在时自动创建）
+        std::string prefix       = "fly_control"; // 文件名前缀
+        size_t      segment_size = 16u << 20;     // 单个分段大小（字节）
+        size_t      max_segments = 8;             // 目录内同一 prefix 最多保留的分段数（跨多次录制），超出删除最旧的
+    };
+
+    CaptureWriter() = default;
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    // 从 JSON 解析录制配置：{ "dir", "prefix", "segment_size_mb", "max_segments" }
+    // 未出现的字段保留 out 中原有的值
+    static bool ParseOptions(const nlohmann::json& cfg, Options& out, std::string* err);
+
+    // 打开第一个分段并启动后台滚动线程
+    bool Open(const Options& options, std::string* err = nullptr);
+
+    // 停止后台线程，截断当前分段到有效长度并关闭，删除未启用的预备分段
+    void Close();
+
+    bool IsOpen() const;
+
+    // 追加一条记录；单条记录超过分段容量或滚动失败时丢弃并计数
+    // 分段写满时只交换到预备分段；预备分段尚未就绪（后台线程没跟上）时等待，计入 rotation_waits
+    bool Append(CaptureDirection direction, const uint8_t* data, size_t len,
+                int64_t mono_ns = CaptureNowNs());
+
+    // 录制统计：records / bytes / dropped / segments / rotation_waits / current_path
+    nlohmann::json GetStats() const;
+
+private:
+    // 一个已映射的分段文件
+    struct Segment {
+        int         fd    = -1;
+        uint8_t*    map   = nullptr;
+        size_t      size  = 0;
+        size_t      used  = 0;     // 有效长度（含文件头），关闭时截断到这里
+        uint32_t    index = 0;
+        std::string path;          // 最终文件名（预备分段在磁盘上另带 .part 后缀）
+    };
+
+    // 以下三个函数不持锁调用（只读 options_ / session_tag_，二者在后台线程运行期间不变）
+    bool OpenSegment(uint32_t index, bool spare, Segment& seg, std::string* err) const;
+    void PruneSegments(const std::string& keep) const;
+    static void CloseSegment(Segment& seg);
+
+    void ActivateSpareLocked();
+    void RotatorLoop();
+
+    mutable std::mutex      mutex_;
+    std::condition_variable rotator_cv_;        // 唤醒后台线程：有待收尾的分段或需要预备下一个分段
+    std::condition_variable spare_cv_;          // 预备分段就绪（或预备失败）
+    std::thread             rotator_;
+    bool                    rotator_stop_ = false;
+
+    Options                 options_;
+    std::string             session_tag_;       // 本次录制的唯一标签（时间 + pid + 序号），用于分段文件名
+    uint32_t                segment_index_ = 0;
+
+    Segment                  current_;          // 正在写入的分段（map 为空表示未打开）
+    Segment                  spare_;            // 预备好的下一个分段（map 为空表示未就绪）
+    bool                     spare_failed_ = false;
+    std::string              spare_error_;
+    std::vector<Segment>     retired_;          // 已写满、待后台线程截断关闭
+    std::vector<std::string> unpublished_;      // 已启用、待后台线程去掉 .part 后缀
+
+    uint64_t records_        = 0;
+    uint64_t bytes_          = 0;
+    uint64_t dropped_        = 0;
+    uint64_t rotation_waits_ = 0;
+};
+
+// ---------------------------------------------------------------------------
+// 读取端：只读映射一个分段文件，按顺序遍历记录
+// ---------------------------------------------------------------------------
+class CaptureReader {
+public:
+    CaptureReader() = default;
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    bool Open(const std::string& path, std::string* err = nullptr);
+    void Close();
+
+    // 取下一条记录；到达 data_end 或遇到损坏记录时返回 false
+    bool Next(CaptureRecordView& rec);
+
+    // 回到第一条记录
+    void Rewind();
+
+    const CaptureFileHeader& Header() const { return header_; }
+
+    // 列出抓包文件：path 为文件时返回自身，为目录时返回其中所有 .fccap（按文件名排序）
+    static std::vector<std::string> ListCaptureFiles(const std::string& path, std::string* err = nullptr);
+
+private:
+    CaptureFileHeader header_{};
+    const uint8_t*    map_      = nullptr;
+    size_t            map_size_ = 0;
+    size_t            data_end_ = 0;
+    size_t            read_off_ = 0;
+};
+
+} // namespace fly_control
@@ -1,11 +1,10 @@
 #include "FlyControlCodec.h"
 #include "FlyControlFrame.h"
-#include "MyLEHelper.h"
 
 // =============================================================================
 // 协议编解码层实现
-// 所有 encode 函数将结构体字段用 MyLEHelper 写入载荷，然后调用 BuildFrame 组帧
-// 所有 decode 函数从载荷中用 MyLEHelper 按序读出字段
+// 字段按 FlyControlProtocol.h 中的载荷布局以固定偏移读写（StoreFields / LoadFields），
+// 帧直接组装在调用方缓冲区中，校验和原地计算，不再经过中间载荷 vector
 // =============================================================================
 
 namespace fly_control {
@@ -50,315 +49,356 @@ uint16_t FaultBits::ToU16() const {
     return val;
 }
 
+// ===========================================================================
+// 定长帧组帧
+// ===========================================================================
+
+namespace {
+
+// 写入帧头、CNT、帧类型，返回载荷起始位置
+inline uint8_t* WriteFrameHead(uint8_t* frame, uint8_t cnt, uint8_t frame_type) {
+    frame[0] = FRAME_HEADER_0;
+    frame[1] = FRAME_HEADER_1;
+    frame[2] = cnt;
+    frame[3] = frame_type;
+    return frame + FRAME_PAYLOAD_OFFSET;
+}
+
+// 载荷写完后原地计算校验和并写入帧尾；frame_len 为完整帧长度
+inline void WriteFrameTail(uint8_t* frame, size_t frame_len) {
+    const size_t chk_pos = frame_len - FRAME_TAIL_LEN - FRAME_CHECKSUM_LEN;
+    frame[chk_pos]       = CalcChecksum(frame, chk_pos);
+    frame[frame_len - 2] = FRAME_TAIL_0;
+    frame[frame_len - 1] = FRAME_TAIL_1;
+}
+
+// 按布局编码一个定长帧；缓冲区长度与布局不符时编译失败
+template <typename Layout, size_t N, typename... Args>
+inline void EncodeFixedFrame(std::array<uint8_t, N>& out, uint8_t cnt, uint8_t frame_type,
+                             const Args&... fields) {
+    static_assert(N == FrameLenOf(Layout::SIZE), "frame buffer size does not match payload layout");
+    StoreFields<Layout>(WriteFrameHead(out.data(), cnt, frame_type), fields...);
+    WriteFrameTail(out.data(), N);
+}
+
+template <size_t N>
+inline std::vector<uint8_t> ToVector(const std::array<uint8_t, N>& frame) {
+    return std::vector<uint8_t>(frame.begin(), frame.end());
+}
+
+} // namespace
+
 // ===========================================================================
 // 解码函数实现
+// 载荷（不含帧头/CNT/帧类型）按布局固定偏移读取，只做一次长度检查
 // ===========================================================================
 
 // ---------------------------------------------------------------------------
-// 解码心跳帧载荷
-// payload 布局（不含帧头/CNT/帧类型，即从飞机ID开始）：
-//   飞机ID(1) + 运行模式(1) + 定位星数(1) + lon(4) + lat(4) + alt(2) + ...
-//   共 82 字节（89 - 帧头2 - CNT1 - 帧类型1 - 校验1 - 帧尾2 = 82）
+// 解码心跳帧载荷（从飞机ID开始，共 HeartbeatLayout::SIZE = 82 字节）
 // ---------------------------------------------------------------------------
-bool DecodeHeartbeat(const std::vector<uint8_t>& payload, HeartbeatData& out) {
-    // 心跳载荷长度应为 82 字节
-    if (payload.size() < 82) {
+bool DecodeHeartbeat(const uint8_t* payload, size_t len, HeartbeatData& out) {
+    if (len < HeartbeatLayout::SIZE) {
         return false;
     }
-
-    size_t off = 0;
-    out.aircraft_id     = MyLEHelper::read_uint8(payload, off);
-    out.run_mode        = MyLEHelper::read_uint8(payload, off);
-    out.satellite_count = MyLEHelper::read_uint8(payload, off);
-    out.longitude       = static_cast<int32_t>(MyLEHelper::read_uint32(payload, off));
-    out.latitude        = static_cast<int32_t>(MyLEHelper::read_uint32(payload, off));
-    out.altitude        = MyLEHelper::read_uint16(payload, off);
-    out.relative_alt    = MyLEHelper::read_uint16(payload, off);
-    out.airspeed        = MyLEHelper::read_uint16(payload, off);
-    out.groundspeed     = MyLEHelper::read_uint16(payload, off);
-    out.velocity_x      = MyLEHelper::read_int16(payload, off);
-    out.velocity_y      = MyLEHelper::read_int16(payload, off);
-    out.velocity_z      = MyLEHelper::read_int16(payload, off);
-    out.accel_x         = MyLEHelper::read_int16(payload, off);
-    out.accel_y         = MyLEHelper::read_int16(payload, off);
-    out.accel_z         = MyLEHelper::read_int16(payload, off);
-    out.roll            = MyLEHelper::read_int16(payload, off);
-    out.pitch           = MyLEHelper::read_int16(payload, off);
-    out.yaw             = MyLEHelper::read_uint16(payload, off);
-    out.flight_mode     = MyLEHelper::read_uint8(payload, off);
-    out.current_waypoint = MyLEHelper::read_uint16(payload, off);
-    out.battery_voltage = MyLEHelper::read_uint16(payload, off);
-    out.battery_percent = MyLEHelper::read_uint8(payload, off);
-    out.battery_current = MyLEHelper::read_uint16(payload, off);
-    out.atm_pressure    = MyLEHelper::read_uint16(payload, off);
-    out.utc_timestamp   = MyLEHelper::read_uint64(payload, off);
-    out.fault_info      = MyLEHelper::read_uint16(payload, off);
-    out.rotation_speed  = MyLEHelper::read_uint16(payload, off);
-    out.throttle        = MyLEHelper::read_uint16(payload, off);
-    out.target_altitude = MyLEHelper::read_uint16(payload, off);
-    out.target_speed    = MyLEHelper::read_uint16(payload, off);
-    out.origin_distance = MyLEHelper::read_uint16(payload, off);
-    out.origin_heading  = MyLEHelper::read_uint16(payload, off);
-    out.target_distance = MyLEHelper::read_uint16(payload, off);
-    out.flight_state    = MyLEHelper::read_uint8(payload, off);
-    out.altitude_state  = MyLEHelper::read_uint8(payload, off);
-    out.state_switch_src = MyLEHelper::read_uint8(payload, off);
-    out.flight_time     = MyLEHelper::read_uint16(payload, off);
-    out.flight_range    = MyLEHelper::read_uint16(payload, off);
-    out.reserved        = MyLEHelper::read_uint32(payload, off);
-
+    LoadFields<HeartbeatLayout>(payload,
+        out.aircraft_id, out.run_mode, out.satellite_count,
+        out.longitude, out.latitude,
+        out.altitude, out.relative_alt, out.airspeed, out.groundspeed,
+        out.velocity_x, out.velocity_y, out.velocity_z,
+        out.accel_x, out.accel_y, out.accel_z,
+        out.roll, out.pitch, out.yaw,
+        out.flight_mode, out.current_waypoint, out.battery_voltage, out.battery_percent,
+        out.battery_current, out.atm_pressure, out.utc_timestamp,
+        out.fault_info, out.rotation_speed, out.throttle, out.target_altitude, out.target_speed,
+        out.origin_distance, out.origin_heading, out.target_distance,
+        out.flight_state, out.altitude_state, out.state_switch_src,
+        out.flight_time, out.flight_range, out.reserved);
     return true;
 }
 
+bool DecodeHeartbeat(const std::vector<uint8_t>& payload, HeartbeatData& out) {
+    return DecodeHeartbeat(payload.data(), payload.size(), out);
+}
+
 // ---------------------------------------------------------------------------
 // 解码云台控制帧载荷
 // payload: 使能(1) + 俯仰(2) + 偏航(2) = 5 字节
 // ---------------------------------------------------------------------------
-bool DecodeGimbalControl(const std::vector<uint8_t>& payload, GimbalControlData& out) {
-    if (payload.size() < 5) {
+bool DecodeGimbalControl(const uint8_t* payload, size_t len, GimbalControlData& out) {
+    if (len < GimbalControlLayout::SIZE) {
         return false;
     }
-    size_t off = 0;
-    out.enable      = MyLEHelper::read_uint8(payload, off);
-    out.pitch_angle = MyLEHelper::read_int16(payload, off);
-    out.yaw_angle   = MyLEHelper::read_int16(payload, off);
+    LoadFields<GimbalControlLayout>(payload, out.enable, out.pitch_angle, out.yaw_angle);
     return true;
 }
 
+bool DecodeGimbalControl(const std::vector<uint8_t>& payload, GimbalControlData& out) {
+    return DecodeGimbalControl(payload.data(), payload.size(), out);
+}
+
 // ---------------------------------------------------------------------------
 // 解码指令回复帧载荷
 // payload: 回复指令类型(1) + 结果(1) = 2 字节
 // ---------------------------------------------------------------------------
-bool DecodeCommandReply(const std::vector<uint8_t>& payload, CommandReplyData& out) {
-    if (payload.size() < 2) {
+bool DecodeCommandReply(const uint8_t* payload, size_t len, CommandReplyData& out) {
+    if (len < CommandReplyLayout::SIZE) {
         return false;
     }
-    size_t off = 0;
-    out.replied_cmd = MyLEHelper::read_uint8(payload, off);
-    out.result      = MyLEHelper::read_uint8(payload, off);
+    LoadFields<CommandReplyLayout>(payload, out.replied_cmd, out.result);
     return true;
 }
 
+bool DecodeCommandReply(const std::vector<uint8_t>& payload, CommandReplyData& out) {
+    return DecodeCommandReply(payload.data(), payload.size(), out);
+}
+
 // ===========================================================================
-// 编码函数实现
+// 编码函数实现（写入调用方缓冲区）
 // ===========================================================================
 
 // ---------------------------------------------------------------------------
 // 编码：设置飞行目的地（帧类型 0x02）
 // ---------------------------------------------------------------------------
-std::vector<uint8_t> EncodeSetDestination(uint8_t cnt, const SetDestinationData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.longitude));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.latitude));
-    MyLEHelper::write_uint16(payload, data.altitude);
-    return BuildFrame(cnt, FRAME_TYPE_SET_DESTINATION, payload);
-}
-
-// ---------------------------------------------------------------------------
-// 编码：设置飞行航线（帧类型 0x10, 变长）
-// ---------------------------------------------------------------------------
-std::vector<uint8_t> EncodeSetRoute(uint8_t cnt, const SetRouteData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, static_cast<uint8_t>(data.points.size()));
-    for (const auto& pt : data.points) {
-        MyLEHelper::write_uint32(payload, static_cast<uint32_t>(pt.longitude));
-        MyLEHelper::write_uint32(payload, static_cast<uint32_t>(pt.latitude));
-        MyLEHelper::write_uint16(payload, pt.altitude);
-        MyLEHelper::write_uint16(payload, pt.index);
-        MyLEHelper::write_uint16(payload, pt.speed);
-    }
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+void EncodeSetDestination(uint8_t cnt, const SetDestinationData& data, SetDestinationFrame& out) {
+    EncodeFixedFrame<SetDestinationLayout>(out, cnt, FRAME_TYPE_SET_DESTINATION,
+        data.cmd_type, data.longitude, data.latitude, data.altitude);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：设置角度（帧类型 0x10, 指令 0x03）
 // ---------------------------------------------------------------------------
-std::vector<uint8_t> EncodeSetAngle(uint8_t cnt, const SetAngleData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_int16(payload, data.pitch);
-    MyLEHelper::write_uint16(payload, data.yaw);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+void EncodeSetAngle(uint8_t cnt, const SetAngleData& data, SetAngleFrame& out) {
+    EncodeFixedFrame<SetAngleLayout>(out, cnt, FRAME_TYPE_COMMAND, data.cmd_type, data.pitch, data.yaw);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：设置速度（帧类型 0x10, 指令 0x04）
 // ---------------------------------------------------------------------------
-std::vector<uint8_t> EncodeSetSpeed(uint8_t cnt, const SetSpeedData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint16(payload, data.speed);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+void EncodeSetSpeed(uint8_t cnt, const SetSpeedData& data, SetSpeedFrame& out) {
+    EncodeFixedFrame<SetSpeedLayout>(out, cnt, FRAME_TYPE_COMMAND, data.cmd_type, data.speed);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：设置高度（帧类型 0x10, 指令 0x05）
 // ---------------------------------------------------------------------------
-std::vector<uint8_t> EncodeSetAltitude(uint8_t cnt, const SetAltitudeData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, data.altitude_type);
-    MyLEHelper::write_uint16(payload, data.altitude);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+void EncodeSetAltitude(uint8_t cnt, const SetAltitudeData& data, SetAltitudeFrame& out) {
+    EncodeFixedFrame<SetAltitudeLayout>(out, cnt, FRAME_TYPE_COMMAND,
+        data.cmd_type, data.altitude_type, data.altitude);
 }
 
 // ---------------------------------------------------------------------------
-// 编码：电源开关（帧类型 0x10, 指令 0x06）
+// 编码：电源开关 / 开伞 / 指令按钮 / 切换运行模式（帧类型 0x10, 指令类型 + 1 字节参数）
 // ---------------------------------------------------------------------------
-std::vector<uint8_t> EncodePowerSwitch(uint8_t cnt, const PowerSwitchData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, data.command);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+void EncodePowerSwitch(uint8_t cnt, const PowerSwitchData& data, SingleByteCmdFrame& out) {
+    EncodeFixedFrame<SingleByteCmdLayout>(out, cnt, FRAME_TYPE_COMMAND, data.cmd_type, data.command);
+}
+
+void EncodeParachute(uint8_t cnt, const ParachuteData& data, SingleByteCmdFrame& out) {
+    EncodeFixedFrame<SingleByteCmdLayout>(out, cnt, FRAME_TYPE_COMMAND, data.cmd_type, data.parachute_type);
+}
+
+void EncodeButtonCommand(uint8_t cnt, const ButtonCommandData& data, SingleByteCmdFrame& out) {
+    EncodeFixedFrame<SingleByteCmdLayout>(out, cnt, FRAME_TYPE_COMMAND, data.cmd_type, data.button);
+}
+
+void EncodeSwitchMode(uint8_t cnt, const SwitchModeData& data, SingleByteCmdFrame& out) {
+    EncodeFixedFrame<SingleByteCmdLayout>(out, cnt, FRAME_TYPE_COMMAND, data.cmd_type, data.mode);
 }
 
 // ---------------------------------------------------------------------------
-// 编码：开伞控制（帧类型 0x10, 指令 0x07）
+// 编码：设置原点/返航点（帧类型 0x10, 指令 0x0A）
 // ---------------------------------------------------------------------------
-std::vector<uint8_t> EncodeParachute(uint8_t cnt, const ParachuteData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, data.parachute_type);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+void EncodeSetOriginReturn(uint8_t cnt, const SetOriginReturnData& data, SetOriginReturnFrame& out) {
+    EncodeFixedFrame<SetOriginReturnLayout>(out, cnt, FRAME_TYPE_COMMAND,
+        data.cmd_type, data.point_type, data.longitude, data.latitude, data.altitude);
 }
 
 // ---------------------------------------------------------------------------
-// 编码：指令按钮（帧类型 0x10, 指令 0x09）
+// 编码：末制导指令（帧类型 0x10, 指令 0x0D）
 // ---------------------------------------------------------------------------
-std::vector<uint8_t> EncodeButtonCommand(uint8_t cnt, const ButtonCommandData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, data.button);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+void EncodeGuidance(uint8_t cnt, const GuidanceData& data, GuidanceFrame& out) {
+    EncodeFixedFrame<GuidanceLayout>(out, cnt, FRAME_TYPE_COMMAND,
+        data.cmd_type, data.mode_switch, data.frame_id, data.track_id,
+        data.target_lon, data.target_lat, data.target_alt);
 }
 
 // ---------------------------------------------------------------------------
-// 编码：设置原点/返航点（帧类型 0x10, 指令 0x0A）
+// 编码：末制导指令新版（帧类型 0x10, 指令 0x0E）
 // ---------------------------------------------------------------------------
-std::vector<uint8_t> EncodeSetOriginReturn(uint8_t cnt, const SetOriginReturnData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, data.point_type);
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.longitude));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.latitude));
-    MyLEHelper::write_uint16(payload, data.altitude);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+void EncodeGuidanceNew(uint8_t cnt, const GuidanceNewData& data, GuidanceNewFrame& out) {
+    EncodeFixedFrame<GuidanceNewLayout>(out, cnt, FRAME_TYPE_COMMAND,
+        data.cmd_type,
+        data.pitch_los_rate, data.yaw_los_rate, data.pitch_los_angle, data.yaw_los_angle,
+        data.pitch_frame_angle, data.yaw_frame_angle, data.gimbal_pitch_angle, data.gimbal_yaw_angle,
+        data.acc_x, data.acc_y, data.acc_z,
+        data.gyro_x, data.gyro_y, data.gyro_z,
+        data.target_id, data.target_type,
+        data.target_lon, data.target_lat, data.target_alt, data.laser_range,
+        data.status);
 }
 
 // ---------------------------------------------------------------------------
-// 编码：设置电子围栏（帧类型 0x10, 变长）
+// 编码：吊舱姿态-角速度模式（帧类型 0x10, 指令 0x0F）
 // ---------------------------------------------------------------------------
-std::vector<uint8_t> EncodeSetGeofence(uint8_t cnt, const SetGeofenceData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, static_cast<uint8_t>(data.points.size()));
-    for (const auto& pt : data.points) {
-        MyLEHelper::write_uint32(payload, static_cast<uint32_t>(pt.longitude));
-        MyLEHelper::write_uint32(payload, static_cast<uint32_t>(pt.latitude));
-        MyLEHelper::write_uint16(payload, pt.altitude);
-        MyLEHelper::write_uint8(payload, pt.index);
-    }
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+void EncodeGimbalAngRate(uint8_t cnt, const GimbalAngRateData& data, GimbalAngRateFrame& out) {
+    EncodeFixedFrame<GimbalAngRateLayout>(out, cnt, FRAME_TYPE_COMMAND,
+        data.cmd_type, data.pitch_los_rate, data.yaw_los_rate,
+        data.target_lon, data.target_lat, data.target_alt, data.laser_range, data.status);
 }
 
 // ---------------------------------------------------------------------------
-// 编码：切换运行模式（帧类型 0x10, 指令 0x0C）
+// 编码：吊舱姿态-角度模式（帧类型 0x10, 指令 0x10）
 // ---------------------------------------------------------------------------
-std::vector<uint8_t> EncodeSwitchMode(uint8_t cnt, const SwitchModeData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, data.mode);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+void EncodeGimbalAngle(uint8_t cnt, const GimbalAngleData& data, GimbalAngleFrame& out) {
+    EncodeFixedFrame<GimbalAngleLayout>(out, cnt, FRAME_TYPE_COMMAND,
+        data.cmd_type, data.pitch_frame_angle, data.yaw_frame_angle, data.pitch_ang_rate, data.yaw_ang_rate);
 }
 
 // ---------------------------------------------------------------------------
-// 编码：末制导指令（帧类型 0x10, 指令 0x0D）
+// 编码：识别目标状态（帧类型 0x10, 指令 0x11）
 // ---------------------------------------------------------------------------
-std::vector<uint8_t> EncodeGuidance(uint8_t cnt, const GuidanceData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, data.mode_switch);
-    MyLEHelper::write_uint32(payload, data.frame_id);
-    MyLEHelper::write_uint32(payload, data.track_id);
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_lon));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_lat));
-    MyLEHelper::write_uint16(payload, data.target_alt);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+void EncodeTargetState(uint8_t cnt, const TargetStateData& data, TargetStateFrame& out) {
+    EncodeFixedFrame<TargetStateLayout>(out, cnt, FRAME_TYPE_COMMAND,
+        data.cmd_type, data.pitch_axis_angle, data.yaw_axis_angle,
+        data.target_vertical_ratio, data.target_horizontal_ratio, data.status);
 }
 
 // ---------------------------------------------------------------------------
-// 编码：末制导指令新版（帧类型 0x10, 指令 0x0E）
+// 编码：设置飞行航线（帧类型 0x10, 变长）
 // ---------------------------------------------------------------------------
-std::vector<uint8_t> EncodeGuidanceNew(uint8_t cnt, const GuidanceNewData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_int16(payload, data.pitch_los_rate);
-    MyLEHelper::write_int16(payload, data.yaw_los_rate);
-    MyLEHelper::write_int16(payload, data.pitch_los_angle);
-    MyLEHelper::write_int16(payload, data.yaw_los_angle);
-    MyLEHelper::write_int16(payload, data.pitch_frame_angle);
-    MyLEHelper::write_int16(payload, data.yaw_frame_angle);
-    MyLEHelper::write_int16(payload, data.gimbal_pitch_angle);
-    MyLEHelper::write_int16(payload, data.gimbal_yaw_angle);
-    MyLEHelper::write_int16(payload, data.acc_x);
-    MyLEHelper::write_int16(payload, data.acc_y);
-    MyLEHelper::write_int16(payload, data.acc_z);
-    MyLEHelper::write_int16(payload, data.gyro_x);
-    MyLEHelper::write_int16(payload, data.gyro_y);
-    MyLEHelper::write_int16(payload, data.gyro_z);
-    MyLEHelper::write_uint16(payload, data.target_id);
-    MyLEHelper::write_uint16(payload, data.target_type);
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_lon));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_lat));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_alt));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.laser_range));
-    MyLEHelper::write_uint8(payload, data.status);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+size_t EncodeSetRoute(uint8_t cnt, const SetRouteData& data, uint8_t* out, size_t capacity) {
+    const size_t frame_len = RouteFrameLen(data.points.size());
+    if (capacity < frame_len) {
+        return 0;
+    }
+    uint8_t* p = WriteFrameHead(out, cnt, FRAME_TYPE_COMMAND);
+    StoreFields<PointListHeaderLayout>(p, data.cmd_type, static_cast<uint8_t>(data.points.size()));
+    p += PointListHeaderLayout::SIZE;
+    for (const auto& pt : data.points) {
+        StoreFields<RoutePointLayout>(p, pt.longitude, pt.latitude, pt.altitude, pt.index, pt.speed);
+        p += RoutePointLayout::SIZE;
+    }
+    WriteFrameTail(out, frame_len);
+    return frame_len;
 }
 
 // ---------------------------------------------------------------------------
-// 编码：吊舱姿态-角速度模式（帧类型 0x10, 指令 0x0F）
+// 编码：设置电子围栏（帧类型 0x10, 变长）
 // ---------------------------------------------------------------------------
+size_t EncodeSetGeofence(uint8_t cnt, const SetGeofenceData& data, uint8_t* out, size_t capacity) {
+    const size_t frame_len = GeofenceFrameLen(data.points.size());
+    if (capacity < frame_len) {
+        return 0;
+    }
+    uint8_t* p = WriteFrameHead(out, cnt, FRAME_TYPE_COMMAND);
+    StoreFields<PointListHeaderLayout>(p, data.cmd_type, static_cast<uint8_t>(data.points.size()));
+    p += PointListHeaderLayout::SIZE;
+    for (const auto& pt : data.points) {
+        StoreFields<GeofencePointLayout>(p, pt.longitude, pt.latitude, pt.altitude, pt.index);
+        p += GeofencePointLayout::SIZE;
+    }
+    WriteFrameTail(out, frame_len);
+    return frame_len;
+}
+
+// ===========================================================================
+// 编码函数实现（返回完整帧 std::vector，包装上面的定长/变长版本）
+// ===========================================================================
+
+std::vector<uint8_t> EncodeSetDestination(uint8_t cnt, const SetDestinationData& data) {
+    SetDestinationFrame frame;
+    EncodeSetDestination(cnt, data, frame);
+    return ToVector(frame);
+}
+
+std::vector<uint8_t> EncodeSetRoute(uint8_t cnt, const SetRouteData& data) {
+    std::vector<uint8_t> frame(RouteFrameLen(data.points.size()));
+    EncodeSetRoute(cnt, data, frame.data(), frame.size());
+    return frame;
+}
+
+std::vector<uint8_t> EncodeSetAngle(uint8_t cnt, const SetAngleData& data) {
+    SetAngleFrame frame;
+    EncodeSetAngle(cnt, data, frame);
+    return ToVector(frame);
+}
+
+std::vector<uint8_t> EncodeSetSpeed(uint8_t cnt, const SetSpeedData& data) {
+    SetSpeedFrame frame;
+    EncodeSetSpeed(cnt, data, frame);
+    return ToVector(frame);
+}
+
+std::vector<uint8_t> EncodeSetAltitude(uint8_t cnt, const SetAltitudeData& data) {
+    SetAltitudeFrame frame;
+    EncodeSetAltitude(cnt, data, frame);
+    return ToVector(frame);
+}
+
+std::vector<uint8_t> EncodePowerSwitch(uint8_t cnt, const PowerSwitchData& data) {
+    SingleByteCmdFrame frame;
+    EncodePowerSwitch(cnt, data, frame);
+    return ToVector(frame);
+}
+
+std::vector<uint8_t> EncodeParachute(uint8_t cnt, const ParachuteData& data) {
+    SingleByteCmdFrame frame;
+    EncodeParachute(cnt, data, frame);
+    return ToVector(frame);
+}
+
+std::vector<uint8_t> EncodeButtonCommand(uint8_t cnt, const ButtonCommandData& data) {
+    SingleByteCmdFrame frame;
+    EncodeButtonCommand(cnt, data, frame);
+    return ToVector(frame);
+}
+
+std::vector<uint8_t> EncodeSetOriginReturn(uint8_t cnt, const SetOriginReturnData& data) {
+    SetOriginReturnFrame frame;
+    EncodeSetOriginReturn(cnt, data, frame);
+    return ToVector(frame);
+}
+
+std::vector<uint8_t> EncodeSetGeofence(uint8_t cnt, const SetGeofenceData& data) {
+    std::vector<uint8_t> frame(GeofenceFrameLen(data.points.size()));
+    EncodeSetGeofence(cnt, data, frame.data(), frame.size());
+    return frame;
+}
+
+std::vector<uint8_t> EncodeSwitchMode(uint8_t cnt, const SwitchModeData& data) {
+    SingleByteCmdFrame frame;
+    EncodeSwitchMode(cnt, data, frame);
+    return ToVector(frame);
+}
+
+std::vector<uint8_t> EncodeGuidance(uint8_t cnt, const GuidanceData& data) {
+    GuidanceFrame frame;
+    EncodeGuidance(cnt, data, frame);
+    return ToVector(frame);
+}
+
+std::vector<uint8_t> EncodeGuidanceNew(uint8_t cnt, const GuidanceNewData& data) {
+    GuidanceNewFrame frame;
+    EncodeGuidanceNew(cnt, data, frame);
+    return ToVector(frame);
+}
+
 std::vector<uint8_t> EncodeGimbalAngRate(uint8_t cnt, const GimbalAngRateData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.pitch_los_rate));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.yaw_los_rate));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_lon));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_lat));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_alt));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.laser_range));
-    MyLEHelper::write_uint8(payload, data.status);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    GimbalAngRateFrame frame;
+    EncodeGimbalAngRate(cnt, data, frame);
+    return ToVector(frame);
 }
 
-// ---------------------------------------------------------------------------
-// 编码：吊舱姿态-角度模式（帧类型 0x10, 指令 0x10）
-// ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeGimbalAngle(uint8_t cnt, const GimbalAngleData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.pitch_frame_angle));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.yaw_frame_angle));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.pitch_ang_rate));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.yaw_ang_rate));
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    GimbalAngleFrame frame;
+    EncodeGimbalAngle(cnt, data, frame);
+    return ToVector(frame);
 }
 
-// ---------------------------------------------------------------------------
-// 编码：识别目标状态（帧类型 0x10, 指令 0x11）
-// ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeTargetState(uint8_t cnt, const TargetStateData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.pitch_axis_angle));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.yaw_axis_angle));
-    MyLEHelper::write_uint8(payload, data.target_vertical_ratio);
-    MyLEHelper::write_uint8(payload, data.target_horizontal_ratio);
-    MyLEHelper::write_uint8(payload, data.status);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    TargetStateFrame frame;
+    EncodeTargetState(cnt, data, frame);
+    return ToVector(frame);
 }
 
 // ===========================================================================
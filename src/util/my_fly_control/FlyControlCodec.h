@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -13,22 +15,43 @@
 //   - Encode*  将结构体编码为完整帧（可直接通过串口发送）
 //   - Decode*  从 ParsedFrame 的 payload 中解码出结构体
 //
-// 所有多字节字段均使用小端编码（MyLEHelper）
+// 字段偏移与长度来自 FlyControlProtocol.h 中的编译期载荷布局，多字节字段小端。
+// 定长帧另有写入 std::array 的重载：缓冲区由调用方持有，编码过程不分配内存，
+// 校验和在缓冲区上原地计算；返回 std::vector 的版本保留给低频调用方。
 // =============================================================================
 
 namespace fly_control {
 
+// ===========================================================================
+// 定长帧缓冲区（长度由载荷布局推导）
+// ===========================================================================
+using SetDestinationFrame  = std::array<uint8_t, SET_DESTINATION_FRAME_LEN>;
+using SetAngleFrame        = std::array<uint8_t, SET_ANGLE_FRAME_LEN>;
+using SetSpeedFrame        = std::array<uint8_t, SET_SPEED_FRAME_LEN>;
+using SetAltitudeFrame     = std::array<uint8_t, SET_ALTITUDE_FRAME_LEN>;
+using SingleByteCmdFrame   = std::array<uint8_t, SINGLE_BYTE_CMD_FRAME_LEN>;  // 电源/开伞/按钮/切换模式
+using SetOriginReturnFrame = std::array<uint8_t, SET_ORIGIN_RETURN_FRAME_LEN>;
+using GuidanceFrame        = std::array<uint8_t, GUIDANCE_FRAME_LEN>;
+using GuidanceNewFrame     = std::array<uint8_t, GUIDANCE_NEW_FRAME_LEN>;
+using GimbalAngRateFrame   = std::array<uint8_t, GIMBAL_ANG_RATE_FRAME_LEN>;
+using GimbalAngleFrame     = std::array<uint8_t, GIMBAL_ANGLE_FRAME_LEN>;
+using TargetStateFrame     = std::array<uint8_t, TARGET_STATE_FRAME_LEN>;
+
 // ===========================================================================
 // 解码函数（帧载荷 → 数据结构）
+// 载荷长度不足布局长度时返回 false；指针版本可直接用于 FrameView::payload()
 // ===========================================================================
 
 // 解码心跳帧载荷→HeartbeatData
+bool DecodeHeartbeat(const uint8_t* payload, size_t len, HeartbeatData& out);
 bool DecodeHeartbeat(const std::vector<uint8_t>& payload, HeartbeatData& out);
 
 // 解码云台控制帧载荷→GimbalControlData
+bool DecodeGimbalControl(const uint8_t* payload, size_t len, GimbalControlData& out);
 bool DecodeGimbalControl(const std::vector<uint8_t>& payload, GimbalControlData& out);
 
 // 解码指令回复帧载荷→CommandReplyData
+bool DecodeCommandReply(const uint8_t* payload, size_t len, CommandReplyData& out);
 bool DecodeCommandReply(const std::vector<uint8_t>& payload, CommandReplyData& out);
 
 // ===========================================================================
@@ -83,6 +106,29 @@ std::vector<uint8_t> EncodeGimbalAngle(uint8_t cnt, const GimbalAngleData& data)
 // 编码识别目标状态帧
 std::vector<uint8_t> EncodeTargetState(uint8_t cnt, const TargetStateData& data);
 
+// ===========================================================================
+// 编码函数（数据结构 → 调用方提供的缓冲区，不分配内存）
+// ===========================================================================
+
+void EncodeSetDestination(uint8_t cnt, const SetDestinationData& data, SetDestinationFrame& out);
+void EncodeSetAngle(uint8_t cnt, const SetAngleData& data, SetAngleFrame& out);
+void EncodeSetSpeed(uint8_t cnt, const SetSpeedData& data, SetSpeedFrame& out);
+void EncodeSetAltitude(uint8_t cnt, const SetAltitudeData& data, SetAltitudeFrame& out);
+void EncodePowerSwitch(uint8_t cnt, const PowerSwitchData& data, SingleByteCmdFrame& out);
+void EncodeParachute(uint8_t cnt, const ParachuteData& data, SingleByteCmdFrame& out);
+void EncodeButtonCommand(uint8_t cnt, const ButtonCommandData& data, SingleByteCmdFrame& out);
+void EncodeSetOriginReturn(uint8_t cnt, const SetOriginReturnData& data, SetOriginReturnFrame& out);
+void EncodeSwitchMode(uint8_t cnt, const SwitchModeData& data, SingleByteCmdFrame& out);
+void EncodeGuidance(uint8_t cnt, const GuidanceData& data, GuidanceFrame& out);
+void EncodeGuidanceNew(uint8_t cnt, const GuidanceNewData& data, GuidanceNewFrame& out);
+void EncodeGimbalAngRate(uint8_t cnt, const GimbalAngRateData& data, GimbalAngRateFrame& out);
+void EncodeGimbalAngle(uint8_t cnt, const GimbalAngleData& data, GimbalAngleFrame& out);
+void EncodeTargetState(uint8_t cnt, const TargetStateData& data, TargetStateFrame& out);
+
+// 变长帧：写入 out[0, capacity)，返回帧长度；容量不足返回 0（所需长度见 RouteFrameLen / GeofenceFrameLen）
+size_t EncodeSetRoute(uint8_t cnt, const SetRouteData& data, uint8_t* out, size_t capacity);
+size_t EncodeSetGeofence(uint8_t cnt, const SetGeofenceData& data, uint8_t* out, size_t capacity);
+
 // ===========================================================================
 // 辅助函数
 // ===========================================================================
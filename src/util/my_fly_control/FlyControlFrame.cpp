@@ -8,10 +8,28 @@ namespace fly_control {
 
 // =============================================================================
 // 校验和计算：buf[0..len-1] 所有字节求和，取低 8 位
+//
+// 按 8 字节一组做 SWAR 累加：奇偶字节分别落在 4 个 16 位通道里，
+// 每组每通道最多增加 510，128 组内不会溢出到相邻通道，之后折叠一次。
 // =============================================================================
 uint8_t CalcChecksum(const uint8_t* data, size_t len) {
+    constexpr uint64_t LANE_MASK   = 0x00FF00FF00FF00FFULL;
+    constexpr size_t   FOLD_BLOCKS = 128;
+
     uint32_t sum = 0;
-    for (size_t i = 0; i < len; ++i) {
+    size_t i = 0;
+    while (len - i >= 8) {
+        uint64_t acc = 0;
+        for (size_t n = 0; n < FOLD_BLOCKS && len - i >= 8; ++n, i += 8) {
+            uint64_t v;
+            std::memcpy(&v, data + i, sizeof(v));
+            acc += (v & LANE_MASK) + ((v >> 8) & LANE_MASK);
+        }
+        // 4 个 16 位通道相加
+        sum += static_cast<uint32_t>((acc & 0xFFFF) + ((acc >> 16) & 0xFFFF) +
+                                     ((acc >> 32) & 0xFFFF) + (acc >> 48));
+    }
+    for (; i < len; ++i) {
         sum += data[i];
     }
     return static_cast<uint8_t>(sum & 0xFF);
@@ -58,10 +76,25 @@ std::vector<uint8_t> BuildFrame(uint8_t cnt, uint8_t frame_type,
 // FrameParser 实现
 // =============================================================================
 
+void FrameView::CopyTo(ParsedFrame& out) const {
+    out.cnt        = cnt;
+    out.frame_type = frame_type;
+    out.checksum   = checksum;
+    out.valid      = valid;
+    out.payload.assign(payload(), payload() + payload_len());
+}
+
 void FrameParser::FeedData(const uint8_t* data, size_t len) {
-    for (size_t i = 0; i < len; ++i) {
-        buffer_.push_back(data[i]);
+    if (len == 0) {
+        return;
     }
+    // 已消费部分不少于未消费部分时整体前移，避免缓冲区无限增长
+    if (head_ > 0 && head_ >= PendingSize()) {
+        std::memmove(buffer_.data(), Pending(), PendingSize());
+        buffer_.resize(PendingSize());
+        head_ = 0;
+    }
+    buffer_.insert(buffer_.end(), data, data + len);
 }
 
 void FrameParser::FeedData(const std::vector<uint8_t>& data) {
@@ -70,23 +103,34 @@ void FrameParser::FeedData(const std::vector<uint8_t>& data) {
 
 void FrameParser::Reset() {
     buffer_.clear();
+    head_ = 0;
     MYLOG_WARN("帧解析器已重置，缓冲区已清空");
 }
 
 size_t FrameParser::BufferSize() const {
-    return buffer_.size();
+    return PendingSize();
 }
 
 // ---------------------------------------------------------------------------
 // 在缓冲区中搜索帧头 0xEB 0x90，丢弃帧头之前的脏数据
+// 找不到时保留最后 1 字节（可能是下一帧帧头的前半）
 // ---------------------------------------------------------------------------
 bool FrameParser::FindHeader() {
-    while (buffer_.size() >= 2) {
-        if (buffer_[0] == FRAME_HEADER_0 && buffer_[1] == FRAME_HEADER_1) {
+    while (PendingSize() >= 2) {
+        const uint8_t* begin = Pending();
+        // 最后一个字节之后没有第二个帧头字节，只在 [0, size-1) 中搜索
+        const void* hit = std::memchr(begin, FRAME_HEADER_0, PendingSize() - 1);
+        if (hit == nullptr) {
+            head_ = buffer_.size() - 1;
+            return false;
+        }
+        const auto* p = static_cast<const uint8_t*>(hit);
+        head_ += static_cast<size_t>(p - begin);
+        if (p[1] == FRAME_HEADER_1) {
             return true;
         }
-        // 丢弃一个无效字节，继续搜索
-        buffer_.pop_front();
+        // 丢弃这个孤立的 0xEB，继续搜索
+        ++head_;
     }
     return false;
 }
@@ -95,44 +139,31 @@ bool FrameParser::FindHeader() {
 // 根据帧类型确定帧总长度
 // ---------------------------------------------------------------------------
 size_t FrameParser::GetExpectedFrameLen(uint8_t frame_type, uint8_t cmd_byte) const {
+    // 各帧长度均由 FlyControlProtocol.h 中的载荷布局在编译期推导
     switch (frame_type) {
-        case FRAME_TYPE_HEARTBEAT:
-            // 心跳帧固定 89 字节
-            return HEARTBEAT_FRAME_LEN;
-
-        case FRAME_TYPE_SET_DESTINATION:
-            // 帧头(2)+CNT(1)+帧类型(1)+指令(1)+lon(4)+lat(4)+alt(2)+校验(1)+帧尾(2) = 18
-            return 18;
-
-        case FRAME_TYPE_REPLY:
-            // 帧头(2)+CNT(1)+帧类型(1)+回复指令(1)+结果(1)+校验(1)+帧尾(2) = 9
-            return 9;
-
-        case FRAME_TYPE_GIMBAL_CONTROL:
-            // 帧头(2)+CNT(1)+帧类型(1)+使能(1)+俯仰(2)+偏航(2)+校验(1)+帧尾(2) = 12
-            return 12;
+        case FRAME_TYPE_HEARTBEAT:       return HEARTBEAT_FRAME_LEN;
+        case FRAME_TYPE_SET_DESTINATION: return SET_DESTINATION_FRAME_LEN;
+        case FRAME_TYPE_REPLY:           return REPLY_FRAME_LEN;
+        case FRAME_TYPE_GIMBAL_CONTROL:  return GIMBAL_CONTROL_FRAME_LEN;
 
         case FRAME_TYPE_COMMAND: {
             // 指令帧需要根据子指令类型确定长度
-            // 固定部分 = 帧头(2)+CNT(1)+帧类型(1)+指令类型(1) = 5
-            // 再加上指令体+校验(1)+帧尾(2) = +3
-            constexpr size_t CMD_OVERHEAD = 5 + 3; // 帧头CNT帧类型+指令类型 + 校验帧尾
             switch (cmd_byte) {
-                case CMD_SET_ROUTE:    return 0;  // 变长，需要动态计算
-                case CMD_SET_GEOFENCE: return 0;  // 变长，需要动态计算
-                case CMD_SET_ANGLE:    return CMD_OVERHEAD + 4;  // pitch(2)+yaw(2)
-                case CMD_SET_SPEED:    return CMD_OVERHEAD + 2;  // speed(2)
-                case CMD_SET_ALTITUDE: return CMD_OVERHEAD + 3;  // type(1)+alt(2)
-                case CMD_POWER_SWITCH: return CMD_OVERHEAD + 1;  // cmd(1)
-                case CMD_PARACHUTE:    return CMD_OVERHEAD + 1;  // type(1)
-                case CMD_BUTTON:       return CMD_OVERHEAD + 1;  // button(1)
-                case CMD_SET_ORIGIN_RETURN: return CMD_OVERHEAD + 11; // type(1)+lon(4)+lat(4)+alt(2)
-                case CMD_SWITCH_MODE:  return CMD_OVERHEAD + 1;  // mode(1)
-                case CMD_GUIDANCE:     return CMD_OVERHEAD + 19; // mode(1)+frameid(4)+trackid(4)+lon(4)+lat(4)+alt(2)
-                case CMD_GUIDANCE_NEW: return CMD_OVERHEAD + 49; // 很多字段
-                case CMD_GIMBAL_ANG_RATE: return CMD_OVERHEAD + 25; // 6×4+1
-                case CMD_GIMBAL_ANGLE: return CMD_OVERHEAD + 16; // 4×4
-                case CMD_TARGET_STATE: return CMD_OVERHEAD + 11; // 2×4+3
+                case CMD_SET_ROUTE:         return 0;  // 变长，需要动态计算
+                case CMD_SET_GEOFENCE:      return 0;  // 变长，需要动态计算
+                case CMD_SET_ANGLE:         return SET_ANGLE_FRAME_LEN;
+                case CMD_SET_SPEED:         return SET_SPEED_FRAME_LEN;
+                case CMD_SET_ALTITUDE:      return SET_ALTITUDE_FRAME_LEN;
+                case CMD_POWER_SWITCH:
+                case CMD_PARACHUTE:
+                case CMD_BUTTON:
+                case CMD_SWITCH_MODE:       return SINGLE_BYTE_CMD_FRAME_LEN;
+                case CMD_SET_ORIGIN_RETURN: return SET_ORIGIN_RETURN_FRAME_LEN;
+                case CMD_GUIDANCE:          return GUIDANCE_FRAME_LEN;
+                case CMD_GUIDANCE_NEW:      return GUIDANCE_NEW_FRAME_LEN;
+                case CMD_GIMBAL_ANG_RATE:   return GIMBAL_ANG_RATE_FRAME_LEN;
+                case CMD_GIMBAL_ANGLE:      return GIMBAL_ANGLE_FRAME_LEN;
+                case CMD_TARGET_STATE:      return TARGET_STATE_FRAME_LEN;
                 default:
                     return 0;  // 未知指令，无法确定长度
             }
@@ -152,33 +183,41 @@ size_t FrameParser::CalcVariableLenFrameLen(uint8_t frame_type) const {
     }
 
     // 至少需要 6 字节才能读到 指令类型(byte4) 和 点数量(byte5)
-    if (buffer_.size() < 6) {
+    if (PendingSize() < 6) {
         return 0;
     }
 
-    uint8_t cmd_byte = buffer_[4];
-    uint8_t count    = buffer_[5];
-
-    // 帧固定部分 = 帧头(2)+CNT(1)+帧类型(1)+指令类型(1)+点数量(1)+校验(1)+帧尾(2) = 9
-    constexpr size_t VAR_OVERHEAD = 9;
+    const uint8_t* buf = Pending();
+    uint8_t cmd_byte = buf[4];
+    uint8_t count    = buf[5];
 
     if (cmd_byte == CMD_SET_ROUTE) {
-        // 每个航线点: lon(4)+lat(4)+alt(2)+index(2)+speed(2) = 14 字节
-        return VAR_OVERHEAD + static_cast<size_t>(count) * 14;
+        return RouteFrameLen(count);
     }
 
     if (cmd_byte == CMD_SET_GEOFENCE) {
-        // 每个围栏点: lon(4)+lat(4)+alt(2)+index(1) = 11 字节
-        return VAR_OVERHEAD + static_cast<size_t>(count) * 11;
+        return GeofenceFrameLen(count);
     }
 
     return 0;
 }
 
 // ---------------------------------------------------------------------------
-// 尝试从缓冲区中解析出一个完整帧
+// 尝试从缓冲区中解析出一个完整帧（复制载荷）
 // ---------------------------------------------------------------------------
 bool FrameParser::PopFrame(ParsedFrame& frame) {
+    FrameView view;
+    if (!NextFrame(view)) {
+        return false;
+    }
+    view.CopyTo(frame);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 尝试从缓冲区中解析出一个完整帧（零拷贝视图）
+// ---------------------------------------------------------------------------
+bool FrameParser::NextFrame(FrameView& view) {
     while (true) {
         // 步骤1：查找帧头
         if (!FindHeader()) {
@@ -187,16 +226,18 @@ bool FrameParser::PopFrame(ParsedFrame& frame) {
 
         // 步骤2：至少需要 5 字节才能读到帧类型和可能的指令类型
         // 帧头(2) + CNT(1) + 帧类型(1) + 至少1字节载荷或校验
-        if (buffer_.size() < 5) {
+        const size_t avail = PendingSize();
+        if (avail < 5) {
             return false;
         }
 
-        uint8_t frame_type = buffer_[3];
+        const uint8_t* buf = Pending();
+        uint8_t frame_type = buf[3];
         uint8_t cmd_byte   = 0;
 
         // 对于指令帧，第5字节是指令类型
-        if (frame_type == FRAME_TYPE_COMMAND && buffer_.size() >= 5) {
-            cmd_byte = buffer_[4];
+        if (frame_type == FRAME_TYPE_COMMAND) {
+            cmd_byte = buf[4];
         }
 
         // 步骤3：确定帧总长度
@@ -206,55 +247,47 @@ bool FrameParser::PopFrame(ParsedFrame& frame) {
             // 变长帧或未知帧类型，尝试动态计算
             expected_len = CalcVariableLenFrameLen(frame_type);
             if (expected_len == 0) {
-                // 数据不够或未知帧类型
-                if (frame_type != FRAME_TYPE_COMMAND) {
-                    // 未知帧类型，丢弃帧头继续搜索
-                    buffer_.pop_front();
-                    continue;
+                // 航线/围栏指令帧但点数量字节还没到，等待更多数据
+                if (frame_type == FRAME_TYPE_COMMAND && avail < 6 &&
+                    (cmd_byte == CMD_SET_ROUTE || cmd_byte == CMD_SET_GEOFENCE)) {
+                    return false;
                 }
-                // 指令帧但数据不够，等待更多数据
-                return false;
+                // 未知帧类型或未知指令类型（多为截断帧后的伪帧头），丢弃帧头继续搜索；
+                // 否则解析器会一直停在这里等待永远凑不齐的数据
+                ++head_;
+                continue;
             }
         }
 
         // 步骤4：检查缓冲区长度是否足够
-        if (buffer_.size() < expected_len) {
+        if (avail < expected_len) {
             return false;  // 数据不够，等待更多数据
         }
 
         // 步骤5：校验帧尾
-        if (buffer_[expected_len - 2] != FRAME_TAIL_0 ||
-            buffer_[expected_len - 1] != FRAME_TAIL_1) {
+        if (buf[expected_len - 2] != FRAME_TAIL_0 ||
+            buf[expected_len - 1] != FRAME_TAIL_1) {
             // 帧尾不匹配，当前帧头无效，丢弃继续搜索
-            buffer_.pop_front();
+            ++head_;
             continue;
         }
 
         // 步骤6：校验和验证
-        // 校验和位置 = expected_len - 3（帧尾2字节之前1字节）
+        // 校验和位置 = expected_len - 3（帧尾2字节之前1字节），缓冲区连续，直接原地计算
         size_t chk_pos = expected_len - 3;
-        uint8_t received_chk = buffer_[chk_pos];
-
-        // 将缓冲区前 chk_pos 字节复制出来计算校验和
-        std::vector<uint8_t> raw(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(chk_pos));
-        uint8_t calc_chk = CalcChecksum(raw.data(), raw.size());
-
-        // 步骤7：组装 ParsedFrame
-        frame.cnt        = buffer_[2];
-        frame.frame_type = buffer_[3];
-        frame.checksum   = received_chk;
-        frame.valid      = (calc_chk == received_chk);
-
-        // 载荷 = 帧头(2)+CNT(1)+帧类型(1) 之后，到校验和之前
-        size_t payload_start = 4;
-        size_t payload_len   = chk_pos - payload_start;
-        frame.payload.assign(buffer_.begin() + static_cast<std::ptrdiff_t>(payload_start),
-                             buffer_.begin() + static_cast<std::ptrdiff_t>(payload_start + payload_len));
-
-        // 步骤8：从缓冲区中移除已解析的帧
-        for (size_t i = 0; i < expected_len; ++i) {
-            buffer_.pop_front();
-        }
+        uint8_t received_chk = buf[chk_pos];
+        uint8_t calc_chk = CalcChecksum(buf, chk_pos);
+
+        // 步骤7：填充帧视图
+        view.data       = buf;
+        view.len        = expected_len;
+        view.cnt        = buf[2];
+        view.frame_type = frame_type;
+        view.checksum   = received_chk;
+        view.valid      = (calc_chk == received_chk);
+
+        // 步骤8：移动读偏移（数据留在缓冲区，直到下一次 FeedData 才可能被搬移）
+        head_ += expected_len;
 
         return true;
     }
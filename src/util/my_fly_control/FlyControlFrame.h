@@ -2,7 +2,6 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <deque>
 #include <vector>
 
 #include "FlyControlProtocol.h"
@@ -14,7 +13,8 @@
 //   1. BuildFrame    - 将载荷数据组装成完整帧（添加帧头、CNT、帧类型、校验和、帧尾）
 //   2. CalcChecksum  - 计算校验和（所有字节求和取低8位）
 //   3. FeedData      - 向帧解析器喂入字节流
-//   4. PopFrame      - 从解析器中取出一个完整且校验通过的帧
+//   4. PopFrame      - 从解析器中取出一个完整帧（复制载荷）
+//      NextFrame     - 取出一个完整帧的视图（零拷贝，指向解析器内部缓冲区）
 //   5. Reset         - 重置帧解析器状态
 // =============================================================================
 
@@ -32,8 +32,32 @@ uint8_t CalcChecksum(const uint8_t* data, size_t len);
 std::vector<uint8_t> BuildFrame(uint8_t cnt, uint8_t frame_type,
                                 const std::vector<uint8_t>& payload);
 
+// ---------------------------------------------------------------------------
+// 帧视图：指向 FrameParser 内部缓冲区的一段完整帧，不持有数据
+// 有效期：直到下一次 FeedData / Reset 调用（NextFrame / PopFrame 不会搬移数据）
+// ---------------------------------------------------------------------------
+struct FrameView {
+    const uint8_t* data       = nullptr;  // 完整帧起始（帧头第一个字节）
+    size_t         len        = 0;        // 完整帧长度（含帧头帧尾）
+    uint8_t        cnt        = 0;
+    uint8_t        frame_type = 0;
+    uint8_t        checksum   = 0;        // 收到的校验和
+    bool           valid      = false;    // 校验是否通过
+
+    // 载荷 = 帧头(2)+CNT(1)+帧类型(1) 之后，到校验和之前
+    const uint8_t* payload() const { return data + FRAME_PAYLOAD_OFFSET; }
+    size_t payload_len() const { return len - FRAME_PAYLOAD_OFFSET - FRAME_CHECKSUM_LEN - FRAME_TAIL_LEN; }
+
+    // 按需复制成 ParsedFrame；复用 out.payload 已有容量
+    void CopyTo(ParsedFrame& out) const;
+};
+
 // ---------------------------------------------------------------------------
 // 帧解析器：从连续字节流中拆出完整帧
+//
+// 缓冲区为连续内存 + 读偏移：
+//   - 丢弃脏数据只移动读偏移，帧头重同步用 memchr 扫描
+//   - 已消费部分不少于未消费部分时才整体前移，搬移开销均摊 O(1)
 // ---------------------------------------------------------------------------
 class FrameParser {
 public:
@@ -43,9 +67,12 @@ public:
     void FeedData(const uint8_t* data, size_t len);
     void FeedData(const std::vector<uint8_t>& data);
 
-    // 尝试取出一个完整帧，成功返回 true 并填充 frame
+    // 尝试取出一个完整帧，成功返回 true 并填充 frame（载荷复制到 frame.payload）
     bool PopFrame(ParsedFrame& frame);
 
+    // 尝试取出一个完整帧，成功返回 true，view 指向内部缓冲区（不复制）
+    bool NextFrame(FrameView& view);
+
     // 重置解析器内部状态
     void Reset();
 
@@ -65,7 +92,12 @@ private:
     // 返回 0 表示数据不够无法确定
     size_t CalcVariableLenFrameLen(uint8_t frame_type) const;
 
-    std::deque<uint8_t> buffer_;   // 接收缓冲区
+    // 未消费数据起始指针与长度
+    const uint8_t* Pending() const { return buffer_.data() + head_; }
+    size_t PendingSize() const { return buffer_.size() - head_; }
+
+    std::vector<uint8_t> buffer_;   // 接收缓冲区，[head_, size) 为未消费数据
+    size_t               head_ = 0; // 读偏移
 };
 
 } // namespace fly_control
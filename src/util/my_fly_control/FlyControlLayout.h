@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// =============================================================================
+// 编译期帧载荷布局描述
+//
+// 用 PayloadLayout<字节序, 字段类型...> 按协议顺序描述一个载荷：
+//   - SIZE / Offset<I>() / FieldType<I> 全部在编译期求出
+//   - StoreFields / LoadFields 按固定偏移读写，字段个数与类型不匹配时编译失败
+//   - 不依赖 std::vector，可直接写入调用方提供的 std::array 或帧缓冲区
+//
+// 示例：
+//   using SpeedLayout = PayloadLayout<ByteOrder::Little, uint8_t, uint16_t>;
+//   static_assert(SpeedLayout::SIZE == 3);
+//   StoreFields<SpeedLayout>(payload, cmd_type, speed);
+// =============================================================================
+
+namespace fly_control {
+
+enum class ByteOrder {
+    Little,
+    Big,
+};
+
+template <ByteOrder Order, typename... Fields>
+struct PayloadLayout {
+    static_assert(sizeof...(Fields) > 0, "payload layout must have at least one field");
+    static_assert((std::is_integral_v<Fields> && ...), "payload fields must be integral types");
+
+    static constexpr ByteOrder ORDER = Order;
+    static constexpr size_t    COUNT = sizeof...(Fields);
+    static constexpr size_t    SIZE  = (sizeof(Fields) + ...);
+
+    template <size_t I>
+    using FieldType = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    // 第 I 个字段相对载荷起始的偏移；I == COUNT 时等于 SIZE
+    template <size_t I>
+    static constexpr size_t Offset() {
+        static_assert(I <= COUNT, "field index out of range");
+        constexpr size_t sizes[] = {sizeof(Fields)...};
+        size_t off = 0;
+        for (size_t i = 0; i < I; ++i) {
+            off += sizes[i];
+        }
+        return off;
+    }
+};
+
+// 按字节序写入一个整数（编译器会把小端路径合并为一次存储）
+template <ByteOrder Order, typename T>
+inline void StoreScalar(uint8_t* dst, T value) {
+    using U = std::make_unsigned_t<T>;
+    const U v = static_cast<U>(value);
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        const size_t shift = (Order == ByteOrder::Little) ? i : (sizeof(T) - 1 - i);
+        dst[i] = static_cast<uint8_t>(v >> (8 * shift));
+    }
+}
+
+// 按字节序读取一个整数
+template <ByteOrder Order, typename T>
+inline T LoadScalar(const uint8_t* src) {
+    using U = std::make_unsigned_t<T>;
+    U v = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        const size_t shift = (Order == ByteOrder::Little) ? i : (sizeof(T) - 1 - i);
+        v = static_cast<U>(v | (static_cast<U>(src[i]) << (8 * shift)));
+    }
+    return static_cast<T>(v);
+}
+
+namespace layout_detail {
+
+template <typename Layout, typename... Args, size_t... Is>
+inline void StoreFieldsImpl(uint8_t* payload, std::index_sequence<Is...>, const Args&... values) {
+    static_assert((std::is_same_v<Args, typename Layout::template FieldType<Is>> && ...),
+                  "field type does not match payload layout");
+    (StoreScalar<Layout::ORDER>(payload + Layout::template Offset<Is>(), values), ...);
+}
+
+template <typename Layout, typename... Args, size_t... Is>
+inline void LoadFieldsImpl(const uint8_t* payload, std::index_sequence<Is...>, Args&... values) {
+    static_assert((std::is_same_v<Args, typename Layout::template FieldType<Is>> && ...),
+                  "field type does not match payload layout");
+    ((values = LoadScalar<Layout::ORDER, Args>(payload + Layout::template Offset<Is>())), ...);
+}
+
+} // namespace layout_detail
+
+// 按布局顺序写入全部字段；payload 至少 Layout::SIZE 字节
+template <typename Layout, typename... Args>
+inline void StoreFields(uint8_t* payload, const Args&... values) {
+    static_assert(sizeof...(Args) == Layout::COUNT, "field count does not match payload layout");
+    layout_detail::StoreFieldsImpl<Layout>(payload, std::index_sequence_for<Args...>{}, values...);
+}
+
+// 按布局顺序读出全部字段；payload 至少 Layout::SIZE 字节
+template <typename Layout, typename... Args>
+inline void LoadFields(const uint8_t* payload, Args&... values) {
+    static_assert(sizeof...(Args) == Layout::COUNT, "field count does not match payload layout");
+    layout_detail::LoadFieldsImpl<Layout>(payload, std::index_sequence_for<Args...>{}, values...);
+}
+
+} // namespace fly_control
@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 
+#include "FlyControlLayout.h"
+
 // =============================================================================
 // 飞控通信协议定义
 // 参考文档：域控飞控通信协议v1.0_20260313.md
@@ -22,6 +24,12 @@ constexpr uint8_t  FRAME_TAIL_1     = 0xDE;   // 帧尾第二字节
 constexpr size_t   FRAME_HEADER_LEN = 2;      // 帧头长度
 constexpr size_t   FRAME_TAIL_LEN   = 2;      // 帧尾长度
 constexpr size_t   FRAME_CHECKSUM_LEN = 1;    // 校验和长度
+constexpr size_t   FRAME_PAYLOAD_OFFSET = FRAME_HEADER_LEN + 2;  // 载荷起始：帧头(2)+CNT(1)+帧类型(1)
+
+// 载荷长度 -> 完整帧长度
+constexpr size_t FrameLenOf(size_t payload_len) {
+    return FRAME_PAYLOAD_OFFSET + payload_len + FRAME_CHECKSUM_LEN + FRAME_TAIL_LEN;
+}
 
 // ---------------------------------------------------------------------------
 // 帧类型定义
@@ -53,9 +61,85 @@ constexpr uint8_t  CMD_GIMBAL_ANGLE      = 0x10;   // 吊舱姿态-角度模式
 constexpr uint8_t  CMD_TARGET_STATE      = 0x11;   // 识别目标状态
 
 // ---------------------------------------------------------------------------
-// 心跳帧固定长度（帧头到帧尾共 89 字节）
+// 载荷布局（编译期描述，所有多字节字段小端）
+// 字段类型与下方协议数据结构一一对应，编解码按这里的固定偏移读写
+// ---------------------------------------------------------------------------
+using HeartbeatLayout = PayloadLayout<ByteOrder::Little,
+    uint8_t,  uint8_t,  uint8_t,                      // 飞机ID、运行模式、定位星数
+    int32_t,  int32_t,                                // 经度、纬度
+    uint16_t, uint16_t, uint16_t, uint16_t,           // 海拔高度、相对高度、空速、地速
+    int16_t,  int16_t,  int16_t,                      // 飞行速度 xyz
+    int16_t,  int16_t,  int16_t,                      // 加速度 xyz
+    int16_t,  int16_t,  uint16_t,                     // 横滚、俯仰、偏航
+    uint8_t,  uint16_t, uint16_t, uint8_t,            // 飞行模式、当前航迹点、电池电压、电量
+    uint16_t, uint16_t, uint64_t,                     // 电池电流、大气压强、UTC时间戳
+    uint16_t, uint16_t, uint16_t, uint16_t, uint16_t, // 故障信息、转速、油门、目标高度、目标速度
+    uint16_t, uint16_t, uint16_t,                     // 原点距离、原点航向、目标距离
+    uint8_t,  uint8_t,  uint8_t,                      // 飞行状态、高度状态、状态切换源
+    uint16_t, uint16_t, uint32_t>;                    // 航时、航程、备用
+
+using GimbalControlLayout   = PayloadLayout<ByteOrder::Little, uint8_t, int16_t, int16_t>;  // 使能、俯仰、偏航
+using CommandReplyLayout    = PayloadLayout<ByteOrder::Little, uint8_t, uint8_t>;           // 回复指令、结果
+using SetDestinationLayout  = PayloadLayout<ByteOrder::Little, uint8_t, int32_t, int32_t, uint16_t>;
+using SetAngleLayout        = PayloadLayout<ByteOrder::Little, uint8_t, int16_t, uint16_t>;
+using SetSpeedLayout        = PayloadLayout<ByteOrder::Little, uint8_t, uint16_t>;
+using SetAltitudeLayout     = PayloadLayout<ByteOrder::Little, uint8_t, uint8_t, uint16_t>;
+using SingleByteCmdLayout   = PayloadLayout<ByteOrder::Little, uint8_t, uint8_t>;           // 电源/开伞/按钮/切换模式
+using SetOriginReturnLayout = PayloadLayout<ByteOrder::Little, uint8_t, uint8_t, int32_t, int32_t, uint16_t>;
+using GuidanceLayout        = PayloadLayout<ByteOrder::Little,
+    uint8_t, uint8_t, uint32_t, uint32_t, int32_t, int32_t, uint16_t>;
+using GuidanceNewLayout     = PayloadLayout<ByteOrder::Little,
+    uint8_t,                                          // 指令类型
+    int16_t, int16_t, int16_t, int16_t,               // 视线角速率 俯仰/偏航、视线角度 俯仰/偏航
+    int16_t, int16_t, int16_t, int16_t,               // 框架角 俯仰/偏航、吊舱角 俯仰/偏航
+    int16_t, int16_t, int16_t,                        // Acc xyz
+    int16_t, int16_t, int16_t,                        // Gyro xyz
+    uint16_t, uint16_t,                               // 目标ID、目标类型
+    int32_t, int32_t, int32_t, int32_t,               // 目标经纬高、激光测距
+    uint8_t>;                                         // 状态
+using GimbalAngRateLayout   = PayloadLayout<ByteOrder::Little,
+    uint8_t, int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, uint8_t>;
+using GimbalAngleLayout     = PayloadLayout<ByteOrder::Little, uint8_t, int32_t, int32_t, int32_t, int32_t>;
+using TargetStateLayout     = PayloadLayout<ByteOrder::Little, uint8_t, int32_t, int32_t, uint8_t, uint8_t, uint8_t>;
+
+// 变长帧（航线/围栏）：指令类型 + 点数量，后接 N 个点
+using PointListHeaderLayout = PayloadLayout<ByteOrder::Little, uint8_t, uint8_t>;
+using RoutePointLayout      = PayloadLayout<ByteOrder::Little, int32_t, int32_t, uint16_t, uint16_t, uint16_t>;
+using GeofencePointLayout   = PayloadLayout<ByteOrder::Little, int32_t, int32_t, uint16_t, uint8_t>;
+
+// ---------------------------------------------------------------------------
+// 定长帧总长度（帧头到帧尾），由布局推导
 // ---------------------------------------------------------------------------
-constexpr size_t   HEARTBEAT_FRAME_LEN = 89;
+constexpr size_t   HEARTBEAT_FRAME_LEN         = FrameLenOf(HeartbeatLayout::SIZE);
+constexpr size_t   GIMBAL_CONTROL_FRAME_LEN    = FrameLenOf(GimbalControlLayout::SIZE);
+constexpr size_t   REPLY_FRAME_LEN             = FrameLenOf(CommandReplyLayout::SIZE);
+constexpr size_t   SET_DESTINATION_FRAME_LEN   = FrameLenOf(SetDestinationLayout::SIZE);
+constexpr size_t   SET_ANGLE_FRAME_LEN         = FrameLenOf(SetAngleLayout::SIZE);
+constexpr size_t   SET_SPEED_FRAME_LEN         = FrameLenOf(SetSpeedLayout::SIZE);
+constexpr size_t   SET_ALTITUDE_FRAME_LEN      = FrameLenOf(SetAltitudeLayout::SIZE);
+constexpr size_t   SINGLE_BYTE_CMD_FRAME_LEN   = FrameLenOf(SingleByteCmdLayout::SIZE);
+constexpr size_t   SET_ORIGIN_RETURN_FRAME_LEN = FrameLenOf(SetOriginReturnLayout::SIZE);
+constexpr size_t   GUIDANCE_FRAME_LEN          = FrameLenOf(GuidanceLayout::SIZE);
+constexpr size_t   GUIDANCE_NEW_FRAME_LEN      = FrameLenOf(GuidanceNewLayout::SIZE);
+constexpr size_t   GIMBAL_ANG_RATE_FRAME_LEN   = FrameLenOf(GimbalAngRateLayout::SIZE);
+constexpr size_t   GIMBAL_ANGLE_FRAME_LEN      = FrameLenOf(GimbalAngleLayout::SIZE);
+constexpr size_t   TARGET_STATE_FRAME_LEN      = FrameLenOf(TargetStateLayout::SIZE);
+
+// 变长帧总长度 = 固定部分 + 点数量 × 单点长度
+constexpr size_t RouteFrameLen(size_t point_count) {
+    return FrameLenOf(PointListHeaderLayout::SIZE + point_count * RoutePointLayout::SIZE);
+}
+constexpr size_t GeofenceFrameLen(size_t point_count) {
+    return FrameLenOf(PointListHeaderLayout::SIZE + point_count * GeofencePointLayout::SIZE);
+}
+
+// 与协议文档核对
+static_assert(HEARTBEAT_FRAME_LEN == 89, "心跳帧应为 89 字节");
+static_assert(SET_DESTINATION_FRAME_LEN == 18, "设置目的地帧应为 18 字节");
+static_assert(REPLY_FRAME_LEN == 9, "回复帧应为 9 字节");
+static_assert(GIMBAL_CONTROL_FRAME_LEN == 12, "云台控制帧应为 12 字节");
+static_assert(GUIDANCE_NEW_FRAME_LEN == 57, "末制导(新版)帧应为 57 字节");
+static_assert(RoutePointLayout::SIZE == 14 && GeofencePointLayout::SIZE == 11, "航线点 14 字节，围栏点 11 字节");
 
 // ---------------------------------------------------------------------------
 // 运行模式枚举
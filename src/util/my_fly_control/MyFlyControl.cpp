@@ -14,15 +14,15 @@ namespace fly_control {
 
 namespace {
 
-std::string BytesToHexString(const std::vector<uint8_t>& data, size_t max_bytes = 96) {
-    if (data.empty()) {
+std::string BytesToHexString(const uint8_t* data, size_t size, size_t max_bytes = 96) {
+    if (size == 0) {
         return "<empty>";
     }
 
     std::ostringstream oss;
     oss << std::hex << std::uppercase << std::setfill('0');
 
-    const size_t limit = std::min(data.size(), max_bytes);
+    const size_t limit = std::min(size, max_bytes);
     for (size_t i = 0; i < limit; ++i) {
         if (i != 0) {
             oss << ' ';
@@ -30,13 +30,22 @@ std::string BytesToHexString(const std::vector<uint8_t>& data, size_t max_bytes
         oss << std::setw(2) << static_cast<int>(data[i]);
     }
 
-    if (data.size() > limit) {
-        oss << " ...( +" << (data.size() - limit) << " bytes)";
+    if (size > limit) {
+        oss << " ...( +" << (size - limit) << " bytes)";
     }
 
     return oss.str();
 }
 
+std::string BytesToHexString(const std::vector<uint8_t>& data, size_t max_bytes = 96) {
+    return BytesToHexString(data.data(), data.size(), max_bytes);
+}
+
+// 收发热路径上的十六进制转储只在 debug 级别开启时生成，避免每次收发都逐字节格式化
+bool HexDumpEnabled() {
+    return spdlog::should_log(spdlog::level::debug);
+}
+
 void LogSerialSnapshot(const std::string& prefix,
                        const my_serial::SerialPortSnapshot& snapshot) {
     MYLOG_INFO(
@@ -75,6 +84,23 @@ bool MyFlyControl::Init(const nlohmann::json& cfg, std::string* err) {
         return false;
     }
     LogSerialSnapshot("飞控模块串口初始化成功，串口快照:", serial_.GetSnapshot());
+
+    // 可选的原始字节录制
+    capture_configured_ = false;
+    if (cfg.contains("capture") && cfg["capture"].is_object() && cfg["capture"].value("enabled", false)) {
+        CaptureWriter::Options options;
+        options.prefix = cfg.value("id", options.prefix);
+        std::string capture_err;
+        if (!CaptureWriter::ParseOptions(cfg["capture"], options, &capture_err)) {
+            if (err) *err = capture_err;
+            MYLOG_ERROR("飞控抓包配置无效: {}", capture_err);
+            return false;
+        }
+        capture_options_    = options;
+        capture_configured_ = true;
+        MYLOG_INFO("飞控抓包已配置: dir={}, segment_size={}, max_segments={}",
+                   options.dir, options.segment_size, options.max_segments);
+    }
     return true;
 }
 
@@ -101,9 +127,23 @@ bool MyFlyControl::Start(std::string* err) {
     parser_.Reset();
     MYLOG_INFO("飞控模块帧解析器已重置");
 
-    // 启动接收线程
+    // 录制失败不影响飞控链路，只记录错误
+    if (capture_configured_) {
+        std::string capture_err;
+        if (capture_.Open(capture_options_, &capture_err)) {
+            capture_enabled_.store(true);
+        } else {
+            MYLOG_ERROR("飞控抓包打开失败，本次不录制: {}", capture_err);
+        }
+    }
+
+    // 启动接收线程：串口配置 read_mode=event 时走就绪驱动接收
     running_.store(true);
-    recv_thread_ = std::make_unique<std::thread>(&MyFlyControl::ReceiveLoop, this);
+    if (serial_.IsEventDriven()) {
+        recv_thread_ = std::make_unique<std::thread>(&MyFlyControl::ReceiveLoopEvent, this);
+    } else {
+        recv_thread_ = std::make_unique<std::thread>(&MyFlyControl::ReceiveLoop, this);
+    }
 
     MYLOG_INFO("飞控模块已启动");
     return true;
@@ -115,6 +155,8 @@ void MyFlyControl::Stop() {
     }
 
     running_.store(false);
+    // event 模式下接收线程阻塞在 poll 上，需要主动唤醒
+    serial_.InterruptWait();
 
     // 等待接收线程退出
     if (recv_thread_ && recv_thread_->joinable()) {
@@ -122,6 +164,11 @@ void MyFlyControl::Stop() {
     }
     recv_thread_.reset();
 
+    if (capture_enabled_.exchange(false)) {
+        MYLOG_INFO("飞控抓包已关闭: {}", capture_.GetStats().dump());
+        capture_.Close();
+    }
+
     serial_.Close();
     MYLOG_INFO("飞控模块已停止");
 }
@@ -130,6 +177,125 @@ bool MyFlyControl::IsRunning() const {
     return running_.load();
 }
 
+// =============================================================================
+// 抓包录制与回放
+// =============================================================================
+
+nlohmann::json ReplayStats::ToJson() const {
+    nlohmann::json j;
+    j["files"]          = files;
+    j["records"]        = records;
+    j["tx_records"]     = tx_records;
+    j["rx_bytes"]       = rx_bytes;
+    j["frames"]         = frames;
+    j["invalid_frames"] = invalid_frames;
+    j["elapsed_s"]      = elapsed_s;
+    j["frames_per_sec"] = frames_per_sec;
+    j["mbytes_per_sec"] = mbytes_per_sec;
+    j["handler_p50_ns"] = handler_p50_ns;
+    j["handler_p99_ns"] = handler_p99_ns;
+    j["handler_max_ns"] = handler_max_ns;
+    return j;
+}
+
+nlohmann::json MyFlyControl::GetCaptureStats() const {
+    return capture_.GetStats();
+}
+
+bool MyFlyControl::ReplayCapture(const std::string& path, const ReplayOptions& options,
+                                 ReplayStats* stats, std::string* err) {
+    if (running_.load()) {
+        if (err) *err = "飞控模块运行中，不能回放抓包";
+        return false;
+    }
+    const auto files = CaptureReader::ListCaptureFiles(path, err);
+    if (files.empty()) {
+        return false;
+    }
+
+    MYLOG_INFO("飞控抓包回放开始: path={}, files={}, realtime={}", path, files.size(), options.realtime);
+    parser_.Reset();
+
+    ReplayStats result;
+    std::vector<int64_t> handler_ns;
+    CaptureReader reader;
+    CaptureRecordView rec;
+    FrameView frame;
+
+    // 原速回放：以每次录制的第一条记录为基准，按录制时间差对齐到当前 steady_clock
+    // 不同录制（进程）的 steady_clock 互不相关，遇到新录制的首个分段或时间倒退时重新取基准，
+    // 录制之间的间隔不回放
+    bool has_base = false;
+    int64_t base_record_ns = 0;
+    int64_t last_record_ns = 0;
+    std::chrono::steady_clock::time_point base_time;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& file : files) {
+        if (!reader.Open(file, err)) {
+            return false;
+        }
+        ++result.files;
+        if (reader.Header().segment_index == 0) {
+            has_base = false;
+        }
+        while (reader.Next(rec)) {
+            if (rec.direction != CaptureDirection::Rx) {
+                ++result.tx_records;
+                continue;
+            }
+            if (options.realtime) {
+                if (!has_base || rec.mono_ns < last_record_ns) {
+                    has_base = true;
+                    base_record_ns = rec.mono_ns;
+                    base_time = std::chrono::steady_clock::now();
+                } else {
+                    std::this_thread::sleep_until(base_time + std::chrono::nanoseconds(rec.mono_ns - base_record_ns));
+                }
+                last_record_ns = rec.mono_ns;
+            }
+            ++result.records;
+            result.rx_bytes += rec.len;
+
+            parser_.FeedData(rec.data, rec.len);
+            while (parser_.NextFrame(frame)) {
+                ++result.frames;
+                if (!frame.valid) {
+                    ++result.invalid_frames;
+                    continue;
+                }
+                const auto t0 = std::chrono::steady_clock::now();
+                HandleFrame(frame);
+                handler_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - t0).count());
+            }
+        }
+        reader.Close();
+    }
+
+    result.elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (result.elapsed_s > 0.0) {
+        result.frames_per_sec = static_cast<double>(result.frames) / result.elapsed_s;
+        result.mbytes_per_sec = static_cast<double>(result.rx_bytes) / (1024.0 * 1024.0) / result.elapsed_s;
+    }
+    if (!handler_ns.empty()) {
+        std::sort(handler_ns.begin(), handler_ns.end());
+        const auto pct = [&handler_ns](double q) {
+            return handler_ns[std::min(handler_ns.size() - 1, static_cast<size_t>(q * handler_ns.size()))];
+        };
+        result.handler_p50_ns = pct(0.5);
+        result.handler_p99_ns = pct(0.99);
+        result.handler_max_ns = handler_ns.back();
+    }
+    parser_.Reset();
+
+    MYLOG_INFO("飞控抓包回放完成: {}", result.ToJson().dump());
+    if (stats != nullptr) {
+        *stats = result;
+    }
+    return true;
+}
+
 // =============================================================================
 // 回调注册
 // =============================================================================
@@ -183,9 +349,10 @@ bool MyFlyControl::SendSetDestination(int32_t lon, int32_t lat, uint16_t alt,
     data.longitude = lon;
     data.latitude  = lat;
     data.altitude  = alt;
-    auto frame = EncodeSetDestination(NextCnt(), data);
+    SetDestinationFrame frame;
+    EncodeSetDestination(NextCnt(), data, frame);
     MYLOG_INFO("发送指令: 设置飞行目的地");
-    return SendRawData(frame, err);
+    return SendRawData(frame.data(), frame.size(), err);
 }
 
 bool MyFlyControl::SendSetRoute(const std::vector<RoutePoint>& points,
@@ -205,17 +372,19 @@ bool MyFlyControl::SendSetAngle(int16_t pitch, uint16_t yaw, std::string* err) {
     SetAngleData data;
     data.pitch = pitch;
     data.yaw   = yaw;
-    auto frame = EncodeSetAngle(NextCnt(), data);
+    SetAngleFrame frame;
+    EncodeSetAngle(NextCnt(), data, frame);
     MYLOG_INFO("发送指令: 角度控制");
-    return SendRawData(frame, err);
+    return SendRawData(frame.data(), frame.size(), err);
 }
 
 bool MyFlyControl::SendSetSpeed(uint16_t speed, std::string* err) {
     SetSpeedData data;
     data.speed = speed;
-    auto frame = EncodeSetSpeed(NextCnt(), data);
+    SetSpeedFrame frame;
+    EncodeSetSpeed(NextCnt(), data, frame);
     MYLOG_INFO("发送指令: 速度控制, speed={}", speed);
-    return SendRawData(frame, err);
+    return SendRawData(frame.data(), frame.size(), err);
 }
 
 bool MyFlyControl::SendSetAltitude(uint8_t alt_type, uint16_t altitude,
@@ -223,33 +392,37 @@ bool MyFlyControl::SendSetAltitude(uint8_t alt_type, uint16_t altitude,
     SetAltitudeData data;
     data.altitude_type = alt_type;
     data.altitude      = altitude;
-    auto frame = EncodeSetAltitude(NextCnt(), data);
+    SetAltitudeFrame frame;
+    EncodeSetAltitude(NextCnt(), data, frame);
     MYLOG_INFO("发送指令: 高度控制");
-    return SendRawData(frame, err);
+    return SendRawData(frame.data(), frame.size(), err);
 }
 
 bool MyFlyControl::SendPowerSwitch(uint8_t command, std::string* err) {
     PowerSwitchData data;
     data.command = command;
-    auto frame = EncodePowerSwitch(NextCnt(), data);
+    SingleByteCmdFrame frame;
+    EncodePowerSwitch(NextCnt(), data, frame);
     MYLOG_INFO("发送指令: 电源开关, cmd=0x{:02X}", command);
-    return SendRawData(frame, err);
+    return SendRawData(frame.data(), frame.size(), err);
 }
 
 bool MyFlyControl::SendParachute(uint8_t parachute_type, std::string* err) {
     ParachuteData data;
     data.parachute_type = parachute_type;
-    auto frame = EncodeParachute(NextCnt(), data);
+    SingleByteCmdFrame frame;
+    EncodeParachute(NextCnt(), data, frame);
     MYLOG_INFO("发送指令: 开伞控制, type=0x{:02X}", parachute_type);
-    return SendRawData(frame, err);
+    return SendRawData(frame.data(), frame.size(), err);
 }
 
 bool MyFlyControl::SendButtonCommand(uint8_t button, std::string* err) {
     ButtonCommandData data;
     data.button = button;
-    auto frame = EncodeButtonCommand(NextCnt(), data);
+    SingleByteCmdFrame frame;
+    EncodeButtonCommand(NextCnt(), data, frame);
     MYLOG_INFO("发送指令: 指令按钮=0x{:02X}", button);
-    return SendRawData(frame, err);
+    return SendRawData(frame.data(), frame.size(), err);
 }
 
 bool MyFlyControl::SendSetOriginReturn(uint8_t point_type, int32_t lon,
@@ -260,9 +433,10 @@ bool MyFlyControl::SendSetOriginReturn(uint8_t point_type, int32_t lon,
     data.longitude  = lon;
     data.latitude   = lat;
     data.altitude   = alt;
-    auto frame = EncodeSetOriginReturn(NextCnt(), data);
+    SetOriginReturnFrame frame;
+    EncodeSetOriginReturn(NextCnt(), data, frame);
     MYLOG_INFO("发送指令: 设置{}", point_type == 0 ? "原点" : "返航点");
-    return SendRawData(frame, err);
+    return SendRawData(frame.data(), frame.size(), err);
 }
 
 bool MyFlyControl::SendSetGeofence(const std::vector<GeofencePoint>& points,
@@ -281,39 +455,45 @@ bool MyFlyControl::SendSetGeofence(const std::vector<GeofencePoint>& points,
 bool MyFlyControl::SendSwitchMode(uint8_t mode, std::string* err) {
     SwitchModeData data;
     data.mode = mode;
-    auto frame = EncodeSwitchMode(NextCnt(), data);
+    SingleByteCmdFrame frame;
+    EncodeSwitchMode(NextCnt(), data, frame);
     MYLOG_INFO("发送指令: 切换运行模式=0x{:02X}", mode);
-    return SendRawData(frame, err);
+    return SendRawData(frame.data(), frame.size(), err);
 }
 
 bool MyFlyControl::SendGuidance(const GuidanceData& data, std::string* err) {
-    auto frame = EncodeGuidance(NextCnt(), data);
+    GuidanceFrame frame;
+    EncodeGuidance(NextCnt(), data, frame);
     MYLOG_INFO("发送指令: 末制导指令");
-    return SendRawData(frame, err);
+    return SendRawData(frame.data(), frame.size(), err);
 }
 
 bool MyFlyControl::SendGuidanceNew(const GuidanceNewData& data, std::string* err) {
-    auto frame = EncodeGuidanceNew(NextCnt(), data);
+    GuidanceNewFrame frame;
+    EncodeGuidanceNew(NextCnt(), data, frame);
     MYLOG_INFO("发送指令: 末制导指令(新版)");
-    return SendRawData(frame, err);
+    return SendRawData(frame.data(), frame.size(), err);
 }
 
 bool MyFlyControl::SendGimbalAngRate(const GimbalAngRateData& data, std::string* err) {
-    auto frame = EncodeGimbalAngRate(NextCnt(), data);
+    GimbalAngRateFrame frame;
+    EncodeGimbalAngRate(NextCnt(), data, frame);
     MYLOG_INFO("发送指令: 吊舱姿态-角速度模式");
-    return SendRawData(frame, err);
+    return SendRawData(frame.data(), frame.size(), err);
 }
 
 bool MyFlyControl::SendGimbalAngle(const GimbalAngleData& data, std::string* err) {
-    auto frame = EncodeGimbalAngle(NextCnt(), data);
+    GimbalAngleFrame frame;
+    EncodeGimbalAngle(NextCnt(), data, frame);
     MYLOG_INFO("发送指令: 吊舱姿态-角度模式");
-    return SendRawData(frame, err);
+    return SendRawData(frame.data(), frame.size(), err);
 }
 
 bool MyFlyControl::SendTargetState(const TargetStateData& data, std::string* err) {
-    auto frame = EncodeTargetState(NextCnt(), data);
+    TargetStateFrame frame;
+    EncodeTargetState(NextCnt(), data, frame);
     MYLOG_INFO("发送指令: 识别目标状态");
-    return SendRawData(frame, err);
+    return SendRawData(frame.data(), frame.size(), err);
 }
 
 // =============================================================================
@@ -321,7 +501,7 @@ bool MyFlyControl::SendTargetState(const TargetStateData& data, std::string* err
 // =============================================================================
 
 void MyFlyControl::ReceiveLoop() {
-    LogSerialSnapshot("飞控接收线程启动，当前串口状态:", serial_.GetSnapshot());
+    LogSerialSnapshot("飞控接收线程启动（blocking 模式），当前串口状态:", serial_.GetSnapshot());
     constexpr size_t READ_BUF_SIZE = 256;
     size_t read_count = 0;
     size_t empty_read_count = 0;
@@ -359,53 +539,59 @@ void MyFlyControl::ReceiveLoop() {
         empty_read_count = 0;
         total_bytes += bytes.size();
 
-        const size_t parser_buffer_before = parser_.BufferSize();
-        MYLOG_INFO(
-            "飞控串口收到原始数据: read_count={}, bytes={}, total_bytes={}, parser_buffer_before={}, hex={}",
-            read_count,
-            bytes.size(),
-            total_bytes,
-            parser_buffer_before,
-            BytesToHexString(bytes));
-
-        // 喂入帧解析器
-        parser_.FeedData(bytes);
-        MYLOG_INFO("飞控帧解析器已喂入数据: parser_buffer_after_feed={}", parser_.BufferSize());
-
-        // 尝试取出所有可用帧
-        ParsedFrame frame;
-        size_t parsed_frame_count = 0;
-        while (parser_.PopFrame(frame)) {
-            ++parsed_frame_count;
-            MYLOG_INFO(
-                "飞控帧解析结果: index={}, cnt={}, frame_type=0x{:02X}({}), payload_len={}, checksum=0x{:02X}, valid={}",
-                parsed_frame_count,
-                frame.cnt,
-                frame.frame_type,
-                GetFrameTypeName(frame.frame_type),
-                frame.payload.size(),
-                frame.checksum,
-                frame.valid ? "true" : "false");
-
-            if (!frame.valid) {
-                MYLOG_WARN(
-                    "收到校验和不通过的帧, 帧类型=0x{:02X}, cnt={}, payload_len={}, payload_hex={}, 丢弃",
-                    frame.frame_type,
-                    frame.cnt,
-                    frame.payload.size(),
-                    BytesToHexString(frame.payload));
-                continue;
+        ConsumeBytes(bytes, read_count, total_bytes);
+    }
+
+    MYLOG_INFO("飞控接收线程退出: read_count={}, total_bytes={}, parser_buffer_remaining={}",
+               read_count,
+               total_bytes,
+               parser_.BufferSize());
+}
+
+void MyFlyControl::ReceiveLoopEvent() {
+    LogSerialSnapshot("飞控接收线程启动（event 模式），当前串口状态:", serial_.GetSnapshot());
+    constexpr size_t READ_BUF_SIZE = 4096;
+    constexpr int ERROR_BACKOFF_MS = 100;
+    size_t read_count = 0;
+    size_t error_count = 0;
+    size_t total_bytes = 0;
+    std::vector<uint8_t> bytes;
+    bytes.reserve(READ_BUF_SIZE);
+
+    while (running_.load()) {
+        // 无限等待可读；链路空闲时线程不会被唤醒，Stop() 通过 InterruptWait() 唤醒
+        std::string err;
+        const auto ready = serial_.WaitReadable(-1, &err);
+        if (ready == my_serial::SerialWaitResult::Interrupted ||
+            ready == my_serial::SerialWaitResult::Timeout) {
+            continue;
+        }
+        if (ready == my_serial::SerialWaitResult::Error) {
+            ++error_count;
+            if (error_count == 1 || error_count % 50 == 0) {
+                MYLOG_WARN("飞控串口等待可读失败: error_count={}, err={}", error_count, err);
             }
-            HandleFrame(frame);
+            // 设备断开时 poll 会持续返回错误，退避避免空转
+            std::this_thread::sleep_for(std::chrono::milliseconds(ERROR_BACKOFF_MS));
+            continue;
         }
-
-        if (parsed_frame_count == 0) {
-            MYLOG_INFO("当前读取批次尚未拼出完整帧: parser_buffer_remaining={}", parser_.BufferSize());
-        } else {
-            MYLOG_INFO(
-                "当前读取批次拆帧完成: parsed_frame_count={}, parser_buffer_remaining={}",
-                parsed_frame_count,
-                parser_.BufferSize());
+        error_count = 0;
+
+        // 一次就绪尽量读空内核缓冲区，合并成批次交给帧解析器
+        while (running_.load()) {
+            bytes.resize(READ_BUF_SIZE);
+            const size_t n = serial_.ReadAvailable(bytes.data(), bytes.size(), &err);
+            bytes.resize(n);
+            if (!err.empty()) {
+                MYLOG_WARN("飞控串口读取失败: read_count={}, err={}", read_count, err);
+                break;
+            }
+            if (n == 0) {
+                break;
+            }
+            ++read_count;
+            total_bytes += n;
+            ConsumeBytes(bytes, read_count, total_bytes);
         }
     }
 
@@ -415,12 +601,72 @@ void MyFlyControl::ReceiveLoop() {
                parser_.BufferSize());
 }
 
-void MyFlyControl::HandleFrame(const ParsedFrame& frame) {
+void MyFlyControl::ConsumeBytes(const std::vector<uint8_t>& bytes,
+                                size_t read_count,
+                                size_t total_bytes) {
+    // 每次读取 / 每帧的日志走 DEBUG：高频链路上 INFO 会成为接收瓶颈
+    const size_t parser_buffer_before = parser_.BufferSize();
+    MYLOG_DEBUG(
+        "飞控串口收到原始数据: read_count={}, bytes={}, total_bytes={}, parser_buffer_before={}",
+        read_count,
+        bytes.size(),
+        total_bytes,
+        parser_buffer_before);
+    if (HexDumpEnabled()) {
+        MYLOG_DEBUG("飞控串口收到原始数据: read_count={}, hex={}", read_count, BytesToHexString(bytes));
+    }
+
+    if (capture_enabled_.load(std::memory_order_relaxed)) {
+        capture_.Append(CaptureDirection::Rx, bytes.data(), bytes.size());
+    }
+
+    // 喂入帧解析器
+    parser_.FeedData(bytes);
+    MYLOG_DEBUG("飞控帧解析器已喂入数据: parser_buffer_after_feed={}", parser_.BufferSize());
+
+    // 尝试取出所有可用帧；帧视图指向解析器缓冲区，直接在原地解码
+    size_t parsed_frame_count = 0;
+    FrameView frame;
+    while (parser_.NextFrame(frame)) {
+        ++parsed_frame_count;
+        MYLOG_DEBUG(
+            "飞控帧解析结果: index={}, cnt={}, frame_type=0x{:02X}({}), payload_len={}, checksum=0x{:02X}, valid={}",
+            parsed_frame_count,
+            frame.cnt,
+            frame.frame_type,
+            GetFrameTypeName(frame.frame_type),
+            frame.payload_len(),
+            frame.checksum,
+            frame.valid ? "true" : "false");
+
+        if (!frame.valid) {
+            MYLOG_WARN(
+                "收到校验和不通过的帧, 帧类型=0x{:02X}, cnt={}, payload_len={}, payload_hex={}, 丢弃",
+                frame.frame_type,
+                frame.cnt,
+                frame.payload_len(),
+                BytesToHexString(frame.payload(), frame.payload_len()));
+            continue;
+        }
+        HandleFrame(frame);
+    }
+
+    if (parsed_frame_count == 0) {
+        MYLOG_DEBUG("当前读取批次尚未拼出完整帧: parser_buffer_remaining={}", parser_.BufferSize());
+    } else {
+        MYLOG_DEBUG(
+            "当前读取批次拆帧完成: parsed_frame_count={}, parser_buffer_remaining={}",
+            parsed_frame_count,
+            parser_.BufferSize());
+    }
+}
+
+void MyFlyControl::HandleFrame(const FrameView& frame) {
     switch (frame.frame_type) {
         case FRAME_TYPE_HEARTBEAT: {
             HeartbeatData hb;
             hb.cnt = frame.cnt;
-            if (DecodeHeartbeat(frame.payload, hb)) {
+            if (DecodeHeartbeat(frame.payload(), frame.payload_len(), hb)) {
                 MYLOG_INFO(
                     "收到飞控心跳: cnt={}, aircraft_id={}, run_mode=0x{:02X}, satellites={}, lon={:.7f}, lat={:.7f}, altitude={:.1f}m, relative_alt={:.1f}m, flight_mode=0x{:02X}, flight_state=0x{:02X}, battery={}%, fault_info=0x{:04X}",
                     hb.cnt,
@@ -463,7 +709,7 @@ void MyFlyControl::HandleFrame(const ParsedFrame& frame) {
         case FRAME_TYPE_REPLY: {
             CommandReplyData reply;
             reply.cnt = frame.cnt;
-            if (DecodeCommandReply(frame.payload, reply)) {
+            if (DecodeCommandReply(frame.payload(), frame.payload_len(), reply)) {
                 MYLOG_INFO("收到指令回复: {}={}", GetCommandName(reply.replied_cmd),
                            reply.result == 0 ? "成功" : "失败");
                 std::lock_guard<std::mutex> lock(cb_mutex_);
@@ -479,7 +725,7 @@ void MyFlyControl::HandleFrame(const ParsedFrame& frame) {
         case FRAME_TYPE_GIMBAL_CONTROL: {
             GimbalControlData gimbal;
             gimbal.cnt = frame.cnt;
-            if (DecodeGimbalControl(frame.payload, gimbal)) {
+            if (DecodeGimbalControl(frame.payload(), frame.payload_len(), gimbal)) {
                 MYLOG_INFO("收到云台控制: cnt={}, enable={}, pitch_angle={}, yaw_angle={}",
                            gimbal.cnt,
                            gimbal.enable,
@@ -502,18 +748,28 @@ void MyFlyControl::HandleFrame(const ParsedFrame& frame) {
 }
 
 bool MyFlyControl::SendRawData(const std::vector<uint8_t>& data, std::string* err) {
+    return SendRawData(data.data(), data.size(), err);
+}
+
+bool MyFlyControl::SendRawData(const uint8_t* data, size_t size, std::string* err) {
     std::lock_guard<std::mutex> lock(send_mutex_);
-    MYLOG_INFO("飞控串口发送原始数据: bytes={}, hex={}", data.size(), BytesToHexString(data));
-    size_t written = serial_.Write(data, err);
-    if (written != data.size()) {
+    MYLOG_INFO("飞控串口发送原始数据: bytes={}", size);
+    if (HexDumpEnabled()) {
+        MYLOG_DEBUG("飞控串口发送原始数据: hex={}", BytesToHexString(data, size));
+    }
+    if (capture_enabled_.load(std::memory_order_relaxed)) {
+        capture_.Append(CaptureDirection::Tx, data, size);
+    }
+    size_t written = serial_.Write(data, size, err);
+    if (written != size) {
         MYLOG_WARN("飞控串口发送字节数不匹配: expected={}, actual={}, err={}",
-                   data.size(),
+                   size,
                    written,
                    (err != nullptr && !err->empty()) ? *err : std::string("unknown error"));
     } else {
         MYLOG_INFO("飞控串口发送完成: written={}", written);
     }
-    return written == data.size();
+    return written == size;
 }
 
 uint8_t MyFlyControl::NextCnt() {
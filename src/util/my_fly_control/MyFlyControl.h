@@ -11,6 +11,7 @@
 
 #include <nlohmann/json.hpp>
 
+#include "FlyControlCapture.h"
 #include "FlyControlCodec.h"
 #include "FlyControlFrame.h"
 #include "FlyControlProtocol.h"
@@ -21,11 +22,12 @@
 //
 // 功能概述：
 //   1. 通过 JSON 配置初始化串口连接
-//   2. 启动后台接收线程，持续从串口读取数据并拆帧
+//   2. 启动后台接收线程，持续从串口读取数据并拆帧（blocking 轮询或 event 就绪驱动）
 //   3. 提供各类飞行控制指令的发送接口
 //   4. 维护最新的飞控心跳状态，线程安全可读
 //   5. 支持注册回调：心跳更新、指令回复、云台控制
 //   6. 指令发送支持超时等待回复（2秒超时）
+//   7. 可选录制串口原始收发字节（FlyControlCapture），并把抓包回放进拆帧/处理链路
 //
 // 使用示例：
 //   fly_control::MyFlyControl fc;
@@ -44,6 +46,29 @@ using HeartbeatCallback     = std::function<void(const HeartbeatData&)>;
 using CommandReplyCallback  = std::function<void(const CommandReplyData&)>;
 using GimbalControlCallback = std::function<void(const GimbalControlData&)>;
 
+// 抓包回放参数
+struct ReplayOptions {
+    bool realtime = false;   // true: 按录制时间间隔原速回放；false: 尽可能快
+};
+
+// 抓包回放结果
+struct ReplayStats {
+    size_t  files            = 0;
+    size_t  records          = 0;   // 回放的接收记录数（发送记录只计数不处理）
+    size_t  tx_records       = 0;
+    size_t  rx_bytes         = 0;
+    size_t  frames           = 0;   // 拆出的帧数（含校验失败）
+    size_t  invalid_frames   = 0;
+    double  elapsed_s        = 0.0;
+    double  frames_per_sec   = 0.0;
+    double  mbytes_per_sec   = 0.0;
+    int64_t handler_p50_ns   = 0;   // HandleFrame 耗时分位
+    int64_t handler_p99_ns   = 0;
+    int64_t handler_max_ns   = 0;
+
+    nlohmann::json ToJson() const;
+};
+
 class MyFlyControl {
 public:
     MyFlyControl();
@@ -57,6 +82,10 @@ public:
     // 兼容两套字段：
     //   1. { "port": "/dev/ttyS1", "baudrate": 115200, "timeout_ms": 100 }
     //   2. { "device": "/dev/ttyS1", "baud_rate": 115200, "data_bits": 8, "stop_bits": 1, "flow_control": "none" }
+    // 可选 "capture": { "enabled": true, "dir": "...", "segment_size_mb": 16, "max_segments": 8 }
+    // 启用后 Start 期间的串口收发原始字节写入 mmap 抓包文件
+    // 配置 "read_mode": "event"（可选 vmin/vtime/low_latency）时接收线程改为就绪驱动，
+    // 收到数据立即拆帧，链路空闲时不唤醒
     bool Init(const nlohmann::json& cfg, std::string* err = nullptr);
 
     // 启动后台接收线程
@@ -68,6 +97,18 @@ public:
     // 是否正在运行
     bool IsRunning() const;
 
+    // -----------------------------------------------------------------------
+    // 抓包录制与回放
+    // -----------------------------------------------------------------------
+
+    // 录制统计；未配置 capture 时 open=false
+    nlohmann::json GetCaptureStats() const;
+
+    // 将抓包文件中的接收字节依次喂入帧解析器并处理（触发已注册的回调）
+    // path 可以是单个 .fccap 文件或目录；运行中（Start 之后）不允许回放
+    bool ReplayCapture(const std::string& path, const ReplayOptions& options,
+                       ReplayStats* stats, std::string* err = nullptr);
+
     // -----------------------------------------------------------------------
     // 回调注册
     // -----------------------------------------------------------------------
@@ -151,14 +192,22 @@ public:
     bool SendTargetState(const TargetStateData& data, std::string* err = nullptr);
 
 private:
-    // 后台接收线程主循环
+    // 后台接收线程主循环（blocking 模式：依赖串口读超时 + 空读休眠）
     void ReceiveLoop();
 
-    // 处理一个已解析的帧
-    void HandleFrame(const ParsedFrame& frame);
+    // 后台接收线程主循环（event 模式：poll 等待可读，空闲时不唤醒）
+    void ReceiveLoopEvent();
 
-    // 通过串口发送字节数据
+    // 将一批收到的字节喂入帧解析器并处理所有完整帧
+    void ConsumeBytes(const std::vector<uint8_t>& bytes, size_t read_count,
+                      size_t total_bytes);
+
+    // 处理一个已解析的帧（视图指向解析器缓冲区，仅在本次调用内有效）
+    void HandleFrame(const FrameView& frame);
+
+    // 通过串口发送字节数据；指针版本供定长 std::array 帧使用
     bool SendRawData(const std::vector<uint8_t>& data, std::string* err);
+    bool SendRawData(const uint8_t* data, size_t size, std::string* err);
 
     // 获取下一个 CNT 值（自增计数器）
     uint8_t NextCnt();
@@ -177,6 +226,11 @@ private:
     bool                          has_hb_{false};  // 是否收到过心跳
 
     std::mutex                    send_mutex_;     // 发送锁
+
+    CaptureWriter                 capture_;                  // 原始字节录制
+    CaptureWriter::Options        capture_options_;
+    bool                          capture_configured_{false};
+    std::atomic<bool>             capture_enabled_{false};   // 录制中，收发路径只读这个标志
     std::atomic<uint8_t>          cnt_{0};         // 帧计数器
 
     // 回调函数
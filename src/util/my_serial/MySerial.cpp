@@ -2,9 +2,23 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <cstring>
 #include <limits>
 #include <stdexcept>
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/serial.h>
+#endif
+
 #include "MyLog.h"
 
 namespace my_serial {
@@ -166,6 +180,37 @@ bool ExecuteWithError(std::string* err, std::string& last_error, Fn&& fn) {
     }
 }
 
+// read_mode 只接受 blocking/event 两种取值，其它值视为配置错误而不是
+// 静默回退，避免以为启用了事件接收实际却仍在轮询。
+std::string ParseReadMode(const std::string& value) {
+    const std::string normalized = NormalizeToken(value);
+    if (normalized == "blocking" || normalized == "event") {
+        return normalized;
+    }
+    throw std::invalid_argument("unsupported read_mode: " + value);
+}
+
+#if !defined(_WIN32)
+std::string ErrnoMessage(const std::string& what) {
+    return what + ": " + std::strerror(errno);
+}
+
+void CloseFd(int& fd) {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+void SetNonBlockCloexec(int fd) {
+    const int flags = ::fcntl(fd, F_GETFL);
+    if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0 ||
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC) != 0) {
+        throw std::runtime_error(ErrnoMessage("fcntl failed"));
+    }
+}
+#endif
+
 } // namespace
 
 MySerial::MySerial() = default;
@@ -196,6 +241,7 @@ bool MySerial::Init(const nlohmann::json& cfg, std::string* err) {
         if (serial_ && serial_->isOpen()) {
             current_step = "close previous port";
             MYLOG_WARN("[MySerial] Closing previously opened port before re-init: {}", options_.port);
+            CloseEventReceiverLocked();
             serial_->close();
         }
 
@@ -205,7 +251,7 @@ bool MySerial::Init(const nlohmann::json& cfg, std::string* err) {
         parsed_options = ParseOptions(cfg);
         options_parsed = true;
         MYLOG_INFO(
-            "[MySerial] Parsed config: port={}, baudrate={}, timeout_ms={}, auto_open={}, bytesize={}, parity={}, stopbits={}, flowcontrol={}, inter_byte_timeout_ms={}, read_timeout_constant_ms={}, read_timeout_multiplier_ms={}, write_timeout_constant_ms={}, write_timeout_multiplier_ms={}",
+            "[MySerial] Parsed config: port={}, baudrate={}, timeout_ms={}, auto_open={}, bytesize={}, parity={}, stopbits={}, flowcontrol={}, inter_byte_timeout_ms={}, read_timeout_constant_ms={}, read_timeout_multiplier_ms={}, write_timeout_constant_ms={}, write_timeout_multiplier_ms={}, read_mode={}, vmin={}, vtime={}, low_latency={}",
             parsed_options.port,
             parsed_options.baudrate,
             parsed_options.timeout_ms,
@@ -218,7 +264,11 @@ bool MySerial::Init(const nlohmann::json& cfg, std::string* err) {
             parsed_options.read_timeout_constant_ms,
             parsed_options.read_timeout_multiplier_ms,
             parsed_options.write_timeout_constant_ms,
-            parsed_options.write_timeout_multiplier_ms);
+            parsed_options.write_timeout_multiplier_ms,
+            parsed_options.read_mode,
+            parsed_options.vmin,
+            parsed_options.vtime,
+            parsed_options.low_latency ? "true" : "false");
 
         current_step = "create serial instance";
         auto new_serial = std::make_unique<serial::Serial>();
@@ -245,6 +295,10 @@ bool MySerial::Init(const nlohmann::json& cfg, std::string* err) {
             MYLOG_INFO("[MySerial] auto_open=true, trying to open port: {}", parsed_options.port);
             new_serial->open();
             MYLOG_INFO("[MySerial] Port opened during Init: {}", parsed_options.port);
+            if (parsed_options.read_mode == "event") {
+                current_step = "open event receiver";
+                OpenEventReceiverLocked(parsed_options);
+            }
         } else {
             MYLOG_INFO("[MySerial] auto_open=false, skip opening port during Init: {}", parsed_options.port);
         }
@@ -265,6 +319,7 @@ bool MySerial::Init(const nlohmann::json& cfg, std::string* err) {
                    options_.auto_open ? "true" : "false");
         return true;
     } catch (const std::exception& ex) {
+        CloseEventReceiverLocked();
         initialized_ = false;
         serial_.reset();
         options_ = SerialInitOptions{};
@@ -287,6 +342,7 @@ bool MySerial::Init(const nlohmann::json& cfg, std::string* err) {
             options_parsed ? (parsed_options.auto_open ? "true" : "false") : std::string("<unparsed>"));
         return false;
     } catch (...) {
+        CloseEventReceiverLocked();
         initialized_ = false;
         serial_.reset();
         options_ = SerialInitOptions{};
@@ -321,12 +377,16 @@ bool MySerial::Open(std::string* err) {
             serial_->open();
             MYLOG_INFO("[MySerial] Port opened: {}", options_.port);
         }
+        if (options_.read_mode == "event" && rx_fd_ < 0) {
+            OpenEventReceiverLocked(options_);
+        }
     });
 }
 
 void MySerial::Close() {
     std::lock_guard<std::mutex> lock(mutex_);
     // Close() 是幂等的：未创建、未打开或已经关闭的实例都可以安全调用。
+    CloseEventReceiverLocked();
     if (serial_ && serial_->isOpen()) {
         serial_->close();
         MYLOG_INFO("[MySerial] Port closed: {}", options_.port);
@@ -356,18 +416,21 @@ size_t MySerial::Write(const std::string& data, std::string* err) {
 }
 
 size_t MySerial::Write(const std::vector<uint8_t>& data, std::string* err) {
+    return Write(data.data(), data.size(), err);
+}
+
+size_t MySerial::Write(const uint8_t* data, size_t size, std::string* err) {
     std::lock_guard<std::mutex> lock(mutex_);
     size_t written = 0;
-    // vector<uint8_t> 路径用于二进制帧，数据中的 0x00 等字节不会被当作
-    // C 字符串结束符处理。
-    ExecuteWithError(err, last_error_, [this, &data, &written]() {
+    // 二进制帧路径，数据中的 0x00 等字节不会被当作 C 字符串结束符处理。
+    ExecuteWithError(err, last_error_, [this, data, size, &written]() {
         if (!initialized_ || !serial_) {
             throw std::runtime_error("MySerial is not initialized");
         }
         if (!serial_->isOpen()) {
             throw std::runtime_error("Serial port is not open");
         }
-        written = serial_->write(data);
+        written = serial_->write(data, size);
     });
     return written;
 }
@@ -424,6 +487,125 @@ std::string MySerial::ReadLine(size_t max_size, const std::string& eol, std::str
     return result;
 }
 
+bool MySerial::IsEventDriven() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rx_fd_ >= 0;
+}
+
+int MySerial::NativeHandle() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rx_fd_;
+}
+
+SerialWaitResult MySerial::WaitReadable(int timeout_ms, std::string* err) {
+#if defined(_WIN32)
+    (void)timeout_ms;
+    if (err != nullptr) {
+        *err = "read_mode=event is not supported on this platform";
+    }
+    return SerialWaitResult::Error;
+#else
+    // 只在取 fd 时短暂持锁；poll 本身不持锁，避免阻塞发送路径。
+    int rx_fd = -1;
+    int wake_fd = -1;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rx_fd = rx_fd_;
+        wake_fd = wake_fds_[0];
+    }
+    if (rx_fd < 0) {
+        if (err != nullptr) {
+            *err = "serial event receiver is not open";
+        }
+        return SerialWaitResult::Error;
+    }
+
+    pollfd fds[2] = {{rx_fd, POLLIN, 0}, {wake_fd, POLLIN, 0}};
+    int ready = 0;
+    do {
+        ready = ::poll(fds, 2, timeout_ms < 0 ? -1 : timeout_ms);
+    } while (ready < 0 && errno == EINTR);
+
+    if (ready < 0) {
+        if (err != nullptr) {
+            *err = ErrnoMessage("poll failed");
+        }
+        return SerialWaitResult::Error;
+    }
+    if (ready == 0) {
+        return SerialWaitResult::Timeout;
+    }
+    if (fds[1].revents & POLLIN) {
+        // 读空唤醒管道，多次 InterruptWait() 合并为一次唤醒
+        char drain[64];
+        while (::read(wake_fd, drain, sizeof(drain)) > 0) {
+        }
+        return SerialWaitResult::Interrupted;
+    }
+    if (fds[0].revents & POLLIN) {
+        return SerialWaitResult::Readable;
+    }
+    // POLLERR/POLLHUP/POLLNVAL：USB 转串口拔出、对端关闭等
+    if (err != nullptr) {
+        *err = "serial port error or hang up, revents=" + std::to_string(fds[0].revents);
+    }
+    return SerialWaitResult::Error;
+#endif
+}
+
+size_t MySerial::ReadAvailable(uint8_t* data, size_t size, std::string* err) {
+#if defined(_WIN32)
+    (void)data;
+    (void)size;
+    if (err != nullptr) {
+        *err = "read_mode=event is not supported on this platform";
+    }
+    return 0;
+#else
+    int rx_fd = -1;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rx_fd = rx_fd_;
+    }
+    if (rx_fd < 0) {
+        if (err != nullptr) {
+            *err = "serial event receiver is not open";
+        }
+        return 0;
+    }
+
+    if (err != nullptr) {
+        err->clear();
+    }
+    ssize_t n = 0;
+    do {
+        n = ::read(rx_fd, data, size);
+    } while (n < 0 && errno == EINTR);
+
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+        if (err != nullptr) {
+            *err = ErrnoMessage("serial read failed");
+        }
+        return 0;
+    }
+    return static_cast<size_t>(n);
+#endif
+}
+
+void MySerial::InterruptWait() {
+#if !defined(_WIN32)
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (wake_fds_[1] >= 0) {
+        const char one = 1;
+        // 管道满时说明已有未处理的唤醒，忽略 EAGAIN 即可
+        (void)::write(wake_fds_[1], &one, 1);
+    }
+#endif
+}
+
 size_t MySerial::Available(std::string* err) const {
     std::lock_guard<std::mutex> lock(mutex_);
     size_t available = 0;
@@ -476,6 +658,7 @@ SerialPortSnapshot MySerial::GetSnapshot() const {
     snapshot.parity = options_.parity;
     snapshot.stopbits = options_.stopbits;
     snapshot.flowcontrol = options_.flowcontrol;
+    snapshot.read_mode = options_.read_mode;
 
     if (snapshot.open) {
         try {
@@ -502,6 +685,7 @@ nlohmann::json MySerial::GetSnapshotJson() const {
         {"parity", snapshot.parity},
         {"stopbits", snapshot.stopbits},
         {"flowcontrol", snapshot.flowcontrol},
+        {"read_mode", snapshot.read_mode},
         {"last_error", snapshot.last_error}
     };
 }
@@ -597,9 +781,121 @@ SerialInitOptions MySerial::ParseOptions(const nlohmann::json& cfg) {
     options.stopbits = ToString(ParseStopbits(GetTokenValue(cfg, {"stopbits", "stop_bits"}, options.stopbits)));
     options.flowcontrol = ToString(ParseFlowcontrol(GetTokenValue(cfg, {"flowcontrol", "flow_control"}, options.flowcontrol)));
     options.auto_open = cfg.value("auto_open", options.auto_open);
+    options.read_mode = ParseReadMode(GetTokenValue(cfg, {"read_mode"}, options.read_mode));
+    options.vmin = GetUint32Value(cfg, {"vmin"}, options.vmin);
+    options.vtime = GetUint32Value(cfg, {"vtime"}, options.vtime);
+    options.low_latency = cfg.value("low_latency", options.low_latency);
+    // termios 的 c_cc 是单字节，超出范围直接报错而不是截断
+    if (options.vmin > 255 || options.vtime > 255) {
+        throw std::invalid_argument("serial config field 'vmin'/'vtime' must be in [0, 255]");
+    }
     return options;
 }
 
+void MySerial::OpenEventReceiverLocked(const SerialInitOptions& options) {
+#if defined(_WIN32)
+    (void)options;
+    throw std::runtime_error("read_mode=event is not supported on this platform");
+#else
+    CloseEventReceiverLocked();
+
+    // 底层 serial::Serial 不暴露 fd，这里对同一设备再打开一个只读 fd。
+    // 线路参数（波特率、校验等）是设备级的，已由 serial_ 配置好，这里只调整 c_cc。
+    // termios / serial_struct 同样是设备级的：改动前记下原值，CloseEventReceiverLocked 时恢复，
+    // 避免 blocking 模式或其它进程在关闭后仍沿用这里的 VMIN/VTIME、ASYNC_LOW_LATENCY。
+    rx_fd_ = ::open(options.port.c_str(), O_RDONLY | O_NOCTTY | O_NONBLOCK);
+    if (rx_fd_ < 0) {
+        throw std::runtime_error(ErrnoMessage("open event receiver failed: " + options.port));
+    }
+    try {
+        SetNonBlockCloexec(rx_fd_);
+
+        termios tio{};
+        if (::tcgetattr(rx_fd_, &tio) != 0) {
+            throw std::runtime_error(ErrnoMessage("tcgetattr failed"));
+        }
+        const cc_t saved_vmin = tio.c_cc[VMIN];
+        const cc_t saved_vtime = tio.c_cc[VTIME];
+        tio.c_cc[VMIN] = static_cast<cc_t>(options.vmin);
+        tio.c_cc[VTIME] = static_cast<cc_t>(options.vtime);
+        if (::tcsetattr(rx_fd_, TCSANOW, &tio) != 0) {
+            throw std::runtime_error(ErrnoMessage("tcsetattr failed"));
+        }
+        saved_vmin_ = saved_vmin;
+        saved_vtime_ = saved_vtime;
+        restore_cc_ = true;
+
+        bool low_latency_applied = false;
+#if defined(__linux__)
+        if (options.low_latency) {
+            // pty、部分 USB 转串口驱动不支持 TIOCGSERIAL，只记录日志，不作为失败
+            serial_struct ss{};
+            if (::ioctl(rx_fd_, TIOCGSERIAL, &ss) == 0) {
+                const bool was_low_latency = (ss.flags & ASYNC_LOW_LATENCY) != 0;
+                ss.flags |= ASYNC_LOW_LATENCY;
+                low_latency_applied = ::ioctl(rx_fd_, TIOCSSERIAL, &ss) == 0;
+                restore_low_latency_ = low_latency_applied && !was_low_latency;
+            }
+            if (!low_latency_applied) {
+                MYLOG_INFO("[MySerial] ASYNC_LOW_LATENCY not supported by driver: port={}, errno={}",
+                           options.port, std::strerror(errno));
+            }
+        }
+#endif
+
+        if (::pipe(wake_fds_) != 0) {
+            throw std::runtime_error(ErrnoMessage("pipe failed"));
+        }
+        SetNonBlockCloexec(wake_fds_[0]);
+        SetNonBlockCloexec(wake_fds_[1]);
+
+        MYLOG_INFO("[MySerial] Event receiver opened: port={}, fd={}, vmin={}, vtime={}, low_latency={}",
+                   options.port,
+                   rx_fd_,
+                   options.vmin,
+                   options.vtime,
+                   low_latency_applied ? "true" : "false");
+    } catch (...) {
+        CloseEventReceiverLocked();
+        throw;
+    }
+#endif
+}
+
+void MySerial::CloseEventReceiverLocked() {
+#if !defined(_WIN32)
+    if (rx_fd_ >= 0) {
+        // 只恢复本模块改过的字段，线路参数可能已被 serial_ 重新配置，不整体回写旧 termios
+        if (restore_cc_) {
+            termios tio{};
+            if (::tcgetattr(rx_fd_, &tio) == 0) {
+                tio.c_cc[VMIN] = static_cast<cc_t>(saved_vmin_);
+                tio.c_cc[VTIME] = static_cast<cc_t>(saved_vtime_);
+                if (::tcsetattr(rx_fd_, TCSANOW, &tio) != 0) {
+                    MYLOG_WARN("[MySerial] restore VMIN/VTIME failed: port={}, errno={}",
+                               options_.port, std::strerror(errno));
+                }
+            }
+        }
+#if defined(__linux__)
+        if (restore_low_latency_) {
+            serial_struct ss{};
+            if (::ioctl(rx_fd_, TIOCGSERIAL, &ss) == 0) {
+                ss.flags &= ~ASYNC_LOW_LATENCY;
+                ::ioctl(rx_fd_, TIOCSSERIAL, &ss);
+            }
+        }
+#endif
+        MYLOG_INFO("[MySerial] Event receiver closed: port={}, fd={}", options_.port, rx_fd_);
+    }
+    restore_cc_ = false;
+    restore_low_latency_ = false;
+    CloseFd(rx_fd_);
+    CloseFd(wake_fds_[0]);
+    CloseFd(wake_fds_[1]);
+#endif
+}
+
 serial::bytesize_t MySerial::ParseBytesize(const std::string& value) {
     // serial 库枚举不能直接从 JSON 使用，集中在这里完成字符串/数字兼容。
     const std::string normalized = NormalizeToken(value);
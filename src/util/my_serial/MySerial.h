@@ -22,6 +22,14 @@ namespace my_serial {
  * 所有 timeout 字段的单位均为毫秒。read/write 的 constant 和 multiplier
  * 会传递给底层 serial::Timeout；当它们保持默认组合时，模块使用简单
  * 超时模式，以便与 timeout_ms 的直观语义保持一致。
+ *
+ * read_mode 决定接收方式：
+ * - blocking（默认）：Read()/ReadBytes() 依赖底层库的读超时；
+ * - event：打开端口后额外持有一个只读非阻塞 fd，配合 WaitReadable()/
+ *   ReadAvailable() 做就绪驱动接收。vmin/vtime 写入 termios（vtime 单位
+ *   为 0.1 秒）；Linux 下 vtime=0 时 poll 以 vmin 作为就绪字节数阈值。
+ *   low_latency 在驱动支持时设置 ASYNC_LOW_LATENCY。两者都是设备级设置，
+ *   关闭 event 接收（Close/切回 blocking）时恢复为打开前的值。
  */
 struct SerialInitOptions {
     std::string port;
@@ -37,6 +45,10 @@ struct SerialInitOptions {
     std::string stopbits{"one"};
     std::string flowcontrol{"none"};
     bool auto_open{true};
+    std::string read_mode{"blocking"};
+    uint32_t vmin{1};
+    uint32_t vtime{0};
+    bool low_latency{true};
 };
 
 /**
@@ -56,9 +68,23 @@ struct SerialPortSnapshot {
     std::string parity;
     std::string stopbits;
     std::string flowcontrol;
+    std::string read_mode;
     std::string last_error;
 };
 
+/**
+ * @brief WaitReadable() 的返回结果。
+ *
+ * Interrupted 表示被 InterruptWait() 唤醒，通常用于停止接收线程；
+ * Error 表示端口不可用（未启用 event 模式、设备断开等），原因写入 err。
+ */
+enum class SerialWaitResult {
+    Readable,
+    Timeout,
+    Interrupted,
+    Error,
+};
+
 /**
  * @brief 串口自检或回环自测的统一返回结果。
  *
@@ -130,6 +156,12 @@ public:
      */
     size_t Write(const std::vector<uint8_t>& data, std::string* err = nullptr);
 
+    /**
+     * @brief 写入调用方缓冲区中的原始字节，调用方可用栈上定长数组组帧，避免堆分配。
+     * @return 成功时返回实际写入的字节数；失败时返回 0。
+     */
+    size_t Write(const uint8_t* data, size_t size, std::string* err = nullptr);
+
     /**
      * @brief 读取指定数量的字节并以字符串返回。
      * @param size 期望读取的字节数，实际返回长度可能受底层超时影响。
@@ -149,6 +181,37 @@ public:
      */
     std::string ReadLine(size_t max_size = 65536, const std::string& eol = "\n", std::string* err = nullptr);
 
+    /**
+     * @brief 当前是否启用了 event 接收模式（read_mode=event 且端口已打开）。
+     */
+    bool IsEventDriven() const;
+
+    /**
+     * @brief event 模式下的接收 fd，可交给外部 epoll/事件循环；未启用时返回 -1。
+     *
+     * fd 由 MySerial 持有，调用方不能关闭，且只应用于等待可读。
+     */
+    int NativeHandle() const;
+
+    /**
+     * @brief 等待接收 fd 可读，timeout_ms < 0 表示无限等待。
+     *
+     * 等待期间不持有实例锁，Write() 等接口不受影响。同一时刻只应有一个
+     * 接收线程调用；Close() 前调用方需先 InterruptWait() 并等待该线程退出。
+     */
+    SerialWaitResult WaitReadable(int timeout_ms, std::string* err = nullptr);
+
+    /**
+     * @brief 非阻塞读取当前已到达的数据，最多 size 字节。
+     * @return 实际读取的字节数；暂无数据返回 0，出错时返回 0 并写入 err。
+     */
+    size_t ReadAvailable(uint8_t* data, size_t size, std::string* err = nullptr);
+
+    /**
+     * @brief 唤醒正在（或下一次）WaitReadable() 的线程，使其返回 Interrupted。
+     */
+    void InterruptWait();
+
     /**
      * @brief 查询底层接收缓冲区当前可读取的字节数。
      * @return 可读取字节数；调用失败时返回 0，并通过 err 报告错误。
@@ -200,12 +263,25 @@ private:
     static std::string ToString(serial::stopbits_t value);
     static std::string ToString(serial::flowcontrol_t value);
 
+    // event 模式接收 fd 与唤醒管道的打开/关闭，调用方需持有 mutex_
+    void OpenEventReceiverLocked(const SerialInitOptions& options);
+    void CloseEventReceiverLocked();
+
 private:
     mutable std::mutex mutex_;
     bool initialized_{false};
     mutable std::string last_error_;
     SerialInitOptions options_;
     std::unique_ptr<serial::Serial> serial_;
+
+    // event 模式：只读非阻塞接收 fd 与自唤醒管道（[0] 读端，[1] 写端）
+    int rx_fd_{-1};
+    int wake_fds_[2]{-1, -1};
+    // 打开 event 接收时改动前的设备级设置，关闭时恢复
+    bool restore_cc_{false};
+    uint8_t saved_vmin_{0};
+    uint8_t saved_vtime_{0};
+    bool restore_low_latency_{false};
 };
 
 } // namespace my_serial
\ No newline at end of file
@@ -5,6 +5,7 @@
  * 测试覆盖：
  *   - ValidateFilename 入参校验（合法/非法场景）
  *   - CacheErrorToHttpCode 错误码→HTTP 状态码映射
+ *   - 下载接口 Range 解析与 ETag 匹配
  *   - 与 MyCache 集成的完整上传/查询/删除/列表流程
  */
 
@@ -155,6 +156,63 @@ TEST(FileApi_ErrorMapping, AllCodesMapCorrectly) {
     EXPECT_EQ(CacheErrorToHttpCode(CacheErrorCode::FileTooLarge), 413);
 }
 
+// ============================================================================
+// 下载接口 Range / ETag 辅助函数测试
+// ============================================================================
+
+TEST(FileApi_Download, ParseByteRangeForms) {
+    uint64_t first = 0, last = 0;
+
+    EXPECT_EQ(ParseByteRange("bytes=0-99", 1000, first, last), ByteRangeStatus::Satisfiable);
+    EXPECT_EQ(first, 0u);
+    EXPECT_EQ(last, 99u);
+
+    EXPECT_EQ(ParseByteRange("bytes=500-", 1000, first, last), ByteRangeStatus::Satisfiable);
+    EXPECT_EQ(first, 500u);
+    EXPECT_EQ(last, 999u);
+
+    EXPECT_EQ(ParseByteRange("bytes=-100", 1000, first, last), ByteRangeStatus::Satisfiable);
+    EXPECT_EQ(first, 900u);
+    EXPECT_EQ(last, 999u);
+
+    // 结束偏移超出文件大小时截断到末尾
+    EXPECT_EQ(ParseByteRange("bytes=900-5000", 1000, first, last), ByteRangeStatus::Satisfiable);
+    EXPECT_EQ(last, 999u);
+
+    // 后缀长度大于文件大小时返回整个文件
+    EXPECT_EQ(ParseByteRange("bytes=-5000", 1000, first, last), ByteRangeStatus::Satisfiable);
+    EXPECT_EQ(first, 0u);
+}
+
+TEST(FileApi_Download, ParseByteRangeInvalidOrUnsatisfiable) {
+    uint64_t first = 0, last = 0;
+
+    EXPECT_EQ(ParseByteRange("bytes=1000-", 1000, first, last), ByteRangeStatus::Unsatisfiable);
+    EXPECT_EQ(ParseByteRange("bytes=-0", 1000, first, last), ByteRangeStatus::Unsatisfiable);
+    EXPECT_EQ(ParseByteRange("bytes=0-", 0, first, last), ByteRangeStatus::Unsatisfiable);
+
+    // 格式不支持时按完整文件处理
+    EXPECT_EQ(ParseByteRange("items=0-10", 1000, first, last), ByteRangeStatus::None);
+    EXPECT_EQ(ParseByteRange("bytes=0-10,20-30", 1000, first, last), ByteRangeStatus::None);
+    EXPECT_EQ(ParseByteRange("bytes=10-5", 1000, first, last), ByteRangeStatus::None);
+    EXPECT_EQ(ParseByteRange("bytes=abc-", 1000, first, last), ByteRangeStatus::None);
+    EXPECT_EQ(ParseByteRange("bytes=-", 1000, first, last), ByteRangeStatus::None);
+}
+
+TEST(FileApi_Download, ETagGenerationAndMatching) {
+    auto etag = MakeFileETag(1024, 123456789);
+    EXPECT_EQ(etag, "\"400-75bcd15\"");
+    EXPECT_NE(etag, MakeFileETag(1024, 123456790));
+    EXPECT_NE(etag, MakeFileETag(1025, 123456789));
+
+    EXPECT_TRUE(ETagMatches(etag, etag));
+    EXPECT_TRUE(ETagMatches("*", etag));
+    EXPECT_TRUE(ETagMatches("\"other\", " + etag, etag));
+    EXPECT_TRUE(ETagMatches("W/" + etag, etag));
+    EXPECT_FALSE(ETagMatches("", etag));
+    EXPECT_FALSE(ETagMatches("\"other\"", etag));
+}
+
 // ============================================================================
 // 与 MyCache 集成测试（不经过 HTTP，直接验证业务逻辑）
 // ============================================================================
@@ -240,6 +298,22 @@ TEST(FileApi_Integration, DeleteNonExistentMapsTo404) {
     CleanupDir(dir);
 }
 
+/// 测试 list 接口的排序与单页条数参数解析
+TEST(FileApi_List, ParseOrderAndClampLimit) {
+    FileListOrder order = FileListOrder::ByModifiedDesc;
+    EXPECT_TRUE(ParseListOrder("", order));
+    EXPECT_EQ(order, FileListOrder::ByName);
+    EXPECT_TRUE(ParseListOrder("mtime_desc", order));
+    EXPECT_EQ(order, FileListOrder::ByModifiedDesc);
+    EXPECT_TRUE(ParseListOrder("name", order));
+    EXPECT_EQ(order, FileListOrder::ByName);
+    EXPECT_FALSE(ParseListOrder("size", order));
+
+    EXPECT_EQ(ClampListLimit(0), kDefaultListLimit);
+    EXPECT_EQ(ClampListLimit(50), 50u);
+    EXPECT_EQ(ClampListLimit(kMaxListLimit + 1), kMaxListLimit);
+}
+
 /// 测试 GetAllFileList 集成
 TEST(FileApi_Integration, ListFilesReturnsCorrectMetadata) {
     auto dir = MakeTestDir("list");
@@ -7,6 +7,7 @@
  *   - JSON 配置解析（root_path / max_file_size / max_retention_seconds）
  *   - 文件保存、查询、获取路径、删除的完整生命周期
  *   - GetAllFileList 文件列表与元信息
+ *   - 分页列表：前缀过滤、按名称/修改时间排序、游标翻页
  *   - 路径穿越攻击防护
  *   - 空文件名等非法输入
  *   - 子目录文件操作
@@ -15,17 +16,24 @@
  *   - 过期文件清理
  *   - MyCacheProvider 单例包装器
  *   - 错误码转换
+ *   - CacheFileWriter 流式写入（分块追加、增量大小限制、放弃写入）
+ *   - 总容量上限与 LRU 淘汰、文件固定
+ *   - 内容寻址去重（SHA-256、内容块引用计数、重启后重建）
  *   - 边界条件：空数据、大文件名等
  */
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <thread>
 #include <chrono>
 #include <vector>
 #include <string>
 
+#include "ContentHash.h"
 #include "MyCache.h"
 #include "MyCacheProvider.h"
 #include <nlohmann/json.hpp>
@@ -376,6 +384,162 @@ TEST(MyCache_Directory, GetFileListRejectsTraversal) {
     CleanupDir(dir);
 }
 
+/// 测试：按名称分页，游标翻页覆盖全部文件且不重复
+TEST(MyCache_ListPage, PaginatesByNameWithCursor) {
+    auto dir = MakeTestDir("page_by_name");
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir));
+        ASSERT_EQ(cache.Status(), CacheStatus::Running);
+
+        for (int i = 0; i < 7; ++i) {
+            ASSERT_TRUE(cache.SaveFile("data/f" + std::to_string(i) + ".bin", ToBytes("x")).Ok());
+        }
+        ASSERT_TRUE(cache.SaveFile("other.txt", ToBytes("y")).Ok());
+
+        FileListQuery query;
+        query.folder_path = "data";
+        query.limit = 3;
+
+        std::vector<std::string> names;
+        int pages = 0;
+        while (true) {
+            auto r = cache.GetFileList(query);
+            ASSERT_TRUE(r.Ok());
+            ++pages;
+            for (const auto& fi : r.value.files) names.push_back(fi.name);
+            if (!r.value.has_more) {
+                EXPECT_TRUE(r.value.next_cursor.empty());
+                break;
+            }
+            EXPECT_EQ(r.value.files.size(), 3u);
+            query.after = r.value.next_cursor;
+        }
+
+        EXPECT_EQ(pages, 3);
+        EXPECT_EQ(cache.GetFileList(query).value.total, 7u);
+        ASSERT_EQ(names.size(), 7u);
+        for (int i = 0; i < 7; ++i) {
+            EXPECT_EQ(names[i], "data/f" + std::to_string(i) + ".bin");
+        }
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：前缀过滤只返回目录范围内匹配前缀的文件
+TEST(MyCache_ListPage, FiltersByPrefixWithinFolder) {
+    auto dir = MakeTestDir("page_prefix");
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir));
+        ASSERT_EQ(cache.Status(), CacheStatus::Running);
+
+        ASSERT_TRUE(cache.SaveFile("img/cam1_001.jpg", ToBytes("a")).Ok());
+        ASSERT_TRUE(cache.SaveFile("img/cam1_002.jpg", ToBytes("b")).Ok());
+        ASSERT_TRUE(cache.SaveFile("img/cam2_001.jpg", ToBytes("c")).Ok());
+        ASSERT_TRUE(cache.SaveFile("imgx/cam1_003.jpg", ToBytes("d")).Ok());
+
+        FileListQuery query;
+        query.folder_path = "img";
+        query.prefix = "cam1_";
+        auto r = cache.GetFileList(query);
+        ASSERT_TRUE(r.Ok());
+        ASSERT_EQ(r.value.files.size(), 2u);
+        EXPECT_EQ(r.value.files[0].name, "img/cam1_001.jpg");
+        EXPECT_EQ(r.value.files[1].name, "img/cam1_002.jpg");
+        EXPECT_FALSE(r.value.has_more);
+
+        // 根目录 + 前缀 "img/" 不应包含 "imgx/" 下的文件
+        FileListQuery root_query;
+        root_query.prefix = "img/";
+        auto r2 = cache.GetFileList(root_query);
+        ASSERT_TRUE(r2.Ok());
+        EXPECT_EQ(r2.value.files.size(), 3u);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：按修改时间降序获取最新 N 个文件，并可继续翻页
+TEST(MyCache_ListPage, NewestFirstWithCursor) {
+    auto dir = MakeTestDir("page_mtime");
+    std::filesystem::create_directories(dir);
+    const auto now = std::filesystem::file_time_type::clock::now();
+    for (int i = 0; i < 5; ++i) {
+        auto path = std::filesystem::path(dir) / ("log" + std::to_string(i) + ".txt");
+        std::ofstream(path) << "log";
+        // log4 最新，log0 最旧，间隔大于时间格式的秒级精度
+        std::filesystem::last_write_time(path, now - std::chrono::hours(5 - i));
+    }
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir));
+        ASSERT_EQ(cache.Status(), CacheStatus::Running);
+
+        FileListQuery query;
+        query.order = FileListOrder::ByModifiedDesc;
+        query.limit = 2;
+
+        auto r1 = cache.GetFileList(query);
+        ASSERT_TRUE(r1.Ok());
+        ASSERT_EQ(r1.value.files.size(), 2u);
+        EXPECT_EQ(r1.value.files[0].name, "log4.txt");
+        EXPECT_EQ(r1.value.files[1].name, "log3.txt");
+        ASSERT_TRUE(r1.value.has_more);
+
+        query.after = r1.value.next_cursor;
+        query.limit = 10;
+        auto r2 = cache.GetFileList(query);
+        ASSERT_TRUE(r2.Ok());
+        ASSERT_EQ(r2.value.files.size(), 3u);
+        EXPECT_EQ(r2.value.files[0].name, "log2.txt");
+        EXPECT_EQ(r2.value.files[2].name, "log0.txt");
+        EXPECT_FALSE(r2.value.has_more);
+
+        query.after = "not-a-cursor";
+        EXPECT_EQ(cache.GetFileList(query).code, CacheErrorCode::InvalidArgument);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：同一秒内写入的文件按纳秒修改时间排序，前缀过滤下游标翻页不重复不遗漏
+TEST(MyCache_ListPage, NewestFirstWithinPrefixUsesSubsecondOrder) {
+    auto dir = MakeTestDir("page_mtime_prefix");
+    std::filesystem::create_directories(std::filesystem::path(dir) / "cam");
+    const auto base = std::filesystem::file_time_type::clock::now() - std::chrono::hours(1);
+    for (int i = 0; i < 5; ++i) {
+        auto path = std::filesystem::path(dir) / "cam" / ("shot" + std::to_string(i) + ".jpg");
+        std::ofstream(path) << "jpg";
+        // 同一秒内相隔 1 毫秒，shot4 最新
+        std::filesystem::last_write_time(path, base + std::chrono::milliseconds(i));
+    }
+    std::ofstream(std::filesystem::path(dir) / "newest.txt") << "x";
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir));
+        ASSERT_EQ(cache.Status(), CacheStatus::Running);
+
+        FileListQuery query;
+        query.folder_path = "cam";
+        query.order = FileListOrder::ByModifiedDesc;
+        query.limit = 2;
+
+        std::vector<std::string> names;
+        while (true) {
+            auto r = cache.GetFileList(query);
+            ASSERT_TRUE(r.Ok());
+            EXPECT_EQ(r.value.total, 5u);
+            for (const auto& fi : r.value.files) names.push_back(fi.name);
+            if (!r.value.has_more) break;
+            query.after = r.value.next_cursor;
+        }
+        ASSERT_EQ(names.size(), 5u);
+        for (int i = 0; i < 5; ++i) {
+            EXPECT_EQ(names[i], "cam/shot" + std::to_string(4 - i) + ".jpg");
+        }
+    }
+    CleanupDir(dir);
+}
+
 /// 测试：在根目录或指定目录下创建子目录
 TEST(MyCache_Directory, CreateSubdirectorySucceeds) {
     auto dir = MakeTestDir("create_subdir");
@@ -754,6 +918,515 @@ TEST(MyCache_BackgroundScan, DetectsExternallyDeletedFile) {
     CleanupDir(dir);
 }
 
+// ============================================================================
+// CacheFileWriter 流式写入测试
+// ============================================================================
+
+/// 测试：分块追加后提交，内容完整且索引立即可见
+TEST(MyCache_Writer, AppendChunksAndCommit) {
+    auto dir = MakeTestDir("writer_commit");
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir));
+        ASSERT_EQ(cache.Status(), CacheStatus::Running);
+
+        auto w = cache.OpenWriter();
+        ASSERT_TRUE(w.Ok());
+        std::string expected;
+        for (int i = 0; i < 100; ++i) {
+            std::string chunk = "chunk-" + std::to_string(i) + ";";
+            expected += chunk;
+            auto r = w.value->Append(reinterpret_cast<const uint8_t*>(chunk.data()), chunk.size());
+            ASSERT_TRUE(r.Ok());
+        }
+        EXPECT_EQ(w.value->BytesWritten(), expected.size());
+
+        // 提交前目标文件不可见
+        EXPECT_FALSE(cache.Exists("stream/out.bin").value);
+
+        auto c = w.value->Commit("stream/out.bin");
+        EXPECT_TRUE(c.Ok());
+        EXPECT_FALSE(w.value->IsOpen());
+        EXPECT_TRUE(cache.Exists("stream/out.bin").value);
+
+        std::ifstream ifs(std::filesystem::path(dir) / "stream" / "out.bin", std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(ifs)),
+                             std::istreambuf_iterator<char>());
+        EXPECT_EQ(content, expected);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：累计大小超过 max_file_size 时增量拒绝，临时文件被删除
+TEST(MyCache_Writer, IncrementalSizeLimit) {
+    auto dir = MakeTestDir("writer_limit");
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir, 1));  // max_file_size = 1 MB
+        ASSERT_EQ(cache.Status(), CacheStatus::Running);
+
+        auto w = cache.OpenWriter();
+        ASSERT_TRUE(w.Ok());
+        std::vector<uint8_t> chunk(256 * 1024, 0x5A);
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_TRUE(w.value->Append(chunk.data(), chunk.size()).Ok());
+        }
+        auto r = w.value->Append(chunk.data(), 1);
+        EXPECT_EQ(r.code, CacheErrorCode::FileTooLarge);
+        EXPECT_FALSE(w.value->IsOpen());
+        EXPECT_FALSE(w.value->Commit("big.bin").Ok());
+        EXPECT_FALSE(cache.Exists("big.bin").value);
+
+        auto staging = std::filesystem::path(cache.GetRootPath()) / MyCache::kStagingDirName;
+        EXPECT_TRUE(std::filesystem::is_empty(staging));
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：未提交的写入器析构后不留下任何文件，暂存目录不出现在文件列表中
+TEST(MyCache_Writer, AbortOnDestructionAndHiddenStaging) {
+    auto dir = MakeTestDir("writer_abort");
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir));
+        ASSERT_EQ(cache.Status(), CacheStatus::Running);
+
+        {
+            auto w = cache.OpenWriter();
+            ASSERT_TRUE(w.Ok());
+            auto data = ToBytes("partial");
+            ASSERT_TRUE(w.value->Append(data.data(), data.size()).Ok());
+
+            // 写入过程中暂存文件不可见
+            auto list = cache.GetAllFileList();
+            ASSERT_TRUE(list.Ok());
+            EXPECT_TRUE(list.value.empty());
+        }
+
+        auto staging = std::filesystem::path(cache.GetRootPath()) / MyCache::kStagingDirName;
+        EXPECT_TRUE(std::filesystem::is_empty(staging));
+        EXPECT_EQ(cache.GetFileList(MyCache::kStagingDirName).code, CacheErrorCode::InvalidArgument);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：提交到非法路径失败，临时文件被清理
+TEST(MyCache_Writer, CommitRejectsTraversal) {
+    auto dir = MakeTestDir("writer_traversal");
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir));
+        ASSERT_EQ(cache.Status(), CacheStatus::Running);
+
+        auto w = cache.OpenWriter();
+        ASSERT_TRUE(w.Ok());
+        auto data = ToBytes("evil");
+        ASSERT_TRUE(w.value->Append(data.data(), data.size()).Ok());
+        EXPECT_EQ(w.value->Commit("../escape.txt").code, CacheErrorCode::PathTraversal);
+
+        auto staging = std::filesystem::path(cache.GetRootPath()) / MyCache::kStagingDirName;
+        EXPECT_TRUE(std::filesystem::is_empty(staging));
+    }
+    CleanupDir(dir);
+}
+
+// ============================================================================
+// 容量上限与 LRU 淘汰测试
+// ============================================================================
+
+namespace {
+
+/// 构造带容量上限的 JSON 配置
+std::string MakeCapacityConfig(const std::string& dir, uint64_t max_total_bytes,
+                               double high_watermark, double low_watermark) {
+    json j;
+    j["root_path"] = dir;
+    j["max_total_bytes"] = max_total_bytes;
+    j["high_watermark"] = high_watermark;
+    j["low_watermark"] = low_watermark;
+    return j.dump();
+}
+
+/// 等待后台淘汰使总量降到目标以下
+bool WaitForUsageAtMost(MyCache& cache, uint64_t bytes) {
+    for (int i = 0; i < 200; ++i) {
+        if (cache.GetUsage().total_bytes <= bytes) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+}  // namespace
+
+/// 测试：非法水位配置被拒绝
+TEST(MyCache_Capacity, InvalidWatermarksRejected) {
+    auto dir = MakeTestDir("cap_invalid");
+    {
+        MyCache cache;
+        auto r = cache.Init(MakeCapacityConfig(dir, 1000, 0.5, 0.8));
+        EXPECT_EQ(r.code, CacheErrorCode::InvalidArgument);
+        EXPECT_EQ(cache.Status(), CacheStatus::Error);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：超过高水位后按 LRU 淘汰到低水位，最近访问的文件保留
+TEST(MyCache_Capacity, EvictsLeastRecentlyUsedToLowWatermark) {
+    auto dir = MakeTestDir("cap_lru");
+    {
+        MyCache cache;
+        ASSERT_TRUE(cache.Init(MakeCapacityConfig(dir, 1000, 0.9, 0.5)).Ok());
+
+        std::vector<uint8_t> data(100, 0x11);
+        for (int i = 0; i < 8; ++i) {
+            ASSERT_TRUE(cache.SaveFile("f" + std::to_string(i) + ".bin", data).Ok());
+        }
+        // 访问最早的文件，使其成为最近使用
+        ASSERT_TRUE(cache.GetFullPath("f0.bin").Ok());
+
+        // 第 10 个文件使总量达到 1000 > 900，触发淘汰到 500 以下
+        ASSERT_TRUE(cache.SaveFile("f8.bin", data).Ok());
+        ASSERT_TRUE(cache.SaveFile("f9.bin", data).Ok());
+        ASSERT_TRUE(WaitForUsageAtMost(cache, 500));
+
+        auto usage = cache.GetUsage();
+        EXPECT_EQ(usage.file_count, 5u);
+        EXPECT_EQ(usage.evicted_files, 5u);
+        EXPECT_EQ(usage.evicted_bytes, 500u);
+
+        EXPECT_TRUE(cache.Exists("f0.bin").value);
+        EXPECT_TRUE(cache.Exists("f9.bin").value);
+        EXPECT_FALSE(cache.Exists("f1.bin").value);
+        EXPECT_FALSE(std::filesystem::exists(std::filesystem::path(dir) / "f1.bin"));
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：多个线程并发读取时淘汰照常进行，持续被读取的文件保留
+TEST(MyCache_Capacity, ConcurrentReadersKeepHotFiles) {
+    auto dir = MakeTestDir("cap_readers");
+    {
+        MyCache cache;
+        ASSERT_TRUE(cache.Init(MakeCapacityConfig(dir, 1000, 0.9, 0.5)).Ok());
+
+        std::vector<uint8_t> data(100, 0x33);
+        ASSERT_TRUE(cache.SaveFile("hot.bin", data).Ok());
+        for (int i = 0; i < 7; ++i) {
+            ASSERT_TRUE(cache.SaveFile("c" + std::to_string(i) + ".bin", data).Ok());
+        }
+
+        std::atomic<bool> stop{false};
+        std::atomic<int> failures{0};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&] {
+                while (!stop.load()) {
+                    if (!cache.GetFullPath("hot.bin").Ok()) failures.fetch_add(1);
+                }
+            });
+        }
+
+        ASSERT_TRUE(cache.SaveFile("c7.bin", data).Ok());
+        ASSERT_TRUE(cache.SaveFile("c8.bin", data).Ok());
+        EXPECT_TRUE(WaitForUsageAtMost(cache, 500));
+        stop.store(true);
+        for (auto& r : readers) r.join();
+
+        EXPECT_EQ(failures.load(), 0);
+        EXPECT_TRUE(cache.Exists("hot.bin").value);
+        EXPECT_TRUE(cache.Exists("c8.bin").value);
+        EXPECT_FALSE(cache.Exists("c0.bin").value);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：固定文件不参与淘汰
+TEST(MyCache_Capacity, PinnedFilesAreNeverEvicted) {
+    auto dir = MakeTestDir("cap_pin");
+    {
+        MyCache cache;
+        ASSERT_TRUE(cache.Init(MakeCapacityConfig(dir, 1000, 0.9, 0.5)).Ok());
+
+        std::vector<uint8_t> data(100, 0x22);
+        ASSERT_TRUE(cache.SaveFile("keep.bin", data).Ok());
+        ASSERT_TRUE(cache.SetPinned("keep.bin", true).Ok());
+        EXPECT_EQ(cache.SetPinned("missing.bin", true).code, CacheErrorCode::FileNotFound);
+
+        for (int i = 0; i < 9; ++i) {
+            ASSERT_TRUE(cache.SaveFile("g" + std::to_string(i) + ".bin", data).Ok());
+        }
+        ASSERT_TRUE(WaitForUsageAtMost(cache, 500));
+
+        EXPECT_TRUE(cache.Exists("keep.bin").value);
+        EXPECT_EQ(cache.GetUsage().pinned_count, 1u);
+
+        // 取消固定后可正常删除，统计同步更新
+        ASSERT_TRUE(cache.SetPinned("keep.bin", false).Ok());
+        ASSERT_TRUE(cache.DeleteFile("keep.bin").Ok());
+        EXPECT_EQ(cache.GetUsage().pinned_count, 0u);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：启动时已超出容量的目录在 Init 后被淘汰，最旧的文件先淘汰
+TEST(MyCache_Capacity, EvictsPreexistingFilesOnInit) {
+    auto dir = MakeTestDir("cap_init");
+    std::filesystem::create_directories(dir);
+    for (int i = 0; i < 10; ++i) {
+        auto path = std::filesystem::path(dir) / ("old" + std::to_string(i) + ".bin");
+        std::ofstream(path, std::ios::binary) << std::string(100, 'x');
+        std::filesystem::last_write_time(
+            path, std::filesystem::file_time_type::clock::now() - std::chrono::hours(10 - i));
+    }
+    {
+        MyCache cache;
+        ASSERT_TRUE(cache.Init(MakeCapacityConfig(dir, 1000, 0.9, 0.5)).Ok());
+        ASSERT_TRUE(WaitForUsageAtMost(cache, 500));
+        EXPECT_FALSE(cache.Exists("old0.bin").value);
+        EXPECT_TRUE(cache.Exists("old9.bin").value);
+    }
+    CleanupDir(dir);
+}
+
+// ============================================================================
+// 内容寻址去重测试
+// ============================================================================
+
+namespace {
+
+/// 构造开启去重的 JSON 配置
+std::string MakeDedupConfig(const std::string& dir) {
+    json j;
+    j["root_path"] = dir;
+    j["dedup"] = true;
+    return j.dump();
+}
+
+/// 读取整个文件内容
+std::string ReadAll(const std::filesystem::path& path) {
+    std::ifstream ifs(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+}
+
+/// 统计内容块目录中的文件数
+size_t CountBlobFiles(const std::string& dir) {
+    size_t count = 0;
+    std::error_code ec;
+    for (const auto& e : std::filesystem::recursive_directory_iterator(
+             std::filesystem::path(dir) / MyCache::kBlobDirName, ec)) {
+        if (e.is_regular_file()) ++count;
+    }
+    return count;
+}
+
+}  // namespace
+
+/// 测试：SHA-256 标准向量，分块输入与硬件/可移植实现结果一致
+TEST(MyCache_Dedup, Sha256MatchesKnownVectorsAcrossChunking) {
+    Sha256 empty;
+    EXPECT_EQ(empty.HexDigest(), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+
+    const std::string abc = "abc";
+    Sha256 h;
+    h.Update(reinterpret_cast<const uint8_t*>(abc.data()), abc.size());
+    EXPECT_EQ(h.HexDigest(), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+    std::vector<uint8_t> data(10000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i * 31 + 7);
+
+    Sha256 one_shot(false);
+    one_shot.Update(data.data(), data.size());
+    Sha256 chunked;
+    for (size_t off = 0; off < data.size(); off += 97) {
+        chunked.Update(data.data() + off, std::min<size_t>(97, data.size() - off));
+    }
+    EXPECT_EQ(chunked.HexDigest(), one_shot.HexDigest());
+}
+
+/// 测试：相同内容只保存一份，多个文件名共享内容块
+TEST(MyCache_Dedup, IdenticalContentStoredOnce) {
+    auto dir = MakeTestDir("dedup_once");
+    {
+        MyCache cache;
+        ASSERT_TRUE(cache.Init(MakeDedupConfig(dir)).Ok());
+
+        const std::string payload(4096, 'z');
+        ASSERT_TRUE(cache.SaveFile("a.bin", ToBytes(payload)).Ok());
+        ASSERT_TRUE(cache.SaveFile("snap/b.bin", ToBytes(payload)).Ok());
+
+        auto usage = cache.GetUsage();
+        EXPECT_EQ(usage.file_count, 2u);
+        EXPECT_EQ(usage.total_bytes, 8192u);
+        EXPECT_EQ(usage.stored_bytes, 4096u);
+        EXPECT_EQ(usage.blob_count, 1u);
+        EXPECT_EQ(usage.dedup_hits, 1u);
+
+        auto path_b = std::filesystem::path(dir) / "snap/b.bin";
+        EXPECT_EQ(ReadAll(path_b), payload);
+        EXPECT_EQ(std::filesystem::hard_link_count(path_b), 3u);  // 两个文件名 + 内容块
+
+        // 内容块目录不出现在文件列表中
+        auto list = cache.GetAllFileList();
+        ASSERT_TRUE(list.Ok());
+        EXPECT_EQ(list.value.size(), 2u);
+        EXPECT_EQ(cache.GetFileList(MyCache::kBlobDirName).code, CacheErrorCode::InvalidArgument);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：暂存目录与内容块目录不能通过 GetFullPath / DeleteFile 访问
+TEST(MyCache_Dedup, InternalPathsAreNotAccessible) {
+    auto dir = MakeTestDir("dedup_internal");
+    {
+        MyCache cache;
+        ASSERT_TRUE(cache.Init(MakeDedupConfig(dir)).Ok());
+        const std::string payload(1024, 'q');
+        ASSERT_TRUE(cache.SaveFile("a.bin", ToBytes(payload)).Ok());
+
+        std::string blob_name;
+        for (const auto& e : std::filesystem::recursive_directory_iterator(
+                 std::filesystem::path(dir) / MyCache::kBlobDirName)) {
+            if (e.is_regular_file()) {
+                blob_name = std::filesystem::relative(e.path(), dir).string();
+            }
+        }
+        ASSERT_FALSE(blob_name.empty());
+        EXPECT_EQ(cache.GetFullPath(blob_name).code, CacheErrorCode::FileNotFound);
+        EXPECT_EQ(cache.DeleteFile(blob_name).code, CacheErrorCode::FileNotFound);
+        EXPECT_EQ(cache.GetFullPath(std::string(MyCache::kStagingDirName) + "/upload-x").code,
+                  CacheErrorCode::FileNotFound);
+        EXPECT_EQ(CountBlobFiles(dir), 1u);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：删除文件名只在最后一个引用消失时释放内容块
+TEST(MyCache_Dedup, DeleteReleasesBlobWithLastName) {
+    auto dir = MakeTestDir("dedup_delete");
+    {
+        MyCache cache;
+        ASSERT_TRUE(cache.Init(MakeDedupConfig(dir)).Ok());
+
+        ASSERT_TRUE(cache.SaveFile("a.txt", ToBytes("same")).Ok());
+        ASSERT_TRUE(cache.SaveFile("b.txt", ToBytes("same")).Ok());
+
+        ASSERT_TRUE(cache.DeleteFile("a.txt").Ok());
+        EXPECT_EQ(cache.GetUsage().blob_count, 1u);
+        EXPECT_EQ(CountBlobFiles(dir), 1u);
+        EXPECT_EQ(ReadAll(std::filesystem::path(dir) / "b.txt"), "same");
+
+        ASSERT_TRUE(cache.DeleteFile("b.txt").Ok());
+        EXPECT_EQ(cache.GetUsage().blob_count, 0u);
+        EXPECT_EQ(cache.GetUsage().stored_bytes, 0u);
+        EXPECT_EQ(CountBlobFiles(dir), 0u);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：去重命中不修改共享 inode 的时间，新文件名的修改时间单独记录
+TEST(MyCache_Dedup, HitKeepsOtherNamesModifiedTime) {
+    auto dir = MakeTestDir("dedup_mtime");
+    {
+        MyCache cache;
+        ASSERT_TRUE(cache.Init(MakeDedupConfig(dir)).Ok());
+
+        ASSERT_TRUE(cache.SaveFile("old.txt", ToBytes("same")).Ok());
+        const auto old_path = std::filesystem::path(dir) / "old.txt";
+        const auto past = std::filesystem::file_time_type::clock::now() - std::chrono::hours(2);
+        std::filesystem::last_write_time(old_path, past);
+
+        ASSERT_TRUE(cache.SaveFile("new.txt", ToBytes("same")).Ok());
+        EXPECT_EQ(std::filesystem::last_write_time(old_path), past);
+
+        FileListQuery query;
+        query.order = FileListOrder::ByModifiedDesc;
+        auto r = cache.GetFileList(query);
+        ASSERT_TRUE(r.Ok());
+        ASSERT_EQ(r.value.files.size(), 2u);
+        EXPECT_EQ(r.value.files[0].name, "new.txt");
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：GetWritablePath 对共享内容块的文件名写时复制，原地修改不影响其他文件名
+TEST(MyCache_Dedup, WritablePathBreaksSharedLink) {
+    auto dir = MakeTestDir("dedup_cow");
+    {
+        MyCache cache;
+        ASSERT_TRUE(cache.Init(MakeDedupConfig(dir)).Ok());
+
+        ASSERT_TRUE(cache.SaveFile("a.txt", ToBytes("same")).Ok());
+        ASSERT_TRUE(cache.SaveFile("b.txt", ToBytes("same")).Ok());
+        EXPECT_EQ(cache.GetWritablePath("missing.txt").code, CacheErrorCode::FileNotFound);
+
+        auto path = cache.GetWritablePath("a.txt");
+        ASSERT_TRUE(path.Ok());
+        std::ofstream(path.value, std::ios::binary | std::ios::trunc) << "edited";
+
+        EXPECT_EQ(ReadAll(std::filesystem::path(dir) / "a.txt"), "edited");
+        EXPECT_EQ(ReadAll(std::filesystem::path(dir) / "b.txt"), "same");
+        auto usage = cache.GetUsage();
+        EXPECT_EQ(usage.blob_count, 1u);
+        EXPECT_EQ(usage.stored_bytes, 8u);  // 独立副本 4 字节 + 内容块 4 字节
+
+        // 普通文件直接返回原路径
+        ASSERT_TRUE(cache.GetWritablePath("a.txt").Ok());
+        EXPECT_EQ(cache.GetUsage().stored_bytes, 8u);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：覆盖写入释放旧内容块，重复写入相同内容不产生新内容块
+TEST(MyCache_Dedup, OverwriteSwitchesBlob) {
+    auto dir = MakeTestDir("dedup_overwrite");
+    {
+        MyCache cache;
+        ASSERT_TRUE(cache.Init(MakeDedupConfig(dir)).Ok());
+
+        ASSERT_TRUE(cache.SaveFile("cfg.json", ToBytes("v1")).Ok());
+        ASSERT_TRUE(cache.SaveFile("cfg.json", ToBytes("v1")).Ok());
+        EXPECT_EQ(cache.GetUsage().blob_count, 1u);
+
+        ASSERT_TRUE(cache.SaveFile("cfg.json", ToBytes("v2-longer")).Ok());
+        auto usage = cache.GetUsage();
+        EXPECT_EQ(usage.blob_count, 1u);
+        EXPECT_EQ(usage.stored_bytes, 9u);
+        EXPECT_EQ(CountBlobFiles(dir), 1u);
+        EXPECT_EQ(ReadAll(std::filesystem::path(dir) / "cfg.json"), "v2-longer");
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：重启后根据硬链接重建引用计数，并回收无引用的内容块
+TEST(MyCache_Dedup, RebuildsReferencesOnInit) {
+    auto dir = MakeTestDir("dedup_rebuild");
+    {
+        MyCache cache;
+        ASSERT_TRUE(cache.Init(MakeDedupConfig(dir)).Ok());
+        ASSERT_TRUE(cache.SaveFile("a.txt", ToBytes("shared")).Ok());
+        ASSERT_TRUE(cache.SaveFile("b.txt", ToBytes("shared")).Ok());
+        ASSERT_TRUE(cache.SaveFile("c.txt", ToBytes("orphan")).Ok());
+    }
+    // 模拟缓存停止期间外部删除了文件，留下无引用的内容块
+    std::filesystem::remove(std::filesystem::path(dir) / "c.txt");
+    ASSERT_EQ(CountBlobFiles(dir), 2u);
+    {
+        MyCache cache;
+        ASSERT_TRUE(cache.Init(MakeDedupConfig(dir)).Ok());
+
+        auto usage = cache.GetUsage();
+        EXPECT_EQ(usage.file_count, 2u);
+        EXPECT_EQ(usage.blob_count, 1u);
+        EXPECT_EQ(usage.stored_bytes, 6u);
+        EXPECT_EQ(CountBlobFiles(dir), 1u);
+
+        ASSERT_TRUE(cache.DeleteFile("a.txt").Ok());
+        ASSERT_TRUE(cache.DeleteFile("b.txt").Ok());
+        EXPECT_EQ(CountBlobFiles(dir), 0u);
+    }
+    CleanupDir(dir);
+}
+
 // ============================================================================
 // MyCacheProvider 单例测试
 // ============================================================================
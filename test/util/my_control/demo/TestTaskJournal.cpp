@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "MyData.h"
+#include "TaskJournal.h"
+#include "TaskQueue.h"
+
+using namespace my_control;
+
+static std::string JournalPath() {
+  return "/tmp/fast_cpp_server_test_task_journal.wal";
+}
+
+static void RemoveJournal(const std::string& path) {
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  std::filesystem::remove(path + ".compact", ec);
+}
+
+static my_data::Task MakeTask(const std::string& id) {
+  my_data::Task t;
+  t.task_id = id;
+  t.device_id = "dev-1";
+  t.capability = "navigate";
+  t.action = "set";
+  t.params = {{"depth", 12}};
+  return t;
+}
+
+TEST(MyControl_TaskJournal, ReplaysUnfinishedTasksInOrder) {
+  RemoveJournal(JournalPath());
+
+  TaskJournalOptions opts;
+  opts.path = JournalPath();
+  {
+    TaskJournal j(opts);
+    std::string err;
+    ASSERT_TRUE(j.Open(&err)) << err;
+
+    ASSERT_NE(j.AppendEnqueue("q-a", MakeTask("t1"), &err), 0u);
+    ASSERT_NE(j.AppendEnqueue("q-a", MakeTask("t2"), &err), 0u);
+    ASSERT_NE(j.AppendEnqueue("q-b", MakeTask("t3"), &err), 0u);
+    j.AppendDequeue("q-a", "t1");
+    j.AppendComplete("q-a", "t1");
+    j.AppendDequeue("q-a", "t2");  // 已出队未完成：重启后应重新执行
+    const auto seq = j.AppendEnqueue("q-a", MakeTask("t4"), &err);
+    ASSERT_TRUE(j.WaitDurable(seq, &err)) << err;
+    EXPECT_EQ(j.Stats().live_tasks, 3u);
+  }
+
+  TaskJournal j(opts);
+  std::string err;
+  ASSERT_TRUE(j.Open(&err)) << err;
+  EXPECT_EQ(j.Stats().recovered, 3u);
+
+  auto a = j.TakeRecovered("q-a");
+  ASSERT_EQ(a.size(), 2u);
+  EXPECT_EQ(a[0].task_id, "t2");
+  EXPECT_EQ(a[1].task_id, "t4");
+  EXPECT_EQ(a[0].params.value("depth", 0), 12);
+
+  auto b = j.TakeRecovered("q-b");
+  ASSERT_EQ(b.size(), 1u);
+  EXPECT_EQ(b[0].task_id, "t3");
+  EXPECT_TRUE(j.TakeRecovered("q-a").empty());
+}
+
+TEST(MyControl_TaskJournal, TruncatesTornTail) {
+  RemoveJournal(JournalPath());
+
+  TaskJournalOptions opts;
+  opts.path = JournalPath();
+  std::uintmax_t good_size = 0;
+  {
+    TaskJournal j(opts);
+    std::string err;
+    ASSERT_TRUE(j.Open(&err)) << err;
+    ASSERT_TRUE(j.WaitDurable(j.AppendEnqueue("q", MakeTask("t1"), &err), &err)) << err;
+  }
+  good_size = std::filesystem::file_size(JournalPath());
+
+  // 模拟崩溃时写了一半的记录
+  {
+    std::ofstream out(JournalPath(), std::ios::binary | std::ios::app);
+    const char partial[] = {0x40, 0x00, 0x00, 0x00, 0x12, 0x34};
+    out.write(partial, sizeof(partial));
+  }
+
+  TaskJournal j(opts);
+  std::string err;
+  ASSERT_TRUE(j.Open(&err)) << err;
+  EXPECT_EQ(std::filesystem::file_size(JournalPath()), good_size);
+  auto tasks = j.TakeRecovered("q");
+  ASSERT_EQ(tasks.size(), 1u);
+  EXPECT_EQ(tasks[0].task_id, "t1");
+
+  // 截断后继续追加仍可回放
+  ASSERT_TRUE(j.WaitDurable(j.AppendEnqueue("q", MakeTask("t2"), &err), &err)) << err;
+  j.Close();
+  TaskJournal j2(opts);
+  ASSERT_TRUE(j2.Open(&err)) << err;
+  EXPECT_EQ(j2.TakeRecovered("q").size(), 2u);
+}
+
+TEST(MyControl_TaskJournal, ShortHeaderIsTreatedAsEmpty) {
+  RemoveJournal(JournalPath());
+
+  // 模拟创建日志写文件头时崩溃：只留下不足 8 字节的残缺文件头
+  {
+    std::ofstream out(JournalPath(), std::ios::binary);
+    out.write("MYT", 3);
+  }
+
+  TaskJournalOptions opts;
+  opts.path = JournalPath();
+  {
+    TaskJournal j(opts);
+    std::string err;
+    ASSERT_TRUE(j.Open(&err)) << err;
+    EXPECT_EQ(j.Stats().recovered, 0u);
+    ASSERT_TRUE(j.WaitDurable(j.AppendEnqueue("q", MakeTask("t1"), &err), &err)) << err;
+  }
+
+  TaskJournal j(opts);
+  std::string err;
+  ASSERT_TRUE(j.Open(&err)) << err;
+  auto tasks = j.TakeRecovered("q");
+  ASSERT_EQ(tasks.size(), 1u);
+  EXPECT_EQ(tasks[0].task_id, "t1");
+}
+
+TEST(MyControl_TaskJournal, CompactionKeepsOnlyLiveTasks) {
+  RemoveJournal(JournalPath());
+
+  TaskJournalOptions opts;
+  opts.path = JournalPath();
+  opts.compact_min_bytes = 1;
+  opts.compact_live_ratio = 0.5;
+  {
+    TaskJournal j(opts);
+    std::string err;
+    ASSERT_TRUE(j.Open(&err)) << err;
+    std::uint64_t seq = 0;
+    for (int i = 0; i < 200; ++i) {
+      const std::string id = "t" + std::to_string(i);
+      seq = j.AppendEnqueue("q", MakeTask(id), &err);
+      ASSERT_NE(seq, 0u) << err;
+      if (i % 10 != 0) {
+        j.AppendDequeue("q", id);
+        seq = j.AppendComplete("q", id);
+      }
+    }
+    ASSERT_TRUE(j.WaitDurable(seq, &err)) << err;
+    const auto before = std::filesystem::file_size(JournalPath());
+
+    j.RequestCompaction();
+    for (int i = 0; i < 200 && j.Stats().compactions == 0; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(j.Stats().compactions, 1u);
+    EXPECT_LT(std::filesystem::file_size(JournalPath()), before / 4);
+    EXPECT_EQ(j.Stats().live_tasks, 20u);
+
+    // 压缩后追加写入新文件
+    ASSERT_TRUE(j.WaitDurable(j.AppendComplete("q", "t0"), &err)) << err;
+  }
+
+  TaskJournal j(opts);
+  std::string err;
+  ASSERT_TRUE(j.Open(&err)) << err;
+  auto tasks = j.TakeRecovered("q");
+  ASSERT_EQ(tasks.size(), 19u);
+  EXPECT_EQ(tasks.front().task_id, "t10");
+  EXPECT_EQ(tasks.back().task_id, "t190");
+}
+
+TEST(MyControl_TaskJournal, TaskQueueSurvivesRestart) {
+  RemoveJournal(JournalPath());
+
+  TaskJournalOptions opts;
+  opts.path = JournalPath();
+  {
+    auto journal = std::make_shared<TaskJournal>(opts);
+    std::string err;
+    ASSERT_TRUE(journal->Open(&err)) << err;
+
+    TaskQueue q("queue-dev-1");
+    q.AttachJournal(journal);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 4; ++p) {
+      producers.emplace_back([&q, p] {
+        for (int i = 0; i < 25; ++i) {
+          EXPECT_TRUE(q.Push(MakeTask("p" + std::to_string(p) + "-" + std::to_string(i))));
+        }
+      });
+    }
+    for (auto& t : producers) t.join();
+    ASSERT_EQ(q.Size(), 100u);
+
+    for (int i = 0; i < 60; ++i) {
+      my_data::Task out;
+      ASSERT_TRUE(q.PopBlocking(out, 10));
+      q.MarkDone(out);
+    }
+  }
+
+  auto journal = std::make_shared<TaskJournal>(opts);
+  std::string err;
+  ASSERT_TRUE(journal->Open(&err)) << err;
+  TaskQueue q("queue-dev-1");
+  q.AttachJournal(journal);
+  EXPECT_EQ(q.Restore(journal->TakeRecovered(q.Name())), 40u);
+  EXPECT_EQ(q.Size(), 40u);
+}
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 #include "MyData.h"
 #include "MyLog.h"
 #include "TaskQueue.h"
@@ -32,4 +35,160 @@ TEST(MyControl_TaskQueue, ShutdownWakeUp) {
   bool ok = q.PopBlocking(out, 10);
   EXPECT_FALSE(ok);
   EXPECT_TRUE(q.IsShutdown());
-}
\ No newline at end of file
+}
+static my_data::Task MakePrioTask(const std::string& id, int priority, my_data::TimestampMs deadline_at_ms = 0) {
+  my_data::Task t;
+  t.task_id = id;
+  t.device_id = "dev-1";
+  t.priority = priority;
+  t.deadline_at_ms = deadline_at_ms;
+  return t;
+}
+
+TEST(MyControl_TaskQueue, FifoModeIgnoresPriority) {
+  TaskQueue q("test-queue-fifo");
+  q.Push(MakePrioTask("low", 0));
+  q.Push(MakePrioTask("high", 9));
+
+  my_data::Task out;
+  ASSERT_TRUE(q.PopBlocking(out, 10));
+  EXPECT_EQ(out.task_id, "low");
+  ASSERT_TRUE(q.PopBlocking(out, 10));
+  EXPECT_EQ(out.task_id, "high");
+}
+
+TEST(MyControl_TaskQueue, PriorityModeOrdersByPriorityThenDeadline) {
+  TaskQueueOptions opts;
+  opts.mode = TaskQueueMode::Priority;
+  TaskQueue q("test-queue-prio", opts);
+
+  const auto now = my_data::NowMs();
+  for (int i = 0; i < 50; ++i) {
+    q.Push(MakePrioTask("bulk-" + std::to_string(i), 0));
+  }
+  q.Push(MakePrioTask("urgent-late", 10, now + 60000));
+  q.Push(MakePrioTask("urgent-none", 10));
+  q.Push(MakePrioTask("urgent-soon", 10, now + 1000));
+  q.Push(MakePrioTask("high", 5));
+
+  std::vector<std::string> order;
+  my_data::Task out;
+  while (q.PopBlocking(out, 0)) {
+    order.push_back(out.task_id);
+  }
+  ASSERT_EQ(order.size(), 54u);
+  EXPECT_EQ(order[0], "urgent-soon");
+  EXPECT_EQ(order[1], "urgent-late");
+  EXPECT_EQ(order[2], "urgent-none");
+  EXPECT_EQ(order[3], "high");
+  // 同优先级保持入队顺序
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_EQ(order[4 + i], "bulk-" + std::to_string(i));
+  }
+
+  const auto st = q.Stats();
+  EXPECT_EQ(st.size, 0u);
+  EXPECT_EQ(st.by_priority.at(0).popped, 50u);
+  EXPECT_EQ(st.by_priority.at(10).popped, 3u);
+}
+
+TEST(MyControl_TaskQueue, ExpiredTasksAreCancelledAtDequeue) {
+  TaskQueueOptions opts;
+  opts.mode = TaskQueueMode::Priority;
+  TaskQueue q("test-queue-expire", opts);
+
+  std::vector<std::pair<std::string, my_data::TaskState>> cancelled;
+  std::string reason;
+  q.SetExpiredCallback([&](const my_data::Task& t, const my_data::TaskResult& r) {
+    cancelled.emplace_back(t.task_id, t.state);
+    reason = r.output.value("reason", "");
+    EXPECT_EQ(r.code, my_data::ErrorCode::Timeout);
+  });
+
+  const auto now = my_data::NowMs();
+  q.Push(MakePrioTask("expired-1", 10, now - 5));
+  q.Push(MakePrioTask("expired-2", 7, now - 1));
+  q.Push(MakePrioTask("alive", 1, now + 60000));
+
+  my_data::Task out;
+  ASSERT_TRUE(q.PopBlocking(out, 10));
+  EXPECT_EQ(out.task_id, "alive");
+  ASSERT_EQ(cancelled.size(), 2u);
+  EXPECT_EQ(cancelled[0].first, "expired-1");
+  EXPECT_EQ(cancelled[0].second, my_data::TaskState::Cancelled);
+  EXPECT_EQ(reason, "deadline_exceeded");
+
+  // 只剩过期任务时：上报后继续等待直到超时
+  q.Push(MakePrioTask("expired-3", 0, now - 1));
+  EXPECT_FALSE(q.PopBlocking(out, 20));
+  EXPECT_EQ(cancelled.size(), 3u);
+  EXPECT_EQ(q.Size(), 0u);
+  EXPECT_EQ(q.Stats().by_priority.at(10).expired, 1u);
+}
+
+TEST(MyControl_TaskQueue, PushBatchKeepsOrderAndRejectsAfterShutdown) {
+  my_control::TaskQueue q("queue-batch");
+
+  std::vector<my_data::Task> batch;
+  for (int i = 0; i < 5; ++i) {
+    batch.push_back(MakePrioTask("b" + std::to_string(i), 0));
+  }
+  std::string err;
+  ASSERT_TRUE(q.PushBatch(std::move(batch), &err)) << err;
+  EXPECT_EQ(q.Size(), 5u);
+
+  for (int i = 0; i < 5; ++i) {
+    my_data::Task out;
+    ASSERT_TRUE(q.PopBlocking(out, 10));
+    EXPECT_EQ(out.task_id, "b" + std::to_string(i));
+  }
+
+  q.Shutdown();
+  std::vector<my_data::Task> late;
+  late.push_back(MakePrioTask("late", 0));
+  EXPECT_FALSE(q.PushBatch(std::move(late), &err));
+  EXPECT_EQ(err, "queue shutdown");
+  EXPECT_EQ(q.Size(), 0u);
+}
+
+TEST(MyControl_TaskQueue, VersionChangesOnlyWithQueueState) {
+  my_control::TaskQueue q("queue-version");
+  const auto v0 = q.Version();
+  EXPECT_EQ(q.Version(), v0);
+
+  ASSERT_TRUE(q.Push(MakePrioTask("v1", 0)));
+  const auto v1 = q.Version();
+  EXPECT_GT(v1, v0);
+  EXPECT_EQ(q.Size(), 1u);
+  EXPECT_EQ(q.Version(), v1);  // 只读不改变版本
+
+  my_data::Task out;
+  ASSERT_TRUE(q.PopBlocking(out, 10));
+  EXPECT_GT(q.Version(), v1);
+  EXPECT_EQ(q.Size(), 0u);
+
+  const auto v2 = q.Version();
+  q.Shutdown();
+  EXPECT_GT(q.Version(), v2);
+}
+
+TEST(MyControl_TaskQueue, WaitStatsClampOutOfRangePriorities) {
+  TaskQueueOptions opts;
+  opts.mode = TaskQueueMode::Priority;
+  TaskQueue q("test-queue-stats-clamp", opts);
+
+  const auto now = my_data::NowMs();
+  for (int i = 0; i < 64; ++i) {
+    q.Push(MakePrioTask("hi-" + std::to_string(i), 1000 + i, now + 60000));
+    q.Push(MakePrioTask("lo-" + std::to_string(i), -1000 - i, now + 60000));
+  }
+
+  my_data::Task out;
+  while (q.TryPop(out)) {}
+
+  // 客户端给出的 priority 不会让统计表无限增长
+  const auto st = q.Stats();
+  ASSERT_EQ(st.by_priority.size(), 2u);
+  EXPECT_EQ(st.by_priority.at(TaskQueueStats::kWaitStatsMaxPriority).popped, 64u);
+  EXPECT_EQ(st.by_priority.at(TaskQueueStats::kWaitStatsMinPriority).popped, 64u);
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "IControl.h"
+#include "MyData.h"
+#include "MyLog.h"
+#include "TaskQueue.h"
+#include "WorkflowScheduler.h"
+#include "demo/Workflow.h"
+
+using namespace my_control;
+using namespace my_control::demo;
+
+namespace {
+
+// 模拟“发出请求 -> 等待设备应答”的执行器：pooled 模式下用定时器等待，不占用线程
+class FakeIoControl : public IControl {
+public:
+  explicit FakeIoControl(int latency_ms) : latency_ms_(latency_ms) {}
+
+  bool Init(const nlohmann::json&, std::string*) override { return true; }
+
+  my_data::TaskResult DoTask(const my_data::Task& task) override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(latency_ms_));
+    return MakeResult(task);
+  }
+
+  void DoTaskAsync(const my_data::Task& task, DoneCallback done) override {
+    WorkflowScheduler::GetInstance().RunAfter(latency_ms_, [task, done]() { done(MakeResult(task)); });
+  }
+
+  std::string Name() const override { return "FakeIoControl"; }
+
+private:
+  static my_data::TaskResult MakeResult(const my_data::Task&) {
+    my_data::TaskResult r;
+    r.code = my_data::ErrorCode::Ok;
+    return r;
+  }
+
+  int latency_ms_;
+};
+
+// 单个虚拟设备：独立队列 + 执行器 + Workflow，记录完成顺序是否与入队顺序一致
+struct VirtualDevice {
+  VirtualDevice(const std::string& id, int latency_ms, WorkflowMode mode)
+      : queue("q-" + id), control(latency_ms), workflow("wf-" + id, queue, control, mode) {
+    workflow.SetFinishCallback([this](const my_data::Task& task, const my_data::TaskResult&) {
+      const int seq = std::stoi(task.task_id.substr(task.task_id.rfind('-') + 1));
+      if (seq != next_seq) in_order = false;
+      next_seq = seq + 1;
+      finished.fetch_add(1);
+    });
+  }
+
+  TaskQueue queue;
+  FakeIoControl control;
+  Workflow workflow;
+  int next_seq{0};  // 仅在完成回调中访问；同一设备的回调不会并发
+  bool in_order{true};
+  std::atomic<int> finished{0};
+};
+
+int EnvInt(const char* name, int def) {
+  const char* v = std::getenv(name);
+  if (!v || !*v) return def;
+  return std::atoi(v);
+}
+
+// 当前进程常驻内存（KB），读取失败返回 0
+long ReadRssKb() {
+  std::ifstream in("/proc/self/status");
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.rfind("VmRSS:", 0) == 0) return std::atol(line.c_str() + 6);
+  }
+  return 0;
+}
+
+struct ScaleReport {
+  double seconds{0};
+  double tasks_per_sec{0};
+  long rss_delta_kb{0};
+  bool all_in_order{true};
+  int finished{0};
+};
+
+ScaleReport RunScale(WorkflowMode mode, int devices, int tasks_per_device, int latency_ms) {
+  const long rss_before = ReadRssKb();
+
+  std::vector<std::unique_ptr<VirtualDevice>> devs;
+  devs.reserve(devices);
+  for (int i = 0; i < devices; ++i) {
+    devs.push_back(std::make_unique<VirtualDevice>("dev-" + std::to_string(i), latency_ms, mode));
+    devs.back()->workflow.Start();
+  }
+  const long rss_started = ReadRssKb();
+
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int n = 0; n < tasks_per_device; ++n) {
+    for (int i = 0; i < devices; ++i) {
+      my_data::Task t;
+      t.task_id = "dev-" + std::to_string(i) + "-" + std::to_string(n);
+      t.device_id = "dev-" + std::to_string(i);
+      devs[i]->queue.Push(t);
+    }
+  }
+
+  const int total = devices * tasks_per_device;
+  const auto deadline = t0 + std::chrono::seconds(60);
+  ScaleReport rep;
+  while (std::chrono::steady_clock::now() < deadline) {
+    int done = 0;
+    for (auto& d : devs) done += d->finished.load();
+    rep.finished = done;
+    if (done >= total) break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  rep.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  rep.tasks_per_sec = rep.seconds > 0 ? rep.finished / rep.seconds : 0;
+  rep.rss_delta_kb = rss_started - rss_before;
+
+  for (auto& d : devs) {
+    d->queue.Shutdown();
+    d->workflow.Stop();
+  }
+  for (auto& d : devs) {
+    d->workflow.Join();
+    rep.all_in_order = rep.all_in_order && d->in_order;
+  }
+
+  MYLOG_INFO("[WorkflowScale] mode={} devices={} tasks/device={} latency_ms={} -> finished={} in {:.3f}s "
+             "({:.0f} tasks/s), rss_delta={} KB, in_order={}",
+             ToString(mode), devices, tasks_per_device, latency_ms, rep.finished, rep.seconds,
+             rep.tasks_per_sec, rep.rss_delta_kb, rep.all_in_order ? "true" : "false");
+  return rep;
+}
+
+} // namespace
+
+TEST(MyControl_WorkflowScale, ParseMode) {
+  WorkflowMode m = WorkflowMode::Thread;
+  EXPECT_TRUE(ParseWorkflowMode("pooled", &m));
+  EXPECT_EQ(m, WorkflowMode::Pooled);
+  EXPECT_TRUE(ParseWorkflowMode("thread", &m));
+  EXPECT_EQ(m, WorkflowMode::Thread);
+  EXPECT_FALSE(ParseWorkflowMode("fiber", &m));
+}
+
+// 可用环境变量放大规模：WORKFLOW_SCALE_DEVICES / WORKFLOW_SCALE_TASKS / WORKFLOW_SCALE_LATENCY_MS
+TEST(MyControl_WorkflowScale, PooledVirtualDevices) {
+  const int devices = EnvInt("WORKFLOW_SCALE_DEVICES", 1000);
+  const int tasks = EnvInt("WORKFLOW_SCALE_TASKS", 5);
+  const int latency = EnvInt("WORKFLOW_SCALE_LATENCY_MS", 5);
+
+  ScaleReport rep = RunScale(WorkflowMode::Pooled, devices, tasks, latency);
+  EXPECT_EQ(rep.finished, devices * tasks);
+  EXPECT_TRUE(rep.all_in_order);
+
+  // 工作线程数与设备数无关
+  EXPECT_LE(WorkflowScheduler::GetInstance().Stats().workers,
+            static_cast<std::size_t>(std::max(1u, std::thread::hardware_concurrency())));
+
+  RecordProperty("devices", devices);
+  RecordProperty("tasks_per_sec", static_cast<int>(rep.tasks_per_sec));
+  RecordProperty("rss_delta_kb", static_cast<int>(rep.rss_delta_kb));
+}
+
+// 对照：少量设备下 thread 模式与 pooled 模式结果一致
+TEST(MyControl_WorkflowScale, ThreadModeBaseline) {
+  const int devices = 16;
+  ScaleReport thread_rep = RunScale(WorkflowMode::Thread, devices, 5, 2);
+  ScaleReport pooled_rep = RunScale(WorkflowMode::Pooled, devices, 5, 2);
+  EXPECT_EQ(thread_rep.finished, devices * 5);
+  EXPECT_EQ(pooled_rep.finished, devices * 5);
+  EXPECT_TRUE(thread_rep.all_in_order);
+  EXPECT_TRUE(pooled_rep.all_in_order);
+}
+
+// 调度器停止时未到期的定时回调提前执行，pooled Workflow::Join 不会因计数无法归零而挂起
+TEST(MyControl_WorkflowScale, SchedulerStopFiresPendingTimers) {
+  VirtualDevice dev("stop-drain", 60000, WorkflowMode::Pooled);
+  ASSERT_TRUE(dev.workflow.Start());
+
+  my_data::Task task;
+  task.task_id = "stop-drain-0";
+  task.device_id = "stop-drain";
+  ASSERT_TRUE(dev.queue.Push(task));
+
+  // 等任务进入执行（定时器已登记）
+  for (int i = 0; i < 200 && WorkflowScheduler::GetInstance().Stats().timers == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_GE(WorkflowScheduler::GetInstance().Stats().timers, 1u);
+
+  const auto t0 = std::chrono::steady_clock::now();
+  WorkflowScheduler::GetInstance().Stop();
+  dev.workflow.Stop();
+  dev.workflow.Join();
+  const auto elapsed = std::chrono::steady_clock::now() - t0;
+
+  EXPECT_EQ(dev.finished.load(), 1);
+  EXPECT_LT(elapsed, std::chrono::seconds(5));
+  EXPECT_EQ(WorkflowScheduler::GetInstance().Stats().timers, 0u);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "MyData.h"
+
+using namespace my_data;
+
+TEST(MyData_IdUtil, NextId64IsStrictlyIncreasingAcrossThreads) {
+  constexpr int kThreads = 8;
+  constexpr int kPerThread = 20000;
+  std::vector<std::vector<Id64>> per(kThreads);
+
+  std::vector<std::thread> ths;
+  for (int t = 0; t < kThreads; ++t) {
+    ths.emplace_back([&per, t] {
+      per[t].reserve(kPerThread);
+      for (int i = 0; i < kPerThread; ++i) {
+        per[t].push_back(NextId64());
+      }
+    });
+  }
+  for (auto& th : ths) th.join();
+
+  std::vector<Id64> all;
+  for (const auto& v : per) {
+    // 单线程内严格递增
+    EXPECT_TRUE(std::adjacent_find(v.begin(), v.end(), std::greater_equal<Id64>()) == v.end());
+    all.insert(all.end(), v.begin(), v.end());
+  }
+  std::sort(all.begin(), all.end());
+  EXPECT_TRUE(std::adjacent_find(all.begin(), all.end()) == all.end());
+}
+
+TEST(MyData_IdUtil, EmbedsTimestampAndNodeId) {
+  const auto old_node = IdNodeId();
+  SetIdNodeId(37);
+  EXPECT_EQ(IdNodeId(), 37u);
+
+  const TimestampMs before = NowMs();
+  const Id64 id = NextId64();
+  const TimestampMs after = NowMs();
+
+  EXPECT_EQ((id >> 12) & 0x3FF, 37u);
+  EXPECT_EQ(id >> 63, 0u);
+  // 逻辑时钟可能因序号借用而略超前
+  EXPECT_GE(Id64TimestampMs(id), before);
+  EXPECT_LE(Id64TimestampMs(id), after + 100);
+
+  SetIdNodeId(old_node);
+}
+
+TEST(MyData_IdUtil, Base32RoundTripAndOrdering) {
+  const std::vector<Id64> samples = {0ull, 1ull, 31ull, 32ull, 0x7FFFFFFFFFFFFFFFull, NextId64()};
+  for (Id64 v : samples) {
+    const std::string text = EncodeId64(v);
+    EXPECT_EQ(text.size(), 13u);
+    Id64 back = 0;
+    ASSERT_TRUE(DecodeId64(text, &back)) << text;
+    EXPECT_EQ(back, v);
+
+    std::string lower = text;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    ASSERT_TRUE(DecodeId64(lower, &back));
+    EXPECT_EQ(back, v);
+  }
+
+  const Id64 a = NextId64();
+  const Id64 b = NextId64();
+  EXPECT_LT(EncodeId64(a), EncodeId64(b));
+
+  Id64 dummy = 0;
+  EXPECT_FALSE(DecodeId64("", &dummy));
+  EXPECT_FALSE(DecodeId64("0000000000000U", &dummy));
+  EXPECT_FALSE(DecodeId64("000000000000U", &dummy));
+}
+
+TEST(MyData_IdUtil, GenerateIdParsesBack) {
+  const std::string id = GenerateId("task");
+  ASSERT_EQ(id.size(), std::string("task-").size() + 13);
+  EXPECT_EQ(id.rfind("task-", 0), 0u);
+
+  Id64 v = 0;
+  ASSERT_TRUE(ParseGeneratedId(id, &v));
+  EXPECT_EQ("task-" + EncodeId64(v), id);
+
+  EXPECT_FALSE(ParseGeneratedId("task-crud-1", &v));
+  EXPECT_FALSE(ParseGeneratedId("no_dash", &v));
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include <set>
+#include <thread>
+#include <vector>
+#include "MyData.h"
+
+using namespace my_data;
+
+TEST(MyData_Symbol, InternsEqualStringsToSameId) {
+  Symbol a("dev-symbol-1");
+  Symbol b(std::string("dev-symbol-1"));
+  Symbol c("dev-symbol-2");
+
+  EXPECT_EQ(a.id(), b.id());
+  EXPECT_NE(a.id(), c.id());
+  EXPECT_TRUE(a == b);
+  EXPECT_TRUE(a == "dev-symbol-1");
+  EXPECT_TRUE(std::string("dev-symbol-2") == c);
+  EXPECT_EQ(a.str(), "dev-symbol-1");
+  EXPECT_EQ("id=" + a, "id=dev-symbol-1");
+
+  Symbol empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.id(), 0u);
+  EXPECT_TRUE(Symbol("").empty());
+}
+
+TEST(MyData_Symbol, JsonAndStringInterop) {
+  Symbol s("move_to");
+  nlohmann::json j = {{"action", s}};
+  EXPECT_EQ(j["action"], "move_to");
+
+  Symbol back = j["action"].get<Symbol>();
+  EXPECT_EQ(back, s);
+
+  const std::string& ref = s;
+  EXPECT_EQ(ref, "move_to");
+}
+
+TEST(MyData_Symbol, ConcurrentInternIsConsistent) {
+  std::vector<std::vector<Symbol::Id>> ids(4);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([t, &ids] {
+      for (int i = 0; i < 500; ++i) {
+        ids[t].push_back(Symbol("concurrent-" + std::to_string(i)).id());
+      }
+    });
+  }
+  for (auto& th : threads) th.join();
+
+  for (int t = 1; t < 4; ++t) {
+    EXPECT_EQ(ids[t], ids[0]);
+  }
+  std::set<Symbol::Id> unique(ids[0].begin(), ids[0].end());
+  EXPECT_EQ(unique.size(), 500u);
+}
+
+TEST(MyData_Symbol, TaskMoveKeepsFields) {
+  Task t;
+  t.task_id = "task-move";
+  t.device_id = "dev-move";
+  t.action = "start";
+  t.params = nlohmann::json{{"k", 1}};
+
+  Task moved = std::move(t);
+  EXPECT_EQ(moved.device_id, "dev-move");
+  EXPECT_EQ(moved.action, "start");
+  EXPECT_EQ(moved.params.value("k", 0), 1);
+}
+
+// 会把全局驻留表填满，放在本文件最后
+TEST(MyData_Symbol, FallsBackToOwnedStringsWhenTableIsFull) {
+  Symbol early("symbol-before-full");
+  ASSERT_TRUE(early.interned());
+
+  for (std::size_t i = Symbol::InternedCount(); i < Symbol::kMaxInterned; ++i) {
+    Symbol filler("symbol-filler-" + std::to_string(i));
+    ASSERT_TRUE(filler.interned());
+  }
+  EXPECT_EQ(Symbol::InternedCount(), Symbol::kMaxInterned);
+
+  const std::uint64_t fallbacks = Symbol::OwnedFallbackCount();
+  Symbol a(std::string("symbol-after-full"));
+  Symbol b("symbol-after-full");
+  EXPECT_FALSE(a.interned());
+  EXPECT_EQ(a.id(), Symbol::kOwnedId);
+  EXPECT_EQ(a.str(), "symbol-after-full");
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, Symbol("symbol-after-full-2"));
+  EXPECT_EQ(std::hash<Symbol>()(a), std::hash<Symbol>()(b));
+  EXPECT_EQ(Symbol::OwnedFallbackCount(), fallbacks + 3);
+  EXPECT_EQ(Symbol::InternedCount(), Symbol::kMaxInterned);
+
+  // 已驻留的字符串仍返回原句柄
+  Symbol again("symbol-before-full");
+  EXPECT_TRUE(again.interned());
+  EXPECT_EQ(again.id(), early.id());
+
+  Task t;
+  t.action = a;
+  Task copy = t;
+  EXPECT_EQ(copy.action, "symbol-after-full");
+}
+
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "MyData.h"
+
+using namespace my_data;
+
+TEST(MyData_TaskTrace, HistogramPercentilesStayWithinBucket) {
+  LatencyHistogram h;
+  EXPECT_EQ(h.PercentileUs(0.5), 0);
+
+  for (int i = 0; i < 90; ++i) h.Record(100);   // 桶 [64, 128)
+  for (int i = 0; i < 10; ++i) h.Record(5000);  // 桶 [4096, 8192)
+
+  EXPECT_EQ(h.Count(), 100u);
+  EXPECT_EQ(h.MaxUs(), 5000);
+  const auto p50 = h.PercentileUs(0.5);
+  EXPECT_GE(p50, 100);
+  EXPECT_LT(p50, 128);
+  // 落在最大值所在桶时以最大值封顶
+  EXPECT_EQ(h.PercentileUs(0.99), 5000);
+
+  const auto j = h.ToJson();
+  EXPECT_EQ(j["count"].get<int>(), 100);
+  EXPECT_EQ(j["min_us"].get<int>(), 100);
+  EXPECT_EQ(j["buckets"].size(), 2u);
+}
+
+TEST(MyData_TaskTrace, TaskTraceJsonSkipsMissingStages) {
+  TaskTrace t;
+  t.enqueued_us = 1000;
+  t.dequeued_us = 1500;
+  t.exec_start_us = 1600;
+  t.exec_finish_us = 2600;
+
+  const auto j = t.toJson();
+  EXPECT_FALSE(j.contains("normalize_us"));
+  EXPECT_EQ(j["queue_wait_us"].get<int>(), 500);
+  EXPECT_EQ(j["exec_us"].get<int>(), 1000);
+  // 没有 received 时端到端从入队算起
+  EXPECT_EQ(j["end_to_end_us"].get<int>(), 1600);
+}
+
+TEST(MyData_TaskTrace, TracerAggregatesPerKeyAndWritesChromeTrace) {
+  auto& tracer = TaskTracer::GetInstance();
+  tracer.Reset();
+
+  const std::string path = "test_task_trace_chrome.json";
+  std::string err;
+  ASSERT_TRUE(tracer.OpenChromeTrace(path, &err)) << err;
+
+  Task t;
+  t.task_id = "task-trace-1";
+  t.edge_id = "edge-trace";
+  t.device_id = "dev-trace";
+  t.capability = "sensor";
+  t.action = "read";
+  t.trace.received_us = 100;
+  t.trace.normalized_us = 110;
+  t.trace.enqueued_us = 120;
+  t.trace.dequeued_us = 300;
+  t.trace.exec_start_us = 310;
+  t.trace.exec_finish_us = 1310;
+
+  TaskResult ok;
+  TaskResult failed;
+  failed.code = ErrorCode::InternalError;
+  tracer.Record(t, ok);
+  tracer.Record(t, failed);
+
+  Task other = t;
+  other.edge_id = "edge-other";
+  tracer.Record(other, ok);
+
+  const auto snap = tracer.Snapshot("edge-trace");
+  ASSERT_EQ(snap["items"].size(), 1u);
+  const auto& item = snap["items"][0];
+  EXPECT_EQ(item["device_id"], "dev-trace");
+  EXPECT_EQ(item["ok"].get<int>(), 1);
+  EXPECT_EQ(item["failed"].get<int>(), 1);
+  EXPECT_EQ(item["queue_wait"]["max_us"].get<int>(), 180);
+  EXPECT_EQ(item["exec"]["max_us"].get<int>(), 1000);
+  EXPECT_EQ(item["end_to_end"]["max_us"].get<int>(), 1210);
+  EXPECT_EQ(tracer.Snapshot()["items"].size(), 2u);
+
+  tracer.CloseChromeTrace();
+
+  // 关闭后文件是合法 JSON 数组，包含元数据与 X 事件
+  std::ifstream in(path);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  auto events = nlohmann::json::parse(ss.str());
+  ASSERT_TRUE(events.is_array());
+  int spans = 0;
+  for (const auto& e : events) {
+    if (e["ph"] == "X") {
+      ++spans;
+      EXPECT_EQ(e["args"]["task_id"], "task-trace-1");
+    }
+  }
+  EXPECT_EQ(spans, 9);  // 3 次 Record x (normalize, queue_wait, 执行)
+
+  tracer.Reset();
+  EXPECT_TRUE(tracer.Snapshot()["items"].empty());
+  std::remove(path.c_str());
+}
+
+TEST(MyData_TaskTrace, TracerBoundsDistinctKeys) {
+  TaskTracer tracer;
+  Task t;
+  t.edge_id = "edge-bound";
+  t.device_id = "dev-bound";
+  t.capability = "sensor";
+  TaskResult ok;
+
+  const std::size_t extra = 10;
+  for (std::size_t i = 0; i < TaskTracer::kMaxEntries + extra; ++i) {
+    t.action = "act-bound-" + std::to_string(i);
+    tracer.Record(t, ok);
+  }
+
+  const auto snap = tracer.Snapshot();
+  EXPECT_EQ(snap["items"].size(), TaskTracer::kMaxEntries);
+  EXPECT_EQ(snap["overflowed"].get<std::size_t>(), extra + 1);
+  const auto& last = snap["items"][0];  // "<overflow>" 排在所有 edge_id 非空的条目之前
+  EXPECT_EQ(last["action"], "<overflow>");
+  EXPECT_EQ(last["ok"].get<std::size_t>(), extra + 1);
+}
+
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MyData.h"
+
+using namespace my_data;
+
+TEST(MyData_VersionedSnapshot, PublishReplacesValueAndBumpsVersion) {
+  VersionedSnapshot<DeviceStatus> snap;
+  const auto v0 = snap.Version();
+  auto before = snap.Load();
+  ASSERT_TRUE(before);
+  EXPECT_TRUE(before->device_id.empty());
+
+  DeviceStatus st;
+  st.device_id = "dev-snap-1";
+  st.work_state = DeviceWorkState::Busy;
+  snap.Publish(st);
+
+  EXPECT_GT(snap.Version(), v0);
+  auto after = snap.Load();
+  EXPECT_EQ(after->device_id, "dev-snap-1");
+  EXPECT_EQ(after->work_state, DeviceWorkState::Busy);
+  // 已取出的旧快照不受后续发布影响
+  EXPECT_TRUE(before->device_id.empty());
+}
+
+TEST(MyData_VersionedSnapshot, ReadersSeeConsistentValuesUnderConcurrentPublish) {
+  struct Pair {
+    int a{0};
+    int b{0};
+  };
+  VersionedSnapshot<Pair> snap;
+  std::atomic<bool> stop{false};
+  std::atomic<int> torn{0};
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 4; ++r) {
+    readers.emplace_back([&] {
+      while (!stop.load()) {
+        auto p = snap.Load();
+        if (p->a != p->b) torn.fetch_add(1);
+      }
+    });
+  }
+  for (int i = 1; i <= 20000; ++i) {
+    snap.Publish(Pair{i, i});
+  }
+  stop.store(true);
+  for (auto& t : readers) t.join();
+
+  EXPECT_EQ(torn.load(), 0);
+  EXPECT_EQ(snap.Load()->a, 20000);
+  EXPECT_EQ(snap.Version(), 20001u);
+}
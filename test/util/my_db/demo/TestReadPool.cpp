@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <thread>
+
+#include "MyDB.h"
+#include "MyData.h"
+#include "demo/StatusRepository.h"
+#include "sqlite3.h"
+
+using namespace my_db;
+using namespace my_db::demo;
+
+static std::string DbPathReadPool() {
+  return "/tmp/fast_cpp_server_test_read_pool.db";
+}
+
+static void RemoveDbFiles(const std::string& path) {
+  std::error_code ec;
+  for (const char* suffix : {"", "-wal", "-shm"}) {
+    std::filesystem::remove(path + suffix, ec);
+  }
+}
+
+TEST(MyDB_ReadPool, ReadsDoNotWaitForWriterTransaction) {
+  RemoveDbFiles(DbPathReadPool());
+
+  DBConfig cfg;
+  cfg.path = DbPathReadPool();
+  cfg.busy_timeout_ms = 1000;
+  cfg.wal = true;
+  cfg.read_pool_size = 2;
+
+  std::string err;
+  ASSERT_TRUE(MyDB::GetInstance().Init(cfg, &err)) << err;
+  ASSERT_TRUE(MyDB::GetInstance().Migrate(&err)) << err;
+  EXPECT_EQ(MyDB::GetInstance().ReadStats().size, 2u);
+
+  my_data::DeviceStatus ds;
+  ds.device_id = "uuv-r";
+  ASSERT_TRUE(StatusRepository::GetInstance().InsertDeviceSnapshot("edge-r", ds, &err)) << err;
+
+  // 写事务持有写锁期间插入一行但未提交：读端应立即返回，且只看到已提交数据
+  std::promise<void> in_tx;
+  std::promise<void> release_tx;
+  std::thread writer([&] {
+    std::string werr;
+    MyDB::GetInstance().Transaction([&](std::string* txe) -> bool {
+      auto h = MyDB::GetInstance().Prepare(
+          "INSERT INTO device_status_snapshots(edge_id, device_id, ts_ms, status_json) "
+          "VALUES('edge-r', 'uuv-r', 0, '{}');", txe);
+      bool ok = h && sqlite3_step(h.get()) == SQLITE_DONE;
+      in_tx.set_value();
+      release_tx.get_future().wait();
+      return ok;
+    }, &werr);
+  });
+  in_tx.get_future().wait();
+
+  auto t0 = std::chrono::steady_clock::now();
+  std::int64_t cnt = 0;
+  ASSERT_TRUE(StatusRepository::GetInstance().CountDeviceSnapshots("edge-r", "uuv-r", &cnt, &err)) << err;
+  auto elapsed = std::chrono::steady_clock::now() - t0;
+  EXPECT_EQ(cnt, 1);
+  EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+
+  release_tx.set_value();
+  writer.join();
+
+  ASSERT_TRUE(StatusRepository::GetInstance().CountDeviceSnapshots("edge-r", "uuv-r", &cnt, &err)) << err;
+  EXPECT_EQ(cnt, 2);
+
+  MyDB::GetInstance().Close();
+  EXPECT_EQ(MyDB::GetInstance().ReadStats().size, 0u);
+}
+
+TEST(MyDB_ReadPool, LeaseExhaustionAndFallback) {
+  RemoveDbFiles(DbPathReadPool());
+
+  DBConfig cfg;
+  cfg.path = DbPathReadPool();
+  cfg.busy_timeout_ms = 50;
+  cfg.wal = true;
+  cfg.read_pool_size = 1;
+
+  std::string err;
+  ASSERT_TRUE(MyDB::GetInstance().Init(cfg, &err)) << err;
+  {
+    auto a = MyDB::GetInstance().AcquireReader(&err);
+    ASSERT_TRUE(a) << err;
+    auto b = MyDB::GetInstance().AcquireReader(&err);
+    EXPECT_FALSE(b);
+    EXPECT_EQ(err, "read pool exhausted");
+  }
+  auto stats = MyDB::GetInstance().ReadStats();
+  EXPECT_EQ(stats.idle, 1u);
+  EXPECT_EQ(stats.timeouts, 1u);
+  MyDB::GetInstance().Close();
+
+  // 关闭连接池：读路径回退到写连接
+  cfg.read_pool_size = 0;
+  ASSERT_TRUE(MyDB::GetInstance().Init(cfg, &err)) << err;
+  {
+    auto lease = MyDB::GetInstance().AcquireReader(&err);
+    ASSERT_TRUE(lease) << err;
+    EXPECT_EQ(lease.handle(), MyDB::GetInstance().UnsafeHandle());
+  }
+  EXPECT_EQ(MyDB::GetInstance().ReadStats().size, 0u);
+  MyDB::GetInstance().Close();
+}
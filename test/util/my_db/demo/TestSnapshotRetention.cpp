@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <vector>
+
+#include "MyDB.h"
+#include "MyData.h"
+#include "demo/SnapshotRetention.h"
+#include "demo/StatusRepository.h"
+#include "sqlite3.h"
+
+using namespace my_db;
+using namespace my_db::demo;
+
+static std::string DbPathRetention() {
+  return "/tmp/fast_cpp_server_test_retention.db";
+}
+
+static std::int64_t QueryCount(const std::string& sql) {
+  auto& db = MyDB::GetInstance();
+  std::lock_guard<std::mutex> lk(db.Mutex());
+  std::string err;
+  auto h = db.Prepare(sql, &err);
+  EXPECT_TRUE(h) << err;
+  if (!h || sqlite3_step(h.get()) != SQLITE_ROW) return -1;
+  return sqlite3_column_int64(h.get(), 0);
+}
+
+TEST(MyDB_SnapshotRetention, RollsUpThenExpiresRawAndRollups) {
+  std::error_code ec;
+  for (const char* suffix : {"", "-wal", "-shm"}) {
+    std::filesystem::remove(DbPathRetention() + suffix, ec);
+  }
+
+  DBConfig cfg;
+  cfg.path = DbPathRetention();
+  cfg.busy_timeout_ms = 1000;
+  cfg.snapshot_raw_retention_hours = 1;
+  cfg.snapshot_minute_rollup_retention_days = 1;
+  cfg.snapshot_hour_rollup_retention_days = 365;
+  cfg.snapshot_retention_delete_batch = 100;
+
+  std::string err;
+  ASSERT_TRUE(MyDB::GetInstance().Init(cfg, &err)) << err;
+  ASSERT_TRUE(MyDB::GetInstance().Migrate(&err)) << err;
+  EXPECT_EQ(QueryCount("PRAGMA auto_vacuum;"), 2);  // INCREMENTAL
+
+  // 3 小时的原始快照：设备每 10 秒一条，边缘每分钟一条
+  const std::int64_t kHour = 3600 * 1000;
+  std::vector<SnapshotRow> rows;
+  for (std::int64_t ts = 0; ts < 3 * kHour; ts += 10 * 1000) {
+    my_data::DeviceStatus ds;
+    ds.device_id = "uuv-1";
+    ds.queue_depth = (ts / 10000) % 7;
+    ds.conn_state = my_data::DeviceConnState::Online;
+    rows.push_back(SnapshotRow{SnapshotRow::Kind::Device, "edge-1", ds.device_id, ts, ds.toJson().dump()});
+    if (ts % 60000 == 0) {
+      my_data::EdgeStatus es;
+      es.edge_id = "edge-1";
+      es.tasks_pending_total = ts / 60000;
+      rows.push_back(SnapshotRow{SnapshotRow::Kind::Edge, "edge-1", {}, ts, es.toJson().dump()});
+    }
+  }
+  ASSERT_TRUE(StatusRepository::GetInstance().InsertSnapshotBatch(rows, &err)) << err;
+
+  auto& retention = SnapshotRetention::GetInstance();
+  RetentionReport r;
+  ASSERT_TRUE(retention.RunOnce(10 * kHour, &r, &err)) << err;
+
+  // 1080 条设备快照 -> 180 个分钟桶 + 3 个小时桶；180 条边缘快照 -> 180 + 3
+  EXPECT_EQ(QueryCount("SELECT COUNT(1) FROM device_status_rollups WHERE bucket_ms=60000;"), 180);
+  EXPECT_EQ(QueryCount("SELECT COUNT(1) FROM device_status_rollups WHERE bucket_ms=3600000;"), 3);
+  EXPECT_EQ(QueryCount("SELECT SUM(samples) FROM device_status_rollups WHERE bucket_ms=3600000;"), 1080);
+  EXPECT_EQ(QueryCount("SELECT SUM(online_samples) FROM device_status_rollups WHERE bucket_ms=3600000;"), 1080);
+  EXPECT_EQ(QueryCount("SELECT MAX(queue_depth_max) FROM device_status_rollups;"), 6);
+  EXPECT_EQ(QueryCount("SELECT COUNT(1) FROM edge_status_rollups WHERE bucket_ms=60000;"), 180);
+  EXPECT_EQ(QueryCount("SELECT tasks_pending_max FROM edge_status_rollups "
+                       "WHERE bucket_ms=3600000 AND bucket_start_ms=7200000;"), 179);
+  EXPECT_EQ(QueryCount("SELECT json_extract(last_status_json, '$.tasks_pending_total') FROM edge_status_rollups "
+                       "WHERE bucket_ms=3600000 AND bucket_start_ms=0;"), 59);
+  EXPECT_EQ(r.rollup_rows, 180 + 3 + 180 + 3);
+
+  // 原始快照早于 now-1h 且都已汇总 => 全部删除（分批），并回收空闲页
+  EXPECT_EQ(QueryCount("SELECT COUNT(1) FROM device_status_snapshots;"), 0);
+  EXPECT_EQ(QueryCount("SELECT COUNT(1) FROM edge_status_snapshots;"), 0);
+  EXPECT_EQ(r.deleted_raw_rows, 1080 + 180);
+  EXPECT_EQ(r.deleted_rollup_rows, 0);
+  EXPECT_GT(r.vacuumed_pages, 0);
+  EXPECT_EQ(QueryCount("PRAGMA freelist_count;"), 0);
+
+  // 两天后：分钟聚合过期，小时聚合保留；已汇总的区间不会重复汇总
+  ASSERT_TRUE(retention.RunOnce(10 * kHour + 2 * 24 * kHour, &r, &err)) << err;
+  EXPECT_EQ(r.rollup_rows, 0);
+  EXPECT_EQ(r.deleted_rollup_rows, 360);
+  EXPECT_EQ(QueryCount("SELECT COUNT(1) FROM device_status_rollups WHERE bucket_ms=60000;"), 0);
+  EXPECT_EQ(QueryCount("SELECT COUNT(1) FROM device_status_rollups WHERE bucket_ms=3600000;"), 3);
+  EXPECT_EQ(QueryCount("SELECT COUNT(1) FROM edge_status_rollups WHERE bucket_ms=3600000;"), 3);
+
+  MyDB::GetInstance().Close();
+}
+
+TEST(MyDB_SnapshotRetention, KeepsRawRowsNotYetRolledUp) {
+  std::error_code ec;
+  for (const char* suffix : {"", "-wal", "-shm"}) {
+    std::filesystem::remove(DbPathRetention() + suffix, ec);
+  }
+
+  DBConfig cfg;
+  cfg.path = DbPathRetention();
+  cfg.busy_timeout_ms = 1000;
+  cfg.snapshot_raw_retention_hours = 0;  // 立即过期，但仍须等汇总完成
+
+  std::string err;
+  ASSERT_TRUE(MyDB::GetInstance().Init(cfg, &err)) << err;
+  ASSERT_TRUE(MyDB::GetInstance().Migrate(&err)) << err;
+
+  const std::int64_t now = 5 * 3600 * 1000 + 30 * 60 * 1000;  // 05:30
+  std::vector<SnapshotRow> rows;
+  my_data::DeviceStatus ds;
+  ds.device_id = "uuv-2";
+  for (std::int64_t ts = now - 2 * 3600 * 1000; ts < now; ts += 60 * 1000) {
+    rows.push_back(SnapshotRow{SnapshotRow::Kind::Device, "edge-2", ds.device_id, ts, ds.toJson().dump()});
+  }
+  ASSERT_TRUE(StatusRepository::GetInstance().InsertSnapshotBatch(rows, &err)) << err;
+
+  RetentionReport r;
+  ASSERT_TRUE(SnapshotRetention::GetInstance().RunOnce(now, &r, &err)) << err;
+
+  // 小时粒度只汇总到 05:00，05:00 之后的原始快照保留
+  EXPECT_EQ(QueryCount("SELECT COUNT(1) FROM device_status_snapshots;"), 30);
+  EXPECT_EQ(QueryCount("SELECT MIN(ts_ms) FROM device_status_snapshots;"), 5 * 3600 * 1000);
+
+  MyDB::GetInstance().Close();
+}
+
+TEST(MyDB_SnapshotRetention, ExistingDbIsConvertedOnlyOnRequest) {
+  std::error_code ec;
+  for (const char* suffix : {"", "-wal", "-shm"}) {
+    std::filesystem::remove(DbPathRetention() + suffix, ec);
+  }
+
+  // 旧版本创建的库：auto_vacuum=NONE 且已有表
+  sqlite3* raw = nullptr;
+  ASSERT_EQ(sqlite3_open(DbPathRetention().c_str(), &raw), SQLITE_OK);
+  ASSERT_EQ(sqlite3_exec(raw, "CREATE TABLE legacy (id INTEGER);", nullptr, nullptr, nullptr), SQLITE_OK);
+  sqlite3_close(raw);
+
+  DBConfig cfg;
+  cfg.path = DbPathRetention();
+  cfg.busy_timeout_ms = 1000;
+
+  std::string err;
+  ASSERT_TRUE(MyDB::GetInstance().Init(cfg, &err)) << err;
+  ASSERT_TRUE(MyDB::GetInstance().Migrate(&err)) << err;
+  EXPECT_EQ(QueryCount("PRAGMA auto_vacuum;"), 0);  // Init/Migrate 不做隐式 VACUUM
+
+  ASSERT_TRUE(MyDB::GetInstance().ConvertToIncrementalVacuum(&err)) << err;
+  EXPECT_EQ(QueryCount("PRAGMA auto_vacuum;"), 2);
+  EXPECT_TRUE(MyDB::GetInstance().ConvertToIncrementalVacuum(&err)) << err;  // 幂等
+
+  MyDB::GetInstance().Close();
+}
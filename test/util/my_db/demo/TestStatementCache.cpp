@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "MyDB.h"
+#include "MyData.h"
+#include "StatementCache.h"
+#include "demo/StatusRepository.h"
+#include "sqlite3.h"
+
+using namespace my_db;
+using namespace my_db::demo;
+
+namespace {
+
+struct MemoryDb {
+  sqlite3* db{nullptr};
+  MemoryDb() {
+    sqlite3_open(":memory:", &db);
+    sqlite3_exec(db, "CREATE TABLE t(id INTEGER, v TEXT);", nullptr, nullptr, nullptr);
+  }
+  ~MemoryDb() { sqlite3_close(db); }
+};
+
+} // namespace
+
+TEST(MyDB_StatementCache, ReusesStatementAndClearsBindings) {
+  MemoryDb m;
+  std::string err;
+  {
+    StatementCache cache(4);
+    const std::string sql = "INSERT INTO t(id, v) VALUES(?, ?);";
+
+    sqlite3_stmt* first = nullptr;
+    {
+      auto h = cache.Acquire(m.db, sql, &err);
+      ASSERT_TRUE(h) << err;
+      first = h.get();
+      sqlite3_bind_int64(h.get(), 1, 7);
+      sqlite3_bind_text(h.get(), 2, "x", -1, SQLITE_TRANSIENT);
+      ASSERT_EQ(sqlite3_step(h.get()), SQLITE_DONE);
+    }
+    {
+      auto h = cache.Acquire(m.db, sql, &err);
+      ASSERT_TRUE(h) << err;
+      EXPECT_EQ(h.get(), first);
+      // 归还时已 clear_bindings：未绑定的参数为 NULL
+      ASSERT_EQ(sqlite3_step(h.get()), SQLITE_DONE);
+    }
+
+    auto stats = cache.Stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.size, 1u);
+  }
+
+  sqlite3_stmt* q = nullptr;
+  ASSERT_EQ(sqlite3_prepare_v2(m.db, "SELECT COUNT(1) FROM t WHERE id IS NULL;", -1, &q, nullptr), SQLITE_OK);
+  ASSERT_EQ(sqlite3_step(q), SQLITE_ROW);
+  EXPECT_EQ(sqlite3_column_int64(q, 0), 1);
+  sqlite3_finalize(q);
+}
+
+TEST(MyDB_StatementCache, EvictsLeastRecentlyUsedAndHandlesNestedUse) {
+  MemoryDb m;
+  std::string err;
+  StatementCache cache(2);
+
+  const std::string a = "SELECT 1;";
+  const std::string b = "SELECT 2;";
+  const std::string c = "SELECT 3;";
+
+  { auto h = cache.Acquire(m.db, a, &err); ASSERT_TRUE(h); }
+  { auto h = cache.Acquire(m.db, b, &err); ASSERT_TRUE(h); }
+  { auto h = cache.Acquire(m.db, a, &err); ASSERT_TRUE(h); }  // a 变为最近使用
+  { auto h = cache.Acquire(m.db, c, &err); ASSERT_TRUE(h); }  // 淘汰 b
+
+  auto stats = cache.Stats();
+  EXPECT_EQ(stats.size, 2u);
+  EXPECT_EQ(stats.evictions, 1u);
+
+  { auto h = cache.Acquire(m.db, a, &err); ASSERT_TRUE(h); }
+  EXPECT_EQ(cache.Stats().hits, stats.hits + 1);
+
+  // 同一条 SQL 嵌套使用：第二个句柄是临时语句，不影响缓存项
+  {
+    auto outer = cache.Acquire(m.db, a, &err);
+    auto inner = cache.Acquire(m.db, a, &err);
+    ASSERT_TRUE(outer);
+    ASSERT_TRUE(inner);
+    EXPECT_NE(outer.get(), inner.get());
+  }
+  EXPECT_EQ(cache.Stats().size, 2u);
+
+  // 语法错误返回空句柄
+  auto bad = cache.Acquire(m.db, "SELEC nothing;", &err);
+  EXPECT_FALSE(bad);
+  EXPECT_FALSE(err.empty());
+}
+
+TEST(MyDB_StatementCache, RepositoriesReuseCachedStatements) {
+  const std::string path = "/tmp/fast_cpp_server_test_stmt_cache.db";
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+
+  DBConfig cfg;
+  cfg.path = path;
+  cfg.busy_timeout_ms = 1000;
+
+  std::string err;
+  ASSERT_TRUE(MyDB::GetInstance().Init(cfg, &err)) << err;
+  ASSERT_TRUE(MyDB::GetInstance().Migrate(&err)) << err;
+
+  my_data::DeviceStatus ds;
+  ds.device_id = "uuv-1";
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(StatusRepository::GetInstance().InsertDeviceSnapshot("edge-1", ds, &err)) << err;
+  }
+
+  std::int64_t cnt = 0;
+  ASSERT_TRUE(StatusRepository::GetInstance().CountDeviceSnapshots("edge-1", "uuv-1", &cnt, &err)) << err;
+  EXPECT_EQ(cnt, 10);
+
+  // 写连接：INSERT 编译一次、复用 9 次（COUNT 走只读连接池，不计入写连接缓存）
+  auto stats = MyDB::GetInstance().StatementStats();
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.hits, 9u);
+
+  MyDB::GetInstance().Close();
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <vector>
+
+#include "MyDB.h"
+#include "MyData.h"
+#include "demo/StatusRepository.h"
+
+using namespace my_db;
+using namespace my_db::demo;
+
+static std::string DbPathStatusQuery() {
+  return "/tmp/fast_cpp_server_test_status_query.db";
+}
+
+class MyDB_StatusQuery : public ::testing::Test {
+protected:
+  void SetUp() override {
+    std::error_code ec;
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+      std::filesystem::remove(DbPathStatusQuery() + suffix, ec);
+    }
+    DBConfig cfg;
+    cfg.path = DbPathStatusQuery();
+    cfg.busy_timeout_ms = 1000;
+
+    std::string err;
+    ASSERT_TRUE(MyDB::GetInstance().Init(cfg, &err)) << err;
+    ASSERT_TRUE(MyDB::GetInstance().Migrate(&err)) << err;
+
+    // uuv-1：ts = 0, 1000, ..., 99000（每秒一条）；另有一台设备和一个边缘的干扰数据
+    std::vector<SnapshotRow> rows;
+    for (std::int64_t i = 0; i < 100; ++i) {
+      my_data::DeviceStatus ds;
+      ds.device_id = "uuv-1";
+      ds.queue_depth = i;
+      rows.push_back(SnapshotRow{SnapshotRow::Kind::Device, "edge-1", "uuv-1", i * 1000, ds.toJson().dump()});
+      ds.device_id = "uuv-2";
+      rows.push_back(SnapshotRow{SnapshotRow::Kind::Device, "edge-1", "uuv-2", i * 1000, ds.toJson().dump()});
+      if (i % 10 == 0) {
+        rows.push_back(SnapshotRow{SnapshotRow::Kind::Edge, "edge-1", {}, i * 1000, "{}"});
+      }
+    }
+    ASSERT_TRUE(StatusRepository::GetInstance().InsertSnapshotBatch(rows, &err)) << err;
+  }
+
+  void TearDown() override { MyDB::GetInstance().Close(); }
+};
+
+TEST_F(MyDB_StatusQuery, KeysetPagesCoverRangeWithoutGaps) {
+  SnapshotQuery q;
+  q.device_id = "uuv-1";
+  q.from_ms = 10 * 1000;
+  q.to_ms = 60 * 1000;
+  q.limit = 20;
+
+  std::vector<std::int64_t> ts;
+  std::string err;
+  int pages = 0;
+  while (true) {
+    SnapshotPage page;
+    ASSERT_TRUE(StatusRepository::GetInstance().QuerySnapshots(q, &page, &err)) << err;
+    ++pages;
+    for (const auto& r : page.rows) {
+      ts.push_back(r.ts_ms);
+      EXPECT_TRUE(r.is_json);
+    }
+    if (!page.has_more) {
+      EXPECT_TRUE(page.next_cursor.empty());
+      break;
+    }
+    q.cursor = page.next_cursor;
+  }
+
+  EXPECT_EQ(pages, 3);
+  ASSERT_EQ(ts.size(), 50u);
+  for (std::size_t i = 0; i < ts.size(); ++i) {
+    EXPECT_EQ(ts[i], static_cast<std::int64_t>(10 + i) * 1000);
+  }
+}
+
+TEST_F(MyDB_StatusQuery, DownsamplesEveryNthAndBucketLast) {
+  std::string err;
+
+  SnapshotQuery nth;
+  nth.device_id = "uuv-1";
+  nth.downsample = SnapshotQuery::Downsample::EveryNth;
+  nth.every_n = 10;
+  nth.limit = 4;
+  SnapshotPage page;
+  ASSERT_TRUE(StatusRepository::GetInstance().QuerySnapshots(nth, &page, &err)) << err;
+  ASSERT_EQ(page.rows.size(), 4u);
+  EXPECT_EQ(page.rows[0].ts_ms, 0);
+  EXPECT_EQ(page.rows[3].ts_ms, 30000);
+  ASSERT_TRUE(page.has_more);
+
+  // 下一页从第 40 条继续，步长不变
+  nth.cursor = page.next_cursor;
+  ASSERT_TRUE(StatusRepository::GetInstance().QuerySnapshots(nth, &page, &err)) << err;
+  ASSERT_FALSE(page.rows.empty());
+  EXPECT_EQ(page.rows[0].ts_ms, 40000);
+
+  SnapshotQuery bucket;
+  bucket.device_id = "uuv-1";
+  bucket.edge_id = "edge-1";
+  bucket.downsample = SnapshotQuery::Downsample::BucketLast;
+  bucket.bucket_ms = 25 * 1000;
+  bucket.limit = 3;
+  ASSERT_TRUE(StatusRepository::GetInstance().QuerySnapshots(bucket, &page, &err)) << err;
+  ASSERT_EQ(page.rows.size(), 3u);
+  EXPECT_EQ(page.rows[0].ts_ms, 24000);
+  EXPECT_EQ(page.rows[1].ts_ms, 49000);
+  EXPECT_EQ(page.rows[2].ts_ms, 74000);
+  ASSERT_TRUE(page.has_more);
+
+  bucket.cursor = page.next_cursor;
+  ASSERT_TRUE(StatusRepository::GetInstance().QuerySnapshots(bucket, &page, &err)) << err;
+  ASSERT_EQ(page.rows.size(), 1u);
+  EXPECT_EQ(page.rows[0].ts_ms, 99000);
+  EXPECT_FALSE(page.has_more);
+}
+
+TEST_F(MyDB_StatusQuery, ScanCapEndsPageWithCursor) {
+  std::string err;
+
+  // 每页最多扫描 7 行：25 秒的桶需要跨多页，结果与不截断时一致
+  SnapshotQuery bucket;
+  bucket.device_id = "uuv-1";
+  bucket.downsample = SnapshotQuery::Downsample::BucketLast;
+  bucket.bucket_ms = 25 * 1000;
+  bucket.max_scan = 7;
+
+  std::vector<std::int64_t> ts;
+  int pages = 0;
+  while (true) {
+    SnapshotPage page;
+    ASSERT_TRUE(StatusRepository::GetInstance().QuerySnapshots(bucket, &page, &err)) << err;
+    ASSERT_LE(page.scanned, 7u);
+    ASSERT_LT(++pages, 100);
+    for (const auto& r : page.rows) ts.push_back(r.ts_ms);
+    if (!page.has_more) break;
+    bucket.cursor = page.next_cursor;
+  }
+  EXPECT_GT(pages, 4);
+  EXPECT_EQ(ts, (std::vector<std::int64_t>{24000, 49000, 74000, 99000}));
+
+  // EveryNth 同样受扫描上限约束，游标覆盖全部区间
+  SnapshotQuery nth;
+  nth.device_id = "uuv-1";
+  nth.downsample = SnapshotQuery::Downsample::EveryNth;
+  nth.every_n = 10;
+  nth.max_scan = 10;
+  std::size_t scanned = 0;
+  while (true) {
+    SnapshotPage page;
+    ASSERT_TRUE(StatusRepository::GetInstance().QuerySnapshots(nth, &page, &err)) << err;
+    ASSERT_LE(page.scanned, 10u);
+    scanned += page.scanned;
+    if (!page.has_more) break;
+    nth.cursor = page.next_cursor;
+  }
+  EXPECT_EQ(scanned, 100u);
+}
+
+TEST_F(MyDB_StatusQuery, EdgeQueryAndValidation) {
+  std::string err;
+  SnapshotQuery q;
+  q.kind = SnapshotRow::Kind::Edge;
+  q.edge_id = "edge-1";
+  SnapshotPage page;
+  ASSERT_TRUE(StatusRepository::GetInstance().QuerySnapshots(q, &page, &err)) << err;
+  EXPECT_EQ(page.rows.size(), 10u);
+  EXPECT_FALSE(page.has_more);
+
+  q.cursor = "not-a-cursor";
+  EXPECT_FALSE(StatusRepository::GetInstance().QuerySnapshots(q, &page, &err));
+  EXPECT_EQ(err, "invalid cursor");
+
+  SnapshotQuery missing;
+  EXPECT_FALSE(StatusRepository::GetInstance().QuerySnapshots(missing, &page, &err));
+  EXPECT_EQ(err, "device_id required");
+
+  std::int64_t ts = 0, id = 0;
+  EXPECT_TRUE(SnapshotQuery::ParseCursor(SnapshotQuery::FormatCursor(1234, 56), &ts, &id));
+  EXPECT_EQ(ts, 1234);
+  EXPECT_EQ(id, 56);
+  EXPECT_FALSE(SnapshotQuery::ParseCursor("12:", &ts, &id));
+  EXPECT_FALSE(SnapshotQuery::ParseCursor("12:3x", &ts, &id));
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <future>
+#include <vector>
+
+#include "MyDB.h"
+#include "MyData.h"
+#include "demo/StatusRepository.h"
+#include "demo/StatusSnapshotWriter.h"
+
+using namespace my_db;
+using namespace my_db::demo;
+
+static std::string DbPathSnapWriter() {
+  return "/tmp/fast_cpp_server_test_snapshot_writer.db";
+}
+
+TEST(MyDB_StatusSnapshotWriter, GroupCommitsQueuedSnapshots) {
+  std::error_code ec;
+  std::filesystem::remove(DbPathSnapWriter(), ec);
+
+  DBConfig cfg;
+  cfg.path = DbPathSnapWriter();
+  cfg.busy_timeout_ms = 1000;
+  cfg.snapshot_batch_max_rows = 16;
+  cfg.snapshot_batch_interval_ms = 50;
+
+  std::string err;
+  ASSERT_TRUE(MyDB::GetInstance().Init(cfg, &err)) << err;
+  ASSERT_TRUE(MyDB::GetInstance().Migrate(&err)) << err;
+
+  auto& writer = StatusSnapshotWriter::GetInstance();
+  writer.Stop();  // 以本测试的批量参数重新启动
+  ASSERT_TRUE(writer.Start(&err)) << err;
+  auto before = writer.Stats();
+
+  my_data::EdgeStatus es;
+  es.edge_id = "edge-w";
+  my_data::DeviceStatus ds;
+  ds.device_id = "uuv-w";
+
+  std::vector<std::future<bool>> futures;
+  for (int i = 0; i < 40; ++i) {
+    std::future<bool> f;
+    ASSERT_TRUE(writer.EnqueueDeviceSnapshot("edge-w", ds, &f));
+    futures.push_back(std::move(f));
+  }
+  ASSERT_TRUE(writer.EnqueueEdgeSnapshot(es));  // fire-and-forget
+
+  std::future<bool> last;
+  ASSERT_TRUE(writer.EnqueueEdgeSnapshot(es, &last));
+  ASSERT_EQ(last.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+  EXPECT_TRUE(last.get());
+  for (auto& f : futures) {
+    EXPECT_TRUE(f.get());
+  }
+
+  std::int64_t dev_cnt = 0, edge_cnt = 0;
+  ASSERT_TRUE(StatusRepository::GetInstance().CountDeviceSnapshots("edge-w", "uuv-w", &dev_cnt, &err)) << err;
+  ASSERT_TRUE(StatusRepository::GetInstance().CountEdgeSnapshots("edge-w", &edge_cnt, &err)) << err;
+  EXPECT_EQ(dev_cnt, 40);
+  EXPECT_EQ(edge_cnt, 2);
+
+  auto st = writer.Stats();
+  EXPECT_EQ(st.enqueued - before.enqueued, 42u);
+  EXPECT_EQ(st.committed_rows - before.committed_rows, 42u);
+  EXPECT_EQ(st.failed_rows, before.failed_rows);
+  // 42 行、每批最多 16 行 => 至少 3 个事务，且远少于逐行提交
+  EXPECT_GE(st.batches - before.batches, 3u);
+  EXPECT_LT(st.batches - before.batches, 42u);
+  EXPECT_LE(st.max_batch_rows, 16u);
+  EXPECT_GT(st.max_commit_us, 0);
+
+  // 运行时状态 JSON 暴露批大小与提交耗时
+  const auto j = ToJson(st);
+  EXPECT_EQ(j["batch"]["count"].get<std::uint64_t>(), st.batches);
+  EXPECT_EQ(j["batch"]["max_rows"].get<std::size_t>(), st.max_batch_rows);
+  EXPECT_EQ(j["commit_us"]["max"].get<std::int64_t>(), st.max_commit_us);
+  EXPECT_EQ(j["commit_us"]["avg"].get<std::int64_t>(), st.avg_commit_us);
+
+  writer.Stop();
+  EXPECT_FALSE(writer.Enqueue(SnapshotRow::Edge(es)));
+  EXPECT_EQ(writer.Stats().dropped, st.dropped + 1);
+
+  MyDB::GetInstance().Close();
+}
+
+TEST(MyDB_StatusSnapshotWriter, StopDrainsPendingRows) {
+  std::error_code ec;
+  std::filesystem::remove(DbPathSnapWriter(), ec);
+
+  DBConfig cfg;
+  cfg.path = DbPathSnapWriter();
+  cfg.busy_timeout_ms = 1000;
+  cfg.snapshot_batch_max_rows = 1000;
+  cfg.snapshot_batch_interval_ms = 60000;  // 仅靠 Stop 触发提交
+
+  std::string err;
+  ASSERT_TRUE(MyDB::GetInstance().Init(cfg, &err)) << err;
+  ASSERT_TRUE(MyDB::GetInstance().Migrate(&err)) << err;
+
+  auto& writer = StatusSnapshotWriter::GetInstance();
+  writer.Stop();
+  ASSERT_TRUE(writer.Start(&err)) << err;
+
+  my_data::DeviceStatus ds;
+  ds.device_id = "uuv-d";
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(writer.EnqueueDeviceSnapshot("edge-d", ds));
+  }
+  writer.Stop();
+
+  std::int64_t cnt = 0;
+  ASSERT_TRUE(StatusRepository::GetInstance().CountDeviceSnapshots("edge-d", "uuv-d", &cnt, &err)) << err;
+  EXPECT_EQ(cnt, 5);
+  EXPECT_EQ(writer.Stats().queue_depth, 0u);
+
+  MyDB::GetInstance().Close();
+}
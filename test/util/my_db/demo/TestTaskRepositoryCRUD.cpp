@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <filesystem>
+#include <vector>
 
 #include "MyDB.h"
 #include "MyData.h"
@@ -86,4 +87,34 @@ TEST(MyDB_TaskRepo, CRUD_Task_And_Result_CascadeDelete) {
   std::string out_r;
   EXPECT_FALSE(TaskRepository::GetInstance().GetResultJson(t.task_id, &out_r, &err));
   MyDB::GetInstance().Close();
-}
\ No newline at end of file
+}
+TEST(MyDB_TaskRepo, ListTaskIdsAfter_OrderedByGeneratedSeq) {
+  InitFreshDB();
+  std::string err;
+
+  std::vector<std::string> ids;
+  for (int i = 0; i < 5; ++i) {
+    my_data::Task t;
+    t.task_id = my_data::GenerateId("task");
+    t.device_id = "uuv-1";
+    t.created_at_ms = my_data::NowMs();
+    ids.push_back(t.task_id);
+    ASSERT_TRUE(TaskRepository::GetInstance().UpsertTask(t, &err)) << err;
+  }
+  // 非生成器 ID：task_seq 为 NULL，不参与增量列举
+  my_data::Task ext;
+  ext.task_id = "external-task-1";
+  ASSERT_TRUE(TaskRepository::GetInstance().UpsertTask(ext, &err)) << err;
+
+  std::vector<my_data::TaskId> out;
+  ASSERT_TRUE(TaskRepository::GetInstance().ListTaskIdsAfter(0, 100, &out, &err)) << err;
+  EXPECT_EQ(out, ids);
+
+  my_data::Id64 seq = 0;
+  ASSERT_TRUE(my_data::ParseGeneratedId(ids[1], &seq));
+  ASSERT_TRUE(TaskRepository::GetInstance().ListTaskIdsAfter(seq, 2, &out, &err)) << err;
+  ASSERT_EQ(out.size(), 2u);
+  EXPECT_EQ(out[0], ids[2]);
+  EXPECT_EQ(out[1], ids[3]);
+  MyDB::GetInstance().Close();
+}
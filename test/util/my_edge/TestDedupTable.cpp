@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "DedupTable.h"
+
+using namespace my_edge;
+
+static SubmitResult MakeOk(const std::string& task_id) {
+  SubmitResult r;
+  r.code = SubmitCode::Ok;
+  r.message = "已入队";
+  r.task_id = task_id;
+  return r;
+}
+
+TEST(MyEdge_DedupTable, DuplicateWithinWindowReturnsFirstResult) {
+  DedupTable t;
+  SubmitResult first;
+  EXPECT_FALSE(t.TryReserve("k1", 1000, MakeOk("task-a"), 10000, &first));
+  t.Update("k1", MakeOk("task-a"));
+
+  EXPECT_TRUE(t.TryReserve("k1", 1000, MakeOk("task-b"), 10500, &first));
+  EXPECT_EQ(first.task_id, "task-a");
+  EXPECT_EQ(t.Stats().hits, 1u);
+
+  // 窗口结束后同一 key 视为新提交
+  EXPECT_FALSE(t.TryReserve("k1", 1000, MakeOk("task-c"), 11000, &first));
+  EXPECT_TRUE(t.TryReserve("k1", 1000, MakeOk("task-d"), 11100, &first));
+  EXPECT_EQ(first.task_id, "task-c");
+}
+
+TEST(MyEdge_DedupTable, EraseAllowsRetry) {
+  DedupTable t;
+  SubmitResult first;
+  EXPECT_FALSE(t.TryReserve("k", 5000, MakeOk("task-a"), 1000, &first));
+  t.Erase("k");
+  EXPECT_FALSE(t.TryReserve("k", 5000, MakeOk("task-b"), 1001, &first));
+  EXPECT_TRUE(t.TryReserve("k", 5000, MakeOk("task-c"), 1002, &first));
+  EXPECT_EQ(first.task_id, "task-b");
+}
+
+TEST(MyEdge_DedupTable, WheelExpiresEntriesWithoutFullSweep) {
+  DedupTableOptions opts;
+  opts.slot_ms = 10;
+  opts.max_window_ms = 1000;
+  DedupTable t(opts);
+
+  for (int i = 0; i < 1000; ++i) {
+    t.TryReserve("key-" + std::to_string(i), 100 + (i % 5) * 100, MakeOk("t"), 0, nullptr);
+  }
+  EXPECT_EQ(t.Stats().size, 1000u);
+
+  t.TryReserve("probe", 10, MakeOk("t"), 250, nullptr);  // 窗口 100/200 的已清除
+  EXPECT_EQ(t.Stats().size, 600u + 1u);
+  EXPECT_EQ(t.Stats().expired, 400u);
+
+  // 空闲超过一整圈
+  t.TryReserve("probe2", 10, MakeOk("t"), 100000, nullptr);
+  EXPECT_EQ(t.Stats().size, 1u);
+}
+
+TEST(MyEdge_DedupTable, CapacityIsBounded) {
+  DedupTableOptions opts;
+  opts.slot_ms = 10;
+  opts.max_window_ms = 10000;
+  opts.max_entries = 100;
+  DedupTable t(opts);
+
+  for (int i = 0; i < 10000; ++i) {
+    t.TryReserve("key-" + std::to_string(i), 10000, MakeOk("t"), i, nullptr);
+    ASSERT_LE(t.Stats().size, 100u);
+  }
+  EXPECT_GT(t.Stats().evicted, 0u);
+
+  // 最新的 key 仍然能被去重
+  SubmitResult first;
+  EXPECT_TRUE(t.TryReserve("key-9999", 10000, MakeOk("x"), 10000, &first));
+}
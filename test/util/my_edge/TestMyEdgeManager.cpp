@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MyData.h"
+#include "MyEdgeManager.h"
+
+using namespace my_edge;
+
+namespace {
+
+// 只记录 Submit 次数的最小 Edge；delay_ms 用于验证扇出是并行执行的
+class FakeEdge : public IEdge {
+public:
+  FakeEdge(std::string id, int delay_ms) : id_(std::move(id)), delay_ms_(delay_ms) {}
+
+  bool Init(const nlohmann::json&, std::string*) override { return true; }
+  bool Start(std::string*) override { return true; }
+
+  SubmitResult Submit(const my_data::RawCommand& cmd) override {
+    if (delay_ms_ > 0) std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms_));
+    submits_.fetch_add(1);
+    SubmitResult r;
+    r.code = SubmitCode::Ok;
+    r.edge_id = id_;
+    r.command_id = cmd.command_id;
+    return r;
+  }
+
+  my_data::EdgeStatus GetStatusSnapshot() const override {
+    my_data::EdgeStatus st;
+    st.edge_id = id_;
+    return st;
+  }
+  void SetEStop(bool, const std::string&) override {}
+  void Shutdown() override {}
+  my_data::EdgeId Id() const override { return id_; }
+  std::string EdgeType() const override { return "fake"; }
+  void ShowAnalyzeInitArgs(const nlohmann::json&) const override {}
+  nlohmann::json DumpInternalInfo() const override { return nlohmann::json::object(); }
+  nlohmann::json GetRunTimeStatusInfo() const override { return nlohmann::json::object(); }
+  bool AppendJsonTask(const nlohmann::json&) override { return true; }
+  bool AppendTask(const my_data::Task&) override { return true; }
+
+  int Submits() const { return submits_.load(); }
+
+private:
+  std::string id_;
+  int delay_ms_;
+  std::atomic<int> submits_{0};
+};
+
+my_data::RawCommand BuildCmd(const std::string& cmd_id) {
+  my_data::RawCommand rc;
+  rc.command_id = cmd_id;
+  rc.source = "test";
+  rc.payload = nlohmann::json{{"device_id", "self"}};
+  return rc;
+}
+
+} // namespace
+
+TEST(MyEdge_MyEdgeManager, RoutingMissReturnsCodeInsteadOfThrowing) {
+  auto& mgr = MyEdgeManager::GetInstance();
+  const auto v0 = mgr.routeVersion();
+
+  auto edge = std::make_unique<FakeEdge>("mgr-route-1", 0);
+  FakeEdge* raw = edge.get();
+  ASSERT_TRUE(mgr.appendEdge(std::move(edge)));
+  EXPECT_GT(mgr.routeVersion(), v0);
+  EXPECT_THROW(mgr.appendEdge(std::make_unique<FakeEdge>("mgr-route-1", 0)), DuplicateEdgeException);
+
+  EXPECT_EQ(mgr.findEdge("mgr-route-1").get(), raw);
+  EXPECT_EQ(mgr.findEdge("mgr-route-missing"), nullptr);
+
+  auto ok = mgr.submitToEdge("mgr-route-1", BuildCmd("c-1"));
+  EXPECT_TRUE(ok.ok());
+  EXPECT_EQ(raw->Submits(), 1);
+
+  auto miss = mgr.submitToEdge("mgr-route-missing", BuildCmd("c-2"));
+  EXPECT_EQ(miss.code, SubmitCode::UnknownEdge);
+  EXPECT_EQ(miss.edge_id, "mgr-route-missing");
+  EXPECT_EQ(miss.command_id, "c-2");
+
+  EXPECT_THROW(mgr.getEdgeById("mgr-route-missing"), EdgeNotFoundException);
+
+  // 删除后，之前取到的 shared_ptr 仍然有效
+  auto held = mgr.findEdge("mgr-route-1");
+  ASSERT_TRUE(mgr.deleteEdgeById("mgr-route-1"));
+  EXPECT_EQ(mgr.findEdge("mgr-route-1"), nullptr);
+  EXPECT_EQ(held->Id(), "mgr-route-1");
+}
+
+TEST(MyEdge_MyEdgeManager, FanoutSubmitsToEdgesInParallel) {
+  auto& mgr = MyEdgeManager::GetInstance();
+  constexpr int kEdges = 8;
+  constexpr int kDelayMs = 50;
+
+  std::vector<std::string> ids;
+  std::vector<FakeEdge*> raws;
+  for (int i = 0; i < kEdges; ++i) {
+    ids.push_back("mgr-fanout-" + std::to_string(i));
+    auto edge = std::make_unique<FakeEdge>(ids.back(), kDelayMs);
+    raws.push_back(edge.get());
+    ASSERT_TRUE(mgr.appendEdge(std::move(edge)));
+  }
+  ids.push_back("mgr-fanout-missing");
+
+  const auto t0 = std::chrono::steady_clock::now();
+  auto results = mgr.fanoutSubmit(ids, BuildCmd("fan-1"));
+  const auto elapsed_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+
+  ASSERT_EQ(results.size(), ids.size());
+  for (int i = 0; i < kEdges; ++i) {
+    EXPECT_TRUE(results[i].ok()) << results[i].toString();
+    EXPECT_EQ(results[i].edge_id, ids[i]);
+    EXPECT_EQ(raws[i]->Submits(), 1);
+  }
+  EXPECT_EQ(results.back().code, SubmitCode::UnknownEdge);
+  // 串行需要 kEdges * kDelayMs；只要有两个以上线程参与就明显更短
+  if (std::thread::hardware_concurrency() > 1) {
+    EXPECT_LT(elapsed_ms, kEdges * kDelayMs);
+  }
+
+  nlohmann::json resp;
+  std::string err;
+  ASSERT_TRUE(mgr.fanoutSubmitJson(
+      nlohmann::json{{"edge_ids", {ids[0], ids[1]}}, {"command", BuildCmd("fan-2").toJson()}}, &resp, &err))
+      << err;
+  EXPECT_EQ(resp["total"].get<int>(), 2);
+  EXPECT_EQ(resp["accepted"].get<int>(), 2);
+  EXPECT_FALSE(mgr.fanoutSubmitJson(nlohmann::json{{"edge_ids", "x"}, {"command", nlohmann::json::object()}},
+                                    &resp, &err));
+
+  for (int i = 0; i < kEdges; ++i) {
+    EXPECT_TRUE(mgr.deleteEdgeById(ids[i]));
+  }
+}
+
+TEST(MyEdge_MyEdgeManager, SubmitBatchJsonRejectsMistypedFields) {
+  auto& mgr = MyEdgeManager::GetInstance();
+  auto edge = std::make_unique<FakeEdge>("mgr-batch-1", 0);
+  FakeEdge* raw = edge.get();
+  ASSERT_TRUE(mgr.appendEdge(std::move(edge)));
+
+  const nlohmann::json cmds = nlohmann::json::array({BuildCmd("b-1").toJson()});
+  nlohmann::json resp;
+  std::string err;
+
+  // 非 bool 的 atomic 按参数错误返回，不抛 type_error
+  EXPECT_FALSE(mgr.submitBatchJson(
+      nlohmann::json{{"edge_id", "mgr-batch-1"}, {"commands", cmds}, {"atomic", "yes"}}, &resp, &err));
+  EXPECT_EQ(err, "atomic must be a boolean");
+  EXPECT_FALSE(mgr.submitBatchJson(
+      nlohmann::json{{"edge_id", "mgr-batch-1"}, {"commands", cmds}, {"source", 1}}, &resp, &err));
+  EXPECT_FALSE(mgr.submitBatchJson(nlohmann::json{{"edge_id", 7}, {"commands", cmds}}, &resp, &err));
+  EXPECT_EQ(raw->Submits(), 0);
+
+  err.clear();
+  ASSERT_TRUE(mgr.submitBatchJson(
+      nlohmann::json{{"edge_id", "mgr-batch-1"}, {"commands", cmds}, {"atomic", false}}, &resp, &err))
+      << err;
+  EXPECT_EQ(resp["accepted"].get<int>(), 1);
+  EXPECT_EQ(raw->Submits(), 1);
+  ASSERT_TRUE(mgr.deleteEdgeById("mgr-batch-1"));
+}
@@ -2,6 +2,7 @@
 #include <nlohmann/json.hpp>
 
 #include <chrono>
+#include <filesystem>
 #include <thread>
 
 #include "MyEdge.h"
@@ -166,4 +167,207 @@ TEST(MyEdge_UUVEdge, Submit_EStop_AllowQueueWhenEStop) {
   EXPECT_GE(st.tasks_pending_total, 0);
 
   edge->Shutdown();
-}
\ No newline at end of file
+}
+
+TEST(MyEdge_UUVEdge, TaskJournal_RestoresQueuedTasksAfterRestart) {
+  const std::string path = (std::filesystem::temp_directory_path() /
+                            ("uuv_edge_journal_" + std::to_string(my_data::NowMs()) + ".wal")).string();
+  auto cfg = BuildEdgeCfg();
+  cfg["task_journal_enable"] = true;
+  cfg["task_journal_path"] = path;
+
+  my_data::Task task;
+  task.task_id = "task-journal-1";
+  task.device_id = "uuv-1";
+  task.capability = "navigate";
+  task.action = "set";
+
+  {
+    auto edge = MyEdge::GetInstance().Create("uuv");
+    ASSERT_TRUE(edge != nullptr);
+    std::string err;
+    ASSERT_TRUE(edge->Init(cfg, &err)) << err;
+    // 未 Start：设备不消费，任务留在队列与日志中
+    ASSERT_TRUE(edge->AppendTask(task));
+    edge->Shutdown();
+  }
+
+  auto edge = MyEdge::GetInstance().Create("uuv");
+  ASSERT_TRUE(edge != nullptr);
+  std::string err;
+  ASSERT_TRUE(edge->Init(cfg, &err)) << err;
+  auto info = edge->DumpInternalInfo();
+  EXPECT_EQ(info["task-queues"]["uuv-1"]["size"].get<std::size_t>(), 1u);
+  edge->Shutdown();
+
+  std::filesystem::remove(path);
+}
+
+TEST(MyEdge_UUVEdge, TaskQueueMode_AppliedToDeviceQueues) {
+  auto cfg = BuildEdgeCfg();
+  cfg["task_queue_mode"] = "priority";
+
+  auto edge = MyEdge::GetInstance().Create("uuv");
+  ASSERT_TRUE(edge != nullptr);
+  std::string err;
+  ASSERT_TRUE(edge->Init(cfg, &err)) << err;
+
+  auto info = edge->DumpInternalInfo();
+  EXPECT_EQ(info["task-queues"]["uuv-1"]["stats"]["mode"].get<std::string>(), "priority");
+  edge->Shutdown();
+}
+
+TEST(MyEdge_UUVEdge, Submit_DuplicateWithinWindowReturnsFirstResult) {
+  auto cfg = BuildEdgeCfg();
+  cfg["dedup_default_window_ms"] = 60000;
+
+  auto edge = MyEdge::GetInstance().Create("uuv");
+  ASSERT_TRUE(edge != nullptr);
+  std::string err;
+  ASSERT_TRUE(edge->Init(cfg, &err)) << err;
+  ASSERT_TRUE(edge->Start(&err)) << err;
+
+  const nlohmann::json payload{
+      {"device_id", "uuv-1"},
+      {"capability", "navigate"},
+      {"action", "set"},
+      {"params", nlohmann::json{{"lat", 1.0}, {"lon", 2.0}}}
+  };
+  auto r1 = edge->Submit(BuildCmd(payload, "cmd-dup"));
+  auto r2 = edge->Submit(BuildCmd(payload, "cmd-dup"));
+  auto r3 = edge->Submit(BuildCmd(payload, "cmd-other"));
+
+  ASSERT_EQ(r1.code, SubmitCode::Ok);
+  EXPECT_EQ(r2.code, SubmitCode::Ok);
+  EXPECT_EQ(r2.task_id, r1.task_id);
+  EXPECT_NE(r2.message.find("重复提交"), std::string::npos);
+  EXPECT_NE(r3.task_id, r1.task_id);
+  EXPECT_EQ(edge->DumpInternalInfo()["dedup"]["hits"].get<std::uint64_t>(), 1u);
+
+  edge->Shutdown();
+}
+
+TEST(MyEdge_UUVEdge, SubmitBatch_AtomicAbortsWholeBatch) {
+  auto edge = MyEdge::GetInstance().Create("uuv");
+  ASSERT_TRUE(edge != nullptr);
+  std::string err;
+  ASSERT_TRUE(edge->Init(BuildEdgeCfg(), &err)) << err;
+  ASSERT_TRUE(edge->Start(&err)) << err;
+
+  const nlohmann::json good{
+      {"device_id", "uuv-1"},
+      {"capability", "navigate"},
+      {"action", "set"},
+      {"params", nlohmann::json{{"lat", 1.0}, {"lon", 2.0}}}
+  };
+  const nlohmann::json bad{{"device_id", "uuv-missing"}, {"capability", "navigate"}, {"action", "set"}};
+
+  std::vector<my_data::RawCommand> mixed{BuildCmd(good, "b-1"), BuildCmd(bad, "b-2"), BuildCmd(good, "b-3")};
+  auto aborted = edge->SubmitBatch(std::move(mixed), true);
+  ASSERT_EQ(aborted.size(), 3u);
+  EXPECT_EQ(aborted[0].code, SubmitCode::BatchAborted);
+  EXPECT_EQ(aborted[1].code, SubmitCode::UnknownDevice);
+  EXPECT_EQ(aborted[2].code, SubmitCode::BatchAborted);
+  EXPECT_EQ(aborted[2].command_id, "b-3");
+
+  std::vector<my_data::RawCommand> clean{BuildCmd(good, "b-4"), BuildCmd(good, "b-5")};
+  auto ok = edge->SubmitBatch(std::move(clean), true);
+  ASSERT_EQ(ok.size(), 2u);
+  EXPECT_EQ(ok[0].code, SubmitCode::Ok) << ok[0].toString();
+  EXPECT_EQ(ok[1].code, SubmitCode::Ok) << ok[1].toString();
+  EXPECT_NE(ok[0].task_id, ok[1].task_id);
+  EXPECT_EQ(ok[0].queue_size_after, ok[1].queue_size_after);
+
+  edge->Shutdown();
+}
+
+TEST(MyEdge_UUVEdge, SelfTask_WakesOnAppendWithoutPolling) {
+  auto edge = MyEdge::GetInstance().Create("uuv");
+  ASSERT_TRUE(edge != nullptr);
+  std::string err;
+  ASSERT_TRUE(edge->Init(BuildEdgeCfg(), &err)) << err;
+  ASSERT_TRUE(edge->Start(&err)) << err;
+
+  // 先让 self 线程进入空闲等待
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  my_data::Task task;
+  task.task_id = "self-estop-1";
+  task.device_id = "self";
+  task.action = "set_estop";
+  task.params = nlohmann::json{{"active", true}, {"reason", "self-test"}};
+  const auto t0 = std::chrono::steady_clock::now();
+  ASSERT_TRUE(edge->AppendTask(task));
+
+  bool seen = false;
+  while (std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(500)) {
+    if (edge->GetStatusSnapshot().estop_active) {
+      seen = true;
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_TRUE(seen);
+
+  // Shutdown 关闭 self 队列即唤醒阻塞中的线程，循环里没有额外的 sleep
+  const auto t1 = std::chrono::steady_clock::now();
+  edge->Shutdown();
+  EXPECT_LT(std::chrono::steady_clock::now() - t1, std::chrono::milliseconds(500));
+}
+
+TEST(MyEdge_UUVEdge, StatusSnapshotShared_CachedUntilStateChanges) {
+  auto edge = MyEdge::GetInstance().Create("uuv");
+  ASSERT_TRUE(edge != nullptr);
+  std::string err;
+  ASSERT_TRUE(edge->Init(BuildEdgeCfg(), &err)) << err;
+  ASSERT_TRUE(edge->Start(&err)) << err;
+
+  auto s1 = edge->GetStatusSnapshotShared();
+  auto s2 = edge->GetStatusSnapshotShared();
+  ASSERT_TRUE(s1 != nullptr);
+  EXPECT_EQ(s1.get(), s2.get());
+  EXPECT_EQ(s1->devices.count("uuv-1"), 1u);
+
+  edge->SetEStop(true, "cache-test");
+  auto s3 = edge->GetStatusSnapshotShared();
+  EXPECT_NE(s3.get(), s1.get());
+  EXPECT_TRUE(s3->estop_active);
+  EXPECT_EQ(s3->estop_reason, "cache-test");
+
+  edge->Shutdown();
+  // Shutdown 撤下了设备/队列，旧快照仍可读
+  EXPECT_TRUE(edge->GetStatusSnapshotShared()->devices.empty());
+  EXPECT_EQ(s1->devices.count("uuv-1"), 1u);
+}
+
+TEST(MyEdge_UUVEdge, Submit_StampsIngressTrace) {
+  auto cfg = BuildEdgeCfg();
+  cfg["edge_id"] = "edge-trace";
+
+  auto edge = MyEdge::GetInstance().Create("uuv");
+  ASSERT_TRUE(edge != nullptr);
+  std::string err;
+  ASSERT_TRUE(edge->Init(cfg, &err)) << err;
+  ASSERT_TRUE(edge->Start(&err)) << err;
+
+  auto r = edge->Submit(BuildCmd(nlohmann::json{
+      {"device_id", "uuv-1"},
+      {"capability", "navigate"},
+      {"action", "set"},
+      {"params", nlohmann::json{{"lat", 1.0}, {"lon", 2.0}}}
+  }, "cmd-trace"));
+  ASSERT_EQ(r.code, SubmitCode::Ok) << r.toString();
+
+  // received/normalized 在 Submit 路径上打点后，TaskTracer 才会聚合 normalize 段
+  std::uint64_t normalized = 0;
+  for (int i = 0; i < 200 && normalized == 0; ++i) {
+    const auto snap = my_data::TaskTracer::GetInstance().Snapshot("edge-trace");
+    for (const auto& item : snap["items"]) {
+      normalized += item["normalize"]["count"].get<std::uint64_t>();
+    }
+    if (normalized == 0) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_GE(normalized, 1u);
+
+  edge->Shutdown();
+}
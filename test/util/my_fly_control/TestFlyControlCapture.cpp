@@ -0,0 +1,393 @@
+#include "gtest/gtest.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <pty.h>
+#endif
+
+#include "FlyControlCapture.h"
+#include "FlyControlFrame.h"
+#include "MyFlyControl.h"
+
+using namespace fly_control;
+
+// =============================================================================
+// 飞控抓包录制 / 回放测试
+// =============================================================================
+
+namespace {
+
+// 每个用例独立的临时目录，析构时删除
+class TempDir {
+public:
+    explicit TempDir(const std::string& name)
+        : path_(std::filesystem::temp_directory_path() /
+                (name + "_" + std::to_string(::getpid()))) {
+        std::filesystem::remove_all(path_);
+        std::filesystem::create_directories(path_);
+    }
+    ~TempDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(path_, ec);
+    }
+    std::string str() const { return path_.string(); }
+
+private:
+    std::filesystem::path path_;
+};
+
+std::vector<uint8_t> HeartbeatFrame(uint8_t cnt) {
+    std::vector<uint8_t> payload(HeartbeatLayout::SIZE, 0);
+    payload[0] = 0x01;   // 飞机ID
+    payload[2] = cnt;    // 定位星数，用于区分各帧
+    return BuildFrame(cnt, FRAME_TYPE_HEARTBEAT, payload);
+}
+
+CaptureWriter::Options SmallSegments(const std::string& dir, size_t max_segments) {
+    CaptureWriter::Options options;
+    options.dir          = dir;
+    options.prefix       = "test";
+    options.segment_size = 64u << 10;
+    options.max_segments = max_segments;
+    return options;
+}
+
+} // namespace
+
+// ---- 录制滚动分段，只保留最近 max_segments 个；读取端按时间顺序遍历目录 ----
+TEST(FlyControlCaptureTest, WriterRotatesSegmentsAndReaderWalksDirectory) {
+    TempDir dir("fccap_rotate");
+    CaptureWriter writer;
+    std::string err;
+    ASSERT_TRUE(writer.Open(SmallSegments(dir.str(), 2), &err)) << err;
+
+    constexpr size_t RECORD_LEN = 4000;
+    constexpr int    RECORDS    = 60;   // 约 240KB，跨 4 个 64KB 分段
+    std::vector<uint8_t> data(RECORD_LEN);
+    for (int i = 0; i < RECORDS; ++i) {
+        std::fill(data.begin(), data.end(), static_cast<uint8_t>(i));
+        ASSERT_TRUE(writer.Append(i % 2 ? CaptureDirection::Tx : CaptureDirection::Rx,
+                                  data.data(), data.size(), 1000 + i));
+    }
+    // 超过分段容量的单条记录被丢弃
+    std::vector<uint8_t> huge(70u << 10);
+    EXPECT_FALSE(writer.Append(CaptureDirection::Rx, huge.data(), huge.size()));
+
+    const auto stats = writer.GetStats();
+    EXPECT_EQ(stats["records"].get<int>(), RECORDS);
+    EXPECT_EQ(stats["dropped"].get<int>(), 1);
+    EXPECT_GE(stats["segments"].get<int>(), 4);
+    writer.Close();
+
+    const auto files = CaptureReader::ListCaptureFiles(dir.str(), &err);
+    ASSERT_EQ(files.size(), 2u);
+
+    CaptureReader reader;
+    CaptureRecordView rec;
+    int64_t last_ns = 0;
+    int total = 0;
+    uint32_t last_segment = 0;
+    for (const auto& file : files) {
+        ASSERT_TRUE(reader.Open(file, &err)) << err;
+        EXPECT_GE(reader.Header().segment_index, last_segment);
+        last_segment = reader.Header().segment_index;
+        // 关闭时已截断到有效长度
+        EXPECT_EQ(std::filesystem::file_size(file), reader.Header().data_end);
+        while (reader.Next(rec)) {
+            ASSERT_EQ(rec.len, RECORD_LEN);
+            const int i = static_cast<int>(rec.mono_ns - 1000);
+            EXPECT_GT(rec.mono_ns, last_ns);
+            EXPECT_EQ(rec.data[0], static_cast<uint8_t>(i));
+            EXPECT_EQ(rec.direction, i % 2 ? CaptureDirection::Tx : CaptureDirection::Rx);
+            last_ns = rec.mono_ns;
+            ++total;
+        }
+    }
+    // 最旧的分段已删除，剩下的是末尾连续的记录
+    EXPECT_GT(total, 0);
+    EXPECT_LT(total, RECORDS);
+    EXPECT_EQ(last_ns, 1000 + RECORDS - 1);
+}
+
+// ---- 同一秒内多次录制互不覆盖；分段保留数按整个目录计算 ----
+TEST(FlyControlCaptureTest, RestartedSessionsKeepEarlierCapturesWithinRetention) {
+    TempDir dir("fccap_sessions");
+    std::string err;
+    for (int session = 0; session < 3; ++session) {
+        CaptureWriter writer;
+        ASSERT_TRUE(writer.Open(SmallSegments(dir.str(), 2), &err)) << err;
+        const auto frame = HeartbeatFrame(static_cast<uint8_t>(session));
+        ASSERT_TRUE(writer.Append(CaptureDirection::Rx, frame.data(), frame.size(), 1000 + session));
+        writer.Close();
+    }
+
+    const auto files = CaptureReader::ListCaptureFiles(dir.str(), &err);
+    ASSERT_EQ(files.size(), 2u);
+
+    // 保留的是后两次录制，且各自的记录完整
+    CaptureReader reader;
+    CaptureRecordView rec;
+    std::vector<int64_t> seen;
+    for (const auto& file : files) {
+        ASSERT_TRUE(reader.Open(file, &err)) << err;
+        while (reader.Next(rec)) {
+            seen.push_back(rec.mono_ns);
+        }
+    }
+    EXPECT_EQ(seen, (std::vector<int64_t>{1001, 1002}));
+}
+
+// ---- 下一个分段由后台线程预先打开：不出现在抓包列表里，滚动时直接启用，关闭时删除未用的预备分段 ----
+TEST(FlyControlCaptureTest, SpareSegmentIsPreparedInBackground) {
+    TempDir dir("fccap_spare");
+    CaptureWriter writer;
+    std::string err;
+    ASSERT_TRUE(writer.Open(SmallSegments(dir.str(), 8), &err)) << err;
+
+    auto count_parts = [&]() {
+        size_t n = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(dir.str())) {
+            if (entry.path().extension() == ".part") {
+                ++n;
+            }
+        }
+        return n;
+    };
+    for (int i = 0; i < 200 && count_parts() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(count_parts(), 1u);
+    EXPECT_EQ(CaptureReader::ListCaptureFiles(dir.str(), &err).size(), 1u);
+
+    // 写满第一个分段：切换到预备分段，后台线程随后把它改名并预备下一个
+    std::vector<uint8_t> data(4000, 0x5A);
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(writer.Append(CaptureDirection::Rx, data.data(), data.size(), 1000 + i));
+    }
+    EXPECT_EQ(writer.GetStats()["segments"].get<int>(), 2);
+    writer.Close();
+
+    EXPECT_EQ(count_parts(), 0u);
+    const auto files = CaptureReader::ListCaptureFiles(dir.str(), &err);
+    ASSERT_EQ(files.size(), 2u);
+    CaptureReader reader;
+    CaptureRecordView rec;
+    int total = 0;
+    for (const auto& file : files) {
+        ASSERT_TRUE(reader.Open(file, &err)) << err;
+        while (reader.Next(rec)) {
+            ++total;
+        }
+    }
+    EXPECT_EQ(total, 20);
+}
+
+// ---- 写入端未关闭（模拟进程崩溃）时，读取端以文件头 data_end 为准 ----
+TEST(FlyControlCaptureTest, ReaderStopsAtDataEndOfUnclosedSegment) {
+    TempDir dir("fccap_unclosed");
+    CaptureWriter writer;
+    std::string err;
+    ASSERT_TRUE(writer.Open(SmallSegments(dir.str(), 1), &err)) << err;
+
+    const auto frame = HeartbeatFrame(7);
+    ASSERT_TRUE(writer.Append(CaptureDirection::Rx, frame.data(), 10));
+    ASSERT_TRUE(writer.Append(CaptureDirection::Rx, frame.data() + 10, frame.size() - 10));
+
+    const auto files = CaptureReader::ListCaptureFiles(dir.str(), &err);
+    ASSERT_EQ(files.size(), 1u);
+    // 分段仍是预分配大小，尾部全零
+    EXPECT_EQ(std::filesystem::file_size(files[0]), 64u << 10);
+
+    CaptureReader reader;
+    ASSERT_TRUE(reader.Open(files[0], &err)) << err;
+    CaptureRecordView rec;
+    std::vector<uint8_t> joined;
+    int records = 0;
+    while (reader.Next(rec)) {
+        joined.insert(joined.end(), rec.data, rec.data + rec.len);
+        ++records;
+    }
+    EXPECT_EQ(records, 2);
+    EXPECT_EQ(joined, frame);
+
+    reader.Rewind();
+    ASSERT_TRUE(reader.Next(rec));
+    EXPECT_EQ(rec.len, 10u);
+}
+
+// ---- 回放：接收字节按任意切分喂入解析器，回调与统计正确；同时给出吞吐基准 ----
+TEST(FlyControlCaptureTest, ReplayFeedsParserAndReportsThroughput) {
+    TempDir dir("fccap_replay");
+    CaptureWriter writer;
+    std::string err;
+    auto options = SmallSegments(dir.str(), 64);
+    options.segment_size = 1u << 20;
+    ASSERT_TRUE(writer.Open(options, &err)) << err;
+
+    constexpr int FRAMES = 2000;
+    std::vector<uint8_t> stream;
+    for (int i = 0; i < FRAMES; ++i) {
+        const auto frame = HeartbeatFrame(static_cast<uint8_t>(i));
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    stream[HEARTBEAT_FRAME_LEN * 5 + 20] ^= 0xFF;   // 第 6 帧校验失败
+
+    // 模拟串口读的随机切分，并夹杂发送记录
+    size_t off = 0;
+    int64_t ts = 0;
+    for (size_t chunk = 1; off < stream.size(); chunk = chunk % 97 + 13) {
+        const size_t n = std::min(chunk, stream.size() - off);
+        ASSERT_TRUE(writer.Append(CaptureDirection::Rx, stream.data() + off, n, ts += 1000));
+        off += n;
+        if (off % 7 == 0) {
+            ASSERT_TRUE(writer.Append(CaptureDirection::Tx, stream.data(), 12, ts += 1000));
+        }
+    }
+    writer.Close();
+
+    MyFlyControl fc;
+    std::atomic<int> heartbeats{0};
+    fc.SetOnHeartbeat([&](const HeartbeatData&) { heartbeats.fetch_add(1); });
+
+    ReplayStats stats;
+    ASSERT_TRUE(fc.ReplayCapture(dir.str(), ReplayOptions{}, &stats, &err)) << err;
+    EXPECT_EQ(stats.rx_bytes, stream.size());
+    EXPECT_EQ(stats.frames, static_cast<size_t>(FRAMES));
+    EXPECT_EQ(stats.invalid_frames, 1u);
+    EXPECT_GT(stats.tx_records, 0u);
+    EXPECT_EQ(heartbeats.load(), FRAMES - 1);
+    EXPECT_TRUE(fc.HasHeartbeat());
+    EXPECT_GT(stats.handler_max_ns, 0);
+    EXPECT_LE(stats.handler_p50_ns, stats.handler_p99_ns);
+
+    RecordProperty("frames", static_cast<int>(stats.frames));
+    RecordProperty("elapsed_ms", static_cast<int>(stats.elapsed_s * 1000.0));
+    RecordProperty("frames_per_sec", static_cast<int>(stats.frames_per_sec));
+    RecordProperty("kbytes_per_sec", static_cast<int>(stats.mbytes_per_sec * 1024.0));
+    RecordProperty("handler_p50_ns", static_cast<int>(stats.handler_p50_ns));
+    RecordProperty("handler_p99_ns", static_cast<int>(stats.handler_p99_ns));
+
+    EXPECT_FALSE(fc.ReplayCapture(dir.str() + "/missing", ReplayOptions{}, &stats, &err));
+}
+
+// ---- 原速回放按录制时间间隔推进 ----
+TEST(FlyControlCaptureTest, RealtimeReplayHonoursRecordedTiming) {
+    TempDir dir("fccap_realtime");
+    CaptureWriter writer;
+    std::string err;
+    ASSERT_TRUE(writer.Open(SmallSegments(dir.str(), 1), &err)) << err;
+
+    constexpr int     FRAMES      = 10;
+    constexpr int64_t INTERVAL_NS = 20 * 1000 * 1000;   // 20ms，心跳 50Hz
+    for (int i = 0; i < FRAMES; ++i) {
+        const auto frame = HeartbeatFrame(static_cast<uint8_t>(i));
+        ASSERT_TRUE(writer.Append(CaptureDirection::Rx, frame.data(), frame.size(), i * INTERVAL_NS));
+    }
+    writer.Close();
+
+    MyFlyControl fc;
+    ReplayStats stats;
+    ReplayOptions options;
+    options.realtime = true;
+    ASSERT_TRUE(fc.ReplayCapture(dir.str(), options, &stats, &err)) << err;
+    EXPECT_EQ(stats.frames, static_cast<size_t>(FRAMES));
+    EXPECT_GE(stats.elapsed_s, (FRAMES - 1) * INTERVAL_NS * 1e-9 * 0.95);
+}
+
+// ---- 原速回放多次录制：每次录制各自对齐，录制之间的时钟差不会变成等待 ----
+TEST(FlyControlCaptureTest, RealtimeReplayRebasesEachSession) {
+    TempDir dir("fccap_realtime_sessions");
+    std::string err;
+    constexpr int     FRAMES      = 5;
+    constexpr int64_t INTERVAL_NS = 10 * 1000 * 1000;   // 10ms
+    // 第二次录制的时钟远大于第一次（模拟相隔很久），第三次又回到更小的值（模拟重启后时钟重置）
+    const int64_t session_base_ns[] = {0, 3600LL * 1000 * 1000 * 1000, 1000};
+    for (const int64_t base : session_base_ns) {
+        CaptureWriter writer;
+        ASSERT_TRUE(writer.Open(SmallSegments(dir.str(), 8), &err)) << err;
+        for (int i = 0; i < FRAMES; ++i) {
+            const auto frame = HeartbeatFrame(static_cast<uint8_t>(i));
+            ASSERT_TRUE(writer.Append(CaptureDirection::Rx, frame.data(), frame.size(), base + i * INTERVAL_NS));
+        }
+        writer.Close();
+    }
+
+    MyFlyControl fc;
+    ReplayStats stats;
+    ReplayOptions options;
+    options.realtime = true;
+    ASSERT_TRUE(fc.ReplayCapture(dir.str(), options, &stats, &err)) << err;
+    EXPECT_EQ(stats.files, 3u);
+    EXPECT_EQ(stats.frames, static_cast<size_t>(3 * FRAMES));
+    EXPECT_GE(stats.elapsed_s, 3 * (FRAMES - 1) * INTERVAL_NS * 1e-9 * 0.95);
+    EXPECT_LT(stats.elapsed_s, 5.0);
+}
+
+// ---- 配置 capture 后，Start 期间串口收发字节都会被录制 ----
+TEST(FlyControlCaptureTest, RunningLinkRecordsRxAndTx) {
+#if defined(__linux__) || defined(__APPLE__)
+    TempDir dir("fccap_link");
+    int master_fd = -1;
+    int slave_fd = -1;
+    char slave_name[256] = {0};
+    ASSERT_EQ(openpty(&master_fd, &slave_fd, slave_name, nullptr, nullptr), 0);
+
+    std::atomic<int> heartbeats{0};
+    {
+        MyFlyControl fc;
+        fc.SetOnHeartbeat([&](const HeartbeatData&) { heartbeats.fetch_add(1); });
+        std::string err;
+        ASSERT_TRUE(fc.Init({{"id", "fc_test"},
+                             {"port", slave_name},
+                             {"baudrate", 115200},
+                             {"read_mode", "event"},
+                             {"capture", {{"enabled", true}, {"dir", dir.str()}, {"segment_size_mb", 1}}}},
+                            &err)) << err;
+        ASSERT_TRUE(fc.Start(&err)) << err;
+
+        const auto frame = HeartbeatFrame(3);
+        ASSERT_EQ(::write(master_fd, frame.data(), frame.size()), static_cast<ssize_t>(frame.size()));
+        for (int i = 0; i < 200 && heartbeats.load() == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        ASSERT_TRUE(fc.SendSetSpeed(1500, &err)) << err;
+        EXPECT_EQ(fc.GetCaptureStats()["open"], true);
+        fc.Stop();
+    }
+    ::close(master_fd);
+    ::close(slave_fd);
+    ASSERT_EQ(heartbeats.load(), 1);
+
+    std::string err;
+    const auto files = CaptureReader::ListCaptureFiles(dir.str(), &err);
+    ASSERT_EQ(files.size(), 1u) << err;
+    EXPECT_NE(files[0].find("fc_test_"), std::string::npos);
+
+    CaptureReader reader;
+    ASSERT_TRUE(reader.Open(files[0], &err)) << err;
+    CaptureRecordView rec;
+    size_t rx_bytes = 0;
+    size_t tx_bytes = 0;
+    while (reader.Next(rec)) {
+        (rec.direction == CaptureDirection::Rx ? rx_bytes : tx_bytes) += rec.len;
+    }
+    EXPECT_EQ(rx_bytes, HEARTBEAT_FRAME_LEN);
+    EXPECT_EQ(tx_bytes, SET_SPEED_FRAME_LEN);
+
+    // 录下来的抓包可直接回放
+    MyFlyControl replay;
+    ReplayStats stats;
+    ASSERT_TRUE(replay.ReplayCapture(dir.str(), ReplayOptions{}, &stats, &err)) << err;
+    EXPECT_EQ(stats.frames, 1u);
+#else
+    GTEST_SKIP() << "pty-based fly control test only runs on unix-like systems";
+#endif
+}
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 
@@ -371,3 +372,101 @@ TEST(FlyControlCodecTest, SetOriginReturnEncode) {
     int32_t lon = static_cast<int32_t>(MyLEHelper::read_uint32(pf.payload, off));
     EXPECT_EQ(lon, 1163000000);
 }
+
+// ---- 编译期布局：偏移、长度与字节序 ----
+TEST(FlyControlCodecTest, PayloadLayoutOffsetsAndByteOrder) {
+    static_assert(HeartbeatLayout::SIZE == 82, "心跳载荷 82 字节");
+    static_assert(HeartbeatLayout::Offset<3>() == 3, "经度紧随三个单字节字段");
+    static_assert(HeartbeatLayout::Offset<24>() == 47, "UTC 时间戳偏移");
+    static_assert(GuidanceNewLayout::SIZE == 50, "末制导(新版)载荷 50 字节");
+    static_assert(TargetStateLayout::Offset<TargetStateLayout::COUNT>() == TargetStateLayout::SIZE,
+                  "末尾偏移等于载荷长度");
+
+    uint8_t buf[4] = {0};
+    StoreScalar<ByteOrder::Little>(buf, static_cast<int32_t>(0x11223344));
+    EXPECT_EQ(buf[0], 0x44);
+    EXPECT_EQ(buf[3], 0x11);
+    StoreScalar<ByteOrder::Big>(buf, static_cast<int32_t>(-2));
+    EXPECT_EQ(buf[0], 0xFF);
+    EXPECT_EQ(buf[3], 0xFE);
+    EXPECT_EQ((LoadScalar<ByteOrder::Big, int32_t>(buf)), -2);
+}
+
+// ---- 定长帧写入 std::array：与 MyLEHelper 逐字段拼装的参考帧逐字节一致 ----
+TEST(FlyControlCodecTest, GuidanceNewArrayEncodeMatchesReference) {
+    GuidanceNewData data;
+    data.pitch_los_rate     = -1234;
+    data.yaw_los_rate       = 2345;
+    data.gimbal_yaw_angle   = -32768;
+    data.gyro_z             = 32767;
+    data.target_id          = 0xBEEF;
+    data.target_lon         = 1163456789;
+    data.target_lat         = -396789012;
+    data.laser_range        = 123456;
+    data.status             = 1;
+
+    std::vector<uint8_t> payload;
+    MyLEHelper::write_uint8(payload, data.cmd_type);
+    for (int16_t v : {data.pitch_los_rate, data.yaw_los_rate, data.pitch_los_angle, data.yaw_los_angle,
+                      data.pitch_frame_angle, data.yaw_frame_angle, data.gimbal_pitch_angle,
+                      data.gimbal_yaw_angle, data.acc_x, data.acc_y, data.acc_z,
+                      data.gyro_x, data.gyro_y, data.gyro_z}) {
+        MyLEHelper::write_int16(payload, v);
+    }
+    MyLEHelper::write_uint16(payload, data.target_id);
+    MyLEHelper::write_uint16(payload, data.target_type);
+    for (int32_t v : {data.target_lon, data.target_lat, data.target_alt, data.laser_range}) {
+        MyLEHelper::write_uint32(payload, static_cast<uint32_t>(v));
+    }
+    MyLEHelper::write_uint8(payload, data.status);
+    const auto expected = BuildFrame(0x42, FRAME_TYPE_COMMAND, payload);
+
+    GuidanceNewFrame frame;
+    EncodeGuidanceNew(0x42, data, frame);
+    ASSERT_EQ(expected.size(), frame.size());
+    EXPECT_TRUE(std::equal(frame.begin(), frame.end(), expected.begin()));
+    EXPECT_EQ(EncodeGuidanceNew(0x42, data), expected);
+
+    // 解析器按推导出的长度拆帧，视图载荷可直接按布局读回
+    FrameParser parser;
+    parser.FeedData(frame.data(), frame.size());
+    FrameView view;
+    ASSERT_TRUE(parser.NextFrame(view));
+    EXPECT_TRUE(view.valid);
+    ASSERT_EQ(view.payload_len(), GuidanceNewLayout::SIZE);
+    const auto target_id = LoadScalar<ByteOrder::Little, uint16_t>(view.payload() + GuidanceNewLayout::Offset<15>());
+    const auto laser_range = LoadScalar<ByteOrder::Little, int32_t>(view.payload() + GuidanceNewLayout::Offset<20>());
+    EXPECT_EQ(target_id, 0xBEEF);
+    EXPECT_EQ(laser_range, 123456);
+}
+
+// ---- 变长帧写入调用方缓冲区：容量不足时不写入 ----
+TEST(FlyControlCodecTest, SetRouteIntoBufferChecksCapacity) {
+    SetRouteData data;
+    data.points.resize(3);
+    data.points[2].longitude = -1;
+    data.points[2].speed     = 1500;
+
+    uint8_t buf[64] = {0};
+    EXPECT_EQ(EncodeSetRoute(0x01, data, buf, RouteFrameLen(3) - 1), 0u);
+    EXPECT_EQ(buf[0], 0x00);
+
+    const size_t len = EncodeSetRoute(0x01, data, buf, sizeof(buf));
+    ASSERT_EQ(len, RouteFrameLen(3));
+    const auto expected = EncodeSetRoute(0x01, data);
+    EXPECT_TRUE(std::equal(buf, buf + len, expected.begin(), expected.end()));
+}
+
+// ---- 指针版解码：载荷短于布局长度时拒绝 ----
+TEST(FlyControlCodecTest, PointerDecodeRejectsShortPayload) {
+    const uint8_t payload[GimbalControlLayout::SIZE] = {0x01, 0x10, 0x27, 0xF0, 0xD8};
+    GimbalControlData gimbal;
+    EXPECT_FALSE(DecodeGimbalControl(payload, GimbalControlLayout::SIZE - 1, gimbal));
+    ASSERT_TRUE(DecodeGimbalControl(payload, sizeof(payload), gimbal));
+    EXPECT_EQ(gimbal.enable, 1);
+    EXPECT_EQ(gimbal.pitch_angle, 10000);
+    EXPECT_EQ(gimbal.yaw_angle, -10000);
+
+    HeartbeatData hb;
+    EXPECT_FALSE(DecodeHeartbeat(payload, sizeof(payload), hb));
+}
@@ -0,0 +1,379 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "FlyControlFrame.h"
+#include "FlyControlProtocol.h"
+
+using namespace fly_control;
+
+// =============================================================================
+// FrameParser 连续缓冲区实现：与旧 deque 实现的模糊对比 + 吞吐基准
+// =============================================================================
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// 旧实现（std::deque 逐字节 pop_front），仅作为对比基准
+// 除未知指令类型不再卡住外，逻辑与替换前的 FrameParser 保持一致
+// ---------------------------------------------------------------------------
+class DequeFrameParser {
+public:
+    void FeedData(const uint8_t* data, size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            buffer_.push_back(data[i]);
+        }
+    }
+
+    size_t BufferSize() const { return buffer_.size(); }
+
+    // 帧总长度表（变长指令返回 0）
+    static size_t ExpectedLen(uint8_t frame_type, uint8_t cmd_byte) {
+        constexpr size_t CMD_OVERHEAD = 8;
+        switch (frame_type) {
+            case FRAME_TYPE_HEARTBEAT:       return HEARTBEAT_FRAME_LEN;
+            case FRAME_TYPE_SET_DESTINATION: return 18;
+            case FRAME_TYPE_REPLY:           return 9;
+            case FRAME_TYPE_GIMBAL_CONTROL:  return 12;
+            case FRAME_TYPE_COMMAND:
+                switch (cmd_byte) {
+                    case CMD_SET_ANGLE:         return CMD_OVERHEAD + 4;
+                    case CMD_SET_SPEED:         return CMD_OVERHEAD + 2;
+                    case CMD_SET_ALTITUDE:      return CMD_OVERHEAD + 3;
+                    case CMD_POWER_SWITCH:      return CMD_OVERHEAD + 1;
+                    case CMD_PARACHUTE:         return CMD_OVERHEAD + 1;
+                    case CMD_BUTTON:            return CMD_OVERHEAD + 1;
+                    case CMD_SET_ORIGIN_RETURN: return CMD_OVERHEAD + 11;
+                    case CMD_SWITCH_MODE:       return CMD_OVERHEAD + 1;
+                    case CMD_GUIDANCE:          return CMD_OVERHEAD + 19;
+                    case CMD_GUIDANCE_NEW:      return CMD_OVERHEAD + 49;
+                    case CMD_GIMBAL_ANG_RATE:   return CMD_OVERHEAD + 25;
+                    case CMD_GIMBAL_ANGLE:      return CMD_OVERHEAD + 16;
+                    case CMD_TARGET_STATE:      return CMD_OVERHEAD + 11;
+                    default:                    return 0;
+                }
+            default:
+                return 0;
+        }
+    }
+
+    bool PopFrame(ParsedFrame& frame) {
+        while (true) {
+            while (buffer_.size() >= 2 &&
+                   !(buffer_[0] == FRAME_HEADER_0 && buffer_[1] == FRAME_HEADER_1)) {
+                buffer_.pop_front();
+            }
+            if (buffer_.size() < 5) {
+                return false;
+            }
+            uint8_t frame_type = buffer_[3];
+            uint8_t cmd_byte   = frame_type == FRAME_TYPE_COMMAND ? buffer_[4] : 0;
+
+            size_t expected_len = ExpectedLen(frame_type, cmd_byte);
+            if (expected_len == 0) {
+                expected_len = VariableLen(frame_type);
+                if (expected_len == 0) {
+                    // 与新实现同步修正：只有航线/围栏缺点数量字节时才等待，未知指令丢弃帧头
+                    if (frame_type == FRAME_TYPE_COMMAND && buffer_.size() < 6 &&
+                        (cmd_byte == CMD_SET_ROUTE || cmd_byte == CMD_SET_GEOFENCE)) {
+                        return false;
+                    }
+                    buffer_.pop_front();
+                    continue;
+                }
+            }
+            if (buffer_.size() < expected_len) {
+                return false;
+            }
+            if (buffer_[expected_len - 2] != FRAME_TAIL_0 ||
+                buffer_[expected_len - 1] != FRAME_TAIL_1) {
+                buffer_.pop_front();
+                continue;
+            }
+
+            size_t chk_pos = expected_len - 3;
+            std::vector<uint8_t> raw(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(chk_pos));
+            uint32_t sum = 0;
+            for (uint8_t b : raw) {
+                sum += b;
+            }
+            frame.cnt        = buffer_[2];
+            frame.frame_type = frame_type;
+            frame.checksum   = buffer_[chk_pos];
+            frame.valid      = static_cast<uint8_t>(sum & 0xFF) == frame.checksum;
+            frame.payload.assign(buffer_.begin() + 4,
+                                 buffer_.begin() + static_cast<std::ptrdiff_t>(chk_pos));
+            for (size_t i = 0; i < expected_len; ++i) {
+                buffer_.pop_front();
+            }
+            return true;
+        }
+    }
+
+private:
+    size_t VariableLen(uint8_t frame_type) const {
+        if (frame_type != FRAME_TYPE_COMMAND || buffer_.size() < 6) {
+            return 0;
+        }
+        if (buffer_[4] == CMD_SET_ROUTE) {
+            return 9 + static_cast<size_t>(buffer_[5]) * 14;
+        }
+        if (buffer_[4] == CMD_SET_GEOFENCE) {
+            return 9 + static_cast<size_t>(buffer_[5]) * 11;
+        }
+        return 0;
+    }
+
+    std::deque<uint8_t> buffer_;
+};
+
+// 按帧类型生成一个合法帧（载荷内容随机）
+std::vector<uint8_t> RandomFrame(std::mt19937& rng) {
+    static const uint8_t kCmds[] = {
+        CMD_SET_ANGLE, CMD_SET_SPEED, CMD_SET_ALTITUDE, CMD_POWER_SWITCH, CMD_PARACHUTE,
+        CMD_BUTTON, CMD_SET_ORIGIN_RETURN, CMD_SWITCH_MODE, CMD_GUIDANCE, CMD_GUIDANCE_NEW,
+        CMD_GIMBAL_ANG_RATE, CMD_GIMBAL_ANGLE, CMD_TARGET_STATE, CMD_SET_ROUTE, CMD_SET_GEOFENCE,
+    };
+    auto random_bytes = [&](size_t n) {
+        std::vector<uint8_t> out(n);
+        for (auto& b : out) {
+            b = static_cast<uint8_t>(rng());
+        }
+        return out;
+    };
+
+    uint8_t cnt = static_cast<uint8_t>(rng());
+    switch (rng() % 5) {
+        case 0:  return BuildFrame(cnt, FRAME_TYPE_HEARTBEAT, random_bytes(HEARTBEAT_FRAME_LEN - 7));
+        case 1:  return BuildFrame(cnt, FRAME_TYPE_REPLY, random_bytes(2));
+        case 2:  return BuildFrame(cnt, FRAME_TYPE_GIMBAL_CONTROL, random_bytes(5));
+        case 3:  return BuildFrame(cnt, FRAME_TYPE_SET_DESTINATION, random_bytes(11));
+        default: break;
+    }
+
+    // 指令帧：定长指令按长度表生成载荷，航线/围栏随机点数
+    uint8_t cmd = kCmds[rng() % (sizeof(kCmds) / sizeof(kCmds[0]))];
+    std::vector<uint8_t> payload{cmd};
+    if (cmd == CMD_SET_ROUTE || cmd == CMD_SET_GEOFENCE) {
+        uint8_t count = static_cast<uint8_t>(rng() % 8);
+        payload.push_back(count);
+        auto body = random_bytes(static_cast<size_t>(count) * (cmd == CMD_SET_ROUTE ? 14 : 11));
+        payload.insert(payload.end(), body.begin(), body.end());
+    } else {
+        // 载荷 = 帧长 - 帧头(2) - CNT(1) - 帧类型(1) - 校验(1) - 帧尾(2)，首字节为指令类型
+        auto body = random_bytes(DequeFrameParser::ExpectedLen(FRAME_TYPE_COMMAND, cmd) - 8);
+        payload.insert(payload.end(), body.begin(), body.end());
+    }
+    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+}
+
+// 噪声链路：合法帧之间夹杂随机字节、孤立帧头、截断帧，部分帧校验和被破坏
+std::vector<uint8_t> NoisyStream(std::mt19937& rng, size_t frames) {
+    std::vector<uint8_t> out;
+    for (size_t i = 0; i < frames; ++i) {
+        switch (rng() % 6) {
+            case 0: {
+                size_t n = rng() % 48;
+                for (size_t k = 0; k < n; ++k) {
+                    out.push_back(static_cast<uint8_t>(rng()));
+                }
+                break;
+            }
+            case 1:
+                out.push_back(FRAME_HEADER_0);
+                out.push_back(FRAME_HEADER_1);
+                out.push_back(static_cast<uint8_t>(rng()));
+                break;
+            case 2: {
+                auto f = RandomFrame(rng);
+                f.resize(rng() % f.size());
+                out.insert(out.end(), f.begin(), f.end());
+                break;
+            }
+            default:
+                break;
+        }
+        auto f = RandomFrame(rng);
+        if (rng() % 8 == 0) {
+            f[f.size() - 3] ^= 0x5A;  // 破坏校验和
+        }
+        out.insert(out.end(), f.begin(), f.end());
+    }
+    return out;
+}
+
+int EnvInt(const char* name, int def) {
+    const char* v = std::getenv(name);
+    return (v != nullptr && *v != '\0') ? std::atoi(v) : def;
+}
+
+} // namespace
+
+// ---- SWAR 校验和与逐字节求和一致 ----
+TEST(FlyControlFrameParserTest, ChecksumMatchesBytewiseSum) {
+    std::mt19937 rng(7);
+    std::vector<uint8_t> data(4096);
+    for (auto& b : data) {
+        b = static_cast<uint8_t>(rng());
+    }
+    // 覆盖不同长度与非对齐起点，以及超过 128 组的折叠路径
+    for (size_t off = 0; off < 9; ++off) {
+        for (size_t len : {0u, 1u, 7u, 8u, 9u, 82u, 86u, 1023u, 1024u, 1025u, 4000u}) {
+            uint32_t sum = 0;
+            for (size_t i = 0; i < len; ++i) {
+                sum += data[off + i];
+            }
+            EXPECT_EQ(CalcChecksum(data.data() + off, len), static_cast<uint8_t>(sum & 0xFF))
+                << "off=" << off << " len=" << len;
+        }
+    }
+    std::vector<uint8_t> ff(2048, 0xFF);
+    EXPECT_EQ(CalcChecksum(ff.data(), ff.size()), static_cast<uint8_t>((2048u * 0xFF) & 0xFF));
+}
+
+// ---- 帧视图零拷贝且在 NextFrame 之间保持有效 ----
+TEST(FlyControlFrameParserTest, NextFrameReturnsViewsIntoBuffer) {
+    auto f1 = BuildFrame(0x01, FRAME_TYPE_REPLY, {0x04, 0x00});
+    auto f2 = BuildFrame(0x02, FRAME_TYPE_REPLY, {0x06, 0x01});
+    std::vector<uint8_t> data = {0x00, 0xEB, 0x11};
+    data.insert(data.end(), f1.begin(), f1.end());
+    data.insert(data.end(), f2.begin(), f2.end());
+
+    FrameParser parser;
+    parser.FeedData(data);
+
+    FrameView v1;
+    FrameView v2;
+    ASSERT_TRUE(parser.NextFrame(v1));
+    ASSERT_TRUE(parser.NextFrame(v2));
+    EXPECT_FALSE(parser.NextFrame(v2));
+    EXPECT_EQ(parser.BufferSize(), 0u);
+
+    EXPECT_TRUE(v1.valid);
+    EXPECT_EQ(v1.len, f1.size());
+    EXPECT_EQ(std::vector<uint8_t>(v1.data, v1.data + v1.len), f1);
+    EXPECT_EQ(v2.data, v1.data + v1.len);
+    ASSERT_EQ(v2.payload_len(), 2u);
+    EXPECT_EQ(v2.payload()[0], 0x06);
+
+    ParsedFrame copy;
+    v1.CopyTo(copy);
+    EXPECT_EQ(copy.cnt, 0x01);
+    EXPECT_EQ(copy.payload, (std::vector<uint8_t>{0x04, 0x00}));
+}
+
+// ---- 截断帧后的伪帧头（指令帧 + 未知指令类型）不会让解析器卡住 ----
+TEST(FlyControlFrameParserTest, UnknownCommandHeaderDoesNotStall) {
+    auto good = BuildFrame(0x07, FRAME_TYPE_REPLY, {0x04, 0x00});
+    // 截断的指令帧：帧头 + CNT + 帧类型，紧接着下一帧帧头被当成指令类型 0xEB
+    std::vector<uint8_t> data = {FRAME_HEADER_0, FRAME_HEADER_1, 0x01, FRAME_TYPE_COMMAND};
+    data.insert(data.end(), good.begin(), good.end());
+
+    FrameParser parser;
+    parser.FeedData(data);
+
+    ParsedFrame frame;
+    ASSERT_TRUE(parser.PopFrame(frame));
+    EXPECT_TRUE(frame.valid);
+    EXPECT_EQ(frame.cnt, 0x07);
+    EXPECT_EQ(parser.BufferSize(), 0u);
+
+    // 航线指令只收到 5 字节时仍然等待点数量
+    parser.FeedData(std::vector<uint8_t>{FRAME_HEADER_0, FRAME_HEADER_1, 0x02, FRAME_TYPE_COMMAND, CMD_SET_ROUTE});
+    EXPECT_FALSE(parser.PopFrame(frame));
+    EXPECT_EQ(parser.BufferSize(), 5u);
+}
+
+// ---- 随机分片喂入噪声字节流，结果与旧实现逐帧一致 ----
+TEST(FlyControlFrameParserTest, FuzzMatchesDequeImplementation) {
+    const int rounds = EnvInt("FRAME_PARSER_FUZZ_ROUNDS", 200);
+    size_t frames = 0;
+    for (int round = 0; round < rounds; ++round) {
+        std::mt19937 rng(static_cast<uint32_t>(round));
+        auto stream = NoisyStream(rng, 1 + rng() % 40);
+
+        FrameParser parser;
+        DequeFrameParser ref;
+        ParsedFrame got;
+        ParsedFrame want;
+
+        size_t pos = 0;
+        while (pos < stream.size()) {
+            size_t chunk = std::min<size_t>(stream.size() - pos, 1 + rng() % 300);
+            parser.FeedData(stream.data() + pos, chunk);
+            ref.FeedData(stream.data() + pos, chunk);
+            pos += chunk;
+
+            while (true) {
+                bool ok_got  = parser.PopFrame(got);
+                bool ok_want = ref.PopFrame(want);
+                ASSERT_EQ(ok_got, ok_want) << "round=" << round << " pos=" << pos;
+                if (!ok_got) {
+                    break;
+                }
+                ++frames;
+                ASSERT_EQ(got.cnt, want.cnt);
+                ASSERT_EQ(got.frame_type, want.frame_type);
+                ASSERT_EQ(got.checksum, want.checksum);
+                ASSERT_EQ(got.valid, want.valid);
+                ASSERT_EQ(got.payload, want.payload);
+            }
+            ASSERT_EQ(parser.BufferSize(), ref.BufferSize()) << "round=" << round << " pos=" << pos;
+        }
+    }
+    // 截断的航线帧可能吞掉后续整段数据，单轮允许没有帧，但整体必须解析出帧
+    EXPECT_GT(frames, static_cast<size_t>(rounds));
+}
+
+// ---- 吞吐基准：噪声链路下与旧实现对比（打印结果，不做耗时断言）----
+TEST(FlyControlFrameParserTest, BenchmarkAgainstDequeImplementation) {
+    std::mt19937 rng(2024);
+    const auto stream = NoisyStream(rng, static_cast<size_t>(EnvInt("FRAME_PARSER_BENCH_FRAMES", 20000)));
+    constexpr size_t READ_SIZE = 256;  // 与 MyFlyControl::ReceiveLoop 单次读取一致
+
+    auto run = [&](auto& parser, size_t& frames) {
+        ParsedFrame frame;
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t pos = 0; pos < stream.size(); pos += READ_SIZE) {
+            parser.FeedData(stream.data() + pos, std::min(READ_SIZE, stream.size() - pos));
+            while (parser.PopFrame(frame)) {
+                ++frames;
+            }
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+
+    size_t ref_frames = 0;
+    size_t new_frames = 0;
+    size_t view_frames = 0;
+    DequeFrameParser ref;
+    FrameParser parser;
+    const double ref_s = run(ref, ref_frames);
+    const double new_s = run(parser, new_frames);
+
+    FrameParser view_parser;
+    auto t0 = std::chrono::steady_clock::now();
+    FrameView view;
+    for (size_t pos = 0; pos < stream.size(); pos += READ_SIZE) {
+        view_parser.FeedData(stream.data() + pos, std::min(READ_SIZE, stream.size() - pos));
+        while (view_parser.NextFrame(view)) {
+            ++view_frames;
+        }
+    }
+    const double view_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    EXPECT_EQ(new_frames, ref_frames);
+    EXPECT_EQ(view_frames, ref_frames);
+
+    const double mb = static_cast<double>(stream.size()) / (1024.0 * 1024.0);
+    RecordProperty("bytes", static_cast<int>(stream.size()));
+    RecordProperty("frames", static_cast<int>(ref_frames));
+    RecordProperty("deque_mb_per_sec", static_cast<int>(mb / ref_s));
+    RecordProperty("contiguous_mb_per_sec", static_cast<int>(mb / new_s));
+    RecordProperty("view_mb_per_sec", static_cast<int>(mb / view_s));
+}
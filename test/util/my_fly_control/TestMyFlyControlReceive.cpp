@@ -0,0 +1,163 @@
+#include "gtest/gtest.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <pty.h>
+#endif
+
+#include <nlohmann/json.hpp>
+
+#include "FlyControlFrame.h"
+#include "MyFlyControl.h"
+
+using namespace fly_control;
+
+// =============================================================================
+// 飞控接收链路测试：用 pty 模拟飞控串口，测量 心跳帧写入 -> 回调触发 的延迟
+// =============================================================================
+
+namespace {
+
+#if defined(__linux__) || defined(__APPLE__)
+class PtyMaster {
+public:
+    PtyMaster() {
+        char slave_name[256] = {0};
+        if (openpty(&master_fd_, &slave_fd_, slave_name, nullptr, nullptr) != 0) {
+            throw std::runtime_error(std::string("openpty failed: ") + std::strerror(errno));
+        }
+        slave_path_ = slave_name;
+    }
+
+    ~PtyMaster() {
+        ::close(master_fd_);
+        ::close(slave_fd_);
+    }
+
+    int fd() const { return master_fd_; }
+    const std::string& slave_path() const { return slave_path_; }
+
+private:
+    int master_fd_{-1};
+    int slave_fd_{-1};
+    std::string slave_path_;
+};
+#endif
+
+// 测量 rounds 次心跳的 写入 -> 回调 延迟（微秒），返回排序后的结果
+std::vector<int64_t> MeasureHeartbeatLatency(const std::string& read_mode, int rounds) {
+    std::vector<int64_t> latencies;
+#if defined(__linux__) || defined(__APPLE__)
+    PtyMaster pty;
+    MyFlyControl fc;
+
+    std::mutex mu;
+    std::condition_variable cv;
+    int received = 0;
+    std::chrono::steady_clock::time_point received_at;
+    fc.SetOnHeartbeat([&](const HeartbeatData&) {
+        std::lock_guard<std::mutex> lk(mu);
+        received_at = std::chrono::steady_clock::now();
+        ++received;
+        cv.notify_all();
+    });
+
+    std::string err;
+    nlohmann::json cfg = {
+        {"port", pty.slave_path()},
+        {"baudrate", 115200},
+        {"timeout_ms", 100},
+        {"read_mode", read_mode},
+    };
+    if (!fc.Init(cfg, &err) || !fc.Start(&err)) {
+        ADD_FAILURE() << "start fly control failed: " << err;
+        return latencies;
+    }
+
+    const auto frame = BuildFrame(0x01, FRAME_TYPE_HEARTBEAT, std::vector<uint8_t>(HEARTBEAT_FRAME_LEN - 7, 0));
+    for (int i = 0; i < rounds; ++i) {
+        // 错开接收线程的轮询节拍，模拟心跳随机到达
+        std::this_thread::sleep_for(std::chrono::microseconds(2000 + 700 * (i % 7)));
+        const auto written_at = std::chrono::steady_clock::now();
+        if (::write(pty.fd(), frame.data(), frame.size()) != static_cast<ssize_t>(frame.size())) {
+            ADD_FAILURE() << "write pty failed";
+            break;
+        }
+        std::unique_lock<std::mutex> lk(mu);
+        if (!cv.wait_for(lk, std::chrono::seconds(2), [&] { return received == i + 1; })) {
+            ADD_FAILURE() << "heartbeat " << i << " not received";
+            break;
+        }
+        latencies.push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(received_at - written_at).count());
+    }
+
+    fc.Stop();
+    std::sort(latencies.begin(), latencies.end());
+#else
+    (void)read_mode;
+    (void)rounds;
+#endif
+    return latencies;
+}
+
+} // namespace
+
+TEST(MyFlyControlReceiveTest, EventModeDeliversHeartbeatWithLowLatency) {
+#if defined(__linux__) || defined(__APPLE__)
+    constexpr int ROUNDS = 20;
+    const auto event_us = MeasureHeartbeatLatency("event", ROUNDS);
+    const auto blocking_us = MeasureHeartbeatLatency("blocking", ROUNDS);
+    ASSERT_EQ(event_us.size(), static_cast<size_t>(ROUNDS));
+    ASSERT_EQ(blocking_us.size(), static_cast<size_t>(ROUNDS));
+
+    auto pct = [](const std::vector<int64_t>& v, double q) {
+        return v[std::min(v.size() - 1, static_cast<size_t>(q * static_cast<double>(v.size())))];
+    };
+    RecordProperty("event_p50_us", static_cast<int>(pct(event_us, 0.5)));
+    RecordProperty("event_p99_us", static_cast<int>(pct(event_us, 0.99)));
+    RecordProperty("blocking_p50_us", static_cast<int>(pct(blocking_us, 0.5)));
+    RecordProperty("blocking_p99_us", static_cast<int>(pct(blocking_us, 0.99)));
+
+    // 目标是亚毫秒；中位数留余量以适配负载较高的 CI 机器
+    EXPECT_LT(pct(event_us, 0.5), 5000);
+    EXPECT_LE(pct(event_us, 0.5), pct(blocking_us, 0.5));
+#else
+    GTEST_SKIP() << "pty-based fly control test only runs on unix-like systems";
+#endif
+}
+
+TEST(MyFlyControlReceiveTest, EventModeStopWakesIdleReceiver) {
+#if defined(__linux__) || defined(__APPLE__)
+    PtyMaster pty;
+    MyFlyControl fc;
+
+    std::string err;
+    ASSERT_TRUE(fc.Init({{"port", pty.slave_path()}, {"baudrate", 115200}, {"read_mode", "event"}}, &err)) << err;
+    ASSERT_TRUE(fc.Start(&err)) << err;
+
+    // 空闲时接收线程阻塞在无限等待上，Stop 必须能立即唤醒它
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const auto t0 = std::chrono::steady_clock::now();
+    fc.Stop();
+    const auto stop_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    EXPECT_FALSE(fc.IsRunning());
+    EXPECT_LT(stop_ms, 500);
+#else
+    GTEST_SKIP() << "pty-based fly control test only runs on unix-like systems";
+#endif
+}
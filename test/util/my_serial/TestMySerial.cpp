@@ -4,6 +4,7 @@
 #include <unistd.h>
 
 #include <cerrno>
+#include <chrono>
 #include <cstring>
 #include <stdexcept>
 #include <string>
@@ -43,6 +44,7 @@ public:
     }
 
     int master_fd() const { return master_fd_; }
+    int slave_fd() const { return slave_fd_; }
     const std::string& slave_path() const { return slave_path_; }
 
 private:
@@ -190,4 +192,112 @@ TEST(MySerialTest, SelfTestLoopbackCanRoundTripWithPty) {
 #else
     GTEST_SKIP() << "pty-based serial test only runs on unix-like systems";
 #endif
-}
\ No newline at end of file
+}
+
+TEST(MySerialTest, InitRejectsInvalidReadModeAndVmin) {
+    my_serial::MySerial serial_tool;
+    std::string err;
+
+    EXPECT_FALSE(serial_tool.Init({{"port", "/dev/ttyFAKE0"}, {"auto_open", false}, {"read_mode", "polling"}}, &err));
+    EXPECT_NE(err.find("read_mode"), std::string::npos);
+
+    EXPECT_FALSE(serial_tool.Init({{"port", "/dev/ttyFAKE0"}, {"auto_open", false}, {"vmin", 256}}, &err));
+    EXPECT_NE(err.find("vmin"), std::string::npos);
+}
+
+TEST(MySerialTest, EventReadModeWaitsForReadinessWithPty) {
+#if defined(__linux__) || defined(__APPLE__)
+    PtyPair pty_pair;
+    my_serial::MySerial serial_tool;
+
+    nlohmann::json cfg = {
+        {"port", pty_pair.slave_path()},
+        {"baudrate", 115200},
+        {"timeout_ms", 500},
+        {"read_mode", "event"},
+        {"vmin", 1},
+        {"vtime", 0}
+    };
+
+    std::string err;
+    ASSERT_TRUE(serial_tool.Init(cfg, &err)) << err;
+    ASSERT_TRUE(serial_tool.IsEventDriven());
+    EXPECT_GE(serial_tool.NativeHandle(), 0);
+    EXPECT_EQ(serial_tool.GetSnapshot().read_mode, "event");
+
+    // 链路空闲：等待超时返回，不读到任何数据
+    EXPECT_EQ(serial_tool.WaitReadable(20, &err), my_serial::SerialWaitResult::Timeout);
+    uint8_t buffer[64] = {0};
+    EXPECT_EQ(serial_tool.ReadAvailable(buffer, sizeof(buffer), &err), 0u);
+    EXPECT_TRUE(err.empty()) << err;
+
+    // 对端写入后立即就绪
+    const std::string inbound = "event-ready";
+    std::chrono::steady_clock::time_point written_at;
+    std::thread writer([&pty_pair, &inbound, &written_at]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        written_at = std::chrono::steady_clock::now();
+        ::write(pty_pair.master_fd(), inbound.data(), inbound.size());
+    });
+    ASSERT_EQ(serial_tool.WaitReadable(-1, &err), my_serial::SerialWaitResult::Readable) << err;
+    const auto woke_at = std::chrono::steady_clock::now();
+    writer.join();
+
+    std::string received;
+    while (received.size() < inbound.size() &&
+           serial_tool.WaitReadable(500, &err) == my_serial::SerialWaitResult::Readable) {
+        const size_t n = serial_tool.ReadAvailable(buffer, sizeof(buffer), &err);
+        received.append(reinterpret_cast<const char*>(buffer), n);
+    }
+    EXPECT_EQ(received, inbound) << err;
+    EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(woke_at - written_at).count(), 100);
+
+    // InterruptWait 唤醒无限等待
+    serial_tool.InterruptWait();
+    EXPECT_EQ(serial_tool.WaitReadable(-1, &err), my_serial::SerialWaitResult::Interrupted);
+
+    serial_tool.Close();
+    EXPECT_FALSE(serial_tool.IsEventDriven());
+    EXPECT_EQ(serial_tool.NativeHandle(), -1);
+    EXPECT_EQ(serial_tool.WaitReadable(0, &err), my_serial::SerialWaitResult::Error);
+#else
+    GTEST_SKIP() << "pty-based serial test only runs on unix-like systems";
+#endif
+}
+
+TEST(MySerialTest, EventReadModeRestoresTermiosOnClose) {
+#if defined(__linux__) || defined(__APPLE__)
+    PtyPair pty_pair;
+    std::string err;
+
+    // 先以阻塞模式打开，记下端口自身的 VMIN/VTIME
+    my_serial::MySerial blocking_tool;
+    ASSERT_TRUE(blocking_tool.Init({{"port", pty_pair.slave_path()}, {"baudrate", 115200}}, &err)) << err;
+    struct termios before {};
+    ASSERT_EQ(::tcgetattr(pty_pair.slave_fd(), &before), 0);
+    blocking_tool.Close();
+
+    my_serial::MySerial serial_tool;
+    nlohmann::json cfg = {
+        {"port", pty_pair.slave_path()},
+        {"baudrate", 115200},
+        {"read_mode", "event"},
+        {"vmin", 5},
+        {"vtime", 3}
+    };
+    ASSERT_TRUE(serial_tool.Init(cfg, &err)) << err;
+    struct termios applied {};
+    ASSERT_EQ(::tcgetattr(pty_pair.slave_fd(), &applied), 0);
+    EXPECT_EQ(applied.c_cc[VMIN], 5);
+    EXPECT_EQ(applied.c_cc[VTIME], 3);
+
+    // 关闭后 VMIN/VTIME 恢复为打开前的值，不影响同一设备上的其它句柄
+    serial_tool.Close();
+    struct termios after {};
+    ASSERT_EQ(::tcgetattr(pty_pair.slave_fd(), &after), 0);
+    EXPECT_EQ(after.c_cc[VMIN], before.c_cc[VMIN]);
+    EXPECT_EQ(after.c_cc[VTIME], before.c_cc[VTIME]);
+#else
+    GTEST_SKIP() << "pty-based serial test only runs on unix-like systems";
+#endif
+}